@@ -0,0 +1,363 @@
+"""Benchmark the setup, the cycle, and the amg_core kernels of pyamg.
+
+Usage
+-----
+Run the suite and write the results to a JSON file::
+
+    python bench/bench.py --size small medium -o before.json
+
+Check the strong and weak scaling over a number of threads::
+
+    python bench/bench.py --threads 1 2 4 8 -o after.json
+
+Compare two runs, e.g. before and after a change::
+
+    python bench/bench.py --compare before.json after.json
+
+Each timing is the minimum over --repeat runs, so that the results are
+reproducible on a loaded machine.  The problems are generated by
+pyamg.gallery, and the right-hand sides from a fixed seed.
+"""
+from __future__ import print_function
+
+import argparse
+import json
+import platform
+import sys
+from timeit import default_timer
+
+import numpy as np
+import scipy as sp
+from scipy import sparse
+
+import pyamg
+from pyamg import amg_core
+from pyamg.gallery import poisson, linear_elasticity, stencil_grid
+from pyamg.gallery.diffusion import diffusion_stencil_2d
+from pyamg.strength import classical_strength_of_connection, \
+    symmetric_strength_of_connection
+from pyamg.aggregation.aggregate import standard_aggregation
+from pyamg.aggregation.tentative import fit_candidates
+from pyamg.util.profile import Profile
+from pyamg.util.utils import remove_diagonal
+
+SEED = 2357136044
+
+# number of points per dimension of each problem size, chosen so that the
+# number of unknowns grows by about 4x between sizes in 2D
+SIZES = {'small': (100, 16), 'medium': (200, 25), 'large': (400, 40),
+         'huge': (800, 64)}
+
+
+def poisson_2d(size):
+    n = SIZES[size][0]
+    return poisson((n, n), format='csr'), None
+
+
+def poisson_3d(size):
+    n = SIZES[size][1]
+    return poisson((n, n, n), format='csr'), None
+
+
+def anisotropic_2d(size):
+    n = SIZES[size][0]
+    stencil = diffusion_stencil_2d(epsilon=0.001, theta=np.pi / 8, type='FD')
+    return stencil_grid(stencil, (n, n), format='csr'), None
+
+
+def elasticity_2d(size):
+    n = SIZES[size][0] // 2
+    return linear_elasticity((n, n), format='bsr')
+
+
+PROBLEMS = [('poisson_2d', poisson_2d),
+            ('poisson_3d', poisson_3d),
+            ('anisotropic_2d', anisotropic_2d),
+            ('elasticity_2d', elasticity_2d)]
+
+
+def sa(A, B, profile):
+    return pyamg.smoothed_aggregation_solver(A, B=B, max_coarse=100,
+                                             profile=profile)
+
+
+def rs(A, B, profile):
+    return pyamg.ruge_stuben_solver(A.tocsr(), max_coarse=100,
+                                    profile=profile)
+
+
+SOLVERS = [('sa', sa), ('rs', rs)]
+
+
+def best_of(repeat, fn, reset=None):
+    """Return the minimum wall time of fn() over repeat runs."""
+    best = np.inf
+    for _ in range(repeat):
+        if reset is not None:
+            reset()
+        tic = default_timer()
+        fn()
+        best = min(best, default_timer() - tic)
+    return best
+
+
+def phase_table(table):
+    """Sum the seconds of each phase of a profile table over the levels."""
+    phases = {}
+    for (level, phase), entry in table.items():
+        phases[phase] = phases.get(phase, 0.0) + entry[1]
+    return phases
+
+
+def bench_solver(A, B, solver, repeat, tol=1e-8, maxiter=200):
+    """Time the setup phases and the solve of one solver on one problem.
+
+    The setup and solve times are measured without a profile, because a
+    profile times every amg_core kernel and disables the native cycle,
+    see multilevel_solver.solve.  The phases are then taken from one
+    separate, profiled setup and solve.
+    """
+    np.random.seed(SEED)
+    b = np.random.rand(A.shape[0])
+
+    setup = np.inf
+    for _ in range(repeat):
+        tic = default_timer()
+        ml = solver(A, B, None)
+        setup = min(setup, default_timer() - tic)
+
+    solve = np.inf
+    for _ in range(repeat):
+        residuals = []
+        tic = default_timer()
+        ml.solve(b, tol=tol, maxiter=maxiter, residuals=residuals)
+        solve = min(solve, default_timer() - tic)
+    cycles = len(residuals) - 1
+
+    profile = Profile(trace_memory=False)
+    profiled = solver(A, B, profile)
+    setup_phases = phase_table(profile.setup)
+    setup_kernels = dict((name, entry[1]) for name, entry
+                         in profile.kernels.items())
+    profiled.profile = Profile(trace_memory=False)
+    residuals_profiled = []
+    profiled.solve(b, tol=tol, maxiter=maxiter,
+                   residuals=residuals_profiled)
+    cycles_profiled = max(len(residuals_profiled) - 1, 1)
+    solve_phases = phase_table(profiled.profile.solve)
+
+    factor = (residuals[-1] / residuals[0])**(1.0 / max(cycles, 1))
+    return {'unknowns': A.shape[0],
+            'nnz': A.nnz,
+            'levels': len(ml.levels),
+            'operator_complexity': ml.operator_complexity(),
+            'grid_complexity': ml.grid_complexity(),
+            'setup': setup,
+            'setup_phases': setup_phases,
+            'setup_kernels': setup_kernels,
+            'solve': solve,
+            'cycles': cycles,
+            'cycle': solve / max(cycles, 1),
+            'cycle_phases': dict((phase, seconds / cycles_profiled)
+                                 for phase, seconds in solve_phases.items()),
+            'convergence_factor': factor}
+
+
+def bench_kernels(A, repeat):
+    """Time the raw amg_core kernels on the CSR matrix A.
+
+    The inputs are built outside of the timed region, so that the times
+    exclude the Python overhead of the setup routines that call them.
+    """
+    n = A.shape[0]
+    results = {}
+
+    np.random.seed(SEED)
+    b = np.random.rand(n)
+    x = np.zeros(n)
+    results['gauss_seidel'] = best_of(
+        repeat,
+        lambda: amg_core.gauss_seidel(A.indptr, A.indices, A.data, x, b,
+                                      0, n, 1),
+        reset=lambda: x.fill(0))
+
+    C = symmetric_strength_of_connection(A)
+    Tj = np.empty(n, dtype='intc')
+    Cpts = np.empty(n, dtype='intc')
+    results['standard_aggregation'] = best_of(
+        repeat,
+        lambda: amg_core.standard_aggregation(n, C.indptr, C.indices,
+                                              Tj, Cpts))
+
+    S = remove_diagonal(classical_strength_of_connection(A))
+    T = S.T.tocsr()
+    splitting = np.empty(n, dtype='intc')
+    influence = np.zeros(n, dtype='intc')
+    results['rs_cf_splitting'] = best_of(
+        repeat,
+        lambda: amg_core.rs_cf_splitting(n, S.indptr, S.indices,
+                                         T.indptr, T.indices,
+                                         influence, splitting),
+        reset=lambda: influence.fill(0))
+
+    # the first product of the energy-min smoother, A*T restricted to the
+    # sparsity pattern of A*T, for a scalar problem with one candidate
+    AggOp = standard_aggregation(C)[0]
+    Tent = fit_candidates(AggOp, np.ones((n, 1)))[0]
+    Absr = A.tobsr(blocksize=(1, 1))
+    AT = (Absr * Tent).tobsr(blocksize=(1, 1))
+    Sx = np.zeros(AT.data.size)
+    results['incomplete_mat_mult_bsr'] = best_of(
+        repeat,
+        lambda: amg_core.incomplete_mat_mult_bsr(
+            Absr.indptr, Absr.indices, np.ravel(Absr.data),
+            Tent.indptr, Tent.indices, np.ravel(Tent.data),
+            AT.indptr, AT.indices, Sx,
+            n, Tent.shape[1], 1, 1, 1),
+        reset=lambda: Sx.fill(0))
+
+    return results
+
+
+def bench_problems(args):
+    results = {}
+    for name, problem in PROBLEMS:
+        if args.problem and name not in args.problem:
+            continue
+        for size in args.size:
+            A, B = problem(size)
+            key = '%s/%s' % (name, size)
+            results[key] = {}
+            for solver_name, solver in SOLVERS:
+                if args.solver and solver_name not in args.solver:
+                    continue
+                results[key][solver_name] = bench_solver(A, B, solver,
+                                                         args.repeat)
+                report(key, solver_name, results[key][solver_name])
+            if sparse.isspmatrix_csr(A):
+                results[key]['kernels'] = bench_kernels(A, args.repeat)
+                report(key, 'kernels', results[key]['kernels'])
+    return results
+
+
+def bench_scaling(args):
+    """Strong and weak scaling of SA and the kernels for 2D Poisson.
+
+    The strong scaling keeps the problem of the first --size fixed, and the
+    weak scaling grows the number of unknowns with the number of threads.
+    """
+    results = {'strong': {}, 'weak': {}}
+    n = SIZES[args.size[0]][0]
+    saved = amg_core.set_num_threads(0)
+    try:
+        for threads in args.threads:
+            amg_core.set_num_threads(threads)
+            for kind, points in [('strong', n),
+                                 ('weak', int(round(n * np.sqrt(threads))))]:
+                A = poisson((points, points), format='csr')
+                entry = bench_solver(A, None, sa, args.repeat)
+                entry['kernels'] = bench_kernels(A, args.repeat)
+                results[kind][str(threads)] = entry
+                report('%s scaling, %d thread(s)' % (kind, threads), 'sa',
+                       entry)
+    finally:
+        amg_core.set_num_threads(saved)
+    return results
+
+
+def report(key, name, entry):
+    if name == 'kernels':
+        line = ', '.join('%s %.4fs' % item for item in sorted(entry.items()))
+    else:
+        line = 'setup %.4fs, %d cycles of %.4fs, factor %.3f' % \
+            (entry['setup'], entry['cycles'], entry['cycle'],
+             entry['convergence_factor'])
+    print('%-32s %-8s %s' % (key, name, line))
+    sys.stdout.flush()
+
+
+def metadata():
+    return {'pyamg': pyamg.__version__,
+            'git_revision': pyamg.__git_revision__,
+            'numpy': np.__version__,
+            'scipy': sp.__version__,
+            'python': platform.python_version(),
+            'platform': platform.platform(),
+            'processor': platform.processor(),
+            'threads': amg_core.set_num_threads(0)}
+
+
+def flatten(results, prefix=''):
+    """Map the nested timings of a run to {'a/b/c': seconds}."""
+    flat = {}
+    for key, value in results.items():
+        name = prefix + key
+        if isinstance(value, dict):
+            flat.update(flatten(value, name + '/'))
+        elif name.rsplit('/', 1)[-1] not in ['unknowns', 'nnz', 'levels',
+                                             'cycles']:
+            flat[name] = value
+    return flat
+
+
+def compare(before, after, threshold):
+    """Print the ratio after/before of the timings common to two runs."""
+    old = flatten(before['results'])
+    new = flatten(after['results'])
+    slower = 0
+    print('%-72s %10s %10s %7s' % ('', 'before', 'after', 'ratio'))
+    for key in sorted(set(old) & set(new)):
+        if not old[key] or key.endswith('complexity') or \
+                key.endswith('convergence_factor'):
+            ratio = None
+        else:
+            ratio = new[key] / old[key]
+        flag = ''
+        if ratio is not None and ratio > 1 + threshold:
+            flag = ' slower'
+            slower += 1
+        elif ratio is not None and ratio < 1 - threshold:
+            flag = ' faster'
+        print('%-72s %10.4g %10.4g %7s%s' %
+              (key, old[key], new[key],
+               '' if ratio is None else '%.3f' % ratio, flag))
+    return slower
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('--size', nargs='+', default=['small'],
+                        choices=sorted(SIZES, key=lambda s: SIZES[s]))
+    parser.add_argument('--problem', nargs='+',
+                        choices=[name for name, _ in PROBLEMS])
+    parser.add_argument('--solver', nargs='+',
+                        choices=[name for name, _ in SOLVERS])
+    parser.add_argument('--repeat', type=int, default=3)
+    parser.add_argument('--threads', nargs='+', type=int,
+                        help='also run the strong and weak scaling')
+    parser.add_argument('-o', '--output', help='write the results as JSON')
+    parser.add_argument('--compare', nargs=2, metavar=('BEFORE', 'AFTER'),
+                        help='compare two JSON results instead of running')
+    parser.add_argument('--threshold', type=float, default=0.1,
+                        help='relative change reported by --compare')
+    args = parser.parse_args(argv)
+
+    if args.compare:
+        with open(args.compare[0]) as f:
+            before = json.load(f)
+        with open(args.compare[1]) as f:
+            after = json.load(f)
+        return 1 if compare(before, after, args.threshold) else 0
+
+    run = {'metadata': metadata(), 'results': bench_problems(args)}
+    if args.threads:
+        run['results']['scaling'] = bench_scaling(args)
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump(run, f, indent=1, sort_keys=True)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -6,7 +6,8 @@ import scipy.sparse as sparse
 from pyamg import amg_core
 from pyamg.graph import lloyd_cluster
 
-__all__ = ['standard_aggregation', 'naive_aggregation', 'lloyd_aggregation', 'balanced_lloyd_aggregation']
+__all__ = ['standard_aggregation', 'naive_aggregation', 'parallel_aggregation',
+           'lloyd_aggregation', 'balanced_lloyd_aggregation']
 
 
 def standard_aggregation(C):
@@ -177,6 +178,82 @@ def naive_aggregation(C):
         return sparse.csr_matrix((Tx, Tj, Tp), shape=shape), Cpts
 
 
+def parallel_aggregation(C):
+    """Compute the sparsity pattern of the tentative prolongator in parallel.
+
+    Parameters
+    ----------
+    C : csr_matrix
+        strength of connection matrix
+
+    Returns
+    -------
+    AggOp : csr_matrix
+        aggregation operator which determines the sparsity pattern
+        of the tentative prolongator
+    Cpts : array
+        array of Cpts, i.e., Cpts[i] = root node of aggregate i
+
+    Examples
+    --------
+    >>> from scipy.sparse import csr_matrix
+    >>> from pyamg.aggregation.aggregate import parallel_aggregation
+    >>> A = csr_matrix([[1,0,0],[0,1,1],[0,1,1]])
+    >>> A.toarray()                      # first vertex is isolated
+    matrix([[1, 0, 0],
+            [0, 1, 1],
+            [0, 1, 1]])
+    >>> parallel_aggregation(A)[0].toarray() # one aggregate
+    matrix([[0],
+            [1],
+            [1]], dtype=int8)
+
+    See Also
+    --------
+    amg_core.parallel_aggregation, maximal_independent_set
+
+    Notes
+    -----
+    The root nodes are a distance-2 maximal independent set of C, computed
+    with random weights, so that no two roots share a neighbor.  Each root
+    is aggregated with its neighbors, and the remaining nodes join a
+    neighboring aggregate.  Every step is threaded in amg_core, unlike the
+    greedy sweep in standard_aggregation.  The aggregates depend on the
+    state of np.random, but not on the number of threads.
+
+    """
+    if not sparse.isspmatrix_csr(C):
+        raise TypeError('expected csr_matrix')
+
+    if C.shape[0] != C.shape[1]:
+        raise ValueError('expected square matrix')
+
+    index_type = C.indptr.dtype
+    num_rows = C.shape[0]
+
+    Tj = np.empty(num_rows, dtype=index_type)  # stores the aggregate #s
+    Cpts = np.empty(num_rows, dtype=index_type)  # stores the Cpts
+
+    fn = amg_core.parallel_aggregation
+
+    num_aggregates = fn(num_rows, C.indptr, C.indices, Tj, Cpts,
+                        np.random.rand(num_rows))
+    Cpts = Cpts[:num_aggregates]
+
+    if num_aggregates == 0:
+        # return all zero matrix and no Cpts
+        return sparse.csr_matrix((num_rows, 1), dtype='int8'),\
+            np.array([], dtype=index_type)
+    else:
+        shape = (num_rows, num_aggregates)
+        # isolated nodes are not aggregated
+        mask = Tj != -1
+        row = np.arange(num_rows, dtype=index_type)[mask]
+        col = Tj[mask]
+        data = np.ones(len(col), dtype='int8')
+        return sparse.coo_matrix((data, (row, col)), shape=shape).tocsr(), Cpts
+
+
 def lloyd_aggregation(C, ratio=0.03, distance='unit', maxiter=10):
     """Aggregate nodes using Lloyd Clustering.
 
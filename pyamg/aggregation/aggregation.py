@@ -3,21 +3,24 @@ from __future__ import absolute_import
 
 
 from warnings import warn
+from functools import partial
 import numpy as np
 from scipy.sparse import csr_matrix, isspmatrix_csr, isspmatrix_bsr,\
     SparseEfficiencyWarning
 
 from pyamg.multilevel import multilevel_solver
+from pyamg.util.profile import Profile, null_profile
 from pyamg.relaxation.smoothing import change_smoothers
 from pyamg.util.utils import relaxation_as_linear_operator,\
     eliminate_diag_dom_nodes, blocksize,\
-    levelize_strength_or_aggregation, levelize_smooth_or_improve_candidates
+    levelize_strength_or_aggregation, levelize_smooth_or_improve_candidates,\
+    galerkin_product
 from pyamg.strength import classical_strength_of_connection,\
     symmetric_strength_of_connection, evolution_strength_of_connection,\
     energy_based_strength_of_connection, distance_strength_of_connection,\
     algebraic_distance, affinity_distance
 from .aggregate import standard_aggregation, naive_aggregation,\
-    lloyd_aggregation
+    parallel_aggregation, lloyd_aggregation
 from .tentative import fit_candidates
 from .smooth import jacobi_prolongation_smoother,\
     richardson_prolongation_smoother, energy_prolongation_smoother
@@ -39,7 +42,7 @@ def smoothed_aggregation_solver(A, B=None, BH=None,
                                                     None],
                                 max_levels=10, max_coarse=10,
                                 diagonal_dominance=False,
-                                keep=False, **kwargs):
+                                keep=False, profile=False, **kwargs):
     """Create a multilevel solver using classical-style Smoothed Aggregation (SA).
 
     Parameters
@@ -73,8 +76,10 @@ def smoothed_aggregation_solver(A, B=None, BH=None,
 
     aggregate : string or list
         Method used to aggregate nodes.
-        Choose from 'standard', 'lloyd', 'naive',
-        ('predefined', {'AggOp' : csr_matrix})
+        Choose from 'standard', 'lloyd', 'naive', 'parallel',
+        ('predefined', {'AggOp' : csr_matrix}).  'parallel' seeds the
+        aggregates with a distance-2 maximal independent set and is threaded,
+        see parallel_aggregation.
 
     smooth : list
         Method used to smooth the tentative prolongator.  Method-specific
@@ -113,8 +118,15 @@ def smoothed_aggregation_solver(A, B=None, BH=None,
 
     keep : bool
         Flag to indicate keeping extra operators in the hierarchy for
-        diagnostics.  For example, if True, then strength of connection (C),
-        tentative prolongation (T), and aggregation (AggOp) are kept.
+        diagnostics.  For example, if True, then strength of connection (C)
+        and tentative prolongation (T) are kept.  The aggregation (AggOp) is
+        always kept, for multilevel_solver.update.
+
+    profile : bool, Profile
+        If True, or a pyamg.util.profile.Profile, then the wall time and the
+        memory allocated by each phase of the setup on each level, and by
+        each component of the cycle in ml.solve, are recorded in ml.profile.
+        See multilevel_solver.profile_summary.
 
     Other Parameters
     ----------------
@@ -127,6 +139,22 @@ def smoothed_aggregation_solver(A, B=None, BH=None,
         ['splu', 'lu', ...] or a callable function, and args is a dictionary of
         arguments to be passed to fn.
 
+    cycle_dtype : dtype
+        Precision of the hierarchy, e.g. np.float32 to store and cycle the
+        hierarchy in single precision while solve iterates on A in double
+        precision.  See multilevel_solver.
+
+    reorder : {None, 'rcm', 'aggregate'}
+        Permute the unknowns of each level for the locality of the cycle,
+        by reverse Cuthill-McKee, or by the aggregates of the setup.  solve
+        still takes and returns vectors in the ordering of A.  See
+        multilevel_solver.
+
+    compress : bool
+        Store the coarse level matrices and the prolongators in compressed
+        formats, with 16-bit column offsets or by the aggregate map of a
+        tentative prolongator.  See multilevel_solver.
+
     Returns
     -------
     ml : multilevel_solver
@@ -190,6 +218,10 @@ def smoothed_aggregation_solver(A, B=None, BH=None,
           A.shape[0] and Agg1.shape[1] == Agg0.shape[0].  Each AggOp is a
           csr_matrix.
 
+        - For an operator whose values change while its sparsity pattern
+          does not, ml.update(A) recomputes the hierarchy with the same
+          aggregates, see multilevel_solver.update.
+
     Examples
     --------
     >>> from pyamg import smoothed_aggregation_solver
@@ -274,24 +306,39 @@ def smoothed_aggregation_solver(A, B=None, BH=None,
     if A.symmetry == 'nonsymmetric':
         levels[-1].BH = BH    # left candidates
 
-    while len(levels) < max_levels and\
-            int(levels[-1].A.shape[0]/blocksize(levels[-1].A)) > max_coarse:
-        extend_hierarchy(levels, strength, aggregate, smooth,
-                         improve_candidates, diagonal_dominance, keep)
-
-    ml = multilevel_solver(levels, **kwargs)
-    change_smoothers(ml, presmoother, postsmoother)
+    if profile is True:
+        profile = Profile()
+    elif not profile:
+        profile = None
+
+    with (profile or null_profile).timing_kernels():
+        while len(levels) < max_levels and\
+                int(levels[-1].A.shape[0]/blocksize(levels[-1].A)) > max_coarse:
+            extend_hierarchy(levels, strength, aggregate, smooth,
+                             improve_candidates, diagonal_dominance, keep,
+                             profile)
+
+        ml = multilevel_solver(levels, profile=profile, **kwargs)
+        change_smoothers(ml, presmoother, postsmoother)
+    ml.updater = partial(update_hierarchy, B=B, BH=BH, strength=strength,
+                         smooth=smooth, improve_candidates=improve_candidates,
+                         diagonal_dominance=diagonal_dominance, keep=keep)
     return ml
 
 
 def extend_hierarchy(levels, strength, aggregate, smooth, improve_candidates,
-                     diagonal_dominance=False, keep=True):
+                     diagonal_dominance=False, keep=True, profile=None,
+                     previous=None):
     """Extend the multigrid hierarchy.
 
     Service routine to implement the strength of connection, aggregation,
     tentative prolongation construction, and prolongation smoothing.  Called by
     smoothed_aggregation_solver.
 
+    If previous is given, it is the list of levels of a previous hierarchy
+    with the same aggregates, and the sparsity patterns of its P, R, and
+    coarse A are tried for those of the new level, see update_hierarchy.
+
     """
     def unpack_arg(v):
         if isinstance(v, tuple):
@@ -299,6 +346,11 @@ def extend_hierarchy(levels, strength, aggregate, smooth, improve_candidates,
         else:
             return v, {}
 
+    if profile is None:
+        profile = null_profile
+    lvl = len(levels) - 1
+    profile.start()
+
     A = levels[-1].A
     B = levels[-1].B
     if A.symmetry == "nonsymmetric":
@@ -338,6 +390,8 @@ def extend_hierarchy(levels, strength, aggregate, smooth, improve_candidates,
     if flag:
         C = eliminate_diag_dom_nodes(A, C, **kwargs)
 
+    profile.lap('setup', lvl, 'strength')
+
     # Compute the aggregation matrix AggOp (i.e., the nodal coarsening of A).
     # AggOp is a boolean matrix, where the sparsity pattern for the k-th column
     # denotes the fine-grid nodes agglomerated into k-th coarse-grid node.
@@ -346,6 +400,8 @@ def extend_hierarchy(levels, strength, aggregate, smooth, improve_candidates,
         AggOp = standard_aggregation(C, **kwargs)[0]
     elif fn == 'naive':
         AggOp = naive_aggregation(C, **kwargs)[0]
+    elif fn == 'parallel':
+        AggOp = parallel_aggregation(C, **kwargs)[0]
     elif fn == 'lloyd':
         AggOp = lloyd_aggregation(C, **kwargs)[0]
     elif fn == 'predefined':
@@ -353,6 +409,8 @@ def extend_hierarchy(levels, strength, aggregate, smooth, improve_candidates,
     else:
         raise ValueError('unrecognized aggregation method %s' % str(fn))
 
+    profile.lap('setup', lvl, 'aggregate')
+
     # Improve near nullspace candidates by relaxing on A B = 0
     fn, kwargs = unpack_arg(improve_candidates[len(levels)-1])
     if fn is not None:
@@ -363,6 +421,8 @@ def extend_hierarchy(levels, strength, aggregate, smooth, improve_candidates,
             BH = relaxation_as_linear_operator((fn, kwargs), AH, b) * BH
             levels[-1].BH = BH
 
+    profile.lap('setup', lvl, 'candidates')
+
     # Compute the tentative prolongator, T, which is a tentative interpolation
     # matrix from the coarse-grid to the fine-grid.  T exactly interpolates
     # B_fine = T B_coarse.
@@ -370,9 +430,13 @@ def extend_hierarchy(levels, strength, aggregate, smooth, improve_candidates,
     if A.symmetry == "nonsymmetric":
         TH, BH = fit_candidates(AggOp, BH)
 
+    profile.lap('setup', lvl, 'tentative')
+
     # Smooth the tentative prolongator, so that it's accuracy is greatly
     # improved for algebraically smooth error.
     fn, kwargs = unpack_arg(smooth[len(levels)-1])
+    if fn == 'jacobi' and previous is not None:
+        kwargs = dict(kwargs, pattern=previous[lvl].P)
     if fn == 'jacobi':
         P = jacobi_prolongation_smoother(A, T, C, B, **kwargs)
     elif fn == 'richardson':
@@ -396,6 +460,8 @@ def extend_hierarchy(levels, strength, aggregate, smooth, improve_candidates,
         R = P.T
     elif symmetry == 'nonsymmetric':
         fn, kwargs = unpack_arg(smooth[len(levels)-1])
+        if fn == 'jacobi' and previous is not None:
+            kwargs = dict(kwargs, pattern=previous[lvl].R.H)
         if fn == 'jacobi':
             R = jacobi_prolongation_smoother(AH, TH, C, BH, **kwargs).H
         elif fn == 'richardson':
@@ -410,19 +476,90 @@ def extend_hierarchy(levels, strength, aggregate, smooth, improve_candidates,
             raise ValueError('unrecognized prolongation smoother method %s' %
                              str(fn))
 
+    profile.lap('setup', lvl, 'smooth')
+
     if keep:
         levels[-1].C = C  # strength of connection matrix
-        levels[-1].AggOp = AggOp  # aggregation operator
         levels[-1].T = T  # tentative prolongator
 
+    levels[-1].AggOp = AggOp  # aggregation operator
+
     levels[-1].P = P  # smoothed prolongator
     levels[-1].R = R  # restriction operator
 
     levels.append(multilevel_solver.level())
-    A = R * A * P              # Galerkin operator
+    if previous is None:
+        A = galerkin_product(R, A, P)  # Galerkin operator
+    else:
+        A = galerkin_product(R, A, P, pattern=previous[lvl + 1].A)
     A.symmetry = symmetry
+    profile.lap('setup', lvl, 'RAP')
     levels[-1].A = A
     levels[-1].B = B           # right near nullspace candidates
 
     if A.symmetry == "nonsymmetric":
         levels[-1].BH = BH     # left near nullspace candidates
+
+
+def update_hierarchy(levels, A, B, BH, strength, smooth, improve_candidates,
+                     diagonal_dominance=False, keep=False, profile=None,
+                     previous=None):
+    """Recompute an SA hierarchy for a new operator with the same aggregates.
+
+    Service routine for multilevel_solver.update.  The hierarchy is rebuilt
+    with extend_hierarchy from A and the near nullspace candidates B (and
+    BH) of the setup, before improve_candidates, with the aggregation
+    predefined by the AggOp of each level.  The strength of connection is
+    predefined by the C of each level if it was kept, recomputed if the
+    prolongation smoother needs it, and skipped otherwise.
+
+    The AggOp of each level is kept for the update whether or not keep is
+    set, while C and T are kept only with keep=True, as in the setup.
+
+    The sparsity patterns of the P, R (for a nonsymmetric A) and coarse A
+    of each level of previous, by default levels, are tried for the new
+    level, so that the Jacobi prolongation smoother and the Galerkin
+    product only recompute the values where the patterns still hold, see
+    jacobi_prolongation_smoother and galerkin_product.  The patterns must
+    be in the order and format of the setup, see multilevel_solver.update.
+
+    Returns
+    -------
+    levels : list
+        The new levels, with the same sizes as levels
+
+    """
+    def unpack_arg(v):
+        if isinstance(v, tuple):
+            return v[0], v[1]
+        else:
+            return v, {}
+
+    aggregate = []
+    level_strength = []
+    for lvl, level in enumerate(levels[:-1]):
+        aggregate.append(('predefined', {'AggOp': level.AggOp}))
+        fn, kwargs = unpack_arg(smooth[lvl])
+        if hasattr(level, 'C'):
+            level_strength.append(('predefined', {'C': level.C}))
+        elif fn == 'energy' or (fn == 'jacobi' and kwargs.get('filter')):
+            level_strength.append(strength[lvl])
+        else:
+            # C is only used to aggregate
+            level_strength.append(None)
+
+    if previous is None:
+        previous = levels
+
+    new_levels = [multilevel_solver.level()]
+    new_levels[0].A = A
+    new_levels[0].B = B
+    if A.symmetry == 'nonsymmetric':
+        new_levels[0].BH = BH
+
+    while len(new_levels) < len(levels):
+        extend_hierarchy(new_levels, level_strength, aggregate, smooth,
+                         improve_candidates, diagonal_dominance, keep,
+                         profile, previous=previous)
+
+    return new_levels
@@ -13,7 +13,7 @@ from pyamg.util.utils import relaxation_as_linear_operator,\
     scale_T, get_Cpt_params, \
     eliminate_diag_dom_nodes, blocksize, \
     levelize_strength_or_aggregation, \
-    levelize_smooth_or_improve_candidates
+    levelize_smooth_or_improve_candidates, galerkin_product
 from pyamg.strength import classical_strength_of_connection,\
     symmetric_strength_of_connection, evolution_strength_of_connection,\
     energy_based_strength_of_connection, distance_strength_of_connection,\
@@ -131,6 +131,22 @@ def rootnode_solver(A, B=None, BH=None,
         ['splu', 'lu', ...] or a callable function, and args is a dictionary of
         arguments to be passed to fn.
 
+    cycle_dtype : dtype
+        Precision of the hierarchy, e.g. np.float32 to store and cycle the
+        hierarchy in single precision while solve iterates on A in double
+        precision.  See multilevel_solver.
+
+    reorder : {None, 'rcm', 'aggregate'}
+        Permute the unknowns of each level for the locality of the cycle,
+        by reverse Cuthill-McKee, or by the aggregates of the setup.  solve
+        still takes and returns vectors in the ordering of A.  See
+        multilevel_solver.
+
+    compress : bool
+        Store the coarse level matrices and the prolongators in compressed
+        formats, with 16-bit column offsets or by the aggregate map of a
+        tentative prolongator.  See multilevel_solver.
+
     Returns
     -------
     ml : multilevel_solver
@@ -457,7 +473,7 @@ def extend_hierarchy(levels, strength, aggregate, smooth, improve_candidates,
     levels[-1].Cpts = Cpt_params[1]['Cpts']      # Cpts (i.e., rootnodes)
 
     levels.append(multilevel_solver.level())
-    A = R * A * P                                 # Galerkin operator
+    A = galerkin_product(R, A, P)                 # Galerkin operator
     A.symmetry = symmetry
     levels[-1].A = A
     levels[-1].B = B                          # right near nullspace candidates
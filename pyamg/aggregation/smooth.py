@@ -7,7 +7,7 @@ import scipy.sparse as sparse
 import scipy.linalg as la
 from pyamg.util.utils import scale_rows, get_diagonal, get_block_diag, \
     UnAmal, filter_operator, compute_BtBinv, filter_matrix_rows, \
-    truncate_rows
+    truncate_rows, _in_pattern
 from pyamg.util.linalg import approximate_spectral_radius
 import pyamg.amg_core
 
@@ -61,7 +61,8 @@ def Satisfy_Constraints(U, B, BtBinv):
 
 
 def jacobi_prolongation_smoother(S, T, C, B, omega=4.0/3.0, degree=1,
-                                 filter=False, weighting='diagonal'):
+                                 filter=False, weighting='diagonal',
+                                 pattern=None):
     """Jacobi prolongation smoother.
 
     Parameters
@@ -87,6 +88,10 @@ def jacobi_prolongation_smoother(S, T, C, B, omega=4.0/3.0, degree=1,
         estimates.
         'block' uses a block diagonal inverse of A if A is BSR
         'diagonal' uses classic Jacobi with D = diagonal(A)
+    pattern : bsr_matrix
+        Optional previous prolongator, e.g. of the same level of a hierarchy
+        with the same aggregates, whose sparsity pattern is tried for P
+        before it is computed, see Notes
 
     Returns
     -------
@@ -102,6 +107,13 @@ def jacobi_prolongation_smoother(S, T, C, B, omega=4.0/3.0, degree=1,
     for the spectral radius approximation.  For precise reproducibility,
     set numpy.random.seed(..) to the same value before each test.
 
+    The pattern is only used for one unfiltered step with 'diagonal' or
+    'local' weighting of a T with at most one block per block row, which is
+    smoothed by amg_core.  If every block of P falls in the pattern, the
+    symbolic pass is skipped and P shares the index arrays of pattern,
+    unless some of its blocks are zero.  Otherwise P is computed as without
+    pattern, so the result is the same either way.
+
     Examples
     --------
     >>> from pyamg.aggregation import jacobi_prolongation_smoother
@@ -138,6 +150,11 @@ def jacobi_prolongation_smoother(S, T, C, B, omega=4.0/3.0, degree=1,
             if S.blocksize[0] == 1:
                 weighting = 'diagonal'
 
+    if not filter and degree == 1 and weighting in ['diagonal', 'local'] and\
+            _tentative_blocks(S, T):
+        # one step with the common sparsity of a tentative prolongator
+        return _fused_jacobi_prolongation(S, T, omega, weighting, pattern)
+
     if filter:
         # Implement filtered prolongation smoothing for the general case by
         # utilizing satisfy constraints
@@ -203,6 +220,99 @@ def jacobi_prolongation_smoother(S, T, C, B, omega=4.0/3.0, degree=1,
     return P
 
 
+def _tentative_blocks(S, T):
+    """Whether T has at most one block per block row of S.
+
+    This is the case, e.g., for the tentative prolongator of fit_candidates,
+    which jacobi_prolongation_smoother then smooths in amg_core.
+    """
+    if not sparse.isspmatrix_bsr(T) or T.dtype != S.dtype:
+        return False
+    if sparse.isspmatrix_csr(S):
+        RowsPerBlock = 1
+    elif sparse.isspmatrix_bsr(S) and S.blocksize[0] == S.blocksize[1]:
+        RowsPerBlock = S.blocksize[0]
+    else:
+        return False
+    return T.blocksize[0] == RowsPerBlock and np.all(np.diff(T.indptr) <= 1)
+
+
+def _fused_jacobi_prolongation(S, T, omega, weighting, pattern=None):
+    """Compute P = (I - omega D^-1 S) T for T with one block per block row.
+
+    The weights omega D^-1 of the rows are those of
+    jacobi_prolongation_smoother, and P is computed from S and T by
+    amg_core.jacobi_prolongation_pass1 and _pass2, without forming D^-1 S
+    or S T, or in the sparsity pattern of a previous P by
+    amg_core.jacobi_prolongation_values.  Zero blocks, e.g., from
+    cancellation, are removed from P.
+
+    T is computed beforehand by fit_candidates, which is not fused into
+    these passes: a block row of P needs the blocks of T of the neighbors
+    of the row, which are in other aggregates, so every aggregate has to
+    be factored before any row is smoothed.
+    """
+    from scipy.sparse.linalg import LinearOperator
+
+    if weighting == 'diagonal':
+        D_inv = get_diagonal(S, inv=True)
+
+        def matvec(x):
+            return D_inv * (S * np.ravel(x))
+
+        D_inv_S = LinearOperator(S.shape, matvec=matvec, dtype=S.dtype)
+        w = (omega/approximate_spectral_radius(D_inv_S))*D_inv
+    else:
+        D = np.ravel(np.abs(S)*np.ones((S.shape[0], 1), dtype=S.dtype))
+        D_inv = np.zeros_like(D)
+        D_inv[D != 0] = 1.0 / np.abs(D[D != 0])
+        w = omega*D_inv
+    w = np.asarray(w, dtype=S.dtype)
+
+    if sparse.isspmatrix_bsr(S):
+        RowsPerBlock = S.blocksize[0]
+    else:
+        RowsPerBlock = 1
+    ColsPerBlock = T.blocksize[1]
+    n_brow = int(T.shape[0] / RowsPerBlock)
+    n_bcol = int(T.shape[1] / ColsPerBlock)
+
+    index_type = S.indptr.dtype
+    Tp = T.indptr.astype(index_type, copy=False)
+    Tj = T.indices.astype(index_type, copy=False)
+
+    if sparse.isspmatrix_bsr(pattern) and pattern.shape == T.shape and \
+            pattern.blocksize == T.blocksize and \
+            pattern.indices.dtype == index_type:
+        Px = np.empty(pattern.nnz, dtype=S.dtype)
+        misses = pyamg.amg_core.jacobi_prolongation_values(
+            n_brow, n_bcol, S.indptr, S.indices, np.ravel(S.data),
+            Tp, Tj, np.ravel(T.data), w, pattern.indptr, pattern.indices, Px,
+            RowsPerBlock, ColsPerBlock)
+        if misses == 0:
+            Px = Px.reshape(-1, RowsPerBlock, ColsPerBlock)
+            return _in_pattern(sparse.bsr_matrix, Px, pattern,
+                               Px.any(axis=(1, 2)))
+
+    Pp = np.empty(n_brow + 1, dtype=index_type)
+    pyamg.amg_core.jacobi_prolongation_pass1(n_brow, n_bcol,
+                                             S.indptr, S.indices, Tp, Tj, Pp)
+    Pj = np.empty(Pp[-1], dtype=index_type)
+    Px = np.empty(Pp[-1] * RowsPerBlock * ColsPerBlock, dtype=S.dtype)
+    pyamg.amg_core.jacobi_prolongation_pass2(n_brow, n_bcol,
+                                             S.indptr, S.indices,
+                                             np.ravel(S.data),
+                                             Tp, Tj, np.ravel(T.data), w,
+                                             Pp, Pj, Px,
+                                             RowsPerBlock, ColsPerBlock)
+
+    P = sparse.bsr_matrix((Px.reshape(-1, RowsPerBlock, ColsPerBlock),
+                           Pj, Pp), shape=T.shape)
+    P.has_sorted_indices = True
+    P.eliminate_zeros()
+    return P
+
+
 def richardson_prolongation_smoother(S, T, omega=4.0/3.0, degree=1):
     """Richardson prolongation smoother.
 
@@ -3,7 +3,9 @@ import scipy.sparse as sparse
 
 from pyamg.gallery import poisson, load_example
 from pyamg.strength import symmetric_strength_of_connection
-from pyamg.aggregation.aggregate import standard_aggregation, naive_aggregation
+from pyamg import amg_core
+from pyamg.aggregation.aggregate import standard_aggregation, naive_aggregation,\
+    parallel_aggregation
 
 from numpy.testing import TestCase, assert_equal
 
@@ -63,6 +65,56 @@ class TestAggregate(TestCase):
         assert_equal(result.toarray(), expected)
         assert_equal(Cpts.shape[0], 4)
 
+    def test_parallel_aggregation(self):
+        for A in self.cases:
+            S = symmetric_strength_of_connection(A)
+            S.data[:] = 1
+            (result, Cpts) = parallel_aggregation(S)
+
+            # every node with a neighbor is in exactly one aggregate
+            G = S - sparse.diags(S.diagonal())
+            G.eliminate_zeros()
+            expected = (np.diff(G.indptr) > 0).astype(int)
+            assert_equal(np.ravel(result.sum(axis=1)), expected)
+
+            # Cpts[k] is a member of aggregate k
+            assert_equal(result[Cpts, np.arange(len(Cpts))],
+                         np.ones((1, len(Cpts))))
+
+            if (G - G.T).nnz == 0:
+                # the roots are a distance-2 independent set
+                G2 = (G + G * G).tocsr()[Cpts, :][:, Cpts]
+                G2.setdiag(0)
+                G2.eliminate_zeros()
+                assert_equal(G2.nnz, 0)
+
+                # every node is at most distance 2 from its root
+                I = sparse.eye(S.shape[0], format='csr')
+                D2 = (I + G + G * G).tocsr()[Cpts, :].T
+                near = np.ravel(D2.multiply(result).sum(axis=1))
+                assert_equal(near > 0, expected > 0)
+
+        # S is diagonal - no dofs aggregated
+        S = sparse.spdiags([[1, 1, 1, 1]], [0], 4, 4, format='csr')
+        (result, Cpts) = parallel_aggregation(S)
+        expected = np.array([[0], [0], [0], [0]])
+        assert_equal(result.toarray(), expected)
+        assert_equal(Cpts.shape[0], 0)
+
+    def test_parallel_aggregation_threads(self):
+        S = symmetric_strength_of_connection(poisson((50, 50), format='csr'))
+        num_threads = amg_core.set_num_threads(0)
+        try:
+            results = []
+            for t in [1, 4]:
+                amg_core.set_num_threads(t)
+                np.random.seed(0)
+                results.append(parallel_aggregation(S))
+            assert_equal((results[0][0] - results[1][0]).nnz, 0)
+            assert_equal(results[0][1], results[1][1])
+        finally:
+            amg_core.set_num_threads(num_threads)
+
 
 class TestComplexAggregate(TestCase):
     def setUp(self):
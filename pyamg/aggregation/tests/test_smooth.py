@@ -281,6 +281,44 @@ class TestEnergyMin(TestCase):
             assert_array_almost_equal(result.indices, exact.indices)
             assert_array_almost_equal(result.indptr, exact.indptr)
 
+    def test_incomplete_mat_mult_bsr_blocksizes(self):
+        # square blocks in A of size 1, 2, 3 and 6 use unrolled kernels,
+        # and the result must not depend on the number of threads
+        from pyamg import amg_core
+        np.random.seed(1208983)
+        num_threads = amg_core.set_num_threads(0)
+        try:
+            for bs, bcol in [(1, 1), (2, 3), (3, 6), (6, 6), (4, 2)]:
+                n = 12*bs
+                A = sparse.random(n, n, density=0.2, format='csr')
+                A = (A + sparse.eye(n)).tobsr(blocksize=(bs, bs))
+                B = sparse.random(n, 6*bcol, density=0.3, format='csr')
+                B = B.tobsr(blocksize=(bs, bcol))
+                mask = sparse.random(n, 6*bcol, density=0.5, format='csr')
+                mask = mask.tobsr(blocksize=(bs, bcol))
+                exact = (A*B).toarray() * (mask.toarray() != 0)
+
+                results = []
+                for threads in [1, 4]:
+                    amg_core.set_num_threads(threads)
+                    result = mask.copy()
+                    result.data[:] = 0.0
+                    incomplete_mat_mult_bsr(A.indptr, A.indices,
+                                            np.ravel(A.data),
+                                            B.indptr, B.indices,
+                                            np.ravel(B.data),
+                                            result.indptr, result.indices,
+                                            np.ravel(result.data),
+                                            int(A.shape[0] / bs),
+                                            int(result.shape[1] / bcol),
+                                            bs, bs, bcol)
+                    results.append(result)
+
+                assert_array_almost_equal(results[0].toarray(), exact)
+                assert_equal(results[0].data, results[1].data)
+        finally:
+            amg_core.set_num_threads(num_threads)
+
     def test_range(self):
         warnings.filterwarnings('ignore', category=UserWarning,
                                 message='Having less target vectors')
@@ -591,6 +629,64 @@ class TestEnergyMin(TestCase):
             assert_equal(ml_nofilter.levels[0].P.nnz >
                          ml_filter.levels[0].P.nnz, True)
 
+
+class TestJacobiProlongation(TestCase):
+    def test_fused(self):
+        # one step on a tentative prolongator is computed in amg_core
+        from pyamg import amg_core
+        from pyamg.aggregation import jacobi_prolongation_smoother
+        from pyamg.aggregation.aggregate import standard_aggregation
+        from pyamg.aggregation.tentative import fit_candidates
+        from pyamg.strength import symmetric_strength_of_connection
+        from pyamg.util.linalg import approximate_spectral_radius
+        from pyamg.util.utils import get_diagonal, scale_rows
+        np.random.seed(2371687351)
+
+        cases = []
+        A = poisson((15, 15), format='csr')
+        cases.append((A, np.ones((A.shape[0], 1))))
+        cases.append((A, np.random.rand(A.shape[0], 2)))
+        cases.append((A.astype(complex) * (1.0 + 1.0j),
+                      np.ones((A.shape[0], 1), dtype=complex)))
+        cases.append(linear_elasticity((7, 7), format='bsr'))
+
+        for A, B in cases:
+            C = symmetric_strength_of_connection(A)
+            AggOp = standard_aggregation(C)[0]
+            T = fit_candidates(AggOp, B.astype(A.dtype))[0]
+
+            for weighting in ['diagonal', 'local']:
+                np.random.seed(2112648147)
+                P = jacobi_prolongation_smoother(A, T, C, B,
+                                                 weighting=weighting)
+                assert(sparse.isspmatrix_bsr(P))
+                assert_equal(P.blocksize, T.blocksize)
+
+                # P = T - omega D^-1 A T as sparse products
+                np.random.seed(2112648147)
+                if weighting == 'diagonal':
+                    D_inv_S = scale_rows(A, get_diagonal(A, inv=True))
+                    D_inv_S = D_inv_S / approximate_spectral_radius(D_inv_S)
+                else:
+                    D = np.abs(A) * np.ones(A.shape[0])
+                    D_inv_S = scale_rows(A, 1.0 / D)
+                exact = (T - (4.0/3.0) * D_inv_S * T).toarray()
+                assert_array_almost_equal(P.toarray(), exact)
+
+                # no zero blocks, and the result does not depend on the
+                # number of threads
+                assert(np.all(np.abs(P.data).max(axis=(1, 2)) > 0))
+                num_threads = amg_core.set_num_threads(0)
+                try:
+                    amg_core.set_num_threads(4)
+                    np.random.seed(2112648147)
+                    P4 = jacobi_prolongation_smoother(A, T, C, B,
+                                                      weighting=weighting)
+                finally:
+                    amg_core.set_num_threads(num_threads)
+                assert_equal(P4.indices, P.indices)
+                assert_equal(P4.data, P.data)
+
 # class TestSatisfyConstaints(TestCase):
 #    def test_scalar(self):
 #
@@ -6,6 +6,15 @@ from .evolution_strength import *
 from .graph import *
 from .krylov import *
 from .linalg import *
+from .parallel import *
 from .relaxation import *
 from .ruge_stuben import *
 from .smoothed_aggregation import *
+from .sparse import *
+
+# PYAMG_NUM_THREADS sets the number of threads for the threaded kernels,
+# otherwise the OpenMP runtime default (OMP_NUM_THREADS) is used.  Like
+# set_num_threads, it applies to the kernels called from any thread
+import os as _os
+if _os.environ.get('PYAMG_NUM_THREADS'):
+    set_num_threads(int(_os.environ['PYAMG_NUM_THREADS']))
@@ -0,0 +1,127 @@
+#ifndef BIND_ARRAYS_H
+#define BIND_ARRAYS_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+
+namespace py = pybind11;
+
+/*
+ *  Array types of the arguments of the generated bindings, see
+ *  bindthem.py.
+ *
+ *  An output, i.e., an array that a kernel writes to, is bound as
+ *  output_array<T> with py::arg().noconvert(), so that it must be a
+ *  C-contiguous array of dtype T.  Any other array is rejected with a
+ *  TypeError, rather than copied to a temporary that the kernel would
+ *  write to instead.
+ *
+ *  An input, i.e., an array that a kernel only reads, is bound as
+ *  input_array<T>.  A C-contiguous array of dtype T is passed without a
+ *  copy, so that a kernel instantiated for both int and int64_t indices
+ *  takes the indices of either dtype as they are.  Only if no overload of
+ *  a function accepts all of its arguments as they are, i.e., in the
+ *  second pass of the overload resolution of pybind11, is an input copied
+ *  to a C-contiguous array of dtype T, and only if numpy casts its dtype
+ *  to T safely.  If the environment variable PYAMG_DEBUG_CONVERSIONS is
+ *  set, each such copy is reported with a RuntimeWarning.
+ *
+ */
+template<class T>
+using output_array = py::array_t<T, py::array::c_style>;
+
+template<class T>
+class input_array : public py::array_t<T, py::array::c_style>
+{
+public:
+    using py::array_t<T, py::array::c_style>::array_t;
+};
+
+
+/*
+ *  Report the copy of src, which was passed for an input of dtype,
+ *  with a RuntimeWarning if PYAMG_DEBUG_CONVERSIONS is set.
+ *
+ */
+inline void report_conversion(py::handle src, py::handle dtype)
+{
+    if (std::getenv("PYAMG_DEBUG_CONVERSIONS") == NULL) {
+        return; }
+
+    std::string from = Py_TYPE(src.ptr())->tp_name;
+    if (py::isinstance<py::array>(src)) {
+        from = "array of dtype " + std::string(py::str(src.attr("dtype")));
+        if (!src.attr("flags").attr("c_contiguous").cast<bool>()) {
+            from = "non-contiguous " + from; }
+        from += " and shape " + std::string(py::str(src.attr("shape")));
+    }
+
+    std::string message = "amg_core copied an input " + from +
+                          " to a C-contiguous array of dtype " +
+                          std::string(py::str(dtype));
+    if (PyErr_WarnEx(PyExc_RuntimeWarning, message.c_str(), 1) == -1) {
+        throw py::error_already_set(); }
+}
+
+
+/*
+ *  The length of an array as the int *_size argument of a kernel.
+ *
+ *  The kernels take the lengths of their arrays as int, also when they
+ *  are instantiated for int64_t indices, so an array of 2^31 or more
+ *  entries is rejected with an OverflowError, rather than passed with a
+ *  truncated length.
+ *
+ */
+inline int array_size(const py::ssize_t size)
+{
+    const int max_size = std::numeric_limits<int>::max();
+    if (size > max_size) {
+        throw std::overflow_error("amg_core takes arrays of at most " +
+                                  std::to_string(max_size) + " entries, not " +
+                                  std::to_string(size)); }
+    return static_cast<int>(size);
+}
+
+
+namespace pybind11 { namespace detail {
+
+template<class T>
+struct type_caster<input_array<T>>
+{
+    PYBIND11_TYPE_CASTER(input_array<T>, _("numpy.ndarray"));
+
+    bool load(handle src, bool convert)
+    {
+        typedef py::array_t<T, py::array::c_style> array_type;
+
+        if (!convert && !array_type::check_(src)) {
+            return false; }
+
+        // a new reference to src itself if it has the dtype and layout
+        array_type a = array_type::ensure(src);
+        if (!a) {
+            return false; }
+
+        if (a.ptr() != src.ptr()) {
+            report_conversion(src, a.dtype()); }
+
+        value = reinterpret_steal<input_array<T>>(a.release());
+        return true;
+    }
+
+    static handle cast(const input_array<T> & src, return_value_policy, handle)
+    {
+        return src.inc_ref();
+    }
+};
+
+}} // namespace pybind11::detail
+
+#endif
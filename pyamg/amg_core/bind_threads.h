@@ -0,0 +1,55 @@
+#ifndef BIND_THREADS_H
+#define BIND_THREADS_H
+
+#include <atomic>
+
+#include <pybind11/pybind11.h>
+
+#include "parallel.h"
+
+namespace py = pybind11;
+
+/*
+ *  Number of threads of the amg_core kernels, see bindthem.py and
+ *  set_num_threads in parallel.h.
+ *
+ *  Each amg_core module is a separate extension, with its own copy of
+ *  num_threads_setting.  When a module is imported, share_num_threads
+ *  points its setting at one atomic kept in the shared data of pybind11,
+ *  so that set_num_threads of the parallel module applies to the kernels
+ *  of all of the modules.  It is called with the GIL held.
+ *
+ *  Each generated binding calls apply_num_threads after the GIL is
+ *  released, so that the kernel uses the setting in whichever thread it
+ *  is called.
+ *
+ */
+inline void share_num_threads()
+{
+    const char * name = "pyamg.amg_core.num_threads";
+
+    void * shared = py::get_shared_data(name);
+    if (shared == NULL) {
+        shared = py::set_shared_data(name, new std::atomic<int>(0)); }
+    num_threads_setting() = static_cast<std::atomic<int> *>(shared);
+}
+
+
+/*
+ *  Apply the number of threads of set_num_threads to the subsequent
+ *  parallel regions of the calling thread.  Nothing is changed if the
+ *  number of threads is not set, or if amg_core is compiled without
+ *  OpenMP.
+ *
+ */
+inline void apply_num_threads()
+{
+#ifdef _OPENMP
+    const int setting = num_threads_setting()->load(std::memory_order_relaxed);
+    if (setting > 0 && setting != omp_get_max_threads()){
+        omp_set_num_threads(setting);
+    }
+#endif
+}
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef BIND_TIMERS_H
+#define BIND_TIMERS_H
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <utility>
+
+#include <pybind11/pybind11.h>
+
+namespace py = pybind11;
+
+/*
+ *  Timers of the amg_core kernels, see bindthem.py and
+ *  pyamg.util.profile.Profile.timing_kernels.
+ *
+ *  Each generated binding times the call of its kernel with a
+ *  kernel_timer, after the arguments are read and the GIL is released,
+ *  so that the time does not include the overhead of the binding.
+ *
+ *  The timers are thread local: only the calls made by a thread that
+ *  enabled the timers are timed, so that profiles recorded concurrently
+ *  in different threads do not see each other's calls, and the calls of
+ *  other threads are not slowed down.  While the timers are disabled, a
+ *  call costs one read of a thread local flag.
+ *
+ *  Each amg_core module holds the timers of its own kernels, which are
+ *  read with the _kernel_timers function of the module.
+ *
+ */
+struct kernel_timer_table
+{
+    bool enabled = false;
+
+    // calls and seconds, keyed by the name of the kernel
+    std::map<std::string, std::pair<long, double> > entries;
+};
+
+
+inline kernel_timer_table & kernel_timers()
+{
+    static thread_local kernel_timer_table table;
+    return table;
+}
+
+
+class kernel_timer
+{
+public:
+    explicit kernel_timer(const char * name)
+        : name(name), table(kernel_timers()), enabled(table.enabled)
+    {
+        if (enabled) {
+            start = std::chrono::steady_clock::now(); }
+    }
+
+    ~kernel_timer()
+    {
+        if (!enabled) {
+            return; }
+
+        const std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        std::pair<long, double> & entry = table.entries[name];
+        entry.first += 1;
+        entry.second += elapsed.count();
+    }
+
+private:
+    const char * name;
+    kernel_timer_table & table;
+    const bool enabled;
+    std::chrono::steady_clock::time_point start;
+};
+
+
+/*
+ *  Return the kernel timers of the calling thread, as a dict of
+ *  (calls, seconds) keyed by the name of the kernel, and reset them.
+ *  The timers of subsequent calls in this thread are then enabled, or
+ *  disabled, according to enable.
+ *
+ */
+inline py::dict swap_kernel_timers(const bool enable)
+{
+    kernel_timer_table & table = kernel_timers();
+
+    py::dict entries;
+    for (const auto & entry : table.entries) {
+        entries[py::str(entry.first)] =
+            py::make_tuple(entry.second.first, entry.second.second); }
+
+    table.entries.clear();
+    table.enabled = enable;
+    return entries;
+}
+
+#endif
@@ -8,6 +8,9 @@ PYBINDHEADER = """\
 #include <pybind11/numpy.h>
 #include <pybind11/complex.h>
 
+#include "bind_arrays.h"
+#include "bind_threads.h"
+#include "bind_timers.h"
 #include "{}"
 
 namespace py = pybind11;
@@ -69,7 +72,7 @@ def find_comments(fname, ch):
     return comments
 
 
-def build_function(func):
+def build_function(func, pyname):
     """
     Build a function from a templated function.  The function must look like
     template<class I, class T, ...>
@@ -80,6 +83,13 @@ def build_function(func):
         - all arrays are templated
         - non arrays are basic types: int, double, complex, etc
         - all functions are straight up c++
+
+    A const array is an input, bound as input_array, and any other array
+    is an output, bound as output_array, see bind_arrays.h.  The pointers
+    and sizes of the arrays are read before the call, which releases the
+    GIL, so that kernels run concurrently from several Python threads.  A
+    size that does not fit the int p_size raises an OverflowError.
+    The call is timed as pyname, see bind_timers.h.
     """
 
     indent = '    '
@@ -98,7 +108,7 @@ def build_function(func):
 
     # for each parameter
     # if it's an array
-    #   - replace with py::array_t
+    #   - replace with input_array or output_array
     #   - skip the next _size argument
     #   - save in a list of arrays
     # else replicate
@@ -113,11 +123,13 @@ def build_function(func):
         # check if pointer/array
         if p['pointer'] or p['array']:
             paramtype = p['raw_type']
-            const = ''
             if p['constant']:
                 const = 'const '
-
-            param = 'py::array_t<{}> &'.format(paramtype) + ' ' + p['name']
+                param = 'input_array<{}> &'.format(paramtype)
+            else:
+                const = ''
+                param = 'output_array<{}> &'.format(paramtype)
+            param += ' ' + p['name']
             arraylist.append((const, paramtype, p['name']))
             needsize = True
         elif '_size' not in p['name'] and needsize:
@@ -158,26 +170,43 @@ def build_function(func):
         fdef += indent
         fdef += a[0] + a[1] + ' *_' + a[2] + ' = py_' + a[2] + data
 
-    # get the template signature
+    # read the sizes of the arrays, which needs the GIL, and raise an
+    # OverflowError for a size that does not fit, see bind_arrays.h
+    for p in func['parameters']:
+        if '_size' in p['name']:
+            name, s = p['name'].split('_size')
+            if s == '':
+                s = '0'
+            fdef += indent
+            fdef += '{} {} = array_size({}.shape({}));\n'.format(
+                p['type'].replace('const ', ''), p['name'], name, s)
+
+    # the kernel only sees raw pointers, so the GIL is released for the call
     if len(arraylist) > 0:
         fdef += '\n'
+    fdef += indent + 'py::gil_scoped_release release;\n'
+    fdef += indent + 'apply_num_threads();\n'
+    fdef += indent + 'kernel_timer timer("{}");\n\n'.format(pyname)
+
+    # get the template signature
     if func['template']:
         template = func['template']
         template = template.replace('template', '').replace(
             'class ', '')   # template <class T> ----> <T>
     else:
         template = ''
-    newcall = '    return ' + func['name'] + template + '('
+    if 'impl' in func:
+        # the generic implementation of a dispatched function, see main
+        newcall = '    return ' + func['impl'] + template[:-1] + ', 0>('
+    else:
+        newcall = '    return ' + func['name'] + template + '('
     fdef += newcall + '\n'
 
     # function parameters
     for i, p in enumerate(func['parameters']):
         if '_size' in p['name']:
             fdef = fdef.strip()
-            name, s = p['name'].split('_size')
-            if s == '':
-                s = '0'
-            fdef += " {}.shape({})".format(name, s)
+            fdef += ' ' + p['name']
         else:
             if p['pointer'] or p['array']:
                 name = '_' + p['name']
@@ -190,6 +219,68 @@ def build_function(func):
     return fdef
 
 
+def build_dispatch(func, sizes):
+    """
+    Build the definition of a function that dispatches on its blocksize.
+    The header declares the function, e.g.
+    template<class I, class T, class F>
+    void func(const I p[], const int p_size, ..., const I blocksize, ...);
+
+    and defines its implementation, with the blocksize as a template
+    parameter, and the same parameters
+    template<class I, class T, class F, int BS>
+    void func_impl(const I p[], const int p_size, ..., const I blocksize_, ...)
+
+    rules:
+        - the blocksize is the parameter named blocksize
+        - func_impl<..., BS> is called for each blocksize BS in sizes,
+          and func_impl<..., 0> for the others, i.e., with the blocksize
+          given at run time
+    """
+
+    indent = '    '
+
+    params = []
+    for p in func['parameters']:
+        if p['pointer'] or p['array']:
+            if p['constant']:
+                const = 'const '
+            else:
+                const = ''
+            params.append('{}{} {}[]'.format(const, p['raw_type'], p['name']))
+        else:
+            params.append('{} {}'.format(p['type'], p['name']))
+    names = [p['name'] for p in func['parameters']]
+    if 'blocksize' not in names:
+        raise ValueError(
+            'Expecting a blocksize parameter for {}'.format(func['name']))
+
+    template = func['template'].replace('template', '').replace('class ', '')
+    template = template.strip()[1:-1].strip()
+
+    fdef = func['template'] + '\n'
+    newcall = func['returns'] + ' ' + func['name'] + '('
+    fdef += newcall
+    fdef += (',\n' + ' ' * len(newcall)).join(params) + ')\n'
+    fdef += '{\n'
+
+    def call(size, depth):
+        newcall = '{}_impl<{}, {}>('.format(func['name'], template, size)
+        return indent * depth + newcall +\
+            (',\n' + ' ' * (len(indent * depth) + len(newcall))).join(names) +\
+            ');\n'
+
+    fdef += indent + 'switch(blocksize){\n'
+    for size in sizes:
+        fdef += indent * 2 + 'case {}:\n'.format(size)
+        fdef += call(size, 3)
+        fdef += indent * 3 + 'return;\n'
+    fdef += indent + '}\n\n'
+    fdef += call(0, 1)
+    fdef += '}'
+    return fdef
+
+
 def build_plugin(headerfile, ch, comments, inst, remaps):
     """
     Take a header file (headerfile) and a parse tree (ch)
@@ -230,6 +321,16 @@ def build_plugin(headerfile, ch, comments, inst, remaps):
     plugin += indent + 'py::options options;\n'
     plugin += indent + 'options.disable_function_signatures();\n\n'
 
+    # the number of threads of all modules, see bind_threads.h
+    plugin += indent + 'share_num_threads();\n\n'
+
+    # the kernel timers of this module, see bind_timers.h
+    plugin += indent + 'm.def("_kernel_timers", &swap_kernel_timers, ' +\
+        'py::arg("enable"),\n'
+    plugin += 'R"pbdoc(\nReturn and reset the kernel timers of the ' +\
+        'calling thread, and enable or\ndisable them for subsequent ' +\
+        'calls, see bind_timers.h.)pbdoc");\n\n'
+
     unbound = []
     bound = []
     for f in ch.functions:
@@ -270,8 +371,9 @@ def build_plugin(headerfile, ch, comments, inst, remaps):
         argnames = []
         for p in f['parameters']:
 
+            # only the outputs are strict, see bind_arrays.h
             array = False
-            if p['pointer'] or p['array']:
+            if (p['pointer'] or p['array']) and not p['constant']:
                 array = True
 
             # skip "_size" parameters
@@ -354,7 +456,7 @@ def main():
     #
     # load the instantiate file
     #
-    if args.input_file == 'bind_examples.h':
+    if args.input_file in ['bind_examples.h', 'linalg_examples.h']:
         data = yaml.safe_load(open('instantiate-test.yml', 'r'))
     else:
         try:
@@ -371,6 +473,29 @@ def main():
     else:
         remaps = []
 
+    #
+    # the functions that dispatch on the blocksize, see build_dispatch
+    #
+    if 'blocksizes' in data:
+        sizes = data['blocksizes']['sizes']
+        dispatch = [f for f in ch.functions
+                    if f['name'] in data['blocksizes']['functions']]
+    else:
+        dispatch = []
+
+    # each is also bound as name_generic, which calls name_impl with the
+    # blocksize at run time for all blocksizes, to test the dispatch
+    for f in dispatch:
+        generic = dict(f, name=f['name'] + '_generic',
+                       impl=f['name'] + '_impl')
+        ch.functions.insert(ch.functions.index(f) + 1, generic)
+        comments[generic['name']] = \
+            '{} with the blocksize given at run time, for all ' \
+            'blocksizes, see {}.'.format(f['name'], f['name'])
+        for func in inst:
+            if f['name'] in func['functions']:
+                func['functions'].append(generic['name'])
+
     #
     # build the plugin
     #
@@ -385,7 +510,11 @@ def main():
     for f in ch.functions:
         if f['name'] in bound:
             print('\t[building {}]'.format(f['name']))
-            fdef = build_function(f)
+            pyname = f['name']
+            for remap in remaps:
+                if f['name'] in remap:
+                    pyname = remap[f['name']]
+            fdef = build_function(f, pyname)
             flist.append(fdef)
 
     #
@@ -407,6 +536,23 @@ def main():
 
         print(plugin, file=outf)
 
+    #
+    # write to _dispatch.h, which the header includes
+    #
+    if len(dispatch) > 0:
+        basename = os.path.splitext(args.input_file)[0]
+        guard = os.path.basename(basename).upper() + '_DISPATCH_H'
+        with open(basename + '_dispatch.h', 'wt') as outf:
+
+            print('// DO NOT EDIT: this file is generated\n', file=outf)
+            print('#ifndef {}\n#define {}\n'.format(guard, guard), file=outf)
+
+            for f in dispatch:
+                print('\t[building dispatch for {}]'.format(f['name']))
+                print(build_dispatch(f, sizes), '\n', file=outf, sep="")
+
+            print('#endif', file=outf)
+
 
 if __name__ == '__main__':
     main()
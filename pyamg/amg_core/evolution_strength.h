@@ -5,8 +5,10 @@
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <vector>
 
 #include "smoothed_aggregation.h"
+#include "parallel.h"
 
 /*
  * Return a filtered strength-of-connection matrix by applying a drop tolerance
@@ -237,6 +239,125 @@ void min_blocks(const I n_blocks,
 }
 
 
+/*
+ * Solve the (NullDim+1) x (NullDim+1) system LHS x = RHS of the local
+ * minimization problems in evolution_strength_helper, where LHS is in
+ * column major and has the form
+ *
+ *      [ M    d ]
+ *      [ c^T  0 ]
+ *
+ * with M = Bi^H D_A Bi Hermitian.  M is factored by Cholesky, M = L L^H,
+ * and the constraint is eliminated with the Schur complement c^T M^{-1} d.
+ * This is much cheaper than the SVD, and for nonsingular LHS gives the
+ * same solution as the pseudoinverse.
+ *
+ * Parameters
+ * ----------
+ * LHS : {float|complex array}
+ *      (NullDim+1) x (NullDim+1) system in column major, not modified
+ * RHS : {float|complex array}
+ *      (NullDim+1) right hand side, holds the solution upon return
+ * NullDim : {int}
+ *      Number of nullspace vectors
+ * work : {float|complex array}
+ *      Scratch space of length at least NullDim*NullDim + 2*NullDim
+ *
+ * Return
+ * ------
+ * true if the system was solved.  false, with RHS unchanged, if M is not
+ * numerically positive definite or if the Schur complement is numerically
+ * zero, relative to sqrt(machine epsilon).  The caller then falls back to
+ * svd_solve.
+ *
+ */
+template<class I, class T, class F>
+bool constrained_cholesky_solve(const T LHS[], T RHS[], const I NullDim, T work[])
+{
+    const I NullDimPone = NullDim + 1;
+    const F tol = std::sqrt(std::numeric_limits<F>::epsilon());
+    T * L  = work;                   // Cholesky factor, column major
+    T * y1 = L  + NullDim*NullDim;   // M^{-1} RHS[0:NullDim]
+    T * y2 = y1 + NullDim;           // M^{-1} d
+
+    F max_diag = 0.0;
+    for(I k = 0; k < NullDim; k++)
+    {   max_diag = std::max(max_diag, real(LHS[k*NullDimPone + k])); }
+    if(!(max_diag > 0.0))
+    {   return false; }
+
+    // Factor M = L L^H, using the lower triangle of M
+    for(I j = 0; j < NullDim; j++)
+    {
+        F pivot = real(LHS[j*NullDimPone + j]);
+        for(I k = 0; k < j; k++)
+        {   pivot -= mynormsq(L[k*NullDim + j]); }
+        if(!(pivot > tol*max_diag))
+        {   return false; }
+
+        const F Ljj = std::sqrt(pivot);
+        L[j*NullDim + j] = Ljj;
+        for(I r = j + 1; r < NullDim; r++)
+        {
+            T sum = LHS[j*NullDimPone + r];
+            for(I k = 0; k < j; k++)
+            {   sum -= L[k*NullDim + r]*conjugate(L[k*NullDim + j]); }
+            L[j*NullDim + r] = sum/Ljj;
+        }
+    }
+
+    // y1 = M^{-1} RHS[0:NullDim] and y2 = M^{-1} d, by solving with L
+    // and then with L^H
+    for(I r = 0; r < NullDim; r++)
+    {
+        T sum1 = RHS[r];
+        T sum2 = LHS[NullDim*NullDimPone + r];
+        for(I k = 0; k < r; k++)
+        {
+            sum1 -= L[k*NullDim + r]*y1[k];
+            sum2 -= L[k*NullDim + r]*y2[k];
+        }
+        y1[r] = sum1/real(L[r*NullDim + r]);
+        y2[r] = sum2/real(L[r*NullDim + r]);
+    }
+    for(I r = NullDim - 1; r >= 0; r--)
+    {
+        T sum1 = y1[r];
+        T sum2 = y2[r];
+        for(I k = r + 1; k < NullDim; k++)
+        {
+            sum1 -= conjugate(L[r*NullDim + k])*y1[k];
+            sum2 -= conjugate(L[r*NullDim + k])*y2[k];
+        }
+        y1[r] = sum1/real(L[r*NullDim + r]);
+        y2[r] = sum2/real(L[r*NullDim + r]);
+    }
+
+    // Schur complement s = c^T M^{-1} d, and the multiplier of the constraint
+    T cy1 = 0.0;
+    T s   = 0.0;
+    F norm_c  = 0.0;
+    F norm_y2 = 0.0;
+    for(I r = 0; r < NullDim; r++)
+    {
+        const T c = LHS[r*NullDimPone + NullDim];
+        cy1 += c*y1[r];
+        s   += c*y2[r];
+        norm_c  += mynormsq(c);
+        norm_y2 += mynormsq(y2[r]);
+    }
+    if(!(mynorm(s) > tol*std::sqrt(norm_c*norm_y2)))
+    {   return false; }
+
+    const T lambda = (cy1 - RHS[NullDim])/s;
+    for(I r = 0; r < NullDim; r++)
+    {   RHS[r] = y1[r] - lambda*y2[r]; }
+    RHS[NullDim] = lambda;
+
+    return true;
+}
+
+
 /*
  * Create strength-of-connection matrix based on constrained min problem of
  *    min( z - B*x ), such that
@@ -290,6 +411,12 @@ void min_blocks(const I n_blocks,
  *      Number of nullspace vectors
  * tol : {float}
  *      Used to determine when values are numerically zero
+ * workspace : {float|complex array}
+ *      Scratch space of length at least
+ *          p*(2*m*(NullDim + 1) + 3*(NullDim + 1)^2 + 2*(NullDim + 1)),
+ *      where m is the maximum number of nonzeros in a row of S and p is
+ *      the number of threads, see set_num_threads.  If workspace is
+ *      shorter than this, the scratch space is allocated internally.
  *
  * Returns
  * -------
@@ -304,6 +431,11 @@ void min_blocks(const I n_blocks,
  *
  * b is used to save on the computation of each local minimization problem
  *
+ * The rows are independent, and are split over the threads.  Each local
+ * problem is solved with constrained_cholesky_solve, i.e. a Cholesky
+ * factorization instead of an SVD, unless it is ill-conditioned, in which
+ * case the pseudoinverse is used as before.
+ *
  * Principle calling routine is evolution_strength_of_connection(...) in strength.py.
  * In that routine, it is used to calculate strength-of-connection for the case
  * of multiple near-nullspace modes.
@@ -322,24 +454,27 @@ void evolution_strength_helper(      T Sx[], const int Sx_size,
                                const T b[], const int b_size,
                                const I BDBCols,
                                const I NullDim,
-                               const F tol)
+                               const F tol,
+                                     T workspace[], const int workspace_size)
 {
     //Compute maximum row length
     I max_length = 0;
     for(I i = 0; i < nrows; i++)
         max_length = std::max(max_length, Sp[i + 1] - Sp[i]);
 
-    //Declare Workspace
+    //Declare Workspace, one slice of total_size for each thread, taken
+    //from workspace[] if it is large enough
     const I NullDimPone = NullDim + 1;
     const I work_size   = 2*NullDimPone*NullDimPone + NullDimPone;
-    T * z         = new T[max_length];
-    T * zhat      = new T[max_length];
-    T * DBi       = new T[max_length*NullDim];
-    T * Bi        = new T[max_length*NullDim];
-    T * LHS       = new T[NullDimPone*NullDimPone];
-    T * RHS       = new T[NullDimPone];
-    T * work      = new T[work_size];
-    F * sing_vals = new F[NullDimPone];
+    const I total_size  = 2*max_length*NullDimPone + NullDimPone*NullDimPone
+                          + NullDimPone + work_size;
+    const I num_threads = set_num_threads((I) 0);
+    std::vector<T> scratch;
+    T * workspace_ptr = workspace;
+    if(workspace_size < num_threads*total_size){
+        scratch.resize(num_threads*total_size);
+        workspace_ptr = &scratch[0];
+    }
 
     //Rename to something more understandable
     const T * BDB = b;
@@ -350,189 +485,196 @@ void evolution_strength_helper(      T Sx[], const int Sx_size,
     const F near_zero = std::numeric_limits<F>::epsilon();
     const F sqrt_near_zero = std::sqrt(near_zero);
 
-    //Loop over rows
-    for(I i = 0; i < nrows; i++)
+    //Loop over rows, each row is an independent minimization problem
+    #pragma omp parallel num_threads(num_threads)
     {
-        const I rowstart = Sp[i];
-        const I rowend   = Sp[i+1];
-        const I length   = rowend - rowstart;
-
-        if(length <= NullDim) {
-            // If B can perfectly locally approximate this row of S,
-            // then all connections are strong
-            for(I kk = rowstart; kk < rowend; kk++)
-            {   Sx[kk] = 1.0; }
-            continue; //skip to next row
-        }
+        T * ws        = workspace_ptr + thread_num<I>()*total_size;
+        T * z         = ws;
+        T * zhat      = z    + max_length;
+        T * DBi       = zhat + max_length;
+        T * Bi        = DBi  + max_length*NullDim;
+        T * LHS       = Bi   + max_length*NullDim;
+        T * RHS       = LHS  + NullDimPone*NullDimPone;
+        T * work      = RHS  + NullDimPone;
+        std::vector<F> sing_vals(NullDimPone);
+
+        #pragma omp for schedule(static)
+        for(I i = 0; i < nrows; i++)
+        {
+            const I rowstart = Sp[i];
+            const I rowend   = Sp[i+1];
+            const I length   = rowend - rowstart;
+
+            if(length <= NullDim) {
+                // If B can perfectly locally approximate this row of S,
+                // then all connections are strong
+                for(I kk = rowstart; kk < rowend; kk++)
+                {   Sx[kk] = 1.0; }
+                continue; //skip to next row
+            }
 
 
-        //S[i,:] ==> z
-        std::copy(Sx + rowstart, Sx + rowend, z);
+            //S[i,:] ==> z
+            std::copy(Sx + rowstart, Sx + rowend, z);
 
-        //construct Bi, where B_i is B with the rows restricted only to
-        //the nonzero column indices of row i of S
-        T z_at_i = 1.0;
-        for(I jj = rowstart, Bicounter = 0; jj < rowend; jj++)
-        {
-            const I j = Sj[jj];
-            const T v = Sx[jj];
+            //construct Bi, where B_i is B with the rows restricted only to
+            //the nonzero column indices of row i of S
+            T z_at_i = 1.0;
+            for(I jj = rowstart, Bicounter = 0; jj < rowend; jj++)
+            {
+                const I j = Sj[jj];
+                const T v = Sx[jj];
 
-            if(i == j)
-                z_at_i = v;
+                if(i == j)
+                    z_at_i = v;
 
-            I Bcounter = j*NullDim;
-            for(I k = 0; k < NullDim; k++)
-            {
-                Bi[Bicounter] = B[Bcounter];
-                Bicounter++;
-                Bcounter++;
+                I Bcounter = j*NullDim;
+                for(I k = 0; k < NullDim; k++)
+                {
+                    Bi[Bicounter] = B[Bcounter];
+                    Bicounter++;
+                    Bcounter++;
+                }
             }
-        }
 
-        //Construct Bi^H*D_A in row major,  where DB_i is DB
-        // with the rows restricted only to the nonzero column indices of row i of S
-        for(I k = 0, Bicounter = 0, Bcounter = 0; k < NullDim; k++, Bcounter += nrows)
-        {
-            for(I jj = rowstart; jj < rowend; jj++)
+            //Construct Bi^H*D_A in row major,  where DB_i is DB
+            // with the rows restricted only to the nonzero column indices of row i of S
+            for(I k = 0, Bicounter = 0, Bcounter = 0; k < NullDim; k++, Bcounter += nrows)
             {
-                DBi[Bicounter] = DB[Bcounter + Sj[jj]];
-                Bicounter++;
+                for(I jj = rowstart; jj < rowend; jj++)
+                {
+                    DBi[Bicounter] = DB[Bcounter + Sj[jj]];
+                    Bicounter++;
+                }
             }
-        }
 
-        //Construct B_i^H * diag(A_i) * B_i, the 1,1 block of LHS in column major ordering
-        for(I kk = 0; kk < NullDimPone*NullDimPone; kk++)
-        {   LHS[kk] = 0.0; }
+            //Construct B_i^H * diag(A_i) * B_i, the 1,1 block of LHS in column major ordering
+            for(I kk = 0; kk < NullDimPone*NullDimPone; kk++)
+            {   LHS[kk] = 0.0; }
 
-        for(I jj = rowstart; jj < rowend; jj++)
-        {
-            const I j = Sj[jj];
-            // Do work in computing Diagonal of LHS
-            I LHScounter = 0;
-            I BDBCounter = j*BDBCols;
-            for(I m = 0; m < NullDim; m++)
-            {
-                LHS[LHScounter] += BDB[BDBCounter];
-                LHScounter += NullDimPone + 1;
-                BDBCounter += (NullDim - m);
-            }
-            // Do work in computing offdiagonals of LHS,
-            //   noting that the (1,1) block of LHS is Hermitian
-            BDBCounter = j*BDBCols;
-            for(I m = 0; m < NullDim; m++)
+            for(I jj = rowstart; jj < rowend; jj++)
             {
-                I counter = 1;
-                for(I n = m+1; n < NullDim; n++)
+                const I j = Sj[jj];
+                // Do work in computing Diagonal of LHS
+                I LHScounter = 0;
+                I BDBCounter = j*BDBCols;
+                for(I m = 0; m < NullDim; m++)
                 {
-                    T elmt_bdb = BDB[BDBCounter + counter];
-                    LHS[m*NullDimPone + n] = LHS[m*NullDimPone + n] + conjugate(elmt_bdb);      // entry(n,m)
-                    LHS[n*NullDimPone + m] = LHS[n*NullDimPone + m] + elmt_bdb;                 // entry(m,n)
-                    counter++;
+                    LHS[LHScounter] += BDB[BDBCounter];
+                    LHScounter += NullDimPone + 1;
+                    BDBCounter += (NullDim - m);
+                }
+                // Do work in computing offdiagonals of LHS,
+                //   noting that the (1,1) block of LHS is Hermitian
+                BDBCounter = j*BDBCols;
+                for(I m = 0; m < NullDim; m++)
+                {
+                    I counter = 1;
+                    for(I n = m+1; n < NullDim; n++)
+                    {
+                        T elmt_bdb = BDB[BDBCounter + counter];
+                        LHS[m*NullDimPone + n] = LHS[m*NullDimPone + n] + conjugate(elmt_bdb);      // entry(n,m)
+                        LHS[n*NullDimPone + m] = LHS[n*NullDimPone + m] + elmt_bdb;                 // entry(m,n)
+                        counter++;
+                    }
+                    BDBCounter += (NullDim - m);
                 }
-                BDBCounter += (NullDim - m);
             }
-        }
 
-        //Write last row of LHS, e_i^T*B
-        for(I j = NullDim, Bcounter = i*NullDim; j < NullDim*NullDimPone; j+= NullDimPone, Bcounter++)
-        {   LHS[j] = B[Bcounter]; }
-
-        //Write last column of LHS, B^H*D_A*e_i
-        for(I j = NullDim*NullDimPone, Bcounter = i; j < (NullDimPone*NullDimPone - 1); j++, Bcounter += nrows)
-        {   LHS[j] = DB[Bcounter]; }
-
-        //Write first NullDim Entries of RHS
-        //  Bi^H*D_A*z ==> RHS
-        gemm( DBi, NullDim, length, 'F',
-                z, length,       1, 'F',
-              RHS, NullDim,      1, 'F',
-              'T');
-        //Double the first NullDim entries in RHS
-        for(I j = 0; j < NullDim; j++)
-        {   RHS[j] *= 2.0; }
-        //Last entry of RHS
-        RHS[NullDim] = z_at_i;
-
-        //Solve minimization problem,  pseudo_inverse(LHS)*RHS ==> prod
-        svd_solve(&(LHS[0]), NullDimPone, NullDimPone, &(RHS[0]), &(sing_vals[0]), &(work[0]), work_size);
-
-        //Find best approximation to z in span(Bi), Bi*RHS[0:NullDim] ==> zhat
-        gemm(  Bi,   length, NullDim, 'F',
-              RHS,  NullDim,       1, 'F',
-             zhat,   length,       1, 'F',
-              'T');
-
-        //Need to filter out numerically zero values in zhat, because the sign of each
-        //entry is very important in the below angle calc.  First, find the maximum value
-        //in zhat to scale the tolerance with.  Then, whenever the real or imag part of
-        //zhat is less than this tolerance, set that real or imag part to zero.
-        F max_zhat = 0.0;
-        for(I jj = rowstart, zcounter = 0; jj < rowend; jj++, zcounter++)
-        {
-            F curr_norm = mynorm(zhat[zcounter]);
-            if (curr_norm > max_zhat) {
-                max_zhat = curr_norm; }
-        }
-        F tol_i = tol*max_zhat;
-        for(I jj = rowstart, zcounter = 0; jj < rowend; jj++, zcounter++)
-        {
-            if (mynorm(real(zhat[zcounter])) < tol_i) {
-                T curr_val = zhat[zcounter];
-                zhat[zcounter] = zero_real(curr_val); }
-            if (mynorm(imag(zhat[zcounter])) < tol_i) {
-                T curr_val = zhat[zcounter];
-                zhat[zcounter] = zero_imag(curr_val); }
-        }
+            //Write last row of LHS, e_i^T*B
+            for(I j = NullDim, Bcounter = i*NullDim; j < NullDim*NullDimPone; j+= NullDimPone, Bcounter++)
+            {   LHS[j] = B[Bcounter]; }
+
+            //Write last column of LHS, B^H*D_A*e_i
+            for(I j = NullDim*NullDimPone, Bcounter = i; j < (NullDimPone*NullDimPone - 1); j++, Bcounter += nrows)
+            {   LHS[j] = DB[Bcounter]; }
+
+            //Write first NullDim Entries of RHS
+            //  Bi^H*D_A*z ==> RHS
+            gemm<I, T>( DBi, NullDim, length, 'F',
+                    z, length,       1, 'F',
+                  RHS, NullDim,      1, 'F',
+                  'T');
+            //Double the first NullDim entries in RHS
+            for(I j = 0; j < NullDim; j++)
+            {   RHS[j] *= 2.0; }
+            //Last entry of RHS
+            RHS[NullDim] = z_at_i;
+
+            //Solve minimization problem, LHS^{-1}*RHS ==> RHS, with a Cholesky
+            //factorization when LHS is well conditioned, and otherwise with the
+            //pseudo_inverse(LHS)*RHS
+            if(!constrained_cholesky_solve<I, T, F>(LHS, RHS, NullDim, work))
+            {   svd_solve(&(LHS[0]), NullDimPone, NullDimPone, &(RHS[0]), &(sing_vals[0]), &(work[0]), work_size); }
+
+            //Find best approximation to z in span(Bi), Bi*RHS[0:NullDim] ==> zhat
+            gemm<I, T>(  Bi,   length, NullDim, 'F',
+                  RHS,  NullDim,       1, 'F',
+                 zhat,   length,       1, 'F',
+                  'T');
+
+            //Need to filter out numerically zero values in zhat, because the sign of each
+            //entry is very important in the below angle calc.  First, find the maximum value
+            //in zhat to scale the tolerance with.  Then, whenever the real or imag part of
+            //zhat is less than this tolerance, set that real or imag part to zero.
+            F max_zhat = 0.0;
+            for(I jj = rowstart, zcounter = 0; jj < rowend; jj++, zcounter++)
+            {
+                F curr_norm = mynorm(zhat[zcounter]);
+                if (curr_norm > max_zhat) {
+                    max_zhat = curr_norm; }
+            }
+            F tol_i = tol*max_zhat;
+            for(I jj = rowstart, zcounter = 0; jj < rowend; jj++, zcounter++)
+            {
+                if (mynorm(real(zhat[zcounter])) < tol_i) {
+                    T curr_val = zhat[zcounter];
+                    zhat[zcounter] = zero_real(curr_val); }
+                if (mynorm(imag(zhat[zcounter])) < tol_i) {
+                    T curr_val = zhat[zcounter];
+                    zhat[zcounter] = zero_imag(curr_val); }
+            }
 
 
-        //Now, calculate strength-of-connection
-        for(I jj = rowstart, zcounter = 0; jj < rowend; jj++, zcounter++)
-        {
-            //Strongly connected to self
-            if(Sj[jj] == i)
-            {   Sx[jj] = 1.0; }
-            else
+            //Now, calculate strength-of-connection
+            for(I jj = rowstart, zcounter = 0; jj < rowend; jj++, zcounter++)
             {
-                //Approximation ratio
-                const T ratio = zhat[zcounter]/z[zcounter];
-                // Dot-Product between zhat_j and z_j
-                const F dprod = real(zhat[zcounter])*real(z[zcounter]) + imag(zhat[zcounter])*imag(z[zcounter]);
+                //Strongly connected to self
+                if(Sj[jj] == i)
+                {   Sx[jj] = 1.0; }
+                else
+                {
+                    //Approximation ratio
+                    const T ratio = zhat[zcounter]/z[zcounter];
+                    // Dot-Product between zhat_j and z_j
+                    const F dprod = real(zhat[zcounter])*real(z[zcounter]) + imag(zhat[zcounter])*imag(z[zcounter]);
 
-                // if the ratio is close to zero, then weak connection
-                if( mynormsq(ratio) <= 1e-8 )
-                {   Sx[jj] = 0.0; }
+                    // if the ratio is close to zero, then weak connection
+                    if( mynormsq(ratio) <= 1e-8 )
+                    {   Sx[jj] = 0.0; }
 
-                // if angle in complex plane between zhat[j] and z[j] is more than 90 degrees, then weak connection
-                // If the dot product is positive, we are guaranteed this by <a, b>/(||a|| ||b||) = cos(theta)
-                else if( dprod < 0.0 )
-                {   Sx[jj] = 0.0; }
+                    // if angle in complex plane between zhat[j] and z[j] is more than 90 degrees, then weak connection
+                    // If the dot product is positive, we are guaranteed this by <a, b>/(||a|| ||b||) = cos(theta)
+                    else if( dprod < 0.0 )
+                    {   Sx[jj] = 0.0; }
 
-                //Calculate approximation error as strength value
-                else
-                {
-                    const F error = mynorm(-ratio + (F) 1.0);
-                    //This comparison allows for predictable handling of the "zero" error case
-                    if(error < sqrt_near_zero)
-                    {    Sx[jj] = 1e-4; }
+                    //Calculate approximation error as strength value
                     else
-                    {    Sx[jj] = error; }
+                    {
+                        const F error = mynorm(-ratio + (F) 1.0);
+                        //This comparison allows for predictable handling of the "zero" error case
+                        if(error < sqrt_near_zero)
+                        {    Sx[jj] = 1e-4; }
+                        else
+                        {    Sx[jj] = error; }
+                    }
                 }
-            }
 
 
-        } //end for
+            } //end for
 
-    } //end i loop
-
-    //Clean up heap
-    delete[] LHS;
-    delete[] RHS;
-    delete[] z;
-    delete[] zhat;
-    delete[] DBi;
-    delete[] Bi;
-    delete[] work;
-    delete[] sing_vals;
+        } //end i loop
+    }
 }
 
 
@@ -650,10 +792,9 @@ T my_inner(const I Ap[], const I Aj[], const T Ax[],
  * sparsity pattern is a subset of A*B, so this algorithm
  * should work well.
  *
- * Principle calling routine is evolution_strength_of_connection in
- * strength.py.  Here it is used to calculate S*S only at the
- * sparsity pattern of the original operator.  This allows for
- * BIG cost savings.
+ * The rows of S are computed in parallel.  masked_mat_mult_csr(...)
+ * in sparse.h computes the same product with B in CSR, which is
+ * usually faster unless S has far fewer nonzeros than A or B.
  *
  * Examples
  * --------
@@ -684,6 +825,7 @@ void incomplete_mat_mult_csr(const I Ap[], const int Ap_size,
                                    T Sx[], const int Sx_size,
                              const I num_rows)
 {
+    #pragma omp parallel for schedule(static)
     for(I row = 0; row < num_rows; row++)
     {
         const I row_start = Sp[row];
@@ -4,6 +4,9 @@
 #include <pybind11/numpy.h>
 #include <pybind11/complex.h>
 
+#include "bind_arrays.h"
+#include "bind_threads.h"
+#include "bind_timers.h"
 #include "evolution_strength.h"
 
 namespace py = pybind11;
@@ -12,9 +15,9 @@ template<class I, class T>
 void _apply_absolute_distance_filter(
             const I n_row,
           const T epsilon,
-      py::array_t<I> & Sp,
-      py::array_t<I> & Sj,
-      py::array_t<T> & Sx
+      input_array<I> & Sp,
+      input_array<I> & Sj,
+     output_array<T> & Sx
                                      )
 {
     auto py_Sp = Sp.unchecked();
@@ -23,13 +26,20 @@ void _apply_absolute_distance_filter(
     const I *_Sp = py_Sp.data();
     const I *_Sj = py_Sj.data();
     T *_Sx = py_Sx.mutable_data();
+    int Sp_size = array_size(Sp.shape(0));
+    int Sj_size = array_size(Sj.shape(0));
+    int Sx_size = array_size(Sx.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("apply_absolute_distance_filter");
 
     return apply_absolute_distance_filter<I, T>(
                     n_row,
                   epsilon,
-                      _Sp, Sp.shape(0),
-                      _Sj, Sj.shape(0),
-                      _Sx, Sx.shape(0)
+                      _Sp, Sp_size,
+                      _Sj, Sj_size,
+                      _Sx, Sx_size
                                                 );
 }
 
@@ -37,9 +47,9 @@ template<class I, class T>
 void _apply_distance_filter(
             const I n_row,
           const T epsilon,
-      py::array_t<I> & Sp,
-      py::array_t<I> & Sj,
-      py::array_t<T> & Sx
+      input_array<I> & Sp,
+      input_array<I> & Sj,
+     output_array<T> & Sx
                             )
 {
     auto py_Sp = Sp.unchecked();
@@ -48,13 +58,20 @@ void _apply_distance_filter(
     const I *_Sp = py_Sp.data();
     const I *_Sj = py_Sj.data();
     T *_Sx = py_Sx.mutable_data();
+    int Sp_size = array_size(Sp.shape(0));
+    int Sj_size = array_size(Sj.shape(0));
+    int Sx_size = array_size(Sx.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("apply_distance_filter");
 
     return apply_distance_filter<I, T>(
                     n_row,
                   epsilon,
-                      _Sp, Sp.shape(0),
-                      _Sj, Sj.shape(0),
-                      _Sx, Sx.shape(0)
+                      _Sp, Sp_size,
+                      _Sj, Sj_size,
+                      _Sx, Sx_size
                                        );
 }
 
@@ -62,35 +79,42 @@ template<class I, class T>
 void _min_blocks(
          const I n_blocks,
         const I blocksize,
-      py::array_t<T> & Sx,
-      py::array_t<T> & Tx
+      input_array<T> & Sx,
+     output_array<T> & Tx
                  )
 {
     auto py_Sx = Sx.unchecked();
     auto py_Tx = Tx.mutable_unchecked();
     const T *_Sx = py_Sx.data();
     T *_Tx = py_Tx.mutable_data();
+    int Sx_size = array_size(Sx.shape(0));
+    int Tx_size = array_size(Tx.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("min_blocks");
 
     return min_blocks<I, T>(
                  n_blocks,
                 blocksize,
-                      _Sx, Sx.shape(0),
-                      _Tx, Tx.shape(0)
+                      _Sx, Sx_size,
+                      _Tx, Tx_size
                             );
 }
 
 template<class I, class T, class F>
 void _evolution_strength_helper(
-      py::array_t<T> & Sx,
-      py::array_t<I> & Sp,
-      py::array_t<I> & Sj,
+     output_array<T> & Sx,
+      input_array<I> & Sp,
+      input_array<I> & Sj,
             const I nrows,
-       py::array_t<T> & x,
-       py::array_t<T> & y,
-       py::array_t<T> & b,
+       input_array<T> & x,
+       input_array<T> & y,
+       input_array<T> & b,
           const I BDBCols,
           const I NullDim,
-              const F tol
+              const F tol,
+output_array<T> & workspace
                                 )
 {
     auto py_Sx = Sx.mutable_unchecked();
@@ -99,38 +123,52 @@ void _evolution_strength_helper(
     auto py_x = x.unchecked();
     auto py_y = y.unchecked();
     auto py_b = b.unchecked();
+    auto py_workspace = workspace.mutable_unchecked();
     T *_Sx = py_Sx.mutable_data();
     const I *_Sp = py_Sp.data();
     const I *_Sj = py_Sj.data();
     const T *_x = py_x.data();
     const T *_y = py_y.data();
     const T *_b = py_b.data();
+    T *_workspace = py_workspace.mutable_data();
+    int Sx_size = array_size(Sx.shape(0));
+    int Sp_size = array_size(Sp.shape(0));
+    int Sj_size = array_size(Sj.shape(0));
+    int x_size = array_size(x.shape(0));
+    int y_size = array_size(y.shape(0));
+    int b_size = array_size(b.shape(0));
+    int workspace_size = array_size(workspace.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("evolution_strength_helper");
 
     return evolution_strength_helper<I, T, F>(
-                      _Sx, Sx.shape(0),
-                      _Sp, Sp.shape(0),
-                      _Sj, Sj.shape(0),
+                      _Sx, Sx_size,
+                      _Sp, Sp_size,
+                      _Sj, Sj_size,
                     nrows,
-                       _x, x.shape(0),
-                       _y, y.shape(0),
-                       _b, b.shape(0),
+                       _x, x_size,
+                       _y, y_size,
+                       _b, b_size,
                   BDBCols,
                   NullDim,
-                      tol
+                      tol,
+               _workspace, workspace_size
                                               );
 }
 
 template<class I, class T, class F>
 void _incomplete_mat_mult_csr(
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
-      py::array_t<T> & Ax,
-      py::array_t<I> & Bp,
-      py::array_t<I> & Bj,
-      py::array_t<T> & Bx,
-      py::array_t<I> & Sp,
-      py::array_t<I> & Sj,
-      py::array_t<T> & Sx,
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      input_array<I> & Bp,
+      input_array<I> & Bj,
+      input_array<T> & Bx,
+      input_array<I> & Sp,
+      input_array<I> & Sj,
+     output_array<T> & Sx,
          const I num_rows
                               )
 {
@@ -152,17 +190,30 @@ void _incomplete_mat_mult_csr(
     const I *_Sp = py_Sp.data();
     const I *_Sj = py_Sj.data();
     T *_Sx = py_Sx.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int Bp_size = array_size(Bp.shape(0));
+    int Bj_size = array_size(Bj.shape(0));
+    int Bx_size = array_size(Bx.shape(0));
+    int Sp_size = array_size(Sp.shape(0));
+    int Sj_size = array_size(Sj.shape(0));
+    int Sx_size = array_size(Sx.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("incomplete_mat_mult_csr");
 
     return incomplete_mat_mult_csr<I, T, F>(
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
-                      _Ax, Ax.shape(0),
-                      _Bp, Bp.shape(0),
-                      _Bj, Bj.shape(0),
-                      _Bx, Bx.shape(0),
-                      _Sp, Sp.shape(0),
-                      _Sj, Sj.shape(0),
-                      _Sx, Sx.shape(0),
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                      _Bp, Bp_size,
+                      _Bj, Bj_size,
+                      _Bx, Bx_size,
+                      _Sp, Sp_size,
+                      _Sj, Sj_size,
+                      _Sx, Sx_size,
                  num_rows
                                             );
 }
@@ -183,10 +234,21 @@ PYBIND11_MODULE(evolution_strength, m) {
     py::options options;
     options.disable_function_signatures();
 
+    share_num_threads();
+
+    m.def("_kernel_timers", &swap_kernel_timers, py::arg("enable"),
+R"pbdoc(
+Return and reset the kernel timers of the calling thread, and enable or
+disable them for subsequent calls, see bind_timers.h.)pbdoc");
+
     m.def("apply_absolute_distance_filter", &_apply_absolute_distance_filter<int, float>,
-        py::arg("n_row"), py::arg("epsilon"), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
+        py::arg("n_row"), py::arg("epsilon"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert());
     m.def("apply_absolute_distance_filter", &_apply_absolute_distance_filter<int, double>,
-        py::arg("n_row"), py::arg("epsilon"), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert(),
+        py::arg("n_row"), py::arg("epsilon"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert());
+    m.def("apply_absolute_distance_filter", &_apply_absolute_distance_filter<int64_t, float>,
+        py::arg("n_row"), py::arg("epsilon"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert());
+    m.def("apply_absolute_distance_filter", &_apply_absolute_distance_filter<int64_t, double>,
+        py::arg("n_row"), py::arg("epsilon"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert(),
 R"pbdoc(
 Return a filtered strength-of-connection matrix by applying a drop tolerance
  Strength values are assumed to be "distance"-like, i.e. the smaller the
@@ -237,9 +299,13 @@ Examples
 >>> print "Matrix After Applying Filter\n" + str(S.todense()))pbdoc");
 
     m.def("apply_distance_filter", &_apply_distance_filter<int, float>,
-        py::arg("n_row"), py::arg("epsilon"), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
+        py::arg("n_row"), py::arg("epsilon"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert());
     m.def("apply_distance_filter", &_apply_distance_filter<int, double>,
-        py::arg("n_row"), py::arg("epsilon"), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert(),
+        py::arg("n_row"), py::arg("epsilon"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert());
+    m.def("apply_distance_filter", &_apply_distance_filter<int64_t, float>,
+        py::arg("n_row"), py::arg("epsilon"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert());
+    m.def("apply_distance_filter", &_apply_distance_filter<int64_t, double>,
+        py::arg("n_row"), py::arg("epsilon"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert(),
 R"pbdoc(
 Return a filtered strength-of-connection matrix by applying a drop tolerance
  Strength values are assumed to be "distance"-like, i.e. the smaller the
@@ -290,9 +356,13 @@ Examples
 >>> print "Matrix AFter Applying Filter\n" + str(S.todense()))pbdoc");
 
     m.def("min_blocks", &_min_blocks<int, float>,
-        py::arg("n_blocks"), py::arg("blocksize"), py::arg("Sx").noconvert(), py::arg("Tx").noconvert());
+        py::arg("n_blocks"), py::arg("blocksize"), py::arg("Sx"), py::arg("Tx").noconvert());
     m.def("min_blocks", &_min_blocks<int, double>,
-        py::arg("n_blocks"), py::arg("blocksize"), py::arg("Sx").noconvert(), py::arg("Tx").noconvert(),
+        py::arg("n_blocks"), py::arg("blocksize"), py::arg("Sx"), py::arg("Tx").noconvert());
+    m.def("min_blocks", &_min_blocks<int64_t, float>,
+        py::arg("n_blocks"), py::arg("blocksize"), py::arg("Sx"), py::arg("Tx").noconvert());
+    m.def("min_blocks", &_min_blocks<int64_t, double>,
+        py::arg("n_blocks"), py::arg("blocksize"), py::arg("Sx"), py::arg("Tx").noconvert(),
 R"pbdoc(
 Given a BSR with num_blocks stored, return a linear array of length
  num_blocks, which holds each block's smallest, nonzero, entry
@@ -337,13 +407,21 @@ Examples
 >>> print "Matrix AFter\n" + str(S2.todense()))pbdoc");
 
     m.def("evolution_strength_helper", &_evolution_strength_helper<int, float, float>,
-        py::arg("Sx").noconvert(), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("nrows"), py::arg("x").noconvert(), py::arg("y").noconvert(), py::arg("b").noconvert(), py::arg("BDBCols"), py::arg("NullDim"), py::arg("tol"));
+        py::arg("Sx").noconvert(), py::arg("Sp"), py::arg("Sj"), py::arg("nrows"), py::arg("x"), py::arg("y"), py::arg("b"), py::arg("BDBCols"), py::arg("NullDim"), py::arg("tol"), py::arg("workspace").noconvert());
     m.def("evolution_strength_helper", &_evolution_strength_helper<int, double, double>,
-        py::arg("Sx").noconvert(), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("nrows"), py::arg("x").noconvert(), py::arg("y").noconvert(), py::arg("b").noconvert(), py::arg("BDBCols"), py::arg("NullDim"), py::arg("tol"));
+        py::arg("Sx").noconvert(), py::arg("Sp"), py::arg("Sj"), py::arg("nrows"), py::arg("x"), py::arg("y"), py::arg("b"), py::arg("BDBCols"), py::arg("NullDim"), py::arg("tol"), py::arg("workspace").noconvert());
     m.def("evolution_strength_helper", &_evolution_strength_helper<int, std::complex<float>, float>,
-        py::arg("Sx").noconvert(), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("nrows"), py::arg("x").noconvert(), py::arg("y").noconvert(), py::arg("b").noconvert(), py::arg("BDBCols"), py::arg("NullDim"), py::arg("tol"));
+        py::arg("Sx").noconvert(), py::arg("Sp"), py::arg("Sj"), py::arg("nrows"), py::arg("x"), py::arg("y"), py::arg("b"), py::arg("BDBCols"), py::arg("NullDim"), py::arg("tol"), py::arg("workspace").noconvert());
     m.def("evolution_strength_helper", &_evolution_strength_helper<int, std::complex<double>, double>,
-        py::arg("Sx").noconvert(), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("nrows"), py::arg("x").noconvert(), py::arg("y").noconvert(), py::arg("b").noconvert(), py::arg("BDBCols"), py::arg("NullDim"), py::arg("tol"),
+        py::arg("Sx").noconvert(), py::arg("Sp"), py::arg("Sj"), py::arg("nrows"), py::arg("x"), py::arg("y"), py::arg("b"), py::arg("BDBCols"), py::arg("NullDim"), py::arg("tol"), py::arg("workspace").noconvert());
+    m.def("evolution_strength_helper", &_evolution_strength_helper<int64_t, float, float>,
+        py::arg("Sx").noconvert(), py::arg("Sp"), py::arg("Sj"), py::arg("nrows"), py::arg("x"), py::arg("y"), py::arg("b"), py::arg("BDBCols"), py::arg("NullDim"), py::arg("tol"), py::arg("workspace").noconvert());
+    m.def("evolution_strength_helper", &_evolution_strength_helper<int64_t, double, double>,
+        py::arg("Sx").noconvert(), py::arg("Sp"), py::arg("Sj"), py::arg("nrows"), py::arg("x"), py::arg("y"), py::arg("b"), py::arg("BDBCols"), py::arg("NullDim"), py::arg("tol"), py::arg("workspace").noconvert());
+    m.def("evolution_strength_helper", &_evolution_strength_helper<int64_t, std::complex<float>, float>,
+        py::arg("Sx").noconvert(), py::arg("Sp"), py::arg("Sj"), py::arg("nrows"), py::arg("x"), py::arg("y"), py::arg("b"), py::arg("BDBCols"), py::arg("NullDim"), py::arg("tol"), py::arg("workspace").noconvert());
+    m.def("evolution_strength_helper", &_evolution_strength_helper<int64_t, std::complex<double>, double>,
+        py::arg("Sx").noconvert(), py::arg("Sp"), py::arg("Sj"), py::arg("nrows"), py::arg("x"), py::arg("y"), py::arg("b"), py::arg("BDBCols"), py::arg("NullDim"), py::arg("tol"), py::arg("workspace").noconvert(),
 R"pbdoc(
 Create strength-of-connection matrix based on constrained min problem of
    min( z - B*x ), such that
@@ -397,6 +475,12 @@ NullDim : {int}
      Number of nullspace vectors
 tol : {float}
      Used to determine when values are numerically zero
+workspace : {float|complex array}
+     Scratch space of length at least
+         p*(2*m*(NullDim + 1) + 3*(NullDim + 1)^2 + 2*(NullDim + 1)),
+     where m is the maximum number of nonzeros in a row of S and p is
+     the number of threads, see set_num_threads.  If workspace is
+     shorter than this, the scratch space is allocated internally.
 
 Returns
 -------
@@ -411,6 +495,11 @@ there is no need to completely calculate all of S.
 
 b is used to save on the computation of each local minimization problem
 
+The rows are independent, and are split over the threads.  Each local
+problem is solved with constrained_cholesky_solve, i.e. a Cholesky
+factorization instead of an SVD, unless it is ill-conditioned, in which
+case the pseudoinverse is used as before.
+
 Principle calling routine is evolution_strength_of_connection(...) in strength.py.
 In that routine, it is used to calculate strength-of-connection for the case
 of multiple near-nullspace modes.
@@ -420,13 +509,21 @@ Examples
 See evolution_strength_of_connection(...) in strength.py)pbdoc");
 
     m.def("incomplete_mat_mult_csr", &_incomplete_mat_mult_csr<int, float, float>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("Bp").noconvert(), py::arg("Bj").noconvert(), py::arg("Bx").noconvert(), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert(), py::arg("num_rows"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Bp"), py::arg("Bj"), py::arg("Bx"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert(), py::arg("num_rows"));
     m.def("incomplete_mat_mult_csr", &_incomplete_mat_mult_csr<int, double, double>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("Bp").noconvert(), py::arg("Bj").noconvert(), py::arg("Bx").noconvert(), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert(), py::arg("num_rows"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Bp"), py::arg("Bj"), py::arg("Bx"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert(), py::arg("num_rows"));
     m.def("incomplete_mat_mult_csr", &_incomplete_mat_mult_csr<int, std::complex<float>, float>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("Bp").noconvert(), py::arg("Bj").noconvert(), py::arg("Bx").noconvert(), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert(), py::arg("num_rows"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Bp"), py::arg("Bj"), py::arg("Bx"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert(), py::arg("num_rows"));
     m.def("incomplete_mat_mult_csr", &_incomplete_mat_mult_csr<int, std::complex<double>, double>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("Bp").noconvert(), py::arg("Bj").noconvert(), py::arg("Bx").noconvert(), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert(), py::arg("num_rows"),
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Bp"), py::arg("Bj"), py::arg("Bx"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert(), py::arg("num_rows"));
+    m.def("incomplete_mat_mult_csr", &_incomplete_mat_mult_csr<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Bp"), py::arg("Bj"), py::arg("Bx"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert(), py::arg("num_rows"));
+    m.def("incomplete_mat_mult_csr", &_incomplete_mat_mult_csr<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Bp"), py::arg("Bj"), py::arg("Bx"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert(), py::arg("num_rows"));
+    m.def("incomplete_mat_mult_csr", &_incomplete_mat_mult_csr<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Bp"), py::arg("Bj"), py::arg("Bx"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert(), py::arg("num_rows"));
+    m.def("incomplete_mat_mult_csr", &_incomplete_mat_mult_csr<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Bp"), py::arg("Bj"), py::arg("Bx"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert(), py::arg("num_rows"),
 R"pbdoc(
 Calculate A*B = S, but only at the pre-existing sparsity
 pattern of S, i.e. do an exact, but incomplete mat-mat multiply.
@@ -473,10 +570,9 @@ But, the routine is written for the case when S's
 sparsity pattern is a subset of A*B, so this algorithm
 should work well.
 
-Principle calling routine is evolution_strength_of_connection in
-strength.py.  Here it is used to calculate S*S only at the
-sparsity pattern of the original operator.  This allows for
-BIG cost savings.
+The rows of S are computed in parallel.  masked_mat_mult_csr(...)
+in sparse.h computes the same product with B in CSR, which is
+usually faster unless S has far fewer nonzeros than A or B.
 
 Examples
 --------
@@ -2,6 +2,8 @@
 ./bindthem.py graph.h
 ./bindthem.py krylov.h
 ./bindthem.py linalg.h
+./bindthem.py parallel.h
 ./bindthem.py relaxation.h
 ./bindthem.py ruge_stuben.h
 ./bindthem.py smoothed_aggregation.h
+./bindthem.py sparse.h
@@ -8,6 +8,8 @@
 #include <vector>
 #include <iostream>
 
+#include "parallel.h"
+
 inline void coreassert(const bool istrue, const std::string &errormsg){
     if (!istrue){
         throw std::runtime_error("pyamg-error (amg_core) -- " + errormsg);
@@ -93,6 +95,11 @@ I maximal_independent_set_serial(const I num_rows,
  *      be assigned the value C or F depending on whether they are in the
  *      MIS or not.
  *
+ *      Each iteration only visits the vertices that are still active,
+ *      and the vertices are tested and then updated in separate passes,
+ *      which are threaded with OpenMP.  The result therefore depends on
+ *      y, but not on the number of threads.  The graph must be symmetric.
+ *
  */
 template<class I, class T, class R>
 I maximal_independent_set_parallel(const I num_rows,
@@ -108,53 +115,91 @@ I maximal_independent_set_parallel(const I num_rows,
     I N = 0;
     I num_iters = 0;
 
-    bool active_nodes = true;
-
-    while(active_nodes && (max_iters == -1 || num_iters < max_iters)){
-        active_nodes = false;
+    // the active vertices, state[k] records whether frontier[k] is added
+    // to the MIS (1), has a neighbor in the MIS (2), or neither (0) in
+    // the current round
+    std::vector<I> frontier;
+    for(I i = 0; i < num_rows; i++){
+        if(x[i] == active)
+            frontier.push_back(i);
+    }
+    std::vector<char> state(frontier.size());
 
+    while(!frontier.empty() && (max_iters == -1 || num_iters < max_iters)){
         num_iters++;
 
-        for(I i = 0; i < num_rows; i++){
-            const R yi = y[i];
+        const I num_frontier = frontier.size();
+        I num_selected = 0;
 
-            if(x[i] != active) continue;
+        #pragma omp parallel
+        {
+            // find the vertices that are larger than all of their active
+            // neighbors, x is not modified until every vertex is tested
+            #pragma omp for schedule(static) reduction(+:num_selected)
+            for(I k = 0; k < num_frontier; k++){
+                const I i  = frontier[k];
+                const R yi = y[i];
 
-            const I row_start = Ap[i];
-            const I row_end   = Ap[i+1];
+                state[k] = 1;
 
-            I jj;
+                for(I jj = Ap[i]; jj < Ap[i+1]; jj++){
+                    const I j  = Aj[jj];
+                    const T xj = x[j];
 
-            for(jj = row_start; jj < row_end; jj++){
-                const I j  = Aj[jj];
-                const T xj = x[j];
+                    if(xj == C) {
+                        state[k] = 2;                  //neighbor is MIS
+                        break;
+                    }
 
-                if(xj == C) {
-                    x[i] = F;                      //neighbor is MIS
-                    break;
+                    if(xj == active){
+                        const R yj = y[j];
+                        if(yj > yi)
+                            state[k] = 0;              //neighbor is larger
+                        else if (yj == yi && j > i)
+                            state[k] = 0;              //tie breaker goes to neighbor
+                    }
                 }
 
-                if(xj == active){
-                    const R yj = y[j];
-                    if(yj > yi)
-                        break;                     //neighbor is larger
-                    else if (yj == yi && j > i)
-                        break;                     //tie breaker goes to neighbor
-                }
+                if(state[k] == 1)
+                    num_selected++;
             }
 
-            if(jj == row_end){
-                for(jj = row_start; jj < row_end; jj++){
-                    const I j  = Aj[jj];
-                    if(x[j] == active)
+            #pragma omp for schedule(static)
+            for(I k = 0; k < num_frontier; k++){
+                if(state[k] == 1)
+                    x[frontier[k]] = C;
+                else if(state[k] == 2)
+                    x[frontier[k]] = F;
+            }
+
+            // remove the active neighbors of the new MIS vertices
+            #pragma omp for schedule(static)
+            for(I k = 0; k < num_frontier; k++){
+                if(state[k] != 1) continue;
+                const I i = frontier[k];
+                for(I jj = Ap[i]; jj < Ap[i+1]; jj++){
+                    const I j = Aj[jj];
+                    T xj;
+                    #pragma omp atomic read
+                    xj = x[j];
+                    if(xj == active){
+                        #pragma omp atomic write
                         x[j] = F;
+                    }
                 }
-                N++;
-                x[i] = C;
-            } else {
-                active_nodes = true;
             }
         }
+
+        N += num_selected;
+
+        // compact the frontier to the vertices that are still active
+        I num_active = 0;
+        for(I k = 0; k < num_frontier; k++){
+            const I i = frontier[k];
+            if(x[i] == active)
+                frontier[num_active++] = i;
+        }
+        frontier.resize(num_active);
     } // end while
 
     return N;
@@ -237,6 +282,13 @@ void vertex_coloring_first_fit(const I num_rows,
  *  Notes:
  *      Arrays x and y will be overwritten
  *
+ *      Each round colors the uncolored vertices that have a larger
+ *      weight than all of their uncolored neighbors, using the first
+ *      color not used by a neighbor.  Only the uncolored vertices are
+ *      visited, and the rounds are threaded with OpenMP.  The coloring
+ *      depends on y, but not on the number of threads.  The graph must
+ *      be symmetric.
+ *
  *  References:
  *      Mark T. Jones and Paul E. Plassmann
  *      A Parallel Graph Coloring Heuristic
@@ -253,20 +305,86 @@ T vertex_coloring_jones_plassmann(const I num_rows,
 {
     std::fill( x, x + num_rows, -1);
 
+    #pragma omp parallel for schedule(static)
     for(I i = 0; i < num_rows; i++){
         z[i] += Ap[i+1] - Ap[i];
     }
 
-    I N = 0;
+    // the uncolored vertices, selected[k] records whether frontier[k]
+    // is colored in the current round
+    std::vector<I> frontier(num_rows);
+    for(I i = 0; i < num_rows; i++){
+        frontier[i] = i;
+    }
+    std::vector<char> selected(num_rows);
+
     T K = 0; //iteration number
 
-    while(N < num_rows){
-        N += maximal_independent_set_parallel(num_rows,Ap,Ap_size,Aj,Aj_size,-1,K,-2,x,x_size,z,z_size,1);
-        for(I i = 0; i < num_rows; i++){
-            if(x[i] == -2)
-                x[i] = -1;
+    while(!frontier.empty()){
+        const I num_frontier = frontier.size();
+
+        #pragma omp parallel
+        {
+            // colors of the neighbors of a vertex, indexed by color
+            std::vector<char> mask(K + 1, 0);
+
+            // find the vertices that are larger than all of their
+            // uncolored neighbors
+            #pragma omp for schedule(static)
+            for(I k = 0; k < num_frontier; k++){
+                const I i  = frontier[k];
+                const R zi = z[i];
+
+                selected[k] = 1;
+
+                for(I jj = Ap[i]; jj < Ap[i+1]; jj++){
+                    const I j = Aj[jj];
+                    if(x[j] != -1) continue;
+
+                    const R zj = z[j];
+                    if(zj > zi || (zj == zi && j > i)){
+                        selected[k] = 0;
+                        break;
+                    }
+                }
+            }
+
+            // first fit: assign each selected vertex the smallest color
+            // that is not used by its neighbors.  The selected vertices
+            // are independent, so only colors from previous rounds are read
+            #pragma omp for schedule(static)
+            for(I k = 0; k < num_frontier; k++){
+                if(!selected[k]) continue;
+                const I i = frontier[k];
+
+                for(I jj = Ap[i]; jj < Ap[i+1]; jj++){
+                    const I j = Aj[jj];
+                    if(  i == j  ) continue; //ignore diagonal
+                    if( x[j] < 0 ) continue; //ignore uncolored vertices
+                    mask[x[j]] = 1;
+                }
+
+                T c = 0;
+                while(mask[c]) c++;
+
+                for(I jj = Ap[i]; jj < Ap[i+1]; jj++){
+                    const I j = Aj[jj];
+                    if( i != j && x[j] >= 0 )
+                        mask[x[j]] = 0;
+                }
+
+                x[i] = c;
+            }
         }
-        vertex_coloring_first_fit(num_rows,Ap,Ap_size,Aj,Aj_size,x,x_size,K);
+
+        // compact the frontier to the vertices that are still uncolored
+        I num_uncolored = 0;
+        for(I k = 0; k < num_frontier; k++){
+            if(!selected[k])
+                frontier[num_uncolored++] = frontier[k];
+        }
+        frontier.resize(num_uncolored);
+
         K++;
     }
 
@@ -319,7 +437,7 @@ T vertex_coloring_LDF(const I num_rows,
             weights[i] = y[i] + num_neighbors;
         }
 
-        N += maximal_independent_set_parallel(num_rows,Ap,Ap_size,Aj,Aj_size,-1,K,-2,x,x_size,&weights[0],num_rows,1);
+        N += maximal_independent_set_parallel<I, T, R>(num_rows,Ap,Ap_size,Aj,Aj_size,-1,K,-2,x,x_size,&weights[0],num_rows,1);
         for(I i = 0; i < num_rows; i++){
             if(x[i] == -2)
                 x[i] = -1;
@@ -586,6 +704,173 @@ void bellman_ford(const I num_nodes,
 }
 
 
+/*
+ * Transpose a graph stored in CSR format, keeping the edge lengths
+ *
+ *  Parameters
+ *      num_nodes - (IN)  number of nodes (number of rows in A)
+ *      Ap[]      - (IN)  CSR row pointer
+ *      Aj[]      - (IN)  CSR index array
+ *      Ax[]      - (IN)  CSR data array (edge lengths)
+ *      Tp        - (OUT) CSR row pointer of the transpose
+ *      Tj        - (OUT) CSR index array of the transpose
+ *      Tx        - (OUT) CSR data array of the transpose
+ *
+ *  Notes:
+ *      Row i of the transpose lists the edges j -> i of A, in order of j.
+ *
+ */
+template<class I, class T>
+void csr_transpose_graph(const I num_nodes,
+                         const I Ap[],
+                         const I Aj[],
+                         const T Ax[],
+                         std::vector<I>& Tp,
+                         std::vector<I>& Tj,
+                         std::vector<T>& Tx)
+{
+    const I nnz = Ap[num_nodes];
+
+    Tp.assign(num_nodes + 1, 0);
+    Tj.resize(nnz);
+    Tx.resize(nnz);
+
+    for(I jj = 0; jj < nnz; jj++){
+        Tp[Aj[jj] + 1]++;
+    }
+    for(I i = 0; i < num_nodes; i++){
+        Tp[i + 1] += Tp[i];
+    }
+
+    std::vector<I> next(Tp.begin(), Tp.end() - 1);
+    for(I i = 0; i < num_nodes; i++){
+        for(I jj = Ap[i]; jj < Ap[i+1]; jj++){
+            const I n = next[Aj[jj]]++;
+            Tj[n] = i;
+            Tx[n] = Ax[jj];
+        }
+    }
+}
+
+
+/*
+ * Apply Bellman-Ford on a distance graph stored in CSR format,
+ * relaxing only the nodes next to the nodes that changed
+ *
+ * Computes the same distances as bellman_ford, but rather than
+ * sweeping over all of the nodes until nothing changes, each round
+ * only visits the nodes with an edge from the frontier, i.e. the nodes
+ * whose distance decreased in the previous round.  Each node of the
+ * frontier pulls the shortest path over its incoming edges from the
+ * distances of the previous round, so the rounds are threaded with
+ * OpenMP, and the result does not depend on the number of threads.
+ *
+ *  Parameters
+ *      num_nodes - (IN)    number of nodes (number of rows in A)
+ *      Ap[]      - (IN)    CSR row pointer
+ *      Aj[]      - (IN)    CSR index array
+ *      Ax[]      - (IN)    CSR data array (edge lengths)
+ *      d[]       - (INOUT) distance to nearest center
+ *     cm[]       - (INOUT) cluster index for each node
+ *
+ *  Notes:
+ *      A node only changes clusters if its distance strictly decreases.
+ *      Paths of equal length are broken in favor of the smaller cluster
+ *      index, where bellman_ford takes the first one in sweep order.
+ *
+ *  References:
+ *      http://en.wikipedia.org/wiki/Bellman-Ford_algorithm
+ */
+template<class I, class T>
+void bellman_ford_frontier(const I num_nodes,
+                           const I Ap[], const int Ap_size,
+                           const I Aj[], const int Aj_size,
+                           const T Ax[], const int Ax_size,
+                                 T  d[], const int  d_size,
+                                 I cm[], const int cm_size)
+{
+    // incoming edges of each node
+    std::vector<I> Tp, Tj;
+    std::vector<T> Tx;
+    csr_transpose_graph(num_nodes, Ap, Aj, Ax, Tp, Tj, Tx);
+
+    // nodes whose distance changed in the previous round
+    std::vector<I> frontier;
+    for(I i = 0; i < num_nodes; i++){
+        if(d[i] < std::numeric_limits<T>::max()){
+            frontier.push_back(i);
+        }
+    }
+
+    std::vector<char> marked(num_nodes, 0);
+    std::vector<I> candidates;
+    std::vector<T> new_d(num_nodes);
+    std::vector<I> new_cm(num_nodes);
+
+    while(!frontier.empty()){
+        const I num_frontier = frontier.size();
+
+        // the nodes with an edge from the frontier
+        candidates.clear();
+        #pragma omp parallel
+        {
+            std::vector<I> local;
+
+            #pragma omp for schedule(static) nowait
+            for(I n = 0; n < num_frontier; n++){
+                const I i = frontier[n];
+                for(I jj = Ap[i]; jj < Ap[i+1]; jj++){
+                    const I j = Aj[jj];
+                    char was_marked;
+                    #pragma omp atomic capture
+                    { was_marked = marked[j]; marked[j] = 1; }
+                    if(!was_marked){
+                        local.push_back(j);
+                    }
+                }
+            }
+
+            #pragma omp critical
+            candidates.insert(candidates.end(), local.begin(), local.end());
+        }
+
+        // relax the candidates with the distances of the previous round
+        const I num_candidates = candidates.size();
+        #pragma omp parallel for schedule(static)
+        for(I n = 0; n < num_candidates; n++){
+            const I i = candidates[n];
+
+            T best_d  = d[i];
+            I best_cm = cm[i];
+            for(I jj = Tp[i]; jj < Tp[i+1]; jj++){
+                const I j = Tj[jj];
+                const T dist = d[j] + Tx[jj];
+                if(dist < best_d){
+                    best_d  = dist;
+                    best_cm = cm[j];
+                }
+                else if(dist == best_d && dist < d[i] && cm[j] < best_cm){
+                    best_cm = cm[j];
+                }
+            }
+            new_d[i]  = best_d;
+            new_cm[i] = best_cm;
+        }
+
+        frontier.clear();
+        for(I n = 0; n < num_candidates; n++){
+            const I i = candidates[n];
+            marked[i] = 0;
+            if(new_d[i] < d[i]){
+                d[i]  = new_d[i];
+                cm[i] = new_cm[i];
+                frontier.push_back(i);
+            }
+        }
+    }
+}
+
+
 /*
  * Apply Bellman-Ford with a heuristic to balance cluster sizes
  *
@@ -603,6 +888,12 @@ void bellman_ford(const I num_nodes,
  *      d[]         - (INOUT) distance to nearest center
  *     cm[]         - (INOUT) cluster index for each node
  *
+ *  Notes:
+ *      The first sweep visits every node in order.  After that, a sweep
+ *      only visits the nodes next to a node that switched in the previous
+ *      sweep, and a full sweep is made to check for convergence once no
+ *      such nodes are left, since the cluster sizes change globally.
+ *
  *  References:
  *      http://en.wikipedia.org/wiki/Bellman-Ford_algorithm
  */
@@ -618,6 +909,11 @@ void bellman_ford_balanced(const I num_nodes,
     coreassert(d_size == num_nodes, "");
     coreassert(cm_size == num_nodes, "");
 
+    // nothing to relax, and the safety check below divides by num_nodes
+    if(num_nodes == 0){
+        return;
+    }
+
     std::vector<I> predecessor(num_nodes, -1); // index of predecessor node
     std::vector<I> pred_count(num_nodes, 0); // number of other nodes that we are the predecessor for
 
@@ -628,12 +924,34 @@ void bellman_ford_balanced(const I num_nodes,
         }
     }
 
-    bool change; // did we make any changes during this iteration?
+    // the nodes that read d[i] and cm[i], i.e. with an edge to node i
+    std::vector<I> Tp, Tj;
+    std::vector<T> Tx;
+    csr_transpose_graph(num_nodes, Ap, Aj, Ax, Tp, Tj, Tx);
+
+    std::vector<I> sweep(num_nodes); // nodes visited in the current sweep
+    std::vector<I> next;             // nodes visited in the next sweep
+    std::vector<char> queued(num_nodes, 0);
+    for(I i = 0; i < num_nodes; i++){
+        sweep[i] = i;
+    }
+
+    auto enqueue = [&](const I k){
+        if(!queued[k]){
+            queued[k] = 1;
+            next.push_back(k);
+        }
+    };
+
+    bool full_sweep = true; // does the current sweep visit every node?
     I iteration = 0; // iteration count for safety check
 
-    do{
-        change = false;
-        for(I i = 0; i < num_nodes; i++){
+    while(true){
+        bool change = false; // did we make any changes during this iteration?
+        next.clear();
+
+        for(const I i : sweep){
+            bool switched = false;
             for(I jj = Ap[i]; jj < Ap[i+1]; jj++){ // all neighbors of node i
                 const I j = Aj[jj];
                 const T new_d = Ax[jj] + d[j];
@@ -658,6 +976,7 @@ void bellman_ford_balanced(const I num_nodes,
                     if(predecessor[i] > -1){
                         pred_count[predecessor[i]]--;
                         coreassert(pred_count[predecessor[i]] >= 0, "");
+                        enqueue(predecessor[i]);
                     }
                     predecessor[i] = j;
                     pred_count[predecessor[i]]++;
@@ -666,14 +985,40 @@ void bellman_ford_balanced(const I num_nodes,
                     d[i] = new_d;
                     cm[i] = cm[j];
                     change = true;
+                    switched = true;
+                }
+            }
+            if(switched){
+                for(I kk = Tp[i]; kk < Tp[i+1]; kk++){
+                    enqueue(Tj[kk]);
                 }
             }
         }
         // safety check, regular unweighted BF is actually O(|V|.|E|)
-        if (++iteration > num_nodes*num_nodes){
+        if (++iteration / num_nodes > num_nodes){
             throw std::runtime_error("pyamg-error (amg_core) -- too many iterations!");
         }
-    } while(change);
+
+        if(!next.empty()){
+            // visit the nodes next to a switched node in order
+            std::sort(next.begin(), next.end());
+            for(const I k : next){
+                queued[k] = 0;
+            }
+            sweep.swap(next);
+            full_sweep = false;
+        }
+        else if(full_sweep && !change){
+            break;
+        }
+        else {
+            sweep.resize(num_nodes);
+            for(I i = 0; i < num_nodes; i++){
+                sweep[i] = i;
+            }
+            full_sweep = true;
+        }
+    }
 }
 
 
@@ -717,13 +1062,8 @@ void lloyd_cluster(const I num_nodes,
         cm[i] = a;
     }
 
-    std::vector<T> old_distances(num_nodes);
-
     // propagate distances outward
-    do{
-        std::copy(d, d+num_nodes, old_distances.begin());
-        bellman_ford(num_nodes, Ap, Ap_size, Aj, Aj_size, Ax, Ax_size, d, d_size, cm, cm_size);
-    } while ( !std::equal( d, d+num_nodes, old_distances.begin() ) );
+    bellman_ford_frontier(num_nodes, Ap, Ap_size, Aj, Aj_size, Ax, Ax_size, d, d_size, cm, cm_size);
 
     //find boundaries
     for(I i = 0; i < num_nodes; i++){
@@ -740,10 +1080,7 @@ void lloyd_cluster(const I num_nodes,
     }
 
     // propagate distances inward
-    do{
-        std::copy(d, d+num_nodes, old_distances.begin());
-        bellman_ford(num_nodes, Ap, Ap_size, Aj, Aj_size, Ax, Ax_size, d, d_size, cm, cm_size);
-    } while ( !std::equal( d, d+num_nodes, old_distances.begin() ) );
+    bellman_ford_frontier(num_nodes, Ap, Ap_size, Aj, Aj_size, Ax, Ax_size, d, d_size, cm, cm_size);
 
 
     // compute new seeds
@@ -858,6 +1195,7 @@ void csr_propagate_max(const IndexType  num_rows,
                        const ValueType  i_vals[],
                              ValueType  o_vals[])
 {
+    #pragma omp parallel for schedule(static)
     for(IndexType i = 0; i < num_rows; i++){
 
         IndexType k_max = i_keys[i];
@@ -898,6 +1236,11 @@ void csr_propagate_max(const IndexType  num_rows,
  *      y[]        - random values used during parallel MIS algorithm
  *      max_iters  - maximum number of iterations to use (default, no limit)
  *
+ *  Notes:
+ *      Each propagation step is threaded with OpenMP, and reads only
+ *      the values of the previous step, so the result depends on y,
+ *      but not on the number of threads.
+ *
  */
 template<class I, class T, class R>
 void maximal_independent_set_k_parallel(const I num_rows,
@@ -908,13 +1251,14 @@ void maximal_independent_set_k_parallel(const I num_rows,
                                         const R  y[], const int  y_size,
                                         const I  max_iters)
 {
-    std::vector<bool> active(num_rows,true);
+    std::vector<char> active(num_rows,true);
 
     std::vector<I> i_keys(num_rows);
     std::vector<I> o_keys(num_rows);
     std::vector<R> i_vals(num_rows);
     std::vector<R> o_vals(num_rows);
 
+    #pragma omp parallel for schedule(static)
     for(I i = 0; i < num_rows; i++){
         i_keys[i] = i;
         i_vals[i] = y[i];
@@ -928,6 +1272,7 @@ void maximal_independent_set_k_parallel(const I num_rows,
             std::swap(i_vals, o_vals);
         }
 
+        #pragma omp parallel for schedule(static)
         for(I i = 0; i < num_rows; i++){
             if( i_keys[i] == i && active[i]){
                 x[i] = 1; // i is a MIS-k node
@@ -954,6 +1299,7 @@ void maximal_independent_set_k_parallel(const I num_rows,
 
         bool work_left = false;
 
+        #pragma omp parallel for schedule(static) reduction(||:work_left)
         for(I i = 0; i < num_rows; i++){
             if(i_vals[i] == 1){
                 active[i] =  false;
@@ -1027,6 +1373,94 @@ void breadth_first_search(const I Ap[], const int Ap_size,
 }
 
 
+/*
+ *  Compute a Cuthill-McKee ordering of a graph in CSR format.
+ *
+ *  Each connected component is searched breadth first, as in
+ *  breadth_first_search, from a vertex of minimum degree, and the
+ *  unmarked neighbors of each vertex are added to the queue by
+ *  increasing degree, with ties broken by the vertex number.  The
+ *  reverse of order is the reverse Cuthill-McKee ordering, which reduces
+ *  the bandwidth of a matrix with this graph.
+ *
+ *  Parameters
+ *      num_rows         - number of rows in A (number of vertices)
+ *      Ap[]             - CSR row pointer
+ *      Aj[]             - CSR index array
+ *      order[num_rows]  - records the order in which vertices were searched
+ *      level[num_rows]  - records the level set of each vertex (i.e. the
+ *                         distance to the seed of its component)
+ *
+ *  Notes:
+ *      The values of the level must be initialized to -1
+ *      The graph must be symmetric
+ *
+ */
+template <class I>
+void cuthill_mckee(const I num_rows,
+                   const I Ap[], const int Ap_size,
+                   const I Aj[], const int Aj_size,
+                         I order[], const int order_size,
+                         I level[], const int level_size)
+{
+    // the vertices by increasing degree, with a counting sort
+    std::vector<I> degree(num_rows);
+    I max_degree = 0;
+    for(I i = 0; i < num_rows; i++){
+        degree[i] = Ap[i+1] - Ap[i];
+        max_degree = std::max(max_degree, degree[i]);
+    }
+
+    std::vector<I> count(max_degree + 2, 0);
+    for(I i = 0; i < num_rows; i++){
+        count[degree[i] + 1]++;
+    }
+    for(I d = 0; d <= max_degree; d++){
+        count[d + 1] += count[d];
+    }
+
+    std::vector<I> by_degree(num_rows);
+    for(I i = 0; i < num_rows; i++){
+        by_degree[count[degree[i]]++] = i;
+    }
+
+    I N = 0;
+    for(I r = 0; r < num_rows; r++){
+        const I seed = by_degree[r];
+        if(level[seed] != -1){
+            continue;
+        }
+
+        // search the component of seed
+        order[N] = seed;
+        level[seed] = 0;
+        N++;
+
+        for(I ii = N - 1; ii < N; ii++){
+            const I i = order[ii];
+            const I first = N;
+
+            for(I jj = Ap[i]; jj < Ap[i+1]; jj++){
+                const I j = Aj[jj];
+                if(level[j] == -1){
+                    order[N] = j;
+                    level[j] = level[i] + 1;
+                    N++;
+                }
+            }
+
+            std::sort(order + first, order + N,
+                      [&](const I& a, const I& b)
+                      {
+                          return (degree[a] < degree[b]) ||
+                                 (degree[a] == degree[b] && a < b);
+                      }
+                     );
+        }
+    }
+}
+
+
 /*
  *  Compute the connected components of a graph stored in CSR format.
  *
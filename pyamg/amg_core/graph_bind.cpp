@@ -4,6 +4,9 @@
 #include <pybind11/numpy.h>
 #include <pybind11/complex.h>
 
+#include "bind_arrays.h"
+#include "bind_threads.h"
+#include "bind_timers.h"
 #include "graph.h"
 
 namespace py = pybind11;
@@ -11,12 +14,12 @@ namespace py = pybind11;
 template<class I, class T>
 I _maximal_independent_set_serial(
          const I num_rows,
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
+      input_array<I> & Ap,
+      input_array<I> & Aj,
            const T active,
                 const T C,
                 const T F,
-       py::array_t<T> & x
+      output_array<T> & x
                                   )
 {
     auto py_Ap = Ap.unchecked();
@@ -25,28 +28,35 @@ I _maximal_independent_set_serial(
     const I *_Ap = py_Ap.data();
     const I *_Aj = py_Aj.data();
     T *_x = py_x.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int x_size = array_size(x.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("maximal_independent_set_serial");
 
     return maximal_independent_set_serial<I, T>(
                  num_rows,
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
                    active,
                         C,
                         F,
-                       _x, x.shape(0)
+                       _x, x_size
                                                 );
 }
 
 template<class I, class T, class R>
 I _maximal_independent_set_parallel(
          const I num_rows,
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
+      input_array<I> & Ap,
+      input_array<I> & Aj,
            const T active,
                 const T C,
                 const T F,
-       py::array_t<T> & x,
-       py::array_t<R> & y,
+      output_array<T> & x,
+       input_array<R> & y,
         const I max_iters
                                     )
 {
@@ -58,16 +68,24 @@ I _maximal_independent_set_parallel(
     const I *_Aj = py_Aj.data();
     T *_x = py_x.mutable_data();
     const R *_y = py_y.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int x_size = array_size(x.shape(0));
+    int y_size = array_size(y.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("maximal_independent_set_parallel");
 
     return maximal_independent_set_parallel<I, T, R>(
                  num_rows,
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
                    active,
                         C,
                         F,
-                       _x, x.shape(0),
-                       _y, y.shape(0),
+                       _x, x_size,
+                       _y, y_size,
                 max_iters
                                                      );
 }
@@ -75,9 +93,9 @@ I _maximal_independent_set_parallel(
 template<class I, class T>
 T _vertex_coloring_mis(
          const I num_rows,
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
-       py::array_t<T> & x
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      output_array<T> & x
                        )
 {
     auto py_Ap = Ap.unchecked();
@@ -86,22 +104,29 @@ T _vertex_coloring_mis(
     const I *_Ap = py_Ap.data();
     const I *_Aj = py_Aj.data();
     T *_x = py_x.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int x_size = array_size(x.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("vertex_coloring_mis");
 
     return vertex_coloring_mis<I, T>(
                  num_rows,
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
-                       _x, x.shape(0)
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                       _x, x_size
                                      );
 }
 
 template<class I, class T, class R>
 T _vertex_coloring_jones_plassmann(
          const I num_rows,
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
-       py::array_t<T> & x,
-       py::array_t<R> & z
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      output_array<T> & x,
+      output_array<R> & z
                                    )
 {
     auto py_Ap = Ap.unchecked();
@@ -112,23 +137,31 @@ T _vertex_coloring_jones_plassmann(
     const I *_Aj = py_Aj.data();
     T *_x = py_x.mutable_data();
     R *_z = py_z.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int x_size = array_size(x.shape(0));
+    int z_size = array_size(z.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("vertex_coloring_jones_plassmann");
 
     return vertex_coloring_jones_plassmann<I, T, R>(
                  num_rows,
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
-                       _x, x.shape(0),
-                       _z, z.shape(0)
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                       _x, x_size,
+                       _z, z_size
                                                     );
 }
 
 template<class I, class T, class R>
 T _vertex_coloring_LDF(
          const I num_rows,
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
-       py::array_t<T> & x,
-       py::array_t<R> & y
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      output_array<T> & x,
+       input_array<R> & y
                        )
 {
     auto py_Ap = Ap.unchecked();
@@ -139,13 +172,21 @@ T _vertex_coloring_LDF(
     const I *_Aj = py_Aj.data();
     T *_x = py_x.mutable_data();
     const R *_y = py_y.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int x_size = array_size(x.shape(0));
+    int y_size = array_size(y.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("vertex_coloring_LDF");
 
     return vertex_coloring_LDF<I, T, R>(
                  num_rows,
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
-                       _x, x.shape(0),
-                       _y, y.shape(0)
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                       _x, x_size,
+                       _y, y_size
                                         );
 }
 
@@ -153,10 +194,10 @@ template<class I>
 void _cluster_node_incidence(
         const I num_nodes,
      const I num_clusters,
-      py::array_t<I> & cm,
-     py::array_t<I> & ICp,
-     py::array_t<I> & ICi,
-       py::array_t<I> & L
+      input_array<I> & cm,
+    output_array<I> & ICp,
+    output_array<I> & ICi,
+      output_array<I> & L
                              )
 {
     auto py_cm = cm.unchecked();
@@ -167,14 +208,22 @@ void _cluster_node_incidence(
     I *_ICp = py_ICp.mutable_data();
     I *_ICi = py_ICi.mutable_data();
     I *_L = py_L.mutable_data();
+    int cm_size = array_size(cm.shape(0));
+    int ICp_size = array_size(ICp.shape(0));
+    int ICi_size = array_size(ICi.shape(0));
+    int L_size = array_size(L.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("cluster_node_incidence");
 
     return cluster_node_incidence<I>(
                 num_nodes,
              num_clusters,
-                      _cm, cm.shape(0),
-                     _ICp, ICp.shape(0),
-                     _ICi, ICi.shape(0),
-                       _L, L.shape(0)
+                      _cm, cm_size,
+                     _ICp, ICp_size,
+                     _ICi, ICi_size,
+                       _L, L_size
                                      );
 }
 
@@ -183,13 +232,13 @@ I _cluster_center(
                 const I a,
         const I num_nodes,
      const I num_clusters,
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
-      py::array_t<T> & Ax,
-      py::array_t<I> & cm,
-     py::array_t<I> & ICp,
-     py::array_t<I> & ICi,
-       py::array_t<I> & L
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      input_array<I> & cm,
+     input_array<I> & ICp,
+     input_array<I> & ICi,
+       input_array<I> & L
                   )
 {
     auto py_Ap = Ap.unchecked();
@@ -206,29 +255,40 @@ I _cluster_center(
     const I *_ICp = py_ICp.data();
     const I *_ICi = py_ICi.data();
     const I *_L = py_L.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int cm_size = array_size(cm.shape(0));
+    int ICp_size = array_size(ICp.shape(0));
+    int ICi_size = array_size(ICi.shape(0));
+    int L_size = array_size(L.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("cluster_center");
 
     return cluster_center<I, T>(
                         a,
                 num_nodes,
              num_clusters,
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
-                      _Ax, Ax.shape(0),
-                      _cm, cm.shape(0),
-                     _ICp, ICp.shape(0),
-                     _ICi, ICi.shape(0),
-                       _L, L.shape(0)
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                      _cm, cm_size,
+                     _ICp, ICp_size,
+                     _ICi, ICi_size,
+                       _L, L_size
                                 );
 }
 
 template<class I, class T>
 void _bellman_ford(
         const I num_nodes,
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
-      py::array_t<T> & Ax,
-       py::array_t<T> & d,
-      py::array_t<I> & cm
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      output_array<T> & d,
+     output_array<I> & cm
                    )
 {
     auto py_Ap = Ap.unchecked();
@@ -241,27 +301,76 @@ void _bellman_ford(
     const T *_Ax = py_Ax.data();
     T *_d = py_d.mutable_data();
     I *_cm = py_cm.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int d_size = array_size(d.shape(0));
+    int cm_size = array_size(cm.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("bellman_ford");
 
     return bellman_ford<I, T>(
                 num_nodes,
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
-                      _Ax, Ax.shape(0),
-                       _d, d.shape(0),
-                      _cm, cm.shape(0)
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                       _d, d_size,
+                      _cm, cm_size
                               );
 }
 
+template<class I, class T>
+void _bellman_ford_frontier(
+        const I num_nodes,
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      output_array<T> & d,
+     output_array<I> & cm
+                            )
+{
+    auto py_Ap = Ap.unchecked();
+    auto py_Aj = Aj.unchecked();
+    auto py_Ax = Ax.unchecked();
+    auto py_d = d.mutable_unchecked();
+    auto py_cm = cm.mutable_unchecked();
+    const I *_Ap = py_Ap.data();
+    const I *_Aj = py_Aj.data();
+    const T *_Ax = py_Ax.data();
+    T *_d = py_d.mutable_data();
+    I *_cm = py_cm.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int d_size = array_size(d.shape(0));
+    int cm_size = array_size(cm.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("bellman_ford_frontier");
+
+    return bellman_ford_frontier<I, T>(
+                num_nodes,
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                       _d, d_size,
+                      _cm, cm_size
+                                       );
+}
+
 template<class I, class T>
 void _lloyd_cluster(
         const I num_nodes,
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
-      py::array_t<T> & Ax,
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
      const I num_clusters,
-       py::array_t<T> & d,
-      py::array_t<I> & cm,
-       py::array_t<I> & c
+      output_array<T> & d,
+     output_array<I> & cm,
+      output_array<I> & c
                     )
 {
     auto py_Ap = Ap.unchecked();
@@ -276,29 +385,39 @@ void _lloyd_cluster(
     T *_d = py_d.mutable_data();
     I *_cm = py_cm.mutable_data();
     I *_c = py_c.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int d_size = array_size(d.shape(0));
+    int cm_size = array_size(cm.shape(0));
+    int c_size = array_size(c.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("lloyd_cluster");
 
     return lloyd_cluster<I, T>(
                 num_nodes,
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
-                      _Ax, Ax.shape(0),
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
              num_clusters,
-                       _d, d.shape(0),
-                      _cm, cm.shape(0),
-                       _c, c.shape(0)
+                       _d, d_size,
+                      _cm, cm_size,
+                       _c, c_size
                                );
 }
 
 template<class I, class T>
 void _lloyd_cluster_exact(
         const I num_nodes,
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
-      py::array_t<T> & Ax,
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
      const I num_clusters,
-       py::array_t<T> & d,
-      py::array_t<I> & cm,
-       py::array_t<I> & c
+      output_array<T> & d,
+     output_array<I> & cm,
+      output_array<I> & c
                           )
 {
     auto py_Ap = Ap.unchecked();
@@ -313,27 +432,37 @@ void _lloyd_cluster_exact(
     T *_d = py_d.mutable_data();
     I *_cm = py_cm.mutable_data();
     I *_c = py_c.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int d_size = array_size(d.shape(0));
+    int cm_size = array_size(cm.shape(0));
+    int c_size = array_size(c.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("lloyd_cluster_exact");
 
     return lloyd_cluster_exact<I, T>(
                 num_nodes,
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
-                      _Ax, Ax.shape(0),
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
              num_clusters,
-                       _d, d.shape(0),
-                      _cm, cm.shape(0),
-                       _c, c.shape(0)
+                       _d, d_size,
+                      _cm, cm_size,
+                       _c, c_size
                                      );
 }
 
 template<class I, class T, class R>
 void _maximal_independent_set_k_parallel(
          const I num_rows,
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
+      input_array<I> & Ap,
+      input_array<I> & Aj,
                 const I k,
-       py::array_t<T> & x,
-       py::array_t<R> & y,
+      output_array<T> & x,
+       input_array<R> & y,
         const I max_iters
                                          )
 {
@@ -345,25 +474,33 @@ void _maximal_independent_set_k_parallel(
     const I *_Aj = py_Aj.data();
     T *_x = py_x.mutable_data();
     const R *_y = py_y.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int x_size = array_size(x.shape(0));
+    int y_size = array_size(y.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("maximal_independent_set_k_parallel");
 
     return maximal_independent_set_k_parallel<I, T, R>(
                  num_rows,
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
                         k,
-                       _x, x.shape(0),
-                       _y, y.shape(0),
+                       _x, x_size,
+                       _y, y_size,
                 max_iters
                                                        );
 }
 
 template <class I>
 void _breadth_first_search(
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
+      input_array<I> & Ap,
+      input_array<I> & Aj,
              const I seed,
-   py::array_t<I> & order,
-   py::array_t<I> & level
+  output_array<I> & order,
+  output_array<I> & level
                            )
 {
     auto py_Ap = Ap.unchecked();
@@ -374,22 +511,65 @@ void _breadth_first_search(
     const I *_Aj = py_Aj.data();
     I *_order = py_order.mutable_data();
     I *_level = py_level.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int order_size = array_size(order.shape(0));
+    int level_size = array_size(level.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("breadth_first_search");
 
     return breadth_first_search <I>(
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
                      seed,
-                   _order, order.shape(0),
-                   _level, level.shape(0)
+                   _order, order_size,
+                   _level, level_size
                                     );
 }
 
+template <class I>
+void _cuthill_mckee(
+         const I num_rows,
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+  output_array<I> & order,
+  output_array<I> & level
+                    )
+{
+    auto py_Ap = Ap.unchecked();
+    auto py_Aj = Aj.unchecked();
+    auto py_order = order.mutable_unchecked();
+    auto py_level = level.mutable_unchecked();
+    const I *_Ap = py_Ap.data();
+    const I *_Aj = py_Aj.data();
+    I *_order = py_order.mutable_data();
+    I *_level = py_level.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int order_size = array_size(order.shape(0));
+    int level_size = array_size(level.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("cuthill_mckee");
+
+    return cuthill_mckee <I>(
+                 num_rows,
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                   _order, order_size,
+                   _level, level_size
+                             );
+}
+
 template <class I>
 I _connected_components(
         const I num_nodes,
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
-py::array_t<I> & components
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+output_array<I> & components
                         )
 {
     auto py_Ap = Ap.unchecked();
@@ -398,12 +578,19 @@ py::array_t<I> & components
     const I *_Ap = py_Ap.data();
     const I *_Aj = py_Aj.data();
     I *_components = py_components.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int components_size = array_size(components.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("connected_components");
 
     return connected_components <I>(
                 num_nodes,
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
-              _components, components.shape(0)
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+              _components, components_size
                                     );
 }
 
@@ -422,18 +609,29 @@ PYBIND11_MODULE(graph, m) {
     cluster_node_incidence
     cluster_center
     bellman_ford
+    bellman_ford_frontier
     lloyd_cluster
     lloyd_cluster_exact
     maximal_independent_set_k_parallel
     breadth_first_search
+    cuthill_mckee
     connected_components
     )pbdoc";
 
     py::options options;
     options.disable_function_signatures();
 
+    share_num_threads();
+
+    m.def("_kernel_timers", &swap_kernel_timers, py::arg("enable"),
+R"pbdoc(
+Return and reset the kernel timers of the calling thread, and enable or
+disable them for subsequent calls, see bind_timers.h.)pbdoc");
+
     m.def("maximal_independent_set_serial", &_maximal_independent_set_serial<int, int>,
-        py::arg("num_rows"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("active"), py::arg("C"), py::arg("F"), py::arg("x").noconvert(),
+        py::arg("num_rows"), py::arg("Ap"), py::arg("Aj"), py::arg("active"), py::arg("C"), py::arg("F"), py::arg("x").noconvert());
+    m.def("maximal_independent_set_serial", &_maximal_independent_set_serial<int64_t, int64_t>,
+        py::arg("num_rows"), py::arg("Ap"), py::arg("Aj"), py::arg("active"), py::arg("C"), py::arg("F"), py::arg("x").noconvert(),
 R"pbdoc(
 Compute a maximal independent set for a graph stored in CSR format
  using a greedy serial algorithm
@@ -458,7 +656,9 @@ Compute a maximal independent set for a graph stored in CSR format
      MIS or not.)pbdoc");
 
     m.def("maximal_independent_set_parallel", &_maximal_independent_set_parallel<int, int, double>,
-        py::arg("num_rows"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("active"), py::arg("C"), py::arg("F"), py::arg("x").noconvert(), py::arg("y").noconvert(), py::arg("max_iters"),
+        py::arg("num_rows"), py::arg("Ap"), py::arg("Aj"), py::arg("active"), py::arg("C"), py::arg("F"), py::arg("x").noconvert(), py::arg("y"), py::arg("max_iters"));
+    m.def("maximal_independent_set_parallel", &_maximal_independent_set_parallel<int64_t, int64_t, double>,
+        py::arg("num_rows"), py::arg("Ap"), py::arg("Aj"), py::arg("active"), py::arg("C"), py::arg("F"), py::arg("x").noconvert(), py::arg("y"), py::arg("max_iters"),
 R"pbdoc(
 Compute a maximal independent set for a graph stored in CSR format
  using a variant of Luby's parallel MIS algorithm
@@ -483,10 +683,17 @@ Compute a maximal independent set for a graph stored in CSR format
      Only the vertices with values with x[i] == active are considered
      when determining the MIS.  Upon return, all active vertices will
      be assigned the value C or F depending on whether they are in the
-     MIS or not.)pbdoc");
+     MIS or not.
+
+     Each iteration only visits the vertices that are still active,
+     and the vertices are tested and then updated in separate passes,
+     which are threaded with OpenMP.  The result therefore depends on
+     y, but not on the number of threads.  The graph must be symmetric.)pbdoc");
 
     m.def("vertex_coloring_mis", &_vertex_coloring_mis<int, int>,
-        py::arg("num_rows"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("x").noconvert(),
+        py::arg("num_rows"), py::arg("Ap"), py::arg("Aj"), py::arg("x").noconvert());
+    m.def("vertex_coloring_mis", &_vertex_coloring_mis<int64_t, int64_t>,
+        py::arg("num_rows"), py::arg("Ap"), py::arg("Aj"), py::arg("x").noconvert(),
 R"pbdoc(
 Compute a vertex coloring for a graph stored in CSR format.
 
@@ -500,7 +707,9 @@ Compute a vertex coloring for a graph stored in CSR format.
  of the i-th vertex.)pbdoc");
 
     m.def("vertex_coloring_jones_plassmann", &_vertex_coloring_jones_plassmann<int, int, double>,
-        py::arg("num_rows"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("x").noconvert(), py::arg("z").noconvert(),
+        py::arg("num_rows"), py::arg("Ap"), py::arg("Aj"), py::arg("x").noconvert(), py::arg("z").noconvert());
+    m.def("vertex_coloring_jones_plassmann", &_vertex_coloring_jones_plassmann<int64_t, int64_t, double>,
+        py::arg("num_rows"), py::arg("Ap"), py::arg("Aj"), py::arg("x").noconvert(), py::arg("z").noconvert(),
 R"pbdoc(
 Compute a vertex coloring of a graph using the Jones-Plassmann algorithm
 
@@ -514,6 +723,13 @@ Compute a vertex coloring of a graph using the Jones-Plassmann algorithm
  Notes:
      Arrays x and y will be overwritten
 
+     Each round colors the uncolored vertices that have a larger
+     weight than all of their uncolored neighbors, using the first
+     color not used by a neighbor.  Only the uncolored vertices are
+     visited, and the rounds are threaded with OpenMP.  The coloring
+     depends on y, but not on the number of threads.  The graph must
+     be symmetric.
+
  References:
      Mark T. Jones and Paul E. Plassmann
      A Parallel Graph Coloring Heuristic
@@ -521,7 +737,9 @@ Compute a vertex coloring of a graph using the Jones-Plassmann algorithm
      http://citeseer.ist.psu.edu/jones92parallel.html)pbdoc");
 
     m.def("vertex_coloring_LDF", &_vertex_coloring_LDF<int, int, double>,
-        py::arg("num_rows"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("x").noconvert(), py::arg("y").noconvert(),
+        py::arg("num_rows"), py::arg("Ap"), py::arg("Aj"), py::arg("x").noconvert(), py::arg("y"));
+    m.def("vertex_coloring_LDF", &_vertex_coloring_LDF<int64_t, int64_t, double>,
+        py::arg("num_rows"), py::arg("Ap"), py::arg("Aj"), py::arg("x").noconvert(), py::arg("y"),
 R"pbdoc(
 Compute a vertex coloring of a graph using the parallel
 Largest-Degree-First (LDF) algorithm
@@ -540,7 +758,9 @@ Largest-Degree-First (LDF) algorithm
     http://citeseerx.ist.psu.edu/viewdoc/summary?doi=10.1.1.45.4650)pbdoc");
 
     m.def("cluster_node_incidence", &_cluster_node_incidence<int>,
-        py::arg("num_nodes"), py::arg("num_clusters"), py::arg("cm").noconvert(), py::arg("ICp").noconvert(), py::arg("ICi").noconvert(), py::arg("L").noconvert(),
+        py::arg("num_nodes"), py::arg("num_clusters"), py::arg("cm"), py::arg("ICp").noconvert(), py::arg("ICi").noconvert(), py::arg("L").noconvert());
+    m.def("cluster_node_incidence", &_cluster_node_incidence<int64_t>,
+        py::arg("num_nodes"), py::arg("num_clusters"), py::arg("cm"), py::arg("ICp").noconvert(), py::arg("ICi").noconvert(), py::arg("L").noconvert(),
 R"pbdoc(
 Compute the incidence matrix for a clustering
 
@@ -579,11 +799,17 @@ L is an additional vector (length num_rows) to store local indexes.
      L[num_nodes]      - (OUT) Local index mapping)pbdoc");
 
     m.def("cluster_center", &_cluster_center<int, int>,
-        py::arg("a"), py::arg("num_nodes"), py::arg("num_clusters"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("cm").noconvert(), py::arg("ICp").noconvert(), py::arg("ICi").noconvert(), py::arg("L").noconvert());
+        py::arg("a"), py::arg("num_nodes"), py::arg("num_clusters"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("cm"), py::arg("ICp"), py::arg("ICi"), py::arg("L"));
     m.def("cluster_center", &_cluster_center<int, float>,
-        py::arg("a"), py::arg("num_nodes"), py::arg("num_clusters"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("cm").noconvert(), py::arg("ICp").noconvert(), py::arg("ICi").noconvert(), py::arg("L").noconvert());
+        py::arg("a"), py::arg("num_nodes"), py::arg("num_clusters"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("cm"), py::arg("ICp"), py::arg("ICi"), py::arg("L"));
     m.def("cluster_center", &_cluster_center<int, double>,
-        py::arg("a"), py::arg("num_nodes"), py::arg("num_clusters"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("cm").noconvert(), py::arg("ICp").noconvert(), py::arg("ICi").noconvert(), py::arg("L").noconvert(),
+        py::arg("a"), py::arg("num_nodes"), py::arg("num_clusters"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("cm"), py::arg("ICp"), py::arg("ICi"), py::arg("L"));
+    m.def("cluster_center", &_cluster_center<int64_t, int>,
+        py::arg("a"), py::arg("num_nodes"), py::arg("num_clusters"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("cm"), py::arg("ICp"), py::arg("ICi"), py::arg("L"));
+    m.def("cluster_center", &_cluster_center<int64_t, float>,
+        py::arg("a"), py::arg("num_nodes"), py::arg("num_clusters"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("cm"), py::arg("ICp"), py::arg("ICi"), py::arg("L"));
+    m.def("cluster_center", &_cluster_center<int64_t, double>,
+        py::arg("a"), py::arg("num_nodes"), py::arg("num_clusters"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("cm"), py::arg("ICp"), py::arg("ICi"), py::arg("L"),
 R"pbdoc(
 Apply Floyd–Warshall to cluster "a" and use the result to find the
 cluster center
@@ -609,11 +835,17 @@ cluster center
      https://en.wikipedia.org/wiki/Distance_(graph_theory))pbdoc");
 
     m.def("bellman_ford", &_bellman_ford<int, int>,
-        py::arg("num_nodes"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("d").noconvert(), py::arg("cm").noconvert());
+        py::arg("num_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("d").noconvert(), py::arg("cm").noconvert());
     m.def("bellman_ford", &_bellman_ford<int, float>,
-        py::arg("num_nodes"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("d").noconvert(), py::arg("cm").noconvert());
+        py::arg("num_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("d").noconvert(), py::arg("cm").noconvert());
     m.def("bellman_ford", &_bellman_ford<int, double>,
-        py::arg("num_nodes"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("d").noconvert(), py::arg("cm").noconvert(),
+        py::arg("num_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("d").noconvert(), py::arg("cm").noconvert());
+    m.def("bellman_ford", &_bellman_ford<int64_t, int>,
+        py::arg("num_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("d").noconvert(), py::arg("cm").noconvert());
+    m.def("bellman_ford", &_bellman_ford<int64_t, float>,
+        py::arg("num_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("d").noconvert(), py::arg("cm").noconvert());
+    m.def("bellman_ford", &_bellman_ford<int64_t, double>,
+        py::arg("num_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("d").noconvert(), py::arg("cm").noconvert(),
 R"pbdoc(
 Apply one iteration of Bellman-Ford iteration on a distance
 graph stored in CSR format.
@@ -626,15 +858,61 @@ graph stored in CSR format.
      d[]       - (INOUT) distance to nearest center
     cm[]       - (INOUT) cluster index for each node
 
+ References:
+     http://en.wikipedia.org/wiki/Bellman-Ford_algorithm)pbdoc");
+
+    m.def("bellman_ford_frontier", &_bellman_ford_frontier<int, int>,
+        py::arg("num_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("d").noconvert(), py::arg("cm").noconvert());
+    m.def("bellman_ford_frontier", &_bellman_ford_frontier<int, float>,
+        py::arg("num_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("d").noconvert(), py::arg("cm").noconvert());
+    m.def("bellman_ford_frontier", &_bellman_ford_frontier<int, double>,
+        py::arg("num_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("d").noconvert(), py::arg("cm").noconvert());
+    m.def("bellman_ford_frontier", &_bellman_ford_frontier<int64_t, int>,
+        py::arg("num_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("d").noconvert(), py::arg("cm").noconvert());
+    m.def("bellman_ford_frontier", &_bellman_ford_frontier<int64_t, float>,
+        py::arg("num_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("d").noconvert(), py::arg("cm").noconvert());
+    m.def("bellman_ford_frontier", &_bellman_ford_frontier<int64_t, double>,
+        py::arg("num_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("d").noconvert(), py::arg("cm").noconvert(),
+R"pbdoc(
+Apply Bellman-Ford on a distance graph stored in CSR format,
+relaxing only the nodes next to the nodes that changed
+
+Computes the same distances as bellman_ford, but rather than
+sweeping over all of the nodes until nothing changes, each round
+only visits the nodes with an edge from the frontier, i.e. the nodes
+whose distance decreased in the previous round.  Each node of the
+frontier pulls the shortest path over its incoming edges from the
+distances of the previous round, so the rounds are threaded with
+OpenMP, and the result does not depend on the number of threads.
+
+ Parameters
+     num_nodes - (IN)    number of nodes (number of rows in A)
+     Ap[]      - (IN)    CSR row pointer
+     Aj[]      - (IN)    CSR index array
+     Ax[]      - (IN)    CSR data array (edge lengths)
+     d[]       - (INOUT) distance to nearest center
+    cm[]       - (INOUT) cluster index for each node
+
+ Notes:
+     A node only changes clusters if its distance strictly decreases.
+     Paths of equal length are broken in favor of the smaller cluster
+     index, where bellman_ford takes the first one in sweep order.
+
  References:
      http://en.wikipedia.org/wiki/Bellman-Ford_algorithm)pbdoc");
 
     m.def("lloyd_cluster", &_lloyd_cluster<int, int>,
-        py::arg("num_nodes"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("num_clusters"), py::arg("d").noconvert(), py::arg("cm").noconvert(), py::arg("c").noconvert());
+        py::arg("num_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("num_clusters"), py::arg("d").noconvert(), py::arg("cm").noconvert(), py::arg("c").noconvert());
     m.def("lloyd_cluster", &_lloyd_cluster<int, float>,
-        py::arg("num_nodes"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("num_clusters"), py::arg("d").noconvert(), py::arg("cm").noconvert(), py::arg("c").noconvert());
+        py::arg("num_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("num_clusters"), py::arg("d").noconvert(), py::arg("cm").noconvert(), py::arg("c").noconvert());
     m.def("lloyd_cluster", &_lloyd_cluster<int, double>,
-        py::arg("num_nodes"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("num_clusters"), py::arg("d").noconvert(), py::arg("cm").noconvert(), py::arg("c").noconvert(),
+        py::arg("num_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("num_clusters"), py::arg("d").noconvert(), py::arg("cm").noconvert(), py::arg("c").noconvert());
+    m.def("lloyd_cluster", &_lloyd_cluster<int64_t, int>,
+        py::arg("num_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("num_clusters"), py::arg("d").noconvert(), py::arg("cm").noconvert(), py::arg("c").noconvert());
+    m.def("lloyd_cluster", &_lloyd_cluster<int64_t, float>,
+        py::arg("num_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("num_clusters"), py::arg("d").noconvert(), py::arg("cm").noconvert(), py::arg("c").noconvert());
+    m.def("lloyd_cluster", &_lloyd_cluster<int64_t, double>,
+        py::arg("num_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("num_clusters"), py::arg("d").noconvert(), py::arg("cm").noconvert(), py::arg("c").noconvert(),
 R"pbdoc(
 Perform one iteration of Lloyd clustering on a distance graph
 
@@ -654,11 +932,17 @@ Perform one iteration of Lloyd clustering on a distance graph
      PhD thesis (UIUC), August 2008)pbdoc");
 
     m.def("lloyd_cluster_exact", &_lloyd_cluster_exact<int, int>,
-        py::arg("num_nodes"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("num_clusters"), py::arg("d").noconvert(), py::arg("cm").noconvert(), py::arg("c").noconvert());
+        py::arg("num_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("num_clusters"), py::arg("d").noconvert(), py::arg("cm").noconvert(), py::arg("c").noconvert());
     m.def("lloyd_cluster_exact", &_lloyd_cluster_exact<int, float>,
-        py::arg("num_nodes"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("num_clusters"), py::arg("d").noconvert(), py::arg("cm").noconvert(), py::arg("c").noconvert());
+        py::arg("num_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("num_clusters"), py::arg("d").noconvert(), py::arg("cm").noconvert(), py::arg("c").noconvert());
     m.def("lloyd_cluster_exact", &_lloyd_cluster_exact<int, double>,
-        py::arg("num_nodes"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("num_clusters"), py::arg("d").noconvert(), py::arg("cm").noconvert(), py::arg("c").noconvert(),
+        py::arg("num_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("num_clusters"), py::arg("d").noconvert(), py::arg("cm").noconvert(), py::arg("c").noconvert());
+    m.def("lloyd_cluster_exact", &_lloyd_cluster_exact<int64_t, int>,
+        py::arg("num_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("num_clusters"), py::arg("d").noconvert(), py::arg("cm").noconvert(), py::arg("c").noconvert());
+    m.def("lloyd_cluster_exact", &_lloyd_cluster_exact<int64_t, float>,
+        py::arg("num_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("num_clusters"), py::arg("d").noconvert(), py::arg("cm").noconvert(), py::arg("c").noconvert());
+    m.def("lloyd_cluster_exact", &_lloyd_cluster_exact<int64_t, double>,
+        py::arg("num_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("num_clusters"), py::arg("d").noconvert(), py::arg("cm").noconvert(), py::arg("c").noconvert(),
 R"pbdoc(
 Perform one iteration of Lloyd clustering on a distance graph using
 exact centers
@@ -683,7 +967,9 @@ nearly-equal-sized clusters.
      PhD thesis (UIUC), August 2008)pbdoc");
 
     m.def("maximal_independent_set_k_parallel", &_maximal_independent_set_k_parallel<int, int, double>,
-        py::arg("num_rows"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("k"), py::arg("x").noconvert(), py::arg("y").noconvert(), py::arg("max_iters"),
+        py::arg("num_rows"), py::arg("Ap"), py::arg("Aj"), py::arg("k"), py::arg("x").noconvert(), py::arg("y"), py::arg("max_iters"));
+    m.def("maximal_independent_set_k_parallel", &_maximal_independent_set_k_parallel<int64_t, int64_t, double>,
+        py::arg("num_rows"), py::arg("Ap"), py::arg("Aj"), py::arg("k"), py::arg("x").noconvert(), py::arg("y"), py::arg("max_iters"),
 R"pbdoc(
 Compute a distance-k maximal independent set for a graph stored
  in CSR format using a parallel algorithm.  An MIS-k is a set of
@@ -699,10 +985,17 @@ Compute a distance-k maximal independent set for a graph stored
      k          - minimum separation between MIS vertices
      x[]        - state of each vertex (1 if in the MIS, 0 otherwise)
      y[]        - random values used during parallel MIS algorithm
-     max_iters  - maximum number of iterations to use (default, no limit))pbdoc");
+     max_iters  - maximum number of iterations to use (default, no limit)
+
+ Notes:
+     Each propagation step is threaded with OpenMP, and reads only
+     the values of the previous step, so the result depends on y,
+     but not on the number of threads.)pbdoc");
 
     m.def("breadth_first_search", &_breadth_first_search<int>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("seed"), py::arg("order").noconvert(), py::arg("level").noconvert(),
+        py::arg("Ap"), py::arg("Aj"), py::arg("seed"), py::arg("order").noconvert(), py::arg("level").noconvert());
+    m.def("breadth_first_search", &_breadth_first_search<int64_t>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("seed"), py::arg("order").noconvert(), py::arg("level").noconvert(),
 R"pbdoc(
 Compute a breadth first search of a graph in CSR format
  beginning at a given seed vertex.
@@ -717,8 +1010,36 @@ Compute a breadth first search of a graph in CSR format
  Notes:
      The values of the level must be initialized to -1)pbdoc");
 
+    m.def("cuthill_mckee", &_cuthill_mckee<int>,
+        py::arg("num_rows"), py::arg("Ap"), py::arg("Aj"), py::arg("order").noconvert(), py::arg("level").noconvert());
+    m.def("cuthill_mckee", &_cuthill_mckee<int64_t>,
+        py::arg("num_rows"), py::arg("Ap"), py::arg("Aj"), py::arg("order").noconvert(), py::arg("level").noconvert(),
+R"pbdoc(
+Compute a Cuthill-McKee ordering of a graph in CSR format.
+
+ Each connected component is searched breadth first, as in
+ breadth_first_search, from a vertex of minimum degree, and the
+ unmarked neighbors of each vertex are added to the queue by
+ increasing degree, with ties broken by the vertex number.  The
+ reverse of order is the reverse Cuthill-McKee ordering, which reduces
+ the bandwidth of a matrix with this graph.
+
+ Parameters
+     num_rows         - number of rows in A (number of vertices)
+     Ap[]             - CSR row pointer
+     Aj[]             - CSR index array
+     order[num_rows]  - records the order in which vertices were searched
+     level[num_rows]  - records the level set of each vertex (i.e. the
+                        distance to the seed of its component)
+
+ Notes:
+     The values of the level must be initialized to -1
+     The graph must be symmetric)pbdoc");
+
     m.def("connected_components", &_connected_components<int>,
-        py::arg("num_nodes"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("components").noconvert(),
+        py::arg("num_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("components").noconvert());
+    m.def("connected_components", &_connected_components<int64_t>,
+        py::arg("num_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("components").noconvert(),
 R"pbdoc(
 Compute the connected components of a graph stored in CSR format.
 
@@ -4,14 +4,17 @@
 #include <pybind11/numpy.h>
 #include <pybind11/complex.h>
 
+#include "bind_arrays.h"
+#include "bind_threads.h"
+#include "bind_timers.h"
 #include "krylov.h"
 
 namespace py = pybind11;
 
 template<class I, class T, class F>
 void _apply_householders(
-       py::array_t<T> & z,
-       py::array_t<T> & B,
+      output_array<T> & z,
+       input_array<T> & B,
                 const I n,
             const I start,
              const I stop,
@@ -22,10 +25,16 @@ void _apply_householders(
     auto py_B = B.unchecked();
     T *_z = py_z.mutable_data();
     const T *_B = py_B.data();
+    int z_size = array_size(z.shape(0));
+    int B_size = array_size(B.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("apply_householders");
 
     return apply_householders<I, T, F>(
-                       _z, z.shape(0),
-                       _B, B.shape(0),
+                       _z, z_size,
+                       _B, B_size,
                         n,
                     start,
                      stop,
@@ -35,9 +44,9 @@ void _apply_householders(
 
 template<class I, class T, class F>
 void _householder_hornerscheme(
-       py::array_t<T> & z,
-       py::array_t<T> & B,
-       py::array_t<T> & y,
+      output_array<T> & z,
+       input_array<T> & B,
+       input_array<T> & y,
                 const I n,
             const I start,
              const I stop,
@@ -50,11 +59,18 @@ void _householder_hornerscheme(
     T *_z = py_z.mutable_data();
     const T *_B = py_B.data();
     const T *_y = py_y.data();
+    int z_size = array_size(z.shape(0));
+    int B_size = array_size(B.shape(0));
+    int y_size = array_size(y.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("householder_hornerscheme");
 
     return householder_hornerscheme<I, T, F>(
-                       _z, z.shape(0),
-                       _B, B.shape(0),
-                       _y, y.shape(0),
+                       _z, z_size,
+                       _B, B_size,
+                       _y, y_size,
                         n,
                     start,
                      stop,
@@ -64,8 +80,8 @@ void _householder_hornerscheme(
 
 template<class I, class T, class F>
 void _apply_givens(
-       py::array_t<T> & B,
-       py::array_t<T> & x,
+       input_array<T> & B,
+      output_array<T> & x,
                 const I n,
              const I nrot
                    )
@@ -74,10 +90,16 @@ void _apply_givens(
     auto py_x = x.mutable_unchecked();
     const T *_B = py_B.data();
     T *_x = py_x.mutable_data();
+    int B_size = array_size(B.shape(0));
+    int x_size = array_size(x.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("apply_givens");
 
     return apply_givens<I, T, F>(
-                       _B, B.shape(0),
-                       _x, x.shape(0),
+                       _B, B_size,
+                       _x, x_size,
                         n,
                      nrot
                                  );
@@ -97,14 +119,29 @@ PYBIND11_MODULE(krylov, m) {
     py::options options;
     options.disable_function_signatures();
 
+    share_num_threads();
+
+    m.def("_kernel_timers", &swap_kernel_timers, py::arg("enable"),
+R"pbdoc(
+Return and reset the kernel timers of the calling thread, and enable or
+disable them for subsequent calls, see bind_timers.h.)pbdoc");
+
     m.def("apply_householders", &_apply_householders<int, float, float>,
-        py::arg("z").noconvert(), py::arg("B").noconvert(), py::arg("n"), py::arg("start"), py::arg("stop"), py::arg("step"));
+        py::arg("z").noconvert(), py::arg("B"), py::arg("n"), py::arg("start"), py::arg("stop"), py::arg("step"));
     m.def("apply_householders", &_apply_householders<int, double, double>,
-        py::arg("z").noconvert(), py::arg("B").noconvert(), py::arg("n"), py::arg("start"), py::arg("stop"), py::arg("step"));
+        py::arg("z").noconvert(), py::arg("B"), py::arg("n"), py::arg("start"), py::arg("stop"), py::arg("step"));
     m.def("apply_householders", &_apply_householders<int, std::complex<float>, float>,
-        py::arg("z").noconvert(), py::arg("B").noconvert(), py::arg("n"), py::arg("start"), py::arg("stop"), py::arg("step"));
+        py::arg("z").noconvert(), py::arg("B"), py::arg("n"), py::arg("start"), py::arg("stop"), py::arg("step"));
     m.def("apply_householders", &_apply_householders<int, std::complex<double>, double>,
-        py::arg("z").noconvert(), py::arg("B").noconvert(), py::arg("n"), py::arg("start"), py::arg("stop"), py::arg("step"),
+        py::arg("z").noconvert(), py::arg("B"), py::arg("n"), py::arg("start"), py::arg("stop"), py::arg("step"));
+    m.def("apply_householders", &_apply_householders<int64_t, float, float>,
+        py::arg("z").noconvert(), py::arg("B"), py::arg("n"), py::arg("start"), py::arg("stop"), py::arg("step"));
+    m.def("apply_householders", &_apply_householders<int64_t, double, double>,
+        py::arg("z").noconvert(), py::arg("B"), py::arg("n"), py::arg("start"), py::arg("stop"), py::arg("step"));
+    m.def("apply_householders", &_apply_householders<int64_t, std::complex<float>, float>,
+        py::arg("z").noconvert(), py::arg("B"), py::arg("n"), py::arg("start"), py::arg("stop"), py::arg("step"));
+    m.def("apply_householders", &_apply_householders<int64_t, std::complex<double>, double>,
+        py::arg("z").noconvert(), py::arg("B"), py::arg("n"), py::arg("start"), py::arg("stop"), py::arg("step"),
 R"pbdoc(
 Apply |start-stop| Householder reflectors in B to z
 
@@ -135,13 +172,21 @@ Notes
 Principle calling routine is gmres(...) and fgmres(...) in krylov.py)pbdoc");
 
     m.def("householder_hornerscheme", &_householder_hornerscheme<int, float, float>,
-        py::arg("z").noconvert(), py::arg("B").noconvert(), py::arg("y").noconvert(), py::arg("n"), py::arg("start"), py::arg("stop"), py::arg("step"));
+        py::arg("z").noconvert(), py::arg("B"), py::arg("y"), py::arg("n"), py::arg("start"), py::arg("stop"), py::arg("step"));
     m.def("householder_hornerscheme", &_householder_hornerscheme<int, double, double>,
-        py::arg("z").noconvert(), py::arg("B").noconvert(), py::arg("y").noconvert(), py::arg("n"), py::arg("start"), py::arg("stop"), py::arg("step"));
+        py::arg("z").noconvert(), py::arg("B"), py::arg("y"), py::arg("n"), py::arg("start"), py::arg("stop"), py::arg("step"));
     m.def("householder_hornerscheme", &_householder_hornerscheme<int, std::complex<float>, float>,
-        py::arg("z").noconvert(), py::arg("B").noconvert(), py::arg("y").noconvert(), py::arg("n"), py::arg("start"), py::arg("stop"), py::arg("step"));
+        py::arg("z").noconvert(), py::arg("B"), py::arg("y"), py::arg("n"), py::arg("start"), py::arg("stop"), py::arg("step"));
     m.def("householder_hornerscheme", &_householder_hornerscheme<int, std::complex<double>, double>,
-        py::arg("z").noconvert(), py::arg("B").noconvert(), py::arg("y").noconvert(), py::arg("n"), py::arg("start"), py::arg("stop"), py::arg("step"),
+        py::arg("z").noconvert(), py::arg("B"), py::arg("y"), py::arg("n"), py::arg("start"), py::arg("stop"), py::arg("step"));
+    m.def("householder_hornerscheme", &_householder_hornerscheme<int64_t, float, float>,
+        py::arg("z").noconvert(), py::arg("B"), py::arg("y"), py::arg("n"), py::arg("start"), py::arg("stop"), py::arg("step"));
+    m.def("householder_hornerscheme", &_householder_hornerscheme<int64_t, double, double>,
+        py::arg("z").noconvert(), py::arg("B"), py::arg("y"), py::arg("n"), py::arg("start"), py::arg("stop"), py::arg("step"));
+    m.def("householder_hornerscheme", &_householder_hornerscheme<int64_t, std::complex<float>, float>,
+        py::arg("z").noconvert(), py::arg("B"), py::arg("y"), py::arg("n"), py::arg("start"), py::arg("stop"), py::arg("step"));
+    m.def("householder_hornerscheme", &_householder_hornerscheme<int64_t, std::complex<double>, double>,
+        py::arg("z").noconvert(), py::arg("B"), py::arg("y"), py::arg("n"), py::arg("start"), py::arg("stop"), py::arg("step"),
 R"pbdoc(
 For use after gmres is finished iterating and the least squares
 solution has been found.  This routine maps the solution back to
@@ -186,13 +231,21 @@ Principle calling routine is gmres(...) and fgmres(...) in krylov.py
 See pages 164-167 in Saad, "Iterative Methods for Sparse Linear Systems")pbdoc");
 
     m.def("apply_givens", &_apply_givens<int, float, float>,
-        py::arg("B").noconvert(), py::arg("x").noconvert(), py::arg("n"), py::arg("nrot"));
+        py::arg("B"), py::arg("x").noconvert(), py::arg("n"), py::arg("nrot"));
     m.def("apply_givens", &_apply_givens<int, double, double>,
-        py::arg("B").noconvert(), py::arg("x").noconvert(), py::arg("n"), py::arg("nrot"));
+        py::arg("B"), py::arg("x").noconvert(), py::arg("n"), py::arg("nrot"));
     m.def("apply_givens", &_apply_givens<int, std::complex<float>, float>,
-        py::arg("B").noconvert(), py::arg("x").noconvert(), py::arg("n"), py::arg("nrot"));
+        py::arg("B"), py::arg("x").noconvert(), py::arg("n"), py::arg("nrot"));
     m.def("apply_givens", &_apply_givens<int, std::complex<double>, double>,
-        py::arg("B").noconvert(), py::arg("x").noconvert(), py::arg("n"), py::arg("nrot"),
+        py::arg("B"), py::arg("x").noconvert(), py::arg("n"), py::arg("nrot"));
+    m.def("apply_givens", &_apply_givens<int64_t, float, float>,
+        py::arg("B"), py::arg("x").noconvert(), py::arg("n"), py::arg("nrot"));
+    m.def("apply_givens", &_apply_givens<int64_t, double, double>,
+        py::arg("B"), py::arg("x").noconvert(), py::arg("n"), py::arg("nrot"));
+    m.def("apply_givens", &_apply_givens<int64_t, std::complex<float>, float>,
+        py::arg("B"), py::arg("x").noconvert(), py::arg("n"), py::arg("nrot"));
+    m.def("apply_givens", &_apply_givens<int64_t, std::complex<double>, double>,
+        py::arg("B"), py::arg("x").noconvert(), py::arg("n"), py::arg("nrot"),
 R"pbdoc(
 Apply the first nrot Givens rotations in B to x
 
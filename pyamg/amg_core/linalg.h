@@ -5,6 +5,7 @@
 #include <limits>
 #include <complex>
 #include <iostream>
+#include <vector>
 
 /*******************************************************************
  * Overloaded routines for real arithmetic for int, float and double
@@ -128,6 +129,123 @@ inline std::complex<double> zero_imag(std::complex<double>& x)
  *      templated for pyamg's complex class, float and double
  *******************************************************************/
 
+/*
+ * Number of independent partial sums used by the vectorized reductions
+ * below.  Splitting a sum into lanes breaks the serial dependence on a
+ * single accumulator, so the compiler can map the lanes onto the SIMD
+ * registers of the target (SSE2/AVX/AVX-512/NEON) without -ffast-math.
+ */
+const int LINALG_LANES = 4;
+
+/*
+ * Sum of x[i]*y[i], i = 0, ..., n-1, for real x and y, accumulated in
+ * LINALG_LANES partial sums.  Note the result may differ from the serial
+ * sum in the last bits, as the additions are done in a different order.
+ */
+template<class I, class F>
+inline F dot_lanes(const F x[], const F y[], const I n)
+{
+    F s[LINALG_LANES] = {0.0};
+
+    const I nlanes = n - n % LINALG_LANES;
+    for(I i = 0; i < nlanes; i += LINALG_LANES){
+        for(int l = 0; l < LINALG_LANES; l++){
+            s[l] += x[i + l]*y[i + l];
+        }
+    }
+    for(I i = nlanes; i < n; i++){
+        s[0] += x[i]*y[i];
+    }
+
+    F sum = 0.0;
+    for(int l = 0; l < LINALG_LANES; l++){
+        sum += s[l];
+    }
+    return sum;
+}
+
+/*
+ * Sum of x[2i]*y[2i+1] - x[2i+1]*y[2i], i = 0, ..., n-1, i.e., the
+ * imaginary part of conjugate(x).T y for complex x and y viewed as
+ * interleaved (real, imag) pairs.
+ */
+template<class I, class F>
+inline F cross_lanes(const F x[], const F y[], const I n)
+{
+    F s[LINALG_LANES] = {0.0};
+
+    const I nlanes = n - n % LINALG_LANES;
+    for(I i = 0; i < nlanes; i += LINALG_LANES){
+        for(int l = 0; l < LINALG_LANES; l++){
+            const I k = 2*(i + l);
+            s[l] += x[k]*y[k + 1] - x[k + 1]*y[k];
+        }
+    }
+    for(I i = nlanes; i < n; i++){
+        s[0] += x[2*i]*y[2*i + 1] - x[2*i + 1]*y[2*i];
+    }
+
+    F sum = 0.0;
+    for(int l = 0; l < LINALG_LANES; l++){
+        sum += s[l];
+    }
+    return sum;
+}
+
+/*
+ * s += a*b, with the complex product written out in real arithmetic.
+ * This is the same as s += a*b with std::complex' operator*, which also
+ * computes the product in real arithmetic first, and only calls the
+ * inf/nan recovery if both parts of it are nan.  Here the recovery is
+ * a branch that is not taken for finite values, rather than a call that
+ * keeps the complex loops from being vectorized.
+ */
+template<class T>
+inline void mult_add(T& s, const T& a, const T& b)
+    { s += a*b; }
+template<class F>
+inline void mult_add(std::complex<F>& s, const std::complex<F>& a, const std::complex<F>& b)
+{
+    F re = a.real()*b.real() - a.imag()*b.imag();
+    F im = a.real()*b.imag() + a.imag()*b.real();
+    if (re != re && im != im) {
+        const std::complex<F> ab = a*b;
+        re = ab.real();
+        im = ab.imag();
+    }
+    s = std::complex<F>(s.real() + re, s.imag() + im);
+}
+
+/*
+ * Sum of Ax[jj]*v[Aj[jj]], jj = start, ..., end-1, i.e., the product of a
+ * row of a CSR matrix and v, accumulated in LINALG_LANES partial sums as
+ * in dot_lanes.  The gathers of v stay serial, but the products are added
+ * to independent accumulators.
+ */
+template<class I, class T>
+inline T csr_row_dot(const I Aj[], const T Ax[], const T v[],
+                     const I start, const I end)
+{
+    T s[LINALG_LANES] = {0.0};
+
+    const I nlanes = end - (end - start) % LINALG_LANES;
+    for(I jj = start; jj < nlanes; jj += LINALG_LANES){
+        for(int l = 0; l < LINALG_LANES; l++){
+            mult_add(s[l], Ax[jj + l], v[Aj[jj + l]]);
+        }
+    }
+    for(I jj = nlanes; jj < end; jj++){
+        mult_add(s[0], Ax[jj], v[Aj[jj]]);
+    }
+
+    T sum = 0.0;
+    for(int l = 0; l < LINALG_LANES; l++){
+        sum += s[l];
+    }
+    return sum;
+}
+
+
 /* dot(x, y, n)
  *
  * Parameters
@@ -143,9 +261,16 @@ inline std::complex<double> zero_imag(std::complex<double>& x)
  * ------
  * conjugate(x).T y
  *
+ * Notes
+ * -----
+ * For float, double and complex arrays, the overloads below accumulate in
+ * LINALG_LANES partial sums, with complex arrays treated as interleaved
+ * (real, imag) pairs, so the result may differ from dot_prod_ref, the
+ * serial sum, in the last bits.  Any other type uses dot_prod_ref.
+ *
  */
 template<class I, class T>
-inline T dot_prod(const T x[], const T y[], const I n)
+inline T dot_prod_ref(const T x[], const T y[], const I n)
 {
     T sum = 0.0;
     for( I i = 0; i < n; i++)
@@ -153,6 +278,24 @@ inline T dot_prod(const T x[], const T y[], const I n)
     return sum;
 }
 
+template<class I, class T>
+inline T dot_prod(const T x[], const T y[], const I n)
+    { return dot_prod_ref(x, y, n); }
+
+template<class I>
+inline float dot_prod(const float x[], const float y[], const I n)
+    { return dot_lanes(x, y, n); }
+template<class I>
+inline double dot_prod(const double x[], const double y[], const I n)
+    { return dot_lanes(x, y, n); }
+template<class I, class F>
+inline std::complex<F> dot_prod(const std::complex<F> x[], const std::complex<F> y[], const I n)
+{
+    const F * xr = reinterpret_cast<const F *>(x);
+    const F * yr = reinterpret_cast<const F *>(y);
+    return std::complex<F>(dot_lanes(xr, yr, 2*n), cross_lanes(xr, yr, n));
+}
+
 
 /* norm(x, n)
  *
@@ -169,13 +312,32 @@ inline T dot_prod(const T x[], const T y[], const I n)
  * ------
  * normx = sqrt( <x, x> )
  *
+ * Notes
+ * -----
+ * <x, x> is taken from dot_prod, or for complex x from the partial sums
+ * of its real part.  norm_ref takes it from dot_prod_ref.
+ *
  */
+template<class I, class T, class F>
+inline void norm_ref(const T x[], const I n, F &normx)
+{
+    normx = sqrt(real(dot_prod_ref(x,x,n)));
+}
+
 template<class I, class T, class F>
 inline void norm(const T x[], const I n, F &normx)
 {
     normx = sqrt(real(dot_prod(x,x,n)));
 }
 
+template<class I, class F>
+inline void norm(const std::complex<F> x[], const I n, F &normx)
+{
+    // <x, x> is real, so skip the imaginary part of dot_prod
+    const F * xr = reinterpret_cast<const F *>(x);
+    normx = sqrt(dot_lanes(xr, xr, 2*n));
+}
+
 
 /* axpy(x, y, alpha, n)
  *
@@ -193,14 +355,26 @@ inline void norm(const T x[], const I n, F &normx)
  * ------
  * x = x + alpha*y
  *
+ * Notes
+ * -----
+ * axpy_ref is the scalar reference, with std::complex' operator*.  Both
+ * give the same result.
+ *
  */
 template<class I, class T>
-inline void axpy(T x[], const T y[], const T alpha, const I n)
+inline void axpy_ref(T x[], const T y[], const T alpha, const I n)
 {
     for( I i = 0; i < n; i++)
     {   x[i] += alpha*y[i]; }
 }
 
+template<class I, class T>
+inline void axpy(T x[], const T y[], const T alpha, const I n)
+{
+    for( I i = 0; i < n; i++)
+    {   mult_add(x[i], alpha, y[i]); }
+}
+
 
 /* Transpose Ax by overwriting Bx
  *
@@ -305,6 +479,51 @@ inline void transpose(const T Ax[], T Bx[], const I m, const I n)
 }
 
 
+/*
+ * Sx[j*s_stride] += a.T Bx[:,j], j = 0, ..., Bcols-1, for a row a of
+ * length Brows, with Bx stored in column major.  Four columns of Bx are
+ * done at a time, so that each a[k] is loaded once for four independent
+ * accumulators held in registers.  Each entry of Sx is still summed
+ * over k = 0, ..., Brows-1 in order, as in the scalar triple loop.
+ */
+template<class I, class T>
+inline void gemm_row(const T a[], const T Bx[], const I Brows, const I Bcols,
+                     T Sx[], const I s_stride)
+{
+    I j = 0;
+    for(; j + 4 <= Bcols; j += 4)
+    {
+        const T * b0 = &(Bx[j*Brows]);
+        const T * b1 = b0 + Brows;
+        const T * b2 = b1 + Brows;
+        const T * b3 = b2 + Brows;
+        T s0 = Sx[j*s_stride];
+        T s1 = Sx[(j + 1)*s_stride];
+        T s2 = Sx[(j + 2)*s_stride];
+        T s3 = Sx[(j + 3)*s_stride];
+        for(I k = 0; k < Brows; k++)
+        {
+            mult_add(s0, a[k], b0[k]);
+            mult_add(s1, a[k], b1[k]);
+            mult_add(s2, a[k], b2[k]);
+            mult_add(s3, a[k], b3[k]);
+        }
+        Sx[j*s_stride] = s0;
+        Sx[(j + 1)*s_stride] = s1;
+        Sx[(j + 2)*s_stride] = s2;
+        Sx[(j + 3)*s_stride] = s3;
+    }
+    for(; j < Bcols; j++)
+    {
+        const T * b = &(Bx[j*Brows]);
+        T s = Sx[j*s_stride];
+        for(I k = 0; k < Brows; k++)
+        {   mult_add(s, a[k], b[k]); }
+        Sx[j*s_stride] = s;
+    }
+}
+
+
 /* Calculate Ax*Bx = S
  *
  * Parameters
@@ -351,11 +570,37 @@ inline void transpose(const T Ax[], T Bx[], const I m, const I n)
  *  Btrans = 'F' and Strans = 'T'
  *  Btrans = 'F' and Strans = 'F'
  *  Btrans = 'T' and Strans = 'F'
+ *  Btrans = 'T' and Strans = 'T'
  *
- *  All other combinations are not yet supported
- *
+ *  gemm_ref is the scalar reference, with the plain triple loops.  Each
+ *  entry of S is summed over the columns of A in the same order by both.
  *
  */
+template<class I, class T>
+inline void gemm_ref(const T Ax[], const I Arows, const I Acols, const char Atrans,
+          const T Bx[], const I Brows, const I Bcols, const char Btrans,
+          T Sx[], const I Srows, const I Scols, const char Strans,
+          const char overwrite)
+{
+    if(overwrite == 'T'){
+        std::fill(Sx, Sx + Srows*Scols,  0); }
+
+    for(I i = 0; i < Arows; i++)
+    {
+        for(I j = 0; j < Bcols; j++)
+        {
+            // S[i,j] in column or row major
+            T & s = (Strans == 'T') ? Sx[j*Srows + i] : Sx[i*Scols + j];
+            for(I k = 0; k < Acols; k++)
+            {
+                // B[k,j] in column or row major
+                const T b = (Btrans == 'T') ? Bx[k*Bcols + j] : Bx[j*Brows + k];
+                s += Ax[i*Acols + k]*b;
+            }
+        }
+    }
+}
+
 template<class I, class T>
 inline void gemm(const T Ax[], const I Arows, const I Acols, const char Atrans,
           const T Bx[], const I Brows, const I Bcols, const char Btrans,
@@ -372,76 +617,44 @@ inline void gemm(const T Ax[], const I Arows, const I Acols, const char Atrans,
     {
         // A is in row major, B is in column major, so compute
         // S(i,j) = A(i,:) B(:,j) by looping over the rows of A
-        // and the columns of B.
-
-        I s_counter = 0; I a_counter =0; I b_counter =0; I a_start = 0;
+        // and the columns of B, with S in column major.
         for(I i = 0; i < Arows; i++)
-        {
-            s_counter = i;
-            b_counter = 0;
-            for(I j = 0; j < Bcols; j++)
-            {
-                a_counter = a_start;                                // a_counter cycles through rows of A
-                for(I k = 0; k < Brows; k++)
-                {
-                    //S[i,j] += Ax[i,k]*B[k,j]
-                    Sx[s_counter] += Ax[a_counter]*Bx[b_counter];
-                    a_counter++; b_counter++;
-                }
-                s_counter+=Srows;
-            }
-            a_start += Acols;
-        }
+        {   gemm_row(&(Ax[i*Acols]), Bx, Brows, Bcols, &(Sx[i]), Srows); }
     }
     else if((Strans == 'F') && (Btrans == 'F'))
     {
         // A is in row major, B is in column major, so compute
         // S(i,j) = A(i,:) B(:,j) by looping over the rows of A
-        // and the columns of B.
-
-        I s_counter = 0; I a_counter =0; I b_counter =0; I a_start = 0;
+        // and the columns of B, with S in row major.
         for(I i = 0; i < Arows; i++)
-        {
-            b_counter = 0;
-            for(I j = 0; j < Bcols; j++)
-            {
-                a_counter = a_start;
-                for(I k = 0; k < Brows; k++)
-                {
-                    //S[i,j] += A[i,k]*B[k,j]
-                    Sx[s_counter] += Ax[a_counter]*Bx[b_counter];
-                    a_counter++; b_counter++;
-                }
-                s_counter++;
-            }
-            a_start += Acols;
-        }
+        {   gemm_row(&(Ax[i*Acols]), Bx, Brows, Bcols, &(Sx[i*Bcols]), (I) 1); }
     }
     else if((Strans == 'F') && (Btrans == 'T'))
     {
         // A is in row major, B is in row major, so compute
-        // S(i,j) = A(i,:) B(:,j) with the SMMP algorithm
-
-        I a_counter = 0;
+        // S(i,:) += A(i,j) B(j,:) with the SMMP algorithm, which
+        // keeps row i of S in cache for all j
 
         // Loop over rows of A
         for(I i = 0; i < Arows; i++)
         {
             // Loop over columns in row i of A
+            for(I j = 0; j < Acols; j++)
+            {   axpy(&(Sx[i*Scols]), &(Bx[j*Bcols]), Ax[i*Acols + j], Bcols); }
+        }
+    }
+    else if((Strans == 'T') && (Btrans == 'T'))
+    {
+        // A is in row major, B is in row major, so compute
+        // S(i,:) += A(i,j) B(j,:) as above, with S in column major
+        for(I i = 0; i < Arows; i++)
+        {
             for(I j = 0; j < Acols; j++)
             {
-                I s_counter = i*Scols;
-                I b_counter = j*Bcols;
-
-                // Loop over columns in row j of B
+                const T a = Ax[i*Acols + j];
+                const T * b = &(Bx[j*Bcols]);
                 for(I k = 0; k < Bcols; k++)
-                {
-                    // Accumulate A[i,j]*B[j,k] --> S[i,k]
-                    Sx[s_counter] += Ax[a_counter]*Bx[b_counter];
-                    b_counter++;
-                    s_counter++;
-                }
-                a_counter++;
+                {   mult_add(Sx[k*Srows + i], a, b[k]); }
             }
         }
     }
@@ -449,6 +662,50 @@ inline void gemm(const T Ax[], const I Arows, const I Acols, const char Atrans,
 }
 
 
+/*
+ * Dense block times vector, y = A*x, for a square block A stored in row
+ * major.  If BS is nonzero, it is the dimension of A, known at compile
+ * time, so that the loops can be unrolled.  Otherwise the dimension is
+ * given by blocksize.
+ *
+ * The same products are accumulated in the same order as with
+ *      gemm(A, n, n, 'F', x, n, 1, 'F', y, n, 1, 'F', 'T')
+ */
+template<int BS, class I, class T>
+inline void block_matvec(const T A[], const T x[], T y[], const I blocksize)
+{
+    const I n = (BS > 0) ? BS : blocksize;
+
+    for(I m = 0; m < n; m++){
+        T sum = 0.0;
+        for(I k = 0; k < n; k++){
+            mult_add(sum, A[m*n + k], x[k]);
+        }
+        y[m] = sum;
+    }
+}
+
+
+/*
+ * Work space of a dense block kernel, i.e., a vector of blocksize entries.
+ * If BS is nonzero, it is the blocksize, known at compile time, as for
+ * block_matvec, and the entries are on the stack.  Otherwise they are
+ * allocated on the heap.
+ */
+template<class T, int BS>
+class block_vector
+{
+    public:
+        block_vector(const int blocksize) : heap((BS > 0) ? 0 : blocksize) {}
+
+        T& operator[](const int k) { return (BS > 0) ? stack[k] : heap[k]; }
+
+    private:
+        T stack[(BS > 0) ? BS : 1];
+        std::vector<T> heap;
+};
+
+
 /*
  * Compute the SVD of a matrix, Ax, using the Jacobi method.
  * Compute Ax = U S V.H
@@ -542,7 +799,7 @@ I svd_jacobi (const T Ax[], T Tx[], T Bx[], F Sx[], const I m, const I n)
     I sweep = 0;
 
     // Always do at least  30 sweeps
-    I sweepmax = std::max(15*n, 30);
+    I sweepmax = std::max<I>(15*n, 30);
 
     F tolerance = sqrt((F)m)*std::numeric_limits<F>::epsilon();
 
@@ -820,7 +1077,7 @@ void svd_solve( T Ax[], I m, I n, T b[], F sing_vals[], T work[], I work_size)
 
     // A^{-1} b = V*Sinv*U.H*b, in 3 steps
     // Step 1, U.H*b
-    gemm(&(U[0]), n, m, trans, &(b[0]), m, 1, trans,
+    gemm<I, T>(&(U[0]), n, m, trans, &(b[0]), m, 1, trans,
          &(x[0]), n, 1, trans, 'T');
 
     // Step 2, scale x by Sinv
@@ -835,7 +1092,7 @@ void svd_solve( T Ax[], I m, I n, T b[], F sing_vals[], T work[], I work_size)
     // Step 3, multiply by V
     // transpose V so that it is in row major for gemm
     transpose(&(V[0]), &(U[0]), n, n);
-    gemm(&(U[0]), n, n, trans, &(x[0]), n, 1, trans,
+    gemm<I, T>(&(U[0]), n, n, trans, &(x[0]), n, 1, trans,
          &(b[0]), n, 1, trans, 'T');
 
     return;
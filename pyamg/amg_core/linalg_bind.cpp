@@ -4,13 +4,16 @@
 #include <pybind11/numpy.h>
 #include <pybind11/complex.h>
 
+#include "bind_arrays.h"
+#include "bind_threads.h"
+#include "bind_timers.h"
 #include "linalg.h"
 
 namespace py = pybind11;
 
 template<class I, class T, class F>
 void _pinv_array(
-      py::array_t<T> & AA,
+     output_array<T> & AA,
                 const I m,
                 const I n,
         const char TransA
@@ -18,9 +21,14 @@ void _pinv_array(
 {
     auto py_AA = AA.mutable_unchecked();
     T *_AA = py_AA.mutable_data();
+    int AA_size = array_size(AA.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("pinv_array");
 
     return pinv_array<I, T, F>(
-                      _AA, AA.shape(0),
+                      _AA, AA_size,
                         m,
                         n,
                    TransA
@@ -31,10 +39,10 @@ template <class I, class T>
 void _csc_scale_columns(
             const I n_row,
             const I n_col,
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
-      py::array_t<T> & Ax,
-      py::array_t<T> & Xx
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+     output_array<T> & Ax,
+      input_array<T> & Xx
                         )
 {
     auto py_Ap = Ap.unchecked();
@@ -45,14 +53,22 @@ void _csc_scale_columns(
     const I *_Aj = py_Aj.data();
     T *_Ax = py_Ax.mutable_data();
     const T *_Xx = py_Xx.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int Xx_size = array_size(Xx.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("csc_scale_columns");
 
     return csc_scale_columns <I, T>(
                     n_row,
                     n_col,
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
-                      _Ax, Ax.shape(0),
-                      _Xx, Xx.shape(0)
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                      _Xx, Xx_size
                                     );
 }
 
@@ -60,10 +76,10 @@ template <class I, class T>
 void _csc_scale_rows(
             const I n_row,
             const I n_col,
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
-      py::array_t<T> & Ax,
-      py::array_t<T> & Xx
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+     output_array<T> & Ax,
+      input_array<T> & Xx
                      )
 {
     auto py_Ap = Ap.unchecked();
@@ -74,14 +90,22 @@ void _csc_scale_rows(
     const I *_Aj = py_Aj.data();
     T *_Ax = py_Ax.mutable_data();
     const T *_Xx = py_Xx.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int Xx_size = array_size(Xx.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("csc_scale_rows");
 
     return csc_scale_rows <I, T>(
                     n_row,
                     n_col,
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
-                      _Ax, Ax.shape(0),
-                      _Xx, Xx.shape(0)
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                      _Xx, Xx_size
                                  );
 }
 
@@ -130,6 +154,13 @@ PYBIND11_MODULE(linalg, m) {
     py::options options;
     options.disable_function_signatures();
 
+    share_num_threads();
+
+    m.def("_kernel_timers", &swap_kernel_timers, py::arg("enable"),
+R"pbdoc(
+Return and reset the kernel timers of the calling thread, and enable or
+disable them for subsequent calls, see bind_timers.h.)pbdoc");
+
     m.def("pinv_array", &_pinv_array<int, float, float>,
         py::arg("AA").noconvert(), py::arg("m"), py::arg("n"), py::arg("TransA"));
     m.def("pinv_array", &_pinv_array<int, double, double>,
@@ -137,6 +168,14 @@ PYBIND11_MODULE(linalg, m) {
     m.def("pinv_array", &_pinv_array<int, std::complex<float>, float>,
         py::arg("AA").noconvert(), py::arg("m"), py::arg("n"), py::arg("TransA"));
     m.def("pinv_array", &_pinv_array<int, std::complex<double>, double>,
+        py::arg("AA").noconvert(), py::arg("m"), py::arg("n"), py::arg("TransA"));
+    m.def("pinv_array", &_pinv_array<int64_t, float, float>,
+        py::arg("AA").noconvert(), py::arg("m"), py::arg("n"), py::arg("TransA"));
+    m.def("pinv_array", &_pinv_array<int64_t, double, double>,
+        py::arg("AA").noconvert(), py::arg("m"), py::arg("n"), py::arg("TransA"));
+    m.def("pinv_array", &_pinv_array<int64_t, std::complex<float>, float>,
+        py::arg("AA").noconvert(), py::arg("m"), py::arg("n"), py::arg("TransA"));
+    m.def("pinv_array", &_pinv_array<int64_t, std::complex<double>, double>,
         py::arg("AA").noconvert(), py::arg("m"), py::arg("n"), py::arg("TransA"),
 R"pbdoc(
 Replace each block of A with a Moore-Penrose pseudoinverse of that block.
@@ -183,11 +222,17 @@ Examples
 >>> print "A holds the inverse of the transpose\n" + str(dot(A[0], Ac[0].T)))pbdoc");
 
     m.def("csc_scale_columns", &_csc_scale_columns<int, int>,
-        py::arg("n_row"), py::arg("n_col"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("Xx").noconvert());
+        py::arg("n_row"), py::arg("n_col"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax").noconvert(), py::arg("Xx"));
     m.def("csc_scale_columns", &_csc_scale_columns<int, float>,
-        py::arg("n_row"), py::arg("n_col"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("Xx").noconvert());
+        py::arg("n_row"), py::arg("n_col"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax").noconvert(), py::arg("Xx"));
     m.def("csc_scale_columns", &_csc_scale_columns<int, double>,
-        py::arg("n_row"), py::arg("n_col"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("Xx").noconvert(),
+        py::arg("n_row"), py::arg("n_col"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax").noconvert(), py::arg("Xx"));
+    m.def("csc_scale_columns", &_csc_scale_columns<int64_t, int>,
+        py::arg("n_row"), py::arg("n_col"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax").noconvert(), py::arg("Xx"));
+    m.def("csc_scale_columns", &_csc_scale_columns<int64_t, float>,
+        py::arg("n_row"), py::arg("n_col"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax").noconvert(), py::arg("Xx"));
+    m.def("csc_scale_columns", &_csc_scale_columns<int64_t, double>,
+        py::arg("n_row"), py::arg("n_col"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax").noconvert(), py::arg("Xx"),
 R"pbdoc(
 Scale the columns of a CSC matrix *in place*
 
@@ -197,11 +242,17 @@ See:
 https://github.com/scipy/scipy/blob/master/scipy/sparse/sparsetools/csr.h)pbdoc");
 
     m.def("csc_scale_rows", &_csc_scale_rows<int, int>,
-        py::arg("n_row"), py::arg("n_col"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("Xx").noconvert());
+        py::arg("n_row"), py::arg("n_col"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax").noconvert(), py::arg("Xx"));
     m.def("csc_scale_rows", &_csc_scale_rows<int, float>,
-        py::arg("n_row"), py::arg("n_col"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("Xx").noconvert());
+        py::arg("n_row"), py::arg("n_col"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax").noconvert(), py::arg("Xx"));
     m.def("csc_scale_rows", &_csc_scale_rows<int, double>,
-        py::arg("n_row"), py::arg("n_col"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("Xx").noconvert(),
+        py::arg("n_row"), py::arg("n_col"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax").noconvert(), py::arg("Xx"));
+    m.def("csc_scale_rows", &_csc_scale_rows<int64_t, int>,
+        py::arg("n_row"), py::arg("n_col"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax").noconvert(), py::arg("Xx"));
+    m.def("csc_scale_rows", &_csc_scale_rows<int64_t, float>,
+        py::arg("n_row"), py::arg("n_col"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax").noconvert(), py::arg("Xx"));
+    m.def("csc_scale_rows", &_csc_scale_rows<int64_t, double>,
+        py::arg("n_row"), py::arg("n_col"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax").noconvert(), py::arg("Xx"),
 R"pbdoc(
 Scale the rows of a CSC matrix *in place*
 
@@ -0,0 +1,157 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/*
+ *  Number of threads set by set_num_threads, or 0 if it is not set.
+ *
+ *  The setting is process wide.  Each amg_core module points it at the
+ *  same atomic when it is imported, see bind_threads.h, so that the
+ *  setting applies to the kernels of all modules, called from any thread.
+ *
+ */
+inline std::atomic<int> * & num_threads_setting()
+{
+    static std::atomic<int> setting(0);
+    static std::atomic<int> * shared = &setting;
+    return shared;
+}
+
+
+/*
+ *  Set the number of threads used by the threaded kernels in amg_core
+ *
+ *  Parameters
+ *      num_threads  - number of threads for subsequent parallel regions,
+ *                     values < 1 leave the number of threads unchanged
+ *
+ *  Returns:
+ *      The number of threads used by subsequent parallel regions.  This
+ *      is always 1 if amg_core is compiled without OpenMP.
+ *
+ *  Notes:
+ *      The setting is process wide: it applies to all of the amg_core
+ *      modules, and to the kernels called from any thread, e.g. the
+ *      solves in a thread pool.  Until it is set, the kernels use the
+ *      OpenMP default of the calling thread, i.e. OMP_NUM_THREADS.  Use
+ *      set_num_threads(0) to query the current number of threads.
+ *
+ *      OpenMP keeps its number of threads per thread, so the bindings
+ *      apply the setting on entry to each kernel, see bind_threads.h.
+ *
+ */
+template<class I>
+I set_num_threads(const I num_threads)
+{
+#ifdef _OPENMP
+    if (num_threads > 0){
+        num_threads_setting()->store((int) num_threads);
+    }
+    const int setting = num_threads_setting()->load();
+    return (setting > 0) ? setting : omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+
+/*
+ *  Number of the calling thread in the current parallel region, used to
+ *  select per-thread scratch space.  This is 0 outside of a parallel
+ *  region, or if amg_core is compiled without OpenMP.
+ *
+ */
+template<class I>
+inline I thread_num()
+{
+#ifdef _OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+
+/*
+ *  Number of iterations of the loop
+ *
+ *      for(I i = start; i != stop; i += step)
+ *
+ *  used to map row_start, row_stop, and row_step onto a counted loop
+ *  that OpenMP can split across threads.
+ *
+ */
+template<class I>
+inline I sweep_length(const I start, const I stop, const I step)
+{
+    if (step > 0 && stop > start){
+        return (stop - start + step - 1)/step;
+    }
+    else if (step < 0 && stop < start){
+        return (start - stop - step - 1)/(-step);
+    }
+    return 0;
+}
+
+
+/*
+ *  Replace x[0], ..., x[n-1] by their cumulative sum, i.e.
+ *
+ *      x[i] = x[0] + x[1] + ... + x[i]
+ *
+ *  Used to turn the per-row counts of a CSR matrix into its row pointer
+ *  when the rows are filled in parallel.  Each thread sums a contiguous
+ *  chunk, and then adds the total of the preceding chunks.
+ *
+ */
+template<class I>
+void cumulative_sum(I x[], const I n)
+{
+#ifdef _OPENMP
+    std::vector<I> offsets;
+
+    #pragma omp parallel
+    {
+        const I num_threads = omp_get_num_threads();
+        const I thread_num  = omp_get_thread_num();
+
+        #pragma omp single
+        offsets.assign(num_threads + 1, 0);
+
+        const I chunk = (n + num_threads - 1)/num_threads;
+        const I start = std::min(thread_num*chunk, n);
+        const I stop  = std::min(start + chunk, n);
+
+        I sum = 0;
+        for(I i = start; i < stop; i++){
+            sum += x[i];
+            x[i] = sum;
+        }
+        offsets[thread_num + 1] = sum;
+
+        #pragma omp barrier
+        #pragma omp single
+        for(I t = 0; t < num_threads; t++){
+            offsets[t + 1] += offsets[t];
+        }
+
+        const I offset = offsets[thread_num];
+        for(I i = start; i < stop; i++){
+            x[i] += offset;
+        }
+    }
+#else
+    for(I i = 1; i < n; i++){
+        x[i] += x[i - 1];
+    }
+#endif
+}
+
+#endif
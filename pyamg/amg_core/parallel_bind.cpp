@@ -0,0 +1,73 @@
+// DO NOT EDIT: this file is generated
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/complex.h>
+
+#include "bind_arrays.h"
+#include "bind_threads.h"
+#include "bind_timers.h"
+#include "parallel.h"
+
+namespace py = pybind11;
+
+template<class I>
+I _set_num_threads(
+      const I num_threads
+                   )
+{
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("set_num_threads");
+
+    return set_num_threads<I>(
+              num_threads
+                              );
+}
+
+PYBIND11_MODULE(parallel, m) {
+    m.doc() = R"pbdoc(
+    Pybind11 bindings for parallel.h
+
+    Methods
+    -------
+    set_num_threads
+    )pbdoc";
+
+    py::options options;
+    options.disable_function_signatures();
+
+    share_num_threads();
+
+    m.def("_kernel_timers", &swap_kernel_timers, py::arg("enable"),
+R"pbdoc(
+Return and reset the kernel timers of the calling thread, and enable or
+disable them for subsequent calls, see bind_timers.h.)pbdoc");
+
+    m.def("set_num_threads", &_set_num_threads<int>,
+        py::arg("num_threads"));
+    m.def("set_num_threads", &_set_num_threads<int64_t>,
+        py::arg("num_threads"),
+R"pbdoc(
+Set the number of threads used by the threaded kernels in amg_core
+
+ Parameters
+     num_threads  - number of threads for subsequent parallel regions,
+                    values < 1 leave the number of threads unchanged
+
+ Returns:
+     The number of threads used by subsequent parallel regions.  This
+     is always 1 if amg_core is compiled without OpenMP.
+
+ Notes:
+     The setting is process wide: it applies to all of the amg_core
+     modules, and to the kernels called from any thread, e.g. the
+     solves in a thread pool.  Until it is set, the kernels use the
+     OpenMP default of the calling thread, i.e. OMP_NUM_THREADS.  Use
+     set_num_threads(0) to query the current number of threads.
+
+     OpenMP keeps its number of threads per thread, so the bindings
+     apply the setting on entry to each kernel, see bind_threads.h.)pbdoc");
+
+}
+
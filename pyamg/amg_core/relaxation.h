@@ -1,7 +1,11 @@
 #ifndef RELAXATION_H
 #define RELAXATION_H
 
+#include <algorithm>
+#include <vector>
+
 #include "linalg.h"
+#include "parallel.h"
 
 /*
  *  Perform one iteration of Gauss-Seidel relaxation on the linear
@@ -62,43 +66,30 @@ void gauss_seidel(const I Ap[], const int Ap_size,
 
 
 /*
- *  Perform one iteration of Gauss-Seidel relaxation on the linear
- *  system Ax = b, where A is stored in Block CSR format and x and b
- *  are column vectors.  This method applies point-wise relaxation
- *  to the BSR as opposed to \"block relaxation\".
- *
- *  Refer to gauss_seidel for additional information regarding
- *  row_start, row_stop, and row_step.
- *
- *  Parameters
- *      Ap[]       - BSR row pointer
- *      Aj[]       - BSR index array
- *      Ax[]       - BSR data array
- *      x[]        - approximate solution
- *      b[]        - right hand side
- *      row_start  - beginning of the sweep (block row index)
- *      row_stop   - end of the sweep (i.e. one past the last unknown)
- *      row_step   - stride used during the sweep (may be negative)
- *      blocksize  - BSR blocksize (blocks must be square)
- *
- *  Returns:
- *      Nothing, x will be modified in place
+ *  Implementation of bsr_gauss_seidel, see below.  If BS is nonzero,
+ *  it is the blocksize, known at compile time so that the dense block
+ *  operations are unrolled.  Otherwise the blocksize is given at run
+ *  time by blocksize_.  bsr_gauss_seidel dispatches the blocksizes
+ *  of instantiate.yml to the compile-time versions, and the others to
+ *  BS = 0.  This dispatch is generated by bindthem.py in
+ *  relaxation_dispatch.h, for each function of the blocksizes entry.
  *
  */
-template<class I, class T, class F>
-void bsr_gauss_seidel(const I Ap[], const int Ap_size,
-                      const I Aj[], const int Aj_size,
-                      const T Ax[], const int Ax_size,
-                            T  x[], const int  x_size,
-                      const T  b[], const int  b_size,
-                      const I row_start,
-                      const I row_stop,
-                      const I row_step,
-                      const I blocksize)
+template<class I, class T, class F, int BS>
+void bsr_gauss_seidel_impl(const I Ap[], const int Ap_size,
+                           const I Aj[], const int Aj_size,
+                           const T Ax[], const int Ax_size,
+                                 T  x[], const int  x_size,
+                           const T  b[], const int  b_size,
+                           const I row_start,
+                           const I row_stop,
+                           const I row_step,
+                           const I blocksize_)
 {
+    const I blocksize = (BS > 0) ? BS : blocksize_;
     I B2 = blocksize*blocksize;
-    T *rsum = new T[blocksize];
-    T *Axloc = new T[blocksize];
+    block_vector<T, BS> rsum(blocksize);
+    block_vector<T, BS> Axloc(blocksize);
     //T zero = 0.0;
 
     // Determine if this is a forward, or backward sweep
@@ -135,10 +126,7 @@ void bsr_gauss_seidel(const I Ap[], const int Ap_size,
                 diag_ptr = jj*B2; }
             else {
                 // do a dense multiply of this block times x and accumulate in rsum
-                gemm(&(Ax[jj*B2]),  blocksize, blocksize, 'F',
-                     &(x[col]),     blocksize,   1,       'F',
-                     &(Axloc[0]),   blocksize,   1,       'F',
-                     'T');
+                block_matvec<BS>(&(Ax[jj*B2]), &(x[col]), &(Axloc[0]), blocksize);
                 for(I m = 0; m < blocksize; m++) {
                     rsum[m] -= Axloc[m]; }
             }
@@ -163,12 +151,234 @@ void bsr_gauss_seidel(const I Ap[], const int Ap_size,
         }
 
     } // end outer-most for loop
-
-    delete[] rsum;
-    delete[] Axloc;
 }// end function
 
 
+/*
+ *  Perform one iteration of Gauss-Seidel relaxation on the linear
+ *  system Ax = b, where A is stored in Block CSR format and x and b
+ *  are column vectors.  This method applies point-wise relaxation
+ *  to the BSR as opposed to \"block relaxation\".
+ *
+ *  Refer to gauss_seidel for additional information regarding
+ *  row_start, row_stop, and row_step.
+ *
+ *  Parameters
+ *      Ap[]       - BSR row pointer
+ *      Aj[]       - BSR index array
+ *      Ax[]       - BSR data array
+ *      x[]        - approximate solution
+ *      b[]        - right hand side
+ *      row_start  - beginning of the sweep (block row index)
+ *      row_stop   - end of the sweep (i.e. one past the last unknown)
+ *      row_step   - stride used during the sweep (may be negative)
+ *      blocksize  - BSR blocksize (blocks must be square)
+ *
+ *  Returns:
+ *      Nothing, x will be modified in place
+ *
+ */
+template<class I, class T, class F>
+void bsr_gauss_seidel(const I Ap[], const int Ap_size,
+                      const I Aj[], const int Aj_size,
+                      const T Ax[], const int Ax_size,
+                            T  x[], const int  x_size,
+                      const T  b[], const int  b_size,
+                      const I row_start,
+                      const I row_stop,
+                      const I row_step,
+                      const I blocksize);
+
+
+/*
+ *  Perform one iteration of multicolor Gauss-Seidel relaxation on the
+ *  linear system Ax = b, where A is stored in CSR format and x and b
+ *  are column vectors.
+ *
+ *  The rows are grouped by color, so that no two rows of the same
+ *  color are coupled in A.  The colors are swept through according
+ *  to the slice defined by color_start, color_stop, and color_step,
+ *  and all rows of one color are relaxed simultaneously (in parallel
+ *  when compiled with OpenMP).  The rows of color c are
+ *
+ *      color_rows[color_ptr[c]], ..., color_rows[color_ptr[c+1]-1]
+ *
+ *  Parameters
+ *      Ap[]          - CSR row pointer
+ *      Aj[]          - CSR index array
+ *      Ax[]          - CSR data array
+ *      x[]           - approximate solution
+ *      b[]           - right hand side
+ *      color_ptr[]   - pointer into color_rows for each color
+ *      color_rows[]  - rows of A, grouped by color
+ *      color_start   - first color of the sweep
+ *      color_stop    - end of the sweep (i.e. one past the last color)
+ *      color_step    - stride used during the sweep (may be negative)
+ *
+ *  Returns:
+ *      Nothing, x will be modified in place
+ *
+ *  Notes:
+ *      A coloring is computed once with vertex_coloring_mis or
+ *      vertex_coloring_jones_plassmann on the graph of A + A^T
+ *
+ */
+template<class I, class T, class F>
+void gauss_seidel_multicolor(const I Ap[], const int Ap_size,
+                             const I Aj[], const int Aj_size,
+                             const T Ax[], const int Ax_size,
+                                   T  x[], const int  x_size,
+                             const T  b[], const int  b_size,
+                             const I color_ptr[], const int color_ptr_size,
+                             const I color_rows[], const int color_rows_size,
+                             const I color_start,
+                             const I color_stop,
+                             const I color_step)
+{
+    for(I c = color_start; c != color_stop; c += color_step) {
+        const I color_begin = color_ptr[c];
+        const I color_end   = color_ptr[c+1];
+
+        #pragma omp parallel for schedule(static)
+        for(I ii = color_begin; ii < color_end; ii++) {
+            const I i = color_rows[ii];
+            const I start = Ap[i];
+            const I end   = Ap[i+1];
+            T rsum = 0;
+            T diag = 0;
+
+            for(I jj = start; jj < end; jj++){
+                const I j = Aj[jj];
+                if (i == j)
+                    diag  = Ax[jj];
+                else
+                    rsum += Ax[jj]*x[j];
+            }
+
+            if (diag != (F) 0.0){
+                x[i] = (b[i] - rsum)/diag;
+            }
+        }
+    }
+}
+
+
+/*
+ *  Implementation of bsr_gauss_seidel_multicolor, with the blocksize BS
+ *  as for bsr_gauss_seidel_impl.
+ *
+ */
+template<class I, class T, class F, int BS>
+void bsr_gauss_seidel_multicolor_impl(const I Ap[], const int Ap_size,
+                                      const I Aj[], const int Aj_size,
+                                      const T Ax[], const int Ax_size,
+                                            T  x[], const int  x_size,
+                                      const T  b[], const int  b_size,
+                                      const I color_ptr[], const int color_ptr_size,
+                                      const I color_rows[], const int color_rows_size,
+                                      const I color_start,
+                                      const I color_stop,
+                                      const I color_step,
+                                      const I blocksize_)
+{
+    const I blocksize = (BS > 0) ? BS : blocksize_;
+    const I B2 = blocksize*blocksize;
+
+    #pragma omp parallel
+    {
+        // thread-local work space, for all colors
+        block_vector<T, BS> rsum(blocksize);
+        block_vector<T, BS> Axloc(blocksize);
+
+        for(I c = color_start; c != color_stop; c += color_step) {
+            const I color_begin = color_ptr[c];
+            const I color_end   = color_ptr[c+1];
+
+            // the implicit barrier completes each color before the next
+            #pragma omp for schedule(static)
+            for(I ii = color_begin; ii < color_end; ii++) {
+                const I i = color_rows[ii];
+                const I start = Ap[i];
+                const I end   = Ap[i+1];
+                I diag_ptr = -1;
+
+                // initialize rsum to b, then later subtract A*x
+                for(I k = 0; k < blocksize; k++) {
+                    rsum[k] = b[i*blocksize+k]; }
+
+                // loop over row i
+                for(I jj = start; jj < end; jj++){
+                    const I j = Aj[jj];
+                    if (i == j){    //point to where in Ax the diagonal block starts
+                        diag_ptr = jj*B2; }
+                    else {
+                        block_matvec<BS>(&(Ax[jj*B2]), &(x[j*blocksize]), &(Axloc[0]), blocksize);
+                        for(I m = 0; m < blocksize; m++) {
+                            rsum[m] -= Axloc[m]; }
+                    }
+                }
+
+                // Carry out point-wise GS over the diagonal block
+                if (diag_ptr != -1) {
+                    for(I k = 0; k < blocksize; k++){
+                        T diag = 1.0;
+                        for(I kk = 0; kk < blocksize; kk++){
+                            if(k == kk){
+                                diag = Ax[k*blocksize + kk + diag_ptr]; }
+                            else{
+                                rsum[k] -= Ax[k*blocksize + kk + diag_ptr]*x[i*blocksize+kk]; }
+                        }
+                        if (diag != (F) 0.0){
+                            x[i*blocksize+k] = rsum[k]/diag; }
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+/*
+ *  Perform one iteration of multicolor Gauss-Seidel relaxation on the
+ *  linear system Ax = b, where A is stored in Block CSR format and x
+ *  and b are column vectors.  As in bsr_gauss_seidel, point-wise
+ *  relaxation is applied within each diagonal block.
+ *
+ *  Refer to gauss_seidel_multicolor for additional information
+ *  regarding color_ptr, color_rows, color_start, color_stop, and
+ *  color_step.  Here, the coloring is of the block rows of A.
+ *
+ *  Parameters
+ *      Ap[]          - BSR row pointer
+ *      Aj[]          - BSR index array
+ *      Ax[]          - BSR data array
+ *      x[]           - approximate solution
+ *      b[]           - right hand side
+ *      color_ptr[]   - pointer into color_rows for each color
+ *      color_rows[]  - block rows of A, grouped by color
+ *      color_start   - first color of the sweep
+ *      color_stop    - end of the sweep (i.e. one past the last color)
+ *      color_step    - stride used during the sweep (may be negative)
+ *      blocksize     - BSR blocksize (blocks must be square)
+ *
+ *  Returns:
+ *      Nothing, x will be modified in place
+ *
+ */
+template<class I, class T, class F>
+void bsr_gauss_seidel_multicolor(const I Ap[], const int Ap_size,
+                                 const I Aj[], const int Aj_size,
+                                 const T Ax[], const int Ax_size,
+                                       T  x[], const int  x_size,
+                                 const T  b[], const int  b_size,
+                                 const I color_ptr[], const int color_ptr_size,
+                                 const I color_rows[], const int color_rows_size,
+                                 const I color_start,
+                                 const I color_stop,
+                                 const I color_step,
+                                 const I blocksize);
+
+
 /*
  *  Perform one iteration of Jacobi relaxation on the linear
  *  system Ax = b, where A is stored in CSR format and x and b
@@ -208,31 +418,142 @@ void jacobi(const I Ap[], const int Ap_size,
 {
     T one = 1.0;
     T omega2 = omega[0];
+    const I num_rows = sweep_length(row_start, row_stop, row_step);
 
-    for(I i = row_start; i != row_stop; i += row_step) {
-        temp[i] = x[i];
-    }
+    #pragma omp parallel
+    {
+        #pragma omp for schedule(static)
+        for(I k = 0; k < num_rows; k++) {
+            const I i = row_start + k*row_step;
+            temp[i] = x[i];
+        }
 
-    for(I i = row_start; i != row_stop; i += row_step) {
-        I start = Ap[i];
-        I end   = Ap[i+1];
-        T rsum = 0;
-        T diag = 0;
+        // the implicit barrier above completes temp before it is read
+        #pragma omp for schedule(static)
+        for(I k = 0; k < num_rows; k++) {
+            const I i = row_start + k*row_step;
+            I start = Ap[i];
+            I end   = Ap[i+1];
+            T rsum = 0;
+            T diag = 0;
 
-        for(I jj = start; jj < end; jj++){
-            I j = Aj[jj];
-            if (i == j)
-                diag  = Ax[jj];
-            else
-                rsum += Ax[jj]*temp[j];
-        }
+            for(I jj = start; jj < end; jj++){
+                I j = Aj[jj];
+                if (i == j)
+                    diag  = Ax[jj];
+                else
+                    rsum += Ax[jj]*temp[j];
+            }
 
-        if (diag != (F) 0.0){
-            x[i] = (one - omega2) * temp[i] + omega2 * ((b[i] - rsum)/diag);
+            if (diag != (F) 0.0){
+                x[i] = (one - omega2) * temp[i] + omega2 * ((b[i] - rsum)/diag);
+            }
         }
     }
 }
 
+/*
+ *  Implementation of bsr_jacobi, with the blocksize BS as for
+ *  bsr_gauss_seidel_impl.
+ *
+ */
+template<class I, class T, class F, int BS>
+void bsr_jacobi_impl(const I Ap[], const int Ap_size,
+                     const I Aj[], const int Aj_size,
+                     const T Ax[], const int Ax_size,
+                           T  x[], const int  x_size,
+                     const T  b[], const int  b_size,
+                           T temp[], const int temp_size,
+                     const I row_start,
+                     const I row_stop,
+                     const I row_step,
+                     const I blocksize_,
+                     const T omega[], const int omega_size)
+{
+    const I blocksize = (BS > 0) ? BS : blocksize_;
+    const I B2 = blocksize*blocksize;
+    const T one = 1.0;
+    const T omega2 = omega[0];
+    const I num_rows = sweep_length(row_start, row_stop, row_step);
+    const I num_copy = abs(row_stop-row_start)*blocksize;
+
+    // Determine if this is a forward, or backward sweep
+    I step, step_start, step_end;
+    if (row_step < 0){
+        step = -1;
+        step_start = blocksize-1;
+        step_end = -1;
+    }
+    else{
+        step = 1;
+        step_start = 0;
+        step_end = blocksize;
+    }
+
+    #pragma omp parallel
+    {
+        // thread-local work space
+        block_vector<T, BS> rsum(blocksize);
+        block_vector<T, BS> Axloc(blocksize);
+
+        // copy x to temp
+        #pragma omp for schedule(static)
+        for(I i = 0; i < num_copy; i++) {
+            temp[i] = x[i];
+        }
+
+        // the implicit barrier above completes temp before it is read
+        #pragma omp for schedule(static)
+        for(I n = 0; n < num_rows; n++) {
+            const I i = row_start + n*row_step;
+            I start = Ap[i];
+            I end   = Ap[i+1];
+            I diag_ptr = -1;
+
+            // initialize rsum to b, then later subtract A*x
+            for(I k = 0; k < blocksize; k++) {
+                rsum[k] = b[i*blocksize+k]; }
+
+            // loop over row i
+            for(I jj = start; jj < end; jj++){
+                // extract column entry
+                I j = Aj[jj];
+                // absolute column entry for the start of this block
+                I col = j*blocksize;
+
+                if (i == j){    //point to where in Ax the diagonal block starts
+                    diag_ptr = jj*B2; }
+                else {
+                    // do a dense multiply of this block times x and accumulate in rsum
+                    block_matvec<BS>(&(Ax[jj*B2]), &(temp[col]), &(Axloc[0]), blocksize);
+                    for(I m = 0; m < blocksize; m++) {
+                        rsum[m] -= Axloc[m]; }
+                }
+            }
+
+            // Carry out point-wise jacobi over the diagonal block,
+            // all the other blocks have been factored into rsum.
+            if (diag_ptr != -1) {
+                for(I k = step_start; k != step_end; k+=step){
+                    T diag = 1.0;
+                    for(I kk = step_start; kk != step_end; kk+=step){
+                        if(k == kk){
+                            // diagonal entry
+                            diag = Ax[k*blocksize + kk + diag_ptr]; }
+                        else{
+                            // off-diag entry
+                            rsum[k] -= Ax[k*blocksize + kk + diag_ptr]*temp[i*blocksize+kk]; }
+                    }
+                    if (diag != (F) 0.0){
+                        x[i*blocksize+k] = (one - omega2) * temp[i*blocksize+k] + omega2 * rsum[k]/diag; }
+                }
+            }
+
+        } // end outer-most for loop
+    }
+}// end function
+
+
 /*
  *  Perform one iteration of Jacobi relaxation on the linear
  *  system Ax = b, where A is stored in Block CSR format and x and b
@@ -270,86 +591,235 @@ void bsr_jacobi(const I Ap[], const int Ap_size,
                 const I row_stop,
                 const I row_step,
                 const I blocksize,
-                const T omega[], const int omega_size)
-{
-    I B2 = blocksize*blocksize;
-    T *rsum = new T[blocksize];
-    T *Axloc = new T[blocksize];
-    //T zero = 0.0;
-    T one = 1.0;
-    T omega2 = omega[0];
-
-    // Determine if this is a forward, or backward sweep
-    I step, step_start, step_end;
-    if (row_step < 0){
-        step = -1;
-        step_start = blocksize-1;
-        step_end = -1;
-    }
-    else{
-        step = 1;
-        step_start = 0;
-        step_end = blocksize;
-    }
+                const T omega[], const int omega_size);
 
-    // copy x to temp
-    for(I i = 0; i < abs(row_stop-row_start)*blocksize; i += step) {
-        temp[i] = x[i];
-    }
 
-    for(I i = row_start; i != row_stop; i += row_step) {
-        I start = Ap[i];
-        I end   = Ap[i+1];
-        I diag_ptr = -1;
+/*
+ *  Perform one iteration of polynomial smoothing on the linear system
+ *  Ax = b, where A is stored in CSR format, i.e.,
+ *
+ *      x = x + p(A) (b - A x)
+ *
+ *  where p is the polynomial with the given coefficients, in descending
+ *  order.  p(A) r is evaluated by Horner's rule, h = c_0 r and then
+ *  h = c_k r + A h for k = 1, ..., degree.  Each step is a single pass
+ *  over A, with the product fused with the update, and the last step
+ *  adds h to x directly.  The residual is computed in the first pass.
+ *  The row products are accumulated in LINALG_LANES partial sums, see
+ *  csr_row_dot in linalg.h, so they may differ in the last bits from a
+ *  serial sum.
+ *
+ *  Parameters
+ *      Ap[]            - CSR row pointer
+ *      Aj[]            - CSR index array
+ *      Ax[]            - CSR data array
+ *      x[]             - approximate solution
+ *      b[]             - right hand side
+ *      temp[]          - temporary vector of three times the size of x
+ *      coefficients[]  - coefficients of p, in descending order
+ *      zero_guess      - if nonzero, x is zero and b - A x = b
+ *
+ *  Returns:
+ *      Nothing, x will be modified in place
+ *
+ *  Notes:
+ *      The result does not depend on the number of threads.
+ *
+ */
+template<class I, class T, class F>
+void polynomial(const I Ap[], const int Ap_size,
+                const I Aj[], const int Aj_size,
+                const T Ax[], const int Ax_size,
+                      T  x[], const int  x_size,
+                const T  b[], const int  b_size,
+                      T temp[], const int temp_size,
+                const T coefficients[], const int coefficients_size,
+                const I zero_guess)
+{
+    const I n = Ap_size - 1;
+    const I degree = coefficients_size - 1;
+    T * r = temp;
 
+    if (degree < 0) {
+        return; }
 
-        // initialize rsum to b, then later subtract A*x
-        for(I k = 0; k < blocksize; k++) {
-            rsum[k] = b[i*blocksize+k]; }
+    #pragma omp parallel
+    {
+        // h = p_k(A) r so far, and g the next one, swapped by every thread
+        T * h = temp + n;
+        T * g = temp + 2*n;
+
+        #pragma omp for schedule(static)
+        for(I i = 0; i < n; i++) {
+            T ri = b[i];
+            if (!zero_guess) {
+                ri -= csr_row_dot(Aj, Ax, x, Ap[i], Ap[i+1]); }
+            r[i] = ri;
+            h[i] = coefficients[0]*ri;
+        }
 
-        // loop over row i
-        for(I jj = start; jj < end; jj++){
-            // extract column entry
-            I j = Aj[jj];
-            // absolute column entry for the start of this block
-            I col = j*blocksize;
+        for(I k = 1; k < degree; k++) {
+            const T c = coefficients[k];
+            #pragma omp for schedule(static)
+            for(I i = 0; i < n; i++) {
+                const T sum = c*r[i] + csr_row_dot(Aj, Ax, h, Ap[i], Ap[i+1]);
+                g[i] = sum;
+            }
+            std::swap(h, g);
+        }
 
-            if (i == j){    //point to where in Ax the diagonal block starts
-                diag_ptr = jj*B2; }
-            else {
-                // do a dense multiply of this block times x and accumulate in rsum
-                gemm(&(Ax[jj*B2]),  blocksize, blocksize, 'F',
-                     &(temp[col]),  blocksize,   1,       'F',
-                     &(Axloc[0]),   blocksize,   1,       'F',
-                     'T');
-                for(I m = 0; m < blocksize; m++) {
-                    rsum[m] -= Axloc[m]; }
+        if (degree == 0) {
+            #pragma omp for schedule(static)
+            for(I i = 0; i < n; i++) {
+                x[i] += h[i]; }
+        }
+        else {
+            const T c = coefficients[degree];
+            #pragma omp for schedule(static)
+            for(I i = 0; i < n; i++) {
+                const T sum = c*r[i] + csr_row_dot(Aj, Ax, h, Ap[i], Ap[i+1]);
+                x[i] += sum;
             }
         }
+    }
+}
 
-        // Carry out point-wise jacobi over the diagonal block,
-        // all the other blocks have been factored into rsum.
-        if (diag_ptr != -1) {
-            for(I k = step_start; k != step_end; k+=step){
-                T diag = 1.0;
-                for(I kk = step_start; kk != step_end; kk+=step){
-                    if(k == kk){
-                        // diagonal entry
-                        diag = Ax[k*blocksize + kk + diag_ptr]; }
-                    else{
-                        // off-diag entry
-                        rsum[k] -= Ax[k*blocksize + kk + diag_ptr]*temp[i*blocksize+kk]; }
-                }
-                if (diag != (F) 0.0){
-                    x[i*blocksize+k] = (one - omega2) * temp[i*blocksize+k] + omega2 * rsum[k]/diag; }
+
+/*
+ *  Add the product of block row i of the BSR matrix A, with square blocks,
+ *  and the vector v to y, i.e., y += A[i, :] v, where y has length
+ *  blocksize.  If BS is nonzero, it is the blocksize, as for block_matvec.
+ *  Helper for bsr_polynomial.
+ */
+template<int BS, class I, class T, class Y>
+inline void bsr_block_row_add(const I Ap[], const I Aj[], const T Ax[],
+                              const T v[], Y& y, const I i,
+                              const I blocksize_)
+{
+    const I blocksize = (BS > 0) ? BS : blocksize_;
+    const I B2 = blocksize*blocksize;
+    for(I jj = Ap[i]; jj < Ap[i+1]; jj++) {
+        const T * block = Ax + jj*B2;
+        const T * vj = v + Aj[jj]*blocksize;
+        for(I m = 0; m < blocksize; m++) {
+            T sum = y[m];
+            for(I l = 0; l < blocksize; l++) {
+                mult_add(sum, block[m*blocksize + l], vj[l]); }
+            y[m] = sum;
+        }
+    }
+}
+
+
+/*
+ *  Implementation of bsr_polynomial, with the blocksize BS as for
+ *  bsr_gauss_seidel_impl.
+ *
+ */
+template<class I, class T, class F, int BS>
+void bsr_polynomial_impl(const I Ap[], const int Ap_size,
+                         const I Aj[], const int Aj_size,
+                         const T Ax[], const int Ax_size,
+                               T  x[], const int  x_size,
+                         const T  b[], const int  b_size,
+                               T temp[], const int temp_size,
+                         const T coefficients[], const int coefficients_size,
+                         const I zero_guess,
+                         const I blocksize_)
+{
+    const I blocksize = (BS > 0) ? BS : blocksize_;
+    const I n_brow = Ap_size - 1;
+    const I n = n_brow*blocksize;
+    const I degree = coefficients_size - 1;
+    T * r = temp;
+
+    if (degree < 0) {
+        return; }
+
+    #pragma omp parallel
+    {
+        T * h = temp + n;
+        T * g = temp + 2*n;
+        block_vector<T, BS> Av(blocksize);
+
+        #pragma omp for schedule(static)
+        for(I i = 0; i < n_brow; i++) {
+            const I row = i*blocksize;
+            for(I m = 0; m < blocksize; m++) {
+                Av[m] = 0.0; }
+            if (!zero_guess) {
+                bsr_block_row_add<BS>(Ap, Aj, Ax, x, Av, i, blocksize); }
+            for(I m = 0; m < blocksize; m++) {
+                r[row + m] = b[row + m] - Av[m];
+                h[row + m] = coefficients[0]*r[row + m];
             }
         }
 
-    } // end outer-most for loop
+        for(I k = 1; k < degree; k++) {
+            const T c = coefficients[k];
+            #pragma omp for schedule(static)
+            for(I i = 0; i < n_brow; i++) {
+                const I row = i*blocksize;
+                for(I m = 0; m < blocksize; m++) {
+                    g[row + m] = c*r[row + m]; }
+                T * gi = g + row;
+                bsr_block_row_add<BS>(Ap, Aj, Ax, h, gi, i, blocksize);
+            }
+            std::swap(h, g);
+        }
 
-    delete[] rsum;
-    delete[] Axloc;
-}// end function
+        if (degree == 0) {
+            #pragma omp for schedule(static)
+            for(I i = 0; i < n; i++) {
+                x[i] += h[i]; }
+        }
+        else {
+            const T c = coefficients[degree];
+            #pragma omp for schedule(static)
+            for(I i = 0; i < n_brow; i++) {
+                const I row = i*blocksize;
+                for(I m = 0; m < blocksize; m++) {
+                    Av[m] = c*r[row + m]; }
+                bsr_block_row_add<BS>(Ap, Aj, Ax, h, Av, i, blocksize);
+                for(I m = 0; m < blocksize; m++) {
+                    x[row + m] += Av[m]; }
+            }
+        }
+    }
+}
+
+
+/*
+ *  Perform one iteration of polynomial smoothing on the linear system
+ *  Ax = b, where A is stored in BSR format with square blocks.
+ *
+ *  Refer to polynomial for additional information.
+ *
+ *  Parameters
+ *      Ap[]            - BSR row pointer
+ *      Aj[]            - BSR index array
+ *      Ax[]            - BSR data array
+ *      x[]             - approximate solution
+ *      b[]             - right hand side
+ *      temp[]          - temporary vector of three times the size of x
+ *      coefficients[]  - coefficients of p, in descending order
+ *      zero_guess      - if nonzero, x is zero and b - A x = b
+ *      blocksize       - BSR blocksize (blocks must be square)
+ *
+ *  Returns:
+ *      Nothing, x will be modified in place
+ *
+ */
+template<class I, class T, class F>
+void bsr_polynomial(const I Ap[], const int Ap_size,
+                    const I Aj[], const int Aj_size,
+                    const T Ax[], const int Ax_size,
+                          T  x[], const int  x_size,
+                    const T  b[], const int  b_size,
+                          T temp[], const int temp_size,
+                    const T coefficients[], const int coefficients_size,
+                    const I zero_guess,
+                    const I blocksize);
 
 
 
@@ -622,6 +1092,87 @@ void gauss_seidel_nr(const I Ap[], const int Ap_size,
 
 }
 
+/*
+ *  Implementation of block_jacobi, with the blocksize BS as for
+ *  bsr_gauss_seidel_impl.
+ *
+ */
+template<class I, class T, class F, int BS>
+void block_jacobi_impl(const I Ap[], const int Ap_size,
+                       const I Aj[], const int Aj_size,
+                       const T Ax[], const int Ax_size,
+                             T  x[], const int  x_size,
+                       const T  b[], const int  b_size,
+                       const T Tx[], const int Tx_size,
+                             T temp[], const int temp_size,
+                       const I row_start,
+                       const I row_stop,
+                       const I row_step,
+                       const T omega[], const int omega_size,
+                       const I blocksize_)
+{
+    const I blocksize = (BS > 0) ? BS : blocksize_;
+    // Rename
+    const T * Dinv = Tx;
+
+    const T one = 1.0;
+    const T zero = 0.0;
+    const T omega2 = omega[0];
+    const I blocksize_sq = blocksize*blocksize;
+    const I num_rows = sweep_length(row_start, row_stop, row_step);
+
+    #pragma omp parallel
+    {
+        // thread-local work space
+        block_vector<T, BS> rsum(blocksize);
+        block_vector<T, BS> v(blocksize);
+
+        // Copy x to temp vector
+        #pragma omp for schedule(static)
+        for(I n = 0; n < num_rows; n++) {
+            const I i = (row_start + n*row_step)*blocksize;
+            std::copy(&(x[i]), &(x[i+blocksize]), &(temp[i]));
+        }
+
+        // Begin block Jacobi sweep, the implicit barrier above
+        // completes temp before it is read
+        #pragma omp for schedule(static)
+        for(I n = 0; n < num_rows; n++) {
+            const I i = row_start + n*row_step;
+            I start = Ap[i];
+            I end   = Ap[i+1];
+            for(I k = 0; k < blocksize; k++) {
+                rsum[k] = zero; }
+
+            // Carry out a block dot product between block row i and x
+            for(I jj = start; jj < end; jj++){
+                I j = Aj[jj];
+                if (i == j) {
+                    //diagonal, do nothing
+                    continue;
+                }
+                else {
+                    block_matvec<BS>(&(Ax[jj*blocksize_sq]), &(temp[j*blocksize]), &(v[0]), blocksize);
+                    for(I k = 0; k < blocksize; k++) {
+                        rsum[k] += v[k]; }
+                }
+            }
+
+            // x[i*blocksize:(i+1)*blocksize] = (one - omega2) * temp[i*blocksize:(i+1)*blocksize] + omega2 *
+            //          (Dinv[i*blocksize_sq : (i+1)*blocksize_sq]*(b[i*blocksize:(i+1)*blocksize] - rsum[0:blocksize]));
+            I iblocksize = i*blocksize;
+            for(I k = 0; k < blocksize; k++) {
+                rsum[k] = b[iblocksize + k] - rsum[k]; }
+
+            block_matvec<BS>(&(Dinv[i*blocksize_sq]), &(rsum[0]), &(v[0]), blocksize);
+
+            for(I k = 0; k < blocksize; k++) {
+                x[iblocksize + k] = (one - omega2)*temp[iblocksize + k] + omega2*v[k]; }
+        }
+    }
+}
+
+
 /*
  *  Perform one iteration of block Jacobi relaxation on the linear
  *  system Ax = b, where A is stored in BSR format and x and b
@@ -662,28 +1213,40 @@ void block_jacobi(const I Ap[], const int Ap_size,
                   const I row_stop,
                   const I row_step,
                   const T omega[], const int omega_size,
-                  const I blocksize)
+                  const I blocksize);
+
+/*
+ *  Implementation of block_gauss_seidel, with the blocksize BS as for
+ *  bsr_gauss_seidel_impl.
+ *
+ */
+template<class I, class T, class F, int BS>
+void block_gauss_seidel_impl(const I Ap[], const int Ap_size,
+                             const I Aj[], const int Aj_size,
+                             const T Ax[], const int Ax_size,
+                                   T  x[], const int  x_size,
+                             const T  b[], const int  b_size,
+                             const T Tx[], const int Tx_size,
+                             const I row_start,
+                             const I row_stop,
+                             const I row_step,
+                             const I blocksize_)
 {
+    const I blocksize = (BS > 0) ? BS : blocksize_;
     // Rename
     const T * Dinv = Tx;
 
-    T one = 1.0;
     T zero = 0.0;
-    T omega2 = omega[0];
-    T *rsum = new T[blocksize];
-    T *v = new T[blocksize];
+    block_vector<T, BS> rsum(blocksize);
+    block_vector<T, BS> v(blocksize);
     I blocksize_sq = blocksize*blocksize;
 
-    // Copy x to temp vector
-    for(I i = row_start*blocksize; i != row_stop*blocksize; i += row_step*blocksize) {
-        std::copy(&(x[i]), &(x[i+blocksize]), &(temp[i]));
-    }
-
-    // Begin block Jacobi sweep
+    // Begin block Gauss-Seidel sweep
     for(I i = row_start; i != row_stop; i += row_step) {
         I start = Ap[i];
         I end   = Ap[i+1];
-        std::fill(&(rsum[0]), &(rsum[blocksize]), zero);
+        for(I k = 0; k < blocksize; k++) {
+            rsum[k] = zero; }
 
         // Carry out a block dot product between block row i and x
         for(I jj = start; jj < end; jj++){
@@ -693,34 +1256,22 @@ void block_jacobi(const I Ap[], const int Ap_size,
                 continue;
             }
             else {
-                gemm(&(Ax[jj*blocksize_sq]), blocksize, blocksize, 'F',
-                     &(temp[j*blocksize]),   blocksize, 1,         'F',
-                     &(v[0]),                blocksize, 1,         'F',
-                     'T');
+                block_matvec<BS>(&(Ax[jj*blocksize_sq]), &(x[j*blocksize]), &(v[0]), blocksize);
                 for(I k = 0; k < blocksize; k++) {
                     rsum[k] += v[k]; }
             }
         }
 
-        // x[i*blocksize:(i+1)*blocksize] = (one - omega2) * temp[i*blocksize:(i+1)*blocksize] + omega2 *
-        //          (Dinv[i*blocksize_sq : (i+1)*blocksize_sq]*(b[i*blocksize:(i+1)*blocksize] - rsum[0:blocksize]));
+        // x[i*blocksize:(i+1)*blocksize] = (Dinv[i*blocksize_sq : (i+1)*blocksize_sq]*(b[i*blocksize:(i+1)*blocksize] - rsum[0:blocksize]));
         I iblocksize = i*blocksize;
         for(I k = 0; k < blocksize; k++) {
             rsum[k] = b[iblocksize + k] - rsum[k]; }
 
-        gemm(&(Dinv[i*blocksize_sq]), blocksize, blocksize, 'F',
-             &(rsum[0]),              blocksize, 1,         'F',
-             &(v[0]),                 blocksize, 1,         'F',
-             'T');
-
-        for(I k = 0; k < blocksize; k++) {
-            x[iblocksize + k] = (one - omega2)*temp[iblocksize + k] + omega2*v[k]; }
+        block_matvec<BS>(&(Dinv[i*blocksize_sq]), &(rsum[0]), &(x[iblocksize]), blocksize);
     }
-
-    delete[] v;
-    delete[] rsum;
 }
 
+
 /*
  *  Perform one iteration of block Gauss-Seidel relaxation on
  *  the linear system Ax = b, where A is stored in BSR format
@@ -756,53 +1307,7 @@ void block_gauss_seidel(const I Ap[], const int Ap_size,
                         const I row_start,
                         const I row_stop,
                         const I row_step,
-                        const I blocksize)
-{
-    // Rename
-    const T * Dinv = Tx;
-
-    T zero = 0.0;
-    T *rsum = new T[blocksize];
-    T *v = new T[blocksize];
-    I blocksize_sq = blocksize*blocksize;
-
-    // Begin block Gauss-Seidel sweep
-    for(I i = row_start; i != row_stop; i += row_step) {
-        I start = Ap[i];
-        I end   = Ap[i+1];
-        std::fill(&(rsum[0]), &(rsum[blocksize]), zero);
-
-        // Carry out a block dot product between block row i and x
-        for(I jj = start; jj < end; jj++){
-            I j = Aj[jj];
-            if (i == j) {
-                //diagonal, do nothing
-                continue;
-            }
-            else {
-                gemm(&(Ax[jj*blocksize_sq]), blocksize, blocksize, 'F',
-                     &(x[j*blocksize]),      blocksize, 1,         'F',
-                     &(v[0]),                blocksize, 1,         'F',
-                     'T');
-                for(I k = 0; k < blocksize; k++) {
-                    rsum[k] += v[k]; }
-            }
-        }
-
-        // x[i*blocksize:(i+1)*blocksize] = (Dinv[i*blocksize_sq : (i+1)*blocksize_sq]*(b[i*blocksize:(i+1)*blocksize] - rsum[0:blocksize]));
-        I iblocksize = i*blocksize;
-        for(I k = 0; k < blocksize; k++) {
-            rsum[k] = b[iblocksize + k] - rsum[k]; }
-
-        gemm(&(Dinv[i*blocksize_sq]), blocksize, blocksize, 'F',
-             &(rsum[0]),              blocksize, 1,         'F',
-             &(x[iblocksize]),        blocksize, 1,         'F',
-             'T');
-    }
-
-    delete[] v;
-    delete[] rsum;
-}
+                        const I blocksize);
 
 /*
  *  Extract diagonal blocks from A and insert into a linear array.
@@ -921,6 +1426,9 @@ void extract_subblocks(const I Ap[], const int Ap_size,
  *      row_start      --- The subdomains are processed in this order,
  *      row_stop       --- for(i = row_start, i != row_stop, i+=row_step)
  *      row_step       --- {...computation...}
+ *      workspace[]    - Scratch space of length at least 2*nrows.  If
+ *                       workspace is shorter, the scratch space is
+ *                       allocated internally.
  *
  *
  *  Returns:
@@ -941,18 +1449,17 @@ void overlapping_schwarz_csr(const I Ap[], const int Ap_size,
                                    I nrows,
                                    I row_start,
                                    I row_stop,
-                                   I row_step)
+                                   I row_step,
+                                   T workspace[], const int workspace_size)
 {
 
-    //T zero = 0.0;
-    T *rsum = new T[nrows];
-    T *Dinv_rsum = new T[nrows];
-
-    // Initialize rsum and Dinv_rsum
-    for(I k = 0; k < nrows; k++) {
-        rsum[k] = 0.0;
-        Dinv_rsum[k] = 0.0;
+    std::vector<T> scratch;
+    T *rsum = workspace;
+    if(workspace_size < 2*nrows){
+        scratch.resize(2*nrows);
+        rsum = &scratch[0];
     }
+    T *Dinv_rsum = rsum + nrows;
 
     // Begin loop over the subdomains
     for(I domptr = row_start; domptr != row_stop; domptr+=row_step) {
@@ -960,26 +1467,26 @@ void overlapping_schwarz_csr(const I Ap[], const int Ap_size,
         I counter = 0;
         I size_domain = Sp[domptr+1] - Sp[domptr];
 
-        // Begin block calculation of the residual
+        // Begin block calculation of the residual, rsum is overwritten so
+        // that it need not be zeroed between subdomains
         for(I j = Sp[domptr]; j < Sp[domptr+1]; j++) {
             // For this row, calculate the residual
             I row = Sj[j];
             I start = Ap[row];
             I end   = Ap[row+1];
+            T r = b[row];
             for(I jj = start; jj < end; jj++){
-                rsum[counter] -= Ax[jj]*x[Aj[jj]];
+                r -= Ax[jj]*x[Aj[jj]];
             }
-
-            // Account for the RHS
-            rsum[counter] += b[row];
+            rsum[counter] = r;
             counter++;
         }
 
         // Multiply block residual with block inverse of A
-        gemm(&(Tx[Tp[domptr]]), size_domain, size_domain, 'F',
+        gemm<I, T>(&(Tx[Tp[domptr]]), size_domain, size_domain, 'F',
              &(rsum[0]),      size_domain,   1,         'F',
              &(Dinv_rsum[0]), size_domain,   1,         'F',
-             'F');
+             'T');
 
         // Add to x
         counter = 0;
@@ -987,19 +1494,1416 @@ void overlapping_schwarz_csr(const I Ap[], const int Ap_size,
             x[Sj[j]] += Dinv_rsum[counter];
             counter++;
             }
+    }
+}
+
+
+/*
+ *  LU factorization, with partial pivoting, of the diagonal block of A
+ *  for each subdomain, as extracted by extract_subblocks.  The factors
+ *  replace the blocks in Tx, so that they stay packed contiguously in
+ *  the order of the subdomains.  Used by overlapping_schwarz_lu_csr and
+ *  overlapping_schwarz_multicolor_csr.
+ *
+ *  Parameters
+ *      Tx[]       - Diagonal block of A for each subdomain, stored in
+ *                   row major.  Overwritten by the factors L and U of
+ *                   P A_i = L U, with the unit diagonal of L not stored.
+ *      Tp[]       - Pointer array into Tx indicating where the
+ *                   diagonal blocks start and stop
+ *      Sp[]       - Pointer array indicating where each subdomain
+ *                   starts and stops
+ *      Tpiv[]     - Pivots, row k of block i was swapped with row
+ *                   Tpiv[Sp[i] + k] at step k of the factorization.
+ *                   Tpiv[Sp[i]] is set to -1 if block i is singular.
+ *      nsdomains  - Number of subdomains
+ *      tol        - Block i is singular if a pivot is at most tol times
+ *                   the largest entry of the block in magnitude
+ *
+ *  Returns:
+ *      The number of singular blocks.  Tx is left partially factored
+ *      for these blocks, and they must be replaced, e.g., by their
+ *      pseudo-inverse, see overlapping_schwarz_lu_csr.
+ *
+ */
+template<class I, class T, class F>
+I schwarz_factor(      T Tx[], const int Tx_size,
+                 const I Tp[], const int Tp_size,
+                 const I Sp[], const int Sp_size,
+                       I Tpiv[], const int Tpiv_size,
+                 const I nsdomains,
+                 const F tol)
+{
+    I nsingular = 0;
+
+    #pragma omp parallel for schedule(static) reduction(+:nsingular)
+    for(I i = 0; i < nsdomains; i++) {
+        const I m = Sp[i+1] - Sp[i];
+        T * LU = Tx + Tp[i];
+        I * piv = Tpiv + Sp[i];
+
+        if (m == 0) {
+            continue; }
+
+        F scale = 0.0;
+        for(I k = 0; k < m*m; k++) {
+            scale = std::max(scale, mynorm(LU[k])); }
+
+        bool singular = (scale == 0.0);
+        for(I k = 0; k < m && !singular; k++) {
+            // Find the pivot, the largest entry of column k below row k
+            I p = k;
+            F pmax = mynorm(LU[k*m + k]);
+            for(I r = k + 1; r < m; r++) {
+                const F v = mynorm(LU[r*m + k]);
+                if (v > pmax) {
+                    p = r;
+                    pmax = v;
+                }
+            }
+            if (pmax <= tol*scale) {
+                singular = true;
+                break;
+            }
+
+            piv[k] = p;
+            if (p != k) {
+                std::swap_ranges(LU + k*m, LU + (k + 1)*m, LU + p*m); }
+
+            // Eliminate below the pivot, row by row
+            const T * Uk = LU + k*m;
+            for(I r = k + 1; r < m; r++) {
+                T * Ur = LU + r*m;
+                const T l = Ur[k]/Uk[k];
+                Ur[k] = l;
+                for(I c = k + 1; c < m; c++) {
+                    Ur[c] -= l*Uk[c]; }
+            }
+        }
+
+        if (singular) {
+            piv[0] = -1;
+            nsingular++;
+        }
+    }
+
+    return nsingular;
+}
+
+
+/*
+ *  Apply the Schwarz update x[S_i] += A_i^{-1} (b - A x)[S_i] for
+ *  subdomain i, where A_i is given by its LU factors from
+ *  schwarz_factor, or by an explicit inverse if Tpiv[Sp[i]] is -1.
+ *  Helper for overlapping_schwarz_lu_csr and
+ *  overlapping_schwarz_multicolor_csr, w is scratch space of length at
+ *  least twice the size of the subdomain.
+ */
+template<class I, class T>
+inline void schwarz_subdomain(const I Ap[], const I Aj[], const T Ax[],
+                              T x[], const T b[],
+                              const T Tx[], const I Tp[], const I Tpiv[],
+                              const I Sj[], const I Sp[], const I i, T w[])
+{
+    const I begin = Sp[i];
+    const I m = Sp[i+1] - begin;
+    const T * LU = Tx + Tp[i];
+    const I * piv = Tpiv + begin;
+    const I * S = Sj + begin;
+    T * r = w;
+
+    if (m == 0) {
+        return; }
+
+    // Residual restricted to the subdomain
+    for(I k = 0; k < m; k++) {
+        const I row = S[k];
+        T sum = b[row];
+        for(I jj = Ap[row]; jj < Ap[row+1]; jj++) {
+            sum -= Ax[jj]*x[Aj[jj]]; }
+        r[k] = sum;
+    }
+
+    if (piv[0] < 0) {
+        // Explicit (pseudo-)inverse, y = A_i^{-1} r with A_i^{-1} in row
+        // major.  A plain loop rather than gemm, whose shapes the compiler
+        // cannot see are positive here, see -Wstringop-overflow.
+        T * y = w + m;
+        for(I k = 0; k < m; k++) {
+            const T * row = LU + k*m;
+            T sum = 0.0;
+            for(I c = 0; c < m; c++) {
+                sum += row[c]*r[c]; }
+            y[k] = sum;
+        }
+        r = y;
+    }
+    else {
+        // Solve L U r = P r in place
+        for(I k = 0; k < m; k++) {
+            if (piv[k] != k) {
+                std::swap(r[k], r[piv[k]]); }
+        }
+        for(I k = 1; k < m; k++) {
+            T sum = r[k];
+            for(I c = 0; c < k; c++) {
+                sum -= LU[k*m + c]*r[c]; }
+            r[k] = sum;
+        }
+        for(I k = m - 1; k >= 0; k--) {
+            T sum = r[k];
+            for(I c = k + 1; c < m; c++) {
+                sum -= LU[k*m + c]*r[c]; }
+            r[k] = sum/LU[k*m + k];
+        }
+    }
+
+    for(I k = 0; k < m; k++) {
+        x[S[k]] += r[k]; }
+}
+
+
+/*
+ *  Perform one iteration of an overlapping Schwarz relaxation on
+ *  the linear system Ax = b, where A is stored in CSR format
+ *  and x and b are column vectors, with the diagonal block of each
+ *  subdomain given by its LU factors.
+ *
+ *  This is overlapping_schwarz_csr, with the inverses replaced by the
+ *  factors from schwarz_factor, and may be mixed with explicit inverses,
+ *  see Tpiv.
+ *
+ *  Parameters
+ *      Ap[]           - CSR row pointer
+ *      Aj[]           - CSR index array
+ *      Ax[]           - CSR data array
+ *      x[]            - approximate solution
+ *      b[]            - right hand side
+ *      Tx[]           - LU factors of each diagonal block of A, stored
+ *                       in row major, see schwarz_factor
+ *      Tp[]           - Pointer array into Tx indicating where the
+ *                       diagonal blocks start and stop
+ *      Tpiv[]         - Pivots from schwarz_factor.  If Tpiv[Sp[i]] is -1,
+ *                       then Tx holds the inverse of block i instead.
+ *      Sj[]           - Indices of each subdomain
+ *      Sp[]           - Pointer array indicating where each subdomain
+ *                       starts and stops
+ *      row_start      --- The subdomains are processed in this order,
+ *      row_stop       --- for(i = row_start, i != row_stop, i+=row_step)
+ *      row_step       --- {...computation...}
+ *      workspace[]    - Scratch space of length at least twice the size
+ *                       of the largest subdomain.  If workspace is
+ *                       shorter, the scratch space is allocated
+ *                       internally.
+ *
+ *  Returns:
+ *      Nothing, x will be modified in place
+ *
+ */
+template<class I, class T, class F>
+void overlapping_schwarz_lu_csr(const I Ap[], const int Ap_size,
+                                const I Aj[], const int Aj_size,
+                                const T Ax[], const int Ax_size,
+                                      T  x[], const int  x_size,
+                                const T  b[], const int  b_size,
+                                const T Tx[], const int Tx_size,
+                                const I Tp[], const int Tp_size,
+                                const I Tpiv[], const int Tpiv_size,
+                                const I Sj[], const int Sj_size,
+                                const I Sp[], const int Sp_size,
+                                const I row_start,
+                                const I row_stop,
+                                const I row_step,
+                                      T workspace[], const int workspace_size)
+{
+    I max_size = 0;
+    for(I i = 0; i < Sp_size - 1; i++) {
+        max_size = std::max(max_size, Sp[i+1] - Sp[i]); }
+
+    std::vector<T> scratch;
+    T * w = workspace;
+    if (workspace_size < 2*max_size) {
+        scratch.resize(2*max_size);
+        w = &scratch[0];
+    }
+
+    for(I i = row_start; i != row_stop; i += row_step) {
+        schwarz_subdomain(Ap, Aj, Ax, x, b, Tx, Tp, Tpiv, Sj, Sp, i, w); }
+}
+
+
+/*
+ *  Perform one iteration of multicolor overlapping Schwarz relaxation on
+ *  the linear system Ax = b, where A is stored in CSR format and x and b
+ *  are column vectors.  The subdomains are grouped by a coloring such
+ *  that the subdomains of one color do not overlap and none reads x
+ *  where another writes it, so that the subdomains of one color are
+ *  independent and are processed in parallel.
+ *
+ *  Refer to overlapping_schwarz_lu_csr for Tx, Tp, Tpiv, Sj, and Sp, and
+ *  to gauss_seidel_multicolor for color_start, color_stop, and
+ *  color_step.
+ *
+ *  Parameters
+ *      Ap[]             - CSR row pointer
+ *      Aj[]             - CSR index array
+ *      Ax[]             - CSR data array
+ *      x[]              - approximate solution
+ *      b[]              - right hand side
+ *      Tx[]             - LU factors (or inverses) of the diagonal blocks
+ *      Tp[]             - Pointer array into Tx
+ *      Tpiv[]           - Pivots from schwarz_factor
+ *      Sj[]             - Indices of each subdomain
+ *      Sp[]             - Pointer array into Sj
+ *      color_ptr[]      - pointer into color_domains for each color
+ *      color_domains[]  - subdomains, grouped by color
+ *      color_start      - first color of the sweep
+ *      color_stop       - end of the sweep (i.e. one past the last color)
+ *      color_step       - stride used during the sweep (may be negative)
+ *      workspace[]      - Scratch space of length at least twice the size
+ *                         of the largest subdomain times the number of
+ *                         threads.  If workspace is shorter, the scratch
+ *                         space is allocated internally.
+ *
+ *  Returns:
+ *      Nothing, x will be modified in place
+ *
+ *  Notes:
+ *      The result does not depend on the number of threads.
+ *
+ */
+template<class I, class T, class F>
+void overlapping_schwarz_multicolor_csr(const I Ap[], const int Ap_size,
+                                        const I Aj[], const int Aj_size,
+                                        const T Ax[], const int Ax_size,
+                                              T  x[], const int  x_size,
+                                        const T  b[], const int  b_size,
+                                        const T Tx[], const int Tx_size,
+                                        const I Tp[], const int Tp_size,
+                                        const I Tpiv[], const int Tpiv_size,
+                                        const I Sj[], const int Sj_size,
+                                        const I Sp[], const int Sp_size,
+                                        const I color_ptr[], const int color_ptr_size,
+                                        const I color_domains[], const int color_domains_size,
+                                        const I color_start,
+                                        const I color_stop,
+                                        const I color_step,
+                                              T workspace[], const int workspace_size)
+{
+    I max_size = 0;
+    for(I i = 0; i < Sp_size - 1; i++) {
+        max_size = std::max(max_size, Sp[i+1] - Sp[i]); }
+
+    // one slice of scratch space for each thread
+    const I num_threads = set_num_threads((I) 0);
+    std::vector<T> scratch;
+    T * workspace_ptr = workspace;
+    if (workspace_size < num_threads*2*max_size) {
+        scratch.resize(num_threads*2*max_size);
+        workspace_ptr = &scratch[0];
+    }
+
+    #pragma omp parallel num_threads(num_threads)
+    {
+        T * w = workspace_ptr + thread_num<I>()*2*max_size;
+
+        for(I c = color_start; c != color_stop; c += color_step) {
+            #pragma omp for schedule(static)
+            for(I ii = color_ptr[c]; ii < color_ptr[c+1]; ii++) {
+                schwarz_subdomain(Ap, Aj, Ax, x, b, Tx, Tp, Tpiv, Sj, Sp,
+                                  color_domains[ii], w);
+            }
+        }
+    }
+}
+
+
+/*
+ *  Compute the restricted residual coarse_b = R (b - A x) in a single
+ *  pass, where A is stored in CSR format and R^T is stored in CSR
+ *  format (i.e., R is stored in CSC format).
+ *
+ *  Each entry of the residual is computed from a row of A and then
+ *  immediately scattered into coarse_b through the same row of R^T,
+ *  so that the residual is never stored.
+ *
+ *  Parameters
+ *      Ap[]         - CSR row pointer of A
+ *      Aj[]         - CSR index array of A
+ *      Ax[]         - CSR data array of A
+ *      x[]          - approximate solution
+ *      b[]          - right hand side
+ *      Tp[]         - CSR row pointer of R^T
+ *      Tj[]         - CSR index array of R^T
+ *      Tx[]         - CSR data array of R^T
+ *      coarse_b[]   - restricted residual (output)
+ *
+ *  Returns:
+ *      Nothing, coarse_b will be overwritten
+ *
+ *  Notes:
+ *      R^T, not R^H, is used.  For R = P^H, R^T is the conjugate of P.
+ *
+ */
+template<class I, class T>
+void csr_residual_restrict(const I Ap[], const int Ap_size,
+                           const I Aj[], const int Aj_size,
+                           const T Ax[], const int Ax_size,
+                           const T  x[], const int  x_size,
+                           const T  b[], const int  b_size,
+                           const I Tp[], const int Tp_size,
+                           const I Tj[], const int Tj_size,
+                           const T Tx[], const int Tx_size,
+                                 T coarse_b[], const int coarse_b_size)
+{
+    const T zero = 0.0;
+    const I n_row = Ap_size - 1;
 
-        // Set rsum and Dinv_rsum back to zero for the next iteration
-        for(I k = 0; k < size_domain; k++) {
-            rsum[k] = 0.0;
-            Dinv_rsum[k] = 0.0;
+    std::fill(coarse_b, coarse_b + coarse_b_size, zero);
+
+    for(I i = 0; i < n_row; i++) {
+        T r = b[i];
+        for(I jj = Ap[i]; jj < Ap[i+1]; jj++) {
+            r -= Ax[jj]*x[Aj[jj]];
+        }
+
+        for(I kk = Tp[i]; kk < Tp[i+1]; kk++) {
+            coarse_b[Tj[kk]] += Tx[kk]*r;
         }
+    }
+}
+
 
+/*
+ *  Compute the restricted residual coarse_b = R (b - A x) in a single
+ *  pass, where A is stored in BSR format with square blocks and R^T
+ *  is stored in BSR format with the same block row size as A.
+ *
+ *  Refer to csr_residual_restrict for additional information.
+ *
+ *  Parameters
+ *      Ap[]              - BSR row pointer of A
+ *      Aj[]              - BSR index array of A
+ *      Ax[]              - BSR data array of A
+ *      x[]               - approximate solution
+ *      b[]               - right hand side
+ *      Tp[]              - BSR row pointer of R^T
+ *      Tj[]              - BSR index array of R^T
+ *      Tx[]              - BSR data array of R^T
+ *      coarse_b[]        - restricted residual (output)
+ *      blocksize         - BSR blocksize of A
+ *      coarse_blocksize  - number of columns in each block of R^T
+ *
+ *  Returns:
+ *      Nothing, coarse_b will be overwritten
+ *
+ */
+template<class I, class T>
+void bsr_residual_restrict(const I Ap[], const int Ap_size,
+                           const I Aj[], const int Aj_size,
+                           const T Ax[], const int Ax_size,
+                           const T  x[], const int  x_size,
+                           const T  b[], const int  b_size,
+                           const I Tp[], const int Tp_size,
+                           const I Tj[], const int Tj_size,
+                           const T Tx[], const int Tx_size,
+                                 T coarse_b[], const int coarse_b_size,
+                           const I blocksize,
+                           const I coarse_blocksize)
+{
+    const T zero = 0.0;
+    const I n_brow = Ap_size - 1;
+    const I A_bs2 = blocksize*blocksize;
+    const I T_bs2 = blocksize*coarse_blocksize;
+    std::vector<T> r(blocksize);
+
+    std::fill(coarse_b, coarse_b + coarse_b_size, zero);
+
+    for(I i = 0; i < n_brow; i++) {
+        // residual for block row i
+        for(I m = 0; m < blocksize; m++) {
+            r[m] = b[i*blocksize + m]; }
+
+        for(I jj = Ap[i]; jj < Ap[i+1]; jj++) {
+            const T * block = Ax + jj*A_bs2;
+            const T * xj = x + Aj[jj]*blocksize;
+            for(I m = 0; m < blocksize; m++) {
+                T sum = zero;
+                for(I n = 0; n < blocksize; n++) {
+                    sum += block[m*blocksize + n]*xj[n]; }
+                r[m] -= sum;
+            }
+        }
+
+        // scatter through block row i of R^T
+        for(I kk = Tp[i]; kk < Tp[i+1]; kk++) {
+            const T * block = Tx + kk*T_bs2;
+            T * bk = coarse_b + Tj[kk]*coarse_blocksize;
+            for(I m = 0; m < blocksize; m++) {
+                for(I c = 0; c < coarse_blocksize; c++) {
+                    bk[c] += block[m*coarse_blocksize + c]*r[m]; }
+            }
+        }
+    }
+}
+
+
+/*
+ *  Apply the coarse grid correction x += P coarse_x in place, where P
+ *  is stored in CSR format.
+ *
+ *  Parameters
+ *      Pp[]         - CSR row pointer of P
+ *      Pj[]         - CSR index array of P
+ *      Px[]         - CSR data array of P
+ *      coarse_x[]   - coarse grid correction
+ *      x[]          - approximate solution
+ *
+ *  Returns:
+ *      Nothing, x will be modified in place
+ *
+ */
+template<class I, class T>
+void csr_prolongate_add(const I Pp[], const int Pp_size,
+                        const I Pj[], const int Pj_size,
+                        const T Px[], const int Px_size,
+                        const T coarse_x[], const int coarse_x_size,
+                              T x[], const int x_size)
+{
+    const I n_row = Pp_size - 1;
+
+    #pragma omp parallel for schedule(static)
+    for(I i = 0; i < n_row; i++) {
+        T sum = x[i];
+        for(I jj = Pp[i]; jj < Pp[i+1]; jj++) {
+            sum += Px[jj]*coarse_x[Pj[jj]];
+        }
+        x[i] = sum;
+    }
+}
+
+
+/*
+ *  Apply the coarse grid correction x += P coarse_x in place, where P
+ *  is stored in BSR format.
+ *
+ *  Parameters
+ *      Pp[]              - BSR row pointer of P
+ *      Pj[]              - BSR index array of P
+ *      Px[]              - BSR data array of P
+ *      coarse_x[]        - coarse grid correction
+ *      x[]               - approximate solution
+ *      blocksize         - number of rows in each block of P
+ *      coarse_blocksize  - number of columns in each block of P
+ *
+ *  Returns:
+ *      Nothing, x will be modified in place
+ *
+ */
+template<class I, class T>
+void bsr_prolongate_add(const I Pp[], const int Pp_size,
+                        const I Pj[], const int Pj_size,
+                        const T Px[], const int Px_size,
+                        const T coarse_x[], const int coarse_x_size,
+                              T x[], const int x_size,
+                        const I blocksize,
+                        const I coarse_blocksize)
+{
+    const I n_brow = Pp_size - 1;
+    const I P_bs2 = blocksize*coarse_blocksize;
+
+    #pragma omp parallel for schedule(static)
+    for(I i = 0; i < n_brow; i++) {
+        T * xi = x + i*blocksize;
+        for(I jj = Pp[i]; jj < Pp[i+1]; jj++) {
+            const T * block = Px + jj*P_bs2;
+            const T * cj = coarse_x + Pj[jj]*coarse_blocksize;
+            for(I m = 0; m < blocksize; m++) {
+                T sum = 0.0;
+                for(I n = 0; n < coarse_blocksize; n++) {
+                    sum += block[m*coarse_blocksize + n]*cj[n]; }
+                xi[m] += sum;
+            }
+        }
+    }
+}
+
+
+/*
+ *  Perform one iteration of Gauss-Seidel relaxation on the linear
+ *  system Ax = b, where A is stored in CSR format with delta encoded
+ *  column indices, see csr_delta_matvec in sparse.h.
+ *
+ *  Refer to gauss_seidel for additional information regarding
+ *  row_start, row_stop, and row_step.
+ *
+ *  Parameters
+ *      Ap[]       - CSR row pointer
+ *      Ab[]       - column of the first entry of each row
+ *      Ad[]       - offset of each column from the previous one in its row
+ *      Ax[]       - CSR data array
+ *      x[]        - approximate solution
+ *      b[]        - right hand side
+ *      row_start  - beginning of the sweep
+ *      row_stop   - end of the sweep (i.e. one past the last unknown)
+ *      row_step   - stride used during the sweep (may be negative)
+ *
+ *  Returns:
+ *      Nothing, x will be modified in place
+ *
+ */
+template<class I, class T, class F>
+void gauss_seidel_delta(const I Ap[], const int Ap_size,
+                        const I Ab[], const int Ab_size,
+                        const unsigned short Ad[], const int Ad_size,
+                        const T Ax[], const int Ax_size,
+                              T  x[], const int  x_size,
+                        const T  b[], const int  b_size,
+                        const I row_start,
+                        const I row_stop,
+                        const I row_step)
+{
+    for(I i = row_start; i != row_stop; i += row_step) {
+        I j = Ab[i];
+        T rsum = 0;
+        T diag = 0;
+
+        for(I jj = Ap[i]; jj < Ap[i+1]; jj++){
+            j += Ad[jj];
+            if (i == j)
+                diag  = Ax[jj];
+            else
+                rsum += Ax[jj]*x[j];
+        }
+
+        if (diag != (F) 0.0){
+            x[i] = (b[i] - rsum)/diag;
+        }
+    }
+}
+
+
+/*
+ *  Perform one iteration of multicolor Gauss-Seidel relaxation on the
+ *  linear system Ax = b, where A is stored in CSR format with delta
+ *  encoded column indices, see csr_delta_matvec in sparse.h.
+ *
+ *  Refer to gauss_seidel_multicolor for additional information
+ *  regarding color_ptr, color_rows, color_start, color_stop, and
+ *  color_step.
+ *
+ *  Parameters
+ *      Ap[]          - CSR row pointer
+ *      Ab[]          - column of the first entry of each row
+ *      Ad[]          - offset of each column from the previous one in its row
+ *      Ax[]          - CSR data array
+ *      x[]           - approximate solution
+ *      b[]           - right hand side
+ *      color_ptr[]   - pointer into color_rows for each color
+ *      color_rows[]  - rows of A, grouped by color
+ *      color_start   - first color of the sweep
+ *      color_stop    - end of the sweep (i.e. one past the last color)
+ *      color_step    - stride used during the sweep (may be negative)
+ *
+ *  Returns:
+ *      Nothing, x will be modified in place
+ *
+ */
+template<class I, class T, class F>
+void gauss_seidel_multicolor_delta(const I Ap[], const int Ap_size,
+                                   const I Ab[], const int Ab_size,
+                                   const unsigned short Ad[], const int Ad_size,
+                                   const T Ax[], const int Ax_size,
+                                         T  x[], const int  x_size,
+                                   const T  b[], const int  b_size,
+                                   const I color_ptr[], const int color_ptr_size,
+                                   const I color_rows[], const int color_rows_size,
+                                   const I color_start,
+                                   const I color_stop,
+                                   const I color_step)
+{
+    for(I c = color_start; c != color_stop; c += color_step) {
+        const I color_begin = color_ptr[c];
+        const I color_end   = color_ptr[c+1];
+
+        #pragma omp parallel for schedule(static)
+        for(I ii = color_begin; ii < color_end; ii++) {
+            const I i = color_rows[ii];
+            I j = Ab[i];
+            T rsum = 0;
+            T diag = 0;
+
+            for(I jj = Ap[i]; jj < Ap[i+1]; jj++){
+                j += Ad[jj];
+                if (i == j)
+                    diag  = Ax[jj];
+                else
+                    rsum += Ax[jj]*x[j];
+            }
+
+            if (diag != (F) 0.0){
+                x[i] = (b[i] - rsum)/diag;
+            }
+        }
+    }
+}
+
+
+/*
+ *  Perform one iteration of Jacobi relaxation on the linear system
+ *  Ax = b, where A is stored in CSR format with delta encoded column
+ *  indices, see csr_delta_matvec in sparse.h.
+ *
+ *  Refer to jacobi for additional information.
+ *
+ *  Parameters
+ *      Ap[]       - CSR row pointer
+ *      Ab[]       - column of the first entry of each row
+ *      Ad[]       - offset of each column from the previous one in its row
+ *      Ax[]       - CSR data array
+ *      x[]        - approximate solution
+ *      b[]        - right hand side
+ *      temp[]     - temporary vector the same size as x
+ *      row_start  - beginning of the sweep
+ *      row_stop   - end of the sweep (i.e. one past the last unknown)
+ *      row_step   - stride used during the sweep (may be negative)
+ *      omega      - damping parameter
+ *
+ *  Returns:
+ *      Nothing, x will be modified in place
+ *
+ */
+template<class I, class T, class F>
+void jacobi_delta(const I Ap[], const int Ap_size,
+                  const I Ab[], const int Ab_size,
+                  const unsigned short Ad[], const int Ad_size,
+                  const T Ax[], const int Ax_size,
+                        T  x[], const int  x_size,
+                  const T  b[], const int  b_size,
+                        T temp[], const int temp_size,
+                  const I row_start,
+                  const I row_stop,
+                  const I row_step,
+                  const T omega[], const int omega_size)
+{
+    T one = 1.0;
+    T omega2 = omega[0];
+    const I num_rows = sweep_length(row_start, row_stop, row_step);
+
+    #pragma omp parallel
+    {
+        #pragma omp for schedule(static)
+        for(I k = 0; k < num_rows; k++) {
+            const I i = row_start + k*row_step;
+            temp[i] = x[i];
+        }
+
+        #pragma omp for schedule(static)
+        for(I k = 0; k < num_rows; k++) {
+            const I i = row_start + k*row_step;
+            I j = Ab[i];
+            T rsum = 0;
+            T diag = 0;
+
+            for(I jj = Ap[i]; jj < Ap[i+1]; jj++){
+                j += Ad[jj];
+                if (i == j)
+                    diag  = Ax[jj];
+                else
+                    rsum += Ax[jj]*temp[j];
+            }
+
+            if (diag != (F) 0.0){
+                x[i] = (one - omega2) * temp[i] + omega2 * ((b[i] - rsum)/diag);
+            }
+        }
+    }
+}
+
+
+/*
+ *  Apply the coarse grid correction x += P coarse_x in place, where P
+ *  has at most one block per block row, as a tentative prolongator, and
+ *  is stored by its aggregate map: block row i of P is the block
+ *  Px[i] in block column Pj[i], or zero if Pj[i] is negative.
+ *
+ *  Parameters
+ *      Pj[]              - block column of each block row of P, or -1
+ *      Px[]              - block of each block row of P
+ *      coarse_x[]        - coarse grid correction
+ *      x[]               - approximate solution
+ *      blocksize         - number of rows in each block of P
+ *      coarse_blocksize  - number of columns in each block of P
+ *
+ *  Returns:
+ *      Nothing, x will be modified in place
+ *
+ */
+template<class I, class T>
+void aggregate_prolongate_add(const I Pj[], const int Pj_size,
+                              const T Px[], const int Px_size,
+                              const T coarse_x[], const int coarse_x_size,
+                                    T x[], const int x_size,
+                              const I blocksize,
+                              const I coarse_blocksize)
+{
+    const I n_brow = Pj_size;
+    const I P_bs2 = blocksize*coarse_blocksize;
+
+    #pragma omp parallel for schedule(static)
+    for(I i = 0; i < n_brow; i++) {
+        if(Pj[i] < 0){
+            continue;
+        }
+        T * xi = x + i*blocksize;
+        const T * block = Px + i*P_bs2;
+        const T * cj = coarse_x + Pj[i]*coarse_blocksize;
+        for(I m = 0; m < blocksize; m++) {
+            T sum = 0.0;
+            for(I n = 0; n < coarse_blocksize; n++) {
+                sum += block[m*coarse_blocksize + n]*cj[n]; }
+            xi[m] += sum;
+        }
+    }
+}
+
+
+/*
+ *  Restrict coarse_b = P^H r, where P is stored by its aggregate map,
+ *  see aggregate_prolongate_add.
+ *
+ *  Parameters
+ *      Pj[]              - block column of each block row of P, or -1
+ *      Px[]              - block of each block row of P
+ *      r[]               - fine level vector, e.g., the residual
+ *      coarse_b[]        - restricted vector (output)
+ *      blocksize         - number of rows in each block of P
+ *      coarse_blocksize  - number of columns in each block of P
+ *
+ *  Returns:
+ *      Nothing, coarse_b will be overwritten
+ *
+ *  Notes:
+ *      The block rows of P are scattered into coarse_b, so this is not
+ *      threaded.
+ *
+ */
+template<class I, class T>
+void aggregate_restrict(const I Pj[], const int Pj_size,
+                        const T Px[], const int Px_size,
+                        const T r[], const int r_size,
+                              T coarse_b[], const int coarse_b_size,
+                        const I blocksize,
+                        const I coarse_blocksize)
+{
+    const I n_brow = Pj_size;
+    const I P_bs2 = blocksize*coarse_blocksize;
+
+    std::fill(coarse_b, coarse_b + coarse_b_size, T(0));
+
+    for(I i = 0; i < n_brow; i++) {
+        if(Pj[i] < 0){
+            continue;
+        }
+        const T * ri = r + i*blocksize;
+        const T * block = Px + i*P_bs2;
+        T * bj = coarse_b + Pj[i]*coarse_blocksize;
+        for(I m = 0; m < blocksize; m++) {
+            for(I n = 0; n < coarse_blocksize; n++) {
+                bj[n] += conjugate(block[m*coarse_blocksize + n])*ri[m]; }
+        }
+    }
+}
+
+
+/*
+ *  Perform one iteration of Gauss-Seidel relaxation on the linear
+ *  systems A X = B, where A is stored in CSR format and X and B hold
+ *  nrhs column vectors, stored in row major (C) order, i.e., x[i*nrhs + k]
+ *  is entry i of the k-th vector.
+ *
+ *  Each row of A is read once for all nrhs vectors, and the result for
+ *  each vector is the same as with gauss_seidel.
+ *
+ *  Parameters
+ *      Ap[]       - CSR row pointer
+ *      Aj[]       - CSR index array
+ *      Ax[]       - CSR data array
+ *      x[]        - approximate solutions, n x nrhs
+ *      b[]        - right hand sides, n x nrhs
+ *      row_start  - beginning of the sweep
+ *      row_stop   - end of the sweep (i.e. one past the last unknown)
+ *      row_step   - stride used during the sweep (may be negative)
+ *      nrhs       - number of vectors in x and b
+ *
+ *  Returns:
+ *      Nothing, x will be modified in place
+ *
+ */
+template<class I, class T, class F>
+void gauss_seidel_multi(const I Ap[], const int Ap_size,
+                        const I Aj[], const int Aj_size,
+                        const T Ax[], const int Ax_size,
+                              T  x[], const int  x_size,
+                        const T  b[], const int  b_size,
+                        const I row_start,
+                        const I row_stop,
+                        const I row_step,
+                        const I nrhs)
+{
+    std::vector<T> rsum(nrhs);
+
+    for(I i = row_start; i != row_stop; i += row_step) {
+        I start = Ap[i];
+        I end   = Ap[i+1];
+        T diag = 0;
+        std::fill(rsum.begin(), rsum.end(), (T) 0.0);
+
+        for(I jj = start; jj < end; jj++){
+            I j = Aj[jj];
+            if (i == j){
+                diag  = Ax[jj];
+            }
+            else{
+                const T a = Ax[jj];
+                const T * xj = x + j*nrhs;
+                for(I k = 0; k < nrhs; k++){
+                    rsum[k] += a*xj[k]; }
+            }
+        }
+
+        if (diag != (F) 0.0){
+            T * xi = x + i*nrhs;
+            const T * bi = b + i*nrhs;
+            for(I k = 0; k < nrhs; k++){
+                xi[k] = (bi[k] - rsum[k])/diag; }
+        }
+    }
+}
+
+
+/*
+ *  Perform one iteration of Jacobi relaxation on the linear systems
+ *  A X = B, where A is stored in CSR format and X and B hold nrhs column
+ *  vectors, stored in row major order as for gauss_seidel_multi.
+ *
+ *  Refer to jacobi for additional information.
+ *
+ *  Parameters
+ *      Ap[]       - CSR row pointer
+ *      Aj[]       - CSR index array
+ *      Ax[]       - CSR data array
+ *      x[]        - approximate solutions, n x nrhs
+ *      b[]        - right hand sides, n x nrhs
+ *      temp[]     - temporary array the same size as x
+ *      row_start  - beginning of the sweep
+ *      row_stop   - end of the sweep (i.e. one past the last unknown)
+ *      row_step   - stride used during the sweep (may be negative)
+ *      nrhs       - number of vectors in x and b
+ *      omega      - damping parameter
+ *
+ *  Returns:
+ *      Nothing, x will be modified in place
+ *
+ */
+template<class I, class T, class F>
+void jacobi_multi(const I Ap[], const int Ap_size,
+                  const I Aj[], const int Aj_size,
+                  const T Ax[], const int Ax_size,
+                        T  x[], const int  x_size,
+                  const T  b[], const int  b_size,
+                        T temp[], const int temp_size,
+                  const I row_start,
+                  const I row_stop,
+                  const I row_step,
+                  const I nrhs,
+                  const T omega[], const int omega_size)
+{
+    T one = 1.0;
+    T omega2 = omega[0];
+    const I num_rows = sweep_length(row_start, row_stop, row_step);
+
+    #pragma omp parallel
+    {
+        std::vector<T> rsum(nrhs);
+
+        #pragma omp for schedule(static)
+        for(I m = 0; m < num_rows; m++) {
+            const I i = row_start + m*row_step;
+            for(I k = 0; k < nrhs; k++){
+                temp[i*nrhs + k] = x[i*nrhs + k]; }
+        }
+
+        // the implicit barrier above completes temp before it is read
+        #pragma omp for schedule(static)
+        for(I m = 0; m < num_rows; m++) {
+            const I i = row_start + m*row_step;
+            I start = Ap[i];
+            I end   = Ap[i+1];
+            T diag = 0;
+            std::fill(rsum.begin(), rsum.end(), (T) 0.0);
+
+            for(I jj = start; jj < end; jj++){
+                I j = Aj[jj];
+                if (i == j){
+                    diag  = Ax[jj];
+                }
+                else{
+                    const T a = Ax[jj];
+                    const T * tj = temp + j*nrhs;
+                    for(I k = 0; k < nrhs; k++){
+                        rsum[k] += a*tj[k]; }
+                }
+            }
+
+            if (diag != (F) 0.0){
+                T * xi = x + i*nrhs;
+                const T * bi = b + i*nrhs;
+                const T * ti = temp + i*nrhs;
+                for(I k = 0; k < nrhs; k++){
+                    xi[k] = (one - omega2) * ti[k] + omega2 * ((bi[k] - rsum[k])/diag); }
+            }
+        }
+    }
+}
+
+
+/*
+ *  Compute the restricted residuals coarse_b = R (b - A x) in a single
+ *  pass for nrhs vectors, where A and R^T are stored in CSR format, and
+ *  x, b and coarse_b are stored in row major order, as for
+ *  gauss_seidel_multi.
+ *
+ *  Refer to csr_residual_restrict for additional information.
+ *
+ *  Parameters
+ *      Ap[]         - CSR row pointer of A
+ *      Aj[]         - CSR index array of A
+ *      Ax[]         - CSR data array of A
+ *      x[]          - approximate solutions, n x nrhs
+ *      b[]          - right hand sides, n x nrhs
+ *      Tp[]         - CSR row pointer of R^T
+ *      Tj[]         - CSR index array of R^T
+ *      Tx[]         - CSR data array of R^T
+ *      coarse_b[]   - restricted residuals (output), n_coarse x nrhs
+ *      nrhs         - number of vectors in x and b
+ *
+ *  Returns:
+ *      Nothing, coarse_b will be overwritten
+ *
+ */
+template<class I, class T>
+void csr_residual_restrict_multi(const I Ap[], const int Ap_size,
+                                 const I Aj[], const int Aj_size,
+                                 const T Ax[], const int Ax_size,
+                                 const T  x[], const int  x_size,
+                                 const T  b[], const int  b_size,
+                                 const I Tp[], const int Tp_size,
+                                 const I Tj[], const int Tj_size,
+                                 const T Tx[], const int Tx_size,
+                                       T coarse_b[], const int coarse_b_size,
+                                 const I nrhs)
+{
+    const T zero = 0.0;
+    const I n_row = Ap_size - 1;
+    std::vector<T> r(nrhs);
+
+    std::fill(coarse_b, coarse_b + coarse_b_size, zero);
+
+    for(I i = 0; i < n_row; i++) {
+        for(I k = 0; k < nrhs; k++){
+            r[k] = b[i*nrhs + k]; }
+
+        for(I jj = Ap[i]; jj < Ap[i+1]; jj++) {
+            const T a = Ax[jj];
+            const T * xj = x + Aj[jj]*nrhs;
+            for(I k = 0; k < nrhs; k++){
+                r[k] -= a*xj[k]; }
+        }
+
+        for(I kk = Tp[i]; kk < Tp[i+1]; kk++) {
+            const T t = Tx[kk];
+            T * bj = coarse_b + Tj[kk]*nrhs;
+            for(I k = 0; k < nrhs; k++){
+                bj[k] += t*r[k]; }
+        }
+    }
+}
+
+
+/*
+ *  Apply the coarse grid corrections x += P coarse_x in place for nrhs
+ *  vectors, where P is stored in CSR format, and x and coarse_x are
+ *  stored in row major order, as for gauss_seidel_multi.
+ *
+ *  Parameters
+ *      Pp[]         - CSR row pointer of P
+ *      Pj[]         - CSR index array of P
+ *      Px[]         - CSR data array of P
+ *      coarse_x[]   - coarse grid corrections, n_coarse x nrhs
+ *      x[]          - approximate solutions, n x nrhs
+ *      nrhs         - number of vectors in x and coarse_x
+ *
+ *  Returns:
+ *      Nothing, x will be modified in place
+ *
+ */
+template<class I, class T>
+void csr_prolongate_add_multi(const I Pp[], const int Pp_size,
+                              const I Pj[], const int Pj_size,
+                              const T Px[], const int Px_size,
+                              const T coarse_x[], const int coarse_x_size,
+                                    T x[], const int x_size,
+                              const I nrhs)
+{
+    const I n_row = Pp_size - 1;
+
+    #pragma omp parallel for schedule(static)
+    for(I i = 0; i < n_row; i++) {
+        T * xi = x + i*nrhs;
+        for(I jj = Pp[i]; jj < Pp[i+1]; jj++) {
+            const T p = Px[jj];
+            const T * cj = coarse_x + Pj[jj]*nrhs;
+            for(I k = 0; k < nrhs; k++){
+                xi[k] += p*cj[k]; }
+        }
+    }
+}
+
+
+/*
+ *  Layout of the level descriptors of multigrid_cycle.  Each level is
+ *  described by CYCLE_LEVEL_SIZE integers, which are either sizes, codes,
+ *  or offsets into the index[], data[], and work[] arrays of the cycle.
+ *
+ *  For each level but the coarsest, the matrices A, R^T, and P are
+ *  stored by the offsets of their (B)CSR row pointer and index arrays
+ *  in index[] and of their data arrays in data[].  The smoothers are
+ *  given by a code, a number of iterations, and an argument, i.e., the
+ *  sweep of CYCLE_GAUSS_SEIDEL or the offset of omega in data[] for
+ *  CYCLE_JACOBI.  For the coarsest level, the solver is given by a code
+ *  and the offsets of the dense factorization in data[] and of its
+ *  pivots in index[].
+ *
+ */
+#define CYCLE_N            0   // number of unknowns of the level
+#define CYCLE_A_BS         1   // BSR blocksize of A, or 0 for CSR
+#define CYCLE_A_P          2
+#define CYCLE_A_J          3
+#define CYCLE_A_X          4
+#define CYCLE_T_BS         5   // columns of the blocks of R^T, or 0 for CSR
+#define CYCLE_T_P          6
+#define CYCLE_T_J          7
+#define CYCLE_T_X          8
+#define CYCLE_P_BROW       9   // rows of the blocks of P, or 0 for CSR
+#define CYCLE_P_BCOL      10   // columns of the blocks of P
+#define CYCLE_P_P         11
+#define CYCLE_P_J         12
+#define CYCLE_P_X         13
+#define CYCLE_PRE         14   // presmoother code, iterations, argument
+#define CYCLE_POST        17   // postsmoother code, iterations, argument
+#define CYCLE_WORK        20   // offset of x, b, and temp in work[]
+#define CYCLE_LEVEL_SIZE  21
+
+#define CYCLE_COARSE      1    // coarse solver code of the coarsest level
+#define CYCLE_COARSE_X    2    // offset of the factorization in data[]
+#define CYCLE_COARSE_PIV  3    // offset of the pivots in index[]
+
+// smoother codes
+#define CYCLE_NONE          0
+#define CYCLE_GAUSS_SEIDEL  1
+#define CYCLE_JACOBI        2
+
+// Gauss-Seidel sweeps
+#define CYCLE_FORWARD    0
+#define CYCLE_BACKWARD   1
+#define CYCLE_SYMMETRIC  2
+
+// coarse solver codes
+#define CYCLE_ZERO   0    // no correction, i.e., A is zero
+#define CYCLE_DENSE  1    // x = M b, with the dense n x n matrix M (pinv)
+#define CYCLE_LU     2    // LU factorization with partial pivoting
+
+// cycle types
+#define CYCLE_V  0
+#define CYCLE_W  1
+#define CYCLE_F  2
+
+
+/*
+ *  Apply the smoother given by code, iterations, and arg (see above)
+ *  to A x = b on the level described by level[], as the Python
+ *  smoothers gauss_seidel and jacobi do.
+ *
+ */
+template<class I, class T, class F>
+void multigrid_cycle_smooth(const I level[],
+                            const I code,
+                            const I iterations,
+                            const I arg,
+                            const I index[],
+                            const T data[],
+                                  T x[],
+                            const T b[],
+                                  T temp[])
+{
+    const I n = level[CYCLE_N];
+    const I bs = level[CYCLE_A_BS];
+    const I n_brow = (bs == 0) ? n : n / bs;
+    const I * Ap = index + level[CYCLE_A_P];
+    const I * Aj = index + level[CYCLE_A_J];
+    const T * Ax = data + level[CYCLE_A_X];
+    const I nnz = Ap[n_brow];
+    const I Ax_size = (bs == 0) ? nnz : nnz*bs*bs;
+
+    if (code == CYCLE_GAUSS_SEIDEL) {
+        for(I iter = 0; iter < iterations; iter++) {
+            // a symmetric sweep is a forward sweep then a backward sweep
+            for(I pass = 0; pass < 2; pass++) {
+                const bool forward = (pass == 0);
+                if ((forward && arg == CYCLE_BACKWARD) ||
+                    (!forward && arg == CYCLE_FORWARD)) {
+                    continue; }
+
+                const I row_start = forward ? 0 : n_brow - 1;
+                const I row_stop  = forward ? n_brow : -1;
+                const I row_step  = forward ? 1 : -1;
+                if (bs == 0) {
+                    gauss_seidel<I, T, F>(Ap, n_brow + 1, Aj, nnz, Ax, Ax_size,
+                                          x, n, b, n,
+                                          row_start, row_stop, row_step);
+                } else {
+                    bsr_gauss_seidel<I, T, F>(Ap, n_brow + 1, Aj, nnz, Ax, Ax_size,
+                                              x, n, b, n,
+                                              row_start, row_stop, row_step, bs);
+                }
+            }
+        }
+    }
+    else if (code == CYCLE_JACOBI) {
+        const T * omega = data + arg;
+        for(I iter = 0; iter < iterations; iter++) {
+            if (bs == 0) {
+                jacobi<I, T, F>(Ap, n_brow + 1, Aj, nnz, Ax, Ax_size, x, n, b, n,
+                                temp, n, 0, n_brow, 1, omega, 1);
+            } else {
+                bsr_jacobi<I, T, F>(Ap, n_brow + 1, Aj, nnz, Ax, Ax_size, x, n,
+                                    b, n, temp, n, 0, n_brow, 1, bs, omega, 1);
+            }
+        }
+    }
+}
+
+
+/*
+ *  Solve A x = b on the coarsest level described by level[], with the
+ *  dense factorization stored in data[] (see above).
+ *
+ */
+template<class I, class T>
+void multigrid_cycle_coarse_solve(const I level[],
+                                  const I index[],
+                                  const T data[],
+                                        T x[],
+                                  const T b[])
+{
+    const I n = level[CYCLE_N];
+    const T * M = data + level[CYCLE_COARSE_X];
+
+    if (level[CYCLE_COARSE] == CYCLE_DENSE) {
+        for(I i = 0; i < n; i++) {
+            T sum = 0.0;
+            for(I j = 0; j < n; j++) {
+                sum += M[i*n + j]*b[j]; }
+            x[i] = sum;
+        }
+    }
+    else if (level[CYCLE_COARSE] == CYCLE_LU) {
+        // P A = L U, with the row interchanges in piv as from getrf
+        const I * piv = index + level[CYCLE_COARSE_PIV];
+        std::copy(b, b + n, x);
+        for(I i = 0; i < n; i++) {
+            std::swap(x[i], x[piv[i]]); }
+
+        for(I i = 0; i < n; i++) {
+            T sum = x[i];
+            for(I j = 0; j < i; j++) {
+                sum -= M[i*n + j]*x[j]; }
+            x[i] = sum;
+        }
+
+        for(I i = n - 1; i >= 0; i--) {
+            T sum = x[i];
+            for(I j = i + 1; j < n; j++) {
+                sum -= M[i*n + j]*x[j]; }
+            x[i] = sum / M[i*n + i];
+        }
+    }
+    else {
+        std::fill(x, x + n, (T) 0.0);
+    }
+}
+
+
+/*
+ *  Recursive part of multigrid_cycle, which cycles on level lvl of the
+ *  hierarchy with x and b of that level.
+ *
+ */
+template<class I, class T, class F>
+void multigrid_cycle_level(const I levels[],
+                           const I n_levels,
+                           const I lvl,
+                           const I index[],
+                           const T data[],
+                                 T work[],
+                                 T x[],
+                           const T b[],
+                           const I cycle)
+{
+    const I * level = levels + lvl*CYCLE_LEVEL_SIZE;
+    const I * coarse = level + CYCLE_LEVEL_SIZE;
+    const I n = level[CYCLE_N];
+    const I nc = coarse[CYCLE_N];
+    const I bs = level[CYCLE_A_BS];
+    const I n_brow = (bs == 0) ? n : n / bs;
+
+    T * temp = work + level[CYCLE_WORK] + 2*n;
+    T * coarse_x = work + coarse[CYCLE_WORK];
+    T * coarse_b = coarse_x + nc;
+
+    multigrid_cycle_smooth<I, T, F>(level, level[CYCLE_PRE], level[CYCLE_PRE + 1],
+                                    level[CYCLE_PRE + 2], index, data, x, b, temp);
+
+    // coarse_b = R (b - A x)
+    {
+        const I * Ap = index + level[CYCLE_A_P];
+        const I * Aj = index + level[CYCLE_A_J];
+        const T * Ax = data + level[CYCLE_A_X];
+        const I * Tp = index + level[CYCLE_T_P];
+        const I * Tj = index + level[CYCLE_T_J];
+        const T * Tx = data + level[CYCLE_T_X];
+        const I A_nnz = Ap[n_brow];
+        const I T_nnz = Tp[n_brow];
+
+        if (bs == 0) {
+            csr_residual_restrict<I, T>(Ap, n_brow + 1, Aj, A_nnz, Ax, A_nnz,
+                                        x, n, b, n, Tp, n_brow + 1, Tj, T_nnz,
+                                        Tx, T_nnz, coarse_b, nc);
+        } else {
+            const I T_bs = level[CYCLE_T_BS];
+            bsr_residual_restrict<I, T>(Ap, n_brow + 1, Aj, A_nnz, Ax,
+                                        A_nnz*bs*bs, x, n, b, n, Tp, n_brow + 1,
+                                        Tj, T_nnz, Tx, T_nnz*bs*T_bs,
+                                        coarse_b, nc, bs, T_bs);
+        }
+    }
+
+    std::fill(coarse_x, coarse_x + nc, (T) 0.0);
+
+    if (lvl + 2 == n_levels) {
+        multigrid_cycle_coarse_solve<I, T>(coarse, index, data, coarse_x, coarse_b);
+    }
+    else if (cycle == CYCLE_W) {
+        multigrid_cycle_level<I, T, F>(levels, n_levels, lvl + 1, index, data, work,
+                                       coarse_x, coarse_b, CYCLE_W);
+        multigrid_cycle_level<I, T, F>(levels, n_levels, lvl + 1, index, data, work,
+                                       coarse_x, coarse_b, CYCLE_W);
+    }
+    else if (cycle == CYCLE_F) {
+        multigrid_cycle_level<I, T, F>(levels, n_levels, lvl + 1, index, data, work,
+                                       coarse_x, coarse_b, CYCLE_F);
+        multigrid_cycle_level<I, T, F>(levels, n_levels, lvl + 1, index, data, work,
+                                       coarse_x, coarse_b, CYCLE_V);
+    }
+    else {
+        multigrid_cycle_level<I, T, F>(levels, n_levels, lvl + 1, index, data, work,
+                                       coarse_x, coarse_b, CYCLE_V);
+    }
+
+    // x += P coarse_x
+    {
+        const I P_brow = level[CYCLE_P_BROW];
+        const I P_bcol = level[CYCLE_P_BCOL];
+        const I * Pp = index + level[CYCLE_P_P];
+        const I * Pj = index + level[CYCLE_P_J];
+        const T * Px = data + level[CYCLE_P_X];
+
+        if (P_brow == 0) {
+            const I P_nnz = Pp[n];
+            csr_prolongate_add<I, T>(Pp, n + 1, Pj, P_nnz, Px, P_nnz,
+                                     coarse_x, nc, x, n);
+        } else {
+            const I P_nbrow = n / P_brow;
+            const I P_nnz = Pp[P_nbrow];
+            bsr_prolongate_add<I, T>(Pp, P_nbrow + 1, Pj, P_nnz, Px,
+                                     P_nnz*P_brow*P_bcol, coarse_x, nc, x, n,
+                                     P_brow, P_bcol);
+        }
+    }
+
+    multigrid_cycle_smooth<I, T, F>(level, level[CYCLE_POST], level[CYCLE_POST + 1],
+                                    level[CYCLE_POST + 2], index, data, x, b, temp);
+}
+
+
+/*
+ *  Perform one multigrid cycle for A x = b on a whole hierarchy, i.e.,
+ *  presmoothing, the restriction of the residual, the coarse grid
+ *  correction, and postsmoothing on each level, as
+ *  multilevel_solver.solve does in Python, but without returning to
+ *  Python between the levels.
+ *
+ *  The hierarchy has levels_size / CYCLE_LEVEL_SIZE levels, which are
+ *  described by levels[] as laid out above.  The last level is solved
+ *  directly.  The operations of each level are those of the kernels
+ *  gauss_seidel, jacobi (or their BSR counterparts),
+ *  csr/bsr_residual_restrict, and csr/bsr_prolongate_add, in the same
+ *  order as in Python, so that the result agrees with the Python cycle
+ *  up to the rounding of the coarse solve.
+ *
+ *  Parameters
+ *      levels[]  - level descriptors, CYCLE_LEVEL_SIZE for each level
+ *      index[]   - row pointers and indices of the level matrices, and
+ *                  the pivots of the coarse factorization
+ *      data[]    - values of the level matrices, the Jacobi weights,
+ *                  and the dense coarse factorization (row major)
+ *      work[]    - workspace, 3 n for each level of n unknowns, at the
+ *                  offsets CYCLE_WORK of the descriptors
+ *      x[]       - approximate solution on the first level
+ *      b[]       - right hand side on the first level
+ *      cycle     - CYCLE_V, CYCLE_W, or CYCLE_F
+ *
+ *  Returns:
+ *      Nothing, x will be modified in place
+ *
+ *  Notes:
+ *      Only the smoothers, matrix formats and coarse solvers listed
+ *      above are supported natively.  multilevel_solver falls back to
+ *      the Python cycle for any other hierarchy.
+ *
+ */
+template<class I, class T, class F>
+void multigrid_cycle(const I levels[], const int levels_size,
+                     const I index[], const int index_size,
+                     const T data[], const int data_size,
+                           T work[], const int work_size,
+                           T x[], const int x_size,
+                     const T b[], const int b_size,
+                     const I cycle)
+{
+    const I n_levels = levels_size / CYCLE_LEVEL_SIZE;
 
+    if (n_levels == 1) {
+        multigrid_cycle_coarse_solve<I, T>(levels, index, data, x, b);
+        return;
     }
 
-    delete[] rsum;
-    delete[] Dinv_rsum;
+    multigrid_cycle_level<I, T, F>(levels, n_levels, 0, index, data, work, x, b,
+                                   cycle);
 }
 
+// the definitions of the functions that dispatch on the blocksize
+#include "relaxation_dispatch.h"
 
 #endif
@@ -4,17 +4,20 @@
 #include <pybind11/numpy.h>
 #include <pybind11/complex.h>
 
+#include "bind_arrays.h"
+#include "bind_threads.h"
+#include "bind_timers.h"
 #include "relaxation.h"
 
 namespace py = pybind11;
 
 template<class I, class T, class F>
 void _gauss_seidel(
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
-      py::array_t<T> & Ax,
-       py::array_t<T> & x,
-       py::array_t<T> & b,
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      output_array<T> & x,
+       input_array<T> & b,
         const I row_start,
          const I row_stop,
          const I row_step
@@ -30,13 +33,22 @@ void _gauss_seidel(
     const T *_Ax = py_Ax.data();
     T *_x = py_x.mutable_data();
     const T *_b = py_b.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int b_size = array_size(b.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("gauss_seidel");
 
     return gauss_seidel<I, T, F>(
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
-                      _Ax, Ax.shape(0),
-                       _x, x.shape(0),
-                       _b, b.shape(0),
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _b, b_size,
                 row_start,
                  row_stop,
                  row_step
@@ -45,11 +57,11 @@ void _gauss_seidel(
 
 template<class I, class T, class F>
 void _bsr_gauss_seidel(
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
-      py::array_t<T> & Ax,
-       py::array_t<T> & x,
-       py::array_t<T> & b,
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      output_array<T> & x,
+       input_array<T> & b,
         const I row_start,
          const I row_stop,
          const I row_step,
@@ -66,13 +78,22 @@ void _bsr_gauss_seidel(
     const T *_Ax = py_Ax.data();
     T *_x = py_x.mutable_data();
     const T *_b = py_b.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int b_size = array_size(b.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("bsr_gauss_seidel");
 
     return bsr_gauss_seidel<I, T, F>(
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
-                      _Ax, Ax.shape(0),
-                       _x, x.shape(0),
-                       _b, b.shape(0),
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _b, b_size,
                 row_start,
                  row_stop,
                  row_step,
@@ -80,18 +101,230 @@ void _bsr_gauss_seidel(
                                      );
 }
 
+template<class I, class T, class F>
+void _bsr_gauss_seidel_generic(
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      output_array<T> & x,
+       input_array<T> & b,
+        const I row_start,
+         const I row_stop,
+         const I row_step,
+        const I blocksize
+                               )
+{
+    auto py_Ap = Ap.unchecked();
+    auto py_Aj = Aj.unchecked();
+    auto py_Ax = Ax.unchecked();
+    auto py_x = x.mutable_unchecked();
+    auto py_b = b.unchecked();
+    const I *_Ap = py_Ap.data();
+    const I *_Aj = py_Aj.data();
+    const T *_Ax = py_Ax.data();
+    T *_x = py_x.mutable_data();
+    const T *_b = py_b.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int b_size = array_size(b.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("bsr_gauss_seidel_generic");
+
+    return bsr_gauss_seidel_impl<I, T, F, 0>(
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _b, b_size,
+                row_start,
+                 row_stop,
+                 row_step,
+                blocksize
+                                             );
+}
+
+template<class I, class T, class F>
+void _gauss_seidel_multicolor(
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      output_array<T> & x,
+       input_array<T> & b,
+input_array<I> & color_ptr,
+input_array<I> & color_rows,
+      const I color_start,
+       const I color_stop,
+       const I color_step
+                              )
+{
+    auto py_Ap = Ap.unchecked();
+    auto py_Aj = Aj.unchecked();
+    auto py_Ax = Ax.unchecked();
+    auto py_x = x.mutable_unchecked();
+    auto py_b = b.unchecked();
+    auto py_color_ptr = color_ptr.unchecked();
+    auto py_color_rows = color_rows.unchecked();
+    const I *_Ap = py_Ap.data();
+    const I *_Aj = py_Aj.data();
+    const T *_Ax = py_Ax.data();
+    T *_x = py_x.mutable_data();
+    const T *_b = py_b.data();
+    const I *_color_ptr = py_color_ptr.data();
+    const I *_color_rows = py_color_rows.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int b_size = array_size(b.shape(0));
+    int color_ptr_size = array_size(color_ptr.shape(0));
+    int color_rows_size = array_size(color_rows.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("gauss_seidel_multicolor");
+
+    return gauss_seidel_multicolor<I, T, F>(
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _b, b_size,
+               _color_ptr, color_ptr_size,
+              _color_rows, color_rows_size,
+              color_start,
+               color_stop,
+               color_step
+                                            );
+}
+
+template<class I, class T, class F>
+void _bsr_gauss_seidel_multicolor(
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      output_array<T> & x,
+       input_array<T> & b,
+input_array<I> & color_ptr,
+input_array<I> & color_rows,
+      const I color_start,
+       const I color_stop,
+       const I color_step,
+        const I blocksize
+                                  )
+{
+    auto py_Ap = Ap.unchecked();
+    auto py_Aj = Aj.unchecked();
+    auto py_Ax = Ax.unchecked();
+    auto py_x = x.mutable_unchecked();
+    auto py_b = b.unchecked();
+    auto py_color_ptr = color_ptr.unchecked();
+    auto py_color_rows = color_rows.unchecked();
+    const I *_Ap = py_Ap.data();
+    const I *_Aj = py_Aj.data();
+    const T *_Ax = py_Ax.data();
+    T *_x = py_x.mutable_data();
+    const T *_b = py_b.data();
+    const I *_color_ptr = py_color_ptr.data();
+    const I *_color_rows = py_color_rows.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int b_size = array_size(b.shape(0));
+    int color_ptr_size = array_size(color_ptr.shape(0));
+    int color_rows_size = array_size(color_rows.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("bsr_gauss_seidel_multicolor");
+
+    return bsr_gauss_seidel_multicolor<I, T, F>(
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _b, b_size,
+               _color_ptr, color_ptr_size,
+              _color_rows, color_rows_size,
+              color_start,
+               color_stop,
+               color_step,
+                blocksize
+                                                );
+}
+
+template<class I, class T, class F>
+void _bsr_gauss_seidel_multicolor_generic(
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      output_array<T> & x,
+       input_array<T> & b,
+input_array<I> & color_ptr,
+input_array<I> & color_rows,
+      const I color_start,
+       const I color_stop,
+       const I color_step,
+        const I blocksize
+                                          )
+{
+    auto py_Ap = Ap.unchecked();
+    auto py_Aj = Aj.unchecked();
+    auto py_Ax = Ax.unchecked();
+    auto py_x = x.mutable_unchecked();
+    auto py_b = b.unchecked();
+    auto py_color_ptr = color_ptr.unchecked();
+    auto py_color_rows = color_rows.unchecked();
+    const I *_Ap = py_Ap.data();
+    const I *_Aj = py_Aj.data();
+    const T *_Ax = py_Ax.data();
+    T *_x = py_x.mutable_data();
+    const T *_b = py_b.data();
+    const I *_color_ptr = py_color_ptr.data();
+    const I *_color_rows = py_color_rows.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int b_size = array_size(b.shape(0));
+    int color_ptr_size = array_size(color_ptr.shape(0));
+    int color_rows_size = array_size(color_rows.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("bsr_gauss_seidel_multicolor_generic");
+
+    return bsr_gauss_seidel_multicolor_impl<I, T, F, 0>(
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _b, b_size,
+               _color_ptr, color_ptr_size,
+              _color_rows, color_rows_size,
+              color_start,
+               color_stop,
+               color_step,
+                blocksize
+                                                        );
+}
+
 template<class I, class T, class F>
 void _jacobi(
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
-      py::array_t<T> & Ax,
-       py::array_t<T> & x,
-       py::array_t<T> & b,
-    py::array_t<T> & temp,
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      output_array<T> & x,
+       input_array<T> & b,
+   output_array<T> & temp,
         const I row_start,
          const I row_stop,
          const I row_step,
-   py::array_t<T> & omega
+   input_array<T> & omega
              )
 {
     auto py_Ap = Ap.unchecked();
@@ -108,34 +341,45 @@ void _jacobi(
     const T *_b = py_b.data();
     T *_temp = py_temp.mutable_data();
     const T *_omega = py_omega.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int b_size = array_size(b.shape(0));
+    int temp_size = array_size(temp.shape(0));
+    int omega_size = array_size(omega.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("jacobi");
 
     return jacobi<I, T, F>(
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
-                      _Ax, Ax.shape(0),
-                       _x, x.shape(0),
-                       _b, b.shape(0),
-                    _temp, temp.shape(0),
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _b, b_size,
+                    _temp, temp_size,
                 row_start,
                  row_stop,
                  row_step,
-                   _omega, omega.shape(0)
+                   _omega, omega_size
                            );
 }
 
 template<class I, class T, class F>
 void _bsr_jacobi(
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
-      py::array_t<T> & Ax,
-       py::array_t<T> & x,
-       py::array_t<T> & b,
-    py::array_t<T> & temp,
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      output_array<T> & x,
+       input_array<T> & b,
+   output_array<T> & temp,
         const I row_start,
          const I row_stop,
          const I row_step,
         const I blocksize,
-   py::array_t<T> & omega
+   input_array<T> & omega
                  )
 {
     auto py_Ap = Ap.unchecked();
@@ -152,30 +396,251 @@ void _bsr_jacobi(
     const T *_b = py_b.data();
     T *_temp = py_temp.mutable_data();
     const T *_omega = py_omega.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int b_size = array_size(b.shape(0));
+    int temp_size = array_size(temp.shape(0));
+    int omega_size = array_size(omega.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("bsr_jacobi");
 
     return bsr_jacobi<I, T, F>(
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
-                      _Ax, Ax.shape(0),
-                       _x, x.shape(0),
-                       _b, b.shape(0),
-                    _temp, temp.shape(0),
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _b, b_size,
+                    _temp, temp_size,
                 row_start,
                  row_stop,
                  row_step,
                 blocksize,
-                   _omega, omega.shape(0)
+                   _omega, omega_size
                                );
 }
 
+template<class I, class T, class F>
+void _bsr_jacobi_generic(
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      output_array<T> & x,
+       input_array<T> & b,
+   output_array<T> & temp,
+        const I row_start,
+         const I row_stop,
+         const I row_step,
+        const I blocksize,
+   input_array<T> & omega
+                         )
+{
+    auto py_Ap = Ap.unchecked();
+    auto py_Aj = Aj.unchecked();
+    auto py_Ax = Ax.unchecked();
+    auto py_x = x.mutable_unchecked();
+    auto py_b = b.unchecked();
+    auto py_temp = temp.mutable_unchecked();
+    auto py_omega = omega.unchecked();
+    const I *_Ap = py_Ap.data();
+    const I *_Aj = py_Aj.data();
+    const T *_Ax = py_Ax.data();
+    T *_x = py_x.mutable_data();
+    const T *_b = py_b.data();
+    T *_temp = py_temp.mutable_data();
+    const T *_omega = py_omega.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int b_size = array_size(b.shape(0));
+    int temp_size = array_size(temp.shape(0));
+    int omega_size = array_size(omega.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("bsr_jacobi_generic");
+
+    return bsr_jacobi_impl<I, T, F, 0>(
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _b, b_size,
+                    _temp, temp_size,
+                row_start,
+                 row_stop,
+                 row_step,
+                blocksize,
+                   _omega, omega_size
+                                       );
+}
+
+template<class I, class T, class F>
+void _polynomial(
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      output_array<T> & x,
+       input_array<T> & b,
+   output_array<T> & temp,
+input_array<T> & coefficients,
+       const I zero_guess
+                 )
+{
+    auto py_Ap = Ap.unchecked();
+    auto py_Aj = Aj.unchecked();
+    auto py_Ax = Ax.unchecked();
+    auto py_x = x.mutable_unchecked();
+    auto py_b = b.unchecked();
+    auto py_temp = temp.mutable_unchecked();
+    auto py_coefficients = coefficients.unchecked();
+    const I *_Ap = py_Ap.data();
+    const I *_Aj = py_Aj.data();
+    const T *_Ax = py_Ax.data();
+    T *_x = py_x.mutable_data();
+    const T *_b = py_b.data();
+    T *_temp = py_temp.mutable_data();
+    const T *_coefficients = py_coefficients.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int b_size = array_size(b.shape(0));
+    int temp_size = array_size(temp.shape(0));
+    int coefficients_size = array_size(coefficients.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("polynomial");
+
+    return polynomial<I, T, F>(
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _b, b_size,
+                    _temp, temp_size,
+            _coefficients, coefficients_size,
+               zero_guess
+                               );
+}
+
+template<class I, class T, class F>
+void _bsr_polynomial(
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      output_array<T> & x,
+       input_array<T> & b,
+   output_array<T> & temp,
+input_array<T> & coefficients,
+       const I zero_guess,
+        const I blocksize
+                     )
+{
+    auto py_Ap = Ap.unchecked();
+    auto py_Aj = Aj.unchecked();
+    auto py_Ax = Ax.unchecked();
+    auto py_x = x.mutable_unchecked();
+    auto py_b = b.unchecked();
+    auto py_temp = temp.mutable_unchecked();
+    auto py_coefficients = coefficients.unchecked();
+    const I *_Ap = py_Ap.data();
+    const I *_Aj = py_Aj.data();
+    const T *_Ax = py_Ax.data();
+    T *_x = py_x.mutable_data();
+    const T *_b = py_b.data();
+    T *_temp = py_temp.mutable_data();
+    const T *_coefficients = py_coefficients.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int b_size = array_size(b.shape(0));
+    int temp_size = array_size(temp.shape(0));
+    int coefficients_size = array_size(coefficients.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("bsr_polynomial");
+
+    return bsr_polynomial<I, T, F>(
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _b, b_size,
+                    _temp, temp_size,
+            _coefficients, coefficients_size,
+               zero_guess,
+                blocksize
+                                   );
+}
+
+template<class I, class T, class F>
+void _bsr_polynomial_generic(
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      output_array<T> & x,
+       input_array<T> & b,
+   output_array<T> & temp,
+input_array<T> & coefficients,
+       const I zero_guess,
+        const I blocksize
+                             )
+{
+    auto py_Ap = Ap.unchecked();
+    auto py_Aj = Aj.unchecked();
+    auto py_Ax = Ax.unchecked();
+    auto py_x = x.mutable_unchecked();
+    auto py_b = b.unchecked();
+    auto py_temp = temp.mutable_unchecked();
+    auto py_coefficients = coefficients.unchecked();
+    const I *_Ap = py_Ap.data();
+    const I *_Aj = py_Aj.data();
+    const T *_Ax = py_Ax.data();
+    T *_x = py_x.mutable_data();
+    const T *_b = py_b.data();
+    T *_temp = py_temp.mutable_data();
+    const T *_coefficients = py_coefficients.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int b_size = array_size(b.shape(0));
+    int temp_size = array_size(temp.shape(0));
+    int coefficients_size = array_size(coefficients.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("bsr_polynomial_generic");
+
+    return bsr_polynomial_impl<I, T, F, 0>(
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _b, b_size,
+                    _temp, temp_size,
+            _coefficients, coefficients_size,
+               zero_guess,
+                blocksize
+                                           );
+}
+
 template<class I, class T, class F>
 void _gauss_seidel_indexed(
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
-      py::array_t<T> & Ax,
-       py::array_t<T> & x,
-       py::array_t<T> & b,
-      py::array_t<I> & Id,
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      output_array<T> & x,
+       input_array<T> & b,
+      input_array<I> & Id,
         const I row_start,
          const I row_stop,
          const I row_step
@@ -193,14 +658,24 @@ void _gauss_seidel_indexed(
     T *_x = py_x.mutable_data();
     const T *_b = py_b.data();
     const I *_Id = py_Id.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int b_size = array_size(b.shape(0));
+    int Id_size = array_size(Id.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("gauss_seidel_indexed");
 
     return gauss_seidel_indexed<I, T, F>(
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
-                      _Ax, Ax.shape(0),
-                       _x, x.shape(0),
-                       _b, b.shape(0),
-                      _Id, Id.shape(0),
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _b, b_size,
+                      _Id, Id_size,
                 row_start,
                  row_stop,
                  row_step
@@ -209,17 +684,17 @@ void _gauss_seidel_indexed(
 
 template<class I, class T, class F>
 void _jacobi_ne(
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
-      py::array_t<T> & Ax,
-       py::array_t<T> & x,
-       py::array_t<T> & b,
-      py::array_t<T> & Tx,
-    py::array_t<T> & temp,
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      output_array<T> & x,
+       input_array<T> & b,
+      input_array<T> & Tx,
+   output_array<T> & temp,
         const I row_start,
          const I row_stop,
          const I row_step,
-   py::array_t<T> & omega
+   input_array<T> & omega
                 )
 {
     auto py_Ap = Ap.unchecked();
@@ -238,33 +713,45 @@ void _jacobi_ne(
     const T *_Tx = py_Tx.data();
     T *_temp = py_temp.mutable_data();
     const T *_omega = py_omega.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int b_size = array_size(b.shape(0));
+    int Tx_size = array_size(Tx.shape(0));
+    int temp_size = array_size(temp.shape(0));
+    int omega_size = array_size(omega.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("jacobi_ne");
 
     return jacobi_ne<I, T, F>(
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
-                      _Ax, Ax.shape(0),
-                       _x, x.shape(0),
-                       _b, b.shape(0),
-                      _Tx, Tx.shape(0),
-                    _temp, temp.shape(0),
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _b, b_size,
+                      _Tx, Tx_size,
+                    _temp, temp_size,
                 row_start,
                  row_stop,
                  row_step,
-                   _omega, omega.shape(0)
+                   _omega, omega_size
                               );
 }
 
 template<class I, class T, class F>
 void _gauss_seidel_ne(
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
-      py::array_t<T> & Ax,
-       py::array_t<T> & x,
-       py::array_t<T> & b,
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      output_array<T> & x,
+       input_array<T> & b,
         const I row_start,
          const I row_stop,
          const I row_step,
-      py::array_t<T> & Tx,
+      input_array<T> & Tx,
             const F omega
                       )
 {
@@ -280,32 +767,42 @@ void _gauss_seidel_ne(
     T *_x = py_x.mutable_data();
     const T *_b = py_b.data();
     const T *_Tx = py_Tx.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int b_size = array_size(b.shape(0));
+    int Tx_size = array_size(Tx.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("gauss_seidel_ne");
 
     return gauss_seidel_ne<I, T, F>(
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
-                      _Ax, Ax.shape(0),
-                       _x, x.shape(0),
-                       _b, b.shape(0),
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _b, b_size,
                 row_start,
                  row_stop,
                  row_step,
-                      _Tx, Tx.shape(0),
+                      _Tx, Tx_size,
                     omega
                                     );
 }
 
 template<class I, class T, class F>
 void _gauss_seidel_nr(
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
-      py::array_t<T> & Ax,
-       py::array_t<T> & x,
-       py::array_t<T> & z,
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      output_array<T> & x,
+      output_array<T> & z,
         const I col_start,
          const I col_stop,
          const I col_step,
-      py::array_t<T> & Tx,
+      input_array<T> & Tx,
             const F omega
                       )
 {
@@ -321,34 +818,44 @@ void _gauss_seidel_nr(
     T *_x = py_x.mutable_data();
     T *_z = py_z.mutable_data();
     const T *_Tx = py_Tx.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int z_size = array_size(z.shape(0));
+    int Tx_size = array_size(Tx.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("gauss_seidel_nr");
 
     return gauss_seidel_nr<I, T, F>(
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
-                      _Ax, Ax.shape(0),
-                       _x, x.shape(0),
-                       _z, z.shape(0),
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _z, z_size,
                 col_start,
                  col_stop,
                  col_step,
-                      _Tx, Tx.shape(0),
+                      _Tx, Tx_size,
                     omega
                                     );
 }
 
 template<class I, class T, class F>
 void _block_jacobi(
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
-      py::array_t<T> & Ax,
-       py::array_t<T> & x,
-       py::array_t<T> & b,
-      py::array_t<T> & Tx,
-    py::array_t<T> & temp,
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      output_array<T> & x,
+       input_array<T> & b,
+      input_array<T> & Tx,
+   output_array<T> & temp,
         const I row_start,
          const I row_stop,
          const I row_step,
-   py::array_t<T> & omega,
+   input_array<T> & omega,
         const I blocksize
                    )
 {
@@ -368,31 +875,104 @@ void _block_jacobi(
     const T *_Tx = py_Tx.data();
     T *_temp = py_temp.mutable_data();
     const T *_omega = py_omega.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int b_size = array_size(b.shape(0));
+    int Tx_size = array_size(Tx.shape(0));
+    int temp_size = array_size(temp.shape(0));
+    int omega_size = array_size(omega.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("block_jacobi");
 
     return block_jacobi<I, T, F>(
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
-                      _Ax, Ax.shape(0),
-                       _x, x.shape(0),
-                       _b, b.shape(0),
-                      _Tx, Tx.shape(0),
-                    _temp, temp.shape(0),
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _b, b_size,
+                      _Tx, Tx_size,
+                    _temp, temp_size,
                 row_start,
                  row_stop,
                  row_step,
-                   _omega, omega.shape(0),
+                   _omega, omega_size,
                 blocksize
                                  );
 }
 
+template<class I, class T, class F>
+void _block_jacobi_generic(
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      output_array<T> & x,
+       input_array<T> & b,
+      input_array<T> & Tx,
+   output_array<T> & temp,
+        const I row_start,
+         const I row_stop,
+         const I row_step,
+   input_array<T> & omega,
+        const I blocksize
+                           )
+{
+    auto py_Ap = Ap.unchecked();
+    auto py_Aj = Aj.unchecked();
+    auto py_Ax = Ax.unchecked();
+    auto py_x = x.mutable_unchecked();
+    auto py_b = b.unchecked();
+    auto py_Tx = Tx.unchecked();
+    auto py_temp = temp.mutable_unchecked();
+    auto py_omega = omega.unchecked();
+    const I *_Ap = py_Ap.data();
+    const I *_Aj = py_Aj.data();
+    const T *_Ax = py_Ax.data();
+    T *_x = py_x.mutable_data();
+    const T *_b = py_b.data();
+    const T *_Tx = py_Tx.data();
+    T *_temp = py_temp.mutable_data();
+    const T *_omega = py_omega.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int b_size = array_size(b.shape(0));
+    int Tx_size = array_size(Tx.shape(0));
+    int temp_size = array_size(temp.shape(0));
+    int omega_size = array_size(omega.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("block_jacobi_generic");
+
+    return block_jacobi_impl<I, T, F, 0>(
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _b, b_size,
+                      _Tx, Tx_size,
+                    _temp, temp_size,
+                row_start,
+                 row_stop,
+                 row_step,
+                   _omega, omega_size,
+                blocksize
+                                         );
+}
+
 template<class I, class T, class F>
 void _block_gauss_seidel(
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
-      py::array_t<T> & Ax,
-       py::array_t<T> & x,
-       py::array_t<T> & b,
-      py::array_t<T> & Tx,
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      output_array<T> & x,
+       input_array<T> & b,
+      input_array<T> & Tx,
         const I row_start,
          const I row_stop,
          const I row_step,
@@ -411,14 +991,24 @@ void _block_gauss_seidel(
     T *_x = py_x.mutable_data();
     const T *_b = py_b.data();
     const T *_Tx = py_Tx.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int b_size = array_size(b.shape(0));
+    int Tx_size = array_size(Tx.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("block_gauss_seidel");
 
     return block_gauss_seidel<I, T, F>(
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
-                      _Ax, Ax.shape(0),
-                       _x, x.shape(0),
-                       _b, b.shape(0),
-                      _Tx, Tx.shape(0),
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _b, b_size,
+                      _Tx, Tx_size,
                 row_start,
                  row_stop,
                  row_step,
@@ -426,15 +1016,66 @@ void _block_gauss_seidel(
                                        );
 }
 
+template<class I, class T, class F>
+void _block_gauss_seidel_generic(
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      output_array<T> & x,
+       input_array<T> & b,
+      input_array<T> & Tx,
+        const I row_start,
+         const I row_stop,
+         const I row_step,
+        const I blocksize
+                                 )
+{
+    auto py_Ap = Ap.unchecked();
+    auto py_Aj = Aj.unchecked();
+    auto py_Ax = Ax.unchecked();
+    auto py_x = x.mutable_unchecked();
+    auto py_b = b.unchecked();
+    auto py_Tx = Tx.unchecked();
+    const I *_Ap = py_Ap.data();
+    const I *_Aj = py_Aj.data();
+    const T *_Ax = py_Ax.data();
+    T *_x = py_x.mutable_data();
+    const T *_b = py_b.data();
+    const T *_Tx = py_Tx.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int b_size = array_size(b.shape(0));
+    int Tx_size = array_size(Tx.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("block_gauss_seidel_generic");
+
+    return block_gauss_seidel_impl<I, T, F, 0>(
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _b, b_size,
+                      _Tx, Tx_size,
+                row_start,
+                 row_stop,
+                 row_step,
+                blocksize
+                                               );
+}
+
 template<class I, class T, class F>
 void _extract_subblocks(
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
-      py::array_t<T> & Ax,
-      py::array_t<T> & Tx,
-      py::array_t<I> & Tp,
-      py::array_t<I> & Sj,
-      py::array_t<I> & Sp,
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+     output_array<T> & Tx,
+      input_array<I> & Tp,
+      input_array<I> & Sj,
+      input_array<I> & Sp,
         const I nsdomains,
             const I nrows
                         )
@@ -453,73 +1094,985 @@ void _extract_subblocks(
     const I *_Tp = py_Tp.data();
     const I *_Sj = py_Sj.data();
     const I *_Sp = py_Sp.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int Tx_size = array_size(Tx.shape(0));
+    int Tp_size = array_size(Tp.shape(0));
+    int Sj_size = array_size(Sj.shape(0));
+    int Sp_size = array_size(Sp.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("extract_subblocks");
 
     return extract_subblocks<I, T, F>(
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
-                      _Ax, Ax.shape(0),
-                      _Tx, Tx.shape(0),
-                      _Tp, Tp.shape(0),
-                      _Sj, Sj.shape(0),
-                      _Sp, Sp.shape(0),
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                      _Tx, Tx_size,
+                      _Tp, Tp_size,
+                      _Sj, Sj_size,
+                      _Sp, Sp_size,
                 nsdomains,
                     nrows
                                       );
 }
 
-template<class I, class T, class F>
-void _overlapping_schwarz_csr(
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
-      py::array_t<T> & Ax,
-       py::array_t<T> & x,
-       py::array_t<T> & b,
-      py::array_t<T> & Tx,
-      py::array_t<I> & Tp,
-      py::array_t<I> & Sj,
-      py::array_t<I> & Sp,
-              I nsdomains,
-                  I nrows,
-              I row_start,
-               I row_stop,
-               I row_step
-                              )
+template<class I, class T, class F>
+void _overlapping_schwarz_csr(
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      output_array<T> & x,
+       input_array<T> & b,
+      input_array<T> & Tx,
+      input_array<I> & Tp,
+      input_array<I> & Sj,
+      input_array<I> & Sp,
+              I nsdomains,
+                  I nrows,
+              I row_start,
+               I row_stop,
+               I row_step,
+output_array<T> & workspace
+                              )
+{
+    auto py_Ap = Ap.unchecked();
+    auto py_Aj = Aj.unchecked();
+    auto py_Ax = Ax.unchecked();
+    auto py_x = x.mutable_unchecked();
+    auto py_b = b.unchecked();
+    auto py_Tx = Tx.unchecked();
+    auto py_Tp = Tp.unchecked();
+    auto py_Sj = Sj.unchecked();
+    auto py_Sp = Sp.unchecked();
+    auto py_workspace = workspace.mutable_unchecked();
+    const I *_Ap = py_Ap.data();
+    const I *_Aj = py_Aj.data();
+    const T *_Ax = py_Ax.data();
+    T *_x = py_x.mutable_data();
+    const T *_b = py_b.data();
+    const T *_Tx = py_Tx.data();
+    const I *_Tp = py_Tp.data();
+    const I *_Sj = py_Sj.data();
+    const I *_Sp = py_Sp.data();
+    T *_workspace = py_workspace.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int b_size = array_size(b.shape(0));
+    int Tx_size = array_size(Tx.shape(0));
+    int Tp_size = array_size(Tp.shape(0));
+    int Sj_size = array_size(Sj.shape(0));
+    int Sp_size = array_size(Sp.shape(0));
+    int workspace_size = array_size(workspace.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("overlapping_schwarz_csr");
+
+    return overlapping_schwarz_csr<I, T, F>(
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _b, b_size,
+                      _Tx, Tx_size,
+                      _Tp, Tp_size,
+                      _Sj, Sj_size,
+                      _Sp, Sp_size,
+                nsdomains,
+                    nrows,
+                row_start,
+                 row_stop,
+                 row_step,
+               _workspace, workspace_size
+                                            );
+}
+
+template<class I, class T, class F>
+I _schwarz_factor(
+     output_array<T> & Tx,
+      input_array<I> & Tp,
+      input_array<I> & Sp,
+   output_array<I> & Tpiv,
+        const I nsdomains,
+              const F tol
+                  )
+{
+    auto py_Tx = Tx.mutable_unchecked();
+    auto py_Tp = Tp.unchecked();
+    auto py_Sp = Sp.unchecked();
+    auto py_Tpiv = Tpiv.mutable_unchecked();
+    T *_Tx = py_Tx.mutable_data();
+    const I *_Tp = py_Tp.data();
+    const I *_Sp = py_Sp.data();
+    I *_Tpiv = py_Tpiv.mutable_data();
+    int Tx_size = array_size(Tx.shape(0));
+    int Tp_size = array_size(Tp.shape(0));
+    int Sp_size = array_size(Sp.shape(0));
+    int Tpiv_size = array_size(Tpiv.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("schwarz_factor");
+
+    return schwarz_factor<I, T, F>(
+                      _Tx, Tx_size,
+                      _Tp, Tp_size,
+                      _Sp, Sp_size,
+                    _Tpiv, Tpiv_size,
+                nsdomains,
+                      tol
+                                   );
+}
+
+template<class I, class T, class F>
+void _overlapping_schwarz_lu_csr(
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      output_array<T> & x,
+       input_array<T> & b,
+      input_array<T> & Tx,
+      input_array<I> & Tp,
+    input_array<I> & Tpiv,
+      input_array<I> & Sj,
+      input_array<I> & Sp,
+        const I row_start,
+         const I row_stop,
+         const I row_step,
+output_array<T> & workspace
+                                 )
+{
+    auto py_Ap = Ap.unchecked();
+    auto py_Aj = Aj.unchecked();
+    auto py_Ax = Ax.unchecked();
+    auto py_x = x.mutable_unchecked();
+    auto py_b = b.unchecked();
+    auto py_Tx = Tx.unchecked();
+    auto py_Tp = Tp.unchecked();
+    auto py_Tpiv = Tpiv.unchecked();
+    auto py_Sj = Sj.unchecked();
+    auto py_Sp = Sp.unchecked();
+    auto py_workspace = workspace.mutable_unchecked();
+    const I *_Ap = py_Ap.data();
+    const I *_Aj = py_Aj.data();
+    const T *_Ax = py_Ax.data();
+    T *_x = py_x.mutable_data();
+    const T *_b = py_b.data();
+    const T *_Tx = py_Tx.data();
+    const I *_Tp = py_Tp.data();
+    const I *_Tpiv = py_Tpiv.data();
+    const I *_Sj = py_Sj.data();
+    const I *_Sp = py_Sp.data();
+    T *_workspace = py_workspace.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int b_size = array_size(b.shape(0));
+    int Tx_size = array_size(Tx.shape(0));
+    int Tp_size = array_size(Tp.shape(0));
+    int Tpiv_size = array_size(Tpiv.shape(0));
+    int Sj_size = array_size(Sj.shape(0));
+    int Sp_size = array_size(Sp.shape(0));
+    int workspace_size = array_size(workspace.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("overlapping_schwarz_lu_csr");
+
+    return overlapping_schwarz_lu_csr<I, T, F>(
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _b, b_size,
+                      _Tx, Tx_size,
+                      _Tp, Tp_size,
+                    _Tpiv, Tpiv_size,
+                      _Sj, Sj_size,
+                      _Sp, Sp_size,
+                row_start,
+                 row_stop,
+                 row_step,
+               _workspace, workspace_size
+                                               );
+}
+
+template<class I, class T, class F>
+void _overlapping_schwarz_multicolor_csr(
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      output_array<T> & x,
+       input_array<T> & b,
+      input_array<T> & Tx,
+      input_array<I> & Tp,
+    input_array<I> & Tpiv,
+      input_array<I> & Sj,
+      input_array<I> & Sp,
+input_array<I> & color_ptr,
+input_array<I> & color_domains,
+      const I color_start,
+       const I color_stop,
+       const I color_step,
+output_array<T> & workspace
+                                         )
+{
+    auto py_Ap = Ap.unchecked();
+    auto py_Aj = Aj.unchecked();
+    auto py_Ax = Ax.unchecked();
+    auto py_x = x.mutable_unchecked();
+    auto py_b = b.unchecked();
+    auto py_Tx = Tx.unchecked();
+    auto py_Tp = Tp.unchecked();
+    auto py_Tpiv = Tpiv.unchecked();
+    auto py_Sj = Sj.unchecked();
+    auto py_Sp = Sp.unchecked();
+    auto py_color_ptr = color_ptr.unchecked();
+    auto py_color_domains = color_domains.unchecked();
+    auto py_workspace = workspace.mutable_unchecked();
+    const I *_Ap = py_Ap.data();
+    const I *_Aj = py_Aj.data();
+    const T *_Ax = py_Ax.data();
+    T *_x = py_x.mutable_data();
+    const T *_b = py_b.data();
+    const T *_Tx = py_Tx.data();
+    const I *_Tp = py_Tp.data();
+    const I *_Tpiv = py_Tpiv.data();
+    const I *_Sj = py_Sj.data();
+    const I *_Sp = py_Sp.data();
+    const I *_color_ptr = py_color_ptr.data();
+    const I *_color_domains = py_color_domains.data();
+    T *_workspace = py_workspace.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int b_size = array_size(b.shape(0));
+    int Tx_size = array_size(Tx.shape(0));
+    int Tp_size = array_size(Tp.shape(0));
+    int Tpiv_size = array_size(Tpiv.shape(0));
+    int Sj_size = array_size(Sj.shape(0));
+    int Sp_size = array_size(Sp.shape(0));
+    int color_ptr_size = array_size(color_ptr.shape(0));
+    int color_domains_size = array_size(color_domains.shape(0));
+    int workspace_size = array_size(workspace.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("overlapping_schwarz_multicolor_csr");
+
+    return overlapping_schwarz_multicolor_csr<I, T, F>(
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _b, b_size,
+                      _Tx, Tx_size,
+                      _Tp, Tp_size,
+                    _Tpiv, Tpiv_size,
+                      _Sj, Sj_size,
+                      _Sp, Sp_size,
+               _color_ptr, color_ptr_size,
+           _color_domains, color_domains_size,
+              color_start,
+               color_stop,
+               color_step,
+               _workspace, workspace_size
+                                                       );
+}
+
+template<class I, class T>
+void _csr_residual_restrict(
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+       input_array<T> & x,
+       input_array<T> & b,
+      input_array<I> & Tp,
+      input_array<I> & Tj,
+      input_array<T> & Tx,
+output_array<T> & coarse_b
+                            )
+{
+    auto py_Ap = Ap.unchecked();
+    auto py_Aj = Aj.unchecked();
+    auto py_Ax = Ax.unchecked();
+    auto py_x = x.unchecked();
+    auto py_b = b.unchecked();
+    auto py_Tp = Tp.unchecked();
+    auto py_Tj = Tj.unchecked();
+    auto py_Tx = Tx.unchecked();
+    auto py_coarse_b = coarse_b.mutable_unchecked();
+    const I *_Ap = py_Ap.data();
+    const I *_Aj = py_Aj.data();
+    const T *_Ax = py_Ax.data();
+    const T *_x = py_x.data();
+    const T *_b = py_b.data();
+    const I *_Tp = py_Tp.data();
+    const I *_Tj = py_Tj.data();
+    const T *_Tx = py_Tx.data();
+    T *_coarse_b = py_coarse_b.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int b_size = array_size(b.shape(0));
+    int Tp_size = array_size(Tp.shape(0));
+    int Tj_size = array_size(Tj.shape(0));
+    int Tx_size = array_size(Tx.shape(0));
+    int coarse_b_size = array_size(coarse_b.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("csr_residual_restrict");
+
+    return csr_residual_restrict<I, T>(
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _b, b_size,
+                      _Tp, Tp_size,
+                      _Tj, Tj_size,
+                      _Tx, Tx_size,
+                _coarse_b, coarse_b_size
+                                       );
+}
+
+template<class I, class T>
+void _bsr_residual_restrict(
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+       input_array<T> & x,
+       input_array<T> & b,
+      input_array<I> & Tp,
+      input_array<I> & Tj,
+      input_array<T> & Tx,
+output_array<T> & coarse_b,
+        const I blocksize,
+ const I coarse_blocksize
+                            )
+{
+    auto py_Ap = Ap.unchecked();
+    auto py_Aj = Aj.unchecked();
+    auto py_Ax = Ax.unchecked();
+    auto py_x = x.unchecked();
+    auto py_b = b.unchecked();
+    auto py_Tp = Tp.unchecked();
+    auto py_Tj = Tj.unchecked();
+    auto py_Tx = Tx.unchecked();
+    auto py_coarse_b = coarse_b.mutable_unchecked();
+    const I *_Ap = py_Ap.data();
+    const I *_Aj = py_Aj.data();
+    const T *_Ax = py_Ax.data();
+    const T *_x = py_x.data();
+    const T *_b = py_b.data();
+    const I *_Tp = py_Tp.data();
+    const I *_Tj = py_Tj.data();
+    const T *_Tx = py_Tx.data();
+    T *_coarse_b = py_coarse_b.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int b_size = array_size(b.shape(0));
+    int Tp_size = array_size(Tp.shape(0));
+    int Tj_size = array_size(Tj.shape(0));
+    int Tx_size = array_size(Tx.shape(0));
+    int coarse_b_size = array_size(coarse_b.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("bsr_residual_restrict");
+
+    return bsr_residual_restrict<I, T>(
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _b, b_size,
+                      _Tp, Tp_size,
+                      _Tj, Tj_size,
+                      _Tx, Tx_size,
+                _coarse_b, coarse_b_size,
+                blocksize,
+         coarse_blocksize
+                                       );
+}
+
+template<class I, class T>
+void _csr_prolongate_add(
+      input_array<I> & Pp,
+      input_array<I> & Pj,
+      input_array<T> & Px,
+input_array<T> & coarse_x,
+      output_array<T> & x
+                         )
+{
+    auto py_Pp = Pp.unchecked();
+    auto py_Pj = Pj.unchecked();
+    auto py_Px = Px.unchecked();
+    auto py_coarse_x = coarse_x.unchecked();
+    auto py_x = x.mutable_unchecked();
+    const I *_Pp = py_Pp.data();
+    const I *_Pj = py_Pj.data();
+    const T *_Px = py_Px.data();
+    const T *_coarse_x = py_coarse_x.data();
+    T *_x = py_x.mutable_data();
+    int Pp_size = array_size(Pp.shape(0));
+    int Pj_size = array_size(Pj.shape(0));
+    int Px_size = array_size(Px.shape(0));
+    int coarse_x_size = array_size(coarse_x.shape(0));
+    int x_size = array_size(x.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("csr_prolongate_add");
+
+    return csr_prolongate_add<I, T>(
+                      _Pp, Pp_size,
+                      _Pj, Pj_size,
+                      _Px, Px_size,
+                _coarse_x, coarse_x_size,
+                       _x, x_size
+                                    );
+}
+
+template<class I, class T>
+void _bsr_prolongate_add(
+      input_array<I> & Pp,
+      input_array<I> & Pj,
+      input_array<T> & Px,
+input_array<T> & coarse_x,
+      output_array<T> & x,
+        const I blocksize,
+ const I coarse_blocksize
+                         )
+{
+    auto py_Pp = Pp.unchecked();
+    auto py_Pj = Pj.unchecked();
+    auto py_Px = Px.unchecked();
+    auto py_coarse_x = coarse_x.unchecked();
+    auto py_x = x.mutable_unchecked();
+    const I *_Pp = py_Pp.data();
+    const I *_Pj = py_Pj.data();
+    const T *_Px = py_Px.data();
+    const T *_coarse_x = py_coarse_x.data();
+    T *_x = py_x.mutable_data();
+    int Pp_size = array_size(Pp.shape(0));
+    int Pj_size = array_size(Pj.shape(0));
+    int Px_size = array_size(Px.shape(0));
+    int coarse_x_size = array_size(coarse_x.shape(0));
+    int x_size = array_size(x.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("bsr_prolongate_add");
+
+    return bsr_prolongate_add<I, T>(
+                      _Pp, Pp_size,
+                      _Pj, Pj_size,
+                      _Px, Px_size,
+                _coarse_x, coarse_x_size,
+                       _x, x_size,
+                blocksize,
+         coarse_blocksize
+                                    );
+}
+
+template<class I, class T, class F>
+void _gauss_seidel_delta(
+      input_array<I> & Ap,
+      input_array<I> & Ab,
+input_array<unsigned short> & Ad,
+      input_array<T> & Ax,
+      output_array<T> & x,
+       input_array<T> & b,
+        const I row_start,
+         const I row_stop,
+         const I row_step
+                         )
+{
+    auto py_Ap = Ap.unchecked();
+    auto py_Ab = Ab.unchecked();
+    auto py_Ad = Ad.unchecked();
+    auto py_Ax = Ax.unchecked();
+    auto py_x = x.mutable_unchecked();
+    auto py_b = b.unchecked();
+    const I *_Ap = py_Ap.data();
+    const I *_Ab = py_Ab.data();
+    const unsigned short *_Ad = py_Ad.data();
+    const T *_Ax = py_Ax.data();
+    T *_x = py_x.mutable_data();
+    const T *_b = py_b.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Ab_size = array_size(Ab.shape(0));
+    int Ad_size = array_size(Ad.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int b_size = array_size(b.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("gauss_seidel_delta");
+
+    return gauss_seidel_delta<I, T, F>(
+                      _Ap, Ap_size,
+                      _Ab, Ab_size,
+                      _Ad, Ad_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _b, b_size,
+                row_start,
+                 row_stop,
+                 row_step
+                                       );
+}
+
+template<class I, class T, class F>
+void _gauss_seidel_multicolor_delta(
+      input_array<I> & Ap,
+      input_array<I> & Ab,
+input_array<unsigned short> & Ad,
+      input_array<T> & Ax,
+      output_array<T> & x,
+       input_array<T> & b,
+input_array<I> & color_ptr,
+input_array<I> & color_rows,
+      const I color_start,
+       const I color_stop,
+       const I color_step
+                                    )
+{
+    auto py_Ap = Ap.unchecked();
+    auto py_Ab = Ab.unchecked();
+    auto py_Ad = Ad.unchecked();
+    auto py_Ax = Ax.unchecked();
+    auto py_x = x.mutable_unchecked();
+    auto py_b = b.unchecked();
+    auto py_color_ptr = color_ptr.unchecked();
+    auto py_color_rows = color_rows.unchecked();
+    const I *_Ap = py_Ap.data();
+    const I *_Ab = py_Ab.data();
+    const unsigned short *_Ad = py_Ad.data();
+    const T *_Ax = py_Ax.data();
+    T *_x = py_x.mutable_data();
+    const T *_b = py_b.data();
+    const I *_color_ptr = py_color_ptr.data();
+    const I *_color_rows = py_color_rows.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Ab_size = array_size(Ab.shape(0));
+    int Ad_size = array_size(Ad.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int b_size = array_size(b.shape(0));
+    int color_ptr_size = array_size(color_ptr.shape(0));
+    int color_rows_size = array_size(color_rows.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("gauss_seidel_multicolor_delta");
+
+    return gauss_seidel_multicolor_delta<I, T, F>(
+                      _Ap, Ap_size,
+                      _Ab, Ab_size,
+                      _Ad, Ad_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _b, b_size,
+               _color_ptr, color_ptr_size,
+              _color_rows, color_rows_size,
+              color_start,
+               color_stop,
+               color_step
+                                                  );
+}
+
+template<class I, class T, class F>
+void _jacobi_delta(
+      input_array<I> & Ap,
+      input_array<I> & Ab,
+input_array<unsigned short> & Ad,
+      input_array<T> & Ax,
+      output_array<T> & x,
+       input_array<T> & b,
+   output_array<T> & temp,
+        const I row_start,
+         const I row_stop,
+         const I row_step,
+   input_array<T> & omega
+                   )
+{
+    auto py_Ap = Ap.unchecked();
+    auto py_Ab = Ab.unchecked();
+    auto py_Ad = Ad.unchecked();
+    auto py_Ax = Ax.unchecked();
+    auto py_x = x.mutable_unchecked();
+    auto py_b = b.unchecked();
+    auto py_temp = temp.mutable_unchecked();
+    auto py_omega = omega.unchecked();
+    const I *_Ap = py_Ap.data();
+    const I *_Ab = py_Ab.data();
+    const unsigned short *_Ad = py_Ad.data();
+    const T *_Ax = py_Ax.data();
+    T *_x = py_x.mutable_data();
+    const T *_b = py_b.data();
+    T *_temp = py_temp.mutable_data();
+    const T *_omega = py_omega.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Ab_size = array_size(Ab.shape(0));
+    int Ad_size = array_size(Ad.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int b_size = array_size(b.shape(0));
+    int temp_size = array_size(temp.shape(0));
+    int omega_size = array_size(omega.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("jacobi_delta");
+
+    return jacobi_delta<I, T, F>(
+                      _Ap, Ap_size,
+                      _Ab, Ab_size,
+                      _Ad, Ad_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _b, b_size,
+                    _temp, temp_size,
+                row_start,
+                 row_stop,
+                 row_step,
+                   _omega, omega_size
+                                 );
+}
+
+template<class I, class T>
+void _aggregate_prolongate_add(
+      input_array<I> & Pj,
+      input_array<T> & Px,
+input_array<T> & coarse_x,
+      output_array<T> & x,
+        const I blocksize,
+ const I coarse_blocksize
+                               )
+{
+    auto py_Pj = Pj.unchecked();
+    auto py_Px = Px.unchecked();
+    auto py_coarse_x = coarse_x.unchecked();
+    auto py_x = x.mutable_unchecked();
+    const I *_Pj = py_Pj.data();
+    const T *_Px = py_Px.data();
+    const T *_coarse_x = py_coarse_x.data();
+    T *_x = py_x.mutable_data();
+    int Pj_size = array_size(Pj.shape(0));
+    int Px_size = array_size(Px.shape(0));
+    int coarse_x_size = array_size(coarse_x.shape(0));
+    int x_size = array_size(x.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("aggregate_prolongate_add");
+
+    return aggregate_prolongate_add<I, T>(
+                      _Pj, Pj_size,
+                      _Px, Px_size,
+                _coarse_x, coarse_x_size,
+                       _x, x_size,
+                blocksize,
+         coarse_blocksize
+                                          );
+}
+
+template<class I, class T>
+void _aggregate_restrict(
+      input_array<I> & Pj,
+      input_array<T> & Px,
+       input_array<T> & r,
+output_array<T> & coarse_b,
+        const I blocksize,
+ const I coarse_blocksize
+                         )
+{
+    auto py_Pj = Pj.unchecked();
+    auto py_Px = Px.unchecked();
+    auto py_r = r.unchecked();
+    auto py_coarse_b = coarse_b.mutable_unchecked();
+    const I *_Pj = py_Pj.data();
+    const T *_Px = py_Px.data();
+    const T *_r = py_r.data();
+    T *_coarse_b = py_coarse_b.mutable_data();
+    int Pj_size = array_size(Pj.shape(0));
+    int Px_size = array_size(Px.shape(0));
+    int r_size = array_size(r.shape(0));
+    int coarse_b_size = array_size(coarse_b.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("aggregate_restrict");
+
+    return aggregate_restrict<I, T>(
+                      _Pj, Pj_size,
+                      _Px, Px_size,
+                       _r, r_size,
+                _coarse_b, coarse_b_size,
+                blocksize,
+         coarse_blocksize
+                                    );
+}
+
+template<class I, class T, class F>
+void _gauss_seidel_multi(
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      output_array<T> & x,
+       input_array<T> & b,
+        const I row_start,
+         const I row_stop,
+         const I row_step,
+             const I nrhs
+                         )
+{
+    auto py_Ap = Ap.unchecked();
+    auto py_Aj = Aj.unchecked();
+    auto py_Ax = Ax.unchecked();
+    auto py_x = x.mutable_unchecked();
+    auto py_b = b.unchecked();
+    const I *_Ap = py_Ap.data();
+    const I *_Aj = py_Aj.data();
+    const T *_Ax = py_Ax.data();
+    T *_x = py_x.mutable_data();
+    const T *_b = py_b.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int b_size = array_size(b.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("gauss_seidel_multi");
+
+    return gauss_seidel_multi<I, T, F>(
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _b, b_size,
+                row_start,
+                 row_stop,
+                 row_step,
+                     nrhs
+                                       );
+}
+
+template<class I, class T, class F>
+void _jacobi_multi(
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      output_array<T> & x,
+       input_array<T> & b,
+   output_array<T> & temp,
+        const I row_start,
+         const I row_stop,
+         const I row_step,
+             const I nrhs,
+   input_array<T> & omega
+                   )
+{
+    auto py_Ap = Ap.unchecked();
+    auto py_Aj = Aj.unchecked();
+    auto py_Ax = Ax.unchecked();
+    auto py_x = x.mutable_unchecked();
+    auto py_b = b.unchecked();
+    auto py_temp = temp.mutable_unchecked();
+    auto py_omega = omega.unchecked();
+    const I *_Ap = py_Ap.data();
+    const I *_Aj = py_Aj.data();
+    const T *_Ax = py_Ax.data();
+    T *_x = py_x.mutable_data();
+    const T *_b = py_b.data();
+    T *_temp = py_temp.mutable_data();
+    const T *_omega = py_omega.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int b_size = array_size(b.shape(0));
+    int temp_size = array_size(temp.shape(0));
+    int omega_size = array_size(omega.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("jacobi_multi");
+
+    return jacobi_multi<I, T, F>(
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _b, b_size,
+                    _temp, temp_size,
+                row_start,
+                 row_stop,
+                 row_step,
+                     nrhs,
+                   _omega, omega_size
+                                 );
+}
+
+template<class I, class T>
+void _csr_residual_restrict_multi(
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+       input_array<T> & x,
+       input_array<T> & b,
+      input_array<I> & Tp,
+      input_array<I> & Tj,
+      input_array<T> & Tx,
+output_array<T> & coarse_b,
+             const I nrhs
+                                  )
 {
     auto py_Ap = Ap.unchecked();
     auto py_Aj = Aj.unchecked();
     auto py_Ax = Ax.unchecked();
-    auto py_x = x.mutable_unchecked();
+    auto py_x = x.unchecked();
     auto py_b = b.unchecked();
-    auto py_Tx = Tx.unchecked();
     auto py_Tp = Tp.unchecked();
-    auto py_Sj = Sj.unchecked();
-    auto py_Sp = Sp.unchecked();
+    auto py_Tj = Tj.unchecked();
+    auto py_Tx = Tx.unchecked();
+    auto py_coarse_b = coarse_b.mutable_unchecked();
     const I *_Ap = py_Ap.data();
     const I *_Aj = py_Aj.data();
     const T *_Ax = py_Ax.data();
-    T *_x = py_x.mutable_data();
+    const T *_x = py_x.data();
     const T *_b = py_b.data();
-    const T *_Tx = py_Tx.data();
     const I *_Tp = py_Tp.data();
-    const I *_Sj = py_Sj.data();
-    const I *_Sp = py_Sp.data();
+    const I *_Tj = py_Tj.data();
+    const T *_Tx = py_Tx.data();
+    T *_coarse_b = py_coarse_b.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int b_size = array_size(b.shape(0));
+    int Tp_size = array_size(Tp.shape(0));
+    int Tj_size = array_size(Tj.shape(0));
+    int Tx_size = array_size(Tx.shape(0));
+    int coarse_b_size = array_size(coarse_b.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("csr_residual_restrict_multi");
+
+    return csr_residual_restrict_multi<I, T>(
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _b, b_size,
+                      _Tp, Tp_size,
+                      _Tj, Tj_size,
+                      _Tx, Tx_size,
+                _coarse_b, coarse_b_size,
+                     nrhs
+                                             );
+}
 
-    return overlapping_schwarz_csr<I, T, F>(
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
-                      _Ax, Ax.shape(0),
-                       _x, x.shape(0),
-                       _b, b.shape(0),
-                      _Tx, Tx.shape(0),
-                      _Tp, Tp.shape(0),
-                      _Sj, Sj.shape(0),
-                      _Sp, Sp.shape(0),
-                nsdomains,
-                    nrows,
-                row_start,
-                 row_stop,
-                 row_step
-                                            );
+template<class I, class T>
+void _csr_prolongate_add_multi(
+      input_array<I> & Pp,
+      input_array<I> & Pj,
+      input_array<T> & Px,
+input_array<T> & coarse_x,
+      output_array<T> & x,
+             const I nrhs
+                               )
+{
+    auto py_Pp = Pp.unchecked();
+    auto py_Pj = Pj.unchecked();
+    auto py_Px = Px.unchecked();
+    auto py_coarse_x = coarse_x.unchecked();
+    auto py_x = x.mutable_unchecked();
+    const I *_Pp = py_Pp.data();
+    const I *_Pj = py_Pj.data();
+    const T *_Px = py_Px.data();
+    const T *_coarse_x = py_coarse_x.data();
+    T *_x = py_x.mutable_data();
+    int Pp_size = array_size(Pp.shape(0));
+    int Pj_size = array_size(Pj.shape(0));
+    int Px_size = array_size(Px.shape(0));
+    int coarse_x_size = array_size(coarse_x.shape(0));
+    int x_size = array_size(x.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("csr_prolongate_add_multi");
+
+    return csr_prolongate_add_multi<I, T>(
+                      _Pp, Pp_size,
+                      _Pj, Pj_size,
+                      _Px, Px_size,
+                _coarse_x, coarse_x_size,
+                       _x, x_size,
+                     nrhs
+                                          );
+}
+
+template<class I, class T, class F>
+void _multigrid_cycle(
+  input_array<I> & levels,
+   input_array<I> & index,
+    input_array<T> & data,
+   output_array<T> & work,
+      output_array<T> & x,
+       input_array<T> & b,
+            const I cycle
+                      )
+{
+    auto py_levels = levels.unchecked();
+    auto py_index = index.unchecked();
+    auto py_data = data.unchecked();
+    auto py_work = work.mutable_unchecked();
+    auto py_x = x.mutable_unchecked();
+    auto py_b = b.unchecked();
+    const I *_levels = py_levels.data();
+    const I *_index = py_index.data();
+    const T *_data = py_data.data();
+    T *_work = py_work.mutable_data();
+    T *_x = py_x.mutable_data();
+    const T *_b = py_b.data();
+    int levels_size = array_size(levels.shape(0));
+    int index_size = array_size(index.shape(0));
+    int data_size = array_size(data.shape(0));
+    int work_size = array_size(work.shape(0));
+    int x_size = array_size(x.shape(0));
+    int b_size = array_size(b.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("multigrid_cycle");
+
+    return multigrid_cycle<I, T, F>(
+                  _levels, levels_size,
+                   _index, index_size,
+                    _data, data_size,
+                    _work, work_size,
+                       _x, x_size,
+                       _b, b_size,
+                    cycle
+                                    );
 }
 
 PYBIND11_MODULE(relaxation, m) {
@@ -530,29 +2083,71 @@ PYBIND11_MODULE(relaxation, m) {
     -------
     gauss_seidel
     bsr_gauss_seidel
+    bsr_gauss_seidel_generic
+    gauss_seidel_multicolor
+    bsr_gauss_seidel_multicolor
+    bsr_gauss_seidel_multicolor_generic
     jacobi
     bsr_jacobi
+    bsr_jacobi_generic
+    polynomial
+    bsr_polynomial
+    bsr_polynomial_generic
     gauss_seidel_indexed
     jacobi_ne
     gauss_seidel_ne
     gauss_seidel_nr
     block_jacobi
+    block_jacobi_generic
     block_gauss_seidel
+    block_gauss_seidel_generic
     extract_subblocks
     overlapping_schwarz_csr
+    schwarz_factor
+    overlapping_schwarz_lu_csr
+    overlapping_schwarz_multicolor_csr
+    csr_residual_restrict
+    bsr_residual_restrict
+    csr_prolongate_add
+    bsr_prolongate_add
+    gauss_seidel_delta
+    gauss_seidel_multicolor_delta
+    jacobi_delta
+    aggregate_prolongate_add
+    aggregate_restrict
+    gauss_seidel_multi
+    jacobi_multi
+    csr_residual_restrict_multi
+    csr_prolongate_add_multi
+    multigrid_cycle
     )pbdoc";
 
     py::options options;
     options.disable_function_signatures();
 
+    share_num_threads();
+
+    m.def("_kernel_timers", &swap_kernel_timers, py::arg("enable"),
+R"pbdoc(
+Return and reset the kernel timers of the calling thread, and enable or
+disable them for subsequent calls, see bind_timers.h.)pbdoc");
+
     m.def("gauss_seidel", &_gauss_seidel<int, float, float>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"));
     m.def("gauss_seidel", &_gauss_seidel<int, double, double>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"));
     m.def("gauss_seidel", &_gauss_seidel<int, std::complex<float>, float>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"));
     m.def("gauss_seidel", &_gauss_seidel<int, std::complex<double>, double>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"),
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"));
+    m.def("gauss_seidel", &_gauss_seidel<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"));
+    m.def("gauss_seidel", &_gauss_seidel<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"));
+    m.def("gauss_seidel", &_gauss_seidel<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"));
+    m.def("gauss_seidel", &_gauss_seidel<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"),
 R"pbdoc(
 Perform one iteration of Gauss-Seidel relaxation on the linear
  system Ax = b, where A is stored in CSR format and x and b
@@ -580,13 +2175,21 @@ Perform one iteration of Gauss-Seidel relaxation on the linear
      Nothing, x will be modified in place)pbdoc");
 
     m.def("bsr_gauss_seidel", &_bsr_gauss_seidel<int, float, float>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
     m.def("bsr_gauss_seidel", &_bsr_gauss_seidel<int, double, double>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
     m.def("bsr_gauss_seidel", &_bsr_gauss_seidel<int, std::complex<float>, float>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
     m.def("bsr_gauss_seidel", &_bsr_gauss_seidel<int, std::complex<double>, double>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"),
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
+    m.def("bsr_gauss_seidel", &_bsr_gauss_seidel<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
+    m.def("bsr_gauss_seidel", &_bsr_gauss_seidel<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
+    m.def("bsr_gauss_seidel", &_bsr_gauss_seidel<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
+    m.def("bsr_gauss_seidel", &_bsr_gauss_seidel<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"),
 R"pbdoc(
 Perform one iteration of Gauss-Seidel relaxation on the linear
  system Ax = b, where A is stored in Block CSR format and x and b
@@ -610,14 +2213,150 @@ Perform one iteration of Gauss-Seidel relaxation on the linear
  Returns:
      Nothing, x will be modified in place)pbdoc");
 
+    m.def("bsr_gauss_seidel_generic", &_bsr_gauss_seidel_generic<int, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
+    m.def("bsr_gauss_seidel_generic", &_bsr_gauss_seidel_generic<int, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
+    m.def("bsr_gauss_seidel_generic", &_bsr_gauss_seidel_generic<int, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
+    m.def("bsr_gauss_seidel_generic", &_bsr_gauss_seidel_generic<int, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
+    m.def("bsr_gauss_seidel_generic", &_bsr_gauss_seidel_generic<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
+    m.def("bsr_gauss_seidel_generic", &_bsr_gauss_seidel_generic<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
+    m.def("bsr_gauss_seidel_generic", &_bsr_gauss_seidel_generic<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
+    m.def("bsr_gauss_seidel_generic", &_bsr_gauss_seidel_generic<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"),
+R"pbdoc(
+bsr_gauss_seidel with the blocksize given at run time, for all blocksizes, see bsr_gauss_seidel.)pbdoc");
+
+    m.def("gauss_seidel_multicolor", &_gauss_seidel_multicolor<int, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("color_ptr"), py::arg("color_rows"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"));
+    m.def("gauss_seidel_multicolor", &_gauss_seidel_multicolor<int, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("color_ptr"), py::arg("color_rows"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"));
+    m.def("gauss_seidel_multicolor", &_gauss_seidel_multicolor<int, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("color_ptr"), py::arg("color_rows"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"));
+    m.def("gauss_seidel_multicolor", &_gauss_seidel_multicolor<int, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("color_ptr"), py::arg("color_rows"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"));
+    m.def("gauss_seidel_multicolor", &_gauss_seidel_multicolor<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("color_ptr"), py::arg("color_rows"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"));
+    m.def("gauss_seidel_multicolor", &_gauss_seidel_multicolor<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("color_ptr"), py::arg("color_rows"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"));
+    m.def("gauss_seidel_multicolor", &_gauss_seidel_multicolor<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("color_ptr"), py::arg("color_rows"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"));
+    m.def("gauss_seidel_multicolor", &_gauss_seidel_multicolor<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("color_ptr"), py::arg("color_rows"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"),
+R"pbdoc(
+Perform one iteration of multicolor Gauss-Seidel relaxation on the
+ linear system Ax = b, where A is stored in CSR format and x and b
+ are column vectors.
+
+ The rows are grouped by color, so that no two rows of the same
+ color are coupled in A.  The colors are swept through according
+ to the slice defined by color_start, color_stop, and color_step,
+ and all rows of one color are relaxed simultaneously (in parallel
+ when compiled with OpenMP).  The rows of color c are
+
+     color_rows[color_ptr[c]], ..., color_rows[color_ptr[c+1]-1]
+
+ Parameters
+     Ap[]          - CSR row pointer
+     Aj[]          - CSR index array
+     Ax[]          - CSR data array
+     x[]           - approximate solution
+     b[]           - right hand side
+     color_ptr[]   - pointer into color_rows for each color
+     color_rows[]  - rows of A, grouped by color
+     color_start   - first color of the sweep
+     color_stop    - end of the sweep (i.e. one past the last color)
+     color_step    - stride used during the sweep (may be negative)
+
+ Returns:
+     Nothing, x will be modified in place
+
+ Notes:
+     A coloring is computed once with vertex_coloring_mis or
+     vertex_coloring_jones_plassmann on the graph of A + A^T)pbdoc");
+
+    m.def("bsr_gauss_seidel_multicolor", &_bsr_gauss_seidel_multicolor<int, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("color_ptr"), py::arg("color_rows"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"), py::arg("blocksize"));
+    m.def("bsr_gauss_seidel_multicolor", &_bsr_gauss_seidel_multicolor<int, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("color_ptr"), py::arg("color_rows"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"), py::arg("blocksize"));
+    m.def("bsr_gauss_seidel_multicolor", &_bsr_gauss_seidel_multicolor<int, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("color_ptr"), py::arg("color_rows"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"), py::arg("blocksize"));
+    m.def("bsr_gauss_seidel_multicolor", &_bsr_gauss_seidel_multicolor<int, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("color_ptr"), py::arg("color_rows"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"), py::arg("blocksize"));
+    m.def("bsr_gauss_seidel_multicolor", &_bsr_gauss_seidel_multicolor<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("color_ptr"), py::arg("color_rows"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"), py::arg("blocksize"));
+    m.def("bsr_gauss_seidel_multicolor", &_bsr_gauss_seidel_multicolor<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("color_ptr"), py::arg("color_rows"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"), py::arg("blocksize"));
+    m.def("bsr_gauss_seidel_multicolor", &_bsr_gauss_seidel_multicolor<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("color_ptr"), py::arg("color_rows"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"), py::arg("blocksize"));
+    m.def("bsr_gauss_seidel_multicolor", &_bsr_gauss_seidel_multicolor<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("color_ptr"), py::arg("color_rows"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"), py::arg("blocksize"),
+R"pbdoc(
+Perform one iteration of multicolor Gauss-Seidel relaxation on the
+ linear system Ax = b, where A is stored in Block CSR format and x
+ and b are column vectors.  As in bsr_gauss_seidel, point-wise
+ relaxation is applied within each diagonal block.
+
+ Refer to gauss_seidel_multicolor for additional information
+ regarding color_ptr, color_rows, color_start, color_stop, and
+ color_step.  Here, the coloring is of the block rows of A.
+
+ Parameters
+     Ap[]          - BSR row pointer
+     Aj[]          - BSR index array
+     Ax[]          - BSR data array
+     x[]           - approximate solution
+     b[]           - right hand side
+     color_ptr[]   - pointer into color_rows for each color
+     color_rows[]  - block rows of A, grouped by color
+     color_start   - first color of the sweep
+     color_stop    - end of the sweep (i.e. one past the last color)
+     color_step    - stride used during the sweep (may be negative)
+     blocksize     - BSR blocksize (blocks must be square)
+
+ Returns:
+     Nothing, x will be modified in place)pbdoc");
+
+    m.def("bsr_gauss_seidel_multicolor_generic", &_bsr_gauss_seidel_multicolor_generic<int, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("color_ptr"), py::arg("color_rows"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"), py::arg("blocksize"));
+    m.def("bsr_gauss_seidel_multicolor_generic", &_bsr_gauss_seidel_multicolor_generic<int, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("color_ptr"), py::arg("color_rows"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"), py::arg("blocksize"));
+    m.def("bsr_gauss_seidel_multicolor_generic", &_bsr_gauss_seidel_multicolor_generic<int, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("color_ptr"), py::arg("color_rows"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"), py::arg("blocksize"));
+    m.def("bsr_gauss_seidel_multicolor_generic", &_bsr_gauss_seidel_multicolor_generic<int, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("color_ptr"), py::arg("color_rows"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"), py::arg("blocksize"));
+    m.def("bsr_gauss_seidel_multicolor_generic", &_bsr_gauss_seidel_multicolor_generic<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("color_ptr"), py::arg("color_rows"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"), py::arg("blocksize"));
+    m.def("bsr_gauss_seidel_multicolor_generic", &_bsr_gauss_seidel_multicolor_generic<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("color_ptr"), py::arg("color_rows"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"), py::arg("blocksize"));
+    m.def("bsr_gauss_seidel_multicolor_generic", &_bsr_gauss_seidel_multicolor_generic<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("color_ptr"), py::arg("color_rows"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"), py::arg("blocksize"));
+    m.def("bsr_gauss_seidel_multicolor_generic", &_bsr_gauss_seidel_multicolor_generic<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("color_ptr"), py::arg("color_rows"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"), py::arg("blocksize"),
+R"pbdoc(
+bsr_gauss_seidel_multicolor with the blocksize given at run time, for all blocksizes, see bsr_gauss_seidel_multicolor.)pbdoc");
+
     m.def("jacobi", &_jacobi<int, float, float>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega").noconvert());
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"));
     m.def("jacobi", &_jacobi<int, double, double>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega").noconvert());
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"));
     m.def("jacobi", &_jacobi<int, std::complex<float>, float>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega").noconvert());
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"));
     m.def("jacobi", &_jacobi<int, std::complex<double>, double>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega").noconvert(),
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"));
+    m.def("jacobi", &_jacobi<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"));
+    m.def("jacobi", &_jacobi<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"));
+    m.def("jacobi", &_jacobi<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"));
+    m.def("jacobi", &_jacobi<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"),
 R"pbdoc(
 Perform one iteration of Jacobi relaxation on the linear
  system Ax = b, where A is stored in CSR format and x and b
@@ -643,13 +2382,21 @@ Perform one iteration of Jacobi relaxation on the linear
      Nothing, x will be modified in place)pbdoc");
 
     m.def("bsr_jacobi", &_bsr_jacobi<int, float, float>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"), py::arg("omega").noconvert());
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"), py::arg("omega"));
     m.def("bsr_jacobi", &_bsr_jacobi<int, double, double>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"), py::arg("omega").noconvert());
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"), py::arg("omega"));
     m.def("bsr_jacobi", &_bsr_jacobi<int, std::complex<float>, float>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"), py::arg("omega").noconvert());
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"), py::arg("omega"));
     m.def("bsr_jacobi", &_bsr_jacobi<int, std::complex<double>, double>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"), py::arg("omega").noconvert(),
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"), py::arg("omega"));
+    m.def("bsr_jacobi", &_bsr_jacobi<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"), py::arg("omega"));
+    m.def("bsr_jacobi", &_bsr_jacobi<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"), py::arg("omega"));
+    m.def("bsr_jacobi", &_bsr_jacobi<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"), py::arg("omega"));
+    m.def("bsr_jacobi", &_bsr_jacobi<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"), py::arg("omega"),
 R"pbdoc(
 Perform one iteration of Jacobi relaxation on the linear
  system Ax = b, where A is stored in Block CSR format and x and b
@@ -675,14 +2422,143 @@ Perform one iteration of Jacobi relaxation on the linear
  Returns:
      Nothing, x will be modified in place)pbdoc");
 
+    m.def("bsr_jacobi_generic", &_bsr_jacobi_generic<int, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"), py::arg("omega"));
+    m.def("bsr_jacobi_generic", &_bsr_jacobi_generic<int, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"), py::arg("omega"));
+    m.def("bsr_jacobi_generic", &_bsr_jacobi_generic<int, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"), py::arg("omega"));
+    m.def("bsr_jacobi_generic", &_bsr_jacobi_generic<int, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"), py::arg("omega"));
+    m.def("bsr_jacobi_generic", &_bsr_jacobi_generic<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"), py::arg("omega"));
+    m.def("bsr_jacobi_generic", &_bsr_jacobi_generic<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"), py::arg("omega"));
+    m.def("bsr_jacobi_generic", &_bsr_jacobi_generic<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"), py::arg("omega"));
+    m.def("bsr_jacobi_generic", &_bsr_jacobi_generic<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"), py::arg("omega"),
+R"pbdoc(
+bsr_jacobi with the blocksize given at run time, for all blocksizes, see bsr_jacobi.)pbdoc");
+
+    m.def("polynomial", &_polynomial<int, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("coefficients"), py::arg("zero_guess"));
+    m.def("polynomial", &_polynomial<int, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("coefficients"), py::arg("zero_guess"));
+    m.def("polynomial", &_polynomial<int, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("coefficients"), py::arg("zero_guess"));
+    m.def("polynomial", &_polynomial<int, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("coefficients"), py::arg("zero_guess"));
+    m.def("polynomial", &_polynomial<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("coefficients"), py::arg("zero_guess"));
+    m.def("polynomial", &_polynomial<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("coefficients"), py::arg("zero_guess"));
+    m.def("polynomial", &_polynomial<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("coefficients"), py::arg("zero_guess"));
+    m.def("polynomial", &_polynomial<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("coefficients"), py::arg("zero_guess"),
+R"pbdoc(
+Perform one iteration of polynomial smoothing on the linear system
+ Ax = b, where A is stored in CSR format, i.e.,
+
+     x = x + p(A) (b - A x)
+
+ where p is the polynomial with the given coefficients, in descending
+ order.  p(A) r is evaluated by Horner's rule, h = c_0 r and then
+ h = c_k r + A h for k = 1, ..., degree.  Each step is a single pass
+ over A, with the product fused with the update, and the last step
+ adds h to x directly.  The residual is computed in the first pass.
+ The row products are accumulated in LINALG_LANES partial sums, see
+ csr_row_dot in linalg.h, so they may differ in the last bits from a
+ serial sum.
+
+ Parameters
+     Ap[]            - CSR row pointer
+     Aj[]            - CSR index array
+     Ax[]            - CSR data array
+     x[]             - approximate solution
+     b[]             - right hand side
+     temp[]          - temporary vector of three times the size of x
+     coefficients[]  - coefficients of p, in descending order
+     zero_guess      - if nonzero, x is zero and b - A x = b
+
+ Returns:
+     Nothing, x will be modified in place
+
+ Notes:
+     The result does not depend on the number of threads.)pbdoc");
+
+    m.def("bsr_polynomial", &_bsr_polynomial<int, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("coefficients"), py::arg("zero_guess"), py::arg("blocksize"));
+    m.def("bsr_polynomial", &_bsr_polynomial<int, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("coefficients"), py::arg("zero_guess"), py::arg("blocksize"));
+    m.def("bsr_polynomial", &_bsr_polynomial<int, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("coefficients"), py::arg("zero_guess"), py::arg("blocksize"));
+    m.def("bsr_polynomial", &_bsr_polynomial<int, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("coefficients"), py::arg("zero_guess"), py::arg("blocksize"));
+    m.def("bsr_polynomial", &_bsr_polynomial<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("coefficients"), py::arg("zero_guess"), py::arg("blocksize"));
+    m.def("bsr_polynomial", &_bsr_polynomial<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("coefficients"), py::arg("zero_guess"), py::arg("blocksize"));
+    m.def("bsr_polynomial", &_bsr_polynomial<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("coefficients"), py::arg("zero_guess"), py::arg("blocksize"));
+    m.def("bsr_polynomial", &_bsr_polynomial<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("coefficients"), py::arg("zero_guess"), py::arg("blocksize"),
+R"pbdoc(
+Perform one iteration of polynomial smoothing on the linear system
+ Ax = b, where A is stored in BSR format with square blocks.
+
+ Refer to polynomial for additional information.
+
+ Parameters
+     Ap[]            - BSR row pointer
+     Aj[]            - BSR index array
+     Ax[]            - BSR data array
+     x[]             - approximate solution
+     b[]             - right hand side
+     temp[]          - temporary vector of three times the size of x
+     coefficients[]  - coefficients of p, in descending order
+     zero_guess      - if nonzero, x is zero and b - A x = b
+     blocksize       - BSR blocksize (blocks must be square)
+
+ Returns:
+     Nothing, x will be modified in place)pbdoc");
+
+    m.def("bsr_polynomial_generic", &_bsr_polynomial_generic<int, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("coefficients"), py::arg("zero_guess"), py::arg("blocksize"));
+    m.def("bsr_polynomial_generic", &_bsr_polynomial_generic<int, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("coefficients"), py::arg("zero_guess"), py::arg("blocksize"));
+    m.def("bsr_polynomial_generic", &_bsr_polynomial_generic<int, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("coefficients"), py::arg("zero_guess"), py::arg("blocksize"));
+    m.def("bsr_polynomial_generic", &_bsr_polynomial_generic<int, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("coefficients"), py::arg("zero_guess"), py::arg("blocksize"));
+    m.def("bsr_polynomial_generic", &_bsr_polynomial_generic<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("coefficients"), py::arg("zero_guess"), py::arg("blocksize"));
+    m.def("bsr_polynomial_generic", &_bsr_polynomial_generic<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("coefficients"), py::arg("zero_guess"), py::arg("blocksize"));
+    m.def("bsr_polynomial_generic", &_bsr_polynomial_generic<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("coefficients"), py::arg("zero_guess"), py::arg("blocksize"));
+    m.def("bsr_polynomial_generic", &_bsr_polynomial_generic<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("coefficients"), py::arg("zero_guess"), py::arg("blocksize"),
+R"pbdoc(
+bsr_polynomial with the blocksize given at run time, for all blocksizes, see bsr_polynomial.)pbdoc");
+
     m.def("gauss_seidel_indexed", &_gauss_seidel_indexed<int, float, float>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("Id").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Id"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"));
     m.def("gauss_seidel_indexed", &_gauss_seidel_indexed<int, double, double>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("Id").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Id"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"));
     m.def("gauss_seidel_indexed", &_gauss_seidel_indexed<int, std::complex<float>, float>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("Id").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Id"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"));
     m.def("gauss_seidel_indexed", &_gauss_seidel_indexed<int, std::complex<double>, double>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("Id").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"),
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Id"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"));
+    m.def("gauss_seidel_indexed", &_gauss_seidel_indexed<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Id"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"));
+    m.def("gauss_seidel_indexed", &_gauss_seidel_indexed<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Id"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"));
+    m.def("gauss_seidel_indexed", &_gauss_seidel_indexed<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Id"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"));
+    m.def("gauss_seidel_indexed", &_gauss_seidel_indexed<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Id"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"),
 R"pbdoc(
 Perform one iteration of Gauss-Seidel relaxation on the linear
  system Ax = b, where A is stored in CSR format and x and b
@@ -713,13 +2589,21 @@ Perform one iteration of Gauss-Seidel relaxation on the linear
      Nothing, x will be modified in place)pbdoc");
 
     m.def("jacobi_ne", &_jacobi_ne<int, float, float>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("Tx").noconvert(), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega").noconvert());
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"));
     m.def("jacobi_ne", &_jacobi_ne<int, double, double>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("Tx").noconvert(), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega").noconvert());
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"));
     m.def("jacobi_ne", &_jacobi_ne<int, std::complex<float>, float>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("Tx").noconvert(), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega").noconvert());
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"));
     m.def("jacobi_ne", &_jacobi_ne<int, std::complex<double>, double>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("Tx").noconvert(), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega").noconvert(),
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"));
+    m.def("jacobi_ne", &_jacobi_ne<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"));
+    m.def("jacobi_ne", &_jacobi_ne<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"));
+    m.def("jacobi_ne", &_jacobi_ne<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"));
+    m.def("jacobi_ne", &_jacobi_ne<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"),
 R"pbdoc(
 Perform NE Jacobi on the linear system A x = b
 This effectively carries out weighted-Jacobi on A A^T x = A^T b
@@ -758,13 +2642,21 @@ Notes
 Primary calling routine is jacobi_ne in relaxation.py)pbdoc");
 
     m.def("gauss_seidel_ne", &_gauss_seidel_ne<int, float, float>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("Tx").noconvert(), py::arg("omega"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("Tx"), py::arg("omega"));
     m.def("gauss_seidel_ne", &_gauss_seidel_ne<int, double, double>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("Tx").noconvert(), py::arg("omega"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("Tx"), py::arg("omega"));
     m.def("gauss_seidel_ne", &_gauss_seidel_ne<int, std::complex<float>, float>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("Tx").noconvert(), py::arg("omega"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("Tx"), py::arg("omega"));
     m.def("gauss_seidel_ne", &_gauss_seidel_ne<int, std::complex<double>, double>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("Tx").noconvert(), py::arg("omega"),
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("Tx"), py::arg("omega"));
+    m.def("gauss_seidel_ne", &_gauss_seidel_ne<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("Tx"), py::arg("omega"));
+    m.def("gauss_seidel_ne", &_gauss_seidel_ne<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("Tx"), py::arg("omega"));
+    m.def("gauss_seidel_ne", &_gauss_seidel_ne<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("Tx"), py::arg("omega"));
+    m.def("gauss_seidel_ne", &_gauss_seidel_ne<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("Tx"), py::arg("omega"),
 R"pbdoc(
 Perform NE Gauss-Seidel on the linear system A x = b
 This effectively carries out Gauss-Seidel on A A.H x = b
@@ -798,13 +2690,21 @@ Notes
 Primary calling routine is gass_seidel_ne in relaxation.py)pbdoc");
 
     m.def("gauss_seidel_nr", &_gauss_seidel_nr<int, float, float>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("z").noconvert(), py::arg("col_start"), py::arg("col_stop"), py::arg("col_step"), py::arg("Tx").noconvert(), py::arg("omega"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("z").noconvert(), py::arg("col_start"), py::arg("col_stop"), py::arg("col_step"), py::arg("Tx"), py::arg("omega"));
     m.def("gauss_seidel_nr", &_gauss_seidel_nr<int, double, double>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("z").noconvert(), py::arg("col_start"), py::arg("col_stop"), py::arg("col_step"), py::arg("Tx").noconvert(), py::arg("omega"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("z").noconvert(), py::arg("col_start"), py::arg("col_stop"), py::arg("col_step"), py::arg("Tx"), py::arg("omega"));
     m.def("gauss_seidel_nr", &_gauss_seidel_nr<int, std::complex<float>, float>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("z").noconvert(), py::arg("col_start"), py::arg("col_stop"), py::arg("col_step"), py::arg("Tx").noconvert(), py::arg("omega"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("z").noconvert(), py::arg("col_start"), py::arg("col_stop"), py::arg("col_step"), py::arg("Tx"), py::arg("omega"));
     m.def("gauss_seidel_nr", &_gauss_seidel_nr<int, std::complex<double>, double>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("z").noconvert(), py::arg("col_start"), py::arg("col_stop"), py::arg("col_step"), py::arg("Tx").noconvert(), py::arg("omega"),
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("z").noconvert(), py::arg("col_start"), py::arg("col_stop"), py::arg("col_step"), py::arg("Tx"), py::arg("omega"));
+    m.def("gauss_seidel_nr", &_gauss_seidel_nr<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("z").noconvert(), py::arg("col_start"), py::arg("col_stop"), py::arg("col_step"), py::arg("Tx"), py::arg("omega"));
+    m.def("gauss_seidel_nr", &_gauss_seidel_nr<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("z").noconvert(), py::arg("col_start"), py::arg("col_stop"), py::arg("col_step"), py::arg("Tx"), py::arg("omega"));
+    m.def("gauss_seidel_nr", &_gauss_seidel_nr<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("z").noconvert(), py::arg("col_start"), py::arg("col_stop"), py::arg("col_step"), py::arg("Tx"), py::arg("omega"));
+    m.def("gauss_seidel_nr", &_gauss_seidel_nr<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("z").noconvert(), py::arg("col_start"), py::arg("col_stop"), py::arg("col_step"), py::arg("Tx"), py::arg("omega"),
 R"pbdoc(
 Perform NR Gauss-Seidel on the linear system A x = b
 This effectively carries out Gauss-Seidel on A.H A x = A.H b
@@ -838,13 +2738,21 @@ Notes
 Primary calling routine is gauss_seidel_nr in relaxation.py)pbdoc");
 
     m.def("block_jacobi", &_block_jacobi<int, float, float>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("Tx").noconvert(), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega").noconvert(), py::arg("blocksize"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"), py::arg("blocksize"));
     m.def("block_jacobi", &_block_jacobi<int, double, double>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("Tx").noconvert(), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega").noconvert(), py::arg("blocksize"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"), py::arg("blocksize"));
     m.def("block_jacobi", &_block_jacobi<int, std::complex<float>, float>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("Tx").noconvert(), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega").noconvert(), py::arg("blocksize"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"), py::arg("blocksize"));
     m.def("block_jacobi", &_block_jacobi<int, std::complex<double>, double>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("Tx").noconvert(), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega").noconvert(), py::arg("blocksize"),
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"), py::arg("blocksize"));
+    m.def("block_jacobi", &_block_jacobi<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"), py::arg("blocksize"));
+    m.def("block_jacobi", &_block_jacobi<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"), py::arg("blocksize"));
+    m.def("block_jacobi", &_block_jacobi<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"), py::arg("blocksize"));
+    m.def("block_jacobi", &_block_jacobi<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"), py::arg("blocksize"),
 R"pbdoc(
 Perform one iteration of block Jacobi relaxation on the linear
  system Ax = b, where A is stored in BSR format and x and b
@@ -872,14 +2780,41 @@ Perform one iteration of block Jacobi relaxation on the linear
  Returns:
      Nothing, x will be modified in place)pbdoc");
 
+    m.def("block_jacobi_generic", &_block_jacobi_generic<int, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"), py::arg("blocksize"));
+    m.def("block_jacobi_generic", &_block_jacobi_generic<int, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"), py::arg("blocksize"));
+    m.def("block_jacobi_generic", &_block_jacobi_generic<int, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"), py::arg("blocksize"));
+    m.def("block_jacobi_generic", &_block_jacobi_generic<int, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"), py::arg("blocksize"));
+    m.def("block_jacobi_generic", &_block_jacobi_generic<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"), py::arg("blocksize"));
+    m.def("block_jacobi_generic", &_block_jacobi_generic<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"), py::arg("blocksize"));
+    m.def("block_jacobi_generic", &_block_jacobi_generic<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"), py::arg("blocksize"));
+    m.def("block_jacobi_generic", &_block_jacobi_generic<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"), py::arg("blocksize"),
+R"pbdoc(
+block_jacobi with the blocksize given at run time, for all blocksizes, see block_jacobi.)pbdoc");
+
     m.def("block_gauss_seidel", &_block_gauss_seidel<int, float, float>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("Tx").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
     m.def("block_gauss_seidel", &_block_gauss_seidel<int, double, double>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("Tx").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
     m.def("block_gauss_seidel", &_block_gauss_seidel<int, std::complex<float>, float>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("Tx").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
     m.def("block_gauss_seidel", &_block_gauss_seidel<int, std::complex<double>, double>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("Tx").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"),
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
+    m.def("block_gauss_seidel", &_block_gauss_seidel<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
+    m.def("block_gauss_seidel", &_block_gauss_seidel<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
+    m.def("block_gauss_seidel", &_block_gauss_seidel<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
+    m.def("block_gauss_seidel", &_block_gauss_seidel<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"),
 R"pbdoc(
 Perform one iteration of block Gauss-Seidel relaxation on
  the linear system Ax = b, where A is stored in BSR format
@@ -904,14 +2839,41 @@ Perform one iteration of block Gauss-Seidel relaxation on
  Returns:
      Nothing, x will be modified in place)pbdoc");
 
+    m.def("block_gauss_seidel_generic", &_block_gauss_seidel_generic<int, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
+    m.def("block_gauss_seidel_generic", &_block_gauss_seidel_generic<int, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
+    m.def("block_gauss_seidel_generic", &_block_gauss_seidel_generic<int, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
+    m.def("block_gauss_seidel_generic", &_block_gauss_seidel_generic<int, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
+    m.def("block_gauss_seidel_generic", &_block_gauss_seidel_generic<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
+    m.def("block_gauss_seidel_generic", &_block_gauss_seidel_generic<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
+    m.def("block_gauss_seidel_generic", &_block_gauss_seidel_generic<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"));
+    m.def("block_gauss_seidel_generic", &_block_gauss_seidel_generic<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("blocksize"),
+R"pbdoc(
+block_gauss_seidel with the blocksize given at run time, for all blocksizes, see block_gauss_seidel.)pbdoc");
+
     m.def("extract_subblocks", &_extract_subblocks<int, float, float>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("Tx").noconvert(), py::arg("Tp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sp").noconvert(), py::arg("nsdomains"), py::arg("nrows"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Tx").noconvert(), py::arg("Tp"), py::arg("Sj"), py::arg("Sp"), py::arg("nsdomains"), py::arg("nrows"));
     m.def("extract_subblocks", &_extract_subblocks<int, double, double>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("Tx").noconvert(), py::arg("Tp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sp").noconvert(), py::arg("nsdomains"), py::arg("nrows"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Tx").noconvert(), py::arg("Tp"), py::arg("Sj"), py::arg("Sp"), py::arg("nsdomains"), py::arg("nrows"));
     m.def("extract_subblocks", &_extract_subblocks<int, std::complex<float>, float>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("Tx").noconvert(), py::arg("Tp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sp").noconvert(), py::arg("nsdomains"), py::arg("nrows"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Tx").noconvert(), py::arg("Tp"), py::arg("Sj"), py::arg("Sp"), py::arg("nsdomains"), py::arg("nrows"));
     m.def("extract_subblocks", &_extract_subblocks<int, std::complex<double>, double>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("Tx").noconvert(), py::arg("Tp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sp").noconvert(), py::arg("nsdomains"), py::arg("nrows"),
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Tx").noconvert(), py::arg("Tp"), py::arg("Sj"), py::arg("Sp"), py::arg("nsdomains"), py::arg("nrows"));
+    m.def("extract_subblocks", &_extract_subblocks<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Tx").noconvert(), py::arg("Tp"), py::arg("Sj"), py::arg("Sp"), py::arg("nsdomains"), py::arg("nrows"));
+    m.def("extract_subblocks", &_extract_subblocks<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Tx").noconvert(), py::arg("Tp"), py::arg("Sj"), py::arg("Sp"), py::arg("nsdomains"), py::arg("nrows"));
+    m.def("extract_subblocks", &_extract_subblocks<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Tx").noconvert(), py::arg("Tp"), py::arg("Sj"), py::arg("Sp"), py::arg("nsdomains"), py::arg("nrows"));
+    m.def("extract_subblocks", &_extract_subblocks<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Tx").noconvert(), py::arg("Tp"), py::arg("Sj"), py::arg("Sp"), py::arg("nsdomains"), py::arg("nrows"),
 R"pbdoc(
 Extract diagonal blocks from A and insert into a linear array.
  This is a helper function for overlapping_schwarz_csr.
@@ -936,13 +2898,21 @@ Extract diagonal blocks from A and insert into a linear array.
      Nothing, Tx will be modified in place)pbdoc");
 
     m.def("overlapping_schwarz_csr", &_overlapping_schwarz_csr<int, float, float>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("Tx").noconvert(), py::arg("Tp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sp").noconvert(), py::arg("nsdomains"), py::arg("nrows"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("Tp"), py::arg("Sj"), py::arg("Sp"), py::arg("nsdomains"), py::arg("nrows"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("workspace").noconvert());
     m.def("overlapping_schwarz_csr", &_overlapping_schwarz_csr<int, double, double>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("Tx").noconvert(), py::arg("Tp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sp").noconvert(), py::arg("nsdomains"), py::arg("nrows"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("Tp"), py::arg("Sj"), py::arg("Sp"), py::arg("nsdomains"), py::arg("nrows"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("workspace").noconvert());
     m.def("overlapping_schwarz_csr", &_overlapping_schwarz_csr<int, std::complex<float>, float>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("Tx").noconvert(), py::arg("Tp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sp").noconvert(), py::arg("nsdomains"), py::arg("nrows"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("Tp"), py::arg("Sj"), py::arg("Sp"), py::arg("nsdomains"), py::arg("nrows"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("workspace").noconvert());
     m.def("overlapping_schwarz_csr", &_overlapping_schwarz_csr<int, std::complex<double>, double>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("x").noconvert(), py::arg("b").noconvert(), py::arg("Tx").noconvert(), py::arg("Tp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sp").noconvert(), py::arg("nsdomains"), py::arg("nrows"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"),
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("Tp"), py::arg("Sj"), py::arg("Sp"), py::arg("nsdomains"), py::arg("nrows"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("workspace").noconvert());
+    m.def("overlapping_schwarz_csr", &_overlapping_schwarz_csr<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("Tp"), py::arg("Sj"), py::arg("Sp"), py::arg("nsdomains"), py::arg("nrows"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("workspace").noconvert());
+    m.def("overlapping_schwarz_csr", &_overlapping_schwarz_csr<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("Tp"), py::arg("Sj"), py::arg("Sp"), py::arg("nsdomains"), py::arg("nrows"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("workspace").noconvert());
+    m.def("overlapping_schwarz_csr", &_overlapping_schwarz_csr<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("Tp"), py::arg("Sj"), py::arg("Sp"), py::arg("nsdomains"), py::arg("nrows"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("workspace").noconvert());
+    m.def("overlapping_schwarz_csr", &_overlapping_schwarz_csr<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("Tp"), py::arg("Sj"), py::arg("Sp"), py::arg("nsdomains"), py::arg("nrows"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("workspace").noconvert(),
 R"pbdoc(
 Perform one iteration of an overlapping Schwarz relaxation on
  the linear system Ax = b, where A is stored in CSR format
@@ -970,10 +2940,692 @@ Perform one iteration of an overlapping Schwarz relaxation on
      row_start      --- The subdomains are processed in this order,
      row_stop       --- for(i = row_start, i != row_stop, i+=row_step)
      row_step       --- {...computation...}
+     workspace[]    - Scratch space of length at least 2*nrows.  If
+                      workspace is shorter, the scratch space is
+                      allocated internally.
+
+
+ Returns:
+     Nothing, x will be modified in place)pbdoc");
+
+    m.def("schwarz_factor", &_schwarz_factor<int, float, float>,
+        py::arg("Tx").noconvert(), py::arg("Tp"), py::arg("Sp"), py::arg("Tpiv").noconvert(), py::arg("nsdomains"), py::arg("tol"));
+    m.def("schwarz_factor", &_schwarz_factor<int, double, double>,
+        py::arg("Tx").noconvert(), py::arg("Tp"), py::arg("Sp"), py::arg("Tpiv").noconvert(), py::arg("nsdomains"), py::arg("tol"));
+    m.def("schwarz_factor", &_schwarz_factor<int, std::complex<float>, float>,
+        py::arg("Tx").noconvert(), py::arg("Tp"), py::arg("Sp"), py::arg("Tpiv").noconvert(), py::arg("nsdomains"), py::arg("tol"));
+    m.def("schwarz_factor", &_schwarz_factor<int, std::complex<double>, double>,
+        py::arg("Tx").noconvert(), py::arg("Tp"), py::arg("Sp"), py::arg("Tpiv").noconvert(), py::arg("nsdomains"), py::arg("tol"));
+    m.def("schwarz_factor", &_schwarz_factor<int64_t, float, float>,
+        py::arg("Tx").noconvert(), py::arg("Tp"), py::arg("Sp"), py::arg("Tpiv").noconvert(), py::arg("nsdomains"), py::arg("tol"));
+    m.def("schwarz_factor", &_schwarz_factor<int64_t, double, double>,
+        py::arg("Tx").noconvert(), py::arg("Tp"), py::arg("Sp"), py::arg("Tpiv").noconvert(), py::arg("nsdomains"), py::arg("tol"));
+    m.def("schwarz_factor", &_schwarz_factor<int64_t, std::complex<float>, float>,
+        py::arg("Tx").noconvert(), py::arg("Tp"), py::arg("Sp"), py::arg("Tpiv").noconvert(), py::arg("nsdomains"), py::arg("tol"));
+    m.def("schwarz_factor", &_schwarz_factor<int64_t, std::complex<double>, double>,
+        py::arg("Tx").noconvert(), py::arg("Tp"), py::arg("Sp"), py::arg("Tpiv").noconvert(), py::arg("nsdomains"), py::arg("tol"),
+R"pbdoc(
+LU factorization, with partial pivoting, of the diagonal block of A
+ for each subdomain, as extracted by extract_subblocks.  The factors
+ replace the blocks in Tx, so that they stay packed contiguously in
+ the order of the subdomains.  Used by overlapping_schwarz_lu_csr and
+ overlapping_schwarz_multicolor_csr.
+
+ Parameters
+     Tx[]       - Diagonal block of A for each subdomain, stored in
+                  row major.  Overwritten by the factors L and U of
+                  P A_i = L U, with the unit diagonal of L not stored.
+     Tp[]       - Pointer array into Tx indicating where the
+                  diagonal blocks start and stop
+     Sp[]       - Pointer array indicating where each subdomain
+                  starts and stops
+     Tpiv[]     - Pivots, row k of block i was swapped with row
+                  Tpiv[Sp[i] + k] at step k of the factorization.
+                  Tpiv[Sp[i]] is set to -1 if block i is singular.
+     nsdomains  - Number of subdomains
+     tol        - Block i is singular if a pivot is at most tol times
+                  the largest entry of the block in magnitude
+
+ Returns:
+     The number of singular blocks.  Tx is left partially factored
+     for these blocks, and they must be replaced, e.g., by their
+     pseudo-inverse, see overlapping_schwarz_lu_csr.)pbdoc");
+
+    m.def("overlapping_schwarz_lu_csr", &_overlapping_schwarz_lu_csr<int, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("Tp"), py::arg("Tpiv"), py::arg("Sj"), py::arg("Sp"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("workspace").noconvert());
+    m.def("overlapping_schwarz_lu_csr", &_overlapping_schwarz_lu_csr<int, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("Tp"), py::arg("Tpiv"), py::arg("Sj"), py::arg("Sp"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("workspace").noconvert());
+    m.def("overlapping_schwarz_lu_csr", &_overlapping_schwarz_lu_csr<int, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("Tp"), py::arg("Tpiv"), py::arg("Sj"), py::arg("Sp"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("workspace").noconvert());
+    m.def("overlapping_schwarz_lu_csr", &_overlapping_schwarz_lu_csr<int, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("Tp"), py::arg("Tpiv"), py::arg("Sj"), py::arg("Sp"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("workspace").noconvert());
+    m.def("overlapping_schwarz_lu_csr", &_overlapping_schwarz_lu_csr<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("Tp"), py::arg("Tpiv"), py::arg("Sj"), py::arg("Sp"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("workspace").noconvert());
+    m.def("overlapping_schwarz_lu_csr", &_overlapping_schwarz_lu_csr<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("Tp"), py::arg("Tpiv"), py::arg("Sj"), py::arg("Sp"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("workspace").noconvert());
+    m.def("overlapping_schwarz_lu_csr", &_overlapping_schwarz_lu_csr<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("Tp"), py::arg("Tpiv"), py::arg("Sj"), py::arg("Sp"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("workspace").noconvert());
+    m.def("overlapping_schwarz_lu_csr", &_overlapping_schwarz_lu_csr<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("Tp"), py::arg("Tpiv"), py::arg("Sj"), py::arg("Sp"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("workspace").noconvert(),
+R"pbdoc(
+Perform one iteration of an overlapping Schwarz relaxation on
+ the linear system Ax = b, where A is stored in CSR format
+ and x and b are column vectors, with the diagonal block of each
+ subdomain given by its LU factors.
+
+ This is overlapping_schwarz_csr, with the inverses replaced by the
+ factors from schwarz_factor, and may be mixed with explicit inverses,
+ see Tpiv.
+
+ Parameters
+     Ap[]           - CSR row pointer
+     Aj[]           - CSR index array
+     Ax[]           - CSR data array
+     x[]            - approximate solution
+     b[]            - right hand side
+     Tx[]           - LU factors of each diagonal block of A, stored
+                      in row major, see schwarz_factor
+     Tp[]           - Pointer array into Tx indicating where the
+                      diagonal blocks start and stop
+     Tpiv[]         - Pivots from schwarz_factor.  If Tpiv[Sp[i]] is -1,
+                      then Tx holds the inverse of block i instead.
+     Sj[]           - Indices of each subdomain
+     Sp[]           - Pointer array indicating where each subdomain
+                      starts and stops
+     row_start      --- The subdomains are processed in this order,
+     row_stop       --- for(i = row_start, i != row_stop, i+=row_step)
+     row_step       --- {...computation...}
+     workspace[]    - Scratch space of length at least twice the size
+                      of the largest subdomain.  If workspace is
+                      shorter, the scratch space is allocated
+                      internally.
+
+ Returns:
+     Nothing, x will be modified in place)pbdoc");
+
+    m.def("overlapping_schwarz_multicolor_csr", &_overlapping_schwarz_multicolor_csr<int, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("Tp"), py::arg("Tpiv"), py::arg("Sj"), py::arg("Sp"), py::arg("color_ptr"), py::arg("color_domains"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"), py::arg("workspace").noconvert());
+    m.def("overlapping_schwarz_multicolor_csr", &_overlapping_schwarz_multicolor_csr<int, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("Tp"), py::arg("Tpiv"), py::arg("Sj"), py::arg("Sp"), py::arg("color_ptr"), py::arg("color_domains"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"), py::arg("workspace").noconvert());
+    m.def("overlapping_schwarz_multicolor_csr", &_overlapping_schwarz_multicolor_csr<int, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("Tp"), py::arg("Tpiv"), py::arg("Sj"), py::arg("Sp"), py::arg("color_ptr"), py::arg("color_domains"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"), py::arg("workspace").noconvert());
+    m.def("overlapping_schwarz_multicolor_csr", &_overlapping_schwarz_multicolor_csr<int, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("Tp"), py::arg("Tpiv"), py::arg("Sj"), py::arg("Sp"), py::arg("color_ptr"), py::arg("color_domains"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"), py::arg("workspace").noconvert());
+    m.def("overlapping_schwarz_multicolor_csr", &_overlapping_schwarz_multicolor_csr<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("Tp"), py::arg("Tpiv"), py::arg("Sj"), py::arg("Sp"), py::arg("color_ptr"), py::arg("color_domains"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"), py::arg("workspace").noconvert());
+    m.def("overlapping_schwarz_multicolor_csr", &_overlapping_schwarz_multicolor_csr<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("Tp"), py::arg("Tpiv"), py::arg("Sj"), py::arg("Sp"), py::arg("color_ptr"), py::arg("color_domains"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"), py::arg("workspace").noconvert());
+    m.def("overlapping_schwarz_multicolor_csr", &_overlapping_schwarz_multicolor_csr<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("Tp"), py::arg("Tpiv"), py::arg("Sj"), py::arg("Sp"), py::arg("color_ptr"), py::arg("color_domains"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"), py::arg("workspace").noconvert());
+    m.def("overlapping_schwarz_multicolor_csr", &_overlapping_schwarz_multicolor_csr<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("Tx"), py::arg("Tp"), py::arg("Tpiv"), py::arg("Sj"), py::arg("Sp"), py::arg("color_ptr"), py::arg("color_domains"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"), py::arg("workspace").noconvert(),
+R"pbdoc(
+Perform one iteration of multicolor overlapping Schwarz relaxation on
+ the linear system Ax = b, where A is stored in CSR format and x and b
+ are column vectors.  The subdomains are grouped by a coloring such
+ that the subdomains of one color do not overlap and none reads x
+ where another writes it, so that the subdomains of one color are
+ independent and are processed in parallel.
+
+ Refer to overlapping_schwarz_lu_csr for Tx, Tp, Tpiv, Sj, and Sp, and
+ to gauss_seidel_multicolor for color_start, color_stop, and
+ color_step.
+
+ Parameters
+     Ap[]             - CSR row pointer
+     Aj[]             - CSR index array
+     Ax[]             - CSR data array
+     x[]              - approximate solution
+     b[]              - right hand side
+     Tx[]             - LU factors (or inverses) of the diagonal blocks
+     Tp[]             - Pointer array into Tx
+     Tpiv[]           - Pivots from schwarz_factor
+     Sj[]             - Indices of each subdomain
+     Sp[]             - Pointer array into Sj
+     color_ptr[]      - pointer into color_domains for each color
+     color_domains[]  - subdomains, grouped by color
+     color_start      - first color of the sweep
+     color_stop       - end of the sweep (i.e. one past the last color)
+     color_step       - stride used during the sweep (may be negative)
+     workspace[]      - Scratch space of length at least twice the size
+                        of the largest subdomain times the number of
+                        threads.  If workspace is shorter, the scratch
+                        space is allocated internally.
 
+ Returns:
+     Nothing, x will be modified in place
+
+ Notes:
+     The result does not depend on the number of threads.)pbdoc");
+
+    m.def("csr_residual_restrict", &_csr_residual_restrict<int, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x"), py::arg("b"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("coarse_b").noconvert());
+    m.def("csr_residual_restrict", &_csr_residual_restrict<int, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x"), py::arg("b"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("coarse_b").noconvert());
+    m.def("csr_residual_restrict", &_csr_residual_restrict<int, std::complex<float>>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x"), py::arg("b"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("coarse_b").noconvert());
+    m.def("csr_residual_restrict", &_csr_residual_restrict<int, std::complex<double>>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x"), py::arg("b"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("coarse_b").noconvert());
+    m.def("csr_residual_restrict", &_csr_residual_restrict<int64_t, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x"), py::arg("b"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("coarse_b").noconvert());
+    m.def("csr_residual_restrict", &_csr_residual_restrict<int64_t, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x"), py::arg("b"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("coarse_b").noconvert());
+    m.def("csr_residual_restrict", &_csr_residual_restrict<int64_t, std::complex<float>>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x"), py::arg("b"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("coarse_b").noconvert());
+    m.def("csr_residual_restrict", &_csr_residual_restrict<int64_t, std::complex<double>>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x"), py::arg("b"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("coarse_b").noconvert(),
+R"pbdoc(
+Compute the restricted residual coarse_b = R (b - A x) in a single
+ pass, where A is stored in CSR format and R^T is stored in CSR
+ format (i.e., R is stored in CSC format).
+
+ Each entry of the residual is computed from a row of A and then
+ immediately scattered into coarse_b through the same row of R^T,
+ so that the residual is never stored.
+
+ Parameters
+     Ap[]         - CSR row pointer of A
+     Aj[]         - CSR index array of A
+     Ax[]         - CSR data array of A
+     x[]          - approximate solution
+     b[]          - right hand side
+     Tp[]         - CSR row pointer of R^T
+     Tj[]         - CSR index array of R^T
+     Tx[]         - CSR data array of R^T
+     coarse_b[]   - restricted residual (output)
+
+ Returns:
+     Nothing, coarse_b will be overwritten
+
+ Notes:
+     R^T, not R^H, is used.  For R = P^H, R^T is the conjugate of P.)pbdoc");
+
+    m.def("bsr_residual_restrict", &_bsr_residual_restrict<int, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x"), py::arg("b"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("coarse_b").noconvert(), py::arg("blocksize"), py::arg("coarse_blocksize"));
+    m.def("bsr_residual_restrict", &_bsr_residual_restrict<int, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x"), py::arg("b"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("coarse_b").noconvert(), py::arg("blocksize"), py::arg("coarse_blocksize"));
+    m.def("bsr_residual_restrict", &_bsr_residual_restrict<int, std::complex<float>>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x"), py::arg("b"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("coarse_b").noconvert(), py::arg("blocksize"), py::arg("coarse_blocksize"));
+    m.def("bsr_residual_restrict", &_bsr_residual_restrict<int, std::complex<double>>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x"), py::arg("b"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("coarse_b").noconvert(), py::arg("blocksize"), py::arg("coarse_blocksize"));
+    m.def("bsr_residual_restrict", &_bsr_residual_restrict<int64_t, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x"), py::arg("b"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("coarse_b").noconvert(), py::arg("blocksize"), py::arg("coarse_blocksize"));
+    m.def("bsr_residual_restrict", &_bsr_residual_restrict<int64_t, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x"), py::arg("b"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("coarse_b").noconvert(), py::arg("blocksize"), py::arg("coarse_blocksize"));
+    m.def("bsr_residual_restrict", &_bsr_residual_restrict<int64_t, std::complex<float>>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x"), py::arg("b"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("coarse_b").noconvert(), py::arg("blocksize"), py::arg("coarse_blocksize"));
+    m.def("bsr_residual_restrict", &_bsr_residual_restrict<int64_t, std::complex<double>>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x"), py::arg("b"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("coarse_b").noconvert(), py::arg("blocksize"), py::arg("coarse_blocksize"),
+R"pbdoc(
+Compute the restricted residual coarse_b = R (b - A x) in a single
+ pass, where A is stored in BSR format with square blocks and R^T
+ is stored in BSR format with the same block row size as A.
+
+ Refer to csr_residual_restrict for additional information.
+
+ Parameters
+     Ap[]              - BSR row pointer of A
+     Aj[]              - BSR index array of A
+     Ax[]              - BSR data array of A
+     x[]               - approximate solution
+     b[]               - right hand side
+     Tp[]              - BSR row pointer of R^T
+     Tj[]              - BSR index array of R^T
+     Tx[]              - BSR data array of R^T
+     coarse_b[]        - restricted residual (output)
+     blocksize         - BSR blocksize of A
+     coarse_blocksize  - number of columns in each block of R^T
+
+ Returns:
+     Nothing, coarse_b will be overwritten)pbdoc");
+
+    m.def("csr_prolongate_add", &_csr_prolongate_add<int, float>,
+        py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("coarse_x"), py::arg("x").noconvert());
+    m.def("csr_prolongate_add", &_csr_prolongate_add<int, double>,
+        py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("coarse_x"), py::arg("x").noconvert());
+    m.def("csr_prolongate_add", &_csr_prolongate_add<int, std::complex<float>>,
+        py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("coarse_x"), py::arg("x").noconvert());
+    m.def("csr_prolongate_add", &_csr_prolongate_add<int, std::complex<double>>,
+        py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("coarse_x"), py::arg("x").noconvert());
+    m.def("csr_prolongate_add", &_csr_prolongate_add<int64_t, float>,
+        py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("coarse_x"), py::arg("x").noconvert());
+    m.def("csr_prolongate_add", &_csr_prolongate_add<int64_t, double>,
+        py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("coarse_x"), py::arg("x").noconvert());
+    m.def("csr_prolongate_add", &_csr_prolongate_add<int64_t, std::complex<float>>,
+        py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("coarse_x"), py::arg("x").noconvert());
+    m.def("csr_prolongate_add", &_csr_prolongate_add<int64_t, std::complex<double>>,
+        py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("coarse_x"), py::arg("x").noconvert(),
+R"pbdoc(
+Apply the coarse grid correction x += P coarse_x in place, where P
+ is stored in CSR format.
+
+ Parameters
+     Pp[]         - CSR row pointer of P
+     Pj[]         - CSR index array of P
+     Px[]         - CSR data array of P
+     coarse_x[]   - coarse grid correction
+     x[]          - approximate solution
+
+ Returns:
+     Nothing, x will be modified in place)pbdoc");
+
+    m.def("bsr_prolongate_add", &_bsr_prolongate_add<int, float>,
+        py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("coarse_x"), py::arg("x").noconvert(), py::arg("blocksize"), py::arg("coarse_blocksize"));
+    m.def("bsr_prolongate_add", &_bsr_prolongate_add<int, double>,
+        py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("coarse_x"), py::arg("x").noconvert(), py::arg("blocksize"), py::arg("coarse_blocksize"));
+    m.def("bsr_prolongate_add", &_bsr_prolongate_add<int, std::complex<float>>,
+        py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("coarse_x"), py::arg("x").noconvert(), py::arg("blocksize"), py::arg("coarse_blocksize"));
+    m.def("bsr_prolongate_add", &_bsr_prolongate_add<int, std::complex<double>>,
+        py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("coarse_x"), py::arg("x").noconvert(), py::arg("blocksize"), py::arg("coarse_blocksize"));
+    m.def("bsr_prolongate_add", &_bsr_prolongate_add<int64_t, float>,
+        py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("coarse_x"), py::arg("x").noconvert(), py::arg("blocksize"), py::arg("coarse_blocksize"));
+    m.def("bsr_prolongate_add", &_bsr_prolongate_add<int64_t, double>,
+        py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("coarse_x"), py::arg("x").noconvert(), py::arg("blocksize"), py::arg("coarse_blocksize"));
+    m.def("bsr_prolongate_add", &_bsr_prolongate_add<int64_t, std::complex<float>>,
+        py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("coarse_x"), py::arg("x").noconvert(), py::arg("blocksize"), py::arg("coarse_blocksize"));
+    m.def("bsr_prolongate_add", &_bsr_prolongate_add<int64_t, std::complex<double>>,
+        py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("coarse_x"), py::arg("x").noconvert(), py::arg("blocksize"), py::arg("coarse_blocksize"),
+R"pbdoc(
+Apply the coarse grid correction x += P coarse_x in place, where P
+ is stored in BSR format.
+
+ Parameters
+     Pp[]              - BSR row pointer of P
+     Pj[]              - BSR index array of P
+     Px[]              - BSR data array of P
+     coarse_x[]        - coarse grid correction
+     x[]               - approximate solution
+     blocksize         - number of rows in each block of P
+     coarse_blocksize  - number of columns in each block of P
+
+ Returns:
+     Nothing, x will be modified in place)pbdoc");
+
+    m.def("gauss_seidel_delta", &_gauss_seidel_delta<int, float, float>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"));
+    m.def("gauss_seidel_delta", &_gauss_seidel_delta<int, double, double>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"));
+    m.def("gauss_seidel_delta", &_gauss_seidel_delta<int, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"));
+    m.def("gauss_seidel_delta", &_gauss_seidel_delta<int, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"));
+    m.def("gauss_seidel_delta", &_gauss_seidel_delta<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"));
+    m.def("gauss_seidel_delta", &_gauss_seidel_delta<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"));
+    m.def("gauss_seidel_delta", &_gauss_seidel_delta<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"));
+    m.def("gauss_seidel_delta", &_gauss_seidel_delta<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"),
+R"pbdoc(
+Perform one iteration of Gauss-Seidel relaxation on the linear
+ system Ax = b, where A is stored in CSR format with delta encoded
+ column indices, see csr_delta_matvec in sparse.h.
+
+ Refer to gauss_seidel for additional information regarding
+ row_start, row_stop, and row_step.
+
+ Parameters
+     Ap[]       - CSR row pointer
+     Ab[]       - column of the first entry of each row
+     Ad[]       - offset of each column from the previous one in its row
+     Ax[]       - CSR data array
+     x[]        - approximate solution
+     b[]        - right hand side
+     row_start  - beginning of the sweep
+     row_stop   - end of the sweep (i.e. one past the last unknown)
+     row_step   - stride used during the sweep (may be negative)
+
+ Returns:
+     Nothing, x will be modified in place)pbdoc");
+
+    m.def("gauss_seidel_multicolor_delta", &_gauss_seidel_multicolor_delta<int, float, float>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("color_ptr"), py::arg("color_rows"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"));
+    m.def("gauss_seidel_multicolor_delta", &_gauss_seidel_multicolor_delta<int, double, double>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("color_ptr"), py::arg("color_rows"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"));
+    m.def("gauss_seidel_multicolor_delta", &_gauss_seidel_multicolor_delta<int, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("color_ptr"), py::arg("color_rows"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"));
+    m.def("gauss_seidel_multicolor_delta", &_gauss_seidel_multicolor_delta<int, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("color_ptr"), py::arg("color_rows"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"));
+    m.def("gauss_seidel_multicolor_delta", &_gauss_seidel_multicolor_delta<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("color_ptr"), py::arg("color_rows"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"));
+    m.def("gauss_seidel_multicolor_delta", &_gauss_seidel_multicolor_delta<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("color_ptr"), py::arg("color_rows"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"));
+    m.def("gauss_seidel_multicolor_delta", &_gauss_seidel_multicolor_delta<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("color_ptr"), py::arg("color_rows"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"));
+    m.def("gauss_seidel_multicolor_delta", &_gauss_seidel_multicolor_delta<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("color_ptr"), py::arg("color_rows"), py::arg("color_start"), py::arg("color_stop"), py::arg("color_step"),
+R"pbdoc(
+Perform one iteration of multicolor Gauss-Seidel relaxation on the
+ linear system Ax = b, where A is stored in CSR format with delta
+ encoded column indices, see csr_delta_matvec in sparse.h.
+
+ Refer to gauss_seidel_multicolor for additional information
+ regarding color_ptr, color_rows, color_start, color_stop, and
+ color_step.
+
+ Parameters
+     Ap[]          - CSR row pointer
+     Ab[]          - column of the first entry of each row
+     Ad[]          - offset of each column from the previous one in its row
+     Ax[]          - CSR data array
+     x[]           - approximate solution
+     b[]           - right hand side
+     color_ptr[]   - pointer into color_rows for each color
+     color_rows[]  - rows of A, grouped by color
+     color_start   - first color of the sweep
+     color_stop    - end of the sweep (i.e. one past the last color)
+     color_step    - stride used during the sweep (may be negative)
+
+ Returns:
+     Nothing, x will be modified in place)pbdoc");
+
+    m.def("jacobi_delta", &_jacobi_delta<int, float, float>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"));
+    m.def("jacobi_delta", &_jacobi_delta<int, double, double>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"));
+    m.def("jacobi_delta", &_jacobi_delta<int, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"));
+    m.def("jacobi_delta", &_jacobi_delta<int, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"));
+    m.def("jacobi_delta", &_jacobi_delta<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"));
+    m.def("jacobi_delta", &_jacobi_delta<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"));
+    m.def("jacobi_delta", &_jacobi_delta<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"));
+    m.def("jacobi_delta", &_jacobi_delta<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("omega"),
+R"pbdoc(
+Perform one iteration of Jacobi relaxation on the linear system
+ Ax = b, where A is stored in CSR format with delta encoded column
+ indices, see csr_delta_matvec in sparse.h.
+
+ Refer to jacobi for additional information.
+
+ Parameters
+     Ap[]       - CSR row pointer
+     Ab[]       - column of the first entry of each row
+     Ad[]       - offset of each column from the previous one in its row
+     Ax[]       - CSR data array
+     x[]        - approximate solution
+     b[]        - right hand side
+     temp[]     - temporary vector the same size as x
+     row_start  - beginning of the sweep
+     row_stop   - end of the sweep (i.e. one past the last unknown)
+     row_step   - stride used during the sweep (may be negative)
+     omega      - damping parameter
+
+ Returns:
+     Nothing, x will be modified in place)pbdoc");
+
+    m.def("aggregate_prolongate_add", &_aggregate_prolongate_add<int, float>,
+        py::arg("Pj"), py::arg("Px"), py::arg("coarse_x"), py::arg("x").noconvert(), py::arg("blocksize"), py::arg("coarse_blocksize"));
+    m.def("aggregate_prolongate_add", &_aggregate_prolongate_add<int, double>,
+        py::arg("Pj"), py::arg("Px"), py::arg("coarse_x"), py::arg("x").noconvert(), py::arg("blocksize"), py::arg("coarse_blocksize"));
+    m.def("aggregate_prolongate_add", &_aggregate_prolongate_add<int, std::complex<float>>,
+        py::arg("Pj"), py::arg("Px"), py::arg("coarse_x"), py::arg("x").noconvert(), py::arg("blocksize"), py::arg("coarse_blocksize"));
+    m.def("aggregate_prolongate_add", &_aggregate_prolongate_add<int, std::complex<double>>,
+        py::arg("Pj"), py::arg("Px"), py::arg("coarse_x"), py::arg("x").noconvert(), py::arg("blocksize"), py::arg("coarse_blocksize"));
+    m.def("aggregate_prolongate_add", &_aggregate_prolongate_add<int64_t, float>,
+        py::arg("Pj"), py::arg("Px"), py::arg("coarse_x"), py::arg("x").noconvert(), py::arg("blocksize"), py::arg("coarse_blocksize"));
+    m.def("aggregate_prolongate_add", &_aggregate_prolongate_add<int64_t, double>,
+        py::arg("Pj"), py::arg("Px"), py::arg("coarse_x"), py::arg("x").noconvert(), py::arg("blocksize"), py::arg("coarse_blocksize"));
+    m.def("aggregate_prolongate_add", &_aggregate_prolongate_add<int64_t, std::complex<float>>,
+        py::arg("Pj"), py::arg("Px"), py::arg("coarse_x"), py::arg("x").noconvert(), py::arg("blocksize"), py::arg("coarse_blocksize"));
+    m.def("aggregate_prolongate_add", &_aggregate_prolongate_add<int64_t, std::complex<double>>,
+        py::arg("Pj"), py::arg("Px"), py::arg("coarse_x"), py::arg("x").noconvert(), py::arg("blocksize"), py::arg("coarse_blocksize"),
+R"pbdoc(
+Apply the coarse grid correction x += P coarse_x in place, where P
+ has at most one block per block row, as a tentative prolongator, and
+ is stored by its aggregate map: block row i of P is the block
+ Px[i] in block column Pj[i], or zero if Pj[i] is negative.
+
+ Parameters
+     Pj[]              - block column of each block row of P, or -1
+     Px[]              - block of each block row of P
+     coarse_x[]        - coarse grid correction
+     x[]               - approximate solution
+     blocksize         - number of rows in each block of P
+     coarse_blocksize  - number of columns in each block of P
+
+ Returns:
+     Nothing, x will be modified in place)pbdoc");
+
+    m.def("aggregate_restrict", &_aggregate_restrict<int, float>,
+        py::arg("Pj"), py::arg("Px"), py::arg("r"), py::arg("coarse_b").noconvert(), py::arg("blocksize"), py::arg("coarse_blocksize"));
+    m.def("aggregate_restrict", &_aggregate_restrict<int, double>,
+        py::arg("Pj"), py::arg("Px"), py::arg("r"), py::arg("coarse_b").noconvert(), py::arg("blocksize"), py::arg("coarse_blocksize"));
+    m.def("aggregate_restrict", &_aggregate_restrict<int, std::complex<float>>,
+        py::arg("Pj"), py::arg("Px"), py::arg("r"), py::arg("coarse_b").noconvert(), py::arg("blocksize"), py::arg("coarse_blocksize"));
+    m.def("aggregate_restrict", &_aggregate_restrict<int, std::complex<double>>,
+        py::arg("Pj"), py::arg("Px"), py::arg("r"), py::arg("coarse_b").noconvert(), py::arg("blocksize"), py::arg("coarse_blocksize"));
+    m.def("aggregate_restrict", &_aggregate_restrict<int64_t, float>,
+        py::arg("Pj"), py::arg("Px"), py::arg("r"), py::arg("coarse_b").noconvert(), py::arg("blocksize"), py::arg("coarse_blocksize"));
+    m.def("aggregate_restrict", &_aggregate_restrict<int64_t, double>,
+        py::arg("Pj"), py::arg("Px"), py::arg("r"), py::arg("coarse_b").noconvert(), py::arg("blocksize"), py::arg("coarse_blocksize"));
+    m.def("aggregate_restrict", &_aggregate_restrict<int64_t, std::complex<float>>,
+        py::arg("Pj"), py::arg("Px"), py::arg("r"), py::arg("coarse_b").noconvert(), py::arg("blocksize"), py::arg("coarse_blocksize"));
+    m.def("aggregate_restrict", &_aggregate_restrict<int64_t, std::complex<double>>,
+        py::arg("Pj"), py::arg("Px"), py::arg("r"), py::arg("coarse_b").noconvert(), py::arg("blocksize"), py::arg("coarse_blocksize"),
+R"pbdoc(
+Restrict coarse_b = P^H r, where P is stored by its aggregate map,
+ see aggregate_prolongate_add.
+
+ Parameters
+     Pj[]              - block column of each block row of P, or -1
+     Px[]              - block of each block row of P
+     r[]               - fine level vector, e.g., the residual
+     coarse_b[]        - restricted vector (output)
+     blocksize         - number of rows in each block of P
+     coarse_blocksize  - number of columns in each block of P
+
+ Returns:
+     Nothing, coarse_b will be overwritten
+
+ Notes:
+     The block rows of P are scattered into coarse_b, so this is not
+     threaded.)pbdoc");
+
+    m.def("gauss_seidel_multi", &_gauss_seidel_multi<int, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("nrhs"));
+    m.def("gauss_seidel_multi", &_gauss_seidel_multi<int, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("nrhs"));
+    m.def("gauss_seidel_multi", &_gauss_seidel_multi<int, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("nrhs"));
+    m.def("gauss_seidel_multi", &_gauss_seidel_multi<int, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("nrhs"));
+    m.def("gauss_seidel_multi", &_gauss_seidel_multi<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("nrhs"));
+    m.def("gauss_seidel_multi", &_gauss_seidel_multi<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("nrhs"));
+    m.def("gauss_seidel_multi", &_gauss_seidel_multi<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("nrhs"));
+    m.def("gauss_seidel_multi", &_gauss_seidel_multi<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("nrhs"),
+R"pbdoc(
+Perform one iteration of Gauss-Seidel relaxation on the linear
+ systems A X = B, where A is stored in CSR format and X and B hold
+ nrhs column vectors, stored in row major (C) order, i.e., x[i*nrhs + k]
+ is entry i of the k-th vector.
+
+ Each row of A is read once for all nrhs vectors, and the result for
+ each vector is the same as with gauss_seidel.
+
+ Parameters
+     Ap[]       - CSR row pointer
+     Aj[]       - CSR index array
+     Ax[]       - CSR data array
+     x[]        - approximate solutions, n x nrhs
+     b[]        - right hand sides, n x nrhs
+     row_start  - beginning of the sweep
+     row_stop   - end of the sweep (i.e. one past the last unknown)
+     row_step   - stride used during the sweep (may be negative)
+     nrhs       - number of vectors in x and b
+
+ Returns:
+     Nothing, x will be modified in place)pbdoc");
+
+    m.def("jacobi_multi", &_jacobi_multi<int, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("nrhs"), py::arg("omega"));
+    m.def("jacobi_multi", &_jacobi_multi<int, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("nrhs"), py::arg("omega"));
+    m.def("jacobi_multi", &_jacobi_multi<int, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("nrhs"), py::arg("omega"));
+    m.def("jacobi_multi", &_jacobi_multi<int, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("nrhs"), py::arg("omega"));
+    m.def("jacobi_multi", &_jacobi_multi<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("nrhs"), py::arg("omega"));
+    m.def("jacobi_multi", &_jacobi_multi<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("nrhs"), py::arg("omega"));
+    m.def("jacobi_multi", &_jacobi_multi<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("nrhs"), py::arg("omega"));
+    m.def("jacobi_multi", &_jacobi_multi<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x").noconvert(), py::arg("b"), py::arg("temp").noconvert(), py::arg("row_start"), py::arg("row_stop"), py::arg("row_step"), py::arg("nrhs"), py::arg("omega"),
+R"pbdoc(
+Perform one iteration of Jacobi relaxation on the linear systems
+ A X = B, where A is stored in CSR format and X and B hold nrhs column
+ vectors, stored in row major order as for gauss_seidel_multi.
+
+ Refer to jacobi for additional information.
+
+ Parameters
+     Ap[]       - CSR row pointer
+     Aj[]       - CSR index array
+     Ax[]       - CSR data array
+     x[]        - approximate solutions, n x nrhs
+     b[]        - right hand sides, n x nrhs
+     temp[]     - temporary array the same size as x
+     row_start  - beginning of the sweep
+     row_stop   - end of the sweep (i.e. one past the last unknown)
+     row_step   - stride used during the sweep (may be negative)
+     nrhs       - number of vectors in x and b
+     omega      - damping parameter
+
+ Returns:
+     Nothing, x will be modified in place)pbdoc");
+
+    m.def("csr_residual_restrict_multi", &_csr_residual_restrict_multi<int, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x"), py::arg("b"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("coarse_b").noconvert(), py::arg("nrhs"));
+    m.def("csr_residual_restrict_multi", &_csr_residual_restrict_multi<int, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x"), py::arg("b"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("coarse_b").noconvert(), py::arg("nrhs"));
+    m.def("csr_residual_restrict_multi", &_csr_residual_restrict_multi<int, std::complex<float>>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x"), py::arg("b"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("coarse_b").noconvert(), py::arg("nrhs"));
+    m.def("csr_residual_restrict_multi", &_csr_residual_restrict_multi<int, std::complex<double>>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x"), py::arg("b"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("coarse_b").noconvert(), py::arg("nrhs"));
+    m.def("csr_residual_restrict_multi", &_csr_residual_restrict_multi<int64_t, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x"), py::arg("b"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("coarse_b").noconvert(), py::arg("nrhs"));
+    m.def("csr_residual_restrict_multi", &_csr_residual_restrict_multi<int64_t, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x"), py::arg("b"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("coarse_b").noconvert(), py::arg("nrhs"));
+    m.def("csr_residual_restrict_multi", &_csr_residual_restrict_multi<int64_t, std::complex<float>>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x"), py::arg("b"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("coarse_b").noconvert(), py::arg("nrhs"));
+    m.def("csr_residual_restrict_multi", &_csr_residual_restrict_multi<int64_t, std::complex<double>>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("x"), py::arg("b"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("coarse_b").noconvert(), py::arg("nrhs"),
+R"pbdoc(
+Compute the restricted residuals coarse_b = R (b - A x) in a single
+ pass for nrhs vectors, where A and R^T are stored in CSR format, and
+ x, b and coarse_b are stored in row major order, as for
+ gauss_seidel_multi.
+
+ Refer to csr_residual_restrict for additional information.
+
+ Parameters
+     Ap[]         - CSR row pointer of A
+     Aj[]         - CSR index array of A
+     Ax[]         - CSR data array of A
+     x[]          - approximate solutions, n x nrhs
+     b[]          - right hand sides, n x nrhs
+     Tp[]         - CSR row pointer of R^T
+     Tj[]         - CSR index array of R^T
+     Tx[]         - CSR data array of R^T
+     coarse_b[]   - restricted residuals (output), n_coarse x nrhs
+     nrhs         - number of vectors in x and b
+
+ Returns:
+     Nothing, coarse_b will be overwritten)pbdoc");
+
+    m.def("csr_prolongate_add_multi", &_csr_prolongate_add_multi<int, float>,
+        py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("coarse_x"), py::arg("x").noconvert(), py::arg("nrhs"));
+    m.def("csr_prolongate_add_multi", &_csr_prolongate_add_multi<int, double>,
+        py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("coarse_x"), py::arg("x").noconvert(), py::arg("nrhs"));
+    m.def("csr_prolongate_add_multi", &_csr_prolongate_add_multi<int, std::complex<float>>,
+        py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("coarse_x"), py::arg("x").noconvert(), py::arg("nrhs"));
+    m.def("csr_prolongate_add_multi", &_csr_prolongate_add_multi<int, std::complex<double>>,
+        py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("coarse_x"), py::arg("x").noconvert(), py::arg("nrhs"));
+    m.def("csr_prolongate_add_multi", &_csr_prolongate_add_multi<int64_t, float>,
+        py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("coarse_x"), py::arg("x").noconvert(), py::arg("nrhs"));
+    m.def("csr_prolongate_add_multi", &_csr_prolongate_add_multi<int64_t, double>,
+        py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("coarse_x"), py::arg("x").noconvert(), py::arg("nrhs"));
+    m.def("csr_prolongate_add_multi", &_csr_prolongate_add_multi<int64_t, std::complex<float>>,
+        py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("coarse_x"), py::arg("x").noconvert(), py::arg("nrhs"));
+    m.def("csr_prolongate_add_multi", &_csr_prolongate_add_multi<int64_t, std::complex<double>>,
+        py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("coarse_x"), py::arg("x").noconvert(), py::arg("nrhs"),
+R"pbdoc(
+Apply the coarse grid corrections x += P coarse_x in place for nrhs
+ vectors, where P is stored in CSR format, and x and coarse_x are
+ stored in row major order, as for gauss_seidel_multi.
+
+ Parameters
+     Pp[]         - CSR row pointer of P
+     Pj[]         - CSR index array of P
+     Px[]         - CSR data array of P
+     coarse_x[]   - coarse grid corrections, n_coarse x nrhs
+     x[]          - approximate solutions, n x nrhs
+     nrhs         - number of vectors in x and coarse_x
 
  Returns:
      Nothing, x will be modified in place)pbdoc");
 
+    m.def("multigrid_cycle", &_multigrid_cycle<int, float, float>,
+        py::arg("levels"), py::arg("index"), py::arg("data"), py::arg("work").noconvert(), py::arg("x").noconvert(), py::arg("b"), py::arg("cycle"));
+    m.def("multigrid_cycle", &_multigrid_cycle<int, double, double>,
+        py::arg("levels"), py::arg("index"), py::arg("data"), py::arg("work").noconvert(), py::arg("x").noconvert(), py::arg("b"), py::arg("cycle"));
+    m.def("multigrid_cycle", &_multigrid_cycle<int, std::complex<float>, float>,
+        py::arg("levels"), py::arg("index"), py::arg("data"), py::arg("work").noconvert(), py::arg("x").noconvert(), py::arg("b"), py::arg("cycle"));
+    m.def("multigrid_cycle", &_multigrid_cycle<int, std::complex<double>, double>,
+        py::arg("levels"), py::arg("index"), py::arg("data"), py::arg("work").noconvert(), py::arg("x").noconvert(), py::arg("b"), py::arg("cycle"));
+    m.def("multigrid_cycle", &_multigrid_cycle<int64_t, float, float>,
+        py::arg("levels"), py::arg("index"), py::arg("data"), py::arg("work").noconvert(), py::arg("x").noconvert(), py::arg("b"), py::arg("cycle"));
+    m.def("multigrid_cycle", &_multigrid_cycle<int64_t, double, double>,
+        py::arg("levels"), py::arg("index"), py::arg("data"), py::arg("work").noconvert(), py::arg("x").noconvert(), py::arg("b"), py::arg("cycle"));
+    m.def("multigrid_cycle", &_multigrid_cycle<int64_t, std::complex<float>, float>,
+        py::arg("levels"), py::arg("index"), py::arg("data"), py::arg("work").noconvert(), py::arg("x").noconvert(), py::arg("b"), py::arg("cycle"));
+    m.def("multigrid_cycle", &_multigrid_cycle<int64_t, std::complex<double>, double>,
+        py::arg("levels"), py::arg("index"), py::arg("data"), py::arg("work").noconvert(), py::arg("x").noconvert(), py::arg("b"), py::arg("cycle"),
+R"pbdoc(
+Perform one multigrid cycle for A x = b on a whole hierarchy, i.e.,
+ presmoothing, the restriction of the residual, the coarse grid
+ correction, and postsmoothing on each level, as
+ multilevel_solver.solve does in Python, but without returning to
+ Python between the levels.
+
+ The hierarchy has levels_size / CYCLE_LEVEL_SIZE levels, which are
+ described by levels[] as laid out above.  The last level is solved
+ directly.  The operations of each level are those of the kernels
+ gauss_seidel, jacobi (or their BSR counterparts),
+ csr/bsr_residual_restrict, and csr/bsr_prolongate_add, in the same
+ order as in Python, so that the result agrees with the Python cycle
+ up to the rounding of the coarse solve.
+
+ Parameters
+     levels[]  - level descriptors, CYCLE_LEVEL_SIZE for each level
+     index[]   - row pointers and indices of the level matrices, and
+                 the pivots of the coarse factorization
+     data[]    - values of the level matrices, the Jacobi weights,
+                 and the dense coarse factorization (row major)
+     work[]    - workspace, 3 n for each level of n unknowns, at the
+                 offsets CYCLE_WORK of the descriptors
+     x[]       - approximate solution on the first level
+     b[]       - right hand side on the first level
+     cycle     - CYCLE_V, CYCLE_W, or CYCLE_F
+
+ Returns:
+     Nothing, x will be modified in place
+
+ Notes:
+     Only the smoothers, matrix formats and coarse solvers listed
+     above are supported natively.  multilevel_solver falls back to
+     the Python cycle for any other hierarchy.)pbdoc");
+
 }
 
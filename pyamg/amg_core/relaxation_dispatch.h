@@ -0,0 +1,708 @@
+// DO NOT EDIT: this file is generated
+
+#ifndef RELAXATION_DISPATCH_H
+#define RELAXATION_DISPATCH_H
+
+template<class I, class T, class F>
+void bsr_gauss_seidel(const I Ap[],
+                      const int Ap_size,
+                      const I Aj[],
+                      const int Aj_size,
+                      const T Ax[],
+                      const int Ax_size,
+                      T x[],
+                      const int x_size,
+                      const T b[],
+                      const int b_size,
+                      const I row_start,
+                      const I row_stop,
+                      const I row_step,
+                      const I blocksize)
+{
+    switch(blocksize){
+        case 2:
+            bsr_gauss_seidel_impl<I, T, F, 2>(Ap,
+                                              Ap_size,
+                                              Aj,
+                                              Aj_size,
+                                              Ax,
+                                              Ax_size,
+                                              x,
+                                              x_size,
+                                              b,
+                                              b_size,
+                                              row_start,
+                                              row_stop,
+                                              row_step,
+                                              blocksize);
+            return;
+        case 3:
+            bsr_gauss_seidel_impl<I, T, F, 3>(Ap,
+                                              Ap_size,
+                                              Aj,
+                                              Aj_size,
+                                              Ax,
+                                              Ax_size,
+                                              x,
+                                              x_size,
+                                              b,
+                                              b_size,
+                                              row_start,
+                                              row_stop,
+                                              row_step,
+                                              blocksize);
+            return;
+        case 4:
+            bsr_gauss_seidel_impl<I, T, F, 4>(Ap,
+                                              Ap_size,
+                                              Aj,
+                                              Aj_size,
+                                              Ax,
+                                              Ax_size,
+                                              x,
+                                              x_size,
+                                              b,
+                                              b_size,
+                                              row_start,
+                                              row_stop,
+                                              row_step,
+                                              blocksize);
+            return;
+        case 6:
+            bsr_gauss_seidel_impl<I, T, F, 6>(Ap,
+                                              Ap_size,
+                                              Aj,
+                                              Aj_size,
+                                              Ax,
+                                              Ax_size,
+                                              x,
+                                              x_size,
+                                              b,
+                                              b_size,
+                                              row_start,
+                                              row_stop,
+                                              row_step,
+                                              blocksize);
+            return;
+    }
+
+    bsr_gauss_seidel_impl<I, T, F, 0>(Ap,
+                                      Ap_size,
+                                      Aj,
+                                      Aj_size,
+                                      Ax,
+                                      Ax_size,
+                                      x,
+                                      x_size,
+                                      b,
+                                      b_size,
+                                      row_start,
+                                      row_stop,
+                                      row_step,
+                                      blocksize);
+}
+
+template<class I, class T, class F>
+void bsr_gauss_seidel_multicolor(const I Ap[],
+                                 const int Ap_size,
+                                 const I Aj[],
+                                 const int Aj_size,
+                                 const T Ax[],
+                                 const int Ax_size,
+                                 T x[],
+                                 const int x_size,
+                                 const T b[],
+                                 const int b_size,
+                                 const I color_ptr[],
+                                 const int color_ptr_size,
+                                 const I color_rows[],
+                                 const int color_rows_size,
+                                 const I color_start,
+                                 const I color_stop,
+                                 const I color_step,
+                                 const I blocksize)
+{
+    switch(blocksize){
+        case 2:
+            bsr_gauss_seidel_multicolor_impl<I, T, F, 2>(Ap,
+                                                         Ap_size,
+                                                         Aj,
+                                                         Aj_size,
+                                                         Ax,
+                                                         Ax_size,
+                                                         x,
+                                                         x_size,
+                                                         b,
+                                                         b_size,
+                                                         color_ptr,
+                                                         color_ptr_size,
+                                                         color_rows,
+                                                         color_rows_size,
+                                                         color_start,
+                                                         color_stop,
+                                                         color_step,
+                                                         blocksize);
+            return;
+        case 3:
+            bsr_gauss_seidel_multicolor_impl<I, T, F, 3>(Ap,
+                                                         Ap_size,
+                                                         Aj,
+                                                         Aj_size,
+                                                         Ax,
+                                                         Ax_size,
+                                                         x,
+                                                         x_size,
+                                                         b,
+                                                         b_size,
+                                                         color_ptr,
+                                                         color_ptr_size,
+                                                         color_rows,
+                                                         color_rows_size,
+                                                         color_start,
+                                                         color_stop,
+                                                         color_step,
+                                                         blocksize);
+            return;
+        case 4:
+            bsr_gauss_seidel_multicolor_impl<I, T, F, 4>(Ap,
+                                                         Ap_size,
+                                                         Aj,
+                                                         Aj_size,
+                                                         Ax,
+                                                         Ax_size,
+                                                         x,
+                                                         x_size,
+                                                         b,
+                                                         b_size,
+                                                         color_ptr,
+                                                         color_ptr_size,
+                                                         color_rows,
+                                                         color_rows_size,
+                                                         color_start,
+                                                         color_stop,
+                                                         color_step,
+                                                         blocksize);
+            return;
+        case 6:
+            bsr_gauss_seidel_multicolor_impl<I, T, F, 6>(Ap,
+                                                         Ap_size,
+                                                         Aj,
+                                                         Aj_size,
+                                                         Ax,
+                                                         Ax_size,
+                                                         x,
+                                                         x_size,
+                                                         b,
+                                                         b_size,
+                                                         color_ptr,
+                                                         color_ptr_size,
+                                                         color_rows,
+                                                         color_rows_size,
+                                                         color_start,
+                                                         color_stop,
+                                                         color_step,
+                                                         blocksize);
+            return;
+    }
+
+    bsr_gauss_seidel_multicolor_impl<I, T, F, 0>(Ap,
+                                                 Ap_size,
+                                                 Aj,
+                                                 Aj_size,
+                                                 Ax,
+                                                 Ax_size,
+                                                 x,
+                                                 x_size,
+                                                 b,
+                                                 b_size,
+                                                 color_ptr,
+                                                 color_ptr_size,
+                                                 color_rows,
+                                                 color_rows_size,
+                                                 color_start,
+                                                 color_stop,
+                                                 color_step,
+                                                 blocksize);
+}
+
+template<class I, class T, class F>
+void bsr_jacobi(const I Ap[],
+                const int Ap_size,
+                const I Aj[],
+                const int Aj_size,
+                const T Ax[],
+                const int Ax_size,
+                T x[],
+                const int x_size,
+                const T b[],
+                const int b_size,
+                T temp[],
+                const int temp_size,
+                const I row_start,
+                const I row_stop,
+                const I row_step,
+                const I blocksize,
+                const T omega[],
+                const int omega_size)
+{
+    switch(blocksize){
+        case 2:
+            bsr_jacobi_impl<I, T, F, 2>(Ap,
+                                        Ap_size,
+                                        Aj,
+                                        Aj_size,
+                                        Ax,
+                                        Ax_size,
+                                        x,
+                                        x_size,
+                                        b,
+                                        b_size,
+                                        temp,
+                                        temp_size,
+                                        row_start,
+                                        row_stop,
+                                        row_step,
+                                        blocksize,
+                                        omega,
+                                        omega_size);
+            return;
+        case 3:
+            bsr_jacobi_impl<I, T, F, 3>(Ap,
+                                        Ap_size,
+                                        Aj,
+                                        Aj_size,
+                                        Ax,
+                                        Ax_size,
+                                        x,
+                                        x_size,
+                                        b,
+                                        b_size,
+                                        temp,
+                                        temp_size,
+                                        row_start,
+                                        row_stop,
+                                        row_step,
+                                        blocksize,
+                                        omega,
+                                        omega_size);
+            return;
+        case 4:
+            bsr_jacobi_impl<I, T, F, 4>(Ap,
+                                        Ap_size,
+                                        Aj,
+                                        Aj_size,
+                                        Ax,
+                                        Ax_size,
+                                        x,
+                                        x_size,
+                                        b,
+                                        b_size,
+                                        temp,
+                                        temp_size,
+                                        row_start,
+                                        row_stop,
+                                        row_step,
+                                        blocksize,
+                                        omega,
+                                        omega_size);
+            return;
+        case 6:
+            bsr_jacobi_impl<I, T, F, 6>(Ap,
+                                        Ap_size,
+                                        Aj,
+                                        Aj_size,
+                                        Ax,
+                                        Ax_size,
+                                        x,
+                                        x_size,
+                                        b,
+                                        b_size,
+                                        temp,
+                                        temp_size,
+                                        row_start,
+                                        row_stop,
+                                        row_step,
+                                        blocksize,
+                                        omega,
+                                        omega_size);
+            return;
+    }
+
+    bsr_jacobi_impl<I, T, F, 0>(Ap,
+                                Ap_size,
+                                Aj,
+                                Aj_size,
+                                Ax,
+                                Ax_size,
+                                x,
+                                x_size,
+                                b,
+                                b_size,
+                                temp,
+                                temp_size,
+                                row_start,
+                                row_stop,
+                                row_step,
+                                blocksize,
+                                omega,
+                                omega_size);
+}
+
+template<class I, class T, class F>
+void bsr_polynomial(const I Ap[],
+                    const int Ap_size,
+                    const I Aj[],
+                    const int Aj_size,
+                    const T Ax[],
+                    const int Ax_size,
+                    T x[],
+                    const int x_size,
+                    const T b[],
+                    const int b_size,
+                    T temp[],
+                    const int temp_size,
+                    const T coefficients[],
+                    const int coefficients_size,
+                    const I zero_guess,
+                    const I blocksize)
+{
+    switch(blocksize){
+        case 2:
+            bsr_polynomial_impl<I, T, F, 2>(Ap,
+                                            Ap_size,
+                                            Aj,
+                                            Aj_size,
+                                            Ax,
+                                            Ax_size,
+                                            x,
+                                            x_size,
+                                            b,
+                                            b_size,
+                                            temp,
+                                            temp_size,
+                                            coefficients,
+                                            coefficients_size,
+                                            zero_guess,
+                                            blocksize);
+            return;
+        case 3:
+            bsr_polynomial_impl<I, T, F, 3>(Ap,
+                                            Ap_size,
+                                            Aj,
+                                            Aj_size,
+                                            Ax,
+                                            Ax_size,
+                                            x,
+                                            x_size,
+                                            b,
+                                            b_size,
+                                            temp,
+                                            temp_size,
+                                            coefficients,
+                                            coefficients_size,
+                                            zero_guess,
+                                            blocksize);
+            return;
+        case 4:
+            bsr_polynomial_impl<I, T, F, 4>(Ap,
+                                            Ap_size,
+                                            Aj,
+                                            Aj_size,
+                                            Ax,
+                                            Ax_size,
+                                            x,
+                                            x_size,
+                                            b,
+                                            b_size,
+                                            temp,
+                                            temp_size,
+                                            coefficients,
+                                            coefficients_size,
+                                            zero_guess,
+                                            blocksize);
+            return;
+        case 6:
+            bsr_polynomial_impl<I, T, F, 6>(Ap,
+                                            Ap_size,
+                                            Aj,
+                                            Aj_size,
+                                            Ax,
+                                            Ax_size,
+                                            x,
+                                            x_size,
+                                            b,
+                                            b_size,
+                                            temp,
+                                            temp_size,
+                                            coefficients,
+                                            coefficients_size,
+                                            zero_guess,
+                                            blocksize);
+            return;
+    }
+
+    bsr_polynomial_impl<I, T, F, 0>(Ap,
+                                    Ap_size,
+                                    Aj,
+                                    Aj_size,
+                                    Ax,
+                                    Ax_size,
+                                    x,
+                                    x_size,
+                                    b,
+                                    b_size,
+                                    temp,
+                                    temp_size,
+                                    coefficients,
+                                    coefficients_size,
+                                    zero_guess,
+                                    blocksize);
+}
+
+template<class I, class T, class F>
+void block_jacobi(const I Ap[],
+                  const int Ap_size,
+                  const I Aj[],
+                  const int Aj_size,
+                  const T Ax[],
+                  const int Ax_size,
+                  T x[],
+                  const int x_size,
+                  const T b[],
+                  const int b_size,
+                  const T Tx[],
+                  const int Tx_size,
+                  T temp[],
+                  const int temp_size,
+                  const I row_start,
+                  const I row_stop,
+                  const I row_step,
+                  const T omega[],
+                  const int omega_size,
+                  const I blocksize)
+{
+    switch(blocksize){
+        case 2:
+            block_jacobi_impl<I, T, F, 2>(Ap,
+                                          Ap_size,
+                                          Aj,
+                                          Aj_size,
+                                          Ax,
+                                          Ax_size,
+                                          x,
+                                          x_size,
+                                          b,
+                                          b_size,
+                                          Tx,
+                                          Tx_size,
+                                          temp,
+                                          temp_size,
+                                          row_start,
+                                          row_stop,
+                                          row_step,
+                                          omega,
+                                          omega_size,
+                                          blocksize);
+            return;
+        case 3:
+            block_jacobi_impl<I, T, F, 3>(Ap,
+                                          Ap_size,
+                                          Aj,
+                                          Aj_size,
+                                          Ax,
+                                          Ax_size,
+                                          x,
+                                          x_size,
+                                          b,
+                                          b_size,
+                                          Tx,
+                                          Tx_size,
+                                          temp,
+                                          temp_size,
+                                          row_start,
+                                          row_stop,
+                                          row_step,
+                                          omega,
+                                          omega_size,
+                                          blocksize);
+            return;
+        case 4:
+            block_jacobi_impl<I, T, F, 4>(Ap,
+                                          Ap_size,
+                                          Aj,
+                                          Aj_size,
+                                          Ax,
+                                          Ax_size,
+                                          x,
+                                          x_size,
+                                          b,
+                                          b_size,
+                                          Tx,
+                                          Tx_size,
+                                          temp,
+                                          temp_size,
+                                          row_start,
+                                          row_stop,
+                                          row_step,
+                                          omega,
+                                          omega_size,
+                                          blocksize);
+            return;
+        case 6:
+            block_jacobi_impl<I, T, F, 6>(Ap,
+                                          Ap_size,
+                                          Aj,
+                                          Aj_size,
+                                          Ax,
+                                          Ax_size,
+                                          x,
+                                          x_size,
+                                          b,
+                                          b_size,
+                                          Tx,
+                                          Tx_size,
+                                          temp,
+                                          temp_size,
+                                          row_start,
+                                          row_stop,
+                                          row_step,
+                                          omega,
+                                          omega_size,
+                                          blocksize);
+            return;
+    }
+
+    block_jacobi_impl<I, T, F, 0>(Ap,
+                                  Ap_size,
+                                  Aj,
+                                  Aj_size,
+                                  Ax,
+                                  Ax_size,
+                                  x,
+                                  x_size,
+                                  b,
+                                  b_size,
+                                  Tx,
+                                  Tx_size,
+                                  temp,
+                                  temp_size,
+                                  row_start,
+                                  row_stop,
+                                  row_step,
+                                  omega,
+                                  omega_size,
+                                  blocksize);
+}
+
+template<class I, class T, class F>
+void block_gauss_seidel(const I Ap[],
+                        const int Ap_size,
+                        const I Aj[],
+                        const int Aj_size,
+                        const T Ax[],
+                        const int Ax_size,
+                        T x[],
+                        const int x_size,
+                        const T b[],
+                        const int b_size,
+                        const T Tx[],
+                        const int Tx_size,
+                        const I row_start,
+                        const I row_stop,
+                        const I row_step,
+                        const I blocksize)
+{
+    switch(blocksize){
+        case 2:
+            block_gauss_seidel_impl<I, T, F, 2>(Ap,
+                                                Ap_size,
+                                                Aj,
+                                                Aj_size,
+                                                Ax,
+                                                Ax_size,
+                                                x,
+                                                x_size,
+                                                b,
+                                                b_size,
+                                                Tx,
+                                                Tx_size,
+                                                row_start,
+                                                row_stop,
+                                                row_step,
+                                                blocksize);
+            return;
+        case 3:
+            block_gauss_seidel_impl<I, T, F, 3>(Ap,
+                                                Ap_size,
+                                                Aj,
+                                                Aj_size,
+                                                Ax,
+                                                Ax_size,
+                                                x,
+                                                x_size,
+                                                b,
+                                                b_size,
+                                                Tx,
+                                                Tx_size,
+                                                row_start,
+                                                row_stop,
+                                                row_step,
+                                                blocksize);
+            return;
+        case 4:
+            block_gauss_seidel_impl<I, T, F, 4>(Ap,
+                                                Ap_size,
+                                                Aj,
+                                                Aj_size,
+                                                Ax,
+                                                Ax_size,
+                                                x,
+                                                x_size,
+                                                b,
+                                                b_size,
+                                                Tx,
+                                                Tx_size,
+                                                row_start,
+                                                row_stop,
+                                                row_step,
+                                                blocksize);
+            return;
+        case 6:
+            block_gauss_seidel_impl<I, T, F, 6>(Ap,
+                                                Ap_size,
+                                                Aj,
+                                                Aj_size,
+                                                Ax,
+                                                Ax_size,
+                                                x,
+                                                x_size,
+                                                b,
+                                                b_size,
+                                                Tx,
+                                                Tx_size,
+                                                row_start,
+                                                row_stop,
+                                                row_step,
+                                                blocksize);
+            return;
+    }
+
+    block_gauss_seidel_impl<I, T, F, 0>(Ap,
+                                        Ap_size,
+                                        Aj,
+                                        Aj_size,
+                                        Ax,
+                                        Ax_size,
+                                        x,
+                                        x_size,
+                                        b,
+                                        b_size,
+                                        Tx,
+                                        Tx_size,
+                                        row_start,
+                                        row_stop,
+                                        row_step,
+                                        blocksize);
+}
+
+#endif
@@ -8,9 +8,11 @@
 #include <cassert>
 #include <limits>
 #include <algorithm>
+#include <functional>
 
 #include "linalg.h"
 #include "graph.h"
+#include "parallel.h"
 
 #define F_NODE 0
 #define C_NODE 1
@@ -46,6 +48,10 @@
  *      of A's nonzero values, a conservative bound is to allocate the same
  *      storage for S as is used by A.
  *
+ *      The rows are processed in parallel in two passes: the strong
+ *      connections in each row are counted, Sp is formed by a cumulative
+ *      sum of the counts, and then each row of Sj and Sx is filled.
+ *
  */
 template<class I, class T, class F>
 void classical_strength_of_connection_abs(const I n_row,
@@ -57,9 +63,10 @@ void classical_strength_of_connection_abs(const I n_row,
                                                 I Sj[], const int Sj_size,
                                                 T Sx[], const int Sx_size)
 {
-    I nnz = 0;
-    Sp[0] = 0;
+    std::vector<F> thresholds(n_row);
 
+    // count the strong connections in each row
+    #pragma omp parallel for schedule(static)
     for(I i = 0; i < n_row; i++){
         F max_offdiagonal = std::numeric_limits<F>::min();
 
@@ -72,28 +79,35 @@ void classical_strength_of_connection_abs(const I n_row,
             }
         }
 
-        F threshold = theta*max_offdiagonal;
+        const F threshold = theta*max_offdiagonal;
+        I row_nnz = 0;
         for(I jj = row_start; jj < row_end; jj++){
-            F norm_jj = mynorm(Ax[jj]);
-
-            // Add entry if it exceeds the threshold
-            if(norm_jj >= threshold){
-                if(Aj[jj] != i){
-                    Sj[nnz] = Aj[jj];
-                    Sx[nnz] = Ax[jj];
-                    nnz++;
-                }
+            // Always add the diagonal
+            if(Aj[jj] == i || mynorm(Ax[jj]) >= threshold){
+                row_nnz++;
             }
+        }
 
-            // Always add the diagonal
-            if(Aj[jj] == i){
+        thresholds[i] = threshold;
+        Sp[i+1] = row_nnz;
+    }
+
+    Sp[0] = 0;
+    cumulative_sum(Sp + 1, n_row);
+
+    // fill in the strong connections
+    #pragma omp parallel for schedule(static)
+    for(I i = 0; i < n_row; i++){
+        const F threshold = thresholds[i];
+        I nnz = Sp[i];
+
+        for(I jj = Ap[i]; jj < Ap[i+1]; jj++){
+            if(Aj[jj] == i || mynorm(Ax[jj]) >= threshold){
                 Sj[nnz] = Aj[jj];
                 Sx[nnz] = Ax[jj];
                 nnz++;
             }
         }
-
-        Sp[i+1] = nnz;
     }
 }
 
@@ -107,9 +121,10 @@ void classical_strength_of_connection_min(const I n_row,
                                                 I Sj[], const int Sj_size,
                                                 T Sx[], const int Sx_size)
 {
-    I nnz = 0;
-    Sp[0] = 0;
+    std::vector<T> thresholds(n_row);
 
+    // count the strong connections in each row
+    #pragma omp parallel for schedule(static)
     for(I i = 0; i < n_row; i++){
         T max_offdiagonal = 0.0;
 
@@ -122,28 +137,35 @@ void classical_strength_of_connection_min(const I n_row,
             }
         }
 
-        T threshold = theta*max_offdiagonal;
+        const T threshold = theta*max_offdiagonal;
+        I row_nnz = 0;
         for(I jj = row_start; jj < row_end; jj++){
-            T norm_jj = -Ax[jj];
-
-            // Add entry if it exceeds the threshold
-            if(norm_jj >= threshold){
-                if(Aj[jj] != i){
-                    Sj[nnz] = Aj[jj];
-                    Sx[nnz] = Ax[jj];
-                    nnz++;
-                }
+            // Always add the diagonal
+            if(Aj[jj] == i || -Ax[jj] >= threshold){
+                row_nnz++;
             }
+        }
 
-            // Always add the diagonal
-            if(Aj[jj] == i){
+        thresholds[i] = threshold;
+        Sp[i+1] = row_nnz;
+    }
+
+    Sp[0] = 0;
+    cumulative_sum(Sp + 1, n_row);
+
+    // fill in the strong connections
+    #pragma omp parallel for schedule(static)
+    for(I i = 0; i < n_row; i++){
+        const T threshold = thresholds[i];
+        I nnz = Sp[i];
+
+        for(I jj = Ap[i]; jj < Ap[i+1]; jj++){
+            if(Aj[jj] == i || -Ax[jj] >= threshold){
                 Sj[nnz] = Aj[jj];
                 Sx[nnz] = Ax[jj];
                 nnz++;
             }
         }
-
-        Sp[i+1] = nnz;
     }
 }
 
@@ -169,6 +191,7 @@ void maximum_row_value(const I n_row,
                        const T Ax[], const int Ax_size)
 {
 
+    #pragma omp parallel for schedule(static)
     for(I i = 0; i < n_row; i++){
         F max_entry = std::numeric_limits<F>::min();
 
@@ -450,6 +473,283 @@ void rs_cf_splitting_pass2(const I n_nodes,
 }
 
 
+/*
+ * Helper for pmis_cf_splitting(...) and hmis_cf_splitting(...), which
+ * completes a PMIS splitting.  Upon entry, each node is marked C_NODE,
+ * F_NODE or U_NODE.  Upon return, every U_NODE is marked C or F.
+ *
+ * Each round, the undecided nodes with a strong connection to a C-node,
+ * in either direction, become F-nodes.  Then the undecided nodes whose
+ * weight is larger than that of every undecided neighbor in S or S^T
+ * become C-nodes.  Ties are broken by the node index.
+ *
+ * The rounds only visit the nodes that are still undecided, and the
+ * nodes are tested and then updated in separate passes, which are
+ * threaded with OpenMP, as in maximal_independent_set_parallel(...).  So
+ * the splitting depends on the weights, but not on the number of threads.
+ */
+template<class I, class T>
+void pmis_rounds(const I n_nodes,
+                 const I Sp[], const I Sj[],
+                 const I Tp[], const I Tj[],
+                 const T weights[],
+                       I splitting[])
+{
+    std::vector<I> frontier;
+    for(I i = 0; i < n_nodes; i++){
+        if(splitting[i] == U_NODE)
+            frontier.push_back(i);
+    }
+
+    // state[k] records whether frontier[k] becomes a C-node (1), an
+    // F-node (2), or stays undecided (0) in the current round
+    std::vector<char> state(frontier.size());
+
+    while(!frontier.empty()){
+        const I num_frontier = frontier.size();
+
+        #pragma omp parallel
+        {
+            // undecided nodes connected to a C-node become F
+            #pragma omp for schedule(static)
+            for(I k = 0; k < num_frontier; k++){
+                const I i = frontier[k];
+                state[k] = 0;
+                for(I jj = Sp[i]; jj < Sp[i+1] && state[k] == 0; jj++){
+                    if(Sj[jj] != i && splitting[Sj[jj]] == C_NODE)
+                        state[k] = 2;
+                }
+                for(I jj = Tp[i]; jj < Tp[i+1] && state[k] == 0; jj++){
+                    if(Tj[jj] != i && splitting[Tj[jj]] == C_NODE)
+                        state[k] = 2;
+                }
+            }
+
+            #pragma omp for schedule(static)
+            for(I k = 0; k < num_frontier; k++){
+                if(state[k] == 2)
+                    splitting[frontier[k]] = F_NODE;
+            }
+
+            // find the undecided nodes that are larger than all of their
+            // undecided neighbors
+            #pragma omp for schedule(static)
+            for(I k = 0; k < num_frontier; k++){
+                if(state[k] == 2) continue;
+                const I i  = frontier[k];
+                const T wi = weights[i];
+
+                state[k] = 1;
+                for(I jj = Sp[i]; jj < Sp[i+1] && state[k] == 1; jj++){
+                    const I j = Sj[jj];
+                    if(j != i && splitting[j] == U_NODE &&
+                       (weights[j] > wi || (weights[j] == wi && j > i)))
+                        state[k] = 0;
+                }
+                for(I jj = Tp[i]; jj < Tp[i+1] && state[k] == 1; jj++){
+                    const I j = Tj[jj];
+                    if(j != i && splitting[j] == U_NODE &&
+                       (weights[j] > wi || (weights[j] == wi && j > i)))
+                        state[k] = 0;
+                }
+            }
+
+            #pragma omp for schedule(static)
+            for(I k = 0; k < num_frontier; k++){
+                if(state[k] == 1)
+                    splitting[frontier[k]] = C_NODE;
+            }
+        }
+
+        // compact the frontier to the nodes that are still undecided
+        I num_undecided = 0;
+        for(I k = 0; k < num_frontier; k++){
+            if(state[k] == 0)
+                frontier[num_undecided++] = frontier[k];
+        }
+        frontier.resize(num_undecided);
+    }
+}
+
+
+/* Compute a C/F splitting using the Parallel Modified Independent Set
+ * (PMIS) method of De Sterck, Yang and Heys.  The strength of connection
+ * matrix S, and its transpose T, are stored in CSR format.  Upon return,
+ * the splitting array will consist of zeros and ones, where C-nodes
+ * (coarse nodes) are marked with the value 1 and F-nodes (fine nodes)
+ * with the value 0.
+ *
+ * Parameters:
+ *   n_nodes   - number of rows in A
+ *   Sp[]      - CSR row pointer array for SOC matrix
+ *   Sj[]      - CSR column index array for SOC matrix
+ *   Tp[]      - CSR row pointer array for transpose of SOC matrix
+ *   Tj[]      - CSR column index array for transpose of SOC matrix
+ *   weights   - measure of each node, usually the number of nodes that
+ *               strongly depend on it plus a random number in [0,1)
+ *   splitting - array to store the C/F splitting
+ *
+ * Notes:
+ *   The splitting array must be preallocated.
+ *
+ *   Nodes that no other node strongly depends on become F-nodes.  The
+ *   remaining nodes are split in rounds, see pmis_rounds(...), so the
+ *   C-nodes are a maximal independent set of the graph of S + S^T, but
+ *   S + S^T is not formed.
+ *
+ *   The rounds are threaded with OpenMP, and the splitting does not
+ *   depend on the number of threads.
+ *
+ */
+template<class I, class T>
+void pmis_cf_splitting(const I n_nodes,
+                       const I Sp[], const int Sp_size,
+                       const I Sj[], const int Sj_size,
+                       const I Tp[], const int Tp_size,
+                       const I Tj[], const int Tj_size,
+                       const T weights[], const int weights_size,
+                             I splitting[], const int splitting_size)
+{
+    // All nodes that no node depends on become F nodes
+    #pragma omp parallel for schedule(static)
+    for(I i = 0; i < n_nodes; i++){
+        splitting[i] = F_NODE;
+        for(I jj = Tp[i]; jj < Tp[i+1]; jj++){
+            if(Tj[jj] != i){
+                splitting[i] = U_NODE;
+                break;
+            }
+        }
+    }
+
+    pmis_rounds(n_nodes, Sp, Sj, Tp, Tj, weights, splitting);
+}
+
+
+/* Compute a C/F splitting using the Hybrid Modified Independent Set
+ * (HMIS) method of De Sterck, Yang and Heys.  The nodes are divided into
+ * blocks of consecutive nodes, and the first pass of Ruge-Stuben
+ * coarsening is applied to each block, using only the strong connections
+ * within the block.  The C-nodes from these passes without strong
+ * connections to other blocks are the initial C-nodes of PMIS, which
+ * splits the remaining nodes.
+ *
+ * Parameters:
+ *   n_nodes    - number of rows in A
+ *   Sp[]       - CSR row pointer array for SOC matrix
+ *   Sj[]       - CSR column index array for SOC matrix
+ *   Tp[]       - CSR row pointer array for transpose of SOC matrix
+ *   Tj[]       - CSR column index array for transpose of SOC matrix
+ *   weights    - measure of each node for PMIS, see pmis_cf_splitting(...)
+ *   splitting  - array to store the C/F splitting
+ *   nodes_per_block - number of nodes in each block
+ *
+ * Notes:
+ *   The splitting array must be preallocated.
+ *
+ *   The blocks take the role of the processor subdomains in the
+ *   distributed algorithm.  The blocks are split in parallel, and their
+ *   size does not depend on the number of threads, so neither does the
+ *   splitting.  Larger blocks give a splitting closer to Ruge-Stuben
+ *   coarsening, but less parallelism.
+ *
+ */
+template<class I, class T>
+void hmis_cf_splitting(const I n_nodes,
+                       const I Sp[], const int Sp_size,
+                       const I Sj[], const int Sj_size,
+                       const I Tp[], const int Tp_size,
+                       const I Tj[], const int Tj_size,
+                       const T weights[], const int weights_size,
+                             I splitting[], const int splitting_size,
+                       const I nodes_per_block)
+{
+    const I num_blocks = (n_nodes + nodes_per_block - 1)/nodes_per_block;
+
+    #pragma omp parallel
+    {
+        // the strong connections within a block, in local numbering
+        std::vector<I> block_Sp, block_Sj, block_Tp, block_Tj;
+        std::vector<I> influence, block_splitting;
+
+        #pragma omp for schedule(static)
+        for(I b = 0; b < num_blocks; b++){
+            const I start = b*nodes_per_block;
+            const I stop  = std::min(start + nodes_per_block, n_nodes);
+            const I m     = stop - start;
+
+            block_Sp.assign(1, 0);
+            block_Tp.assign(1, 0);
+            block_Sj.clear();
+            block_Tj.clear();
+            for(I i = start; i < stop; i++){
+                for(I jj = Sp[i]; jj < Sp[i+1]; jj++){
+                    const I j = Sj[jj];
+                    if(j != i && j >= start && j < stop)
+                        block_Sj.push_back(j - start);
+                }
+                for(I jj = Tp[i]; jj < Tp[i+1]; jj++){
+                    const I j = Tj[jj];
+                    if(j != i && j >= start && j < stop)
+                        block_Tj.push_back(j - start);
+                }
+                block_Sp.push_back(block_Sj.size());
+                block_Tp.push_back(block_Tj.size());
+            }
+            // keep data() valid for empty blocks
+            block_Sj.push_back(0);
+            block_Tj.push_back(0);
+
+            influence.assign(m, 0);
+            block_splitting.resize(m);
+            rs_cf_splitting(m,
+                            &block_Sp[0], m + 1,
+                            &block_Sj[0], block_Sp[m],
+                            &block_Tp[0], m + 1,
+                            &block_Tj[0], block_Tp[m],
+                            &influence[0], m,
+                            &block_splitting[0], m);
+
+            // keep the C-nodes without strong connections to other blocks
+            for(I i = start; i < stop; i++){
+                splitting[i] = U_NODE;
+                if(block_splitting[i - start] != C_NODE)
+                    continue;
+
+                bool interior = true;
+                for(I jj = Sp[i]; jj < Sp[i+1] && interior; jj++){
+                    if(Sj[jj] < start || Sj[jj] >= stop)
+                        interior = false;
+                }
+                for(I jj = Tp[i]; jj < Tp[i+1] && interior; jj++){
+                    if(Tj[jj] < start || Tj[jj] >= stop)
+                        interior = false;
+                }
+                if(interior)
+                    splitting[i] = C_NODE;
+            }
+        }
+
+        // All other nodes that no node depends on become F nodes
+        #pragma omp for schedule(static)
+        for(I i = 0; i < n_nodes; i++){
+            if(splitting[i] == C_NODE) continue;
+            bool dependent = false;
+            for(I jj = Tp[i]; jj < Tp[i+1]; jj++){
+                if(Tj[jj] != i){
+                    dependent = true;
+                    break;
+                }
+            }
+            if(!dependent)
+                splitting[i] = F_NODE;
+        }
+    }
+
+    pmis_rounds(n_nodes, Sp, Sj, Tp, Tj, weights, splitting);
+}
+
+
 /*
  *  Compute a CLJP splitting
  *
@@ -634,6 +934,166 @@ void cljp_naive_splitting(const I n,
 }
 
 
+/*
+ * Helper for the direct interpolation routines below, which computes the
+ * interpolation weights of the F-node i.  Upon return, cols and vals
+ * hold the strong C-neighbors j of i, in the order of row i of S, and
+ * the weights P(i,j).
+ */
+template<class I, class T>
+void rs_direct_interpolation_row(const I i,
+                                 const I Ap[], const I Aj[], const T Ax[],
+                                 const I Sp[], const I Sj[], const T Sx[],
+                                 const I splitting[],
+                                 std::vector<I>& cols,
+                                 std::vector<T>& vals)
+{
+    cols.clear();
+    vals.clear();
+
+    T sum_strong_pos = 0, sum_strong_neg = 0;
+    for(I jj = Sp[i]; jj < Sp[i+1]; jj++){
+        if ( (splitting[Sj[jj]] == C_NODE) && (Sj[jj] != i) ){
+            if (Sx[jj] < 0)
+                sum_strong_neg += Sx[jj];
+            else
+                sum_strong_pos += Sx[jj];
+        }
+    }
+
+    T sum_all_pos = 0, sum_all_neg = 0;
+    T diag = 0;
+    for(I jj = Ap[i]; jj < Ap[i+1]; jj++){
+        if (Aj[jj] == i){
+            diag += Ax[jj];
+        } else {
+            if (Ax[jj] < 0)
+                sum_all_neg += Ax[jj];
+            else
+                sum_all_pos += Ax[jj];
+        }
+    }
+
+    T alpha = sum_all_neg / sum_strong_neg;
+    T beta  = sum_all_pos / sum_strong_pos;
+
+    if (sum_strong_pos == 0){
+        diag += sum_all_pos;
+        beta = 0;
+    }
+
+    T neg_coeff = -alpha/diag;
+    T pos_coeff = -beta/diag;
+
+    for(I jj = Sp[i]; jj < Sp[i+1]; jj++){
+        if ( (splitting[Sj[jj]] == C_NODE) && (Sj[jj] != i) ){
+            cols.push_back(Sj[jj]);
+            if (Sx[jj] < 0)
+                vals.push_back(neg_coeff * Sx[jj]);
+            else
+                vals.push_back(pos_coeff * Sx[jj]);
+        }
+    }
+}
+
+
+/*
+ * Helper for the truncated direct interpolation, which truncates the
+ * weights of a row of P.  The weights with magnitude less than
+ * trunc_factor times the largest magnitude in the row are dropped, and
+ * then, if max_row_nnz > 0, only the max_row_nnz weights of largest
+ * magnitude are kept (ties go to the first weights in the row).  The
+ * remaining weights are scaled so that the row sum is unchanged, and are
+ * kept in their original order.
+ */
+template<class I, class T>
+void rs_truncate_row(std::vector<I>& cols,
+                     std::vector<T>& vals,
+                     std::vector<T>& work,
+                     const I max_row_nnz,
+                     const T trunc_factor)
+{
+    const I n = vals.size();
+    if (n == 0)
+        return;
+
+    T max_val = 0;
+    for(I k = 0; k < n; k++){
+        max_val = std::max(max_val, std::abs(vals[k]));
+    }
+
+    // weights with magnitude >= cutoff are kept
+    T cutoff = trunc_factor * max_val;
+    I num_kept = 0;
+    for(I k = 0; k < n; k++){
+        if (std::abs(vals[k]) >= cutoff)
+            num_kept++;
+    }
+
+    // weights with magnitude == cutoff are only kept while num_ties > 0
+    I num_ties = n;
+    if (max_row_nnz > 0 && num_kept > max_row_nnz){
+        work.resize(n);
+        for(I k = 0; k < n; k++){
+            work[k] = std::abs(vals[k]);
+        }
+        std::nth_element(work.begin(), work.begin() + (max_row_nnz - 1), work.end(),
+                         std::greater<T>());
+        cutoff = work[max_row_nnz - 1];
+
+        num_ties = max_row_nnz;
+        for(I k = 0; k < n; k++){
+            if (std::abs(vals[k]) > cutoff)
+                num_ties--;
+        }
+    }
+
+    T sum_all = 0, sum_kept = 0;
+    I nnz = 0;
+    for(I k = 0; k < n; k++){
+        const T v = std::abs(vals[k]);
+        sum_all += vals[k];
+        if (v > cutoff || (v == cutoff && num_ties-- > 0)){
+            sum_kept += vals[k];
+            cols[nnz] = cols[k];
+            vals[nnz] = vals[k];
+            nnz++;
+        }
+    }
+    cols.resize(nnz);
+    vals.resize(nnz);
+
+    if (nnz < n && sum_kept != 0){
+        const T scale = sum_all / sum_kept;
+        for(I k = 0; k < nnz; k++){
+            vals[k] *= scale;
+        }
+    }
+}
+
+
+/*
+ * Helper for the direct interpolation routines, which replaces the
+ * column indices of P, i.e. the fine grid indices of the C-nodes, by
+ * their coarse grid indices.
+ */
+template<class I>
+void rs_coarse_index_map(const I n_nodes,
+                         const I splitting[],
+                         const I nnz,
+                               I Bj[])
+{
+    std::vector<I> map(splitting, splitting + n_nodes);
+    cumulative_sum(&map[0], n_nodes);
+
+    #pragma omp parallel for schedule(static)
+    for(I i = 0; i < nnz; i++){
+        const I j = Bj[i];
+        Bj[i] = map[j] - splitting[j];
+    }
+}
+
+
 /*
  *   Produce the Ruge-Stuben prolongator using "Direct Interpolation"
  *
@@ -643,6 +1103,9 @@ void cljp_naive_splitting(const I n,
  *
  *   The second pass fills in the nonzero entries of the prolongator
  *
+ *   Both passes are threaded over the rows of P, and the row pointer is
+ *   formed by a cumulative sum of the row counts.
+ *
  *   Reference:
  *      Page 479 of "Multigrid"
  *
@@ -654,9 +1117,11 @@ void rs_direct_interpolation_pass1(const I n_nodes,
                                    const I splitting[], const int splitting_size,
                                          I Bp[], const int Bp_size)
 {
-    I nnz = 0;
     Bp[0] = 0;
+
+    #pragma omp parallel for schedule(static)
     for(I i = 0; i < n_nodes; i++){
+        I nnz = 0;
         if( splitting[i] == C_NODE ){
             nnz++;
         } else {
@@ -667,6 +1132,8 @@ void rs_direct_interpolation_pass1(const I n_nodes,
         }
         Bp[i+1] = nnz;
     }
+
+    cumulative_sum(Bp + 1, n_nodes);
 }
 
 
@@ -683,72 +1150,155 @@ void rs_direct_interpolation_pass2(const I n_nodes,
                                          I Bj[], const int Bj_size,
                                          T Bx[], const int Bx_size)
 {
-
-    for(I i = 0; i < n_nodes; i++){
-        if(splitting[i] == C_NODE){
-            Bj[Bp[i]] = i;
-            Bx[Bp[i]] = 1;
-        } else {
-            T sum_strong_pos = 0, sum_strong_neg = 0;
-            for(I jj = Sp[i]; jj < Sp[i+1]; jj++){
-                if ( (splitting[Sj[jj]] == C_NODE) && (Sj[jj] != i) ){
-                    if (Sx[jj] < 0)
-                        sum_strong_neg += Sx[jj];
-                    else
-                        sum_strong_pos += Sx[jj];
-                }
-            }
-
-            T sum_all_pos = 0, sum_all_neg = 0;
-            T diag = 0;
-            for(I jj = Ap[i]; jj < Ap[i+1]; jj++){
-                if (Aj[jj] == i){
-                    diag += Ax[jj];
-                } else {
-                    if (Ax[jj] < 0)
-                        sum_all_neg += Ax[jj];
-                    else
-                        sum_all_pos += Ax[jj];
-                }
+    #pragma omp parallel
+    {
+        std::vector<I> cols;
+        std::vector<T> vals;
+
+        #pragma omp for schedule(static)
+        for(I i = 0; i < n_nodes; i++){
+            if(splitting[i] == C_NODE){
+                Bj[Bp[i]] = i;
+                Bx[Bp[i]] = 1;
+            } else {
+                rs_direct_interpolation_row(i, Ap, Aj, Ax, Sp, Sj, Sx, splitting, cols, vals);
+                std::copy(cols.begin(), cols.end(), Bj + Bp[i]);
+                std::copy(vals.begin(), vals.end(), Bx + Bp[i]);
             }
+        }
+    }
 
-            T alpha = sum_all_neg / sum_strong_neg;
-            T beta  = sum_all_pos / sum_strong_pos;
+    rs_coarse_index_map(n_nodes, splitting, Bp[n_nodes], Bj);
+}
 
-            if (sum_strong_pos == 0){
-                diag += sum_all_pos;
-                beta = 0;
-            }
 
-            T neg_coeff = -alpha/diag;
-            T pos_coeff = -beta/diag;
+/*
+ *   Produce the Ruge-Stuben prolongator using "Direct Interpolation",
+ *   and truncate the interpolation weights of each row of P.
+ *
+ *   The first pass computes the weights of each row, truncates them and
+ *   computes the row pointer for the prolongator.  The second pass
+ *   recomputes the truncated weights and fills in the nonzero entries of
+ *   the prolongator.  Both passes are threaded over the rows of P.
+ *
+ *   Parameters:
+ *     n_nodes      - number of rows in A
+ *     Ap, Aj, Ax   - CSR matrix A
+ *     Sp, Sj, Sx   - CSR strength of connection matrix, with the entries
+ *                    of A in the sparsity pattern of S
+ *     splitting    - C/F splitting
+ *     Bp, Bj, Bx   - CSR prolongator, Bp is computed by the first pass,
+ *                    and Bj and Bx by the second
+ *     max_row_nnz  - maximum number of weights in each row of P, or
+ *                    <= 0 for no limit
+ *     trunc_factor - weights with magnitude less than trunc_factor times
+ *                    the largest magnitude in the row are dropped
+ *
+ *   Notes:
+ *     The remaining weights in each row are scaled so that the row sum
+ *     is unchanged, see rs_truncate_row(...).  With max_row_nnz <= 0 and
+ *     trunc_factor = 0, P is the same as from rs_direct_interpolation_pass2.
+ *
+ *     Only the truncated row lengths are kept from the first pass, in Bp,
+ *     as the number of weights is not known before the rows are truncated.
+ *     The second pass recomputes and truncates each row of F-nodes, i.e.,
+ *     the weights are computed twice, as for rs_direct_interpolation_pass2.
+ *
+ */
+template<class I, class T>
+void rs_direct_interpolation_truncated_pass1(const I n_nodes,
+                                             const I Ap[], const int Ap_size,
+                                             const I Aj[], const int Aj_size,
+                                             const T Ax[], const int Ax_size,
+                                             const I Sp[], const int Sp_size,
+                                             const I Sj[], const int Sj_size,
+                                             const T Sx[], const int Sx_size,
+                                             const I splitting[], const int splitting_size,
+                                                   I Bp[], const int Bp_size,
+                                             const I max_row_nnz,
+                                             const T trunc_factor)
+{
+    Bp[0] = 0;
 
-            I nnz = Bp[i];
-            for(I jj = Sp[i]; jj < Sp[i+1]; jj++){
-                if ( (splitting[Sj[jj]] == C_NODE) && (Sj[jj] != i) ){
-                    Bj[nnz] = Sj[jj];
-                    if (Sx[jj] < 0)
-                        Bx[nnz] = neg_coeff * Sx[jj];
-                    else
-                        Bx[nnz] = pos_coeff * Sx[jj];
-                    nnz++;
-                }
+    #pragma omp parallel
+    {
+        std::vector<I> cols;
+        std::vector<T> vals, work;
+
+        #pragma omp for schedule(static)
+        for(I i = 0; i < n_nodes; i++){
+            if(splitting[i] == C_NODE){
+                Bp[i+1] = 1;
+            } else {
+                rs_direct_interpolation_row(i, Ap, Aj, Ax, Sp, Sj, Sx, splitting, cols, vals);
+                rs_truncate_row(cols, vals, work, max_row_nnz, trunc_factor);
+                Bp[i+1] = cols.size();
             }
         }
     }
 
-
-    std::vector<I> map(n_nodes);
-    for(I i = 0, sum = 0; i < n_nodes; i++){
-        map[i]  = sum;
-        sum    += splitting[i];
-    }
-    for(I i = 0; i < Bp[n_nodes]; i++){
-        Bj[i] = map[Bj[i]];
-    }
+    cumulative_sum(Bp + 1, n_nodes);
 }
 
 
+/*
+ *   Second pass of the truncated "Direct Interpolation", which fills in
+ *   the nonzero entries of the prolongator, see
+ *   rs_direct_interpolation_truncated_pass1.
+ *
+ *   The weights of each row of an F-node are recomputed and truncated as
+ *   in the first pass, so that they fit the row pointer Bp.  Rows of
+ *   C-nodes interpolate by injection.  The column indices are mapped to
+ *   the coarse grid at the end.  Threaded over the rows of P.
+ *
+ *   Parameters:
+ *     n_nodes      - number of rows in A
+ *     Ap, Aj, Ax   - CSR matrix A
+ *     Sp, Sj, Sx   - CSR strength of connection matrix, with the entries
+ *                    of A in the sparsity pattern of S
+ *     splitting    - C/F splitting
+ *     Bp           - CSR row pointer of P, from the first pass
+ *     Bj, Bx       - CSR column indices and data of P, of size Bp[n_nodes]
+ *     max_row_nnz  - same as for the first pass
+ *     trunc_factor - same as for the first pass
+ *
+ */
+template<class I, class T>
+void rs_direct_interpolation_truncated_pass2(const I n_nodes,
+                                             const I Ap[], const int Ap_size,
+                                             const I Aj[], const int Aj_size,
+                                             const T Ax[], const int Ax_size,
+                                             const I Sp[], const int Sp_size,
+                                             const I Sj[], const int Sj_size,
+                                             const T Sx[], const int Sx_size,
+                                             const I splitting[], const int splitting_size,
+                                             const I Bp[], const int Bp_size,
+                                                   I Bj[], const int Bj_size,
+                                                   T Bx[], const int Bx_size,
+                                             const I max_row_nnz,
+                                             const T trunc_factor)
+{
+    #pragma omp parallel
+    {
+        std::vector<I> cols;
+        std::vector<T> vals, work;
+
+        #pragma omp for schedule(static)
+        for(I i = 0; i < n_nodes; i++){
+            if(splitting[i] == C_NODE){
+                Bj[Bp[i]] = i;
+                Bx[Bp[i]] = 1;
+            } else {
+                rs_direct_interpolation_row(i, Ap, Aj, Ax, Sp, Sj, Sx, splitting, cols, vals);
+                rs_truncate_row(cols, vals, work, max_row_nnz, trunc_factor);
+                std::copy(cols.begin(), cols.end(), Bj + Bp[i]);
+                std::copy(vals.begin(), vals.end(), Bx + Bp[i]);
+            }
+        }
+    }
+
+    rs_coarse_index_map(n_nodes, splitting, Bp[n_nodes], Bj);
+}
 
 
 template<class I, class T>
@@ -4,6 +4,9 @@
 #include <pybind11/numpy.h>
 #include <pybind11/complex.h>
 
+#include "bind_arrays.h"
+#include "bind_threads.h"
+#include "bind_timers.h"
 #include "ruge_stuben.h"
 
 namespace py = pybind11;
@@ -12,12 +15,12 @@ template<class I, class T, class F>
 void _classical_strength_of_connection_abs(
             const I n_row,
             const F theta,
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
-      py::array_t<T> & Ax,
-      py::array_t<I> & Sp,
-      py::array_t<I> & Sj,
-      py::array_t<T> & Sx
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+     output_array<I> & Sp,
+     output_array<I> & Sj,
+     output_array<T> & Sx
                                            )
 {
     auto py_Ap = Ap.unchecked();
@@ -32,16 +35,26 @@ void _classical_strength_of_connection_abs(
     I *_Sp = py_Sp.mutable_data();
     I *_Sj = py_Sj.mutable_data();
     T *_Sx = py_Sx.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int Sp_size = array_size(Sp.shape(0));
+    int Sj_size = array_size(Sj.shape(0));
+    int Sx_size = array_size(Sx.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("classical_strength_of_connection_abs");
 
     return classical_strength_of_connection_abs<I, T, F>(
                     n_row,
                     theta,
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
-                      _Ax, Ax.shape(0),
-                      _Sp, Sp.shape(0),
-                      _Sj, Sj.shape(0),
-                      _Sx, Sx.shape(0)
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                      _Sp, Sp_size,
+                      _Sj, Sj_size,
+                      _Sx, Sx_size
                                                          );
 }
 
@@ -49,12 +62,12 @@ template<class I, class T>
 void _classical_strength_of_connection_min(
             const I n_row,
             const T theta,
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
-      py::array_t<T> & Ax,
-      py::array_t<I> & Sp,
-      py::array_t<I> & Sj,
-      py::array_t<T> & Sx
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+     output_array<I> & Sp,
+     output_array<I> & Sj,
+     output_array<T> & Sx
                                            )
 {
     auto py_Ap = Ap.unchecked();
@@ -69,26 +82,36 @@ void _classical_strength_of_connection_min(
     I *_Sp = py_Sp.mutable_data();
     I *_Sj = py_Sj.mutable_data();
     T *_Sx = py_Sx.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int Sp_size = array_size(Sp.shape(0));
+    int Sj_size = array_size(Sj.shape(0));
+    int Sx_size = array_size(Sx.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("classical_strength_of_connection_min");
 
     return classical_strength_of_connection_min<I, T>(
                     n_row,
                     theta,
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
-                      _Ax, Ax.shape(0),
-                      _Sp, Sp.shape(0),
-                      _Sj, Sj.shape(0),
-                      _Sx, Sx.shape(0)
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                      _Sp, Sp_size,
+                      _Sj, Sj_size,
+                      _Sx, Sx_size
                                                       );
 }
 
 template<class I, class T, class F>
 void _maximum_row_value(
             const I n_row,
-       py::array_t<T> & x,
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
-      py::array_t<T> & Ax
+      output_array<T> & x,
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax
                         )
 {
     auto py_x = x.mutable_unchecked();
@@ -99,25 +122,33 @@ void _maximum_row_value(
     const I *_Ap = py_Ap.data();
     const I *_Aj = py_Aj.data();
     const T *_Ax = py_Ax.data();
+    int x_size = array_size(x.shape(0));
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("maximum_row_value");
 
     return maximum_row_value<I, T, F>(
                     n_row,
-                       _x, x.shape(0),
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
-                      _Ax, Ax.shape(0)
+                       _x, x_size,
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size
                                       );
 }
 
 template<class I>
 void _rs_cf_splitting(
           const I n_nodes,
-py::array_t<I> & C_rowptr,
-py::array_t<I> & C_colinds,
-      py::array_t<I> & Tp,
-      py::array_t<I> & Tj,
-py::array_t<I> & influence,
-py::array_t<I> & splitting
+input_array<I> & C_rowptr,
+input_array<I> & C_colinds,
+      input_array<I> & Tp,
+      input_array<I> & Tj,
+input_array<I> & influence,
+output_array<I> & splitting
                       )
 {
     auto py_C_rowptr = C_rowptr.unchecked();
@@ -132,24 +163,34 @@ py::array_t<I> & splitting
     const I *_Tj = py_Tj.data();
     const I *_influence = py_influence.data();
     I *_splitting = py_splitting.mutable_data();
+    int C_rowptr_size = array_size(C_rowptr.shape(0));
+    int C_colinds_size = array_size(C_colinds.shape(0));
+    int Tp_size = array_size(Tp.shape(0));
+    int Tj_size = array_size(Tj.shape(0));
+    int influence_size = array_size(influence.shape(0));
+    int splitting_size = array_size(splitting.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("rs_cf_splitting");
 
     return rs_cf_splitting<I>(
                   n_nodes,
-                _C_rowptr, C_rowptr.shape(0),
-               _C_colinds, C_colinds.shape(0),
-                      _Tp, Tp.shape(0),
-                      _Tj, Tj.shape(0),
-               _influence, influence.shape(0),
-               _splitting, splitting.shape(0)
+                _C_rowptr, C_rowptr_size,
+               _C_colinds, C_colinds_size,
+                      _Tp, Tp_size,
+                      _Tj, Tj_size,
+               _influence, influence_size,
+               _splitting, splitting_size
                               );
 }
 
 template<class I>
 void _rs_cf_splitting_pass2(
           const I n_nodes,
-py::array_t<I> & C_rowptr,
-py::array_t<I> & C_colinds,
-py::array_t<I> & splitting
+input_array<I> & C_rowptr,
+input_array<I> & C_colinds,
+output_array<I> & splitting
                             )
 {
     auto py_C_rowptr = C_rowptr.unchecked();
@@ -158,23 +199,122 @@ py::array_t<I> & splitting
     const I *_C_rowptr = py_C_rowptr.data();
     const I *_C_colinds = py_C_colinds.data();
     I *_splitting = py_splitting.mutable_data();
+    int C_rowptr_size = array_size(C_rowptr.shape(0));
+    int C_colinds_size = array_size(C_colinds.shape(0));
+    int splitting_size = array_size(splitting.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("rs_cf_splitting_pass2");
 
     return rs_cf_splitting_pass2<I>(
                   n_nodes,
-                _C_rowptr, C_rowptr.shape(0),
-               _C_colinds, C_colinds.shape(0),
-               _splitting, splitting.shape(0)
+                _C_rowptr, C_rowptr_size,
+               _C_colinds, C_colinds_size,
+               _splitting, splitting_size
                                     );
 }
 
+template<class I, class T>
+void _pmis_cf_splitting(
+          const I n_nodes,
+      input_array<I> & Sp,
+      input_array<I> & Sj,
+      input_array<I> & Tp,
+      input_array<I> & Tj,
+ input_array<T> & weights,
+output_array<I> & splitting
+                        )
+{
+    auto py_Sp = Sp.unchecked();
+    auto py_Sj = Sj.unchecked();
+    auto py_Tp = Tp.unchecked();
+    auto py_Tj = Tj.unchecked();
+    auto py_weights = weights.unchecked();
+    auto py_splitting = splitting.mutable_unchecked();
+    const I *_Sp = py_Sp.data();
+    const I *_Sj = py_Sj.data();
+    const I *_Tp = py_Tp.data();
+    const I *_Tj = py_Tj.data();
+    const T *_weights = py_weights.data();
+    I *_splitting = py_splitting.mutable_data();
+    int Sp_size = array_size(Sp.shape(0));
+    int Sj_size = array_size(Sj.shape(0));
+    int Tp_size = array_size(Tp.shape(0));
+    int Tj_size = array_size(Tj.shape(0));
+    int weights_size = array_size(weights.shape(0));
+    int splitting_size = array_size(splitting.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("pmis_cf_splitting");
+
+    return pmis_cf_splitting<I, T>(
+                  n_nodes,
+                      _Sp, Sp_size,
+                      _Sj, Sj_size,
+                      _Tp, Tp_size,
+                      _Tj, Tj_size,
+                 _weights, weights_size,
+               _splitting, splitting_size
+                                   );
+}
+
+template<class I, class T>
+void _hmis_cf_splitting(
+          const I n_nodes,
+      input_array<I> & Sp,
+      input_array<I> & Sj,
+      input_array<I> & Tp,
+      input_array<I> & Tj,
+ input_array<T> & weights,
+output_array<I> & splitting,
+  const I nodes_per_block
+                        )
+{
+    auto py_Sp = Sp.unchecked();
+    auto py_Sj = Sj.unchecked();
+    auto py_Tp = Tp.unchecked();
+    auto py_Tj = Tj.unchecked();
+    auto py_weights = weights.unchecked();
+    auto py_splitting = splitting.mutable_unchecked();
+    const I *_Sp = py_Sp.data();
+    const I *_Sj = py_Sj.data();
+    const I *_Tp = py_Tp.data();
+    const I *_Tj = py_Tj.data();
+    const T *_weights = py_weights.data();
+    I *_splitting = py_splitting.mutable_data();
+    int Sp_size = array_size(Sp.shape(0));
+    int Sj_size = array_size(Sj.shape(0));
+    int Tp_size = array_size(Tp.shape(0));
+    int Tj_size = array_size(Tj.shape(0));
+    int weights_size = array_size(weights.shape(0));
+    int splitting_size = array_size(splitting.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("hmis_cf_splitting");
+
+    return hmis_cf_splitting<I, T>(
+                  n_nodes,
+                      _Sp, Sp_size,
+                      _Sj, Sj_size,
+                      _Tp, Tp_size,
+                      _Tj, Tj_size,
+                 _weights, weights_size,
+               _splitting, splitting_size,
+          nodes_per_block
+                                   );
+}
+
 template<class I>
 void _cljp_naive_splitting(
                 const I n,
-      py::array_t<I> & Sp,
-      py::array_t<I> & Sj,
-      py::array_t<I> & Tp,
-      py::array_t<I> & Tj,
-py::array_t<I> & splitting,
+      input_array<I> & Sp,
+      input_array<I> & Sj,
+      input_array<I> & Tp,
+      input_array<I> & Tj,
+output_array<I> & splitting,
         const I colorflag
                            )
 {
@@ -188,14 +328,23 @@ py::array_t<I> & splitting,
     const I *_Tp = py_Tp.data();
     const I *_Tj = py_Tj.data();
     I *_splitting = py_splitting.mutable_data();
+    int Sp_size = array_size(Sp.shape(0));
+    int Sj_size = array_size(Sj.shape(0));
+    int Tp_size = array_size(Tp.shape(0));
+    int Tj_size = array_size(Tj.shape(0));
+    int splitting_size = array_size(splitting.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("cljp_naive_splitting");
 
     return cljp_naive_splitting<I>(
                         n,
-                      _Sp, Sp.shape(0),
-                      _Sj, Sj.shape(0),
-                      _Tp, Tp.shape(0),
-                      _Tj, Tj.shape(0),
-               _splitting, splitting.shape(0),
+                      _Sp, Sp_size,
+                      _Sj, Sj_size,
+                      _Tp, Tp_size,
+                      _Tj, Tj_size,
+               _splitting, splitting_size,
                 colorflag
                                    );
 }
@@ -203,10 +352,10 @@ py::array_t<I> & splitting,
 template<class I>
 void _rs_direct_interpolation_pass1(
           const I n_nodes,
-      py::array_t<I> & Sp,
-      py::array_t<I> & Sj,
-py::array_t<I> & splitting,
-      py::array_t<I> & Bp
+      input_array<I> & Sp,
+      input_array<I> & Sj,
+input_array<I> & splitting,
+     output_array<I> & Bp
                                     )
 {
     auto py_Sp = Sp.unchecked();
@@ -217,29 +366,37 @@ py::array_t<I> & splitting,
     const I *_Sj = py_Sj.data();
     const I *_splitting = py_splitting.data();
     I *_Bp = py_Bp.mutable_data();
+    int Sp_size = array_size(Sp.shape(0));
+    int Sj_size = array_size(Sj.shape(0));
+    int splitting_size = array_size(splitting.shape(0));
+    int Bp_size = array_size(Bp.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("rs_direct_interpolation_pass1");
 
     return rs_direct_interpolation_pass1<I>(
                   n_nodes,
-                      _Sp, Sp.shape(0),
-                      _Sj, Sj.shape(0),
-               _splitting, splitting.shape(0),
-                      _Bp, Bp.shape(0)
+                      _Sp, Sp_size,
+                      _Sj, Sj_size,
+               _splitting, splitting_size,
+                      _Bp, Bp_size
                                             );
 }
 
 template<class I, class T>
 void _rs_direct_interpolation_pass2(
           const I n_nodes,
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
-      py::array_t<T> & Ax,
-      py::array_t<I> & Sp,
-      py::array_t<I> & Sj,
-      py::array_t<T> & Sx,
-py::array_t<I> & splitting,
-      py::array_t<I> & Bp,
-      py::array_t<I> & Bj,
-      py::array_t<T> & Bx
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      input_array<I> & Sp,
+      input_array<I> & Sj,
+      input_array<T> & Sx,
+input_array<I> & splitting,
+      input_array<I> & Bp,
+     output_array<I> & Bj,
+     output_array<T> & Bx
                                     )
 {
     auto py_Ap = Ap.unchecked();
@@ -262,31 +419,173 @@ py::array_t<I> & splitting,
     const I *_Bp = py_Bp.data();
     I *_Bj = py_Bj.mutable_data();
     T *_Bx = py_Bx.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int Sp_size = array_size(Sp.shape(0));
+    int Sj_size = array_size(Sj.shape(0));
+    int Sx_size = array_size(Sx.shape(0));
+    int splitting_size = array_size(splitting.shape(0));
+    int Bp_size = array_size(Bp.shape(0));
+    int Bj_size = array_size(Bj.shape(0));
+    int Bx_size = array_size(Bx.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("rs_direct_interpolation_pass2");
 
     return rs_direct_interpolation_pass2<I, T>(
                   n_nodes,
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
-                      _Ax, Ax.shape(0),
-                      _Sp, Sp.shape(0),
-                      _Sj, Sj.shape(0),
-                      _Sx, Sx.shape(0),
-               _splitting, splitting.shape(0),
-                      _Bp, Bp.shape(0),
-                      _Bj, Bj.shape(0),
-                      _Bx, Bx.shape(0)
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                      _Sp, Sp_size,
+                      _Sj, Sj_size,
+                      _Sx, Sx_size,
+               _splitting, splitting_size,
+                      _Bp, Bp_size,
+                      _Bj, Bj_size,
+                      _Bx, Bx_size
                                                );
 }
 
+template<class I, class T>
+void _rs_direct_interpolation_truncated_pass1(
+          const I n_nodes,
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      input_array<I> & Sp,
+      input_array<I> & Sj,
+      input_array<T> & Sx,
+input_array<I> & splitting,
+     output_array<I> & Bp,
+      const I max_row_nnz,
+     const T trunc_factor
+                                              )
+{
+    auto py_Ap = Ap.unchecked();
+    auto py_Aj = Aj.unchecked();
+    auto py_Ax = Ax.unchecked();
+    auto py_Sp = Sp.unchecked();
+    auto py_Sj = Sj.unchecked();
+    auto py_Sx = Sx.unchecked();
+    auto py_splitting = splitting.unchecked();
+    auto py_Bp = Bp.mutable_unchecked();
+    const I *_Ap = py_Ap.data();
+    const I *_Aj = py_Aj.data();
+    const T *_Ax = py_Ax.data();
+    const I *_Sp = py_Sp.data();
+    const I *_Sj = py_Sj.data();
+    const T *_Sx = py_Sx.data();
+    const I *_splitting = py_splitting.data();
+    I *_Bp = py_Bp.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int Sp_size = array_size(Sp.shape(0));
+    int Sj_size = array_size(Sj.shape(0));
+    int Sx_size = array_size(Sx.shape(0));
+    int splitting_size = array_size(splitting.shape(0));
+    int Bp_size = array_size(Bp.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("rs_direct_interpolation_truncated_pass1");
+
+    return rs_direct_interpolation_truncated_pass1<I, T>(
+                  n_nodes,
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                      _Sp, Sp_size,
+                      _Sj, Sj_size,
+                      _Sx, Sx_size,
+               _splitting, splitting_size,
+                      _Bp, Bp_size,
+              max_row_nnz,
+             trunc_factor
+                                                         );
+}
+
+template<class I, class T>
+void _rs_direct_interpolation_truncated_pass2(
+          const I n_nodes,
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      input_array<I> & Sp,
+      input_array<I> & Sj,
+      input_array<T> & Sx,
+input_array<I> & splitting,
+      input_array<I> & Bp,
+     output_array<I> & Bj,
+     output_array<T> & Bx,
+      const I max_row_nnz,
+     const T trunc_factor
+                                              )
+{
+    auto py_Ap = Ap.unchecked();
+    auto py_Aj = Aj.unchecked();
+    auto py_Ax = Ax.unchecked();
+    auto py_Sp = Sp.unchecked();
+    auto py_Sj = Sj.unchecked();
+    auto py_Sx = Sx.unchecked();
+    auto py_splitting = splitting.unchecked();
+    auto py_Bp = Bp.unchecked();
+    auto py_Bj = Bj.mutable_unchecked();
+    auto py_Bx = Bx.mutable_unchecked();
+    const I *_Ap = py_Ap.data();
+    const I *_Aj = py_Aj.data();
+    const T *_Ax = py_Ax.data();
+    const I *_Sp = py_Sp.data();
+    const I *_Sj = py_Sj.data();
+    const T *_Sx = py_Sx.data();
+    const I *_splitting = py_splitting.data();
+    const I *_Bp = py_Bp.data();
+    I *_Bj = py_Bj.mutable_data();
+    T *_Bx = py_Bx.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int Sp_size = array_size(Sp.shape(0));
+    int Sj_size = array_size(Sj.shape(0));
+    int Sx_size = array_size(Sx.shape(0));
+    int splitting_size = array_size(splitting.shape(0));
+    int Bp_size = array_size(Bp.shape(0));
+    int Bj_size = array_size(Bj.shape(0));
+    int Bx_size = array_size(Bx.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("rs_direct_interpolation_truncated_pass2");
+
+    return rs_direct_interpolation_truncated_pass2<I, T>(
+                  n_nodes,
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                      _Sp, Sp_size,
+                      _Sj, Sj_size,
+                      _Sx, Sx_size,
+               _splitting, splitting_size,
+                      _Bp, Bp_size,
+                      _Bj, Bj_size,
+                      _Bx, Bx_size,
+              max_row_nnz,
+             trunc_factor
+                                                         );
+}
+
 template<class I, class T>
 void _cr_helper(
-py::array_t<I> & A_rowptr,
-py::array_t<I> & A_colinds,
-       py::array_t<T> & B,
-       py::array_t<T> & e,
- py::array_t<I> & indices,
-py::array_t<I> & splitting,
-   py::array_t<T> & gamma,
+input_array<I> & A_rowptr,
+input_array<I> & A_colinds,
+       input_array<T> & B,
+      output_array<T> & e,
+output_array<I> & indices,
+output_array<I> & splitting,
+  output_array<T> & gamma,
           const T thetacs
                 )
 {
@@ -304,15 +603,26 @@ py::array_t<I> & splitting,
     I *_indices = py_indices.mutable_data();
     I *_splitting = py_splitting.mutable_data();
     T *_gamma = py_gamma.mutable_data();
+    int A_rowptr_size = array_size(A_rowptr.shape(0));
+    int A_colinds_size = array_size(A_colinds.shape(0));
+    int B_size = array_size(B.shape(0));
+    int e_size = array_size(e.shape(0));
+    int indices_size = array_size(indices.shape(0));
+    int splitting_size = array_size(splitting.shape(0));
+    int gamma_size = array_size(gamma.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("cr_helper");
 
     return cr_helper<I, T>(
-                _A_rowptr, A_rowptr.shape(0),
-               _A_colinds, A_colinds.shape(0),
-                       _B, B.shape(0),
-                       _e, e.shape(0),
-                 _indices, indices.shape(0),
-               _splitting, splitting.shape(0),
-                   _gamma, gamma.shape(0),
+                _A_rowptr, A_rowptr_size,
+               _A_colinds, A_colinds_size,
+                       _B, B_size,
+                       _e, e_size,
+                 _indices, indices_size,
+               _splitting, splitting_size,
+                   _gamma, gamma_size,
                   thetacs
                            );
 }
@@ -328,23 +638,42 @@ PYBIND11_MODULE(ruge_stuben, m) {
     maximum_row_value
     rs_cf_splitting
     rs_cf_splitting_pass2
+    pmis_cf_splitting
+    hmis_cf_splitting
     cljp_naive_splitting
     rs_direct_interpolation_pass1
     rs_direct_interpolation_pass2
+    rs_direct_interpolation_truncated_pass1
+    rs_direct_interpolation_truncated_pass2
     cr_helper
     )pbdoc";
 
     py::options options;
     options.disable_function_signatures();
 
+    share_num_threads();
+
+    m.def("_kernel_timers", &swap_kernel_timers, py::arg("enable"),
+R"pbdoc(
+Return and reset the kernel timers of the calling thread, and enable or
+disable them for subsequent calls, see bind_timers.h.)pbdoc");
+
     m.def("classical_strength_of_connection_abs", &_classical_strength_of_connection_abs<int, float, float>,
-        py::arg("n_row"), py::arg("theta"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
+        py::arg("n_row"), py::arg("theta"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
     m.def("classical_strength_of_connection_abs", &_classical_strength_of_connection_abs<int, double, double>,
-        py::arg("n_row"), py::arg("theta"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
+        py::arg("n_row"), py::arg("theta"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
     m.def("classical_strength_of_connection_abs", &_classical_strength_of_connection_abs<int, std::complex<float>, float>,
-        py::arg("n_row"), py::arg("theta"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
+        py::arg("n_row"), py::arg("theta"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
     m.def("classical_strength_of_connection_abs", &_classical_strength_of_connection_abs<int, std::complex<double>, double>,
-        py::arg("n_row"), py::arg("theta"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert(),
+        py::arg("n_row"), py::arg("theta"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
+    m.def("classical_strength_of_connection_abs", &_classical_strength_of_connection_abs<int64_t, float, float>,
+        py::arg("n_row"), py::arg("theta"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
+    m.def("classical_strength_of_connection_abs", &_classical_strength_of_connection_abs<int64_t, double, double>,
+        py::arg("n_row"), py::arg("theta"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
+    m.def("classical_strength_of_connection_abs", &_classical_strength_of_connection_abs<int64_t, std::complex<float>, float>,
+        py::arg("n_row"), py::arg("theta"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
+    m.def("classical_strength_of_connection_abs", &_classical_strength_of_connection_abs<int64_t, std::complex<double>, double>,
+        py::arg("n_row"), py::arg("theta"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert(),
 R"pbdoc(
 Compute a strength of connection matrix using the classical strength
  of connection measure by Ruge and Stuben. Both the input and output
@@ -372,23 +701,39 @@ Otherwise, the connection is weak.
  Notes:
      Storage for S must be preallocated.  Since S will consist of a subset
      of A's nonzero values, a conservative bound is to allocate the same
-     storage for S as is used by A.)pbdoc");
+     storage for S as is used by A.
+
+     The rows are processed in parallel in two passes: the strong
+     connections in each row are counted, Sp is formed by a cumulative
+     sum of the counts, and then each row of Sj and Sx is filled.)pbdoc");
 
     m.def("classical_strength_of_connection_min", &_classical_strength_of_connection_min<int, float>,
-        py::arg("n_row"), py::arg("theta"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
+        py::arg("n_row"), py::arg("theta"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
     m.def("classical_strength_of_connection_min", &_classical_strength_of_connection_min<int, double>,
-        py::arg("n_row"), py::arg("theta"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert(),
+        py::arg("n_row"), py::arg("theta"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
+    m.def("classical_strength_of_connection_min", &_classical_strength_of_connection_min<int64_t, float>,
+        py::arg("n_row"), py::arg("theta"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
+    m.def("classical_strength_of_connection_min", &_classical_strength_of_connection_min<int64_t, double>,
+        py::arg("n_row"), py::arg("theta"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert(),
 R"pbdoc(
 )pbdoc");
 
     m.def("maximum_row_value", &_maximum_row_value<int, float, float>,
-        py::arg("n_row"), py::arg("x").noconvert(), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert());
+        py::arg("n_row"), py::arg("x").noconvert(), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"));
     m.def("maximum_row_value", &_maximum_row_value<int, double, double>,
-        py::arg("n_row"), py::arg("x").noconvert(), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert());
+        py::arg("n_row"), py::arg("x").noconvert(), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"));
     m.def("maximum_row_value", &_maximum_row_value<int, std::complex<float>, float>,
-        py::arg("n_row"), py::arg("x").noconvert(), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert());
+        py::arg("n_row"), py::arg("x").noconvert(), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"));
     m.def("maximum_row_value", &_maximum_row_value<int, std::complex<double>, double>,
-        py::arg("n_row"), py::arg("x").noconvert(), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(),
+        py::arg("n_row"), py::arg("x").noconvert(), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"));
+    m.def("maximum_row_value", &_maximum_row_value<int64_t, float, float>,
+        py::arg("n_row"), py::arg("x").noconvert(), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"));
+    m.def("maximum_row_value", &_maximum_row_value<int64_t, double, double>,
+        py::arg("n_row"), py::arg("x").noconvert(), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"));
+    m.def("maximum_row_value", &_maximum_row_value<int64_t, std::complex<float>, float>,
+        py::arg("n_row"), py::arg("x").noconvert(), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"));
+    m.def("maximum_row_value", &_maximum_row_value<int64_t, std::complex<double>, double>,
+        py::arg("n_row"), py::arg("x").noconvert(), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"),
 R"pbdoc(
 Compute the maximum in magnitude row value for a CSR matrix
 
@@ -403,7 +748,9 @@ Compute the maximum in magnitude row value for a CSR matrix
      Nothing, x[i] will hold row i's maximum magnitude entry)pbdoc");
 
     m.def("rs_cf_splitting", &_rs_cf_splitting<int>,
-        py::arg("n_nodes"), py::arg("C_rowptr").noconvert(), py::arg("C_colinds").noconvert(), py::arg("Tp").noconvert(), py::arg("Tj").noconvert(), py::arg("influence").noconvert(), py::arg("splitting").noconvert(),
+        py::arg("n_nodes"), py::arg("C_rowptr"), py::arg("C_colinds"), py::arg("Tp"), py::arg("Tj"), py::arg("influence"), py::arg("splitting").noconvert());
+    m.def("rs_cf_splitting", &_rs_cf_splitting<int64_t>,
+        py::arg("n_nodes"), py::arg("C_rowptr"), py::arg("C_colinds"), py::arg("Tp"), py::arg("Tj"), py::arg("influence"), py::arg("splitting").noconvert(),
 R"pbdoc(
 Compute a C/F (coarse-fine( splitting using the classical coarse grid
 selection method of Ruge and Stuben.  The strength of connection matrix S,
@@ -425,17 +772,96 @@ Notes:
   The splitting array must be preallocated)pbdoc");
 
     m.def("rs_cf_splitting_pass2", &_rs_cf_splitting_pass2<int>,
-        py::arg("n_nodes"), py::arg("C_rowptr").noconvert(), py::arg("C_colinds").noconvert(), py::arg("splitting").noconvert(),
+        py::arg("n_nodes"), py::arg("C_rowptr"), py::arg("C_colinds"), py::arg("splitting").noconvert());
+    m.def("rs_cf_splitting_pass2", &_rs_cf_splitting_pass2<int64_t>,
+        py::arg("n_nodes"), py::arg("C_rowptr"), py::arg("C_colinds"), py::arg("splitting").noconvert(),
 R"pbdoc(
 )pbdoc");
 
+    m.def("pmis_cf_splitting", &_pmis_cf_splitting<int, float>,
+        py::arg("n_nodes"), py::arg("Sp"), py::arg("Sj"), py::arg("Tp"), py::arg("Tj"), py::arg("weights"), py::arg("splitting").noconvert());
+    m.def("pmis_cf_splitting", &_pmis_cf_splitting<int, double>,
+        py::arg("n_nodes"), py::arg("Sp"), py::arg("Sj"), py::arg("Tp"), py::arg("Tj"), py::arg("weights"), py::arg("splitting").noconvert());
+    m.def("pmis_cf_splitting", &_pmis_cf_splitting<int64_t, float>,
+        py::arg("n_nodes"), py::arg("Sp"), py::arg("Sj"), py::arg("Tp"), py::arg("Tj"), py::arg("weights"), py::arg("splitting").noconvert());
+    m.def("pmis_cf_splitting", &_pmis_cf_splitting<int64_t, double>,
+        py::arg("n_nodes"), py::arg("Sp"), py::arg("Sj"), py::arg("Tp"), py::arg("Tj"), py::arg("weights"), py::arg("splitting").noconvert(),
+R"pbdoc(
+Compute a C/F splitting using the Parallel Modified Independent Set
+(PMIS) method of De Sterck, Yang and Heys.  The strength of connection
+matrix S, and its transpose T, are stored in CSR format.  Upon return,
+the splitting array will consist of zeros and ones, where C-nodes
+(coarse nodes) are marked with the value 1 and F-nodes (fine nodes)
+with the value 0.
+
+Parameters:
+  n_nodes   - number of rows in A
+  Sp[]      - CSR row pointer array for SOC matrix
+  Sj[]      - CSR column index array for SOC matrix
+  Tp[]      - CSR row pointer array for transpose of SOC matrix
+  Tj[]      - CSR column index array for transpose of SOC matrix
+  weights   - measure of each node, usually the number of nodes that
+              strongly depend on it plus a random number in [0,1)
+  splitting - array to store the C/F splitting
+
+Notes:
+  The splitting array must be preallocated.
+
+  Nodes that no other node strongly depends on become F-nodes.  The
+  remaining nodes are split in rounds, see pmis_rounds(...), so the
+  C-nodes are a maximal independent set of the graph of S + S^T, but
+  S + S^T is not formed.
+
+  The rounds are threaded with OpenMP, and the splitting does not
+  depend on the number of threads.)pbdoc");
+
+    m.def("hmis_cf_splitting", &_hmis_cf_splitting<int, float>,
+        py::arg("n_nodes"), py::arg("Sp"), py::arg("Sj"), py::arg("Tp"), py::arg("Tj"), py::arg("weights"), py::arg("splitting").noconvert(), py::arg("nodes_per_block"));
+    m.def("hmis_cf_splitting", &_hmis_cf_splitting<int, double>,
+        py::arg("n_nodes"), py::arg("Sp"), py::arg("Sj"), py::arg("Tp"), py::arg("Tj"), py::arg("weights"), py::arg("splitting").noconvert(), py::arg("nodes_per_block"));
+    m.def("hmis_cf_splitting", &_hmis_cf_splitting<int64_t, float>,
+        py::arg("n_nodes"), py::arg("Sp"), py::arg("Sj"), py::arg("Tp"), py::arg("Tj"), py::arg("weights"), py::arg("splitting").noconvert(), py::arg("nodes_per_block"));
+    m.def("hmis_cf_splitting", &_hmis_cf_splitting<int64_t, double>,
+        py::arg("n_nodes"), py::arg("Sp"), py::arg("Sj"), py::arg("Tp"), py::arg("Tj"), py::arg("weights"), py::arg("splitting").noconvert(), py::arg("nodes_per_block"),
+R"pbdoc(
+Compute a C/F splitting using the Hybrid Modified Independent Set
+(HMIS) method of De Sterck, Yang and Heys.  The nodes are divided into
+blocks of consecutive nodes, and the first pass of Ruge-Stuben
+coarsening is applied to each block, using only the strong connections
+within the block.  The C-nodes from these passes without strong
+connections to other blocks are the initial C-nodes of PMIS, which
+splits the remaining nodes.
+
+Parameters:
+  n_nodes    - number of rows in A
+  Sp[]       - CSR row pointer array for SOC matrix
+  Sj[]       - CSR column index array for SOC matrix
+  Tp[]       - CSR row pointer array for transpose of SOC matrix
+  Tj[]       - CSR column index array for transpose of SOC matrix
+  weights    - measure of each node for PMIS, see pmis_cf_splitting(...)
+  splitting  - array to store the C/F splitting
+  nodes_per_block - number of nodes in each block
+
+Notes:
+  The splitting array must be preallocated.
+
+  The blocks take the role of the processor subdomains in the
+  distributed algorithm.  The blocks are split in parallel, and their
+  size does not depend on the number of threads, so neither does the
+  splitting.  Larger blocks give a splitting closer to Ruge-Stuben
+  coarsening, but less parallelism.)pbdoc");
+
     m.def("cljp_naive_splitting", &_cljp_naive_splitting<int>,
-        py::arg("n"), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Tp").noconvert(), py::arg("Tj").noconvert(), py::arg("splitting").noconvert(), py::arg("colorflag"),
+        py::arg("n"), py::arg("Sp"), py::arg("Sj"), py::arg("Tp"), py::arg("Tj"), py::arg("splitting").noconvert(), py::arg("colorflag"));
+    m.def("cljp_naive_splitting", &_cljp_naive_splitting<int64_t>,
+        py::arg("n"), py::arg("Sp"), py::arg("Sj"), py::arg("Tp"), py::arg("Tj"), py::arg("splitting").noconvert(), py::arg("colorflag"),
 R"pbdoc(
 )pbdoc");
 
     m.def("rs_direct_interpolation_pass1", &_rs_direct_interpolation_pass1<int>,
-        py::arg("n_nodes"), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("splitting").noconvert(), py::arg("Bp").noconvert(),
+        py::arg("n_nodes"), py::arg("Sp"), py::arg("Sj"), py::arg("splitting"), py::arg("Bp").noconvert());
+    m.def("rs_direct_interpolation_pass1", &_rs_direct_interpolation_pass1<int64_t>,
+        py::arg("n_nodes"), py::arg("Sp"), py::arg("Sj"), py::arg("splitting"), py::arg("Bp").noconvert(),
 R"pbdoc(
 Produce the Ruge-Stuben prolongator using "Direct Interpolation"
 
@@ -445,20 +871,100 @@ Produce the Ruge-Stuben prolongator using "Direct Interpolation"
 
   The second pass fills in the nonzero entries of the prolongator
 
+  Both passes are threaded over the rows of P, and the row pointer is
+  formed by a cumulative sum of the row counts.
+
   Reference:
      Page 479 of "Multigrid")pbdoc");
 
     m.def("rs_direct_interpolation_pass2", &_rs_direct_interpolation_pass2<int, float>,
-        py::arg("n_nodes"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert(), py::arg("splitting").noconvert(), py::arg("Bp").noconvert(), py::arg("Bj").noconvert(), py::arg("Bx").noconvert());
+        py::arg("n_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx"), py::arg("splitting"), py::arg("Bp"), py::arg("Bj").noconvert(), py::arg("Bx").noconvert());
     m.def("rs_direct_interpolation_pass2", &_rs_direct_interpolation_pass2<int, double>,
-        py::arg("n_nodes"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert(), py::arg("splitting").noconvert(), py::arg("Bp").noconvert(), py::arg("Bj").noconvert(), py::arg("Bx").noconvert(),
+        py::arg("n_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx"), py::arg("splitting"), py::arg("Bp"), py::arg("Bj").noconvert(), py::arg("Bx").noconvert());
+    m.def("rs_direct_interpolation_pass2", &_rs_direct_interpolation_pass2<int64_t, float>,
+        py::arg("n_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx"), py::arg("splitting"), py::arg("Bp"), py::arg("Bj").noconvert(), py::arg("Bx").noconvert());
+    m.def("rs_direct_interpolation_pass2", &_rs_direct_interpolation_pass2<int64_t, double>,
+        py::arg("n_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx"), py::arg("splitting"), py::arg("Bp"), py::arg("Bj").noconvert(), py::arg("Bx").noconvert(),
 R"pbdoc(
 )pbdoc");
 
+    m.def("rs_direct_interpolation_truncated_pass1", &_rs_direct_interpolation_truncated_pass1<int, float>,
+        py::arg("n_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx"), py::arg("splitting"), py::arg("Bp").noconvert(), py::arg("max_row_nnz"), py::arg("trunc_factor"));
+    m.def("rs_direct_interpolation_truncated_pass1", &_rs_direct_interpolation_truncated_pass1<int, double>,
+        py::arg("n_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx"), py::arg("splitting"), py::arg("Bp").noconvert(), py::arg("max_row_nnz"), py::arg("trunc_factor"));
+    m.def("rs_direct_interpolation_truncated_pass1", &_rs_direct_interpolation_truncated_pass1<int64_t, float>,
+        py::arg("n_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx"), py::arg("splitting"), py::arg("Bp").noconvert(), py::arg("max_row_nnz"), py::arg("trunc_factor"));
+    m.def("rs_direct_interpolation_truncated_pass1", &_rs_direct_interpolation_truncated_pass1<int64_t, double>,
+        py::arg("n_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx"), py::arg("splitting"), py::arg("Bp").noconvert(), py::arg("max_row_nnz"), py::arg("trunc_factor"),
+R"pbdoc(
+Produce the Ruge-Stuben prolongator using "Direct Interpolation",
+  and truncate the interpolation weights of each row of P.
+
+  The first pass computes the weights of each row, truncates them and
+  computes the row pointer for the prolongator.  The second pass
+  recomputes the truncated weights and fills in the nonzero entries of
+  the prolongator.  Both passes are threaded over the rows of P.
+
+  Parameters:
+    n_nodes      - number of rows in A
+    Ap, Aj, Ax   - CSR matrix A
+    Sp, Sj, Sx   - CSR strength of connection matrix, with the entries
+                   of A in the sparsity pattern of S
+    splitting    - C/F splitting
+    Bp, Bj, Bx   - CSR prolongator, Bp is computed by the first pass,
+                   and Bj and Bx by the second
+    max_row_nnz  - maximum number of weights in each row of P, or
+                   <= 0 for no limit
+    trunc_factor - weights with magnitude less than trunc_factor times
+                   the largest magnitude in the row are dropped
+
+  Notes:
+    The remaining weights in each row are scaled so that the row sum
+    is unchanged, see rs_truncate_row(...).  With max_row_nnz <= 0 and
+    trunc_factor = 0, P is the same as from rs_direct_interpolation_pass2.
+
+    Only the truncated row lengths are kept from the first pass, in Bp,
+    as the number of weights is not known before the rows are truncated.
+    The second pass recomputes and truncates each row of F-nodes, i.e.,
+    the weights are computed twice, as for rs_direct_interpolation_pass2.)pbdoc");
+
+    m.def("rs_direct_interpolation_truncated_pass2", &_rs_direct_interpolation_truncated_pass2<int, float>,
+        py::arg("n_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx"), py::arg("splitting"), py::arg("Bp"), py::arg("Bj").noconvert(), py::arg("Bx").noconvert(), py::arg("max_row_nnz"), py::arg("trunc_factor"));
+    m.def("rs_direct_interpolation_truncated_pass2", &_rs_direct_interpolation_truncated_pass2<int, double>,
+        py::arg("n_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx"), py::arg("splitting"), py::arg("Bp"), py::arg("Bj").noconvert(), py::arg("Bx").noconvert(), py::arg("max_row_nnz"), py::arg("trunc_factor"));
+    m.def("rs_direct_interpolation_truncated_pass2", &_rs_direct_interpolation_truncated_pass2<int64_t, float>,
+        py::arg("n_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx"), py::arg("splitting"), py::arg("Bp"), py::arg("Bj").noconvert(), py::arg("Bx").noconvert(), py::arg("max_row_nnz"), py::arg("trunc_factor"));
+    m.def("rs_direct_interpolation_truncated_pass2", &_rs_direct_interpolation_truncated_pass2<int64_t, double>,
+        py::arg("n_nodes"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx"), py::arg("splitting"), py::arg("Bp"), py::arg("Bj").noconvert(), py::arg("Bx").noconvert(), py::arg("max_row_nnz"), py::arg("trunc_factor"),
+R"pbdoc(
+Second pass of the truncated "Direct Interpolation", which fills in
+  the nonzero entries of the prolongator, see
+  rs_direct_interpolation_truncated_pass1.
+
+  The weights of each row of an F-node are recomputed and truncated as
+  in the first pass, so that they fit the row pointer Bp.  Rows of
+  C-nodes interpolate by injection.  The column indices are mapped to
+  the coarse grid at the end.  Threaded over the rows of P.
+
+  Parameters:
+    n_nodes      - number of rows in A
+    Ap, Aj, Ax   - CSR matrix A
+    Sp, Sj, Sx   - CSR strength of connection matrix, with the entries
+                   of A in the sparsity pattern of S
+    splitting    - C/F splitting
+    Bp           - CSR row pointer of P, from the first pass
+    Bj, Bx       - CSR column indices and data of P, of size Bp[n_nodes]
+    max_row_nnz  - same as for the first pass
+    trunc_factor - same as for the first pass)pbdoc");
+
     m.def("cr_helper", &_cr_helper<int, float>,
-        py::arg("A_rowptr").noconvert(), py::arg("A_colinds").noconvert(), py::arg("B").noconvert(), py::arg("e").noconvert(), py::arg("indices").noconvert(), py::arg("splitting").noconvert(), py::arg("gamma").noconvert(), py::arg("thetacs"));
+        py::arg("A_rowptr"), py::arg("A_colinds"), py::arg("B"), py::arg("e").noconvert(), py::arg("indices").noconvert(), py::arg("splitting").noconvert(), py::arg("gamma").noconvert(), py::arg("thetacs"));
     m.def("cr_helper", &_cr_helper<int, double>,
-        py::arg("A_rowptr").noconvert(), py::arg("A_colinds").noconvert(), py::arg("B").noconvert(), py::arg("e").noconvert(), py::arg("indices").noconvert(), py::arg("splitting").noconvert(), py::arg("gamma").noconvert(), py::arg("thetacs"),
+        py::arg("A_rowptr"), py::arg("A_colinds"), py::arg("B"), py::arg("e").noconvert(), py::arg("indices").noconvert(), py::arg("splitting").noconvert(), py::arg("gamma").noconvert(), py::arg("thetacs"));
+    m.def("cr_helper", &_cr_helper<int64_t, float>,
+        py::arg("A_rowptr"), py::arg("A_colinds"), py::arg("B"), py::arg("e").noconvert(), py::arg("indices").noconvert(), py::arg("splitting").noconvert(), py::arg("gamma").noconvert(), py::arg("thetacs"));
+    m.def("cr_helper", &_cr_helper<int64_t, double>,
+        py::arg("A_rowptr"), py::arg("A_colinds"), py::arg("B"), py::arg("e").noconvert(), py::arg("indices").noconvert(), py::arg("splitting").noconvert(), py::arg("gamma").noconvert(), py::arg("thetacs"),
 R"pbdoc(
 Helper function for compatible relaxation to perform steps 3.1d - 3.1f
 in Falgout / Brannick (2010).
@@ -9,7 +9,10 @@
 #include <assert.h>
 #include <cmath>
 
+#include "graph.h"
 #include "linalg.h"
+#include "parallel.h"
+#include "sparse.h"
 
 
 /*
@@ -58,6 +61,7 @@ void symmetric_strength_of_connection(const I n_row,
     std::vector<F> diags(n_row);
 
     //compute norm of diagonal values
+    #pragma omp parallel for schedule(static)
     for(I i = 0; i < n_row; i++){
         T diag = 0.0;
         for(I jj = Ap[i]; jj < Ap[i+1]; jj++){
@@ -68,12 +72,32 @@ void symmetric_strength_of_connection(const I n_row,
         diags[i] = mynorm(diag);
     }
 
-    I nnz = 0;
+    //count the strong connections in each row, then form Sp from
+    //the counts so that the rows of Sj and Sx can be filled in parallel
+    #pragma omp parallel for schedule(static)
+    for(I i = 0; i < n_row; i++){
+
+        F eps_Aii = theta*theta*diags[i];
+        I row_nnz = 0;
+
+        for(I jj = Ap[i]; jj < Ap[i+1]; jj++){
+            const I j = Aj[jj];
+            //  |A(i,j)| >= theta * sqrt(|A(i,i)|*|A(j,j)|)
+            if(i == j || mynormsq(Ax[jj]) >= eps_Aii * diags[j]){
+                row_nnz++;
+            }
+        }
+        Sp[i+1] = row_nnz;
+    }
+
     Sp[0] = 0;
+    cumulative_sum(Sp + 1, n_row);
 
+    #pragma omp parallel for schedule(static)
     for(I i = 0; i < n_row; i++){
 
         F eps_Aii = theta*theta*diags[i];
+        I nnz = Sp[i];
 
         for(I jj = Ap[i]; jj < Ap[i+1]; jj++){
             const I   j = Aj[jj];
@@ -92,7 +116,6 @@ void symmetric_strength_of_connection(const I n_row,
                 nnz++;
             }
         }
-        Sp[i+1] = nnz;
     }
 }
 
@@ -275,6 +298,132 @@ I naive_aggregation(const I n_row,
 }
 
 
+/*
+ * Compute aggregates for a matrix A stored in CSR format in parallel
+ *
+ * Parameters:
+ *   n_row         - number of rows in A
+ *   Ap[n_row + 1] - CSR row pointer
+ *   Aj[nnz]       - CSR column indices
+ *    x[n_row]     - aggregate numbers for each node
+ *    y[n_row]     - will hold Cpts upon return
+ *    r[n_row]     - random values used to select the root nodes
+ *
+ * Returns:
+ *  The number of aggregates (== max(x[:]) + 1 )
+ *
+ * Notes:
+ *    It is assumed that A is symmetric.
+ *    A may contain diagonal entries (self loops)
+ *    Unaggregated (isolated) nodes are marked with a -1
+ *
+ *    The root nodes are a distance-2 maximal independent set of A, so
+ *    no two roots share a neighbor.  Each root takes all of its
+ *    neighbors, and the remaining nodes, which are all at distance 2
+ *    from a root, join the aggregate of their first aggregated
+ *    neighbor.  This mimics the passes of standard_aggregation, but
+ *    every pass only reads the result of the previous one, so the
+ *    aggregates depend on r and not on the number of threads.
+ *
+ */
+template <class I, class R>
+I parallel_aggregation(const I n_row,
+                       const I Ap[], const int Ap_size,
+                       const I Aj[], const int Aj_size,
+                             I  x[], const int  x_size,
+                             I  y[], const int  y_size,
+                       const R  r[], const int  r_size)
+{
+    std::vector<I> roots(n_row);
+    maximal_independent_set_k_parallel(n_row, Ap, Ap_size, Aj, Aj_size, (I)2,
+                                       &roots[0], n_row, r, r_size, (I)-1);
+
+    //Pass #1
+    //Number the roots in order, leaving out isolated nodes
+    std::vector<I> agg(n_row + 1);
+    agg[0] = 0;
+    #pragma omp parallel for schedule(static)
+    for(I i = 0; i < n_row; i++){
+        bool has_neighbors = false;
+        for(I jj = Ap[i]; jj < Ap[i+1]; jj++){
+            if(Aj[jj] != i){
+                has_neighbors = true;
+                break;
+            }
+        }
+        if(!has_neighbors){
+            roots[i] = 0;
+            x[i] = -2;  // isolated node, do not aggregate
+        }
+        else {
+            x[i] = -1;
+        }
+        agg[i + 1] = roots[i] ? 1 : 0;
+    }
+    cumulative_sum(&agg[1], n_row);
+
+    //Pass #2
+    //Make an aggregate out of each root and its neighbors
+    #pragma omp parallel for schedule(static)
+    for(I i = 0; i < n_row; i++){
+        if(roots[i]){
+            x[i] = agg[i];
+            y[agg[i]] = i;              //y stores a list of the Cpts
+            continue;
+        }
+        if(x[i] != -1){ continue; }
+
+        for(I jj = Ap[i]; jj < Ap[i+1]; jj++){
+            const I j = Aj[jj];
+            if(roots[j]){
+                x[i] = agg[j];
+                break;
+            }
+        }
+    }
+
+    //Pass #3
+    //Add the remaining nodes to the aggregate of a neighbor from pass #2
+    std::vector<I> z(x, x + n_row);
+    #pragma omp parallel for schedule(static)
+    for(I i = 0; i < n_row; i++){
+        if(x[i] != -1){ continue; }
+
+        for(I jj = Ap[i]; jj < Ap[i+1]; jj++){
+            const I xj = x[Aj[jj]];
+            if(xj >= 0){
+                z[i] = xj;
+                break;
+            }
+        }
+    }
+
+    //Pass #4
+    //Only reached if A is not symmetric: make an aggregate out of any node
+    //that is still unaggregated and its unaggregated neighbors
+    I next_aggregate = agg[n_row];
+    for(I i = 0; i < n_row; i++){
+        if(z[i] == -2){
+            x[i] = -1;
+            continue;
+        }
+        if(z[i] == -1){
+            z[i] = next_aggregate;
+            y[next_aggregate] = i;
+            for(I jj = Ap[i]; jj < Ap[i+1]; jj++){
+                if(z[Aj[jj]] == -1){
+                    z[Aj[jj]] = next_aggregate;
+                }
+            }
+            next_aggregate++;
+        }
+        x[i] = z[i];
+    }
+
+    return next_aggregate; //number of aggregates
+}
+
+
 /*
  *  Given a set of near-nullspace candidates stored in the columns of B, and
  *  an aggregation operator stored in A using BSR format, this method computes
@@ -496,6 +645,329 @@ void fit_candidates_complex(const I n_row,
 { fit_candidates_common(n_row, n_col, K1, K2, Ap, Ai, Ax, B, R, tol, complex_dot<T>(), complex_norm<S,T>()); }
 
 
+/*
+ *  Compute the row pointer of the smoothed prolongator
+ *      P = T - diag(w) S T,
+ *  see jacobi_prolongation_pass2(...).
+ *
+ *  Block row i of S T is the sum of S_ij T_j over the block columns j of
+ *  block row i of S, and T has at most one block per block row, so that
+ *  the block columns of block row i of P are the aggregates of i and of
+ *  its neighbors in S.
+ *
+ *  Parameters
+ *      n_brow     - number of block rows of S, T, and P
+ *      n_bcol     - number of block columns of T and P (aggregates)
+ *      Sp[]       - BSR row pointer of S
+ *      Sj[]       - BSR index array of S
+ *      Tp[]       - BSR row pointer of T
+ *      Tj[]       - BSR index array of T
+ *      Pp[]       - BSR row pointer of P (n_brow + 1)
+ *
+ *  Returns:
+ *      Nothing, Pp is modified in place
+ *
+ *  Notes:
+ *      The block rows are counted in parallel.
+ *
+ */
+template<class I>
+void jacobi_prolongation_pass1(const I n_brow,
+                               const I n_bcol,
+                               const I Sp[], const int Sp_size,
+                               const I Sj[], const int Sj_size,
+                               const I Tp[], const int Tp_size,
+                               const I Tj[], const int Tj_size,
+                                     I Pp[], const int Pp_size)
+{
+    Pp[0] = 0;
+
+    #pragma omp parallel
+    {
+        // the last block row that reached each aggregate
+        std::vector<I> mark(n_bcol, -1);
+
+        #pragma omp for schedule(static)
+        for(I i = 0; i < n_brow; i++){
+            I length = 0;
+            if(Tp[i] < Tp[i+1]){
+                mark[Tj[Tp[i]]] = i;
+                length++;
+            }
+            for(I jj = Sp[i]; jj < Sp[i+1]; jj++){
+                const I j = Sj[jj];
+                if(Tp[j] == Tp[j+1]){
+                    continue;
+                }
+                const I a = Tj[Tp[j]];
+                if(mark[a] != i){
+                    mark[a] = i;
+                    length++;
+                }
+            }
+            Pp[i+1] = length;
+        }
+    }
+
+    for(I i = 0; i < n_brow; i++){
+        Pp[i+1] += Pp[i];
+    }
+}
+
+
+/*
+ *  Smooth a tentative prolongator T with one step of weighted Jacobi,
+ *      P = T - diag(w) S T,
+ *  directly from T, without forming diag(w) S or S T.
+ *
+ *  T is the tentative prolongator of fit_candidates(...), with at most one
+ *  block per block row, i.e., block row j of T is the block T_j in the
+ *  block column of the aggregate of j, or empty.  Block row i of P is then
+ *  T_i minus, for each block column j of block row i of S, diag(w_i) S_ij
+ *  T_j added to the block of the aggregate of j.  With w = omega/rho(K)
+ *  diag(S)^-1, this is jacobi_prolongation_smoother(...) in smooth.py
+ *  for weighting='diagonal', and with the inverse row sums of abs(S) for
+ *  weighting='local'.
+ *
+ *  Parameters
+ *      n_brow        - number of block rows of S, T, and P
+ *      n_bcol        - number of block columns of T and P (aggregates)
+ *      Sp[]          - BSR row pointer of S
+ *      Sj[]          - BSR index array of S
+ *      Sx[]          - BSR data array of S, RowsPerBlock x RowsPerBlock blocks
+ *      Tp[]          - BSR row pointer of T
+ *      Tj[]          - BSR index array of T
+ *      Tx[]          - BSR data array of T, RowsPerBlock x ColsPerBlock blocks
+ *      w[]           - weight of each row (n_brow * RowsPerBlock)
+ *      Pp[]          - BSR row pointer of P, from jacobi_prolongation_pass1
+ *      Pj[]          - BSR index array of P
+ *      Px[]          - BSR data array of P, RowsPerBlock x ColsPerBlock blocks
+ *      RowsPerBlock  - row blocksize of S, T, and P
+ *      ColsPerBlock  - column blocksize of T and P
+ *
+ *  Returns:
+ *      Nothing, Pj and Px are modified in place
+ *
+ *  Notes:
+ *      S is given as CSR with RowsPerBlock = 1.  The block columns of each
+ *      block row of P are sorted, and blocks that are zero are kept.  The
+ *      block rows are computed in parallel, and the result does not
+ *      depend on the number of threads.
+ *
+ */
+template<class I, class T, class F>
+void jacobi_prolongation_pass2(const I n_brow,
+                               const I n_bcol,
+                               const I Sp[], const int Sp_size,
+                               const I Sj[], const int Sj_size,
+                               const T Sx[], const int Sx_size,
+                               const I Tp[], const int Tp_size,
+                               const I Tj[], const int Tj_size,
+                               const T Tx[], const int Tx_size,
+                               const T  w[], const int  w_size,
+                               const I Pp[], const int Pp_size,
+                                     I Pj[], const int Pj_size,
+                                     T Px[], const int Px_size,
+                               const I RowsPerBlock,
+                               const I ColsPerBlock)
+{
+    const I RR = RowsPerBlock*RowsPerBlock;
+    const I RC = RowsPerBlock*ColsPerBlock;
+
+    #pragma omp parallel
+    {
+        // the position in Pj of each aggregate of the current block row
+        std::vector<I> position(n_bcol, -1);
+
+        #pragma omp for schedule(static)
+        for(I i = 0; i < n_brow; i++){
+            const I row_start = Pp[i];
+            const I row_end   = Pp[i+1];
+
+            // the aggregates of i and of its neighbors, in order
+            I length = row_start;
+            if(Tp[i] < Tp[i+1]){
+                position[Tj[Tp[i]]] = length;
+                Pj[length++] = Tj[Tp[i]];
+            }
+            for(I jj = Sp[i]; jj < Sp[i+1]; jj++){
+                const I j = Sj[jj];
+                if(Tp[j] == Tp[j+1]){
+                    continue;
+                }
+                const I a = Tj[Tp[j]];
+                if(position[a] == -1){
+                    position[a] = length;
+                    Pj[length++] = a;
+                }
+            }
+            std::sort(Pj + row_start, Pj + row_end);
+            for(I kk = row_start; kk < row_end; kk++){
+                position[Pj[kk]] = kk;
+            }
+
+            // P_i = T_i
+            std::fill(Px + row_start*RC, Px + row_end*RC, static_cast<T>(0.0));
+            if(Tp[i] < Tp[i+1]){
+                std::copy(Tx + Tp[i]*RC, Tx + (Tp[i] + 1)*RC,
+                          Px + position[Tj[Tp[i]]]*RC);
+            }
+
+            // P_i -= diag(w_i) S_ij T_j
+            for(I jj = Sp[i]; jj < Sp[i+1]; jj++){
+                const I j = Sj[jj];
+                if(Tp[j] == Tp[j+1]){
+                    continue;
+                }
+                const T *S_ij = Sx + jj*RR;
+                const T *T_j  = Tx + Tp[j]*RC;
+                T *P_ia = Px + position[Tj[Tp[j]]]*RC;
+
+                for(I r = 0; r < RowsPerBlock; r++){
+                    const T w_r = w[i*RowsPerBlock + r];
+                    for(I k = 0; k < ColsPerBlock; k++){
+                        T sum = 0.0;
+                        for(I c = 0; c < RowsPerBlock; c++){
+                            sum += S_ij[r*RowsPerBlock + c]*T_j[c*ColsPerBlock + k];
+                        }
+                        P_ia[r*ColsPerBlock + k] -= w_r*sum;
+                    }
+                }
+            }
+
+            // revert the positions to all -1
+            for(I kk = row_start; kk < row_end; kk++){
+                position[Pj[kk]] = -1;
+            }
+        }
+    }
+}
+
+
+/*
+ *  Smooth a tentative prolongator T as in jacobi_prolongation_pass2(...),
+ *  in a given sparsity pattern of P, e.g., the pattern of the prolongator
+ *  of a previous setup with the same aggregates.
+ *
+ *  Parameters
+ *      n_brow        - number of block rows of S, T, and P
+ *      n_bcol        - number of block columns of T and P (aggregates)
+ *      Sp[]          - BSR row pointer of S
+ *      Sj[]          - BSR index array of S
+ *      Sx[]          - BSR data array of S, RowsPerBlock x RowsPerBlock blocks
+ *      Tp[]          - BSR row pointer of T
+ *      Tj[]          - BSR index array of T
+ *      Tx[]          - BSR data array of T, RowsPerBlock x ColsPerBlock blocks
+ *      w[]           - weight of each row (n_brow * RowsPerBlock)
+ *      Pp[]          - BSR row pointer of the pattern of P
+ *      Pj[]          - BSR index array of the pattern of P
+ *      Px[]          - BSR data array of P, RowsPerBlock x ColsPerBlock blocks
+ *      RowsPerBlock  - row blocksize of S, T, and P
+ *      ColsPerBlock  - column blocksize of T and P
+ *
+ *  Returns:
+ *      The number of block rows of P with an aggregate outside of the
+ *      pattern.  If it is 0, Px is modified in place to the blocks of P
+ *      in the pattern, which are zero for the aggregates that no block
+ *      contributes to.  Otherwise, Px is undefined, and P is to be
+ *      computed with jacobi_prolongation_pass1(...) and _pass2(...).
+ *
+ *  Notes:
+ *      This skips jacobi_prolongation_pass1(...) and the sort of the
+ *      block columns of each block row of jacobi_prolongation_pass2(...),
+ *      and computes each block in the same order as there.
+ *
+ */
+template<class I, class T, class F>
+I jacobi_prolongation_values(const I n_brow,
+                             const I n_bcol,
+                             const I Sp[], const int Sp_size,
+                             const I Sj[], const int Sj_size,
+                             const T Sx[], const int Sx_size,
+                             const I Tp[], const int Tp_size,
+                             const I Tj[], const int Tj_size,
+                             const T Tx[], const int Tx_size,
+                             const T  w[], const int  w_size,
+                             const I Pp[], const int Pp_size,
+                             const I Pj[], const int Pj_size,
+                                   T Px[], const int Px_size,
+                             const I RowsPerBlock,
+                             const I ColsPerBlock)
+{
+    const I RR = RowsPerBlock*RowsPerBlock;
+    const I RC = RowsPerBlock*ColsPerBlock;
+
+    I misses = 0;
+
+    #pragma omp parallel
+    {
+        // the position in Pj of each aggregate of the current block row
+        std::vector<I> position(n_bcol, -1);
+
+        #pragma omp for schedule(static) reduction(+:misses)
+        for(I i = 0; i < n_brow; i++){
+            const I row_start = Pp[i];
+            const I row_end   = Pp[i+1];
+
+            for(I kk = row_start; kk < row_end; kk++){
+                position[Pj[kk]] = kk;
+            }
+
+            // P_i = T_i
+            std::fill(Px + row_start*RC, Px + row_end*RC, static_cast<T>(0.0));
+            bool fits = true;
+            if(Tp[i] < Tp[i+1]){
+                const I kk = position[Tj[Tp[i]]];
+                if(kk == -1){
+                    fits = false;
+                }
+                else{
+                    std::copy(Tx + Tp[i]*RC, Tx + (Tp[i] + 1)*RC,
+                              Px + kk*RC);
+                }
+            }
+
+            // P_i -= diag(w_i) S_ij T_j
+            for(I jj = Sp[i]; jj < Sp[i+1] && fits; jj++){
+                const I j = Sj[jj];
+                if(Tp[j] == Tp[j+1]){
+                    continue;
+                }
+                const I kk = position[Tj[Tp[j]]];
+                if(kk == -1){
+                    fits = false;
+                    break;
+                }
+                const T *S_ij = Sx + jj*RR;
+                const T *T_j  = Tx + Tp[j]*RC;
+                T *P_ia = Px + kk*RC;
+
+                for(I r = 0; r < RowsPerBlock; r++){
+                    const T w_r = w[i*RowsPerBlock + r];
+                    for(I k = 0; k < ColsPerBlock; k++){
+                        T sum = 0.0;
+                        for(I c = 0; c < RowsPerBlock; c++){
+                            sum += S_ij[r*RowsPerBlock + c]*T_j[c*ColsPerBlock + k];
+                        }
+                        P_ia[r*ColsPerBlock + k] -= w_r*sum;
+                    }
+                }
+            }
+            if(!fits){
+                misses++;
+            }
+
+            // revert the positions to all -1
+            for(I kk = row_start; kk < row_end; kk++){
+                position[Pj[kk]] = -1;
+            }
+        }
+    }
+
+    return misses;
+}
+
+
 /*
  * Helper routine for satisfy_constraints routine called
  *     by energy_prolongation_smoother(...) in smooth.py
@@ -731,6 +1203,54 @@ void calc_BtB(const I NullDim,
     delete[] work;
 }
 
+/*
+ * Helper for incomplete_mat_mult_bsr(...), which accumulates
+ * S(i,:) += A(i,:)*B over the block rows i of A in parallel.
+ *
+ * The blocks of S are found with the masked_spgemm(...) engine in
+ * sparse.h, so each block row of S is only written by one thread.  If
+ * BROW and BCOL are nonzero, they are the block size of A, known at
+ * compile time, and the block multiply is unrolled.  Otherwise the block
+ * size is given by brow_A and bcol_A.
+ *
+ * The blocks of A, B and S are row major, and each block of S
+ * accumulates the same products in the same order as gemm(...).
+ */
+template<class I, class T, int BROW, int BCOL>
+void incomplete_mat_mult_bsr_rows(const I Ap[], const I Aj[], const T Ax[],
+                                  const I Bp[], const I Bj[], const T Bx[],
+                                  const I Sp[], const I Sj[],       T Sx[],
+                                  const I n_brow,
+                                  const I n_bcol,
+                                  const I brow_A,
+                                  const I bcol_A,
+                                  const I bcol_B)
+{
+    const I m_rows = (BROW > 0) ? BROW : brow_A;
+    const I m_cols = (BCOL > 0) ? BCOL : bcol_A;
+
+    const I A_blocksize = m_rows*m_cols;
+    const I B_blocksize = m_cols*bcol_B;
+    const I S_blocksize = m_rows*bcol_B;
+
+    // Accumulate S(i,k) += A(i,j)*B(j,k) with a block multiply
+    masked_spgemm(Ap, Aj, Bp, Bj, Sp, Sj, n_brow, n_bcol,
+                  [=](const I s, const I a, const I b){
+                      const T * Ablock = &(Ax[a*A_blocksize]);
+                      const T * Bblock = &(Bx[b*B_blocksize]);
+                      T * Sblock = &(Sx[s*S_blocksize]);
+                      for(I m = 0; m < m_rows; m++){
+                          for(I n = 0; n < m_cols; n++){
+                              const T Amn = Ablock[m*m_cols + n];
+                              const T * Brow = Bblock + n*bcol_B;
+                              T * Srow = Sblock + m*bcol_B;
+                              for(I q = 0; q < bcol_B; q++){
+                                  Srow[q] += Amn*Brow[q]; }
+                          }
+                      }
+                  });
+}
+
 /*
  * Calculate A*B = S, but only at the pre-existing sparsity
  * pattern of S, i.e. do an exact, but incomplete mat-mat mult.
@@ -781,7 +1301,7 @@ void calc_BtB(const I NullDim,
  * Notes
  * -----
  *
- * Algorithm is SMMP
+ * Algorithm is SMMP, with the masked_spgemm(...) engine in sparse.h
  *
  * Principle calling routine is energy_prolongation_smoother(...) in
  * smooth.py.  Here it is used to calculate the descent direction
@@ -790,6 +1310,10 @@ void calc_BtB(const I NullDim,
  * Is generally faster than the commented out incomplete_BSRmatmat(...)
  * routine below, except when S has far few nonzeros than A or B.
  *
+ * The block rows of S are computed in parallel.  For square blocks in
+ * A of size 1, 2, 3 or 6, a version with the block multiply unrolled
+ * at compile time is used.
+ *
  */
 template<class I, class T, class F>
 void incomplete_mat_mult_bsr(const I Ap[], const int Ap_size,
@@ -807,63 +1331,31 @@ void incomplete_mat_mult_bsr(const I Ap[], const int Ap_size,
                              const I bcol_A,
                              const I bcol_B )
 {
-
-    std::vector<T*> S(n_bcol);
-    std::fill(S.begin(), S.end(), (T *) NULL);
-
-    I A_blocksize = brow_A*bcol_A;
-    I B_blocksize = bcol_A*bcol_B;
-    I S_blocksize = brow_A*bcol_B;
-    I one_by_one_blocksize = 0;
-    if ((A_blocksize == B_blocksize) && (B_blocksize == S_blocksize) && (A_blocksize == 1)){
-        one_by_one_blocksize = 1; }
-
-    // Loop over rows of A
-    for(I i = 0; i < n_brow; i++){
-
-        // Initialize S to be NULL, except for the nonzero entries in S[i,:],
-        // where S will point to the correct location in Sx
-        I jj_start = Sp[i];
-        I jj_end   = Sp[i+1];
-        for(I jj = jj_start; jj < jj_end; jj++){
-            S[ Sj[jj] ] = &(Sx[jj*S_blocksize]); }
-
-        // Loop over columns in row i of A
-        jj_start = Ap[i];
-        jj_end   = Ap[i+1];
-        for(I jj = jj_start; jj < jj_end; jj++){
-            I j = Aj[jj];
-
-            // Loop over columns in row j of B
-            I kk_start = Bp[j];
-            I kk_end   = Bp[j+1];
-            for(I kk = kk_start; kk < kk_end; kk++){
-                I k = Bj[kk];
-                T * Sk = S[k];
-
-                // If this is an allowed entry in S, then accumulate to it with a block multiply
-                if (Sk != NULL){
-                    if(one_by_one_blocksize){
-                        // Just do a scalar multiply for the case of 1x1 blocks
-                        *(Sk) += Ax[jj]*Bx[kk];
-                    }
-                    else{
-                        gemm(&(Ax[jj*A_blocksize]), brow_A, bcol_A, 'F',
-                             &(Bx[kk*B_blocksize]), bcol_A, bcol_B, 'T',
-                             Sk,                    brow_A, bcol_B, 'F',
-                             'F');
-                    }
-                }
-            }
+    // Dispatch on the block size of A, so that the block multiply is
+    // unrolled for the common (square) block sizes
+    if(brow_A == bcol_A){
+        switch(brow_A){
+            case 1:
+                incomplete_mat_mult_bsr_rows<I, T, 1, 1>(Ap, Aj, Ax, Bp, Bj, Bx, Sp, Sj, Sx,
+                                                         n_brow, n_bcol, brow_A, bcol_A, bcol_B);
+                return;
+            case 2:
+                incomplete_mat_mult_bsr_rows<I, T, 2, 2>(Ap, Aj, Ax, Bp, Bj, Bx, Sp, Sj, Sx,
+                                                         n_brow, n_bcol, brow_A, bcol_A, bcol_B);
+                return;
+            case 3:
+                incomplete_mat_mult_bsr_rows<I, T, 3, 3>(Ap, Aj, Ax, Bp, Bj, Bx, Sp, Sj, Sx,
+                                                         n_brow, n_bcol, brow_A, bcol_A, bcol_B);
+                return;
+            case 6:
+                incomplete_mat_mult_bsr_rows<I, T, 6, 6>(Ap, Aj, Ax, Bp, Bj, Bx, Sp, Sj, Sx,
+                                                         n_brow, n_bcol, brow_A, bcol_A, bcol_B);
+                return;
         }
-
-        // Revert S back to it's state of all NULL
-        jj_start = Sp[i];
-        jj_end   = Sp[i+1];
-        for(I jj = jj_start; jj < jj_end; jj++){
-            S[ Sj[jj] ] = NULL; }
-
     }
+
+    incomplete_mat_mult_bsr_rows<I, T, 0, 0>(Ap, Aj, Ax, Bp, Bj, Bx, Sp, Sj, Sx,
+                                             n_brow, n_bcol, brow_A, bcol_A, bcol_B);
 }
 
 /* Swap x[i] and x[j], and
@@ -4,6 +4,9 @@
 #include <pybind11/numpy.h>
 #include <pybind11/complex.h>
 
+#include "bind_arrays.h"
+#include "bind_threads.h"
+#include "bind_timers.h"
 #include "smoothed_aggregation.h"
 
 namespace py = pybind11;
@@ -12,12 +15,12 @@ template<class I, class T, class F>
 void _symmetric_strength_of_connection(
             const I n_row,
             const F theta,
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
-      py::array_t<T> & Ax,
-      py::array_t<I> & Sp,
-      py::array_t<I> & Sj,
-      py::array_t<T> & Sx
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+     output_array<I> & Sp,
+     output_array<I> & Sj,
+     output_array<T> & Sx
                                        )
 {
     auto py_Ap = Ap.unchecked();
@@ -32,26 +35,36 @@ void _symmetric_strength_of_connection(
     I *_Sp = py_Sp.mutable_data();
     I *_Sj = py_Sj.mutable_data();
     T *_Sx = py_Sx.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int Sp_size = array_size(Sp.shape(0));
+    int Sj_size = array_size(Sj.shape(0));
+    int Sx_size = array_size(Sx.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("symmetric_strength_of_connection");
 
     return symmetric_strength_of_connection<I, T, F>(
                     n_row,
                     theta,
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
-                      _Ax, Ax.shape(0),
-                      _Sp, Sp.shape(0),
-                      _Sj, Sj.shape(0),
-                      _Sx, Sx.shape(0)
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                      _Sp, Sp_size,
+                      _Sj, Sj_size,
+                      _Sx, Sx_size
                                                      );
 }
 
 template <class I>
 I _standard_aggregation(
             const I n_row,
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
-       py::array_t<I> & x,
-       py::array_t<I> & y
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      output_array<I> & x,
+      output_array<I> & y
                         )
 {
     auto py_Ap = Ap.unchecked();
@@ -62,23 +75,31 @@ I _standard_aggregation(
     const I *_Aj = py_Aj.data();
     I *_x = py_x.mutable_data();
     I *_y = py_y.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int x_size = array_size(x.shape(0));
+    int y_size = array_size(y.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("standard_aggregation");
 
     return standard_aggregation <I>(
                     n_row,
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
-                       _x, x.shape(0),
-                       _y, y.shape(0)
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                       _x, x_size,
+                       _y, y_size
                                     );
 }
 
 template <class I>
 I _naive_aggregation(
             const I n_row,
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
-       py::array_t<I> & x,
-       py::array_t<I> & y
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      output_array<I> & x,
+      output_array<I> & y
                      )
 {
     auto py_Ap = Ap.unchecked();
@@ -89,27 +110,75 @@ I _naive_aggregation(
     const I *_Aj = py_Aj.data();
     I *_x = py_x.mutable_data();
     I *_y = py_y.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int x_size = array_size(x.shape(0));
+    int y_size = array_size(y.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("naive_aggregation");
 
     return naive_aggregation <I>(
                     n_row,
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
-                       _x, x.shape(0),
-                       _y, y.shape(0)
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                       _x, x_size,
+                       _y, y_size
                                  );
 }
 
+template <class I, class R>
+I _parallel_aggregation(
+            const I n_row,
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      output_array<I> & x,
+      output_array<I> & y,
+       input_array<R> & r
+                        )
+{
+    auto py_Ap = Ap.unchecked();
+    auto py_Aj = Aj.unchecked();
+    auto py_x = x.mutable_unchecked();
+    auto py_y = y.mutable_unchecked();
+    auto py_r = r.unchecked();
+    const I *_Ap = py_Ap.data();
+    const I *_Aj = py_Aj.data();
+    I *_x = py_x.mutable_data();
+    I *_y = py_y.mutable_data();
+    const R *_r = py_r.data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int x_size = array_size(x.shape(0));
+    int y_size = array_size(y.shape(0));
+    int r_size = array_size(r.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("parallel_aggregation");
+
+    return parallel_aggregation <I, R>(
+                    n_row,
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                       _x, x_size,
+                       _y, y_size,
+                       _r, r_size
+                                       );
+}
+
 template <class I, class T>
 void _fit_candidates_real(
             const I n_row,
             const I n_col,
                const I K1,
                const I K2,
-      py::array_t<I> & Ap,
-      py::array_t<I> & Ai,
-      py::array_t<T> & Ax,
-       py::array_t<T> & B,
-       py::array_t<T> & R,
+      input_array<I> & Ap,
+      input_array<I> & Ai,
+     output_array<T> & Ax,
+       input_array<T> & B,
+      output_array<T> & R,
               const T tol
                           )
 {
@@ -123,17 +192,26 @@ void _fit_candidates_real(
     T *_Ax = py_Ax.mutable_data();
     const T *_B = py_B.data();
     T *_R = py_R.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Ai_size = array_size(Ai.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int B_size = array_size(B.shape(0));
+    int R_size = array_size(R.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("fit_candidates");
 
     return fit_candidates_real <I, T>(
                     n_row,
                     n_col,
                        K1,
                        K2,
-                      _Ap, Ap.shape(0),
-                      _Ai, Ai.shape(0),
-                      _Ax, Ax.shape(0),
-                       _B, B.shape(0),
-                       _R, R.shape(0),
+                      _Ap, Ap_size,
+                      _Ai, Ai_size,
+                      _Ax, Ax_size,
+                       _B, B_size,
+                       _R, R_size,
                       tol
                                       );
 }
@@ -144,11 +222,11 @@ void _fit_candidates_complex(
             const I n_col,
                const I K1,
                const I K2,
-      py::array_t<I> & Ap,
-      py::array_t<I> & Ai,
-      py::array_t<T> & Ax,
-       py::array_t<T> & B,
-       py::array_t<T> & R,
+      input_array<I> & Ap,
+      input_array<I> & Ai,
+     output_array<T> & Ax,
+       input_array<T> & B,
+      output_array<T> & R,
               const S tol
                              )
 {
@@ -162,33 +240,226 @@ void _fit_candidates_complex(
     T *_Ax = py_Ax.mutable_data();
     const T *_B = py_B.data();
     T *_R = py_R.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Ai_size = array_size(Ai.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int B_size = array_size(B.shape(0));
+    int R_size = array_size(R.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("fit_candidates");
 
     return fit_candidates_complex <I, S, T>(
                     n_row,
                     n_col,
                        K1,
                        K2,
-                      _Ap, Ap.shape(0),
-                      _Ai, Ai.shape(0),
-                      _Ax, Ax.shape(0),
-                       _B, B.shape(0),
-                       _R, R.shape(0),
+                      _Ap, Ap_size,
+                      _Ai, Ai_size,
+                      _Ax, Ax_size,
+                       _B, B_size,
+                       _R, R_size,
                       tol
                                             );
 }
 
+template<class I>
+void _jacobi_prolongation_pass1(
+           const I n_brow,
+           const I n_bcol,
+      input_array<I> & Sp,
+      input_array<I> & Sj,
+      input_array<I> & Tp,
+      input_array<I> & Tj,
+     output_array<I> & Pp
+                                )
+{
+    auto py_Sp = Sp.unchecked();
+    auto py_Sj = Sj.unchecked();
+    auto py_Tp = Tp.unchecked();
+    auto py_Tj = Tj.unchecked();
+    auto py_Pp = Pp.mutable_unchecked();
+    const I *_Sp = py_Sp.data();
+    const I *_Sj = py_Sj.data();
+    const I *_Tp = py_Tp.data();
+    const I *_Tj = py_Tj.data();
+    I *_Pp = py_Pp.mutable_data();
+    int Sp_size = array_size(Sp.shape(0));
+    int Sj_size = array_size(Sj.shape(0));
+    int Tp_size = array_size(Tp.shape(0));
+    int Tj_size = array_size(Tj.shape(0));
+    int Pp_size = array_size(Pp.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("jacobi_prolongation_pass1");
+
+    return jacobi_prolongation_pass1<I>(
+                   n_brow,
+                   n_bcol,
+                      _Sp, Sp_size,
+                      _Sj, Sj_size,
+                      _Tp, Tp_size,
+                      _Tj, Tj_size,
+                      _Pp, Pp_size
+                                        );
+}
+
+template<class I, class T, class F>
+void _jacobi_prolongation_pass2(
+           const I n_brow,
+           const I n_bcol,
+      input_array<I> & Sp,
+      input_array<I> & Sj,
+      input_array<T> & Sx,
+      input_array<I> & Tp,
+      input_array<I> & Tj,
+      input_array<T> & Tx,
+       input_array<T> & w,
+      input_array<I> & Pp,
+     output_array<I> & Pj,
+     output_array<T> & Px,
+     const I RowsPerBlock,
+     const I ColsPerBlock
+                                )
+{
+    auto py_Sp = Sp.unchecked();
+    auto py_Sj = Sj.unchecked();
+    auto py_Sx = Sx.unchecked();
+    auto py_Tp = Tp.unchecked();
+    auto py_Tj = Tj.unchecked();
+    auto py_Tx = Tx.unchecked();
+    auto py_w = w.unchecked();
+    auto py_Pp = Pp.unchecked();
+    auto py_Pj = Pj.mutable_unchecked();
+    auto py_Px = Px.mutable_unchecked();
+    const I *_Sp = py_Sp.data();
+    const I *_Sj = py_Sj.data();
+    const T *_Sx = py_Sx.data();
+    const I *_Tp = py_Tp.data();
+    const I *_Tj = py_Tj.data();
+    const T *_Tx = py_Tx.data();
+    const T *_w = py_w.data();
+    const I *_Pp = py_Pp.data();
+    I *_Pj = py_Pj.mutable_data();
+    T *_Px = py_Px.mutable_data();
+    int Sp_size = array_size(Sp.shape(0));
+    int Sj_size = array_size(Sj.shape(0));
+    int Sx_size = array_size(Sx.shape(0));
+    int Tp_size = array_size(Tp.shape(0));
+    int Tj_size = array_size(Tj.shape(0));
+    int Tx_size = array_size(Tx.shape(0));
+    int w_size = array_size(w.shape(0));
+    int Pp_size = array_size(Pp.shape(0));
+    int Pj_size = array_size(Pj.shape(0));
+    int Px_size = array_size(Px.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("jacobi_prolongation_pass2");
+
+    return jacobi_prolongation_pass2<I, T, F>(
+                   n_brow,
+                   n_bcol,
+                      _Sp, Sp_size,
+                      _Sj, Sj_size,
+                      _Sx, Sx_size,
+                      _Tp, Tp_size,
+                      _Tj, Tj_size,
+                      _Tx, Tx_size,
+                       _w, w_size,
+                      _Pp, Pp_size,
+                      _Pj, Pj_size,
+                      _Px, Px_size,
+             RowsPerBlock,
+             ColsPerBlock
+                                              );
+}
+
+template<class I, class T, class F>
+I _jacobi_prolongation_values(
+           const I n_brow,
+           const I n_bcol,
+      input_array<I> & Sp,
+      input_array<I> & Sj,
+      input_array<T> & Sx,
+      input_array<I> & Tp,
+      input_array<I> & Tj,
+      input_array<T> & Tx,
+       input_array<T> & w,
+      input_array<I> & Pp,
+      input_array<I> & Pj,
+     output_array<T> & Px,
+     const I RowsPerBlock,
+     const I ColsPerBlock
+                              )
+{
+    auto py_Sp = Sp.unchecked();
+    auto py_Sj = Sj.unchecked();
+    auto py_Sx = Sx.unchecked();
+    auto py_Tp = Tp.unchecked();
+    auto py_Tj = Tj.unchecked();
+    auto py_Tx = Tx.unchecked();
+    auto py_w = w.unchecked();
+    auto py_Pp = Pp.unchecked();
+    auto py_Pj = Pj.unchecked();
+    auto py_Px = Px.mutable_unchecked();
+    const I *_Sp = py_Sp.data();
+    const I *_Sj = py_Sj.data();
+    const T *_Sx = py_Sx.data();
+    const I *_Tp = py_Tp.data();
+    const I *_Tj = py_Tj.data();
+    const T *_Tx = py_Tx.data();
+    const T *_w = py_w.data();
+    const I *_Pp = py_Pp.data();
+    const I *_Pj = py_Pj.data();
+    T *_Px = py_Px.mutable_data();
+    int Sp_size = array_size(Sp.shape(0));
+    int Sj_size = array_size(Sj.shape(0));
+    int Sx_size = array_size(Sx.shape(0));
+    int Tp_size = array_size(Tp.shape(0));
+    int Tj_size = array_size(Tj.shape(0));
+    int Tx_size = array_size(Tx.shape(0));
+    int w_size = array_size(w.shape(0));
+    int Pp_size = array_size(Pp.shape(0));
+    int Pj_size = array_size(Pj.shape(0));
+    int Px_size = array_size(Px.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("jacobi_prolongation_values");
+
+    return jacobi_prolongation_values<I, T, F>(
+                   n_brow,
+                   n_bcol,
+                      _Sp, Sp_size,
+                      _Sj, Sj_size,
+                      _Sx, Sx_size,
+                      _Tp, Tp_size,
+                      _Tj, Tj_size,
+                      _Tx, Tx_size,
+                       _w, w_size,
+                      _Pp, Pp_size,
+                      _Pj, Pj_size,
+                      _Px, Px_size,
+             RowsPerBlock,
+             ColsPerBlock
+                                               );
+}
+
 template<class I, class T, class F>
 void _satisfy_constraints_helper(
      const I RowsPerBlock,
      const I ColsPerBlock,
    const I num_block_rows,
           const I NullDim,
-       py::array_t<T> & x,
-       py::array_t<T> & y,
-       py::array_t<T> & z,
-      py::array_t<I> & Sp,
-      py::array_t<I> & Sj,
-      py::array_t<T> & Sx
+       input_array<T> & x,
+       input_array<T> & y,
+       input_array<T> & z,
+      input_array<I> & Sp,
+      input_array<I> & Sj,
+     output_array<T> & Sx
                                  )
 {
     auto py_x = x.unchecked();
@@ -203,18 +474,28 @@ void _satisfy_constraints_helper(
     const I *_Sp = py_Sp.data();
     const I *_Sj = py_Sj.data();
     T *_Sx = py_Sx.mutable_data();
+    int x_size = array_size(x.shape(0));
+    int y_size = array_size(y.shape(0));
+    int z_size = array_size(z.shape(0));
+    int Sp_size = array_size(Sp.shape(0));
+    int Sj_size = array_size(Sj.shape(0));
+    int Sx_size = array_size(Sx.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("satisfy_constraints_helper");
 
     return satisfy_constraints_helper<I, T, F>(
              RowsPerBlock,
              ColsPerBlock,
            num_block_rows,
                   NullDim,
-                       _x, x.shape(0),
-                       _y, y.shape(0),
-                       _z, z.shape(0),
-                      _Sp, Sp.shape(0),
-                      _Sj, Sj.shape(0),
-                      _Sx, Sx.shape(0)
+                       _x, x_size,
+                       _y, y_size,
+                       _z, z_size,
+                      _Sp, Sp_size,
+                      _Sj, Sj_size,
+                      _Sx, Sx_size
                                                );
 }
 
@@ -223,11 +504,11 @@ void _calc_BtB(
           const I NullDim,
            const I Nnodes,
      const I ColsPerBlock,
-       py::array_t<T> & b,
+       input_array<T> & b,
           const I BsqCols,
-       py::array_t<T> & x,
-      py::array_t<I> & Sp,
-      py::array_t<I> & Sj
+      output_array<T> & x,
+      input_array<I> & Sp,
+      input_array<I> & Sj
                )
 {
     auto py_b = b.unchecked();
@@ -238,30 +519,38 @@ void _calc_BtB(
     T *_x = py_x.mutable_data();
     const I *_Sp = py_Sp.data();
     const I *_Sj = py_Sj.data();
+    int b_size = array_size(b.shape(0));
+    int x_size = array_size(x.shape(0));
+    int Sp_size = array_size(Sp.shape(0));
+    int Sj_size = array_size(Sj.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("calc_BtB");
 
     return calc_BtB<I, T, F>(
                   NullDim,
                    Nnodes,
              ColsPerBlock,
-                       _b, b.shape(0),
+                       _b, b_size,
                   BsqCols,
-                       _x, x.shape(0),
-                      _Sp, Sp.shape(0),
-                      _Sj, Sj.shape(0)
+                       _x, x_size,
+                      _Sp, Sp_size,
+                      _Sj, Sj_size
                              );
 }
 
 template<class I, class T, class F>
 void _incomplete_mat_mult_bsr(
-      py::array_t<I> & Ap,
-      py::array_t<I> & Aj,
-      py::array_t<T> & Ax,
-      py::array_t<I> & Bp,
-      py::array_t<I> & Bj,
-      py::array_t<T> & Bx,
-      py::array_t<I> & Sp,
-      py::array_t<I> & Sj,
-      py::array_t<T> & Sx,
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      input_array<I> & Bp,
+      input_array<I> & Bj,
+      input_array<T> & Bx,
+      input_array<I> & Sp,
+      input_array<I> & Sj,
+     output_array<T> & Sx,
            const I n_brow,
            const I n_bcol,
            const I brow_A,
@@ -287,17 +576,30 @@ void _incomplete_mat_mult_bsr(
     const I *_Sp = py_Sp.data();
     const I *_Sj = py_Sj.data();
     T *_Sx = py_Sx.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int Bp_size = array_size(Bp.shape(0));
+    int Bj_size = array_size(Bj.shape(0));
+    int Bx_size = array_size(Bx.shape(0));
+    int Sp_size = array_size(Sp.shape(0));
+    int Sj_size = array_size(Sj.shape(0));
+    int Sx_size = array_size(Sx.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("incomplete_mat_mult_bsr");
 
     return incomplete_mat_mult_bsr<I, T, F>(
-                      _Ap, Ap.shape(0),
-                      _Aj, Aj.shape(0),
-                      _Ax, Ax.shape(0),
-                      _Bp, Bp.shape(0),
-                      _Bj, Bj.shape(0),
-                      _Bx, Bx.shape(0),
-                      _Sp, Sp.shape(0),
-                      _Sj, Sj.shape(0),
-                      _Sx, Sx.shape(0),
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                      _Bp, Bp_size,
+                      _Bj, Bj_size,
+                      _Bx, Bx_size,
+                      _Sp, Sp_size,
+                      _Sj, Sj_size,
+                      _Sx, Sx_size,
                    n_brow,
                    n_bcol,
                    brow_A,
@@ -310,9 +612,9 @@ template<class I, class T, class F>
 void _truncate_rows_csr(
             const I n_row,
                 const I k,
-      py::array_t<I> & Sp,
-      py::array_t<I> & Sj,
-      py::array_t<T> & Sx
+      input_array<I> & Sp,
+     output_array<I> & Sj,
+     output_array<T> & Sx
                         )
 {
     auto py_Sp = Sp.unchecked();
@@ -321,13 +623,20 @@ void _truncate_rows_csr(
     const I *_Sp = py_Sp.data();
     I *_Sj = py_Sj.mutable_data();
     T *_Sx = py_Sx.mutable_data();
+    int Sp_size = array_size(Sp.shape(0));
+    int Sj_size = array_size(Sj.shape(0));
+    int Sx_size = array_size(Sx.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("truncate_rows_csr");
 
     return truncate_rows_csr<I, T, F>(
                     n_row,
                         k,
-                      _Sp, Sp.shape(0),
-                      _Sj, Sj.shape(0),
-                      _Sx, Sx.shape(0)
+                      _Sp, Sp_size,
+                      _Sj, Sj_size,
+                      _Sx, Sx_size
                                       );
 }
 
@@ -340,8 +649,12 @@ PYBIND11_MODULE(smoothed_aggregation, m) {
     symmetric_strength_of_connection
     standard_aggregation
     naive_aggregation
+    parallel_aggregation
     fit_candidates_real
     fit_candidates_complex
+    jacobi_prolongation_pass1
+    jacobi_prolongation_pass2
+    jacobi_prolongation_values
     satisfy_constraints_helper
     calc_BtB
     incomplete_mat_mult_bsr
@@ -351,14 +664,29 @@ PYBIND11_MODULE(smoothed_aggregation, m) {
     py::options options;
     options.disable_function_signatures();
 
+    share_num_threads();
+
+    m.def("_kernel_timers", &swap_kernel_timers, py::arg("enable"),
+R"pbdoc(
+Return and reset the kernel timers of the calling thread, and enable or
+disable them for subsequent calls, see bind_timers.h.)pbdoc");
+
     m.def("symmetric_strength_of_connection", &_symmetric_strength_of_connection<int, float, float>,
-        py::arg("n_row"), py::arg("theta"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
+        py::arg("n_row"), py::arg("theta"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
     m.def("symmetric_strength_of_connection", &_symmetric_strength_of_connection<int, double, double>,
-        py::arg("n_row"), py::arg("theta"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
+        py::arg("n_row"), py::arg("theta"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
     m.def("symmetric_strength_of_connection", &_symmetric_strength_of_connection<int, std::complex<float>, float>,
-        py::arg("n_row"), py::arg("theta"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
+        py::arg("n_row"), py::arg("theta"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
     m.def("symmetric_strength_of_connection", &_symmetric_strength_of_connection<int, std::complex<double>, double>,
-        py::arg("n_row"), py::arg("theta"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert(),
+        py::arg("n_row"), py::arg("theta"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
+    m.def("symmetric_strength_of_connection", &_symmetric_strength_of_connection<int64_t, float, float>,
+        py::arg("n_row"), py::arg("theta"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
+    m.def("symmetric_strength_of_connection", &_symmetric_strength_of_connection<int64_t, double, double>,
+        py::arg("n_row"), py::arg("theta"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
+    m.def("symmetric_strength_of_connection", &_symmetric_strength_of_connection<int64_t, std::complex<float>, float>,
+        py::arg("n_row"), py::arg("theta"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
+    m.def("symmetric_strength_of_connection", &_symmetric_strength_of_connection<int64_t, std::complex<double>, double>,
+        py::arg("n_row"), py::arg("theta"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert(),
 R"pbdoc(
 Compute a strength of connection matrix using the standard symmetric
  Smoothed Aggregation heuristic.  Both the input and output matrices
@@ -390,7 +718,9 @@ Compute a strength of connection matrix using the standard symmetric
      storage for S as is used by A.)pbdoc");
 
     m.def("standard_aggregation", &_standard_aggregation<int>,
-        py::arg("n_row"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("x").noconvert(), py::arg("y").noconvert(),
+        py::arg("n_row"), py::arg("Ap"), py::arg("Aj"), py::arg("x").noconvert(), py::arg("y").noconvert());
+    m.def("standard_aggregation", &_standard_aggregation<int64_t>,
+        py::arg("n_row"), py::arg("Ap"), py::arg("Aj"), py::arg("x").noconvert(), py::arg("y").noconvert(),
 R"pbdoc(
 Compute aggregates for a matrix A stored in CSR format
 
@@ -410,7 +740,9 @@ Notes:
    Unaggregated nodes are marked with a -1)pbdoc");
 
     m.def("naive_aggregation", &_naive_aggregation<int>,
-        py::arg("n_row"), py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("x").noconvert(), py::arg("y").noconvert(),
+        py::arg("n_row"), py::arg("Ap"), py::arg("Aj"), py::arg("x").noconvert(), py::arg("y").noconvert());
+    m.def("naive_aggregation", &_naive_aggregation<int64_t>,
+        py::arg("n_row"), py::arg("Ap"), py::arg("Aj"), py::arg("x").noconvert(), py::arg("y").noconvert(),
 R"pbdoc(
 Compute aggregates for a matrix A stored in CSR format
 
@@ -430,39 +762,227 @@ If it has been aggregated, skip over.  Otherwise, put dof
 and any unaggregated neighbors in an aggregate.  Results
 in possibly much higher complexities.)pbdoc");
 
+    m.def("parallel_aggregation", &_parallel_aggregation<int, double>,
+        py::arg("n_row"), py::arg("Ap"), py::arg("Aj"), py::arg("x").noconvert(), py::arg("y").noconvert(), py::arg("r"));
+    m.def("parallel_aggregation", &_parallel_aggregation<int64_t, double>,
+        py::arg("n_row"), py::arg("Ap"), py::arg("Aj"), py::arg("x").noconvert(), py::arg("y").noconvert(), py::arg("r"),
+R"pbdoc(
+Compute aggregates for a matrix A stored in CSR format in parallel
+
+Parameters:
+  n_row         - number of rows in A
+  Ap[n_row + 1] - CSR row pointer
+  Aj[nnz]       - CSR column indices
+   x[n_row]     - aggregate numbers for each node
+   y[n_row]     - will hold Cpts upon return
+   r[n_row]     - random values used to select the root nodes
+
+Returns:
+ The number of aggregates (== max(x[:]) + 1 )
+
+Notes:
+   It is assumed that A is symmetric.
+   A may contain diagonal entries (self loops)
+   Unaggregated (isolated) nodes are marked with a -1
+
+   The root nodes are a distance-2 maximal independent set of A, so
+   no two roots share a neighbor.  Each root takes all of its
+   neighbors, and the remaining nodes, which are all at distance 2
+   from a root, join the aggregate of their first aggregated
+   neighbor.  This mimics the passes of standard_aggregation, but
+   every pass only reads the result of the previous one, so the
+   aggregates depend on r and not on the number of threads.)pbdoc");
+
     m.def("fit_candidates", &_fit_candidates_real<int, float>,
-        py::arg("n_row"), py::arg("n_col"), py::arg("K1"), py::arg("K2"), py::arg("Ap").noconvert(), py::arg("Ai").noconvert(), py::arg("Ax").noconvert(), py::arg("B").noconvert(), py::arg("R").noconvert(), py::arg("tol"));
+        py::arg("n_row"), py::arg("n_col"), py::arg("K1"), py::arg("K2"), py::arg("Ap"), py::arg("Ai"), py::arg("Ax").noconvert(), py::arg("B"), py::arg("R").noconvert(), py::arg("tol"));
     m.def("fit_candidates", &_fit_candidates_real<int, double>,
-        py::arg("n_row"), py::arg("n_col"), py::arg("K1"), py::arg("K2"), py::arg("Ap").noconvert(), py::arg("Ai").noconvert(), py::arg("Ax").noconvert(), py::arg("B").noconvert(), py::arg("R").noconvert(), py::arg("tol"),
+        py::arg("n_row"), py::arg("n_col"), py::arg("K1"), py::arg("K2"), py::arg("Ap"), py::arg("Ai"), py::arg("Ax").noconvert(), py::arg("B"), py::arg("R").noconvert(), py::arg("tol"));
+    m.def("fit_candidates", &_fit_candidates_real<int64_t, float>,
+        py::arg("n_row"), py::arg("n_col"), py::arg("K1"), py::arg("K2"), py::arg("Ap"), py::arg("Ai"), py::arg("Ax").noconvert(), py::arg("B"), py::arg("R").noconvert(), py::arg("tol"));
+    m.def("fit_candidates", &_fit_candidates_real<int64_t, double>,
+        py::arg("n_row"), py::arg("n_col"), py::arg("K1"), py::arg("K2"), py::arg("Ap"), py::arg("Ai"), py::arg("Ax").noconvert(), py::arg("B"), py::arg("R").noconvert(), py::arg("tol"),
 R"pbdoc(
 )pbdoc");
 
     m.def("fit_candidates", &_fit_candidates_complex<int, float, std::complex<float>>,
-        py::arg("n_row"), py::arg("n_col"), py::arg("K1"), py::arg("K2"), py::arg("Ap").noconvert(), py::arg("Ai").noconvert(), py::arg("Ax").noconvert(), py::arg("B").noconvert(), py::arg("R").noconvert(), py::arg("tol"));
+        py::arg("n_row"), py::arg("n_col"), py::arg("K1"), py::arg("K2"), py::arg("Ap"), py::arg("Ai"), py::arg("Ax").noconvert(), py::arg("B"), py::arg("R").noconvert(), py::arg("tol"));
     m.def("fit_candidates", &_fit_candidates_complex<int, double, std::complex<double>>,
-        py::arg("n_row"), py::arg("n_col"), py::arg("K1"), py::arg("K2"), py::arg("Ap").noconvert(), py::arg("Ai").noconvert(), py::arg("Ax").noconvert(), py::arg("B").noconvert(), py::arg("R").noconvert(), py::arg("tol"),
+        py::arg("n_row"), py::arg("n_col"), py::arg("K1"), py::arg("K2"), py::arg("Ap"), py::arg("Ai"), py::arg("Ax").noconvert(), py::arg("B"), py::arg("R").noconvert(), py::arg("tol"));
+    m.def("fit_candidates", &_fit_candidates_complex<int64_t, float, std::complex<float>>,
+        py::arg("n_row"), py::arg("n_col"), py::arg("K1"), py::arg("K2"), py::arg("Ap"), py::arg("Ai"), py::arg("Ax").noconvert(), py::arg("B"), py::arg("R").noconvert(), py::arg("tol"));
+    m.def("fit_candidates", &_fit_candidates_complex<int64_t, double, std::complex<double>>,
+        py::arg("n_row"), py::arg("n_col"), py::arg("K1"), py::arg("K2"), py::arg("Ap"), py::arg("Ai"), py::arg("Ax").noconvert(), py::arg("B"), py::arg("R").noconvert(), py::arg("tol"),
 R"pbdoc(
 )pbdoc");
 
+    m.def("jacobi_prolongation_pass1", &_jacobi_prolongation_pass1<int>,
+        py::arg("n_brow"), py::arg("n_bcol"), py::arg("Sp"), py::arg("Sj"), py::arg("Tp"), py::arg("Tj"), py::arg("Pp").noconvert());
+    m.def("jacobi_prolongation_pass1", &_jacobi_prolongation_pass1<int64_t>,
+        py::arg("n_brow"), py::arg("n_bcol"), py::arg("Sp"), py::arg("Sj"), py::arg("Tp"), py::arg("Tj"), py::arg("Pp").noconvert(),
+R"pbdoc(
+Compute the row pointer of the smoothed prolongator
+     P = T - diag(w) S T,
+ see jacobi_prolongation_pass2(...).
+
+ Block row i of S T is the sum of S_ij T_j over the block columns j of
+ block row i of S, and T has at most one block per block row, so that
+ the block columns of block row i of P are the aggregates of i and of
+ its neighbors in S.
+
+ Parameters
+     n_brow     - number of block rows of S, T, and P
+     n_bcol     - number of block columns of T and P (aggregates)
+     Sp[]       - BSR row pointer of S
+     Sj[]       - BSR index array of S
+     Tp[]       - BSR row pointer of T
+     Tj[]       - BSR index array of T
+     Pp[]       - BSR row pointer of P (n_brow + 1)
+
+ Returns:
+     Nothing, Pp is modified in place
+
+ Notes:
+     The block rows are counted in parallel.)pbdoc");
+
+    m.def("jacobi_prolongation_pass2", &_jacobi_prolongation_pass2<int, float, float>,
+        py::arg("n_brow"), py::arg("n_bcol"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("w"), py::arg("Pp"), py::arg("Pj").noconvert(), py::arg("Px").noconvert(), py::arg("RowsPerBlock"), py::arg("ColsPerBlock"));
+    m.def("jacobi_prolongation_pass2", &_jacobi_prolongation_pass2<int, double, double>,
+        py::arg("n_brow"), py::arg("n_bcol"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("w"), py::arg("Pp"), py::arg("Pj").noconvert(), py::arg("Px").noconvert(), py::arg("RowsPerBlock"), py::arg("ColsPerBlock"));
+    m.def("jacobi_prolongation_pass2", &_jacobi_prolongation_pass2<int, std::complex<float>, float>,
+        py::arg("n_brow"), py::arg("n_bcol"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("w"), py::arg("Pp"), py::arg("Pj").noconvert(), py::arg("Px").noconvert(), py::arg("RowsPerBlock"), py::arg("ColsPerBlock"));
+    m.def("jacobi_prolongation_pass2", &_jacobi_prolongation_pass2<int, std::complex<double>, double>,
+        py::arg("n_brow"), py::arg("n_bcol"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("w"), py::arg("Pp"), py::arg("Pj").noconvert(), py::arg("Px").noconvert(), py::arg("RowsPerBlock"), py::arg("ColsPerBlock"));
+    m.def("jacobi_prolongation_pass2", &_jacobi_prolongation_pass2<int64_t, float, float>,
+        py::arg("n_brow"), py::arg("n_bcol"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("w"), py::arg("Pp"), py::arg("Pj").noconvert(), py::arg("Px").noconvert(), py::arg("RowsPerBlock"), py::arg("ColsPerBlock"));
+    m.def("jacobi_prolongation_pass2", &_jacobi_prolongation_pass2<int64_t, double, double>,
+        py::arg("n_brow"), py::arg("n_bcol"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("w"), py::arg("Pp"), py::arg("Pj").noconvert(), py::arg("Px").noconvert(), py::arg("RowsPerBlock"), py::arg("ColsPerBlock"));
+    m.def("jacobi_prolongation_pass2", &_jacobi_prolongation_pass2<int64_t, std::complex<float>, float>,
+        py::arg("n_brow"), py::arg("n_bcol"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("w"), py::arg("Pp"), py::arg("Pj").noconvert(), py::arg("Px").noconvert(), py::arg("RowsPerBlock"), py::arg("ColsPerBlock"));
+    m.def("jacobi_prolongation_pass2", &_jacobi_prolongation_pass2<int64_t, std::complex<double>, double>,
+        py::arg("n_brow"), py::arg("n_bcol"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("w"), py::arg("Pp"), py::arg("Pj").noconvert(), py::arg("Px").noconvert(), py::arg("RowsPerBlock"), py::arg("ColsPerBlock"),
+R"pbdoc(
+Smooth a tentative prolongator T with one step of weighted Jacobi,
+     P = T - diag(w) S T,
+ directly from T, without forming diag(w) S or S T.
+
+ T is the tentative prolongator of fit_candidates(...), with at most one
+ block per block row, i.e., block row j of T is the block T_j in the
+ block column of the aggregate of j, or empty.  Block row i of P is then
+ T_i minus, for each block column j of block row i of S, diag(w_i) S_ij
+ T_j added to the block of the aggregate of j.  With w = omega/rho(K)
+ diag(S)^-1, this is jacobi_prolongation_smoother(...) in smooth.py
+ for weighting='diagonal', and with the inverse row sums of abs(S) for
+ weighting='local'.
+
+ Parameters
+     n_brow        - number of block rows of S, T, and P
+     n_bcol        - number of block columns of T and P (aggregates)
+     Sp[]          - BSR row pointer of S
+     Sj[]          - BSR index array of S
+     Sx[]          - BSR data array of S, RowsPerBlock x RowsPerBlock blocks
+     Tp[]          - BSR row pointer of T
+     Tj[]          - BSR index array of T
+     Tx[]          - BSR data array of T, RowsPerBlock x ColsPerBlock blocks
+     w[]           - weight of each row (n_brow * RowsPerBlock)
+     Pp[]          - BSR row pointer of P, from jacobi_prolongation_pass1
+     Pj[]          - BSR index array of P
+     Px[]          - BSR data array of P, RowsPerBlock x ColsPerBlock blocks
+     RowsPerBlock  - row blocksize of S, T, and P
+     ColsPerBlock  - column blocksize of T and P
+
+ Returns:
+     Nothing, Pj and Px are modified in place
+
+ Notes:
+     S is given as CSR with RowsPerBlock = 1.  The block columns of each
+     block row of P are sorted, and blocks that are zero are kept.  The
+     block rows are computed in parallel, and the result does not
+     depend on the number of threads.)pbdoc");
+
+    m.def("jacobi_prolongation_values", &_jacobi_prolongation_values<int, float, float>,
+        py::arg("n_brow"), py::arg("n_bcol"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("w"), py::arg("Pp"), py::arg("Pj"), py::arg("Px").noconvert(), py::arg("RowsPerBlock"), py::arg("ColsPerBlock"));
+    m.def("jacobi_prolongation_values", &_jacobi_prolongation_values<int, double, double>,
+        py::arg("n_brow"), py::arg("n_bcol"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("w"), py::arg("Pp"), py::arg("Pj"), py::arg("Px").noconvert(), py::arg("RowsPerBlock"), py::arg("ColsPerBlock"));
+    m.def("jacobi_prolongation_values", &_jacobi_prolongation_values<int, std::complex<float>, float>,
+        py::arg("n_brow"), py::arg("n_bcol"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("w"), py::arg("Pp"), py::arg("Pj"), py::arg("Px").noconvert(), py::arg("RowsPerBlock"), py::arg("ColsPerBlock"));
+    m.def("jacobi_prolongation_values", &_jacobi_prolongation_values<int, std::complex<double>, double>,
+        py::arg("n_brow"), py::arg("n_bcol"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("w"), py::arg("Pp"), py::arg("Pj"), py::arg("Px").noconvert(), py::arg("RowsPerBlock"), py::arg("ColsPerBlock"));
+    m.def("jacobi_prolongation_values", &_jacobi_prolongation_values<int64_t, float, float>,
+        py::arg("n_brow"), py::arg("n_bcol"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("w"), py::arg("Pp"), py::arg("Pj"), py::arg("Px").noconvert(), py::arg("RowsPerBlock"), py::arg("ColsPerBlock"));
+    m.def("jacobi_prolongation_values", &_jacobi_prolongation_values<int64_t, double, double>,
+        py::arg("n_brow"), py::arg("n_bcol"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("w"), py::arg("Pp"), py::arg("Pj"), py::arg("Px").noconvert(), py::arg("RowsPerBlock"), py::arg("ColsPerBlock"));
+    m.def("jacobi_prolongation_values", &_jacobi_prolongation_values<int64_t, std::complex<float>, float>,
+        py::arg("n_brow"), py::arg("n_bcol"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("w"), py::arg("Pp"), py::arg("Pj"), py::arg("Px").noconvert(), py::arg("RowsPerBlock"), py::arg("ColsPerBlock"));
+    m.def("jacobi_prolongation_values", &_jacobi_prolongation_values<int64_t, std::complex<double>, double>,
+        py::arg("n_brow"), py::arg("n_bcol"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx"), py::arg("Tp"), py::arg("Tj"), py::arg("Tx"), py::arg("w"), py::arg("Pp"), py::arg("Pj"), py::arg("Px").noconvert(), py::arg("RowsPerBlock"), py::arg("ColsPerBlock"),
+R"pbdoc(
+Smooth a tentative prolongator T as in jacobi_prolongation_pass2(...),
+ in a given sparsity pattern of P, e.g., the pattern of the prolongator
+ of a previous setup with the same aggregates.
+
+ Parameters
+     n_brow        - number of block rows of S, T, and P
+     n_bcol        - number of block columns of T and P (aggregates)
+     Sp[]          - BSR row pointer of S
+     Sj[]          - BSR index array of S
+     Sx[]          - BSR data array of S, RowsPerBlock x RowsPerBlock blocks
+     Tp[]          - BSR row pointer of T
+     Tj[]          - BSR index array of T
+     Tx[]          - BSR data array of T, RowsPerBlock x ColsPerBlock blocks
+     w[]           - weight of each row (n_brow * RowsPerBlock)
+     Pp[]          - BSR row pointer of the pattern of P
+     Pj[]          - BSR index array of the pattern of P
+     Px[]          - BSR data array of P, RowsPerBlock x ColsPerBlock blocks
+     RowsPerBlock  - row blocksize of S, T, and P
+     ColsPerBlock  - column blocksize of T and P
+
+ Returns:
+     The number of block rows of P with an aggregate outside of the
+     pattern.  If it is 0, Px is modified in place to the blocks of P
+     in the pattern, which are zero for the aggregates that no block
+     contributes to.  Otherwise, Px is undefined, and P is to be
+     computed with jacobi_prolongation_pass1(...) and _pass2(...).
+
+ Notes:
+     This skips jacobi_prolongation_pass1(...) and the sort of the
+     block columns of each block row of jacobi_prolongation_pass2(...),
+     and computes each block in the same order as there.)pbdoc");
+
     m.def("satisfy_constraints_helper", &_satisfy_constraints_helper<int, float, float>,
-        py::arg("RowsPerBlock"), py::arg("ColsPerBlock"), py::arg("num_block_rows"), py::arg("NullDim"), py::arg("x").noconvert(), py::arg("y").noconvert(), py::arg("z").noconvert(), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
+        py::arg("RowsPerBlock"), py::arg("ColsPerBlock"), py::arg("num_block_rows"), py::arg("NullDim"), py::arg("x"), py::arg("y"), py::arg("z"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert());
     m.def("satisfy_constraints_helper", &_satisfy_constraints_helper<int, double, double>,
-        py::arg("RowsPerBlock"), py::arg("ColsPerBlock"), py::arg("num_block_rows"), py::arg("NullDim"), py::arg("x").noconvert(), py::arg("y").noconvert(), py::arg("z").noconvert(), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
+        py::arg("RowsPerBlock"), py::arg("ColsPerBlock"), py::arg("num_block_rows"), py::arg("NullDim"), py::arg("x"), py::arg("y"), py::arg("z"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert());
     m.def("satisfy_constraints_helper", &_satisfy_constraints_helper<int, std::complex<float>, float>,
-        py::arg("RowsPerBlock"), py::arg("ColsPerBlock"), py::arg("num_block_rows"), py::arg("NullDim"), py::arg("x").noconvert(), py::arg("y").noconvert(), py::arg("z").noconvert(), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
+        py::arg("RowsPerBlock"), py::arg("ColsPerBlock"), py::arg("num_block_rows"), py::arg("NullDim"), py::arg("x"), py::arg("y"), py::arg("z"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert());
     m.def("satisfy_constraints_helper", &_satisfy_constraints_helper<int, std::complex<double>, double>,
-        py::arg("RowsPerBlock"), py::arg("ColsPerBlock"), py::arg("num_block_rows"), py::arg("NullDim"), py::arg("x").noconvert(), py::arg("y").noconvert(), py::arg("z").noconvert(), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert(),
+        py::arg("RowsPerBlock"), py::arg("ColsPerBlock"), py::arg("num_block_rows"), py::arg("NullDim"), py::arg("x"), py::arg("y"), py::arg("z"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert());
+    m.def("satisfy_constraints_helper", &_satisfy_constraints_helper<int64_t, float, float>,
+        py::arg("RowsPerBlock"), py::arg("ColsPerBlock"), py::arg("num_block_rows"), py::arg("NullDim"), py::arg("x"), py::arg("y"), py::arg("z"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert());
+    m.def("satisfy_constraints_helper", &_satisfy_constraints_helper<int64_t, double, double>,
+        py::arg("RowsPerBlock"), py::arg("ColsPerBlock"), py::arg("num_block_rows"), py::arg("NullDim"), py::arg("x"), py::arg("y"), py::arg("z"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert());
+    m.def("satisfy_constraints_helper", &_satisfy_constraints_helper<int64_t, std::complex<float>, float>,
+        py::arg("RowsPerBlock"), py::arg("ColsPerBlock"), py::arg("num_block_rows"), py::arg("NullDim"), py::arg("x"), py::arg("y"), py::arg("z"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert());
+    m.def("satisfy_constraints_helper", &_satisfy_constraints_helper<int64_t, std::complex<double>, double>,
+        py::arg("RowsPerBlock"), py::arg("ColsPerBlock"), py::arg("num_block_rows"), py::arg("NullDim"), py::arg("x"), py::arg("y"), py::arg("z"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert(),
 R"pbdoc(
 )pbdoc");
 
     m.def("calc_BtB", &_calc_BtB<int, float, float>,
-        py::arg("NullDim"), py::arg("Nnodes"), py::arg("ColsPerBlock"), py::arg("b").noconvert(), py::arg("BsqCols"), py::arg("x").noconvert(), py::arg("Sp").noconvert(), py::arg("Sj").noconvert());
+        py::arg("NullDim"), py::arg("Nnodes"), py::arg("ColsPerBlock"), py::arg("b"), py::arg("BsqCols"), py::arg("x").noconvert(), py::arg("Sp"), py::arg("Sj"));
     m.def("calc_BtB", &_calc_BtB<int, double, double>,
-        py::arg("NullDim"), py::arg("Nnodes"), py::arg("ColsPerBlock"), py::arg("b").noconvert(), py::arg("BsqCols"), py::arg("x").noconvert(), py::arg("Sp").noconvert(), py::arg("Sj").noconvert());
+        py::arg("NullDim"), py::arg("Nnodes"), py::arg("ColsPerBlock"), py::arg("b"), py::arg("BsqCols"), py::arg("x").noconvert(), py::arg("Sp"), py::arg("Sj"));
     m.def("calc_BtB", &_calc_BtB<int, std::complex<float>, float>,
-        py::arg("NullDim"), py::arg("Nnodes"), py::arg("ColsPerBlock"), py::arg("b").noconvert(), py::arg("BsqCols"), py::arg("x").noconvert(), py::arg("Sp").noconvert(), py::arg("Sj").noconvert());
+        py::arg("NullDim"), py::arg("Nnodes"), py::arg("ColsPerBlock"), py::arg("b"), py::arg("BsqCols"), py::arg("x").noconvert(), py::arg("Sp"), py::arg("Sj"));
     m.def("calc_BtB", &_calc_BtB<int, std::complex<double>, double>,
-        py::arg("NullDim"), py::arg("Nnodes"), py::arg("ColsPerBlock"), py::arg("b").noconvert(), py::arg("BsqCols"), py::arg("x").noconvert(), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(),
+        py::arg("NullDim"), py::arg("Nnodes"), py::arg("ColsPerBlock"), py::arg("b"), py::arg("BsqCols"), py::arg("x").noconvert(), py::arg("Sp"), py::arg("Sj"));
+    m.def("calc_BtB", &_calc_BtB<int64_t, float, float>,
+        py::arg("NullDim"), py::arg("Nnodes"), py::arg("ColsPerBlock"), py::arg("b"), py::arg("BsqCols"), py::arg("x").noconvert(), py::arg("Sp"), py::arg("Sj"));
+    m.def("calc_BtB", &_calc_BtB<int64_t, double, double>,
+        py::arg("NullDim"), py::arg("Nnodes"), py::arg("ColsPerBlock"), py::arg("b"), py::arg("BsqCols"), py::arg("x").noconvert(), py::arg("Sp"), py::arg("Sj"));
+    m.def("calc_BtB", &_calc_BtB<int64_t, std::complex<float>, float>,
+        py::arg("NullDim"), py::arg("Nnodes"), py::arg("ColsPerBlock"), py::arg("b"), py::arg("BsqCols"), py::arg("x").noconvert(), py::arg("Sp"), py::arg("Sj"));
+    m.def("calc_BtB", &_calc_BtB<int64_t, std::complex<double>, double>,
+        py::arg("NullDim"), py::arg("Nnodes"), py::arg("ColsPerBlock"), py::arg("b"), py::arg("BsqCols"), py::arg("x").noconvert(), py::arg("Sp"), py::arg("Sj"),
 R"pbdoc(
 Helper routine for energy_prolongation_smoother
 Calculates the following python code:
@@ -510,13 +1030,21 @@ Notes
 Principle calling routine is energy_prolongation_smoother(...) in smooth.py.)pbdoc");
 
     m.def("incomplete_mat_mult_bsr", &_incomplete_mat_mult_bsr<int, float, float>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("Bp").noconvert(), py::arg("Bj").noconvert(), py::arg("Bx").noconvert(), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert(), py::arg("n_brow"), py::arg("n_bcol"), py::arg("brow_A"), py::arg("bcol_A"), py::arg("bcol_B"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Bp"), py::arg("Bj"), py::arg("Bx"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert(), py::arg("n_brow"), py::arg("n_bcol"), py::arg("brow_A"), py::arg("bcol_A"), py::arg("bcol_B"));
     m.def("incomplete_mat_mult_bsr", &_incomplete_mat_mult_bsr<int, double, double>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("Bp").noconvert(), py::arg("Bj").noconvert(), py::arg("Bx").noconvert(), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert(), py::arg("n_brow"), py::arg("n_bcol"), py::arg("brow_A"), py::arg("bcol_A"), py::arg("bcol_B"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Bp"), py::arg("Bj"), py::arg("Bx"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert(), py::arg("n_brow"), py::arg("n_bcol"), py::arg("brow_A"), py::arg("bcol_A"), py::arg("bcol_B"));
     m.def("incomplete_mat_mult_bsr", &_incomplete_mat_mult_bsr<int, std::complex<float>, float>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("Bp").noconvert(), py::arg("Bj").noconvert(), py::arg("Bx").noconvert(), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert(), py::arg("n_brow"), py::arg("n_bcol"), py::arg("brow_A"), py::arg("bcol_A"), py::arg("bcol_B"));
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Bp"), py::arg("Bj"), py::arg("Bx"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert(), py::arg("n_brow"), py::arg("n_bcol"), py::arg("brow_A"), py::arg("bcol_A"), py::arg("bcol_B"));
     m.def("incomplete_mat_mult_bsr", &_incomplete_mat_mult_bsr<int, std::complex<double>, double>,
-        py::arg("Ap").noconvert(), py::arg("Aj").noconvert(), py::arg("Ax").noconvert(), py::arg("Bp").noconvert(), py::arg("Bj").noconvert(), py::arg("Bx").noconvert(), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert(), py::arg("n_brow"), py::arg("n_bcol"), py::arg("brow_A"), py::arg("bcol_A"), py::arg("bcol_B"),
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Bp"), py::arg("Bj"), py::arg("Bx"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert(), py::arg("n_brow"), py::arg("n_bcol"), py::arg("brow_A"), py::arg("bcol_A"), py::arg("bcol_B"));
+    m.def("incomplete_mat_mult_bsr", &_incomplete_mat_mult_bsr<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Bp"), py::arg("Bj"), py::arg("Bx"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert(), py::arg("n_brow"), py::arg("n_bcol"), py::arg("brow_A"), py::arg("bcol_A"), py::arg("bcol_B"));
+    m.def("incomplete_mat_mult_bsr", &_incomplete_mat_mult_bsr<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Bp"), py::arg("Bj"), py::arg("Bx"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert(), py::arg("n_brow"), py::arg("n_bcol"), py::arg("brow_A"), py::arg("bcol_A"), py::arg("bcol_B"));
+    m.def("incomplete_mat_mult_bsr", &_incomplete_mat_mult_bsr<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Bp"), py::arg("Bj"), py::arg("Bx"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert(), py::arg("n_brow"), py::arg("n_bcol"), py::arg("brow_A"), py::arg("bcol_A"), py::arg("bcol_B"));
+    m.def("incomplete_mat_mult_bsr", &_incomplete_mat_mult_bsr<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Bp"), py::arg("Bj"), py::arg("Bx"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert(), py::arg("n_brow"), py::arg("n_bcol"), py::arg("brow_A"), py::arg("bcol_A"), py::arg("bcol_B"),
 R"pbdoc(
 Calculate A*B = S, but only at the pre-existing sparsity
 pattern of S, i.e. do an exact, but incomplete mat-mat mult.
@@ -567,23 +1095,35 @@ of S.
 Notes
 -----
 
-Algorithm is SMMP
+Algorithm is SMMP, with the masked_spgemm(...) engine in sparse.h
 
 Principle calling routine is energy_prolongation_smoother(...) in
 smooth.py.  Here it is used to calculate the descent direction
 A*P_tent, but only within an accepted sparsity pattern.
 
 Is generally faster than the commented out incomplete_BSRmatmat(...)
-routine below, except when S has far few nonzeros than A or B.)pbdoc");
+routine below, except when S has far few nonzeros than A or B.
+
+The block rows of S are computed in parallel.  For square blocks in
+A of size 1, 2, 3 or 6, a version with the block multiply unrolled
+at compile time is used.)pbdoc");
 
     m.def("truncate_rows_csr", &_truncate_rows_csr<int, float, float>,
-        py::arg("n_row"), py::arg("k"), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
+        py::arg("n_row"), py::arg("k"), py::arg("Sp"), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
     m.def("truncate_rows_csr", &_truncate_rows_csr<int, double, double>,
-        py::arg("n_row"), py::arg("k"), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
+        py::arg("n_row"), py::arg("k"), py::arg("Sp"), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
     m.def("truncate_rows_csr", &_truncate_rows_csr<int, std::complex<float>, float>,
-        py::arg("n_row"), py::arg("k"), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
+        py::arg("n_row"), py::arg("k"), py::arg("Sp"), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
     m.def("truncate_rows_csr", &_truncate_rows_csr<int, std::complex<double>, double>,
-        py::arg("n_row"), py::arg("k"), py::arg("Sp").noconvert(), py::arg("Sj").noconvert(), py::arg("Sx").noconvert(),
+        py::arg("n_row"), py::arg("k"), py::arg("Sp"), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
+    m.def("truncate_rows_csr", &_truncate_rows_csr<int64_t, float, float>,
+        py::arg("n_row"), py::arg("k"), py::arg("Sp"), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
+    m.def("truncate_rows_csr", &_truncate_rows_csr<int64_t, double, double>,
+        py::arg("n_row"), py::arg("k"), py::arg("Sp"), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
+    m.def("truncate_rows_csr", &_truncate_rows_csr<int64_t, std::complex<float>, float>,
+        py::arg("n_row"), py::arg("k"), py::arg("Sp"), py::arg("Sj").noconvert(), py::arg("Sx").noconvert());
+    m.def("truncate_rows_csr", &_truncate_rows_csr<int64_t, std::complex<double>, double>,
+        py::arg("n_row"), py::arg("k"), py::arg("Sp"), py::arg("Sj").noconvert(), py::arg("Sx").noconvert(),
 R"pbdoc(
 Truncate the entries in A, such that only the largest (in magnitude)
  k entries per row are left.   Smaller entries are zeroed out.
@@ -0,0 +1,1065 @@
+#ifndef SPARSE_H
+#define SPARSE_H
+
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+#include "linalg.h"
+#include "parallel.h"
+
+/*
+ * masked_spgemm(...) uses a dense accumulator with one entry per column
+ * of S, unless S has more than dense_max_columns columns, by default
+ * MASKED_DENSE_MAX_SIZE.  Then rows of S with a hash table of at most
+ * MASKED_HASH_MAX_SIZE slots use a hash accumulator instead, see
+ * masked_hash_size(...).
+ */
+const int MASKED_DENSE_MAX_SIZE = 1 << 22;
+const int MASKED_HASH_MAX_SIZE = 1024;
+
+
+/*
+ * Size of the hash table used by masked_spgemm(...) for a row of the mask
+ * with row_length entries, or 0 if the row should use the dense
+ * accumulator.  Matrices with at most dense_max_columns columns always use
+ * the dense accumulator.
+ *
+ * The dense accumulator is faster as long as it is not too large, even
+ * when its entries are accessed at random, but each thread needs its own
+ * copy.  So the hash table is only used for very wide matrices, to bound
+ * the memory used per thread, and only for short rows.  The table is a
+ * power of two, at least twice the row length.
+ */
+template<class I>
+inline I masked_hash_size(const I row_length, const I n_col,
+                          const I dense_max_columns)
+{
+    if(n_col <= dense_max_columns){
+        return 0;
+    }
+
+    I size = 16;
+    while(size < 2*row_length){
+        size *= 2;
+    }
+
+    if(size > MASKED_HASH_MAX_SIZE){
+        return 0;
+    }
+    return size;
+}
+
+
+/*
+ * Slot of column j in a hash table of size mask + 1
+ */
+template<class I>
+inline I masked_hash(const I j, const I mask)
+{
+    return (I) ((static_cast<std::size_t>(j) * 2654435761u) & static_cast<std::size_t>(mask));
+}
+
+
+/*
+ * Masked sparse matrix-matrix multiply engine.  Visit each product
+ * A(i,j)*B(j,k) for which (i,k) is in the sparsity pattern of S.
+ *
+ * For each such product, kernel(s, a, b) is called, where a and b are
+ * the positions of A(i,j) and B(j,k) in Aj and Bj, and s is the position
+ * of S(i,k) in Sj.  The rows of S are processed in parallel, and kernel
+ * is only called with positions s from row i of S while row i is
+ * processed, so kernel may write to row i of S without synchronization.
+ *
+ * Parameters
+ * ----------
+ * Ap, Aj : {int array}
+ *      CSR (or BSR) row pointer and column index arrays for A
+ * Bp, Bj : {int array}
+ *      CSR (or BSR) row pointer and column index arrays for B
+ * Sp, Sj : {int array}
+ *      CSR (or BSR) row pointer and column index arrays for the mask S
+ * n_row : {int}
+ *      Number of rows of A and S
+ * n_col : {int}
+ *      Number of columns of B and S
+ * kernel : {callable}
+ *      Called as kernel(s, a, b) for each product
+ * dense_max_columns : {int}
+ *      Largest number of columns of S for which only the dense
+ *      accumulator is used, values < 1 mean MASKED_DENSE_MAX_SIZE
+ *
+ * Notes
+ * -----
+ * The products for row i are visited with the entries of row i of A in
+ * order, and for each of those, with the entries of the matching row of
+ * B in order.  So the accumulation order in each S(i,k) does not depend
+ * on the number of threads or on the accumulator used.
+ *
+ * Each row of S uses one of two accumulators to map the columns k of
+ * B(j,k) to the positions in row i of S.  By default this is a dense
+ * table with one entry per column of S.  If S is very wide, short rows
+ * use a small hash table with linear probing instead, and the dense
+ * table is only allocated by threads that need it.  See
+ * masked_hash_size(...).
+ *
+ * The indices of A, B and S need not be sorted.  If row i of S has
+ * duplicate columns, only the last one is visited.
+ *
+ */
+template<class I, class Kernel>
+void masked_spgemm(const I Ap[], const I Aj[],
+                   const I Bp[], const I Bj[],
+                   const I Sp[], const I Sj[],
+                   const I n_row,
+                   const I n_col,
+                   const Kernel& kernel,
+                   const I dense_max_columns = MASKED_DENSE_MAX_SIZE)
+{
+    const I max_columns = (dense_max_columns > 0) ? dense_max_columns
+                                                  : (I) MASKED_DENSE_MAX_SIZE;
+
+    #pragma omp parallel
+    {
+        // Dense accumulator, only allocated by threads that need it
+        std::vector<I> dense;
+
+        // Hash accumulator
+        std::vector<I> keys;
+        std::vector<I> values;
+
+        #pragma omp for schedule(static)
+        for(I i = 0; i < n_row; i++){
+            const I row_start = Sp[i];
+            const I row_end   = Sp[i+1];
+            if(row_start == row_end){
+                continue;
+            }
+
+            const I size = masked_hash_size(row_end - row_start, n_col,
+                                            max_columns);
+
+            if(size > 0){
+                const I mask = size - 1;
+                keys.assign(size, -1);
+                values.resize(size);
+
+                for(I jj = row_start; jj < row_end; jj++){
+                    const I k = Sj[jj];
+                    I h = masked_hash(k, mask);
+                    while(keys[h] != -1 && keys[h] != k){
+                        h = (h + 1) & mask;
+                    }
+                    keys[h] = k;
+                    values[h] = jj;
+                }
+
+                for(I a = Ap[i]; a < Ap[i+1]; a++){
+                    const I j = Aj[a];
+                    for(I b = Bp[j]; b < Bp[j+1]; b++){
+                        const I k = Bj[b];
+                        I h = masked_hash(k, mask);
+                        while(keys[h] != -1 && keys[h] != k){
+                            h = (h + 1) & mask;
+                        }
+                        if(keys[h] == k){
+                            kernel(values[h], a, b);
+                        }
+                    }
+                }
+            }
+            else{
+                if(dense.empty()){
+                    dense.assign(n_col, -1);
+                }
+
+                for(I jj = row_start; jj < row_end; jj++){
+                    dense[Sj[jj]] = jj;
+                }
+
+                for(I a = Ap[i]; a < Ap[i+1]; a++){
+                    const I j = Aj[a];
+                    for(I b = Bp[j]; b < Bp[j+1]; b++){
+                        const I s = dense[Bj[b]];
+                        if(s != -1){
+                            kernel(s, a, b);
+                        }
+                    }
+                }
+
+                // Revert the dense accumulator to all -1
+                for(I jj = row_start; jj < row_end; jj++){
+                    dense[Sj[jj]] = -1;
+                }
+            }
+        }
+    }
+}
+
+
+/*
+ * Calculate A*B = S, but only at the pre-existing sparsity
+ * pattern of S, i.e. do an exact, but incomplete mat-mat multiply.
+ *
+ * A, B and S must all be in CSR and may be rectangular, but the
+ * indices need not be sorted.
+ *
+ * Parameters
+ * ----------
+ * Ap : {int array}
+ *      Row pointer array for CSR matrix A
+ * Aj : {int array}
+ *      Col index array for CSR matrix A
+ * Ax : {float|complex array}
+ *      Value array for CSR matrix A
+ * Bp : {int array}
+ *      Row pointer array for CSR matrix B
+ * Bj : {int array}
+ *      Col index array for CSR matrix B
+ * Bx : {float|complex array}
+ *      Value array for CSR matrix B
+ * Sp : {int array}
+ *      Row pointer array for CSR matrix S
+ * Sj : {int array}
+ *      Col index array for CSR matrix S
+ * Sx : {float|complex array}
+ *      Value array for CSR matrix S
+ * n_row : {int}
+ *      Number of rows in A and S
+ * n_col : {int}
+ *      Number of columns in B and S
+ * dense_max_columns : {int}
+ *      Largest number of columns of S for which the product is always
+ *      accumulated in a dense table, values < 1 use the default.  A small
+ *      value forces the hash accumulator, see masked_spgemm(...).
+ *
+ * Returns
+ * -------
+ * Sx is modified inplace to reflect S(i,k) = <A_{i,:}, B_{:,k}>
+ * for the entries in the sparsity pattern of S
+ *
+ * Notes
+ * -----
+ * Unlike incomplete_mat_mult_csr(...), B is in CSR, and the product is
+ * accumulated row by row with masked_spgemm(...), in parallel over the
+ * rows of S.  If the rows of A are sorted, the result is identical to
+ * incomplete_mat_mult_csr(...).
+ *
+ * Principle calling routine is evolution_strength_of_connection in
+ * strength.py.
+ *
+ * Examples
+ * --------
+ * >>> from pyamg.amg_core import masked_mat_mult_csr
+ * >>> import numpy as np
+ * >>> from scipy.sparse import csr_matrix
+ * >>>
+ * >>> A = csr_matrix(np.arange(1,10,dtype=float).reshape(3,3))
+ * >>> B = csr_matrix(np.ones((3,3),dtype=float))
+ * >>> AB = csr_matrix(np.eye(3,3,dtype=float))
+ * >>> masked_mat_mult_csr(A.indptr, A.indices, A.data, B.indptr, B.indices,
+ * ...                     B.data, AB.indptr, AB.indices, AB.data, 3, 3, 0)
+ * >>> print(AB.toarray())
+ * [[ 6.  0.  0.]
+ *  [ 0. 15.  0.]
+ *  [ 0.  0. 24.]]
+ */
+template<class I, class T, class F>
+void masked_mat_mult_csr(const I Ap[], const int Ap_size,
+                         const I Aj[], const int Aj_size,
+                         const T Ax[], const int Ax_size,
+                         const I Bp[], const int Bp_size,
+                         const I Bj[], const int Bj_size,
+                         const T Bx[], const int Bx_size,
+                         const I Sp[], const int Sp_size,
+                         const I Sj[], const int Sj_size,
+                               T Sx[], const int Sx_size,
+                         const I n_row,
+                         const I n_col,
+                         const I dense_max_columns)
+{
+    #pragma omp parallel for schedule(static)
+    for(I i = 0; i < n_row; i++){
+        for(I jj = Sp[i]; jj < Sp[i+1]; jj++){
+            Sx[jj] = 0.0;
+        }
+    }
+
+    masked_spgemm(Ap, Aj, Bp, Bj, Sp, Sj, n_row, n_col,
+                  [=](const I s, const I a, const I b){ Sx[s] += Ax[a]*Bx[b]; },
+                  dense_max_columns);
+}
+
+
+/*
+ * Symbolic phase of a masked matrix-matrix multiply S = A*B, for
+ * repeated products with the same sparsity patterns of A, B and S.
+ *
+ * This first pass counts the products A(i,j)*B(j,k) that land in the
+ * sparsity pattern of S for each nonzero A(i,j).  The second pass,
+ * masked_mat_mult_pattern(...), records those products, and then
+ * masked_mat_mult_numeric_csr(...) computes S from the values of A and B.
+ *
+ * Parameters
+ * ----------
+ * Ap, Aj : {int array}
+ *      CSR row pointer and column index arrays for A
+ * Bp, Bj : {int array}
+ *      CSR row pointer and column index arrays for B
+ * Sp, Sj : {int array}
+ *      CSR row pointer and column index arrays for S
+ * Hp : {int array}
+ *      Output array of length nnz(A) + 1
+ * n_row : {int}
+ *      Number of rows in A and S
+ * n_col : {int}
+ *      Number of columns in B and S
+ *
+ * Returns
+ * -------
+ * Hp is modified inplace, so that the products for the nonzero a of A
+ * are Hp[a], ..., Hp[a+1]-1.  Hp[nnz(A)] is the total number of
+ * products, which is the length needed for Hb and Hs in
+ * masked_mat_mult_pattern(...).
+ *
+ */
+template<class I>
+void masked_mat_mult_symbolic(const I Ap[], const int Ap_size,
+                              const I Aj[], const int Aj_size,
+                              const I Bp[], const int Bp_size,
+                              const I Bj[], const int Bj_size,
+                              const I Sp[], const int Sp_size,
+                              const I Sj[], const int Sj_size,
+                                    I Hp[], const int Hp_size,
+                              const I n_row,
+                              const I n_col)
+{
+    const I nnz = Ap[n_row];
+
+    #pragma omp parallel for schedule(static)
+    for(I a = 0; a < nnz + 1; a++){
+        Hp[a] = 0;
+    }
+
+    masked_spgemm(Ap, Aj, Bp, Bj, Sp, Sj, n_row, n_col,
+                  [=](const I, const I a, const I){ Hp[a + 1]++; });
+
+    cumulative_sum(Hp, nnz + 1);
+}
+
+
+/*
+ * Second pass of the symbolic phase of a masked matrix-matrix multiply,
+ * see masked_mat_mult_symbolic(...).
+ *
+ * Parameters
+ * ----------
+ * Ap, Aj : {int array}
+ *      CSR row pointer and column index arrays for A
+ * Bp, Bj : {int array}
+ *      CSR row pointer and column index arrays for B
+ * Sp, Sj : {int array}
+ *      CSR row pointer and column index arrays for S
+ * Hp : {int array}
+ *      Computed by masked_mat_mult_symbolic(...)
+ * Hb, Hs : {int array}
+ *      Output arrays of length Hp[nnz(A)]
+ * n_row : {int}
+ *      Number of rows in A and S
+ * n_col : {int}
+ *      Number of columns in B and S
+ *
+ * Returns
+ * -------
+ * Hb and Hs are modified inplace.  For h in Hp[a], ..., Hp[a+1]-1,
+ * the product of the nonzero a of A with the nonzero Hb[h] of B
+ * contributes to the nonzero Hs[h] of S.
+ *
+ */
+template<class I>
+void masked_mat_mult_pattern(const I Ap[], const int Ap_size,
+                             const I Aj[], const int Aj_size,
+                             const I Bp[], const int Bp_size,
+                             const I Bj[], const int Bj_size,
+                             const I Sp[], const int Sp_size,
+                             const I Sj[], const int Sj_size,
+                             const I Hp[], const int Hp_size,
+                                   I Hb[], const int Hb_size,
+                                   I Hs[], const int Hs_size,
+                             const I n_row,
+                             const I n_col)
+{
+    // Next free position for the products of each nonzero of A
+    std::vector<I> next(Hp, Hp + Ap[n_row]);
+    I * next_ptr = &next[0];
+
+    masked_spgemm(Ap, Aj, Bp, Bj, Sp, Sj, n_row, n_col,
+                  [=](const I s, const I a, const I b){
+                      const I h = next_ptr[a]++;
+                      Hb[h] = b;
+                      Hs[h] = s;
+                  });
+}
+
+
+/*
+ * Numeric phase of a masked matrix-matrix multiply S = A*B, using the
+ * products recorded by masked_mat_mult_symbolic(...) and
+ * masked_mat_mult_pattern(...).
+ *
+ * Parameters
+ * ----------
+ * Ap : {int array}
+ *      CSR row pointer array for A
+ * Ax : {float|complex array}
+ *      CSR value array for A
+ * Bx : {float|complex array}
+ *      CSR value array for B
+ * Hp, Hb, Hs : {int array}
+ *      Products computed by the symbolic phase
+ * Sp : {int array}
+ *      CSR row pointer array for S
+ * Sx : {float|complex array}
+ *      CSR value array for S
+ * n_row : {int}
+ *      Number of rows in A and S
+ *
+ * Returns
+ * -------
+ * Sx is modified inplace to reflect S(i,k) = <A_{i,:}, B_{:,k}>
+ * for the entries in the sparsity pattern of S
+ *
+ * Notes
+ * -----
+ * A and B must have the same sparsity patterns, in the same order, as
+ * in the symbolic phase.  The result is identical to
+ * masked_mat_mult_csr(...).
+ *
+ */
+template<class I, class T, class F>
+void masked_mat_mult_numeric_csr(const I Ap[], const int Ap_size,
+                                 const T Ax[], const int Ax_size,
+                                 const T Bx[], const int Bx_size,
+                                 const I Hp[], const int Hp_size,
+                                 const I Hb[], const int Hb_size,
+                                 const I Hs[], const int Hs_size,
+                                 const I Sp[], const int Sp_size,
+                                       T Sx[], const int Sx_size,
+                                 const I n_row)
+{
+    #pragma omp parallel for schedule(static)
+    for(I i = 0; i < n_row; i++){
+        for(I jj = Sp[i]; jj < Sp[i+1]; jj++){
+            Sx[jj] = 0.0;
+        }
+
+        for(I a = Ap[i]; a < Ap[i+1]; a++){
+            const T Aa = Ax[a];
+            for(I h = Hp[a]; h < Hp[a+1]; h++){
+                Sx[Hs[h]] += Aa*Bx[Hb[h]];
+            }
+        }
+    }
+}
+
+
+/*
+ * Symbolic phase of the Galerkin product C = R*A*P, computed row by row
+ * without forming A*P or R*A.
+ *
+ * Row i of C is the union of the rows P(j,:) over the nonzeros R(i,k)
+ * and A(k,j).  The rows of C are counted in parallel, each thread with
+ * its own marker array of length n_col.
+ *
+ * Parameters
+ * ----------
+ * Rp, Rj : {int array}
+ *      CSR (or BSR) row pointer and column index arrays for R
+ * Ap, Aj : {int array}
+ *      CSR (or BSR) row pointer and column index arrays for A
+ * Pp, Pj : {int array}
+ *      CSR (or BSR) row pointer and column index arrays for P
+ * Cp : {int array}
+ *      Output array of length n_row + 1
+ * n_row : {int}
+ *      Number of (block) rows of R and C
+ * n_col : {int}
+ *      Number of (block) columns of P and C
+ *
+ * Returns
+ * -------
+ * Cp is modified inplace to the row pointer of C, so that Cp[n_row] is
+ * the length needed for Cj and Cx in galerkin_product_csr(...) or
+ * galerkin_product_bsr(...).
+ *
+ */
+template<class I>
+void galerkin_product_symbolic(const I Rp[], const int Rp_size,
+                               const I Rj[], const int Rj_size,
+                               const I Ap[], const int Ap_size,
+                               const I Aj[], const int Aj_size,
+                               const I Pp[], const int Pp_size,
+                               const I Pj[], const int Pj_size,
+                                     I Cp[], const int Cp_size,
+                               const I n_row,
+                               const I n_col)
+{
+    #pragma omp parallel
+    {
+        // mask[l] == i if column l is already counted in row i
+        std::vector<I> mask(n_col, -1);
+
+        #pragma omp for schedule(static)
+        for(I i = 0; i < n_row; i++){
+            I length = 0;
+            for(I rr = Rp[i]; rr < Rp[i+1]; rr++){
+                const I k = Rj[rr];
+                for(I aa = Ap[k]; aa < Ap[k+1]; aa++){
+                    const I j = Aj[aa];
+                    for(I pp = Pp[j]; pp < Pp[j+1]; pp++){
+                        const I l = Pj[pp];
+                        if(mask[l] != i){
+                            mask[l] = i;
+                            length++;
+                        }
+                    }
+                }
+            }
+            Cp[i+1] = length;
+        }
+    }
+
+    Cp[0] = 0;
+    cumulative_sum(Cp, n_row + 1);
+}
+
+
+/*
+ * Numeric phase of the Galerkin product C = R*A*P for CSR matrices,
+ * computed row by row without forming A*P or R*A.
+ *
+ * Parameters
+ * ----------
+ * Rp, Rj, Rx : {int, int, float|complex array}
+ *      CSR representation of R, with n_row rows
+ * Ap, Aj, Ax : {int, int, float|complex array}
+ *      CSR representation of A
+ * Pp, Pj, Px : {int, int, float|complex array}
+ *      CSR representation of P, with n_col columns
+ * Cp : {int array}
+ *      Row pointer of C, computed by galerkin_product_symbolic(...)
+ * Cj, Cx : {int, float|complex array}
+ *      Output arrays of length Cp[n_row]
+ * n_row : {int}
+ *      Number of rows of R and C
+ * n_col : {int}
+ *      Number of columns of P and C
+ *
+ * Returns
+ * -------
+ * Cj and Cx are modified inplace to the column indices and values of
+ * C = R*A*P, with sorted column indices in each row.
+ *
+ * Notes
+ * -----
+ * Row i of C accumulates R(i,k)*A(k,j)*P(j,:) over the nonzeros of row
+ * i of R and row k of A, so the memory used beyond C is a marker and an
+ * accumulator of length n_col per thread, instead of the intermediate
+ * A*P.  The columns of each row are then sorted.  The rows of C are
+ * computed in parallel, and each entry of C is summed in the same order
+ * for any number of threads.
+ *
+ * If P is a tentative prolongator, with one nonzero per row, then row
+ * i of C sums the rows of A over the aggregate i, and each product
+ * R(i,k)*A(k,j) contributes to the single column of C given by the
+ * aggregate of j.  For a smoothed prolongator, the rows of A*P are
+ * recomputed for each row of R that they contribute to, which trades
+ * some arithmetic for not storing A*P.
+ *
+ * C holds every structural nonzero of R*A*P, including those that cancel
+ * to exactly zero, so that its pattern is the one counted by
+ * galerkin_product_symbolic(...).  galerkin_product(...) in utils.py
+ * drops the zeros afterwards, as the scipy product does.
+ *
+ * The indices of R, A and P need not be sorted.
+ *
+ * Examples
+ * --------
+ * >>> from pyamg.amg_core import galerkin_product_symbolic
+ * >>> from pyamg.amg_core import galerkin_product_csr
+ * >>> import numpy as np
+ * >>> from scipy.sparse import csr_matrix
+ * >>> A = csr_matrix([[2., -1., 0.], [-1., 2., -1.], [0., -1., 2.]])
+ * >>> P = csr_matrix([[1., 0.], [1., 0.], [0., 1.]])
+ * >>> R = P.T.tocsr()
+ * >>> Cp = np.empty(3, dtype=np.intc)
+ * >>> galerkin_product_symbolic(R.indptr, R.indices, A.indptr, A.indices,
+ * ...                           P.indptr, P.indices, Cp, 2, 2)
+ * >>> Cj = np.empty(Cp[-1], dtype=np.intc)
+ * >>> Cx = np.empty(Cp[-1])
+ * >>> galerkin_product_csr(R.indptr, R.indices, R.data, A.indptr,
+ * ...                      A.indices, A.data, P.indptr, P.indices, P.data,
+ * ...                      Cp, Cj, Cx, 2, 2)
+ * >>> print(csr_matrix((Cx, Cj, Cp), shape=(2, 2)).toarray())
+ * [[ 2. -1.]
+ *  [-1.  2.]]
+ */
+template<class I, class T, class F>
+void galerkin_product_csr(const I Rp[], const int Rp_size,
+                          const I Rj[], const int Rj_size,
+                          const T Rx[], const int Rx_size,
+                          const I Ap[], const int Ap_size,
+                          const I Aj[], const int Aj_size,
+                          const T Ax[], const int Ax_size,
+                          const I Pp[], const int Pp_size,
+                          const I Pj[], const int Pj_size,
+                          const T Px[], const int Px_size,
+                          const I Cp[], const int Cp_size,
+                                I Cj[], const int Cj_size,
+                                T Cx[], const int Cx_size,
+                          const I n_row,
+                          const I n_col)
+{
+    #pragma omp parallel
+    {
+        // mask[l] == i if column l is already in row i, and sums[l] is
+        // then the value of C(i,l) so far
+        std::vector<I> mask(n_col, -1);
+        std::vector<T> sums(n_col);
+
+        #pragma omp for schedule(static)
+        for(I i = 0; i < n_row; i++){
+            I length = Cp[i];
+            for(I rr = Rp[i]; rr < Rp[i+1]; rr++){
+                const I k = Rj[rr];
+                const T r = Rx[rr];
+                for(I aa = Ap[k]; aa < Ap[k+1]; aa++){
+                    const I j = Aj[aa];
+                    const T ra = r*Ax[aa];
+                    for(I pp = Pp[j]; pp < Pp[j+1]; pp++){
+                        const I l = Pj[pp];
+                        if(mask[l] != i){
+                            mask[l] = i;
+                            sums[l] = 0.0;
+                            Cj[length++] = l;
+                        }
+                        sums[l] += ra*Px[pp];
+                    }
+                }
+            }
+
+            std::sort(Cj + Cp[i], Cj + Cp[i+1]);
+            for(I jj = Cp[i]; jj < Cp[i+1]; jj++){
+                Cx[jj] = sums[Cj[jj]];
+            }
+        }
+    }
+}
+
+
+/*
+ * Numeric phase of the Galerkin product C = R*A*P for BSR matrices,
+ * see galerkin_product_csr(...).
+ *
+ * Parameters
+ * ----------
+ * Rp, Rj, Rx : {int, int, float|complex array}
+ *      BSR representation of R, with n_brow block rows of blocks of size
+ *      R_brow x A_brow
+ * Ap, Aj, Ax : {int, int, float|complex array}
+ *      BSR representation of A, with blocks of size A_brow x A_bcol
+ * Pp, Pj, Px : {int, int, float|complex array}
+ *      BSR representation of P, with n_bcol block columns of blocks of
+ *      size A_bcol x P_bcol
+ * Cp : {int array}
+ *      Block row pointer of C, computed by galerkin_product_symbolic(...)
+ * Cj, Cx : {int, float|complex array}
+ *      Output arrays of length Cp[n_brow] and Cp[n_brow]*R_brow*P_bcol
+ * n_brow : {int}
+ *      Number of block rows of R and C
+ * n_bcol : {int}
+ *      Number of block columns of P and C
+ * R_brow, A_brow, A_bcol, P_bcol : {int}
+ *      Block sizes
+ *
+ * Returns
+ * -------
+ * Cj and Cx are modified inplace to the block column indices and the
+ * R_brow x P_bcol blocks, in row major, of C = R*A*P, with sorted block
+ * column indices in each block row.
+ *
+ * Notes
+ * -----
+ * For each block R(i,k)*A(k,j), computed once, the products with the
+ * blocks of row j of P are accumulated into block row i of C.
+ *
+ */
+template<class I, class T, class F>
+void galerkin_product_bsr(const I Rp[], const int Rp_size,
+                          const I Rj[], const int Rj_size,
+                          const T Rx[], const int Rx_size,
+                          const I Ap[], const int Ap_size,
+                          const I Aj[], const int Aj_size,
+                          const T Ax[], const int Ax_size,
+                          const I Pp[], const int Pp_size,
+                          const I Pj[], const int Pj_size,
+                          const T Px[], const int Px_size,
+                          const I Cp[], const int Cp_size,
+                                I Cj[], const int Cj_size,
+                                T Cx[], const int Cx_size,
+                          const I n_brow,
+                          const I n_bcol,
+                          const I R_brow,
+                          const I A_brow,
+                          const I A_bcol,
+                          const I P_bcol)
+{
+    const I R_blocksize = R_brow*A_brow;
+    const I A_blocksize = A_brow*A_bcol;
+    const I P_blocksize = A_bcol*P_bcol;
+    const I C_blocksize = R_brow*P_bcol;
+
+    #pragma omp parallel
+    {
+        // mask[l] == i if block column l is already in block row i, and
+        // sums[l*C_blocksize:(l+1)*C_blocksize] is then the block C(i,l)
+        std::vector<I> mask(n_bcol, -1);
+        std::vector<T> sums(n_bcol*C_blocksize);
+        std::vector<T> RA(R_brow*A_bcol);
+
+        #pragma omp for schedule(static)
+        for(I i = 0; i < n_brow; i++){
+            I length = Cp[i];
+            for(I rr = Rp[i]; rr < Rp[i+1]; rr++){
+                const I k = Rj[rr];
+                for(I aa = Ap[k]; aa < Ap[k+1]; aa++){
+                    const I j = Aj[aa];
+
+                    // RA = R(i,k)*A(k,j)
+                    gemm(&(Rx[rr*R_blocksize]), R_brow, A_brow, 'F',
+                         &(Ax[aa*A_blocksize]), A_brow, A_bcol, 'T',
+                         &(RA[0]), R_brow, A_bcol, 'F', 'T');
+
+                    // C(i,l) += RA*P(j,l)
+                    for(I pp = Pp[j]; pp < Pp[j+1]; pp++){
+                        const I l = Pj[pp];
+                        T * block = &(sums[l*C_blocksize]);
+                        if(mask[l] != i){
+                            mask[l] = i;
+                            std::fill(block, block + C_blocksize, 0);
+                            Cj[length++] = l;
+                        }
+                        gemm(&(RA[0]), R_brow, A_bcol, 'F',
+                             &(Px[pp*P_blocksize]), A_bcol, P_bcol, 'T',
+                             block, R_brow, P_bcol, 'F', 'F');
+                    }
+                }
+            }
+
+            std::sort(Cj + Cp[i], Cj + Cp[i+1]);
+            for(I jj = Cp[i]; jj < Cp[i+1]; jj++){
+                const T * block = &(sums[Cj[jj]*C_blocksize]);
+                std::copy(block, block + C_blocksize, Cx + jj*C_blocksize);
+            }
+        }
+    }
+}
+
+
+/*
+ * Values of the Galerkin product C = R*A*P for CSR matrices in a given
+ * sparsity pattern of C, e.g., the pattern of a previous product with
+ * the same (or fewer) nonzeros in R, A and P.
+ *
+ * Parameters
+ * ----------
+ * Rp, Rj, Rx : {int, int, float|complex array}
+ *      CSR representation of R, with n_row rows
+ * Ap, Aj, Ax : {int, int, float|complex array}
+ *      CSR representation of A
+ * Pp, Pj, Px : {int, int, float|complex array}
+ *      CSR representation of P, with n_col columns
+ * Cp, Cj : {int array}
+ *      CSR row pointer and column indices of the pattern of C
+ * Cx : {float|complex array}
+ *      Output array of length Cp[n_row]
+ * n_row : {int}
+ *      Number of rows of R and C
+ * n_col : {int}
+ *      Number of columns of P and C
+ *
+ * Returns
+ * -------
+ * The number of rows of C with a product R(i,k)*A(k,j)*P(j,l) outside
+ * of the pattern.  If it is 0, Cx is modified inplace to the values of
+ * C = R*A*P in the pattern, which are 0 where no product contributes.
+ * Otherwise, Cx is undefined, and C is to be computed with
+ * galerkin_product_symbolic(...) and galerkin_product_csr(...).
+ *
+ * Notes
+ * -----
+ * This skips the symbolic phase and the sort of the columns of each row
+ * of galerkin_product_csr(...).  Each entry of C is summed in the same
+ * order as there, so that the values are the same as those of
+ * galerkin_product_csr(...) for the entries of its pattern.  The columns
+ * of the pattern need not be sorted.
+ *
+ */
+template<class I, class T, class F>
+I galerkin_product_values_csr(const I Rp[], const int Rp_size,
+                              const I Rj[], const int Rj_size,
+                              const T Rx[], const int Rx_size,
+                              const I Ap[], const int Ap_size,
+                              const I Aj[], const int Aj_size,
+                              const T Ax[], const int Ax_size,
+                              const I Pp[], const int Pp_size,
+                              const I Pj[], const int Pj_size,
+                              const T Px[], const int Px_size,
+                              const I Cp[], const int Cp_size,
+                              const I Cj[], const int Cj_size,
+                                    T Cx[], const int Cx_size,
+                              const I n_row,
+                              const I n_col)
+{
+    I misses = 0;
+
+    #pragma omp parallel
+    {
+        // the position in Cj of each column of the current row, or -1
+        std::vector<I> position(n_col, -1);
+
+        #pragma omp for schedule(static) reduction(+:misses)
+        for(I i = 0; i < n_row; i++){
+            for(I jj = Cp[i]; jj < Cp[i+1]; jj++){
+                position[Cj[jj]] = jj;
+                Cx[jj] = 0.0;
+            }
+
+            bool fits = true;
+            for(I rr = Rp[i]; rr < Rp[i+1] && fits; rr++){
+                const I k = Rj[rr];
+                const T r = Rx[rr];
+                for(I aa = Ap[k]; aa < Ap[k+1] && fits; aa++){
+                    const I j = Aj[aa];
+                    const T ra = r*Ax[aa];
+                    for(I pp = Pp[j]; pp < Pp[j+1]; pp++){
+                        const I jj = position[Pj[pp]];
+                        if(jj == -1){
+                            fits = false;
+                            break;
+                        }
+                        Cx[jj] += ra*Px[pp];
+                    }
+                }
+            }
+            if(!fits){
+                misses++;
+            }
+
+            for(I jj = Cp[i]; jj < Cp[i+1]; jj++){
+                position[Cj[jj]] = -1;
+            }
+        }
+    }
+
+    return misses;
+}
+
+
+/*
+ * Values of the Galerkin product C = R*A*P for BSR matrices in a given
+ * sparsity pattern of C, see galerkin_product_values_csr(...) and
+ * galerkin_product_bsr(...).
+ *
+ * Parameters
+ * ----------
+ * Rp, Rj, Rx : {int, int, float|complex array}
+ *      BSR representation of R, with n_brow block rows of blocks of size
+ *      R_brow x A_brow
+ * Ap, Aj, Ax : {int, int, float|complex array}
+ *      BSR representation of A, with blocks of size A_brow x A_bcol
+ * Pp, Pj, Px : {int, int, float|complex array}
+ *      BSR representation of P, with n_bcol block columns of blocks of
+ *      size A_bcol x P_bcol
+ * Cp, Cj : {int array}
+ *      BSR block row pointer and block column indices of the pattern of C
+ * Cx : {float|complex array}
+ *      Output array of length Cp[n_brow]*R_brow*P_bcol
+ * n_brow : {int}
+ *      Number of block rows of R and C
+ * n_bcol : {int}
+ *      Number of block columns of P and C
+ * R_brow, A_brow, A_bcol, P_bcol : {int}
+ *      Block sizes
+ *
+ * Returns
+ * -------
+ * The number of block rows of C with a block product outside of the
+ * pattern.  If it is 0, Cx is modified inplace to the R_brow x P_bcol
+ * blocks, in row major, of C = R*A*P in the pattern.
+ *
+ */
+template<class I, class T, class F>
+I galerkin_product_values_bsr(const I Rp[], const int Rp_size,
+                              const I Rj[], const int Rj_size,
+                              const T Rx[], const int Rx_size,
+                              const I Ap[], const int Ap_size,
+                              const I Aj[], const int Aj_size,
+                              const T Ax[], const int Ax_size,
+                              const I Pp[], const int Pp_size,
+                              const I Pj[], const int Pj_size,
+                              const T Px[], const int Px_size,
+                              const I Cp[], const int Cp_size,
+                              const I Cj[], const int Cj_size,
+                                    T Cx[], const int Cx_size,
+                              const I n_brow,
+                              const I n_bcol,
+                              const I R_brow,
+                              const I A_brow,
+                              const I A_bcol,
+                              const I P_bcol)
+{
+    const I R_blocksize = R_brow*A_brow;
+    const I A_blocksize = A_brow*A_bcol;
+    const I P_blocksize = A_bcol*P_bcol;
+    const I C_blocksize = R_brow*P_bcol;
+
+    I misses = 0;
+
+    #pragma omp parallel
+    {
+        // the position in Cj of each block column of the current block
+        // row, or -1
+        std::vector<I> position(n_bcol, -1);
+        std::vector<T> RA(R_brow*A_bcol);
+
+        #pragma omp for schedule(static) reduction(+:misses)
+        for(I i = 0; i < n_brow; i++){
+            for(I jj = Cp[i]; jj < Cp[i+1]; jj++){
+                position[Cj[jj]] = jj;
+            }
+            std::fill(Cx + Cp[i]*C_blocksize, Cx + Cp[i+1]*C_blocksize,
+                      static_cast<T>(0.0));
+
+            bool fits = true;
+            for(I rr = Rp[i]; rr < Rp[i+1] && fits; rr++){
+                const I k = Rj[rr];
+                for(I aa = Ap[k]; aa < Ap[k+1] && fits; aa++){
+                    const I j = Aj[aa];
+
+                    // RA = R(i,k)*A(k,j)
+                    gemm(&(Rx[rr*R_blocksize]), R_brow, A_brow, 'F',
+                         &(Ax[aa*A_blocksize]), A_brow, A_bcol, 'T',
+                         &(RA[0]), R_brow, A_bcol, 'F', 'T');
+
+                    // C(i,l) += RA*P(j,l)
+                    for(I pp = Pp[j]; pp < Pp[j+1]; pp++){
+                        const I jj = position[Pj[pp]];
+                        if(jj == -1){
+                            fits = false;
+                            break;
+                        }
+                        gemm(&(RA[0]), R_brow, A_bcol, 'F',
+                             &(Px[pp*P_blocksize]), A_bcol, P_bcol, 'T',
+                             Cx + jj*C_blocksize, R_brow, P_bcol, 'F', 'F');
+                    }
+                }
+            }
+            if(!fits){
+                misses++;
+            }
+
+            for(I jj = Cp[i]; jj < Cp[i+1]; jj++){
+                position[Cj[jj]] = -1;
+            }
+        }
+    }
+
+    return misses;
+}
+
+/*
+ * Compute y = A x, where A is stored in CSR format with delta encoded
+ * column indices, see delta_csr_matrix in pyamg/util/compressed.py.
+ *
+ * The columns of row i are Ab[i] + Ad[Ap[i]] + ... + Ad[jj] for the
+ * entries jj of the row, so the first offset of each row is 0 and the
+ * column indices are decoded on the fly from 16-bit offsets.
+ *
+ * Parameters
+ *      Ap[]    - CSR row pointer
+ *      Ab[]    - column of the first entry of each row
+ *      Ad[]    - offset of each column from the previous one in its row
+ *      Ax[]    - CSR data array
+ *      x[]     - input vector
+ *      y[]     - output vector
+ *
+ * Returns
+ *      Nothing, y will be overwritten
+ *
+ */
+template<class I, class T>
+void csr_delta_matvec(const I Ap[], const int Ap_size,
+                      const I Ab[], const int Ab_size,
+                      const unsigned short Ad[], const int Ad_size,
+                      const T Ax[], const int Ax_size,
+                      const T  x[], const int  x_size,
+                            T  y[], const int  y_size)
+{
+    const I n_row = Ap_size - 1;
+
+    #pragma omp parallel for schedule(static)
+    for(I i = 0; i < n_row; i++){
+        I j = Ab[i];
+        T sum = 0;
+        for(I jj = Ap[i]; jj < Ap[i+1]; jj++){
+            j += Ad[jj];
+            sum += Ax[jj]*x[j];
+        }
+        y[i] = sum;
+    }
+}
+
+
+/*
+ * Compute y = A^H x, where A is stored in CSR format with delta encoded
+ * column indices, see csr_delta_matvec.
+ *
+ * Parameters
+ *      Ap[]    - CSR row pointer
+ *      Ab[]    - column of the first entry of each row
+ *      Ad[]    - offset of each column from the previous one in its row
+ *      Ax[]    - CSR data array
+ *      x[]     - input vector, one entry per row of A
+ *      y[]     - output vector, one entry per column of A
+ *
+ * Returns
+ *      Nothing, y will be overwritten
+ *
+ * Notes
+ *      The rows of A are scattered into y, so this is not threaded.
+ *
+ */
+template<class I, class T>
+void csr_delta_rmatvec(const I Ap[], const int Ap_size,
+                       const I Ab[], const int Ab_size,
+                       const unsigned short Ad[], const int Ad_size,
+                       const T Ax[], const int Ax_size,
+                       const T  x[], const int  x_size,
+                             T  y[], const int  y_size)
+{
+    const I n_row = Ap_size - 1;
+
+    std::fill(y, y + y_size, T(0));
+
+    for(I i = 0; i < n_row; i++){
+        I j = Ab[i];
+        const T xi = x[i];
+        for(I jj = Ap[i]; jj < Ap[i+1]; jj++){
+            j += Ad[jj];
+            y[j] += conjugate(Ax[jj])*xi;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,1279 @@
+// DO NOT EDIT: this file is generated
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/complex.h>
+
+#include "bind_arrays.h"
+#include "bind_threads.h"
+#include "bind_timers.h"
+#include "sparse.h"
+
+namespace py = pybind11;
+
+template<class I, class T, class F>
+void _masked_mat_mult_csr(
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      input_array<I> & Bp,
+      input_array<I> & Bj,
+      input_array<T> & Bx,
+      input_array<I> & Sp,
+      input_array<I> & Sj,
+     output_array<T> & Sx,
+            const I n_row,
+            const I n_col,
+const I dense_max_columns
+                          )
+{
+    auto py_Ap = Ap.unchecked();
+    auto py_Aj = Aj.unchecked();
+    auto py_Ax = Ax.unchecked();
+    auto py_Bp = Bp.unchecked();
+    auto py_Bj = Bj.unchecked();
+    auto py_Bx = Bx.unchecked();
+    auto py_Sp = Sp.unchecked();
+    auto py_Sj = Sj.unchecked();
+    auto py_Sx = Sx.mutable_unchecked();
+    const I *_Ap = py_Ap.data();
+    const I *_Aj = py_Aj.data();
+    const T *_Ax = py_Ax.data();
+    const I *_Bp = py_Bp.data();
+    const I *_Bj = py_Bj.data();
+    const T *_Bx = py_Bx.data();
+    const I *_Sp = py_Sp.data();
+    const I *_Sj = py_Sj.data();
+    T *_Sx = py_Sx.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int Bp_size = array_size(Bp.shape(0));
+    int Bj_size = array_size(Bj.shape(0));
+    int Bx_size = array_size(Bx.shape(0));
+    int Sp_size = array_size(Sp.shape(0));
+    int Sj_size = array_size(Sj.shape(0));
+    int Sx_size = array_size(Sx.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("masked_mat_mult_csr");
+
+    return masked_mat_mult_csr<I, T, F>(
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                      _Bp, Bp_size,
+                      _Bj, Bj_size,
+                      _Bx, Bx_size,
+                      _Sp, Sp_size,
+                      _Sj, Sj_size,
+                      _Sx, Sx_size,
+                    n_row,
+                    n_col,
+        dense_max_columns
+                                        );
+}
+
+template<class I>
+void _masked_mat_mult_symbolic(
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<I> & Bp,
+      input_array<I> & Bj,
+      input_array<I> & Sp,
+      input_array<I> & Sj,
+     output_array<I> & Hp,
+            const I n_row,
+            const I n_col
+                               )
+{
+    auto py_Ap = Ap.unchecked();
+    auto py_Aj = Aj.unchecked();
+    auto py_Bp = Bp.unchecked();
+    auto py_Bj = Bj.unchecked();
+    auto py_Sp = Sp.unchecked();
+    auto py_Sj = Sj.unchecked();
+    auto py_Hp = Hp.mutable_unchecked();
+    const I *_Ap = py_Ap.data();
+    const I *_Aj = py_Aj.data();
+    const I *_Bp = py_Bp.data();
+    const I *_Bj = py_Bj.data();
+    const I *_Sp = py_Sp.data();
+    const I *_Sj = py_Sj.data();
+    I *_Hp = py_Hp.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Bp_size = array_size(Bp.shape(0));
+    int Bj_size = array_size(Bj.shape(0));
+    int Sp_size = array_size(Sp.shape(0));
+    int Sj_size = array_size(Sj.shape(0));
+    int Hp_size = array_size(Hp.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("masked_mat_mult_symbolic");
+
+    return masked_mat_mult_symbolic<I>(
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Bp, Bp_size,
+                      _Bj, Bj_size,
+                      _Sp, Sp_size,
+                      _Sj, Sj_size,
+                      _Hp, Hp_size,
+                    n_row,
+                    n_col
+                                       );
+}
+
+template<class I>
+void _masked_mat_mult_pattern(
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<I> & Bp,
+      input_array<I> & Bj,
+      input_array<I> & Sp,
+      input_array<I> & Sj,
+      input_array<I> & Hp,
+     output_array<I> & Hb,
+     output_array<I> & Hs,
+            const I n_row,
+            const I n_col
+                              )
+{
+    auto py_Ap = Ap.unchecked();
+    auto py_Aj = Aj.unchecked();
+    auto py_Bp = Bp.unchecked();
+    auto py_Bj = Bj.unchecked();
+    auto py_Sp = Sp.unchecked();
+    auto py_Sj = Sj.unchecked();
+    auto py_Hp = Hp.unchecked();
+    auto py_Hb = Hb.mutable_unchecked();
+    auto py_Hs = Hs.mutable_unchecked();
+    const I *_Ap = py_Ap.data();
+    const I *_Aj = py_Aj.data();
+    const I *_Bp = py_Bp.data();
+    const I *_Bj = py_Bj.data();
+    const I *_Sp = py_Sp.data();
+    const I *_Sj = py_Sj.data();
+    const I *_Hp = py_Hp.data();
+    I *_Hb = py_Hb.mutable_data();
+    I *_Hs = py_Hs.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Bp_size = array_size(Bp.shape(0));
+    int Bj_size = array_size(Bj.shape(0));
+    int Sp_size = array_size(Sp.shape(0));
+    int Sj_size = array_size(Sj.shape(0));
+    int Hp_size = array_size(Hp.shape(0));
+    int Hb_size = array_size(Hb.shape(0));
+    int Hs_size = array_size(Hs.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("masked_mat_mult_pattern");
+
+    return masked_mat_mult_pattern<I>(
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Bp, Bp_size,
+                      _Bj, Bj_size,
+                      _Sp, Sp_size,
+                      _Sj, Sj_size,
+                      _Hp, Hp_size,
+                      _Hb, Hb_size,
+                      _Hs, Hs_size,
+                    n_row,
+                    n_col
+                                      );
+}
+
+template<class I, class T, class F>
+void _masked_mat_mult_numeric_csr(
+      input_array<I> & Ap,
+      input_array<T> & Ax,
+      input_array<T> & Bx,
+      input_array<I> & Hp,
+      input_array<I> & Hb,
+      input_array<I> & Hs,
+      input_array<I> & Sp,
+     output_array<T> & Sx,
+            const I n_row
+                                  )
+{
+    auto py_Ap = Ap.unchecked();
+    auto py_Ax = Ax.unchecked();
+    auto py_Bx = Bx.unchecked();
+    auto py_Hp = Hp.unchecked();
+    auto py_Hb = Hb.unchecked();
+    auto py_Hs = Hs.unchecked();
+    auto py_Sp = Sp.unchecked();
+    auto py_Sx = Sx.mutable_unchecked();
+    const I *_Ap = py_Ap.data();
+    const T *_Ax = py_Ax.data();
+    const T *_Bx = py_Bx.data();
+    const I *_Hp = py_Hp.data();
+    const I *_Hb = py_Hb.data();
+    const I *_Hs = py_Hs.data();
+    const I *_Sp = py_Sp.data();
+    T *_Sx = py_Sx.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int Bx_size = array_size(Bx.shape(0));
+    int Hp_size = array_size(Hp.shape(0));
+    int Hb_size = array_size(Hb.shape(0));
+    int Hs_size = array_size(Hs.shape(0));
+    int Sp_size = array_size(Sp.shape(0));
+    int Sx_size = array_size(Sx.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("masked_mat_mult_numeric_csr");
+
+    return masked_mat_mult_numeric_csr<I, T, F>(
+                      _Ap, Ap_size,
+                      _Ax, Ax_size,
+                      _Bx, Bx_size,
+                      _Hp, Hp_size,
+                      _Hb, Hb_size,
+                      _Hs, Hs_size,
+                      _Sp, Sp_size,
+                      _Sx, Sx_size,
+                    n_row
+                                                );
+}
+
+template<class I>
+void _galerkin_product_symbolic(
+      input_array<I> & Rp,
+      input_array<I> & Rj,
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<I> & Pp,
+      input_array<I> & Pj,
+     output_array<I> & Cp,
+            const I n_row,
+            const I n_col
+                                )
+{
+    auto py_Rp = Rp.unchecked();
+    auto py_Rj = Rj.unchecked();
+    auto py_Ap = Ap.unchecked();
+    auto py_Aj = Aj.unchecked();
+    auto py_Pp = Pp.unchecked();
+    auto py_Pj = Pj.unchecked();
+    auto py_Cp = Cp.mutable_unchecked();
+    const I *_Rp = py_Rp.data();
+    const I *_Rj = py_Rj.data();
+    const I *_Ap = py_Ap.data();
+    const I *_Aj = py_Aj.data();
+    const I *_Pp = py_Pp.data();
+    const I *_Pj = py_Pj.data();
+    I *_Cp = py_Cp.mutable_data();
+    int Rp_size = array_size(Rp.shape(0));
+    int Rj_size = array_size(Rj.shape(0));
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Pp_size = array_size(Pp.shape(0));
+    int Pj_size = array_size(Pj.shape(0));
+    int Cp_size = array_size(Cp.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("galerkin_product_symbolic");
+
+    return galerkin_product_symbolic<I>(
+                      _Rp, Rp_size,
+                      _Rj, Rj_size,
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Pp, Pp_size,
+                      _Pj, Pj_size,
+                      _Cp, Cp_size,
+                    n_row,
+                    n_col
+                                        );
+}
+
+template<class I, class T, class F>
+void _galerkin_product_csr(
+      input_array<I> & Rp,
+      input_array<I> & Rj,
+      input_array<T> & Rx,
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      input_array<I> & Pp,
+      input_array<I> & Pj,
+      input_array<T> & Px,
+      input_array<I> & Cp,
+     output_array<I> & Cj,
+     output_array<T> & Cx,
+            const I n_row,
+            const I n_col
+                           )
+{
+    auto py_Rp = Rp.unchecked();
+    auto py_Rj = Rj.unchecked();
+    auto py_Rx = Rx.unchecked();
+    auto py_Ap = Ap.unchecked();
+    auto py_Aj = Aj.unchecked();
+    auto py_Ax = Ax.unchecked();
+    auto py_Pp = Pp.unchecked();
+    auto py_Pj = Pj.unchecked();
+    auto py_Px = Px.unchecked();
+    auto py_Cp = Cp.unchecked();
+    auto py_Cj = Cj.mutable_unchecked();
+    auto py_Cx = Cx.mutable_unchecked();
+    const I *_Rp = py_Rp.data();
+    const I *_Rj = py_Rj.data();
+    const T *_Rx = py_Rx.data();
+    const I *_Ap = py_Ap.data();
+    const I *_Aj = py_Aj.data();
+    const T *_Ax = py_Ax.data();
+    const I *_Pp = py_Pp.data();
+    const I *_Pj = py_Pj.data();
+    const T *_Px = py_Px.data();
+    const I *_Cp = py_Cp.data();
+    I *_Cj = py_Cj.mutable_data();
+    T *_Cx = py_Cx.mutable_data();
+    int Rp_size = array_size(Rp.shape(0));
+    int Rj_size = array_size(Rj.shape(0));
+    int Rx_size = array_size(Rx.shape(0));
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int Pp_size = array_size(Pp.shape(0));
+    int Pj_size = array_size(Pj.shape(0));
+    int Px_size = array_size(Px.shape(0));
+    int Cp_size = array_size(Cp.shape(0));
+    int Cj_size = array_size(Cj.shape(0));
+    int Cx_size = array_size(Cx.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("galerkin_product_csr");
+
+    return galerkin_product_csr<I, T, F>(
+                      _Rp, Rp_size,
+                      _Rj, Rj_size,
+                      _Rx, Rx_size,
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                      _Pp, Pp_size,
+                      _Pj, Pj_size,
+                      _Px, Px_size,
+                      _Cp, Cp_size,
+                      _Cj, Cj_size,
+                      _Cx, Cx_size,
+                    n_row,
+                    n_col
+                                         );
+}
+
+template<class I, class T, class F>
+void _galerkin_product_bsr(
+      input_array<I> & Rp,
+      input_array<I> & Rj,
+      input_array<T> & Rx,
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      input_array<I> & Pp,
+      input_array<I> & Pj,
+      input_array<T> & Px,
+      input_array<I> & Cp,
+     output_array<I> & Cj,
+     output_array<T> & Cx,
+           const I n_brow,
+           const I n_bcol,
+           const I R_brow,
+           const I A_brow,
+           const I A_bcol,
+           const I P_bcol
+                           )
+{
+    auto py_Rp = Rp.unchecked();
+    auto py_Rj = Rj.unchecked();
+    auto py_Rx = Rx.unchecked();
+    auto py_Ap = Ap.unchecked();
+    auto py_Aj = Aj.unchecked();
+    auto py_Ax = Ax.unchecked();
+    auto py_Pp = Pp.unchecked();
+    auto py_Pj = Pj.unchecked();
+    auto py_Px = Px.unchecked();
+    auto py_Cp = Cp.unchecked();
+    auto py_Cj = Cj.mutable_unchecked();
+    auto py_Cx = Cx.mutable_unchecked();
+    const I *_Rp = py_Rp.data();
+    const I *_Rj = py_Rj.data();
+    const T *_Rx = py_Rx.data();
+    const I *_Ap = py_Ap.data();
+    const I *_Aj = py_Aj.data();
+    const T *_Ax = py_Ax.data();
+    const I *_Pp = py_Pp.data();
+    const I *_Pj = py_Pj.data();
+    const T *_Px = py_Px.data();
+    const I *_Cp = py_Cp.data();
+    I *_Cj = py_Cj.mutable_data();
+    T *_Cx = py_Cx.mutable_data();
+    int Rp_size = array_size(Rp.shape(0));
+    int Rj_size = array_size(Rj.shape(0));
+    int Rx_size = array_size(Rx.shape(0));
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int Pp_size = array_size(Pp.shape(0));
+    int Pj_size = array_size(Pj.shape(0));
+    int Px_size = array_size(Px.shape(0));
+    int Cp_size = array_size(Cp.shape(0));
+    int Cj_size = array_size(Cj.shape(0));
+    int Cx_size = array_size(Cx.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("galerkin_product_bsr");
+
+    return galerkin_product_bsr<I, T, F>(
+                      _Rp, Rp_size,
+                      _Rj, Rj_size,
+                      _Rx, Rx_size,
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                      _Pp, Pp_size,
+                      _Pj, Pj_size,
+                      _Px, Px_size,
+                      _Cp, Cp_size,
+                      _Cj, Cj_size,
+                      _Cx, Cx_size,
+                   n_brow,
+                   n_bcol,
+                   R_brow,
+                   A_brow,
+                   A_bcol,
+                   P_bcol
+                                         );
+}
+
+template<class I, class T, class F>
+I _galerkin_product_values_csr(
+      input_array<I> & Rp,
+      input_array<I> & Rj,
+      input_array<T> & Rx,
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      input_array<I> & Pp,
+      input_array<I> & Pj,
+      input_array<T> & Px,
+      input_array<I> & Cp,
+      input_array<I> & Cj,
+     output_array<T> & Cx,
+            const I n_row,
+            const I n_col
+                               )
+{
+    auto py_Rp = Rp.unchecked();
+    auto py_Rj = Rj.unchecked();
+    auto py_Rx = Rx.unchecked();
+    auto py_Ap = Ap.unchecked();
+    auto py_Aj = Aj.unchecked();
+    auto py_Ax = Ax.unchecked();
+    auto py_Pp = Pp.unchecked();
+    auto py_Pj = Pj.unchecked();
+    auto py_Px = Px.unchecked();
+    auto py_Cp = Cp.unchecked();
+    auto py_Cj = Cj.unchecked();
+    auto py_Cx = Cx.mutable_unchecked();
+    const I *_Rp = py_Rp.data();
+    const I *_Rj = py_Rj.data();
+    const T *_Rx = py_Rx.data();
+    const I *_Ap = py_Ap.data();
+    const I *_Aj = py_Aj.data();
+    const T *_Ax = py_Ax.data();
+    const I *_Pp = py_Pp.data();
+    const I *_Pj = py_Pj.data();
+    const T *_Px = py_Px.data();
+    const I *_Cp = py_Cp.data();
+    const I *_Cj = py_Cj.data();
+    T *_Cx = py_Cx.mutable_data();
+    int Rp_size = array_size(Rp.shape(0));
+    int Rj_size = array_size(Rj.shape(0));
+    int Rx_size = array_size(Rx.shape(0));
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int Pp_size = array_size(Pp.shape(0));
+    int Pj_size = array_size(Pj.shape(0));
+    int Px_size = array_size(Px.shape(0));
+    int Cp_size = array_size(Cp.shape(0));
+    int Cj_size = array_size(Cj.shape(0));
+    int Cx_size = array_size(Cx.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("galerkin_product_values_csr");
+
+    return galerkin_product_values_csr<I, T, F>(
+                      _Rp, Rp_size,
+                      _Rj, Rj_size,
+                      _Rx, Rx_size,
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                      _Pp, Pp_size,
+                      _Pj, Pj_size,
+                      _Px, Px_size,
+                      _Cp, Cp_size,
+                      _Cj, Cj_size,
+                      _Cx, Cx_size,
+                    n_row,
+                    n_col
+                                                );
+}
+
+template<class I, class T, class F>
+I _galerkin_product_values_bsr(
+      input_array<I> & Rp,
+      input_array<I> & Rj,
+      input_array<T> & Rx,
+      input_array<I> & Ap,
+      input_array<I> & Aj,
+      input_array<T> & Ax,
+      input_array<I> & Pp,
+      input_array<I> & Pj,
+      input_array<T> & Px,
+      input_array<I> & Cp,
+      input_array<I> & Cj,
+     output_array<T> & Cx,
+           const I n_brow,
+           const I n_bcol,
+           const I R_brow,
+           const I A_brow,
+           const I A_bcol,
+           const I P_bcol
+                               )
+{
+    auto py_Rp = Rp.unchecked();
+    auto py_Rj = Rj.unchecked();
+    auto py_Rx = Rx.unchecked();
+    auto py_Ap = Ap.unchecked();
+    auto py_Aj = Aj.unchecked();
+    auto py_Ax = Ax.unchecked();
+    auto py_Pp = Pp.unchecked();
+    auto py_Pj = Pj.unchecked();
+    auto py_Px = Px.unchecked();
+    auto py_Cp = Cp.unchecked();
+    auto py_Cj = Cj.unchecked();
+    auto py_Cx = Cx.mutable_unchecked();
+    const I *_Rp = py_Rp.data();
+    const I *_Rj = py_Rj.data();
+    const T *_Rx = py_Rx.data();
+    const I *_Ap = py_Ap.data();
+    const I *_Aj = py_Aj.data();
+    const T *_Ax = py_Ax.data();
+    const I *_Pp = py_Pp.data();
+    const I *_Pj = py_Pj.data();
+    const T *_Px = py_Px.data();
+    const I *_Cp = py_Cp.data();
+    const I *_Cj = py_Cj.data();
+    T *_Cx = py_Cx.mutable_data();
+    int Rp_size = array_size(Rp.shape(0));
+    int Rj_size = array_size(Rj.shape(0));
+    int Rx_size = array_size(Rx.shape(0));
+    int Ap_size = array_size(Ap.shape(0));
+    int Aj_size = array_size(Aj.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int Pp_size = array_size(Pp.shape(0));
+    int Pj_size = array_size(Pj.shape(0));
+    int Px_size = array_size(Px.shape(0));
+    int Cp_size = array_size(Cp.shape(0));
+    int Cj_size = array_size(Cj.shape(0));
+    int Cx_size = array_size(Cx.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("galerkin_product_values_bsr");
+
+    return galerkin_product_values_bsr<I, T, F>(
+                      _Rp, Rp_size,
+                      _Rj, Rj_size,
+                      _Rx, Rx_size,
+                      _Ap, Ap_size,
+                      _Aj, Aj_size,
+                      _Ax, Ax_size,
+                      _Pp, Pp_size,
+                      _Pj, Pj_size,
+                      _Px, Px_size,
+                      _Cp, Cp_size,
+                      _Cj, Cj_size,
+                      _Cx, Cx_size,
+                   n_brow,
+                   n_bcol,
+                   R_brow,
+                   A_brow,
+                   A_bcol,
+                   P_bcol
+                                                );
+}
+
+template<class I, class T>
+void _csr_delta_matvec(
+      input_array<I> & Ap,
+      input_array<I> & Ab,
+input_array<unsigned short> & Ad,
+      input_array<T> & Ax,
+       input_array<T> & x,
+      output_array<T> & y
+                       )
+{
+    auto py_Ap = Ap.unchecked();
+    auto py_Ab = Ab.unchecked();
+    auto py_Ad = Ad.unchecked();
+    auto py_Ax = Ax.unchecked();
+    auto py_x = x.unchecked();
+    auto py_y = y.mutable_unchecked();
+    const I *_Ap = py_Ap.data();
+    const I *_Ab = py_Ab.data();
+    const unsigned short *_Ad = py_Ad.data();
+    const T *_Ax = py_Ax.data();
+    const T *_x = py_x.data();
+    T *_y = py_y.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Ab_size = array_size(Ab.shape(0));
+    int Ad_size = array_size(Ad.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int y_size = array_size(y.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("csr_delta_matvec");
+
+    return csr_delta_matvec<I, T>(
+                      _Ap, Ap_size,
+                      _Ab, Ab_size,
+                      _Ad, Ad_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _y, y_size
+                                  );
+}
+
+template<class I, class T>
+void _csr_delta_rmatvec(
+      input_array<I> & Ap,
+      input_array<I> & Ab,
+input_array<unsigned short> & Ad,
+      input_array<T> & Ax,
+       input_array<T> & x,
+      output_array<T> & y
+                        )
+{
+    auto py_Ap = Ap.unchecked();
+    auto py_Ab = Ab.unchecked();
+    auto py_Ad = Ad.unchecked();
+    auto py_Ax = Ax.unchecked();
+    auto py_x = x.unchecked();
+    auto py_y = y.mutable_unchecked();
+    const I *_Ap = py_Ap.data();
+    const I *_Ab = py_Ab.data();
+    const unsigned short *_Ad = py_Ad.data();
+    const T *_Ax = py_Ax.data();
+    const T *_x = py_x.data();
+    T *_y = py_y.mutable_data();
+    int Ap_size = array_size(Ap.shape(0));
+    int Ab_size = array_size(Ab.shape(0));
+    int Ad_size = array_size(Ad.shape(0));
+    int Ax_size = array_size(Ax.shape(0));
+    int x_size = array_size(x.shape(0));
+    int y_size = array_size(y.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("csr_delta_rmatvec");
+
+    return csr_delta_rmatvec<I, T>(
+                      _Ap, Ap_size,
+                      _Ab, Ab_size,
+                      _Ad, Ad_size,
+                      _Ax, Ax_size,
+                       _x, x_size,
+                       _y, y_size
+                                   );
+}
+
+PYBIND11_MODULE(sparse, m) {
+    m.doc() = R"pbdoc(
+    Pybind11 bindings for sparse.h
+
+    Methods
+    -------
+    masked_mat_mult_csr
+    masked_mat_mult_symbolic
+    masked_mat_mult_pattern
+    masked_mat_mult_numeric_csr
+    galerkin_product_symbolic
+    galerkin_product_csr
+    galerkin_product_bsr
+    galerkin_product_values_csr
+    galerkin_product_values_bsr
+    csr_delta_matvec
+    csr_delta_rmatvec
+    )pbdoc";
+
+    py::options options;
+    options.disable_function_signatures();
+
+    share_num_threads();
+
+    m.def("_kernel_timers", &swap_kernel_timers, py::arg("enable"),
+R"pbdoc(
+Return and reset the kernel timers of the calling thread, and enable or
+disable them for subsequent calls, see bind_timers.h.)pbdoc");
+
+    m.def("masked_mat_mult_csr", &_masked_mat_mult_csr<int, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Bp"), py::arg("Bj"), py::arg("Bx"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert(), py::arg("n_row"), py::arg("n_col"), py::arg("dense_max_columns"));
+    m.def("masked_mat_mult_csr", &_masked_mat_mult_csr<int, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Bp"), py::arg("Bj"), py::arg("Bx"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert(), py::arg("n_row"), py::arg("n_col"), py::arg("dense_max_columns"));
+    m.def("masked_mat_mult_csr", &_masked_mat_mult_csr<int, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Bp"), py::arg("Bj"), py::arg("Bx"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert(), py::arg("n_row"), py::arg("n_col"), py::arg("dense_max_columns"));
+    m.def("masked_mat_mult_csr", &_masked_mat_mult_csr<int, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Bp"), py::arg("Bj"), py::arg("Bx"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert(), py::arg("n_row"), py::arg("n_col"), py::arg("dense_max_columns"));
+    m.def("masked_mat_mult_csr", &_masked_mat_mult_csr<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Bp"), py::arg("Bj"), py::arg("Bx"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert(), py::arg("n_row"), py::arg("n_col"), py::arg("dense_max_columns"));
+    m.def("masked_mat_mult_csr", &_masked_mat_mult_csr<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Bp"), py::arg("Bj"), py::arg("Bx"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert(), py::arg("n_row"), py::arg("n_col"), py::arg("dense_max_columns"));
+    m.def("masked_mat_mult_csr", &_masked_mat_mult_csr<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Bp"), py::arg("Bj"), py::arg("Bx"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert(), py::arg("n_row"), py::arg("n_col"), py::arg("dense_max_columns"));
+    m.def("masked_mat_mult_csr", &_masked_mat_mult_csr<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Bp"), py::arg("Bj"), py::arg("Bx"), py::arg("Sp"), py::arg("Sj"), py::arg("Sx").noconvert(), py::arg("n_row"), py::arg("n_col"), py::arg("dense_max_columns"),
+R"pbdoc(
+Calculate A*B = S, but only at the pre-existing sparsity
+pattern of S, i.e. do an exact, but incomplete mat-mat multiply.
+
+A, B and S must all be in CSR and may be rectangular, but the
+indices need not be sorted.
+
+Parameters
+----------
+Ap : {int array}
+     Row pointer array for CSR matrix A
+Aj : {int array}
+     Col index array for CSR matrix A
+Ax : {float|complex array}
+     Value array for CSR matrix A
+Bp : {int array}
+     Row pointer array for CSR matrix B
+Bj : {int array}
+     Col index array for CSR matrix B
+Bx : {float|complex array}
+     Value array for CSR matrix B
+Sp : {int array}
+     Row pointer array for CSR matrix S
+Sj : {int array}
+     Col index array for CSR matrix S
+Sx : {float|complex array}
+     Value array for CSR matrix S
+n_row : {int}
+     Number of rows in A and S
+n_col : {int}
+     Number of columns in B and S
+dense_max_columns : {int}
+     Largest number of columns of S for which the product is always
+     accumulated in a dense table, values < 1 use the default.  A small
+     value forces the hash accumulator, see masked_spgemm(...).
+
+Returns
+-------
+Sx is modified inplace to reflect S(i,k) = <A_{i,:}, B_{:,k}>
+for the entries in the sparsity pattern of S
+
+Notes
+-----
+Unlike incomplete_mat_mult_csr(...), B is in CSR, and the product is
+accumulated row by row with masked_spgemm(...), in parallel over the
+rows of S.  If the rows of A are sorted, the result is identical to
+incomplete_mat_mult_csr(...).
+
+Principle calling routine is evolution_strength_of_connection in
+strength.py.
+
+Examples
+--------
+>>> from pyamg.amg_core import masked_mat_mult_csr
+>>> import numpy as np
+>>> from scipy.sparse import csr_matrix
+>>>
+>>> A = csr_matrix(np.arange(1,10,dtype=float).reshape(3,3))
+>>> B = csr_matrix(np.ones((3,3),dtype=float))
+>>> AB = csr_matrix(np.eye(3,3,dtype=float))
+>>> masked_mat_mult_csr(A.indptr, A.indices, A.data, B.indptr, B.indices,
+...                     B.data, AB.indptr, AB.indices, AB.data, 3, 3, 0)
+>>> print(AB.toarray())
+[[ 6.  0.  0.]
+ [ 0. 15.  0.]
+ [ 0.  0. 24.]])pbdoc");
+
+    m.def("masked_mat_mult_symbolic", &_masked_mat_mult_symbolic<int>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Bp"), py::arg("Bj"), py::arg("Sp"), py::arg("Sj"), py::arg("Hp").noconvert(), py::arg("n_row"), py::arg("n_col"));
+    m.def("masked_mat_mult_symbolic", &_masked_mat_mult_symbolic<int64_t>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Bp"), py::arg("Bj"), py::arg("Sp"), py::arg("Sj"), py::arg("Hp").noconvert(), py::arg("n_row"), py::arg("n_col"),
+R"pbdoc(
+Symbolic phase of a masked matrix-matrix multiply S = A*B, for
+repeated products with the same sparsity patterns of A, B and S.
+
+This first pass counts the products A(i,j)*B(j,k) that land in the
+sparsity pattern of S for each nonzero A(i,j).  The second pass,
+masked_mat_mult_pattern(...), records those products, and then
+masked_mat_mult_numeric_csr(...) computes S from the values of A and B.
+
+Parameters
+----------
+Ap, Aj : {int array}
+     CSR row pointer and column index arrays for A
+Bp, Bj : {int array}
+     CSR row pointer and column index arrays for B
+Sp, Sj : {int array}
+     CSR row pointer and column index arrays for S
+Hp : {int array}
+     Output array of length nnz(A) + 1
+n_row : {int}
+     Number of rows in A and S
+n_col : {int}
+     Number of columns in B and S
+
+Returns
+-------
+Hp is modified inplace, so that the products for the nonzero a of A
+are Hp[a], ..., Hp[a+1]-1.  Hp[nnz(A)] is the total number of
+products, which is the length needed for Hb and Hs in
+masked_mat_mult_pattern(...).)pbdoc");
+
+    m.def("masked_mat_mult_pattern", &_masked_mat_mult_pattern<int>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Bp"), py::arg("Bj"), py::arg("Sp"), py::arg("Sj"), py::arg("Hp"), py::arg("Hb").noconvert(), py::arg("Hs").noconvert(), py::arg("n_row"), py::arg("n_col"));
+    m.def("masked_mat_mult_pattern", &_masked_mat_mult_pattern<int64_t>,
+        py::arg("Ap"), py::arg("Aj"), py::arg("Bp"), py::arg("Bj"), py::arg("Sp"), py::arg("Sj"), py::arg("Hp"), py::arg("Hb").noconvert(), py::arg("Hs").noconvert(), py::arg("n_row"), py::arg("n_col"),
+R"pbdoc(
+Second pass of the symbolic phase of a masked matrix-matrix multiply,
+see masked_mat_mult_symbolic(...).
+
+Parameters
+----------
+Ap, Aj : {int array}
+     CSR row pointer and column index arrays for A
+Bp, Bj : {int array}
+     CSR row pointer and column index arrays for B
+Sp, Sj : {int array}
+     CSR row pointer and column index arrays for S
+Hp : {int array}
+     Computed by masked_mat_mult_symbolic(...)
+Hb, Hs : {int array}
+     Output arrays of length Hp[nnz(A)]
+n_row : {int}
+     Number of rows in A and S
+n_col : {int}
+     Number of columns in B and S
+
+Returns
+-------
+Hb and Hs are modified inplace.  For h in Hp[a], ..., Hp[a+1]-1,
+the product of the nonzero a of A with the nonzero Hb[h] of B
+contributes to the nonzero Hs[h] of S.)pbdoc");
+
+    m.def("masked_mat_mult_numeric_csr", &_masked_mat_mult_numeric_csr<int, float, float>,
+        py::arg("Ap"), py::arg("Ax"), py::arg("Bx"), py::arg("Hp"), py::arg("Hb"), py::arg("Hs"), py::arg("Sp"), py::arg("Sx").noconvert(), py::arg("n_row"));
+    m.def("masked_mat_mult_numeric_csr", &_masked_mat_mult_numeric_csr<int, double, double>,
+        py::arg("Ap"), py::arg("Ax"), py::arg("Bx"), py::arg("Hp"), py::arg("Hb"), py::arg("Hs"), py::arg("Sp"), py::arg("Sx").noconvert(), py::arg("n_row"));
+    m.def("masked_mat_mult_numeric_csr", &_masked_mat_mult_numeric_csr<int, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Ax"), py::arg("Bx"), py::arg("Hp"), py::arg("Hb"), py::arg("Hs"), py::arg("Sp"), py::arg("Sx").noconvert(), py::arg("n_row"));
+    m.def("masked_mat_mult_numeric_csr", &_masked_mat_mult_numeric_csr<int, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Ax"), py::arg("Bx"), py::arg("Hp"), py::arg("Hb"), py::arg("Hs"), py::arg("Sp"), py::arg("Sx").noconvert(), py::arg("n_row"));
+    m.def("masked_mat_mult_numeric_csr", &_masked_mat_mult_numeric_csr<int64_t, float, float>,
+        py::arg("Ap"), py::arg("Ax"), py::arg("Bx"), py::arg("Hp"), py::arg("Hb"), py::arg("Hs"), py::arg("Sp"), py::arg("Sx").noconvert(), py::arg("n_row"));
+    m.def("masked_mat_mult_numeric_csr", &_masked_mat_mult_numeric_csr<int64_t, double, double>,
+        py::arg("Ap"), py::arg("Ax"), py::arg("Bx"), py::arg("Hp"), py::arg("Hb"), py::arg("Hs"), py::arg("Sp"), py::arg("Sx").noconvert(), py::arg("n_row"));
+    m.def("masked_mat_mult_numeric_csr", &_masked_mat_mult_numeric_csr<int64_t, std::complex<float>, float>,
+        py::arg("Ap"), py::arg("Ax"), py::arg("Bx"), py::arg("Hp"), py::arg("Hb"), py::arg("Hs"), py::arg("Sp"), py::arg("Sx").noconvert(), py::arg("n_row"));
+    m.def("masked_mat_mult_numeric_csr", &_masked_mat_mult_numeric_csr<int64_t, std::complex<double>, double>,
+        py::arg("Ap"), py::arg("Ax"), py::arg("Bx"), py::arg("Hp"), py::arg("Hb"), py::arg("Hs"), py::arg("Sp"), py::arg("Sx").noconvert(), py::arg("n_row"),
+R"pbdoc(
+Numeric phase of a masked matrix-matrix multiply S = A*B, using the
+products recorded by masked_mat_mult_symbolic(...) and
+masked_mat_mult_pattern(...).
+
+Parameters
+----------
+Ap : {int array}
+     CSR row pointer array for A
+Ax : {float|complex array}
+     CSR value array for A
+Bx : {float|complex array}
+     CSR value array for B
+Hp, Hb, Hs : {int array}
+     Products computed by the symbolic phase
+Sp : {int array}
+     CSR row pointer array for S
+Sx : {float|complex array}
+     CSR value array for S
+n_row : {int}
+     Number of rows in A and S
+
+Returns
+-------
+Sx is modified inplace to reflect S(i,k) = <A_{i,:}, B_{:,k}>
+for the entries in the sparsity pattern of S
+
+Notes
+-----
+A and B must have the same sparsity patterns, in the same order, as
+in the symbolic phase.  The result is identical to
+masked_mat_mult_csr(...).)pbdoc");
+
+    m.def("galerkin_product_symbolic", &_galerkin_product_symbolic<int>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Ap"), py::arg("Aj"), py::arg("Pp"), py::arg("Pj"), py::arg("Cp").noconvert(), py::arg("n_row"), py::arg("n_col"));
+    m.def("galerkin_product_symbolic", &_galerkin_product_symbolic<int64_t>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Ap"), py::arg("Aj"), py::arg("Pp"), py::arg("Pj"), py::arg("Cp").noconvert(), py::arg("n_row"), py::arg("n_col"),
+R"pbdoc(
+Symbolic phase of the Galerkin product C = R*A*P, computed row by row
+without forming A*P or R*A.
+
+Row i of C is the union of the rows P(j,:) over the nonzeros R(i,k)
+and A(k,j).  The rows of C are counted in parallel, each thread with
+its own marker array of length n_col.
+
+Parameters
+----------
+Rp, Rj : {int array}
+     CSR (or BSR) row pointer and column index arrays for R
+Ap, Aj : {int array}
+     CSR (or BSR) row pointer and column index arrays for A
+Pp, Pj : {int array}
+     CSR (or BSR) row pointer and column index arrays for P
+Cp : {int array}
+     Output array of length n_row + 1
+n_row : {int}
+     Number of (block) rows of R and C
+n_col : {int}
+     Number of (block) columns of P and C
+
+Returns
+-------
+Cp is modified inplace to the row pointer of C, so that Cp[n_row] is
+the length needed for Cj and Cx in galerkin_product_csr(...) or
+galerkin_product_bsr(...).)pbdoc");
+
+    m.def("galerkin_product_csr", &_galerkin_product_csr<int, float, float>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Rx"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("Cp"), py::arg("Cj").noconvert(), py::arg("Cx").noconvert(), py::arg("n_row"), py::arg("n_col"));
+    m.def("galerkin_product_csr", &_galerkin_product_csr<int, double, double>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Rx"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("Cp"), py::arg("Cj").noconvert(), py::arg("Cx").noconvert(), py::arg("n_row"), py::arg("n_col"));
+    m.def("galerkin_product_csr", &_galerkin_product_csr<int, std::complex<float>, float>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Rx"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("Cp"), py::arg("Cj").noconvert(), py::arg("Cx").noconvert(), py::arg("n_row"), py::arg("n_col"));
+    m.def("galerkin_product_csr", &_galerkin_product_csr<int, std::complex<double>, double>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Rx"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("Cp"), py::arg("Cj").noconvert(), py::arg("Cx").noconvert(), py::arg("n_row"), py::arg("n_col"));
+    m.def("galerkin_product_csr", &_galerkin_product_csr<int64_t, float, float>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Rx"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("Cp"), py::arg("Cj").noconvert(), py::arg("Cx").noconvert(), py::arg("n_row"), py::arg("n_col"));
+    m.def("galerkin_product_csr", &_galerkin_product_csr<int64_t, double, double>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Rx"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("Cp"), py::arg("Cj").noconvert(), py::arg("Cx").noconvert(), py::arg("n_row"), py::arg("n_col"));
+    m.def("galerkin_product_csr", &_galerkin_product_csr<int64_t, std::complex<float>, float>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Rx"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("Cp"), py::arg("Cj").noconvert(), py::arg("Cx").noconvert(), py::arg("n_row"), py::arg("n_col"));
+    m.def("galerkin_product_csr", &_galerkin_product_csr<int64_t, std::complex<double>, double>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Rx"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("Cp"), py::arg("Cj").noconvert(), py::arg("Cx").noconvert(), py::arg("n_row"), py::arg("n_col"),
+R"pbdoc(
+Numeric phase of the Galerkin product C = R*A*P for CSR matrices,
+computed row by row without forming A*P or R*A.
+
+Parameters
+----------
+Rp, Rj, Rx : {int, int, float|complex array}
+     CSR representation of R, with n_row rows
+Ap, Aj, Ax : {int, int, float|complex array}
+     CSR representation of A
+Pp, Pj, Px : {int, int, float|complex array}
+     CSR representation of P, with n_col columns
+Cp : {int array}
+     Row pointer of C, computed by galerkin_product_symbolic(...)
+Cj, Cx : {int, float|complex array}
+     Output arrays of length Cp[n_row]
+n_row : {int}
+     Number of rows of R and C
+n_col : {int}
+     Number of columns of P and C
+
+Returns
+-------
+Cj and Cx are modified inplace to the column indices and values of
+C = R*A*P, with sorted column indices in each row.
+
+Notes
+-----
+Row i of C accumulates R(i,k)*A(k,j)*P(j,:) over the nonzeros of row
+i of R and row k of A, so the memory used beyond C is a marker and an
+accumulator of length n_col per thread, instead of the intermediate
+A*P.  The columns of each row are then sorted.  The rows of C are
+computed in parallel, and each entry of C is summed in the same order
+for any number of threads.
+
+If P is a tentative prolongator, with one nonzero per row, then row
+i of C sums the rows of A over the aggregate i, and each product
+R(i,k)*A(k,j) contributes to the single column of C given by the
+aggregate of j.  For a smoothed prolongator, the rows of A*P are
+recomputed for each row of R that they contribute to, which trades
+some arithmetic for not storing A*P.
+
+C holds every structural nonzero of R*A*P, including those that cancel
+to exactly zero, so that its pattern is the one counted by
+galerkin_product_symbolic(...).  galerkin_product(...) in utils.py
+drops the zeros afterwards, as the scipy product does.
+
+The indices of R, A and P need not be sorted.
+
+Examples
+--------
+>>> from pyamg.amg_core import galerkin_product_symbolic
+>>> from pyamg.amg_core import galerkin_product_csr
+>>> import numpy as np
+>>> from scipy.sparse import csr_matrix
+>>> A = csr_matrix([[2., -1., 0.], [-1., 2., -1.], [0., -1., 2.]])
+>>> P = csr_matrix([[1., 0.], [1., 0.], [0., 1.]])
+>>> R = P.T.tocsr()
+>>> Cp = np.empty(3, dtype=np.intc)
+>>> galerkin_product_symbolic(R.indptr, R.indices, A.indptr, A.indices,
+...                           P.indptr, P.indices, Cp, 2, 2)
+>>> Cj = np.empty(Cp[-1], dtype=np.intc)
+>>> Cx = np.empty(Cp[-1])
+>>> galerkin_product_csr(R.indptr, R.indices, R.data, A.indptr,
+...                      A.indices, A.data, P.indptr, P.indices, P.data,
+...                      Cp, Cj, Cx, 2, 2)
+>>> print(csr_matrix((Cx, Cj, Cp), shape=(2, 2)).toarray())
+[[ 2. -1.]
+ [-1.  2.]])pbdoc");
+
+    m.def("galerkin_product_bsr", &_galerkin_product_bsr<int, float, float>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Rx"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("Cp"), py::arg("Cj").noconvert(), py::arg("Cx").noconvert(), py::arg("n_brow"), py::arg("n_bcol"), py::arg("R_brow"), py::arg("A_brow"), py::arg("A_bcol"), py::arg("P_bcol"));
+    m.def("galerkin_product_bsr", &_galerkin_product_bsr<int, double, double>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Rx"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("Cp"), py::arg("Cj").noconvert(), py::arg("Cx").noconvert(), py::arg("n_brow"), py::arg("n_bcol"), py::arg("R_brow"), py::arg("A_brow"), py::arg("A_bcol"), py::arg("P_bcol"));
+    m.def("galerkin_product_bsr", &_galerkin_product_bsr<int, std::complex<float>, float>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Rx"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("Cp"), py::arg("Cj").noconvert(), py::arg("Cx").noconvert(), py::arg("n_brow"), py::arg("n_bcol"), py::arg("R_brow"), py::arg("A_brow"), py::arg("A_bcol"), py::arg("P_bcol"));
+    m.def("galerkin_product_bsr", &_galerkin_product_bsr<int, std::complex<double>, double>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Rx"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("Cp"), py::arg("Cj").noconvert(), py::arg("Cx").noconvert(), py::arg("n_brow"), py::arg("n_bcol"), py::arg("R_brow"), py::arg("A_brow"), py::arg("A_bcol"), py::arg("P_bcol"));
+    m.def("galerkin_product_bsr", &_galerkin_product_bsr<int64_t, float, float>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Rx"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("Cp"), py::arg("Cj").noconvert(), py::arg("Cx").noconvert(), py::arg("n_brow"), py::arg("n_bcol"), py::arg("R_brow"), py::arg("A_brow"), py::arg("A_bcol"), py::arg("P_bcol"));
+    m.def("galerkin_product_bsr", &_galerkin_product_bsr<int64_t, double, double>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Rx"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("Cp"), py::arg("Cj").noconvert(), py::arg("Cx").noconvert(), py::arg("n_brow"), py::arg("n_bcol"), py::arg("R_brow"), py::arg("A_brow"), py::arg("A_bcol"), py::arg("P_bcol"));
+    m.def("galerkin_product_bsr", &_galerkin_product_bsr<int64_t, std::complex<float>, float>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Rx"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("Cp"), py::arg("Cj").noconvert(), py::arg("Cx").noconvert(), py::arg("n_brow"), py::arg("n_bcol"), py::arg("R_brow"), py::arg("A_brow"), py::arg("A_bcol"), py::arg("P_bcol"));
+    m.def("galerkin_product_bsr", &_galerkin_product_bsr<int64_t, std::complex<double>, double>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Rx"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("Cp"), py::arg("Cj").noconvert(), py::arg("Cx").noconvert(), py::arg("n_brow"), py::arg("n_bcol"), py::arg("R_brow"), py::arg("A_brow"), py::arg("A_bcol"), py::arg("P_bcol"),
+R"pbdoc(
+Numeric phase of the Galerkin product C = R*A*P for BSR matrices,
+see galerkin_product_csr(...).
+
+Parameters
+----------
+Rp, Rj, Rx : {int, int, float|complex array}
+     BSR representation of R, with n_brow block rows of blocks of size
+     R_brow x A_brow
+Ap, Aj, Ax : {int, int, float|complex array}
+     BSR representation of A, with blocks of size A_brow x A_bcol
+Pp, Pj, Px : {int, int, float|complex array}
+     BSR representation of P, with n_bcol block columns of blocks of
+     size A_bcol x P_bcol
+Cp : {int array}
+     Block row pointer of C, computed by galerkin_product_symbolic(...)
+Cj, Cx : {int, float|complex array}
+     Output arrays of length Cp[n_brow] and Cp[n_brow]*R_brow*P_bcol
+n_brow : {int}
+     Number of block rows of R and C
+n_bcol : {int}
+     Number of block columns of P and C
+R_brow, A_brow, A_bcol, P_bcol : {int}
+     Block sizes
+
+Returns
+-------
+Cj and Cx are modified inplace to the block column indices and the
+R_brow x P_bcol blocks, in row major, of C = R*A*P, with sorted block
+column indices in each block row.
+
+Notes
+-----
+For each block R(i,k)*A(k,j), computed once, the products with the
+blocks of row j of P are accumulated into block row i of C.)pbdoc");
+
+    m.def("galerkin_product_values_csr", &_galerkin_product_values_csr<int, float, float>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Rx"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("Cp"), py::arg("Cj"), py::arg("Cx").noconvert(), py::arg("n_row"), py::arg("n_col"));
+    m.def("galerkin_product_values_csr", &_galerkin_product_values_csr<int, double, double>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Rx"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("Cp"), py::arg("Cj"), py::arg("Cx").noconvert(), py::arg("n_row"), py::arg("n_col"));
+    m.def("galerkin_product_values_csr", &_galerkin_product_values_csr<int, std::complex<float>, float>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Rx"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("Cp"), py::arg("Cj"), py::arg("Cx").noconvert(), py::arg("n_row"), py::arg("n_col"));
+    m.def("galerkin_product_values_csr", &_galerkin_product_values_csr<int, std::complex<double>, double>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Rx"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("Cp"), py::arg("Cj"), py::arg("Cx").noconvert(), py::arg("n_row"), py::arg("n_col"));
+    m.def("galerkin_product_values_csr", &_galerkin_product_values_csr<int64_t, float, float>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Rx"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("Cp"), py::arg("Cj"), py::arg("Cx").noconvert(), py::arg("n_row"), py::arg("n_col"));
+    m.def("galerkin_product_values_csr", &_galerkin_product_values_csr<int64_t, double, double>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Rx"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("Cp"), py::arg("Cj"), py::arg("Cx").noconvert(), py::arg("n_row"), py::arg("n_col"));
+    m.def("galerkin_product_values_csr", &_galerkin_product_values_csr<int64_t, std::complex<float>, float>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Rx"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("Cp"), py::arg("Cj"), py::arg("Cx").noconvert(), py::arg("n_row"), py::arg("n_col"));
+    m.def("galerkin_product_values_csr", &_galerkin_product_values_csr<int64_t, std::complex<double>, double>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Rx"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("Cp"), py::arg("Cj"), py::arg("Cx").noconvert(), py::arg("n_row"), py::arg("n_col"),
+R"pbdoc(
+Values of the Galerkin product C = R*A*P for CSR matrices in a given
+sparsity pattern of C, e.g., the pattern of a previous product with
+the same (or fewer) nonzeros in R, A and P.
+
+Parameters
+----------
+Rp, Rj, Rx : {int, int, float|complex array}
+     CSR representation of R, with n_row rows
+Ap, Aj, Ax : {int, int, float|complex array}
+     CSR representation of A
+Pp, Pj, Px : {int, int, float|complex array}
+     CSR representation of P, with n_col columns
+Cp, Cj : {int array}
+     CSR row pointer and column indices of the pattern of C
+Cx : {float|complex array}
+     Output array of length Cp[n_row]
+n_row : {int}
+     Number of rows of R and C
+n_col : {int}
+     Number of columns of P and C
+
+Returns
+-------
+The number of rows of C with a product R(i,k)*A(k,j)*P(j,l) outside
+of the pattern.  If it is 0, Cx is modified inplace to the values of
+C = R*A*P in the pattern, which are 0 where no product contributes.
+Otherwise, Cx is undefined, and C is to be computed with
+galerkin_product_symbolic(...) and galerkin_product_csr(...).
+
+Notes
+-----
+This skips the symbolic phase and the sort of the columns of each row
+of galerkin_product_csr(...).  Each entry of C is summed in the same
+order as there, so that the values are the same as those of
+galerkin_product_csr(...) for the entries of its pattern.  The columns
+of the pattern need not be sorted.)pbdoc");
+
+    m.def("galerkin_product_values_bsr", &_galerkin_product_values_bsr<int, float, float>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Rx"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("Cp"), py::arg("Cj"), py::arg("Cx").noconvert(), py::arg("n_brow"), py::arg("n_bcol"), py::arg("R_brow"), py::arg("A_brow"), py::arg("A_bcol"), py::arg("P_bcol"));
+    m.def("galerkin_product_values_bsr", &_galerkin_product_values_bsr<int, double, double>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Rx"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("Cp"), py::arg("Cj"), py::arg("Cx").noconvert(), py::arg("n_brow"), py::arg("n_bcol"), py::arg("R_brow"), py::arg("A_brow"), py::arg("A_bcol"), py::arg("P_bcol"));
+    m.def("galerkin_product_values_bsr", &_galerkin_product_values_bsr<int, std::complex<float>, float>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Rx"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("Cp"), py::arg("Cj"), py::arg("Cx").noconvert(), py::arg("n_brow"), py::arg("n_bcol"), py::arg("R_brow"), py::arg("A_brow"), py::arg("A_bcol"), py::arg("P_bcol"));
+    m.def("galerkin_product_values_bsr", &_galerkin_product_values_bsr<int, std::complex<double>, double>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Rx"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("Cp"), py::arg("Cj"), py::arg("Cx").noconvert(), py::arg("n_brow"), py::arg("n_bcol"), py::arg("R_brow"), py::arg("A_brow"), py::arg("A_bcol"), py::arg("P_bcol"));
+    m.def("galerkin_product_values_bsr", &_galerkin_product_values_bsr<int64_t, float, float>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Rx"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("Cp"), py::arg("Cj"), py::arg("Cx").noconvert(), py::arg("n_brow"), py::arg("n_bcol"), py::arg("R_brow"), py::arg("A_brow"), py::arg("A_bcol"), py::arg("P_bcol"));
+    m.def("galerkin_product_values_bsr", &_galerkin_product_values_bsr<int64_t, double, double>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Rx"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("Cp"), py::arg("Cj"), py::arg("Cx").noconvert(), py::arg("n_brow"), py::arg("n_bcol"), py::arg("R_brow"), py::arg("A_brow"), py::arg("A_bcol"), py::arg("P_bcol"));
+    m.def("galerkin_product_values_bsr", &_galerkin_product_values_bsr<int64_t, std::complex<float>, float>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Rx"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("Cp"), py::arg("Cj"), py::arg("Cx").noconvert(), py::arg("n_brow"), py::arg("n_bcol"), py::arg("R_brow"), py::arg("A_brow"), py::arg("A_bcol"), py::arg("P_bcol"));
+    m.def("galerkin_product_values_bsr", &_galerkin_product_values_bsr<int64_t, std::complex<double>, double>,
+        py::arg("Rp"), py::arg("Rj"), py::arg("Rx"), py::arg("Ap"), py::arg("Aj"), py::arg("Ax"), py::arg("Pp"), py::arg("Pj"), py::arg("Px"), py::arg("Cp"), py::arg("Cj"), py::arg("Cx").noconvert(), py::arg("n_brow"), py::arg("n_bcol"), py::arg("R_brow"), py::arg("A_brow"), py::arg("A_bcol"), py::arg("P_bcol"),
+R"pbdoc(
+Values of the Galerkin product C = R*A*P for BSR matrices in a given
+sparsity pattern of C, see galerkin_product_values_csr(...) and
+galerkin_product_bsr(...).
+
+Parameters
+----------
+Rp, Rj, Rx : {int, int, float|complex array}
+     BSR representation of R, with n_brow block rows of blocks of size
+     R_brow x A_brow
+Ap, Aj, Ax : {int, int, float|complex array}
+     BSR representation of A, with blocks of size A_brow x A_bcol
+Pp, Pj, Px : {int, int, float|complex array}
+     BSR representation of P, with n_bcol block columns of blocks of
+     size A_bcol x P_bcol
+Cp, Cj : {int array}
+     BSR block row pointer and block column indices of the pattern of C
+Cx : {float|complex array}
+     Output array of length Cp[n_brow]*R_brow*P_bcol
+n_brow : {int}
+     Number of block rows of R and C
+n_bcol : {int}
+     Number of block columns of P and C
+R_brow, A_brow, A_bcol, P_bcol : {int}
+     Block sizes
+
+Returns
+-------
+The number of block rows of C with a block product outside of the
+pattern.  If it is 0, Cx is modified inplace to the R_brow x P_bcol
+blocks, in row major, of C = R*A*P in the pattern.)pbdoc");
+
+    m.def("csr_delta_matvec", &_csr_delta_matvec<int, float>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x"), py::arg("y").noconvert());
+    m.def("csr_delta_matvec", &_csr_delta_matvec<int, double>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x"), py::arg("y").noconvert());
+    m.def("csr_delta_matvec", &_csr_delta_matvec<int, std::complex<float>>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x"), py::arg("y").noconvert());
+    m.def("csr_delta_matvec", &_csr_delta_matvec<int, std::complex<double>>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x"), py::arg("y").noconvert());
+    m.def("csr_delta_matvec", &_csr_delta_matvec<int64_t, float>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x"), py::arg("y").noconvert());
+    m.def("csr_delta_matvec", &_csr_delta_matvec<int64_t, double>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x"), py::arg("y").noconvert());
+    m.def("csr_delta_matvec", &_csr_delta_matvec<int64_t, std::complex<float>>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x"), py::arg("y").noconvert());
+    m.def("csr_delta_matvec", &_csr_delta_matvec<int64_t, std::complex<double>>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x"), py::arg("y").noconvert(),
+R"pbdoc(
+Compute y = A x, where A is stored in CSR format with delta encoded
+column indices, see delta_csr_matrix in pyamg/util/compressed.py.
+
+The columns of row i are Ab[i] + Ad[Ap[i]] + ... + Ad[jj] for the
+entries jj of the row, so the first offset of each row is 0 and the
+column indices are decoded on the fly from 16-bit offsets.
+
+Parameters
+     Ap[]    - CSR row pointer
+     Ab[]    - column of the first entry of each row
+     Ad[]    - offset of each column from the previous one in its row
+     Ax[]    - CSR data array
+     x[]     - input vector
+     y[]     - output vector
+
+Returns
+     Nothing, y will be overwritten)pbdoc");
+
+    m.def("csr_delta_rmatvec", &_csr_delta_rmatvec<int, float>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x"), py::arg("y").noconvert());
+    m.def("csr_delta_rmatvec", &_csr_delta_rmatvec<int, double>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x"), py::arg("y").noconvert());
+    m.def("csr_delta_rmatvec", &_csr_delta_rmatvec<int, std::complex<float>>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x"), py::arg("y").noconvert());
+    m.def("csr_delta_rmatvec", &_csr_delta_rmatvec<int, std::complex<double>>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x"), py::arg("y").noconvert());
+    m.def("csr_delta_rmatvec", &_csr_delta_rmatvec<int64_t, float>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x"), py::arg("y").noconvert());
+    m.def("csr_delta_rmatvec", &_csr_delta_rmatvec<int64_t, double>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x"), py::arg("y").noconvert());
+    m.def("csr_delta_rmatvec", &_csr_delta_rmatvec<int64_t, std::complex<float>>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x"), py::arg("y").noconvert());
+    m.def("csr_delta_rmatvec", &_csr_delta_rmatvec<int64_t, std::complex<double>>,
+        py::arg("Ap"), py::arg("Ab"), py::arg("Ad"), py::arg("Ax"), py::arg("x"), py::arg("y").noconvert(),
+R"pbdoc(
+Compute y = A^H x, where A is stored in CSR format with delta encoded
+column indices, see csr_delta_matvec.
+
+Parameters
+     Ap[]    - CSR row pointer
+     Ab[]    - column of the first entry of each row
+     Ad[]    - offset of each column from the previous one in its row
+     Ax[]    - CSR data array
+     x[]     - input vector, one entry per row of A
+     y[]     - output vector, one entry per column of A
+
+Returns
+     Nothing, y will be overwritten
+
+Notes
+     The rows of A are scattered into y, so this is not threaded.)pbdoc");
+
+}
+
@@ -0,0 +1,67 @@
+#include "linalg.h"
+
+//
+// The dense kernels of linalg.h and their scalar references, for the
+// comparisons in test_linalg_examples.py.  Each function writes the result
+// of the kernel to its first output, and that of the reference to the
+// second.
+//
+
+/* z[0] = dot_prod(x, y), z[1] = dot_prod_ref(x, y) */
+template <class I, class T, class F>
+void test_dot_prod(const T x[], const int x_size,
+                   const T y[], const int y_size,
+                         T z[], const int z_size)
+{
+    z[0] = dot_prod(x, y, (I) x_size);
+    z[1] = dot_prod_ref(x, y, (I) x_size);
+}
+
+/* z[0] = norm(x), z[1] = norm_ref(x) */
+template <class I, class T, class F>
+void test_norm(const T x[], const int x_size,
+                     F z[], const int z_size)
+{
+    norm(x, (I) x_size, z[0]);
+    norm_ref(x, (I) x_size, z[1]);
+}
+
+/* x += alpha[0]*y with axpy, and x_ref += alpha[0]*y with axpy_ref */
+template <class I, class T, class F>
+void test_axpy(      T x[], const int x_size,
+                     T x_ref[], const int x_ref_size,
+               const T y[], const int y_size,
+               const T alpha[], const int alpha_size)
+{
+    axpy(x, y, alpha[0], (I) x_size);
+    axpy_ref(x_ref, y, alpha[0], (I) x_size);
+}
+
+/*
+ * S = A B with gemm, and S_ref = A B with gemm_ref, for A of Arows x
+ * Acols in row major.  B is in row major if Btrans is nonzero, and in
+ * column major otherwise.  S is in column major if Strans is nonzero, and
+ * in row major otherwise.  S and S_ref are overwritten if overwrite is
+ * nonzero, and accumulated to otherwise.
+ */
+template <class I, class T, class F>
+void test_gemm(const T Ax[], const int Ax_size,
+               const I Arows,
+               const I Acols,
+               const T Bx[], const int Bx_size,
+               const I Bcols,
+               const I Btrans,
+                     T Sx[], const int Sx_size,
+                     T S_ref[], const int S_ref_size,
+               const I Strans,
+               const I overwrite)
+{
+    const char B_order = Btrans ? 'T' : 'F';
+    const char S_order = Strans ? 'T' : 'F';
+    const char over = overwrite ? 'T' : 'F';
+
+    gemm(Ax, Arows, Acols, 'F', Bx, Acols, Bcols, B_order,
+         Sx, Arows, Bcols, S_order, over);
+    gemm_ref(Ax, Arows, Acols, 'F', Bx, Acols, Bcols, B_order,
+             S_ref, Arows, Bcols, S_order, over);
+}
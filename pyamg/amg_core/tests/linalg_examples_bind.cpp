@@ -0,0 +1,214 @@
+// DO NOT EDIT: this file is generated
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/complex.h>
+
+#include "bind_arrays.h"
+#include "bind_threads.h"
+#include "bind_timers.h"
+#include "linalg_examples.h"
+
+namespace py = pybind11;
+
+template <class I, class T, class F>
+void _test_dot_prod(
+       input_array<T> & x,
+       input_array<T> & y,
+      output_array<T> & z
+                    )
+{
+    auto py_x = x.unchecked();
+    auto py_y = y.unchecked();
+    auto py_z = z.mutable_unchecked();
+    const T *_x = py_x.data();
+    const T *_y = py_y.data();
+    T *_z = py_z.mutable_data();
+    int x_size = array_size(x.shape(0));
+    int y_size = array_size(y.shape(0));
+    int z_size = array_size(z.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("test_dot_prod");
+
+    return test_dot_prod <I, T, F>(
+                       _x, x_size,
+                       _y, y_size,
+                       _z, z_size
+                                   );
+}
+
+template <class I, class T, class F>
+void _test_norm(
+       input_array<T> & x,
+      output_array<F> & z
+                )
+{
+    auto py_x = x.unchecked();
+    auto py_z = z.mutable_unchecked();
+    const T *_x = py_x.data();
+    F *_z = py_z.mutable_data();
+    int x_size = array_size(x.shape(0));
+    int z_size = array_size(z.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("test_norm");
+
+    return test_norm <I, T, F>(
+                       _x, x_size,
+                       _z, z_size
+                               );
+}
+
+template <class I, class T, class F>
+void _test_axpy(
+      output_array<T> & x,
+  output_array<T> & x_ref,
+       input_array<T> & y,
+   input_array<T> & alpha
+                )
+{
+    auto py_x = x.mutable_unchecked();
+    auto py_x_ref = x_ref.mutable_unchecked();
+    auto py_y = y.unchecked();
+    auto py_alpha = alpha.unchecked();
+    T *_x = py_x.mutable_data();
+    T *_x_ref = py_x_ref.mutable_data();
+    const T *_y = py_y.data();
+    const T *_alpha = py_alpha.data();
+    int x_size = array_size(x.shape(0));
+    int x_ref_size = array_size(x_ref.shape(0));
+    int y_size = array_size(y.shape(0));
+    int alpha_size = array_size(alpha.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("test_axpy");
+
+    return test_axpy <I, T, F>(
+                       _x, x_size,
+                   _x_ref, x_ref_size,
+                       _y, y_size,
+                   _alpha, alpha_size
+                               );
+}
+
+template <class I, class T, class F>
+void _test_gemm(
+      input_array<T> & Ax,
+            const I Arows,
+            const I Acols,
+      input_array<T> & Bx,
+            const I Bcols,
+           const I Btrans,
+     output_array<T> & Sx,
+  output_array<T> & S_ref,
+           const I Strans,
+        const I overwrite
+                )
+{
+    auto py_Ax = Ax.unchecked();
+    auto py_Bx = Bx.unchecked();
+    auto py_Sx = Sx.mutable_unchecked();
+    auto py_S_ref = S_ref.mutable_unchecked();
+    const T *_Ax = py_Ax.data();
+    const T *_Bx = py_Bx.data();
+    T *_Sx = py_Sx.mutable_data();
+    T *_S_ref = py_S_ref.mutable_data();
+    int Ax_size = array_size(Ax.shape(0));
+    int Bx_size = array_size(Bx.shape(0));
+    int Sx_size = array_size(Sx.shape(0));
+    int S_ref_size = array_size(S_ref.shape(0));
+
+    py::gil_scoped_release release;
+    apply_num_threads();
+    kernel_timer timer("test_gemm");
+
+    return test_gemm <I, T, F>(
+                      _Ax, Ax_size,
+                    Arows,
+                    Acols,
+                      _Bx, Bx_size,
+                    Bcols,
+                   Btrans,
+                      _Sx, Sx_size,
+                   _S_ref, S_ref_size,
+                   Strans,
+                overwrite
+                               );
+}
+
+PYBIND11_MODULE(linalg_examples, m) {
+    m.doc() = R"pbdoc(
+    Pybind11 bindings for linalg_examples.h
+
+    Methods
+    -------
+    test_dot_prod
+    test_norm
+    test_axpy
+    test_gemm
+    )pbdoc";
+
+    py::options options;
+    options.disable_function_signatures();
+
+    share_num_threads();
+
+    m.def("_kernel_timers", &swap_kernel_timers, py::arg("enable"),
+R"pbdoc(
+Return and reset the kernel timers of the calling thread, and enable or
+disable them for subsequent calls, see bind_timers.h.)pbdoc");
+
+    m.def("test_dot_prod", &_test_dot_prod<int, float, float>,
+        py::arg("x"), py::arg("y"), py::arg("z").noconvert());
+    m.def("test_dot_prod", &_test_dot_prod<int, double, double>,
+        py::arg("x"), py::arg("y"), py::arg("z").noconvert());
+    m.def("test_dot_prod", &_test_dot_prod<int, std::complex<float>, float>,
+        py::arg("x"), py::arg("y"), py::arg("z").noconvert());
+    m.def("test_dot_prod", &_test_dot_prod<int, std::complex<double>, double>,
+        py::arg("x"), py::arg("y"), py::arg("z").noconvert(),
+R"pbdoc(
+z[0] = dot_prod(x, y), z[1] = dot_prod_ref(x, y) */)pbdoc");
+
+    m.def("test_norm", &_test_norm<int, float, float>,
+        py::arg("x"), py::arg("z").noconvert());
+    m.def("test_norm", &_test_norm<int, double, double>,
+        py::arg("x"), py::arg("z").noconvert());
+    m.def("test_norm", &_test_norm<int, std::complex<float>, float>,
+        py::arg("x"), py::arg("z").noconvert());
+    m.def("test_norm", &_test_norm<int, std::complex<double>, double>,
+        py::arg("x"), py::arg("z").noconvert(),
+R"pbdoc(
+z[0] = norm(x), z[1] = norm_ref(x) */)pbdoc");
+
+    m.def("test_axpy", &_test_axpy<int, float, float>,
+        py::arg("x").noconvert(), py::arg("x_ref").noconvert(), py::arg("y"), py::arg("alpha"));
+    m.def("test_axpy", &_test_axpy<int, double, double>,
+        py::arg("x").noconvert(), py::arg("x_ref").noconvert(), py::arg("y"), py::arg("alpha"));
+    m.def("test_axpy", &_test_axpy<int, std::complex<float>, float>,
+        py::arg("x").noconvert(), py::arg("x_ref").noconvert(), py::arg("y"), py::arg("alpha"));
+    m.def("test_axpy", &_test_axpy<int, std::complex<double>, double>,
+        py::arg("x").noconvert(), py::arg("x_ref").noconvert(), py::arg("y"), py::arg("alpha"),
+R"pbdoc(
+x += alpha[0]*y with axpy, and x_ref += alpha[0]*y with axpy_ref */)pbdoc");
+
+    m.def("test_gemm", &_test_gemm<int, float, float>,
+        py::arg("Ax"), py::arg("Arows"), py::arg("Acols"), py::arg("Bx"), py::arg("Bcols"), py::arg("Btrans"), py::arg("Sx").noconvert(), py::arg("S_ref").noconvert(), py::arg("Strans"), py::arg("overwrite"));
+    m.def("test_gemm", &_test_gemm<int, double, double>,
+        py::arg("Ax"), py::arg("Arows"), py::arg("Acols"), py::arg("Bx"), py::arg("Bcols"), py::arg("Btrans"), py::arg("Sx").noconvert(), py::arg("S_ref").noconvert(), py::arg("Strans"), py::arg("overwrite"));
+    m.def("test_gemm", &_test_gemm<int, std::complex<float>, float>,
+        py::arg("Ax"), py::arg("Arows"), py::arg("Acols"), py::arg("Bx"), py::arg("Bcols"), py::arg("Btrans"), py::arg("Sx").noconvert(), py::arg("S_ref").noconvert(), py::arg("Strans"), py::arg("overwrite"));
+    m.def("test_gemm", &_test_gemm<int, std::complex<double>, double>,
+        py::arg("Ax"), py::arg("Arows"), py::arg("Acols"), py::arg("Bx"), py::arg("Bcols"), py::arg("Btrans"), py::arg("Sx").noconvert(), py::arg("S_ref").noconvert(), py::arg("Strans"), py::arg("overwrite"),
+R"pbdoc(
+S = A B with gemm, and S_ref = A B with gemm_ref, for A of Arows x
+Acols in row major.  B is in row major if Btrans is nonzero, and in
+column major otherwise.  S is in column major if Strans is nonzero, and
+in row major otherwise.  S and S_ref are overwritten if overwrite is
+nonzero, and accumulated to otherwise.)pbdoc");
+
+}
+
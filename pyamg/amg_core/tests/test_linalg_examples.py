@@ -0,0 +1,114 @@
+import pyamg.amg_core.tests.linalg_examples as g
+import numpy as np
+from numpy.testing import TestCase, assert_equal, assert_allclose
+
+dtypes = [np.float32, np.float64, np.complex64, np.complex128]
+lengths = [0, 1, 3, 4, 5, 7, 13, 101]
+
+
+def rand(shape, dtype):
+    x = np.random.rand(*shape) - 0.5
+    if np.iscomplexobj(np.zeros(1, dtype=dtype)):
+        x = x + 1j * (np.random.rand(*shape) - 0.5)
+    return np.asarray(x, dtype=dtype)
+
+
+def rtol(dtype):
+    return 1e-5 if np.dtype(dtype).char in 'fF' else 1e-12
+
+
+class TestReductions(TestCase):
+    def setUp(self):
+        np.random.seed(1179)
+
+    def test_dot_prod(self):
+        for dtype in dtypes:
+            for n in lengths:
+                x = rand((n,), dtype)
+                y = rand((n,), dtype)
+                z = np.zeros(2, dtype=dtype)
+                g.test_dot_prod(x, y, z)
+                # the partial sums differ from the serial sum in the last
+                # bits only
+                assert_allclose(z[0], z[1], rtol=rtol(dtype), atol=1e-6)
+                assert_allclose(z[1], np.vdot(x, y), rtol=rtol(dtype),
+                                atol=1e-6)
+
+    def test_norm(self):
+        for dtype in dtypes:
+            for n in lengths:
+                x = rand((n,), dtype)
+                z = np.zeros(2, dtype=np.zeros(1, dtype=dtype).real.dtype)
+                g.test_norm(x, z)
+                assert_allclose(z[0], z[1], rtol=rtol(dtype))
+                assert_allclose(z[1], np.linalg.norm(x), rtol=rtol(dtype))
+
+
+class TestAxpy(TestCase):
+    def setUp(self):
+        np.random.seed(2687)
+
+    def test_axpy(self):
+        for dtype in dtypes:
+            for n in lengths:
+                x0 = rand((n,), dtype)
+                x = x0.copy()
+                x_ref = x0.copy()
+                y = rand((n,), dtype)
+                alpha = rand((1,), dtype)
+                g.test_axpy(x, x_ref, y, alpha)
+                assert_allclose(x, x_ref, rtol=rtol(dtype))
+                assert_allclose(x, x0 + alpha * y, rtol=rtol(dtype),
+                                atol=1e-6)
+
+    def test_axpy_nonfinite(self):
+        # the complex products recover inf from nan as std::complex does
+        inf = np.inf
+        nan = np.nan
+        cases = [(inf + 1j * inf, 1.0),
+                 (inf + 0j, 1j),
+                 (complex(inf, nan), 2 + 3j),
+                 (complex(nan, nan), 1 + 1j),
+                 (inf + 1j, 0j),
+                 (1e308 + 1e308j, 1e308 + 1e308j)]
+        for dtype in [np.complex64, np.complex128]:
+            with np.errstate(invalid='ignore', over='ignore'):
+                alpha = np.array([a for a, _ in cases], dtype=dtype)
+                y = np.array([b for _, b in cases], dtype=dtype)
+            for a, b in zip(alpha, y):
+                x = np.zeros(5, dtype=dtype)
+                x_ref = x.copy()
+                g.test_axpy(x, x_ref, np.full(5, b, dtype=dtype),
+                            np.array([a]))
+                assert_equal(x, x_ref)
+
+
+class TestGemm(TestCase):
+    def setUp(self):
+        np.random.seed(3931)
+
+    def test_gemm(self):
+        shapes = [(1, 1, 1), (3, 5, 7), (4, 4, 4), (7, 3, 5), (6, 6, 1),
+                  (1, 9, 6)]
+        for dtype in dtypes:
+            for m, k, n in shapes:
+                A = rand((m, k), dtype)
+                B = rand((k, n), dtype)
+                for Btrans in [0, 1]:
+                    Bx = np.ravel(B, order='C' if Btrans else 'F')
+                    for Strans in [0, 1]:
+                        order = 'F' if Strans else 'C'
+                        for overwrite in [0, 1]:
+                            S0 = rand((m, n), dtype)
+                            S = np.ravel(S0, order=order).copy()
+                            S_ref = S.copy()
+                            g.test_gemm(np.ravel(A), m, k, Bx, n, Btrans,
+                                        S, S_ref, Strans, overwrite)
+                            # each entry is summed in the same order
+                            assert_allclose(S, S_ref, rtol=rtol(dtype))
+                            expected = A.dot(B)
+                            if not overwrite:
+                                expected += S0
+                            assert_allclose(S.reshape((m, n), order=order),
+                                            expected, rtol=rtol(dtype),
+                                            atol=1e-6)
@@ -3,9 +3,12 @@ from __future__ import absolute_import
 
 
 from warnings import warn
+from functools import partial
 from scipy.sparse import csr_matrix, isspmatrix_csr, SparseEfficiencyWarning
 
 from pyamg.multilevel import multilevel_solver
+from pyamg.util.profile import Profile, null_profile
+from pyamg.util.utils import galerkin_product
 from pyamg.relaxation.smoothing import change_smoothers
 from pyamg.strength import classical_strength_of_connection, \
     symmetric_strength_of_connection, evolution_strength_of_connection,\
@@ -24,7 +27,8 @@ def ruge_stuben_solver(A,
                        CF='RS',
                        presmoother=('gauss_seidel', {'sweep': 'symmetric'}),
                        postsmoother=('gauss_seidel', {'sweep': 'symmetric'}),
-                       max_levels=10, max_coarse=10, keep=False, **kwargs):
+                       max_levels=10, max_coarse=10, keep=False,
+                       interpolation='direct', profile=False, **kwargs):
     """Create a multilevel solver using Classical AMG (Ruge-Stuben AMG).
 
     Parameters
@@ -38,7 +42,10 @@ def ruge_stuben_solver(A,
         strength=None, all nonzero entries of the matrix are considered strong.
     CF : string
         Method used for coarse grid selection (C/F splitting)
-        Supported methods are RS, PMIS, PMISc, CLJP, CLJPc, and CR.
+        Supported methods are RS, PMIS, PMISc, HMIS, CLJP, CLJPc, and CR.
+        A given splitting, and strength of connection C, are used by
+        extend_hierarchy with ('predefined', {'splitting': splitting}) and
+        ('predefined', {'C': C}), e.g. by multilevel_solver.update.
     presmoother : string or dict
         Method used for presmoothing at each level.  Method-specific parameters
         may be passed in using a tuple, e.g.
@@ -52,7 +59,18 @@ def ruge_stuben_solver(A,
     keep: bool
         Flag to indicate keeping extra operators in the hierarchy for
         diagnostics.  For example, if True, then strength of connection (C) and
-        tentative prolongation (T) are kept.
+        tentative prolongation (T) are kept.  The C/F splitting (splitting)
+        is always kept, for multilevel_solver.update.
+    interpolation : string or tuple
+        Method used to build the prolongation operator.  Only 'direct' is
+        supported.  The weights are truncated in each row of P with e.g.
+        interpolation=('direct', {'max_row_nnz': 4, 'trunc_factor': 0.2}),
+        see direct_interpolation.
+    profile : bool, Profile
+        If True, or a pyamg.util.profile.Profile, then the wall time and the
+        memory allocated by each phase of the setup on each level, and by
+        each component of the cycle in ml.solve, are recorded in ml.profile.
+        See multilevel_solver.profile_summary.
 
     Returns
     -------
@@ -76,6 +94,15 @@ def ruge_stuben_solver(A,
     function, and args is a dictionary of arguments to be passed to fn.
     See [2001TrOoSc]_ for additional details.
 
+    Similarly, "cycle_dtype" is passed to multilevel_solver, e.g.
+    cycle_dtype=np.float32 stores and cycles the hierarchy in single
+    precision, while solve iterates on A in double precision.
+    Also "reorder='rcm'" permutes the unknowns of each level by reverse
+    Cuthill-McKee for the locality of the cycle, while solve still takes and
+    returns vectors in the ordering of A, and "compress=True" stores the
+    coarse level matrices and the interpolation operators with 16-bit column
+    offsets.
+
 
     References
     ----------
@@ -106,23 +133,43 @@ def ruge_stuben_solver(A,
 
     levels[-1].A = A
 
-    while len(levels) < max_levels and levels[-1].A.shape[0] > max_coarse:
-        extend_hierarchy(levels, strength, CF, keep)
+    if profile is True:
+        profile = Profile()
+    elif not profile:
+        profile = None
+
+    with (profile or null_profile).timing_kernels():
+        while len(levels) < max_levels and levels[-1].A.shape[0] > max_coarse:
+            extend_hierarchy(levels, strength, CF, keep, interpolation,
+                             profile)
 
-    ml = multilevel_solver(levels, **kwargs)
-    change_smoothers(ml, presmoother, postsmoother)
+        ml = multilevel_solver(levels, profile=profile, **kwargs)
+        change_smoothers(ml, presmoother, postsmoother)
+    ml.updater = partial(update_hierarchy, strength=strength,
+                         interpolation=interpolation, keep=keep)
     return ml
 
 
 # internal function
-def extend_hierarchy(levels, strength, CF, keep):
-    """Extend the multigrid hierarchy."""
+def extend_hierarchy(levels, strength, CF, keep, interpolation='direct',
+                     profile=None, previous=None):
+    """Extend the multigrid hierarchy.
+
+    If previous is given, it is the list of levels of a previous hierarchy
+    with the same splittings, and the sparsity pattern of its coarse A is
+    tried for the Galerkin product of the new level, see update_hierarchy.
+    """
     def unpack_arg(v):
         if isinstance(v, tuple):
             return v[0], v[1]
         else:
             return v, {}
 
+    if profile is None:
+        profile = null_profile
+    lvl = len(levels) - 1
+    profile.start()
+
     A = levels[-1].A
 
     # Compute the strength-of-connection matrix C, where larger
@@ -142,11 +189,14 @@ def extend_hierarchy(levels, strength, CF, keep):
         C = algebraic_distance(A, **kwargs)
     elif fn == 'affinity':
         C = affinity_distance(A, **kwargs)
+    elif fn == 'predefined':
+        C = kwargs['C'].tocsr()
     elif fn is None:
         C = A
     else:
         raise ValueError('unrecognized strength of connection method: %s' %
                          str(fn))
+    profile.lap('setup', lvl, 'strength')
 
     # Generate the C/F splitting
     fn, kwargs = unpack_arg(CF)
@@ -156,33 +206,92 @@ def extend_hierarchy(levels, strength, CF, keep):
         splitting = split.PMIS(C, **kwargs)
     elif fn == 'PMISc':
         splitting = split.PMISc(C, **kwargs)
+    elif fn == 'HMIS':
+        splitting = split.HMIS(C, **kwargs)
     elif fn == 'CLJP':
         splitting = split.CLJP(C, **kwargs)
     elif fn == 'CLJPc':
         splitting = split.CLJPc(C, **kwargs)
     elif fn == 'CR':
         splitting = CR(C, **kwargs)
+    elif fn == 'predefined':
+        splitting = kwargs['splitting']
     else:
         raise ValueError('unknown C/F splitting method (%s)' % CF)
+    profile.lap('setup', lvl, 'splitting')
 
     # Generate the interpolation matrix that maps from the coarse-grid to the
     # fine-grid
-    P = direct_interpolation(A, C, splitting)
+    fn, kwargs = unpack_arg(interpolation)
+    if fn == 'direct':
+        P = direct_interpolation(A, C, splitting, **kwargs)
+    else:
+        raise ValueError('unknown interpolation method (%s)' % interpolation)
 
     # Generate the restriction matrix that maps from the fine-grid to the
     # coarse-grid
     R = P.T.tocsr()
+    profile.lap('setup', lvl, 'interpolation')
 
     # Store relevant information for this level
     if keep:
         levels[-1].C = C                  # strength of connection matrix
-        levels[-1].splitting = splitting  # C/F splitting
 
+    levels[-1].splitting = splitting  # C/F splitting
     levels[-1].P = P                  # prolongation operator
     levels[-1].R = R                  # restriction operator
 
     levels.append(multilevel_solver.level())
 
     # Form next level through Galerkin product
-    A = R * A * P
+    if previous is None:
+        A = galerkin_product(R, A, P)
+    else:
+        A = galerkin_product(R, A, P, pattern=previous[lvl + 1].A)
     levels[-1].A = A
+    profile.lap('setup', lvl, 'RAP')
+
+
+def update_hierarchy(levels, A, strength, interpolation='direct', keep=False,
+                     profile=None, previous=None):
+    """Recompute a Ruge-Stuben hierarchy for a new operator and the same splitting.
+
+    Service routine for multilevel_solver.update.  The hierarchy is rebuilt
+    with extend_hierarchy from A, with the C/F splitting of each level, and
+    the strength of connection of each level if it was kept.  Otherwise the
+    strength of connection is recomputed for the interpolation.
+
+    The splitting of each level is kept for the update whether or not keep
+    is set, while C is kept only with keep=True, as in the setup.
+
+    The sparsity pattern of the coarse A of each level of previous, by
+    default levels, is tried for the Galerkin product of the new level, so
+    that only its values are recomputed where the pattern still holds, see
+    galerkin_product.  The patterns must be in the order and format of the
+    setup, see multilevel_solver.update.  The pattern of P follows the
+    strength of connection, which may change with the values of A, so P is
+    recomputed in full.
+
+    Returns
+    -------
+    levels : list
+        The new levels, with the same sizes as levels
+
+    """
+    if previous is None:
+        previous = levels
+
+    new_levels = [multilevel_solver.level()]
+    new_levels[0].A = A
+
+    while len(new_levels) < len(levels):
+        level = levels[len(new_levels) - 1]
+        if hasattr(level, 'C'):
+            level_strength = ('predefined', {'C': level.C})
+        else:
+            level_strength = strength
+        extend_hierarchy(new_levels, level_strength,
+                         ('predefined', {'splitting': level.splitting}),
+                         keep, interpolation, profile, previous=previous)
+
+    return new_levels
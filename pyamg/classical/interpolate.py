@@ -8,7 +8,7 @@ from pyamg import amg_core
 __all__ = ['direct_interpolation']
 
 
-def direct_interpolation(A, C, splitting):
+def direct_interpolation(A, C, splitting, max_row_nnz=None, trunc_factor=0.0):
     """Create prolongator using direct interpolation.
 
     Parameters
@@ -20,6 +20,12 @@ def direct_interpolation(A, C, splitting):
         Must have zero diagonal
     splitting : array
         C/F splitting stored in an array of length N
+    max_row_nnz : int
+        If given, keep at most this many interpolation weights, largest in
+        magnitude, in each row of P
+    trunc_factor : float
+        Drop the interpolation weights with magnitude less than
+        trunc_factor times the largest magnitude in the row of P
 
     Returns
     -------
@@ -41,6 +47,13 @@ def direct_interpolation(A, C, splitting):
      [ 0.   0.5  0.5]
      [ 0.   0.   1. ]]
 
+    Notes
+    -----
+    If max_row_nnz or trunc_factor is given, the weights are truncated as
+    P is assembled, and the remaining weights in each row are scaled so
+    that the row sums of P are unchanged.  This replaces a separate call
+    to pyamg.util.utils.truncate_rows.
+
     """
     if not isspmatrix_csr(A):
         raise TypeError('expected csr_matrix for A')
@@ -57,17 +70,40 @@ def direct_interpolation(A, C, splitting):
 
     Pp = np.empty_like(A.indptr)
 
-    amg_core.rs_direct_interpolation_pass1(A.shape[0],
-                                           C.indptr, C.indices, splitting, Pp)
-
-    nnz = Pp[-1]
-    Pj = np.empty(nnz, dtype=Pp.dtype)
-    Px = np.empty(nnz, dtype=A.dtype)
-
-    amg_core.rs_direct_interpolation_pass2(A.shape[0],
-                                           A.indptr, A.indices, A.data,
-                                           C.indptr, C.indices, C.data,
-                                           splitting,
-                                           Pp, Pj, Px)
+    if max_row_nnz is None and trunc_factor == 0.0:
+        amg_core.rs_direct_interpolation_pass1(A.shape[0],
+                                               C.indptr, C.indices, splitting,
+                                               Pp)
+
+        nnz = Pp[-1]
+        Pj = np.empty(nnz, dtype=Pp.dtype)
+        Px = np.empty(nnz, dtype=A.dtype)
+
+        amg_core.rs_direct_interpolation_pass2(A.shape[0],
+                                               A.indptr, A.indices, A.data,
+                                               C.indptr, C.indices, C.data,
+                                               splitting,
+                                               Pp, Pj, Px)
+    else:
+        if max_row_nnz is None:
+            max_row_nnz = 0
+        elif max_row_nnz < 1:
+            raise ValueError('max_row_nnz must be >= 1')
+        if trunc_factor < 0.0 or trunc_factor > 1.0:
+            raise ValueError('trunc_factor must be in [0, 1]')
+
+        args = (A.shape[0], A.indptr, A.indices, A.data,
+                C.indptr, C.indices, C.data, splitting)
+        amg_core.rs_direct_interpolation_truncated_pass1(*args, Pp,
+                                                         max_row_nnz,
+                                                         trunc_factor)
+
+        nnz = Pp[-1]
+        Pj = np.empty(nnz, dtype=Pp.dtype)
+        Px = np.empty(nnz, dtype=A.dtype)
+
+        amg_core.rs_direct_interpolation_truncated_pass2(*args, Pp, Pj, Px,
+                                                         max_row_nnz,
+                                                         trunc_factor)
 
     return csr_matrix((Px, Pj, Pp))
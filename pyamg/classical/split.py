@@ -37,6 +37,11 @@ PMISc: Parallel Modified Independent Set in Color
     - Augments random weights with a (graph) vertex coloring
     - See References [1]
 
+HMIS: Hybrid Modified Independent Set
+    - Ruge-Stuben first pass on blocks of nodes, followed by PMIS.
+    - Operator complexity between that of RS and PMIS.
+    - See References [3]
+
 CLJP: Cleary-Luby-Jones-Plassmann
     - Parallel method with cost and complexity comparable to Ruge-Stuben.
     - Convergence can deteriorate with increasing problem
@@ -61,6 +66,7 @@ from coloring.
        RS        no        no      moderate
       PMIS      yes        no      very low
       PMISc     yes       yes        low
+      HMIS      yes        no        low
       CLJP      yes        no      moderate
       CLJPc     yes       yes      moderate
     ========  ========  ========  ==========
@@ -96,7 +102,7 @@ from pyamg.graph import vertex_coloring
 from pyamg import amg_core
 from pyamg.util.utils import remove_diagonal
 
-__all__ = ['RS', 'PMIS', 'PMISc', 'CLJP', 'CLJPc', 'MIS']
+__all__ = ['RS', 'PMIS', 'PMISc', 'HMIS', 'CLJP', 'CLJPc', 'MIS']
 
 
 def RS(S, second_pass=False):
@@ -140,8 +146,9 @@ def RS(S, second_pass=False):
     S = remove_diagonal(S)
 
     T = S.T.tocsr()  # transpose S for efficient column access
-    splitting = np.empty(S.shape[0], dtype='intc')
-    influence = np.zeros((S.shape[0],), dtype='intc')
+    index_type = S.indptr.dtype
+    splitting = np.empty(S.shape[0], dtype=index_type)
+    influence = np.zeros((S.shape[0],), dtype=index_type)
 
     amg_core.rs_cf_splitting(S.shape[0],
                              S.indptr, S.indices,
@@ -178,7 +185,13 @@ def PMIS(S):
 
     See Also
     --------
-    MIS
+    MIS, HMIS
+
+    Notes
+    -----
+    The C-nodes are a maximal independent set of the graph of S + S^T,
+    computed in parallel by amg_core.pmis_cf_splitting.  Nodes that no
+    other node strongly depends on are F-nodes.
 
     References
     ----------
@@ -189,7 +202,7 @@ def PMIS(S):
     """
     S = remove_diagonal(S)
     weights, G, S, T = preprocess(S)
-    return MIS(G, weights)
+    return _pmis(S, T, weights)
 
 
 def PMISc(S, method='JP'):
@@ -234,7 +247,65 @@ def PMISc(S, method='JP'):
     """
     S = remove_diagonal(S)
     weights, G, S, T = preprocess(S, coloring_method=method)
-    return MIS(G, weights)
+    return _pmis(S, T, weights)
+
+
+def HMIS(S, block_size=4096):
+    """C/F splitting using the Hybrid Modified Independent Set method.
+
+    Parameters
+    ----------
+    S : csr_matrix
+        Strength of connection matrix indicating the strength between nodes i
+        and j (S_ij)
+    block_size : int
+        Number of consecutive nodes in each block that is split with the
+        first pass of Ruge-Stuben coarsening
+
+    Returns
+    -------
+    splitting : ndarray
+        Array of length of S of ones (coarse) and zeros (fine)
+
+    Examples
+    --------
+    >>> from pyamg.gallery import poisson
+    >>> from pyamg.classical import HMIS
+    >>> S = poisson((7,), format='csr') # 1D mesh with 7 vertices
+    >>> splitting = HMIS(S)
+
+    See Also
+    --------
+    RS, PMIS
+
+    Notes
+    -----
+    The blocks take the role of the processor subdomains in [9]_.  The
+    C-nodes that the first pass of Ruge-Stuben selects in each block, and
+    that have no strong connections to other blocks, are the initial
+    C-nodes for PMIS.  The blocks are split in parallel, and the result
+    does not depend on the number of threads.  Larger blocks give a
+    splitting closer to RS.
+
+    References
+    ----------
+    .. [9] Hans De Sterck, Ulrike M Yang, and Jeffrey J Heys
+       "Reducing complexity in parallel algebraic multigrid preconditioners"
+       SIAM Journal on Matrix Analysis and Applications 2006; 27:1019-1039.
+
+    """
+    if block_size < 1:
+        raise ValueError('block_size must be >= 1')
+
+    S = remove_diagonal(S)
+    weights, G, S, T = preprocess(S)
+
+    splitting = np.empty(S.shape[0], dtype=S.indptr.dtype)
+    amg_core.hmis_cf_splitting(S.shape[0], S.indptr, S.indices,
+                               T.indptr, T.indices, weights, splitting,
+                               block_size)
+
+    return splitting
 
 
 def CLJP(S, color=False):
@@ -280,7 +351,7 @@ def CLJP(S, color=False):
         colorid = 1
 
     T = S.T.tocsr()  # transpose S for efficient column access
-    splitting = np.empty(S.shape[0], dtype='intc')
+    splitting = np.empty(S.shape[0], dtype=S.indptr.dtype)
 
     amg_core.cljp_naive_splitting(S.shape[0],
                                   S.indptr, S.indices,
@@ -365,7 +436,7 @@ def MIS(G, weights, maxiter=None):
         raise TypeError('expected csr_matrix')
     G = remove_diagonal(G)
 
-    mis = np.empty(G.shape[0], dtype='intc')
+    mis = np.empty(G.shape[0], dtype=G.indptr.dtype)
     mis[:] = -1
 
     fn = amg_core.maximal_independent_set_parallel
@@ -381,6 +452,15 @@ def MIS(G, weights, maxiter=None):
     return mis
 
 
+# internal function
+def _pmis(S, T, weights):
+    """Compute a PMIS splitting of S, with transpose T, from the weights."""
+    splitting = np.empty(S.shape[0], dtype=S.indptr.dtype)
+    amg_core.pmis_cf_splitting(S.shape[0], S.indptr, S.indices,
+                               T.indptr, T.indices, weights, splitting)
+    return splitting
+
+
 # internal function
 def preprocess(S, coloring_method=None):
     """Preprocess splitting functions.
@@ -3,12 +3,14 @@ import scipy as sp
 
 from scipy.sparse import csr_matrix, coo_matrix, SparseEfficiencyWarning
 
+from pyamg import amg_core
 from pyamg.gallery import poisson, load_example
 from pyamg.strength import classical_strength_of_connection
 
 from pyamg.classical import split
 from pyamg.classical.classical import ruge_stuben_solver
 from pyamg.classical.interpolate import direct_interpolation
+from pyamg.util.utils import remove_diagonal
 
 from numpy.testing import TestCase, assert_equal, assert_almost_equal
 
@@ -103,6 +105,45 @@ class TestRugeStubenFunctions(TestCase):
             # check that all F-nodes are strongly connected to a C-node
             assert((splitting + S*splitting).min() > 0)
 
+    def test_pmis_hmis_splitting(self):
+        for A in self.cases:
+            S = classical_strength_of_connection(A, 0.0)
+
+            T = remove_diagonal(S)
+            T.data[:] = 1
+            G = (T + T.T).tocsr()
+            dependents = np.ravel(T.sum(axis=0))
+
+            for splitting in [split.PMIS(S), split.PMISc(S),
+                              split.HMIS(S), split.HMIS(S, block_size=3)]:
+                assert(splitting.min() >= 0)
+                assert(splitting.max() <= 1)
+
+                # check that all F-nodes that other nodes depend on are
+                # strongly connected to a C-node
+                F = splitting == 0
+                assert(((G*splitting)[F & (dependents > 0)] > 0).all())
+
+            # check that the C-nodes of PMIS are independent
+            splitting = split.PMIS(S)
+            assert_equal((G*splitting)[splitting == 1], 0)
+
+    def test_pmis_hmis_threads(self):
+        A = poisson((60, 60), format='csr')
+        S = classical_strength_of_connection(A, 0.25)
+
+        num_threads = amg_core.set_num_threads(0)
+        try:
+            results = []
+            for n in [1, 4]:
+                amg_core.set_num_threads(n)
+                np.random.seed(0)
+                results.append((split.PMIS(S), split.HMIS(S, block_size=100)))
+            assert_equal(results[0][0], results[1][0])
+            assert_equal(results[0][1], results[1][1])
+        finally:
+            amg_core.set_num_threads(num_threads)
+
     def test_direct_interpolation(self):
         for A in self.cases:
 
@@ -114,6 +155,25 @@ class TestRugeStubenFunctions(TestCase):
 
             assert_almost_equal(result.toarray(), expected.toarray())
 
+    def test_direct_interpolation_truncation(self):
+        for A in self.cases:
+
+            S = classical_strength_of_connection(A, 0.0)
+            splitting = split.RS(S)
+            P = direct_interpolation(A, S, splitting)
+
+            for max_row_nnz, trunc_factor in [(None, 0.5), (2, 0.0), (1, 0.2)]:
+                result = direct_interpolation(A, S, splitting,
+                                              max_row_nnz=max_row_nnz,
+                                              trunc_factor=trunc_factor)
+                expected = reference_truncation(P, max_row_nnz, trunc_factor)
+
+                assert_almost_equal(result.toarray(), expected.toarray())
+                assert_almost_equal(np.ravel(result.sum(axis=1)),
+                                    np.ravel(P.sum(axis=1)))
+                if max_row_nnz is not None:
+                    assert(np.diff(result.indptr).max() <= max_row_nnz)
+
 
 class TestSolverPerformance(TestCase):
     def test_poisson(self):
@@ -159,6 +219,30 @@ class TestSolverPerformance(TestCase):
 
 
 #   reference implementations for unittests  #
+def reference_truncation(P, max_row_nnz, trunc_factor):
+    # drop the small weights in each row of P, keep the max_row_nnz largest
+    # weights (earlier entries first among ties), and rescale the row
+    P = csr_matrix(P)
+    rows, cols, vals = [], [], []
+    for i in range(P.shape[0]):
+        Pc = P.indices[P.indptr[i]:P.indptr[i + 1]]
+        Pv = P.data[P.indptr[i]:P.indptr[i + 1]]
+        if len(Pv) == 0:
+            continue
+        keep = np.abs(Pv) >= trunc_factor * np.abs(Pv).max()
+        order = [k for k in np.argsort(-np.abs(Pv), kind='stable') if keep[k]]
+        if max_row_nnz is not None:
+            order = order[:max_row_nnz]
+        order = np.sort(order)
+        v = Pv[order]
+        if len(v) < len(Pv) and v.sum() != 0:
+            v = v * (Pv.sum() / v.sum())
+        rows.extend([i] * len(v))
+        cols.extend(Pc[order])
+        vals.extend(v)
+    return csr_matrix((vals, (rows, cols)), shape=P.shape)
+
+
 def reference_direct_interpolation(A, S, splitting):
 
     # Interpolation weights are computed based on entries in A, but subject to
@@ -9,7 +9,7 @@ from scipy import sparse
 from . import amg_core
 
 __all__ = ['maximal_independent_set', 'vertex_coloring', 'bellman_ford',
-           'lloyd_cluster', 'connected_components']
+           'lloyd_cluster', 'connected_components', 'reverse_cuthill_mckee']
 
 from pyamg.graph_ref import bellman_ford_reference
 
@@ -56,7 +56,7 @@ def maximal_independent_set(G, algo='serial', k=None):
     G = asgraph(G)
     N = G.shape[0]
 
-    mis = np.empty(N, dtype='intc')
+    mis = np.empty(N, dtype=G.indptr.dtype)
     mis[:] = -1
 
     if k is None:
@@ -103,7 +103,7 @@ def vertex_coloring(G, method='MIS'):
     G = asgraph(G)
     N = G.shape[0]
 
-    coloring = np.empty(N, dtype='intc')
+    coloring = np.empty(N, dtype=G.indptr.dtype)
 
     if method == 'MIS':
         fn = amg_core.vertex_coloring_mis
@@ -146,12 +146,13 @@ def bellman_ford(G, seeds):
     if G.dtype == complex:
         raise ValueError('Bellman-Ford is defined only for real weights.')
 
-    seeds = np.asarray(seeds, dtype='intc')
+    index_type = G.indptr.dtype
+    seeds = np.asarray(seeds, dtype=index_type)
 
     distances = np.full(N, np.inf, dtype=G.dtype)
     distances[seeds] = 0
 
-    nearest_seed = np.full(N, -1, dtype='intc')
+    nearest_seed = np.full(N, -1, dtype=index_type)
     nearest_seed[seeds] = seeds
 
     amg_core.bellman_ford(N, G.indptr, G.indices, G.data, distances, nearest_seed)
@@ -196,11 +197,12 @@ def lloyd_cluster(G, seeds, maxiter=10):
         G = np.abs(G)
 
     # interpret seeds argument
+    index_type = G.indptr.dtype
     if np.isscalar(seeds):
         seeds = np.random.permutation(N)[:seeds]
-        seeds = seeds.astype('intc')
+        seeds = seeds.astype(index_type)
     else:
-        seeds = np.array(seeds, dtype='intc')
+        seeds = np.array(seeds, dtype=index_type)
 
     if len(seeds) < 1:
         raise ValueError('at least one seed is required')
@@ -210,7 +212,7 @@ def lloyd_cluster(G, seeds, maxiter=10):
     if seeds.max() >= N:
         raise ValueError('invalid seed index (%d)' % seeds.max())
 
-    clusters = np.empty(N, dtype='intc')
+    clusters = np.empty(N, dtype=index_type)
     distances = np.empty(N, dtype=G.dtype)
 
     for i in range(maxiter):
@@ -329,6 +331,58 @@ def connected_components(G):
     return components
 
 
+def reverse_cuthill_mckee(G):
+    """Reverse Cuthill-McKee ordering of a graph.
+
+    Parameters
+    ----------
+    G : csr_matrix, csc_matrix
+        A sparse NxN matrix whose nonzeros are the edges of the graph.  The
+        graph is symmetrized, i.e., the nonzeros of G + G.T are used.
+
+    Returns
+    -------
+    order : int array
+        Permutation of the vertices, such that G[order, :][:, order] has a
+        small bandwidth
+
+    Notes
+    -----
+    Each connected component is searched breadth first from a vertex of
+    minimum degree, visiting the neighbors of each vertex by increasing
+    degree, and the search order is reversed, see amg_core.cuthill_mckee.
+
+    Examples
+    --------
+    >>> from pyamg.gallery import poisson
+    >>> from pyamg.graph import reverse_cuthill_mckee
+    >>> import numpy as np
+    >>> A = poisson((10, 10), format='csr')
+    >>> p = np.random.permutation(A.shape[0])
+    >>> B = A[p, :][:, p]
+    >>> order = reverse_cuthill_mckee(B)
+    >>> C = B[order, :][:, order].tocoo()
+    >>> print(np.abs(C.row - C.col).max())
+    10
+
+    See Also
+    --------
+    breadth_first_search, symmetric_rcm
+
+    """
+    G = asgraph(G)
+    G = (G + G.T).tocsr()
+    N = G.shape[0]
+
+    order = np.empty(N, G.indptr.dtype)
+    level = np.empty(N, G.indptr.dtype)
+    level[:] = -1
+
+    amg_core.cuthill_mckee(N, G.indptr, G.indices, order, level)
+
+    return order[::-1].copy()
+
+
 def symmetric_rcm(A):
     """Symmetric Reverse Cutthill-McKee.
 
@@ -2,13 +2,24 @@
 
 
 from warnings import warn
+import threading
 
 import scipy as sp
 import numpy as np
+from scipy import sparse
+from pyamg.util.profile import null_profile
 
 
 __all__ = ['multilevel_solver', 'coarse_grid_solver']
 
+# codes of the level descriptors of amg_core.multigrid_cycle, see
+# relaxation.h
+_CYCLE_LEVEL_SIZE = 21
+_NATIVE_CYCLES = {'V': 0, 'W': 1, 'F': 2}
+_NATIVE_SMOOTHERS = {'none': 0, 'gauss_seidel': 1, 'jacobi': 2}
+_NATIVE_SWEEPS = {'forward': 0, 'backward': 1, 'symmetric': 2}
+_NATIVE_COARSE_SOLVERS = {'zero': 0, 'pinv': 1, 'lu': 2}
+
 
 class multilevel_solver:
     """Stores multigrid hierarchy and implements the multigrid cycle.
@@ -26,6 +37,29 @@ class multilevel_solver:
         Array of level objects that contain A, R, and P.
     coarse_solver : string
         String passed to coarse_grid_solver indicating the solve type
+    outer_A : sparse matrix
+        Full precision operator used by solve for a hierarchy in lower
+        precision, see cycle_dtype, or operator in the original ordering of
+        a reordered hierarchy, see reorder.  None otherwise.
+    orders : list
+        The permutation of the unknowns of each level of a reordered
+        hierarchy, see reorder, or None.
+    profile : Profile
+        Timings of the setup and of the cycle, or None.
+    updater : callable
+        Set by smoothed_aggregation_solver and ruge_stuben_solver to
+        recompute the hierarchy in update, or None.
+    patterns : list
+        The sparsity patterns of A, P, and R of each level in the order
+        and format of the setup, for update, if the hierarchy is reordered
+        or compressed.  None otherwise.
+    smoother_args : tuple
+        The (presmoother, postsmoother) of the last call to
+        change_smoothers, used by update to set up the smoothers again.
+    native_cycle_max_nnz : int
+        Largest number of stored values of the coarse levels that are
+        copied for amg_core.multigrid_cycle, see solve.  Set to 0 to
+        always cycle in Python.
 
     Methods
     -------
@@ -39,9 +73,18 @@ class multilevel_solver:
         A measure of the size of the multigrid hierarchy.
     solve()
         Iteratively solves a linear system for the right hand side.
+    update()
+        Recompute the hierarchy for a new operator with the same sparsity
+        pattern.
+    save()
+        Write the hierarchy to a binary file.
+    load()
+        Read a hierarchy written by save, memory mapping its arrays.
 
     """
 
+    native_cycle_max_nnz = 2**20
+
     class level:
         """Stores one level of the multigrid hierarchy.
 
@@ -70,7 +113,61 @@ class multilevel_solver:
             """Level construct (empty)."""
             pass
 
-    def __init__(self, levels, coarse_solver='pinv2'):
+    class workspace:
+        """Stores the preallocated temporaries for one level of the cycle.
+
+        Each level of a multilevel_solver has a 'workspace' attribute, which
+        holds the coarse right-hand side and correction used by the cycle,
+        and the scratch space for the amg_core kernels called by the
+        smoothers.  After the first cycle, no further allocations are made
+        unless the dtype of the right-hand side changes.
+
+        Attributes
+        ----------
+        arrays : dict
+            Preallocated arrays of the calling thread, keyed by name
+
+        Notes
+        -----
+        The smoothers pass the workspace of their level to the relaxation
+        methods, see pyamg.relaxation.relaxation.scratch_space.  It is not
+        attached to A, so hierarchies that share an operator do not share
+        temporaries.  The arrays are kept per thread, so that one
+        multilevel_solver may solve from several threads at a time; each
+        thread allocates its own temporaries on its first cycle.
+
+        """
+
+        def __init__(self):
+            """Workspace construct (empty)."""
+            self.local = threading.local()
+
+        @property
+        def arrays(self):
+            """Return the arrays of the calling thread."""
+            arrays = getattr(self.local, 'arrays', None)
+            if arrays is None:
+                arrays = self.local.arrays = {}
+            return arrays
+
+        def get(self, name, shape, dtype):
+            """Return the array stored as name.
+
+            The array is allocated if name is not yet stored, or if the
+            stored array does not match shape and dtype.  The contents of
+            the array are not initialized.
+
+            """
+            if not isinstance(shape, tuple):
+                shape = (shape,)
+            arr = self.arrays.get(name)
+            if arr is None or arr.shape != shape or arr.dtype != dtype:
+                arr = np.empty(shape, dtype=dtype)
+                self.arrays[name] = arr
+            return arr
+
+    def __init__(self, levels, coarse_solver='pinv2', cycle_dtype=None,
+                 profile=None, reorder=None, compress=False):
         """Class constructor responsible for initializing the cycle and ensuring the list of levels is complete.
 
         Parameters
@@ -102,12 +199,77 @@ class multilevel_solver:
             * pinv2    : pseudoinverse (SVD)
             * lu       : LU factorization
             * cholesky : Cholesky factorization
+        cycle_dtype : dtype
+            Precision in which the hierarchy is stored and cycled, e.g.
+            np.float32 for a single precision hierarchy of a double precision
+            problem.  By default the dtype of levels[0].A is used.  See Notes.
+        profile : Profile
+            If given, solve records the wall time of each component of the
+            cycle on each level in it, see pyamg.util.profile.Profile and
+            profile_summary.  The solvers, e.g. smoothed_aggregation_solver,
+            pass the profile of the setup.
+        reorder : {None, 'rcm', 'aggregate'}
+            Permute the unknowns of each level for the locality of the
+            cycle, see Notes.  By default the ordering of the setup is kept.
+        compress : bool
+            If True, store the coarse level matrices and the prolongators
+            in compressed formats, see Notes.
 
         Notes
         -----
         If not defined, the R attribute on each level is set to
         the transpose of P.
 
+        If cycle_dtype is lower precision than levels[0].A, then A, P, and R
+        on every level are converted, and the smoothers set up on the
+        hierarchy afterwards are set up in that precision as well, which
+        halves the memory traffic of a cycle for np.float32.  The original
+        operator is kept in outer_A, and each iteration of solve, as well
+        as an accel Krylov method or aspreconditioner, computes the residual
+        b - outer_A x in full precision and applies the cycle to it.  That
+        is, the cycle is a low precision preconditioner for a full precision
+        iteration, so the attainable accuracy of the solution is that of
+        outer_A.  Complex operators are cycled in the complex counterpart of
+        cycle_dtype.
+
+        If reorder is 'rcm', the unknowns of each level are permuted by a
+        reverse Cuthill-McKee ordering of the graph of the level matrix, or
+        of its blocks for a BSR matrix, see pyamg.graph.reverse_cuthill_mckee.
+        The smaller bandwidth improves the cache reuse of the x[Aj[jj]]
+        accesses of the smoothers and of the matrix products in each cycle.
+        If reorder is 'aggregate', the coarsest level is ordered by reverse
+        Cuthill-McKee, and each finer level by its aggregates (AggOp), so
+        that the unknowns of each aggregate are contiguous and in the order
+        of the coarse level.  Only A, P, and R of each level are permuted,
+        the other data of the setup, e.g., B, C, and AggOp, keep their
+        ordering.  The permutations are kept in orders, and the operator in
+        its original ordering in outer_A, so that solve, aspreconditioner,
+        and update take and return vectors and operators in the original
+        ordering: each iteration permutes the residual, cycles on it, and
+        permutes the correction back.
+
+        If compress is True, the CSR matrices A of the levels other than
+        the finest and the coarsest are stored as delta_csr_matrix, with
+        16-bit column offsets instead of column indices, and each P with
+        at most one (block) entry per (block) row, e.g., an unsmoothed
+        tentative prolongator, as aggregate_matrix, by its aggregate map.
+        Other CSR prolongators, and BSR prolongators with 1 x 1 blocks, are
+        stored as delta_csr_matrix.  R is then
+        kept as the adjoint of the compressed P, and is only compressed if
+        R = P^H.  Operators that can not be encoded, e.g., with columns
+        more than 65535 apart in a row, are kept as they are, and so are
+        the coarsest levels within native_cycle_max_nnz, which may still be
+        cycled by amg_core.multigrid_cycle.  The smoothers relax a
+        delta_csr_matrix with gauss_seidel_delta,
+        gauss_seidel_multicolor_delta, or jacobi_delta, which decode the
+        columns on the fly, and the polynomial smoothers use its products.
+        The Schwarz, block, and Kaczmarz smoothers, which have no kernels for
+        it, relax a CSR or BSR copy converted once at setup, which is kept
+        beside the compressed A, see pyamg.util.compressed.
+
+        With reorder or compress, the index arrays of A, P, and R as set up
+        are kept as well, in patterns, so that update can reuse them.
+
         Examples
         --------
         >>> # manual construction of a two-level AMG hierarchy
@@ -147,14 +309,318 @@ class multilevel_solver:
         <BLANKLINE>
 
         """
-        self.levels = levels
+        self.profile = profile
+        self.cycle_dtype = cycle_dtype
+        self.updater = None
+        self.smoother_args = None
+        self.reorder = reorder
+        self.orders = None
+        self.compress = compress
 
         self.coarse_solver = coarse_grid_solver(coarse_solver)
 
+        self.__set_levels(levels)
+
+    def __set_levels(self, levels):
+        """Store the levels, in cycle_dtype, with their workspaces."""
+        self.levels = levels
+        self.native = None
+
         for level in levels[:-1]:
             if not hasattr(level, 'R'):
                 level.R = level.P.H
 
+        # reorder and compress change the patterns that update reuses
+        self.patterns = None
+        if self.reorder is not None or self.compress:
+            self.patterns = _level_patterns(levels)
+
+        self.outer_A = None
+        if self.reorder is not None:
+            if self.orders is None:
+                self.orders = _level_orders(levels, self.reorder)
+            self.outer_A = levels[0].A
+            for lvl, level in enumerate(levels):
+                q = self.orders[lvl]
+                A = _permute(level.A, q, q)
+                if hasattr(level.A, 'symmetry'):
+                    A.symmetry = level.A.symmetry
+                level.A = A
+                if lvl < len(levels) - 1:
+                    qc = self.orders[lvl + 1]
+                    level.P = _permute(level.P, q, qc)
+                    level.R = _permute(level.R, qc, q)
+
+        if self.cycle_dtype is not None:
+            cycle_dtype = np.dtype(self.cycle_dtype)
+            if levels[0].A.dtype.kind == 'c':
+                cycle_dtype = np.promote_types(cycle_dtype, np.complex64)
+            if cycle_dtype != levels[0].A.dtype:
+                if self.outer_A is None:
+                    self.outer_A = levels[0].A
+                for level in levels:
+                    A = level.A.astype(cycle_dtype)
+                    if hasattr(level.A, 'symmetry'):
+                        A.symmetry = level.A.symmetry
+                    level.A = A
+                    if hasattr(level, 'P'):
+                        level.P = level.P.astype(cycle_dtype)
+                        level.R = level.R.astype(cycle_dtype)
+
+        if self.compress:
+            _compress_levels(levels, self.native_cycle_max_nnz)
+
+        for lvl, level in enumerate(levels):
+            if not hasattr(level, 'workspace'):
+                level.workspace = multilevel_solver.workspace()
+            if lvl < len(levels) - 1:
+                nc = levels[lvl + 1].A.shape[0]
+                level.workspace.get('coarse_b', nc, level.A.dtype)
+                level.workspace.get('coarse_x', nc, level.A.dtype)
+
+    def update(self, A):
+        """Recompute the hierarchy for a new operator with the same sparsity.
+
+        Parameters
+        ----------
+        A : csr_matrix, bsr_matrix
+            New fine level operator, with the same format, shape, and
+            sparsity pattern as the operator of the setup
+
+        Returns
+        -------
+        Nothing, the levels, the smoothers, and the coarse solver are
+        recomputed for A in place.
+
+        Notes
+        -----
+        The aggregates of smoothed_aggregation_solver, or the C/F splitting
+        of ruge_stuben_solver, are kept, so that each level keeps its size
+        and the hierarchy keeps its structure.  Only the values are
+        recomputed from A: the tentative prolongators, the smoothed
+        prolongators and restrictions, the Galerkin products, the smoothers
+        (e.g., the Schwarz subdomain inverses), and the coarse solver.  The
+        strength of connection is recomputed only where it is needed, that
+        is, for Ruge-Stuben interpolation and for SA prolongation smoothers
+        that filter by it, unless it was kept with keep=True.  Levels are
+        not added or removed, so the quality of the hierarchy may degrade
+        if the coefficients of A change enough to call for a different
+        coarsening.
+
+        The setup keeps the AggOp, or splitting, of each level for this,
+        whatever its keep parameter.  The near nullspace candidates are
+        those given to the setup, improved again for A if improve_candidates
+        is set.  Where the sparsity patterns of the previous prolongators
+        and coarse operators still hold, only their values are recomputed,
+        without the symbolic phase of the Jacobi prolongation smoother and
+        of the Galerkin product.  For a reordered or compressed hierarchy,
+        the patterns are those of the setup, before reorder and compress,
+        which are kept for this as patterns.
+
+        This is useful for time-dependent problems, where the coefficients
+        of A, but not its sparsity pattern, change in each time step.
+
+        Examples
+        --------
+        >>> from pyamg.gallery import poisson
+        >>> from pyamg import smoothed_aggregation_solver
+        >>> import numpy as np
+        >>> A = poisson((50, 50), format='csr')
+        >>> ml = smoothed_aggregation_solver(A)
+        >>> A2 = A.copy()
+        >>> A2.data *= 2.0
+        >>> ml.update(A2)
+        >>> x = ml.solve(np.ones(A.shape[0]), tol=1e-8)
+
+        """
+        if self.updater is None:
+            raise ValueError('update is only available for the hierarchies '
+                             'of smoothed_aggregation_solver and '
+                             'ruge_stuben_solver')
+
+        old = self.levels[0].A if self.outer_A is None else self.outer_A
+        if not sparse.isspmatrix(A) or A.format != old.format or \
+                A.shape != old.shape or \
+                (A.format == 'bsr' and A.blocksize != old.blocksize) or \
+                not np.array_equal(A.indptr, old.indptr) or \
+                not np.array_equal(A.indices, old.indices):
+            raise ValueError('A must have the format, shape and sparsity '
+                             'pattern of the operator of the setup')
+
+        A = A.asfptype()
+
+        # the spectral radii and smoother data cached on the fine operator
+        # are stale, also when the values of A were changed in place
+        for M in [A, old, self.levels[0].A,
+                  getattr(self.levels[0], 'Acsr', None)]:
+            for name in _CACHED_ATTRIBUTES:
+                if name != 'symmetry' and M is not None and hasattr(M, name):
+                    delattr(M, name)
+
+        if hasattr(old, 'symmetry'):
+            A.symmetry = old.symmetry
+
+        from pyamg.relaxation.smoothing import change_smoothers
+
+        with (self.profile or null_profile).timing_kernels():
+            previous = self.levels if self.patterns is None else\
+                self.patterns
+            levels = self.updater(self.levels, A, profile=self.profile,
+                                  previous=previous)
+            for level, old_level in zip(levels, self.levels):
+                level.workspace = old_level.workspace
+            self.__set_levels(levels)
+            self.coarse_solver.reset()
+            if self.smoother_args is not None:
+                change_smoothers(self, *self.smoother_args)
+
+    def save(self, path):
+        """Write the hierarchy to a binary file, to be read by load.
+
+        Parameters
+        ----------
+        path : string
+            Name of the file, which is overwritten
+
+        Returns
+        -------
+        Nothing, the file is written.
+
+        Notes
+        -----
+        The file holds the matrices A, P, and R, and the other arrays and
+        matrices of each level, e.g., B and AggOp, the data that the
+        smoothers cache on the level matrices (multicolor and Schwarz
+        colorings, Schwarz factors, block diagonal inverses, and spectral
+        radii), the arguments of change_smoothers, and the arguments and
+        dense factorization of the coarse solver.  The arrays are stored in
+        the aligned format of pyamg.util.arrayfile.save_arrays.
+
+        Callable smoothers or coarse solvers can not be saved, and
+        update is not available for a loaded hierarchy.
+
+        Examples
+        --------
+        >>> from pyamg.gallery import poisson
+        >>> from pyamg import smoothed_aggregation_solver, multilevel_solver
+        >>> import numpy as np
+        >>> import tempfile, os
+        >>> A = poisson((50, 50), format='csr')
+        >>> ml = smoothed_aggregation_solver(A)
+        >>> path = os.path.join(tempfile.mkdtemp(), 'hierarchy.bin')
+        >>> ml.save(path)
+        >>> ml2 = multilevel_solver.load(path)
+        >>> x = ml2.solve(np.ones(A.shape[0]), tol=1e-8)
+
+        """
+        from pyamg.util.arrayfile import save_arrays
+
+        encoder = _HierarchyEncoder()
+
+        levels = []
+        for lvl, level in enumerate(self.levels):
+            attributes = {}
+            for name, value in sorted(level.__dict__.items()):
+                if name in ['workspace', 'presmoother', 'postsmoother']:
+                    continue
+                try:
+                    attributes[name] = encoder.encode(value)
+                except TypeError:
+                    if name in ['A', 'P', 'R']:
+                        raise
+                    warn('level %d: %s is not saved' % (lvl, name))
+            levels.append(attributes)
+
+        solver, kwargs = self.coarse_solver.args()
+        if not (solver is None or isinstance(solver, str)):
+            raise TypeError('a callable coarse solver can not be saved')
+        coarse_state = {}
+        for name, value in sorted(self.coarse_solver.__dict__.items()):
+            try:
+                coarse_state[name] = encoder.encode(value)
+            except TypeError:
+                pass
+
+        header = {'format': 'multilevel_solver',
+                  'levels': levels,
+                  'coarse_solver': encoder.encode((solver, kwargs)),
+                  'coarse_state': coarse_state,
+                  'smoother_args': encoder.encode(self.smoother_args),
+                  'cycle_dtype': encoder.encode(self.cycle_dtype),
+                  'reorder': self.reorder,
+                  'orders': encoder.encode(self.orders),
+                  'compress': self.compress,
+                  'outer_A': encoder.encode(self.outer_A),
+                  'matrices': encoder.matrices}
+        if 'native_cycle_max_nnz' in self.__dict__:
+            header['native_cycle_max_nnz'] = self.native_cycle_max_nnz
+        save_arrays(path, encoder.arrays, header)
+
+    @staticmethod
+    def load(path, mmap=True):
+        """Read a hierarchy written by save.
+
+        Parameters
+        ----------
+        path : string
+            Name of the file
+        mmap : bool
+            If True, the arrays of the hierarchy are views of a memory map of
+            the file, see pyamg.util.arrayfile.load_arrays.  Otherwise the
+            file is read into memory.
+
+        Returns
+        -------
+        ml : multilevel_solver
+            The hierarchy, with its smoothers and coarse solver
+
+        Notes
+        -----
+        No setup is repeated: the matrices are constructed around the
+        arrays of the file, which are passed to the amg_core kernels without
+        copies, and the smoothers are set up from the cached colorings,
+        factorizations, and spectral radii.  With mmap=True, only the pages
+        that are used are read, and processes that load the same file share
+        them through the page cache.  The arrays are copy-on-write, so
+        changes to the loaded hierarchy are not written to the file.
+
+        """
+        from pyamg.util.arrayfile import load_arrays
+        from pyamg.relaxation.smoothing import change_smoothers
+
+        header, arrays = load_arrays(path, mmap=mmap)
+        if header.get('format') != 'multilevel_solver':
+            raise ValueError('%s does not hold a multilevel_solver' % path)
+        decoder = _HierarchyDecoder(header['matrices'], arrays)
+
+        levels = []
+        for attributes in header['levels']:
+            level = multilevel_solver.level()
+            for name, value in attributes.items():
+                setattr(level, str(name), decoder.decode(value))
+            levels.append(level)
+
+        # the levels are stored as set up, so that they are not reordered,
+        # converted, or compressed again
+        ml = multilevel_solver(levels,
+                               coarse_solver=decoder.decode(
+                                   header['coarse_solver']))
+        ml.cycle_dtype = decoder.decode(header['cycle_dtype'])
+        ml.reorder = header['reorder']
+        ml.orders = decoder.decode(header['orders'])
+        ml.compress = header['compress']
+        ml.outer_A = decoder.decode(header['outer_A'])
+        if 'native_cycle_max_nnz' in header:
+            ml.native_cycle_max_nnz = header['native_cycle_max_nnz']
+
+        for name, value in header['coarse_state'].items():
+            setattr(ml.coarse_solver, str(name), decoder.decode(value))
+
+        smoother_args = decoder.decode(header['smoother_args'])
+        if smoother_args is not None:
+            change_smoothers(ml, *smoother_args)
+        return ml
+
     def __repr__(self):
         """Print basic statistics about the multigrid hierarchy."""
         output = 'multilevel_solver\n'
@@ -174,6 +640,26 @@ class multilevel_solver:
 
         return output
 
+    def profile_summary(self):
+        """Print the wall time of each phase of the setup and of the cycle.
+
+        Returns
+        -------
+        summary : string
+            Tables of the calls, seconds, and bytes allocated for each
+            phase of the setup and each component of the cycle on every
+            level, followed by the time spent in the amg_core kernels.
+
+        See Also
+        --------
+        pyamg.util.profile.Profile
+
+        """
+        if self.profile is None:
+            return 'no profile, e.g. use smoothed_aggregation_solver' +\
+                '(A, profile=True)\n'
+        return repr(self.profile)
+
     def cycle_complexity(self, cycle='V'):
         """Cycle complexity of V, W, AMLI, and F(1,1) cycle with simple relaxation.
 
@@ -308,12 +794,19 @@ class multilevel_solver:
         from scipy.sparse.linalg import LinearOperator
 
         shape = self.levels[0].A.shape
-        dtype = self.levels[0].A.dtype
+        if self.outer_A is None:
+            dtype = self.levels[0].A.dtype
+        else:
+            dtype = self.outer_A.dtype
 
         def matvec(b):
             return self.solve(b, maxiter=1, cycle=cycle, tol=1e-12)
 
-        return LinearOperator(shape, matvec, dtype=dtype)
+        def matmat(B):
+            # all columns of B are cycled together, see solve
+            return self.solve(B, maxiter=1, cycle=cycle, tol=1e-12)
+
+        return LinearOperator(shape, matvec, matmat=matmat, dtype=dtype)
 
     def solve(self, b, x0=None, tol=1e-5, maxiter=100, cycle='V', accel=None,
               callback=None, residuals=None, return_residuals=False):
@@ -322,9 +815,9 @@ class multilevel_solver:
         Parameters
         ----------
         b : array
-            Right hand side.
+            Right hand side, or N x k array of k right hand sides.
         x0 : array
-            Initial guess.
+            Initial guess, of the same shape as b.
         tol : float
             Stopping criteria: relative residual r[k]/r[0] tolerance.
         maxiter : int
@@ -341,12 +834,34 @@ class multilevel_solver:
             User-defined function called after each iteration.  It is
             called as callback(xk) where xk is the k-th iterate vector.
         residuals : list
-            List to contain residual norms at each iteration.
+            List to contain residual norms at each iteration.  For k right
+            hand sides, each entry is an array of the k residual norms.
 
         Returns
         -------
         x : array
-            Approximate solution to Ax=b
+            Approximate solution to Ax=b, of the same shape as b
+
+        Notes
+        -----
+        If b is an N x k array, all k right hand sides are cycled at once,
+        so that each level matrix is read once per smoothing sweep,
+        residual and correction for all of them.  This uses the kernels for
+        several right hand sides in amg_core when the smoother supports them
+        (gauss_seidel and jacobi on CSR levels), and otherwise relaxes the
+        columns in turn.  Cycling continues until every column meets tol.
+        With accel, or with AMLI cycles, each column is solved separately.
+
+        For one right hand side, V, W, and F cycles run the coarsest levels
+        in amg_core.multigrid_cycle, which performs the smoothing, the
+        restriction, the coarse solve, and the interpolation of all of these
+        levels without returning to Python.  These are the levels, up to
+        native_cycle_max_nnz stored values, whose matrices are CSR or BSR in
+        the same dtype, whose smoothers are None, jacobi, or gauss_seidel
+        (but not multicolor), and whose coarse solver is pinv, pinv2, or lu.
+        The hierarchy of all small problems is cycled completely in C++.
+        Any other level, and every level while a profile is recorded, is
+        cycled in Python.
 
         See Also
         --------
@@ -366,6 +881,13 @@ class multilevel_solver:
         """
         from pyamg.util.linalg import residual_norm, norm
 
+        if self.profile is not None and not self.profile.timing:
+            with self.profile.timing_kernels():
+                return self.solve(b, x0=x0, tol=tol, maxiter=maxiter,
+                                  cycle=cycle, accel=accel, callback=callback,
+                                  residuals=residuals,
+                                  return_residuals=return_residuals)
+
         if x0 is None:
             x = np.zeros_like(b)
         else:
@@ -373,12 +895,24 @@ class multilevel_solver:
 
         cycle = str(cycle).upper()
 
+        # full precision operator, see cycle_dtype in __init__
+        A = self.levels[0].A if self.outer_A is None else self.outer_A
+
         # AMLI cycles require hermitian matrix
-        if (cycle == 'AMLI') and hasattr(self.levels[0].A, 'symmetry'):
-            if self.levels[0].A.symmetry != 'hermitian':
+        if (cycle == 'AMLI') and hasattr(A, 'symmetry'):
+            if A.symmetry != 'hermitian':
                 raise ValueError('AMLI cycles require \
                     symmetry to be hermitian')
 
+        # k right hand sides, stored as the columns of b
+        multiple_rhs = (np.ndim(b) == 2 and b.shape[1] > 1)
+
+        if multiple_rhs and (accel is not None or cycle == 'AMLI'):
+            # Krylov methods and AMLI cycles work on one vector at a time
+            return self.__solve_columns(b, x0, residuals, return_residuals,
+                                        tol=tol, maxiter=maxiter, cycle=cycle,
+                                        accel=accel, callback=callback)
+
         if accel is not None:
 
             # Check for symmetric smoothing scheme when using CG
@@ -410,7 +944,6 @@ class multilevel_solver:
                     accel = getattr(isolve, accel)
                     kwargs['atol'] = 'legacy'
 
-            A = self.levels[0].A
             M = self.aspreconditioner(cycle=cycle)
 
             try:  # try PyAMG style interface which has a residuals parameter
@@ -439,9 +972,14 @@ class multilevel_solver:
         else:
             # Scale tol by normb
             # Don't scale tol earlier. The accel routine should also scale tol
-            normb = norm(b)
-            if normb != 0:
-                tol = tol * normb
+            if multiple_rhs:
+                # scale tol separately for each column of b
+                normb = np.linalg.norm(np.asarray(b), axis=0)
+                tol = tol * np.where(normb != 0, normb, 1)
+            else:
+                normb = norm(b)
+                if normb != 0:
+                    tol = tol * normb
 
         if return_residuals:
             warn('return_residuals is deprecated.  Use residuals instead')
@@ -455,25 +993,49 @@ class multilevel_solver:
         # Clearly, this logic doesn't handle the case of real A and complex b
         from scipy.sparse.sputils import upcast
         from pyamg.util.utils import to_type
-        tp = upcast(b.dtype, x.dtype, self.levels[0].A.dtype)
+        tp = upcast(b.dtype, x.dtype, A.dtype)
         [b, x] = to_type(tp, [b, x])
-        b = np.ravel(b)
-        x = np.ravel(x)
 
-        A = self.levels[0].A
+        if multiple_rhs:
+            # row major, so that the k entries of each row are adjacent
+            b = np.ascontiguousarray(b)
+            x = np.ascontiguousarray(x)
+
+            def block_residual_norm(A, x, b):
+                return np.linalg.norm(b - A * x, axis=0)
+        else:
+            b = np.ravel(b)
+            x = np.ravel(x)
+            block_residual_norm = residual_norm
 
-        residuals.append(residual_norm(A, x, b))
+        residuals.append(block_residual_norm(A, x, b))
 
         self.first_pass = True
 
-        while len(residuals) <= maxiter and residuals[-1] > tol:
-            if len(self.levels) == 1:
+        while len(residuals) <= maxiter and np.any(residuals[-1] > tol):
+            if self.outer_A is not None:
+                # cycle on the residual equation in the precision and the
+                # ordering of the hierarchy, and correct x in full precision
+                r = b - A * x
+                if self.orders is not None:
+                    r = r[self.orders[0]]
+                r = r.astype(self.levels[0].A.dtype)
+                e = np.zeros_like(r)
+                if len(self.levels) == 1:
+                    e = self.coarse_solver(self.levels[0].A, r)
+                else:
+                    self.__solve(0, e, r, cycle, True)
+                if self.orders is not None:
+                    x[self.orders[0]] += e
+                else:
+                    x += e
+            elif len(self.levels) == 1:
                 # hierarchy has only 1 level
                 x = self.coarse_solver(A, b)
             else:
                 self.__solve(0, x, b, cycle)
 
-            residuals.append(residual_norm(A, x, b))
+            residuals.append(block_residual_norm(A, x, b))
 
             self.first_pass = False
 
@@ -485,7 +1047,39 @@ class multilevel_solver:
         else:
             return x
 
-    def __solve(self, lvl, x, b, cycle):
+    def __solve_columns(self, b, x0, residuals, return_residuals, **kwargs):
+        """Call solve for each column of b, and stack the solutions.
+
+        For k right hand sides, residuals is filled with the k residual
+        histories, one per column.
+
+        """
+        b = np.asarray(b)
+        if x0 is not None:
+            x0 = np.asarray(x0)
+
+        if return_residuals:
+            warn('return_residuals is deprecated.  Use residuals instead')
+            residuals = []
+        if residuals is not None:
+            residuals[:] = []
+
+        x = []
+        for j in range(b.shape[1]):
+            res = None if residuals is None else []
+            x.append(self.solve(b[:, j],
+                                x0=None if x0 is None else x0[:, j],
+                                residuals=res, **kwargs))
+            if residuals is not None:
+                residuals.append(res)
+        x = np.column_stack(x)
+
+        if return_residuals:
+            return x, residuals
+        else:
+            return x
+
+    def __solve(self, lvl, x, b, cycle, zero_guess=False):
         """Multigrid cycling.
 
         Parameters
@@ -503,27 +1097,48 @@ class multilevel_solver:
             cycle = 'W',    W-cycle
             cycle = 'F',    F-cycle
             cycle = 'AMLI', AMLI-cycle
+        zero_guess : bool
+            If True, x is zero on entry, which the presmoother may use
 
         """
-        A = self.levels[lvl].A
+        if cycle in _NATIVE_CYCLES and x.ndim == 1 and self.profile is None:
+            native = self.__native_hierarchy()
+            if native is not None and lvl == native['start'] and\
+                    x.dtype == b.dtype == native['data'].dtype and\
+                    x.flags.carray and b.flags.carray:
+                from pyamg import amg_core
+                work = self.levels[lvl].workspace.get('native_cycle',
+                                                      native['work'],
+                                                      x.dtype)
+                amg_core.multigrid_cycle(native['levels'], native['index'],
+                                         native['data'], work,
+                                         x, b, _NATIVE_CYCLES[cycle])
+                return
 
-        self.levels[lvl].presmoother(A, x, b)
+        A = self.levels[lvl].A
+        profile = null_profile if self.profile is None else self.profile
 
-        residual = b - A * x
+        profile.start()
+        self.__smooth(self.levels[lvl].presmoother, A, x, b, zero_guess)
+        profile.lap('solve', lvl, 'presmooth')
 
-        coarse_b = self.levels[lvl].R * residual
-        coarse_x = np.zeros_like(coarse_b)
+        coarse_b = self.__restrict_residual(self.levels[lvl], x, b)
+        coarse_x = self.levels[lvl].workspace.get('coarse_x', coarse_b.shape,
+                                                  coarse_b.dtype)
+        coarse_x.fill(0)
+        profile.lap('solve', lvl, 'restrict')
 
         if lvl == len(self.levels) - 2:
             coarse_x[:] = self.coarse_solver(self.levels[-1].A, coarse_b)
+            profile.lap('solve', lvl + 1, 'coarse_solve')
         else:
             if cycle == 'V':
-                self.__solve(lvl + 1, coarse_x, coarse_b, 'V')
+                self.__solve(lvl + 1, coarse_x, coarse_b, 'V', True)
             elif cycle == 'W':
-                self.__solve(lvl + 1, coarse_x, coarse_b, cycle)
+                self.__solve(lvl + 1, coarse_x, coarse_b, cycle, True)
                 self.__solve(lvl + 1, coarse_x, coarse_b, cycle)
             elif cycle == 'F':
-                self.__solve(lvl + 1, coarse_x, coarse_b, cycle)
+                self.__solve(lvl + 1, coarse_x, coarse_b, cycle, True)
                 self.__solve(lvl + 1, coarse_x, coarse_b, 'V')
             elif cycle == "AMLI":
                 # Run nAMLI AMLI cycles, which compute "optimal" corrections by
@@ -557,9 +1172,649 @@ class multilevel_solver:
             else:
                 raise TypeError('Unrecognized cycle type (%s)' % cycle)
 
-        x += self.levels[lvl].P * coarse_x   # coarse grid correction
+        profile.start()
+        self.__prolongate_add(self.levels[lvl], coarse_x, x)  # correction
+        profile.lap('solve', lvl, 'prolongate')
+
+        self.__smooth(self.levels[lvl].postsmoother, A, x, b)
+        profile.lap('solve', lvl, 'postsmooth')
 
-        self.levels[lvl].postsmoother(A, x, b)
+    def __smooth(self, smoother, A, x, b, zero_guess=False):
+        """Apply smoother(A, x, b) in place.
+
+        For k right hand sides, i.e., N x k arrays x and b, the columns are
+        relaxed one at a time unless the smoother handles all of them at
+        once, which is marked by its multiple_rhs attribute.  If x is zero
+        on entry, zero_guess is passed on to the smoothers that accept it,
+        which is marked by their zero_guess attribute.
+
+        """
+        kwargs = {}
+        if zero_guess and getattr(smoother, 'zero_guess', False):
+            kwargs['zero_guess'] = True
+        if x.ndim == 2 and not getattr(smoother, 'multiple_rhs', False):
+            from pyamg.relaxation.relaxation import relax_columns
+            relax_columns(smoother, A, x, b, **kwargs)
+        else:
+            smoother(A, x, b, **kwargs)
+
+    def __restrict_residual(self, level, x, b):
+        """Restrict the residual, coarse_b = R * (b - A * x).
+
+        Parameters
+        ----------
+        level : multilevel_solver.level
+            Level containing A and R
+        x : numpy array
+            Current approximation on this level
+        b : numpy array
+            Right-hand side on this level
+
+        Returns
+        -------
+        coarse_b : numpy array
+            Restricted residual
+
+        Notes
+        -----
+        If A is CSR or BSR, then the residual and restriction are fused
+        into a single pass by amg_core (csr/bsr_residual_restrict), which
+        does not form the fine-level residual.  This requires R^T in the
+        same format as A, which is computed once and stored as level.RT.
+        Otherwise, or if the dtypes do not agree, the residual is formed
+        explicitly.
+
+        For k right hand sides, i.e., N x k arrays x and b, only CSR
+        matrices are fused (csr_residual_restrict_multi).
+
+        """
+        from pyamg import amg_core
+
+        A = level.A
+        R = level.R
+        RT = self.__restriction_transpose(level)
+        if RT is None or not (A.dtype == RT.dtype == x.dtype == b.dtype) or\
+                _index_dtype([A, RT]) is None or\
+                x.shape != b.shape or x.ndim > 2 or\
+                (x.ndim == 2 and not sparse.isspmatrix_csr(A)):
+            return R * (b - A * x)
+
+        if x.ndim == 2:
+            nrhs = x.shape[1]
+            coarse_b = level.workspace.get('coarse_b', (RT.shape[1], nrhs),
+                                           A.dtype)
+            amg_core.csr_residual_restrict_multi(A.indptr, A.indices, A.data,
+                                                 np.ravel(x), np.ravel(b),
+                                                 RT.indptr, RT.indices,
+                                                 RT.data,
+                                                 coarse_b.reshape(-1), nrhs)
+            return coarse_b
+
+        coarse_b = level.workspace.get('coarse_b', RT.shape[1], A.dtype)
+        if sparse.isspmatrix_csr(A):
+            amg_core.csr_residual_restrict(A.indptr, A.indices, A.data, x, b,
+                                           RT.indptr, RT.indices, RT.data,
+                                           coarse_b)
+        else:
+            amg_core.bsr_residual_restrict(A.indptr, A.indices,
+                                           np.ravel(A.data), x, b,
+                                           RT.indptr, RT.indices,
+                                           np.ravel(RT.data), coarse_b,
+                                           A.blocksize[0], RT.blocksize[1])
+        return coarse_b
+
+    def __restriction_transpose(self, level):
+        """Return R^T in the format of A, stored as level.RT, or None."""
+        if not hasattr(level, 'RT'):
+            A = level.A
+            R = level.R
+            level.RT = None
+            if sparse.isspmatrix_csr(A) and sparse.isspmatrix(R):
+                level.RT = R.T.tocsr()
+            elif sparse.isspmatrix_bsr(A) and sparse.isspmatrix(R) and\
+                    A.blocksize[0] == A.blocksize[1]:
+                RT = R.T
+                if not (sparse.isspmatrix_bsr(RT) and
+                        RT.blocksize[0] == A.blocksize[0]):
+                    RT = RT.tobsr(blocksize=(A.blocksize[0], 1))
+                level.RT = RT
+        return level.RT
+
+    def __native_hierarchy(self):
+        """Pack the coarsest levels for amg_core.multigrid_cycle.
+
+        Returns
+        -------
+        native : dict
+            The first level of the native cycle as 'start', the level
+            descriptors, index, and data arrays of amg_core.multigrid_cycle,
+            and the size of its work array as 'work', or None if the
+            coarsest two levels can not be cycled natively.  See solve.
+
+        Notes
+        -----
+        The arrays are copies of the levels, which are packed on the first
+        call and again whenever a level matrix or smoother is replaced,
+        e.g., by change_smoothers or update, or native_cycle_max_nnz is
+        changed.  The work array is taken from the workspace of the first
+        level, so that each thread cycles in its own.
+
+        """
+        levels = self.levels
+        for level in levels[:-1]:
+            self.__restriction_transpose(level)
+        key = [levels[-1].A] +\
+            [getattr(level, name, None) for level in levels[:-1]
+             for name in ['A', 'P', 'RT', 'presmoother', 'postsmoother']]
+        if self.native is not None and\
+                self.native[0] == self.native_cycle_max_nnz and\
+                len(key) == len(self.native[1]) and\
+                all(a is b for a, b in zip(key, self.native[1])):
+            return self.native[2]
+
+        # self.native is only replaced once the pack is complete, so that
+        # a concurrent solve never sees a partial pack
+        not_native = (self.native_cycle_max_nnz, key, None)
+
+        dtype = levels[-1].A.dtype
+        coarse = self.coarse_solver.factorization(levels[-1].A)
+        if coarse is None or len(levels) == 1:
+            self.native = not_native
+            return None
+
+        # the coarsest levels that are supported, within native_cycle_max_nnz
+        nnz = levels[-1].A.shape[0]**2
+        start = len(levels) - 1
+        while start > 0:
+            level = levels[start - 1]
+            matrices = [level.A, level.P, level.RT]
+            smoothers = [getattr(level, 'presmoother', None),
+                         getattr(level, 'postsmoother', None)]
+            if not _native_level(matrices, smoothers, dtype):
+                break
+            nnz += sum(M.data.size for M in matrices)
+            if nnz > self.native_cycle_max_nnz:
+                break
+            start -= 1
+
+        if start == len(levels) - 1:
+            self.native = not_native
+            return None
+
+        # the widest index dtype of the levels, intc or int64
+        index_dtype = np.result_type(*[_index_dtype([level.A, level.P,
+                                                     level.RT])
+                                       for level in levels[start:-1]])
+        index = []
+        data = []
+
+        def append(arrays, array):
+            # offset of array in the concatenation of arrays
+            offset = sum(a.size for a in arrays)
+            arrays.append(np.ravel(array))
+            return offset
+
+        descriptors = np.zeros((len(levels) - start, _CYCLE_LEVEL_SIZE),
+                               dtype=index_dtype)
+        work = 0
+        for d, level in zip(descriptors[:-1], levels[start:-1]):
+            A = level.A
+            P = level.P
+            RT = level.RT
+            d[0] = A.shape[0]
+            if sparse.isspmatrix_bsr(A):
+                d[1] = A.blocksize[0]
+                d[5] = RT.blocksize[1]
+            d[2:5] = [append(index, A.indptr), append(index, A.indices),
+                      append(data, A.data)]
+            d[6:9] = [append(index, RT.indptr), append(index, RT.indices),
+                      append(data, RT.data)]
+            if sparse.isspmatrix_bsr(P):
+                d[9:11] = P.blocksize
+            else:
+                d[10] = 1
+            d[11:14] = [append(index, P.indptr), append(index, P.indices),
+                        append(data, P.data)]
+            for j, smoother in [(14, level.presmoother),
+                                (17, level.postsmoother)]:
+                method, iterations, parameter = smoother.native
+                if method == 'gauss_seidel':
+                    parameter = _NATIVE_SWEEPS[parameter]
+                elif method == 'jacobi':
+                    parameter = append(data, np.array([parameter],
+                                                      dtype=dtype))
+                else:
+                    parameter = 0
+                d[j:j+3] = [_NATIVE_SMOOTHERS[method], iterations, parameter]
+            d[20] = work
+            work += 3 * A.shape[0]
+
+        d = descriptors[-1]
+        method, factorization = coarse
+        d[0] = levels[-1].A.shape[0]
+        d[1] = _NATIVE_COARSE_SOLVERS[method]
+        if method == 'pinv':
+            d[2] = append(data, factorization)
+        elif method == 'lu':
+            d[2] = append(data, factorization[0])
+            d[3] = append(index, factorization[1])
+        d[20] = work
+        work += 3 * d[0]
+
+        native = {'start': start,
+                  'levels': np.ravel(descriptors),
+                  'index': np.concatenate(index).astype(index_dtype),
+                  'data': np.concatenate(data).astype(dtype),
+                  'work': work}
+        self.native = (self.native_cycle_max_nnz, key, native)
+        return native
+
+    def __prolongate_add(self, level, coarse_x, x):
+        """Apply the coarse grid correction, x += P * coarse_x, in place.
+
+        If P is CSR or BSR, the correction is added by amg_core
+        (csr/bsr_prolongate_add) without forming P * coarse_x.  For k right
+        hand sides, i.e., N x k arrays x, only CSR P is handled by amg_core
+        (csr_prolongate_add_multi).
+
+        """
+        from pyamg import amg_core
+
+        P = level.P
+        if not (sparse.isspmatrix_csr(P) or sparse.isspmatrix_bsr(P)) or\
+                not (P.dtype == coarse_x.dtype == x.dtype) or\
+                _index_dtype([P]) is None or\
+                coarse_x.ndim != x.ndim or x.ndim > 2 or\
+                (x.ndim == 2 and not (sparse.isspmatrix_csr(P) and
+                                      x.flags.carray)):
+            x += P * coarse_x
+        elif x.ndim == 2:
+            amg_core.csr_prolongate_add_multi(P.indptr, P.indices, P.data,
+                                              np.ravel(coarse_x),
+                                              x.reshape(-1), x.shape[1])
+        elif sparse.isspmatrix_csr(P):
+            amg_core.csr_prolongate_add(P.indptr, P.indices, P.data,
+                                        coarse_x, x)
+        else:
+            amg_core.bsr_prolongate_add(P.indptr, P.indices, np.ravel(P.data),
+                                        coarse_x, x,
+                                        P.blocksize[0], P.blocksize[1])
+
+
+def _native_level(matrices, smoothers, dtype):
+    """Whether amg_core.multigrid_cycle supports a level.
+
+    The matrices [A, P, R^T] must be CSR or BSR with square blocks in
+    dtype, with R^T in the format of A, and both smoothers must be native,
+    see setup_gauss_seidel.
+    """
+    A, P, RT = matrices
+    if sparse.isspmatrix_csr(A):
+        supported = sparse.isspmatrix_csr(RT)
+    elif sparse.isspmatrix_bsr(A) and A.blocksize[0] == A.blocksize[1]:
+        supported = sparse.isspmatrix_bsr(RT) and\
+            RT.blocksize[0] == A.blocksize[0]
+    else:
+        supported = False
+
+    return supported and\
+        (sparse.isspmatrix_csr(P) or sparse.isspmatrix_bsr(P)) and\
+        all(M.dtype == dtype for M in matrices) and\
+        _index_dtype(matrices) is not None and\
+        all(getattr(smoother, 'native', None) is not None
+            for smoother in smoothers)
+
+
+def _compress_levels(levels, max_nnz):
+    """Store A, P, and R of the levels in compressed formats.
+
+    The levels from the coarsest one up to max_nnz stored values are not
+    compressed, as the levels of amg_core.multigrid_cycle.  See
+    multilevel_solver.__init__.
+    """
+    from pyamg.util.compressed import delta_csr_matrix, aggregate_matrix
+
+    def delta(M):
+        try:
+            return delta_csr_matrix(M)
+        except ValueError:
+            return M
+
+    nnz = levels[-1].A.shape[0]**2
+    for lvl in reversed(range(len(levels) - 1)):
+        level = levels[lvl]
+        nnz += level.A.nnz + level.P.nnz + level.R.nnz
+        if nnz <= max_nnz:
+            continue
+
+        if lvl > 0 and sparse.isspmatrix_csr(level.A):
+            A = delta(level.A)
+            if hasattr(level.A, 'symmetry'):
+                A.symmetry = level.A.symmetry
+            level.A = A
+
+        P = level.P
+        R = level.R
+        if not (sparse.isspmatrix_csr(P) or sparse.isspmatrix_bsr(P)) or\
+                not sparse.isspmatrix(R) or R.shape != P.shape[::-1] or\
+                abs(R - P.H).nnz > 0:
+            continue
+        if P.indptr.size == 1 or np.diff(P.indptr).max() <= 1:
+            compressed = aggregate_matrix(P)
+        elif sparse.isspmatrix_csr(P) or P.blocksize == (1, 1):
+            compressed = delta(P.tocsr())
+        else:
+            continue
+        if isinstance(compressed, (aggregate_matrix, delta_csr_matrix)):
+            level.P = compressed
+            level.R = compressed.H
+            # saved as the adjoint of P, see _HierarchyEncoder
+            level.R.adjoint_of = compressed
+
+
+def _level_patterns(levels):
+    """Return the sparsity patterns of A, P, and R of the levels for update.
+
+    Each pattern is a CSR or BSR matrix that shares the index arrays of
+    the level matrix, with a read-only, zero strided data array, so that
+    the values are not kept twice.  Other matrices are kept as they are.
+    See multilevel_solver.update.
+    """
+    def pattern(M):
+        if not (sparse.isspmatrix_csr(M) or sparse.isspmatrix_bsr(M)):
+            return M
+        data = np.lib.stride_tricks.as_strided(
+            np.zeros(1, dtype=M.dtype), shape=M.data.shape,
+            strides=(0,) * M.data.ndim, writeable=False)
+        pattern = M.__class__((data, M.indices, M.indptr), shape=M.shape)
+        pattern.has_sorted_indices = M.has_sorted_indices
+        return pattern
+
+    patterns = []
+    for level in levels:
+        patterns.append(multilevel_solver.level())
+        for name in ['A', 'P', 'R']:
+            if hasattr(level, name):
+                setattr(patterns[-1], name, pattern(getattr(level, name)))
+    return patterns
+
+
+def _level_orders(levels, method):
+    """Return the permutation of the unknowns of each level for reorder.
+
+    A level with a BSR matrix with square blocks is permuted by blocks.
+    See multilevel_solver.__init__.
+    """
+    from pyamg.graph import reverse_cuthill_mckee
+
+    def blocksize(A):
+        if sparse.isspmatrix_bsr(A) and A.blocksize[0] == A.blocksize[1]:
+            return A.blocksize[0]
+        return 1
+
+    def graph(A):
+        # the graph of the blocks of A
+        b = blocksize(A)
+        if b == 1:
+            return A.tocsr()
+        return sparse.csr_matrix((np.ones(A.indices.size), A.indices,
+                                  A.indptr),
+                                 shape=(A.shape[0] // b, A.shape[1] // b))
+
+    if method == 'rcm':
+        orders = [reverse_cuthill_mckee(graph(level.A)) for level in levels]
+    elif method == 'aggregate':
+        orders = [reverse_cuthill_mckee(graph(levels[-1].A))]
+        for level in reversed(levels[:-1]):
+            AggOp = getattr(level, 'AggOp', None)
+            coarse = orders[0]
+            if AggOp is None or\
+                    AggOp.shape != (level.A.shape[0] // blocksize(level.A),
+                                    coarse.size):
+                raise ValueError('reorder=\'aggregate\' requires the '
+                                 'aggregates (AggOp) of the nodes of each '
+                                 'level, one per node of the next level')
+            AggOp = AggOp.tocsr()
+
+            # the position of each aggregate in the coarse ordering, and
+            # the nodes in no aggregate last
+            rank = np.empty_like(coarse)
+            rank[coarse] = np.arange(coarse.size)
+            key = np.full(AggOp.shape[0], coarse.size, dtype=rank.dtype)
+            rows = np.repeat(np.arange(AggOp.shape[0]), np.diff(AggOp.indptr))
+            key[rows] = rank[AggOp.indices]
+            orders.insert(0, np.argsort(key, kind='mergesort'))
+    else:
+        raise ValueError('unknown reorder method (%s)' % method)
+
+    # the permutations of the unknowns, with the blocks of A kept together
+    for lvl, level in enumerate(levels):
+        b = blocksize(level.A)
+        orders[lvl] = (b * orders[lvl][:, np.newaxis] + np.arange(b)).ravel()
+    return orders
+
+
+def _permute(M, rows, cols):
+    """Return M[rows, :][:, cols] as CSR, or as BSR if M is BSR.
+
+    A BSR matrix is permuted by blocks if rows and cols keep its blocks
+    together, and otherwise converted back to its blocksize.
+    """
+    def blocked(q, b):
+        q = q.reshape(-1, b)
+        return np.all(q[:, 0] % b == 0) and\
+            np.all(q - q[:, :1] == np.arange(b))
+
+    if sparse.isspmatrix_bsr(M):
+        R, C = M.blocksize
+        if not (blocked(rows, R) and blocked(cols, C)):
+            return M.tocsr()[rows, :][:, cols].tobsr(blocksize=(R, C))
+
+        # permute the pattern of the blocks, with the block numbers plus one
+        # as its values
+        blocks = sparse.csr_matrix((np.arange(1, M.indices.size + 1),
+                                    M.indices, M.indptr),
+                                   shape=(M.shape[0] // R, M.shape[1] // C))
+        blocks = blocks[rows[::R] // R, :][:, cols[::C] // C]
+        blocks.sort_indices()
+        return sparse.bsr_matrix((M.data[blocks.data - 1], blocks.indices,
+                                  blocks.indptr), shape=M.shape)
+
+    M = M.tocsr()[rows, :][:, cols]
+    M.sort_indices()
+    return M
+
+
+def _index_dtype(matrices):
+    """Return the common index dtype of sparse matrices for amg_core.
+
+    The indptr and indices of all matrices must be the same dtype, intc or
+    int64, for which amg_core is instantiated, so that they are passed
+    without a copy.  Otherwise, None is returned.
+    """
+    dtypes = set(np.dtype(a.dtype) for M in matrices
+                 for a in [M.indptr, M.indices])
+    if len(dtypes) == 1 and dtypes <= {np.dtype(np.intc),
+                                       np.dtype(np.int64)}:
+        return dtypes.pop()
+    return None
+
+
+# data that the smoothers cache on the level matrices, which is saved with
+# them by multilevel_solver.save
+_CACHED_ATTRIBUTES = ['symmetry', 'rho', 'rho_D_inv', 'rho_block_D_inv',
+                      'block_D', 'block_D_inv', 'multicolor_parameters',
+                      'schwarz_parameters', 'schwarz_factors',
+                      'schwarz_colors']
+
+
+class _HierarchyEncoder:
+    """Describe the data of a hierarchy in JSON, for multilevel_solver.save.
+
+    The arrays are collected in arrays, and the matrices in matrices, keyed
+    by number, so that a matrix that is referenced more than once, e.g., as
+    A and Acsr of a level, is stored once.  Values that can not be encoded
+    raise a TypeError.
+
+    A LinearOperator with an adjoint_of attribute, i.e. the R = P^H that
+    _compress_levels keeps for a compressed P, is stored as the adjoint of
+    that matrix, rather than by its own class.
+    """
+
+    def __init__(self):
+        self.arrays = {}
+        self.matrices = {}
+        self.keys = {}
+        self.encoded = []
+
+    def array(self, a):
+        if a.dtype.kind not in 'biufc':
+            raise TypeError('arrays of dtype %s can not be saved' % a.dtype)
+        name = 'a%d' % len(self.arrays)
+        self.arrays[name] = a
+        return name
+
+    def encode(self, value):
+        from scipy.sparse.linalg import LinearOperator
+
+        if value is None or isinstance(value, (bool, str)):
+            return value
+        if isinstance(value, (np.bool_, np.integer, np.floating)):
+            return value.item()
+        if isinstance(value, (int, float)):
+            return value
+        if isinstance(value, (complex, np.complexfloating)):
+            return {'complex': [value.real, value.imag]}
+        if isinstance(value, np.dtype) or\
+                (isinstance(value, type) and issubclass(value, np.generic)):
+            return {'dtype': np.dtype(value).str}
+        if isinstance(value, np.ndarray):
+            return {'array': self.array(value)}
+        if isinstance(value, tuple):
+            return {'tuple': [self.encode(v) for v in value]}
+        if isinstance(value, list):
+            return [self.encode(v) for v in value]
+        if isinstance(value, dict):
+            if not all(isinstance(k, str) for k in value):
+                raise TypeError('dictionaries with keys other than strings '
+                                'can not be saved')
+            return {'dict': dict((k, self.encode(v))
+                                 for k, v in value.items())}
+        if isinstance(value, LinearOperator) and\
+                getattr(value, 'adjoint_of', None) is not None:
+            return {'adjoint': self.encode(value.adjoint_of)}
+        return {'matrix': self.matrix(value)}
+
+    def matrix(self, M):
+        from pyamg.util.compressed import delta_csr_matrix, aggregate_matrix
+
+        key = self.keys.get(id(M))
+        if key is not None:
+            return key
+
+        if sparse.isspmatrix(M) and M.format in ['csr', 'csc', 'bsr']:
+            description = {'indptr': self.array(M.indptr),
+                           'indices': self.array(M.indices),
+                           'data': self.array(M.data),
+                           'sorted': bool(M.has_sorted_indices)}
+        elif isinstance(M, delta_csr_matrix):
+            description = {'indptr': self.array(M.indptr),
+                           'base': self.array(M.base),
+                           'offsets': self.array(M.offsets),
+                           'data': self.array(M.data)}
+        elif isinstance(M, aggregate_matrix):
+            description = {'aggregates': self.array(M.aggregates),
+                           'data': self.array(M.data)}
+        else:
+            raise TypeError('%s can not be saved' % type(M).__name__)
+        description['format'] = M.format
+        description['shape'] = [int(n) for n in M.shape]
+        description['attributes'] = dict(
+            (name, self.encode(getattr(M, name)))
+            for name in _CACHED_ATTRIBUTES if hasattr(M, name))
+
+        key = str(len(self.matrices))
+        self.matrices[key] = description
+        self.keys[id(M)] = key
+        # keep M, so that its id is not reused
+        self.encoded.append(M)
+        return key
+
+
+class _HierarchyDecoder:
+    """Construct the data described by _HierarchyEncoder, around arrays.
+
+    The matrices are constructed once each, without copies of the arrays.
+    """
+
+    def __init__(self, matrices, arrays):
+        self.matrices = matrices
+        self.arrays = arrays
+        self.decoded = {}
+
+    def decode(self, value):
+        if isinstance(value, list):
+            return [self.decode(v) for v in value]
+        if isinstance(value, type(u'')):
+            return str(value)
+        if not isinstance(value, dict):
+            return value
+        if 'array' in value:
+            return self.arrays[value['array']]
+        if 'tuple' in value:
+            return tuple(self.decode(v) for v in value['tuple'])
+        if 'dict' in value:
+            return dict((str(k), self.decode(v))
+                        for k, v in value['dict'].items())
+        if 'complex' in value:
+            return complex(*value['complex'])
+        if 'dtype' in value:
+            return np.dtype(str(value['dtype']))
+        if 'adjoint' in value:
+            M = self.decode(value['adjoint'])
+            adjoint = M.H
+            adjoint.adjoint_of = M
+            return adjoint
+        return self.matrix(value['matrix'])
+
+    def matrix(self, key):
+        from pyamg.util.compressed import delta_csr_matrix, aggregate_matrix
+
+        if key in self.decoded:
+            return self.decoded[key]
+
+        description = self.matrices[key]
+        arrays = dict((name, self.arrays[description[name]])
+                      for name in ['indptr', 'indices', 'data', 'base',
+                                   'offsets', 'aggregates']
+                      if name in description)
+        format = description['format']
+        shape = tuple(description['shape'])
+        data = arrays['data']
+
+        if format in ['csr', 'csc', 'bsr']:
+            # set the arrays directly, the constructors may copy them
+            if format == 'bsr':
+                M = sparse.bsr_matrix(shape, blocksize=data.shape[1:],
+                                      dtype=data.dtype)
+            else:
+                M = getattr(sparse, format + '_matrix')(shape,
+                                                        dtype=data.dtype)
+            M.data = data
+            M.indices = arrays['indices']
+            M.indptr = arrays['indptr']
+            M.has_sorted_indices = description['sorted']
+        elif format == 'dcsr':
+            M = delta_csr_matrix((arrays['indptr'], arrays['base'],
+                                  arrays['offsets'], data), shape=shape)
+        else:
+            M = aggregate_matrix((arrays['aggregates'], data), shape=shape)
+
+        for name, value in description['attributes'].items():
+            setattr(M, str(name), self.decode(value))
+
+        self.decoded[key] = M
+        return M
 
 
 def coarse_grid_solver(solver):
@@ -616,6 +1871,11 @@ def coarse_grid_solver(solver):
 
     solver, kwargs = unpack_arg(solver)
 
+    # the dense solvers take an N x k right hand side directly, the
+    # others are called once for each column
+    multiple_rhs = isinstance(solver, str) and\
+        solver in ['pinv', 'pinv2', 'lu', 'cholesky']
+
     if solver in ['pinv', 'pinv2']:
         def solve(self, A, b):
             if not hasattr(self, 'P'):
@@ -710,6 +1970,10 @@ def coarse_grid_solver(solver):
             if A.nnz == 0:
                 # if A.nnz = 0, then we expect no correction
                 x = np.zeros(b.shape)
+            elif b.ndim == 2 and b.shape[1] > 1 and not multiple_rhs:
+                x = np.column_stack([
+                    np.ravel(solve(self, A, np.ascontiguousarray(b[:, j])))
+                    for j in range(b.shape[1])])
             else:
                 x = solve(self, A, b)
 
@@ -724,6 +1988,33 @@ def coarse_grid_solver(solver):
 
             return x.reshape(b.shape)
 
+        def reset(self):
+            # drop the factorization of the previous A
+            self.__dict__.clear()
+
+        def factorization(self, A):
+            """Return the dense factorization of A for the native cycle.
+
+            This is ('pinv', M) with the pseudoinverse M of A for pinv and
+            pinv2, ('lu', (lu, piv)) as returned by scipy.linalg.lu_factor
+            for lu, ('zero', None) if A is zero, and None for any other
+            solver.
+            """
+            if A.nnz == 0:
+                return ('zero', None)
+            if solver not in ['pinv', 'pinv2', 'lu']:
+                return None
+
+            if not (hasattr(self, 'P') or hasattr(self, 'LU')):
+                solve(self, A, np.zeros(A.shape[0], dtype=A.dtype))
+            if solver == 'lu':
+                return ('lu', self.LU)
+            return ('pinv', self.P)
+
+        def args(self):
+            """Return the solver and its arguments, as passed."""
+            return solver, kwargs
+
         def __repr__(self):
             return 'coarse_grid_solver(' + repr(solver) + ')'
 
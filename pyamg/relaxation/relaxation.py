@@ -7,11 +7,13 @@ import numpy as np
 from scipy import sparse
 
 from pyamg.util.utils import type_prep, get_diagonal, get_block_diag
+from pyamg.util.compressed import delta_csr_matrix
 from pyamg import amg_core
 from scipy.linalg import lapack as la
 
 __all__ = ['sor', 'gauss_seidel', 'jacobi', 'polynomial',
-           'schwarz', 'schwarz_parameters',
+           'schwarz', 'schwarz_parameters', 'schwarz_factors',
+           'schwarz_colors', 'multicolor_parameters',
            'jacobi_ne', 'gauss_seidel_ne', 'gauss_seidel_nr',
            'gauss_seidel_indexed', 'block_jacobi', 'block_gauss_seidel']
 
@@ -27,7 +29,7 @@ def make_system(A, x, b, formats=None):
         n-vector, initial guess
     b : array
         n-vector, right-hand side
-    formats: {'csr', 'csc', 'bsr', 'lil', 'dok',...}
+    formats: {'csr', 'csc', 'bsr', 'lil', 'dok', 'dcsr',...}
         desired sparse matrix format
         default is no change to A's format
 
@@ -42,6 +44,9 @@ def make_system(A, x, b, formats=None):
     such as checking for compatible dimensions and checking
     for compatible type, i.e. float or complex.
 
+    A delta_csr_matrix, see pyamg.util.compressed, is kept if 'dcsr' is
+    one of the formats, and otherwise decoded to CSR.
+
     Examples
     --------
     >>> from pyamg.relaxation.relaxation import make_system
@@ -59,7 +64,12 @@ def make_system(A, x, b, formats=None):
     csc
 
     """
-    if formats is None:
+    if isinstance(A, delta_csr_matrix) and formats is not None and\
+            'dcsr' not in formats:
+        warn('implicit conversion to CSR', sparse.SparseEfficiencyWarning)
+        A = A.tocsr()
+
+    if formats is None or isinstance(A, delta_csr_matrix):
         pass
     elif formats == ['csr']:
         if sparse.isspmatrix_csr(A):
@@ -102,12 +112,77 @@ def make_system(A, x, b, formats=None):
     return A, x, b
 
 
-def sor(A, x, b, omega, iterations=1, sweep='forward'):
+def make_multi_system(A, x, b):
+    """Return A,x,b suitable for relaxation with several right-hand sides.
+
+    Parameters
+    ----------
+    A : csr_matrix
+        n x n system
+    x : array
+        n x k array, initial guesses, one per column
+    b : array
+        n x k array, right-hand sides, one per column
+
+    Returns
+    -------
+    (A,x,b), where x and b are raveled in row major order, i.e. (n*k,)
+    vectors, and x is a view of the input x.
+
+    Notes
+    -----
+    The amg_core kernels for several right-hand sides, e.g.
+    gauss_seidel_multi, read each entry of A once for all k vectors.  This
+    requires the k entries of a row of x and b to be adjacent, so x must be
+    C-contiguous.
+
+    """
+    if not isinstance(x, np.ndarray):
+        raise ValueError('expected numpy array for argument x')
+    if not isinstance(b, np.ndarray):
+        raise ValueError('expected numpy array for argument b')
+
+    M, N = A.shape
+
+    if M != N:
+        raise ValueError('expected square matrix')
+
+    if x.ndim != 2 or x.shape[0] != M:
+        raise ValueError('x has invalid dimensions')
+    if b.shape != x.shape:
+        raise ValueError('b has invalid dimensions')
+
+    if A.dtype != x.dtype or A.dtype != b.dtype:
+        raise TypeError('arguments A, x, and b must have the same dtype')
+
+    if not x.flags.carray:
+        raise ValueError('x must be contiguous in memory')
+
+    x = x.reshape(-1)
+    b = np.ascontiguousarray(b).reshape(-1)
+
+    return A, x, b
+
+
+def relax_columns(relax, A, x, b, **kwargs):
+    """Apply relax(A, x, b, **kwargs) to each column of x and b in turn.
+
+    Used for the relaxation methods, and matrix formats, that have no
+    kernel for several right-hand sides.  x is modified in place.
+
+    """
+    for j in range(x.shape[1]):
+        xj = np.array(x[:, j])
+        relax(A, xj, np.ascontiguousarray(b[:, j]), **kwargs)
+        x[:, j] = xj
+
+
+def sor(A, x, b, omega, iterations=1, sweep='forward', workspace=None):
     """Perform SOR iteration on the linear system Ax=b.
 
     Parameters
     ----------
-    A : csr_matrix, bsr_matrix
+    A : csr_matrix, bsr_matrix, delta_csr_matrix
         Sparse NxN matrix
     x : ndarray
         Approximate solution (length N)
@@ -119,6 +194,8 @@ def sor(A, x, b, omega, iterations=1, sweep='forward'):
         Number of iterations to perform
     sweep : {'forward','backward','symmetric'}
         Direction of sweep
+    workspace : multilevel_solver.workspace
+        Scratch space reused between calls, see scratch_space
 
     Returns
     -------
@@ -153,9 +230,9 @@ def sor(A, x, b, omega, iterations=1, sweep='forward'):
     >>> x = sa.solve(b, x0=x0, tol=1e-8, residuals=residuals)
 
     """
-    A, x, b = make_system(A, x, b, formats=['csr', 'bsr'])
+    A, x, b = make_system(A, x, b, formats=['csr', 'bsr', 'dcsr'])
 
-    x_old = np.empty_like(x)
+    x_old = scratch_space(workspace, 'sor', x.shape, x.dtype)
 
     for i in range(iterations):
         x_old[:] = x
@@ -168,7 +245,8 @@ def sor(A, x, b, omega, iterations=1, sweep='forward'):
 
 
 def schwarz(A, x, b, iterations=1, subdomain=None, subdomain_ptr=None,
-            inv_subblock=None, inv_subblock_ptr=None, sweep='forward'):
+            inv_subblock=None, inv_subblock_ptr=None, sweep='forward',
+            workspace=None):
     """Perform Overlapping multiplicative Schwarz on the linear system Ax=b.
 
     Parameters
@@ -195,8 +273,10 @@ def schwarz(A, x, b, iterations=1, subdomain=None, subdomain_ptr=None,
         inv_subblock[inv_subblock_ptr[i]:inv_subblock_ptr[i+1]]]
         contains the inverted diagonal block of A for the
         i-th subdomain in _row_ major order
-    sweep : {'forward','backward','symmetric'}
+    sweep : {'forward','backward','symmetric','multicolor'}
         Direction of sweep
+    workspace : multilevel_solver.workspace
+        Scratch space reused between calls, see scratch_space
 
     Returns
     -------
@@ -209,7 +289,15 @@ def schwarz(A, x, b, iterations=1, subdomain=None, subdomain_ptr=None,
     neighbors in the matrix graph.
 
     If subdomains is not None, but subblocks is, then the subblocks
-    are formed internally.
+    are formed internally.  In that case, the LU factors of the diagonal
+    blocks are used instead of their inverses, see schwarz_factors.  The
+    factors are computed once and cached on A.
+
+    With sweep='multicolor', the subdomains are grouped by a coloring
+    such that the subdomains of one color are independent, and all
+    subdomains of one color are relaxed simultaneously, in parallel when
+    amg_core is built with OpenMP.  The coloring is cached on A, see
+    schwarz_colors.
 
     Currently only supports CSR matrices
 
@@ -246,34 +334,51 @@ def schwarz(A, x, b, iterations=1, subdomain=None, subdomain_ptr=None,
 
     # If no subdomains are defined, default is to use the sparsity pattern of A
     # to define the overlapping regions
-    (subdomain, subdomain_ptr, inv_subblock, inv_subblock_ptr) = \
-        schwarz_parameters(A, subdomain, subdomain_ptr,
-                           inv_subblock, inv_subblock_ptr)
+    if inv_subblock is None:
+        (subdomain, subdomain_ptr, subblock, subblock_ptr, pivots) = \
+            schwarz_factors(A, subdomain, subdomain_ptr)
+    else:
+        (subdomain, subdomain_ptr, subblock, subblock_ptr) = \
+            schwarz_parameters(A, subdomain, subdomain_ptr,
+                               inv_subblock, inv_subblock_ptr)
+        # pivots of -1 mark explicit inverses
+        pivots = np.full(subdomain.shape, -1, dtype=subdomain.dtype)
+
+    nsdomains = subdomain_ptr.shape[0] - 1
+    if sweep == 'multicolor':
+        color_ptr, color_domains = schwarz_colors(A, subdomain,
+                                                  subdomain_ptr)
+        max_size = np.diff(subdomain_ptr).max() if nsdomains > 0 else 0
+        num_threads = amg_core.set_num_threads(0)
+        temp = scratch_space(workspace, 'schwarz_multicolor',
+                             (2 * max_size * num_threads,), x.dtype)
+        for iter in range(iterations):
+            amg_core.overlapping_schwarz_multicolor_csr(
+                A.indptr, A.indices, A.data, x, b, subblock, subblock_ptr,
+                pivots, subdomain, subdomain_ptr, color_ptr, color_domains,
+                0, color_ptr.shape[0]-1, 1, temp)
+        return
 
     if sweep == 'forward':
-        row_start, row_stop, row_step = 0, subdomain_ptr.shape[0]-1, 1
+        sweeps = [(0, nsdomains, 1)]
     elif sweep == 'backward':
-        row_start, row_stop, row_step = subdomain_ptr.shape[0]-2, -1, -1
+        sweeps = [(nsdomains-1, -1, -1)]
     elif sweep == 'symmetric':
-        for iter in range(iterations):
-            schwarz(A, x, b, iterations=1, subdomain=subdomain,
-                    subdomain_ptr=subdomain_ptr, inv_subblock=inv_subblock,
-                    inv_subblock_ptr=inv_subblock_ptr, sweep='forward')
-            schwarz(A, x, b, iterations=1, subdomain=subdomain,
-                    subdomain_ptr=subdomain_ptr, inv_subblock=inv_subblock,
-                    inv_subblock_ptr=inv_subblock_ptr, sweep='backward')
-        return
+        sweeps = [(0, nsdomains, 1), (nsdomains-1, -1, -1)]
     else:
         raise ValueError("valid sweep directions are 'forward',\
-                          'backward', and 'symmetric'")
+                          'backward', 'symmetric', and 'multicolor'")
+
+    temp = scratch_space(workspace, 'schwarz', (2*A.shape[0],), x.dtype)
 
     # Call C code, need to make sure that subdomains are sorted and unique
     for iter in range(iterations):
-        amg_core.overlapping_schwarz_csr(A.indptr, A.indices, A.data,
-                                         x, b, inv_subblock, inv_subblock_ptr,
-                                         subdomain, subdomain_ptr,
-                                         subdomain_ptr.shape[0]-1, A.shape[0],
-                                         row_start, row_stop, row_step)
+        for row_start, row_stop, row_step in sweeps:
+            amg_core.overlapping_schwarz_lu_csr(A.indptr, A.indices, A.data,
+                                                x, b, subblock, subblock_ptr,
+                                                pivots, subdomain,
+                                                subdomain_ptr, row_start,
+                                                row_stop, row_step, temp)
 
 
 def gauss_seidel(A, x, b, iterations=1, sweep='forward'):
@@ -281,21 +386,37 @@ def gauss_seidel(A, x, b, iterations=1, sweep='forward'):
 
     Parameters
     ----------
-    A : csr_matrix, bsr_matrix
+    A : csr_matrix, bsr_matrix, delta_csr_matrix
         Sparse NxN matrix
     x : ndarray
-        Approximate solution (length N)
+        Approximate solution (length N), or N x k array of approximate
+        solutions for k right-hand sides
     b : ndarray
-        Right-hand side (length N)
+        Right-hand side (length N), or N x k array of right-hand sides
     iterations : int
         Number of iterations to perform
-    sweep : {'forward','backward','symmetric'}
+    sweep : {'forward','backward','symmetric','multicolor'}
         Direction of sweep
 
     Returns
     -------
     Nothing, x will be modified in place.
 
+    Notes
+    -----
+    With sweep='multicolor', the (block) rows of A are grouped by a vertex
+    coloring of the graph of A + A^T and all rows of one color are relaxed
+    simultaneously, in parallel when amg_core is built with OpenMP.  The
+    coloring is computed once and cached on A, see multicolor_parameters.
+
+    If x and b have k > 1 columns and A is CSR, all k systems are relaxed
+    together, reading A once per sweep (gauss_seidel_multi); the result
+    is the same as relaxing each column separately.
+
+    A delta_csr_matrix, see pyamg.util.compressed, is relaxed with its
+    column indices decoded on the fly (gauss_seidel_delta), except for
+    sweep='multicolor', which converts it to CSR.
+
     Examples
     --------
     >>> # Use Gauss-Seidel as a Stand-Alone Solver
@@ -321,9 +442,30 @@ def gauss_seidel(A, x, b, iterations=1, sweep='forward'):
     >>> x = sa.solve(b, x0=x0, tol=1e-8, residuals=residuals)
 
     """
-    A, x, b = make_system(A, x, b, formats=['csr', 'bsr'])
+    if isinstance(x, np.ndarray) and x.ndim == 2 and x.shape[1] > 1:
+        # several right-hand sides, one per column of x and b
+        if not sparse.isspmatrix_csr(A) or\
+                sweep not in ['forward', 'backward', 'symmetric']:
+            relax_columns(gauss_seidel, A, x, b, iterations=iterations,
+                          sweep=sweep)
+            return
+
+        nrhs = x.shape[1]
+        A, x, b = make_multi_system(A, x, b)
+        N = A.shape[0]
+        sweeps = {'forward': [(0, N, 1)],
+                  'backward': [(N-1, -1, -1)],
+                  'symmetric': [(0, N, 1), (N-1, -1, -1)]}[sweep]
+        for iter in range(iterations):
+            for row_start, row_stop, row_step in sweeps:
+                amg_core.gauss_seidel_multi(A.indptr, A.indices, A.data, x, b,
+                                            row_start, row_stop, row_step,
+                                            nrhs)
+        return
+
+    A, x, b = make_system(A, x, b, formats=['csr', 'bsr', 'dcsr'])
 
-    if sparse.isspmatrix_csr(A):
+    if not sparse.isspmatrix_bsr(A):
         blocksize = 1
     else:
         R, C = A.blocksize
@@ -340,11 +482,41 @@ def gauss_seidel(A, x, b, iterations=1, sweep='forward'):
             gauss_seidel(A, x, b, iterations=1, sweep='forward')
             gauss_seidel(A, x, b, iterations=1, sweep='backward')
         return
+    elif sweep == 'multicolor':
+        color_ptr, color_rows = multicolor_parameters(A)
+        color_start, color_stop, color_step = 0, color_ptr.shape[0]-1, 1
+        if isinstance(A, delta_csr_matrix):
+            for iter in range(iterations):
+                amg_core.gauss_seidel_multicolor_delta(A.indptr, A.base,
+                                                       A.offsets, A.data,
+                                                       x, b, color_ptr,
+                                                       color_rows,
+                                                       color_start,
+                                                       color_stop,
+                                                       color_step)
+        elif sparse.isspmatrix_csr(A):
+            for iter in range(iterations):
+                amg_core.gauss_seidel_multicolor(A.indptr, A.indices, A.data,
+                                                 x, b, color_ptr, color_rows,
+                                                 color_start, color_stop,
+                                                 color_step)
+        else:
+            for iter in range(iterations):
+                amg_core.bsr_gauss_seidel_multicolor(A.indptr, A.indices,
+                                                     np.ravel(A.data), x, b,
+                                                     color_ptr, color_rows,
+                                                     color_start, color_stop,
+                                                     color_step, R)
+        return
     else:
         raise ValueError("valid sweep directions are 'forward',\
-                          'backward', and 'symmetric'")
+                          'backward', 'symmetric', and 'multicolor'")
 
-    if sparse.isspmatrix_csr(A):
+    if isinstance(A, delta_csr_matrix):
+        for iter in range(iterations):
+            amg_core.gauss_seidel_delta(A.indptr, A.base, A.offsets, A.data,
+                                        x, b, row_start, row_stop, row_step)
+    elif sparse.isspmatrix_csr(A):
         for iter in range(iterations):
             amg_core.gauss_seidel(A.indptr, A.indices, A.data, x, b,
                                   row_start, row_stop, row_step)
@@ -354,26 +526,37 @@ def gauss_seidel(A, x, b, iterations=1, sweep='forward'):
                                       x, b, row_start, row_stop, row_step, R)
 
 
-def jacobi(A, x, b, iterations=1, omega=1.0):
+def jacobi(A, x, b, iterations=1, omega=1.0, workspace=None):
     """Perform Jacobi iteration on the linear system Ax=b.
 
     Parameters
     ----------
-    A : csr_matrix
+    A : csr_matrix, bsr_matrix, delta_csr_matrix
         Sparse NxN matrix
     x : ndarray
-        Approximate solution (length N)
+        Approximate solution (length N), or N x k array of approximate
+        solutions for k right-hand sides
     b : ndarray
-        Right-hand side (length N)
+        Right-hand side (length N), or N x k array of right-hand sides
     iterations : int
         Number of iterations to perform
     omega : scalar
         Damping parameter
+    workspace : multilevel_solver.workspace
+        Scratch space reused between calls, see scratch_space
 
     Returns
     -------
     Nothing, x will be modified in place.
 
+    Notes
+    -----
+    If x and b have k > 1 columns and A is CSR, all k systems are relaxed
+    together, reading A once per iteration (jacobi_multi).
+
+    A delta_csr_matrix, see pyamg.util.compressed, is relaxed with its
+    column indices decoded on the fly (jacobi_delta).
+
     Examples
     --------
     >>> # Use Jacobi as a Stand-Alone Solver
@@ -399,7 +582,23 @@ def jacobi(A, x, b, iterations=1, omega=1.0):
     >>> x = sa.solve(b, x0=x0, tol=1e-8, residuals=residuals)
 
     """
-    A, x, b = make_system(A, x, b, formats=['csr', 'bsr'])
+    if isinstance(x, np.ndarray) and x.ndim == 2 and x.shape[1] > 1:
+        # several right-hand sides, one per column of x and b
+        if not sparse.isspmatrix_csr(A):
+            relax_columns(jacobi, A, x, b, iterations=iterations,
+                          omega=omega, workspace=workspace)
+            return
+
+        nrhs = x.shape[1]
+        A, x, b = make_multi_system(A, x, b)
+        temp = scratch_space(workspace, 'jacobi_multi', x.shape, x.dtype)
+        [omega] = type_prep(A.dtype, [omega])
+        for iter in range(iterations):
+            amg_core.jacobi_multi(A.indptr, A.indices, A.data, x, b, temp,
+                                  0, A.shape[0], 1, nrhs, omega)
+        return
+
+    A, x, b = make_system(A, x, b, formats=['csr', 'bsr', 'dcsr'])
 
     sweep = slice(None)
     (row_start, row_stop, row_step) = sweep.indices(A.shape[0])
@@ -407,12 +606,16 @@ def jacobi(A, x, b, iterations=1, omega=1.0):
     if (row_stop - row_start) * row_step <= 0:  # no work to do
         return
 
-    temp = np.empty_like(x)
+    temp = scratch_space(workspace, 'jacobi', x.shape, x.dtype)
 
     # Create uniform type, convert possibly complex scalars to length 1 arrays
     [omega] = type_prep(A.dtype, [omega])
 
-    if sparse.isspmatrix_csr(A):
+    if isinstance(A, delta_csr_matrix):
+        for iter in range(iterations):
+            amg_core.jacobi_delta(A.indptr, A.base, A.offsets, A.data, x, b,
+                                  temp, row_start, row_stop, row_step, omega)
+    elif sparse.isspmatrix_csr(A):
         for iter in range(iterations):
             amg_core.jacobi(A.indptr, A.indices, A.data, x, b, temp,
                             row_start, row_stop, row_step, omega)
@@ -428,7 +631,8 @@ def jacobi(A, x, b, iterations=1, omega=1.0):
                                 row_step, R, omega)
 
 
-def block_jacobi(A, x, b, Dinv=None, blocksize=1, iterations=1, omega=1.0):
+def block_jacobi(A, x, b, Dinv=None, blocksize=1, iterations=1, omega=1.0,
+                 workspace=None):
     """Perform block Jacobi iteration on the linear system Ax=b.
 
     Parameters
@@ -448,6 +652,8 @@ def block_jacobi(A, x, b, Dinv=None, blocksize=1, iterations=1, omega=1.0):
         Number of iterations to perform
     omega : scalar
         Damping parameter
+    workspace : multilevel_solver.workspace
+        Scratch space reused between calls, see scratch_space
 
     Returns
     -------
@@ -495,7 +701,7 @@ def block_jacobi(A, x, b, Dinv=None, blocksize=1, iterations=1, omega=1.0):
     if (row_stop - row_start) * row_step <= 0:  # no work to do
         return
 
-    temp = np.empty_like(x)
+    temp = scratch_space(workspace, 'block_jacobi', x.shape, x.dtype)
 
     # Create uniform type, convert possibly complex scalars to length 1 arrays
     [omega] = type_prep(A.dtype, [omega])
@@ -592,7 +798,8 @@ def block_gauss_seidel(A, x, b, iterations=1, sweep='forward', blocksize=1,
                                     row_start, row_stop, row_step, blocksize)
 
 
-def polynomial(A, x, b, coefficients, iterations=1):
+def polynomial(A, x, b, coefficients, iterations=1, workspace=None,
+               zero_guess=False):
     """Apply a polynomial smoother to the system Ax=b.
 
     Parameters
@@ -607,6 +814,11 @@ def polynomial(A, x, b, coefficients, iterations=1):
         Coefficients of the polynomial.  See Notes section for details.
     iterations : int
         Number of iterations to perform
+    workspace : multilevel_solver.workspace
+        Scratch space reused between calls, see scratch_space
+    zero_guess : bool
+        If True, x is zero on entry, e.g., the coarse-grid x of a cycle,
+        so that the first iteration skips the product A*x
 
     Returns
     -------
@@ -629,8 +841,14 @@ def polynomial(A, x, b, coefficients, iterations=1):
 
     Here, Horner's Rule is applied to avoid computing A^k directly.
 
-    For efficience, the method detects the case x = 0 one matrix-vector
-    product is avoided (since (b - A*x) is b).
+    For efficiency, the caller may state that x = 0 with zero_guess, and
+    one matrix-vector product is avoided (since (b - A*x) is b).
+
+    For CSR and BSR (square blocks) matrices, each iteration is applied by
+    amg_core.polynomial (bsr_polynomial), which fuses each product with A
+    with the Horner update, and adds the last one to x in place, with the
+    coefficients cast to the dtype of A.  Other matrices use the products
+    of A.
 
     Examples
     --------
@@ -654,10 +872,26 @@ def polynomial(A, x, b, coefficients, iterations=1):
     """
     A, x, b = make_system(A, x, b, formats=None)
 
-    for i in range(iterations):
-        from pyamg.util.linalg import norm
+    native = sparse.isspmatrix_csr(A) or\
+        (sparse.isspmatrix_bsr(A) and A.blocksize[0] == A.blocksize[1])
+    if native:
+        # e.g. float64 coefficients for a float32 level, see cycle_dtype
+        coefficients = np.asarray(coefficients, dtype=A.dtype).ravel()
+        temp = scratch_space(workspace, 'polynomial', (3 * x.size,), x.dtype)
+        for i in range(iterations):
+            first = (i == 0 and zero_guess)
+            if sparse.isspmatrix_csr(A):
+                amg_core.polynomial(A.indptr, A.indices, A.data, x, b, temp,
+                                    coefficients, first)
+            else:
+                amg_core.bsr_polynomial(A.indptr, A.indices,
+                                        np.ravel(A.data), x, b, temp,
+                                        coefficients, first,
+                                        A.blocksize[0])
+        return
 
-        if norm(x) == 0:
+    for i in range(iterations):
+        if i == 0 and zero_guess:
             residual = b
         else:
             residual = (b - A*x)
@@ -1062,30 +1296,285 @@ def schwarz_parameters(A, subdomain=None, subdomain_ptr=None,
         amg_core.extract_subblocks(A.indptr, A.indices, A.data, inv_subblock,
                                    inv_subblock_ptr, subdomain, subdomain_ptr,
                                    int(subdomain_ptr.shape[0]-1), A.shape[0])
-        # Choose tolerance for which singular values are zero in *gelss below
-        t = A.dtype.char
-        eps = np.finfo(np.float).eps
-        feps = np.finfo(np.single).eps
-        geps = np.finfo(np.longfloat).eps
-        _array_precision = {'f': 0, 'd': 1, 'g': 2, 'F': 0, 'D': 1, 'G': 2}
-        cond = {0: feps*1e3, 1: eps*1e6, 2: geps*1e6}[_array_precision[t]]
-
         # Invert each block column
-        my_pinv, = la.get_lapack_funcs(['gelss'],
-                                       (np.ones((1,), dtype=A.dtype)))
-        for i in range(subdomain_ptr.shape[0]-1):
-            m = blocksize[i]
-            rhs = np.eye(m, m, dtype=A.dtype)
-            j0 = inv_subblock_ptr[i]
-            j1 = inv_subblock_ptr[i+1]
-            gelssoutput = my_pinv(inv_subblock[j0:j1].reshape(m, m),
-                                  rhs, cond=cond, overwrite_a=True,
-                                  overwrite_b=True)
-            inv_subblock[j0:j1] = np.ravel(gelssoutput[1])
+        invert_subblocks(inv_subblock, inv_subblock_ptr, blocksize,
+                         range(subdomain_ptr.shape[0]-1))
 
     A.schwarz_parameters = (subdomain, subdomain_ptr, inv_subblock,
                             inv_subblock_ptr)
     return A.schwarz_parameters
 
+
+def subblock_cond(dtype):
+    """Relative tolerance below which singular values of a block are zero."""
+    eps = np.finfo(np.float).eps
+    feps = np.finfo(np.single).eps
+    geps = np.finfo(np.longfloat).eps
+    _array_precision = {'f': 0, 'd': 1, 'g': 2, 'F': 0, 'D': 1, 'G': 2}
+    return {0: feps*1e3, 1: eps*1e6, 2: geps*1e6}[_array_precision[dtype.char]]
+
+
+def invert_subblocks(subblock, subblock_ptr, blocksize, domains):
+    """Replace the Schwarz blocks of the given subdomains by their inverse.
+
+    The block subblock[subblock_ptr[i]:subblock_ptr[i+1]] of subdomain i is
+    of size blocksize[i] and stored in row major.  It is replaced by its
+    pseudo-inverse, computed by gelss.
+    """
+    cond = subblock_cond(subblock.dtype)
+    my_pinv, = la.get_lapack_funcs(['gelss'],
+                                   (np.ones((1,), dtype=subblock.dtype)))
+    for i in domains:
+        j0 = subblock_ptr[i]
+        j1 = subblock_ptr[i+1]
+        m = blocksize[i]
+        rhs = np.eye(m, m, dtype=subblock.dtype)
+        gelssoutput = my_pinv(subblock[j0:j1].reshape(m, m),
+                              rhs, cond=cond, overwrite_a=True,
+                              overwrite_b=True)
+        subblock[j0:j1] = np.ravel(gelssoutput[1])
+
+
+def schwarz_factors(A, subdomain=None, subdomain_ptr=None):
+    """Set the LU factors for Schwarz relaxation.
+
+    Helper function for setting up Schwarz relaxation.  The diagonal block
+    of A for each subdomain is factored in place by amg_core.schwarz_factor,
+    with partial pivoting, in parallel when amg_core is built with OpenMP.
+    The factors are stored packed contiguously in the order of the
+    subdomains, and the result is cached on A.
+
+    Parameters
+    ----------
+    A : csr_matrix
+        Sparse NxN matrix, with sorted indices
+    subdomain, subdomain_ptr : int array
+        Subdomains, see schwarz.  The default is the sparsity pattern of A.
+
+    Returns
+    -------
+    A.schwarz_factors[0] is subdomain
+    A.schwarz_factors[1] is subdomain_ptr
+    A.schwarz_factors[2] is subblock, the packed LU factors
+    A.schwarz_factors[3] is subblock_ptr
+    A.schwarz_factors[4] is pivots
+
+    Notes
+    -----
+    A numerically singular block, i.e., a block with a pivot smaller than
+    a relative tolerance, is replaced by its pseudo-inverse, as computed by
+    schwarz_parameters, and marked by a pivot of -1 for first row of the
+    subdomain.
+
+    Examples
+    --------
+    >>> from pyamg.gallery import poisson
+    >>> from pyamg.relaxation.relaxation import schwarz_factors
+    >>> A = poisson((4,), format='csr')
+    >>> subdomain, subdomain_ptr, lu, lu_ptr, pivots = schwarz_factors(A)
+    >>> print lu_ptr
+    [ 0  4 13 22 26]
+
+    """
+    # Check if A has a pre-existing factorization
+    if hasattr(A, 'schwarz_factors'):
+        if subdomain is not None and subdomain_ptr is not None:
+            # check that the existing factors correspond to the same
+            # subdomains
+            if np.array(A.schwarz_factors[0] == subdomain).all() and \
+               np.array(A.schwarz_factors[1] == subdomain_ptr).all():
+                return A.schwarz_factors
+        else:
+            return A.schwarz_factors
+
+    # Default is to use the overlapping regions defined by A's sparsity pattern
+    if subdomain is None or subdomain_ptr is None:
+        subdomain_ptr = A.indptr.copy()
+        subdomain = A.indices.copy()
+
+    nsdomains = subdomain_ptr.shape[0] - 1
+    subblock_ptr = np.zeros(subdomain_ptr.shape, dtype=A.indices.dtype)
+    blocksize = (subdomain_ptr[1:] - subdomain_ptr[:-1])
+    subblock_ptr[1:] = np.cumsum(blocksize*blocksize)
+
+    subblock = np.zeros((subblock_ptr[-1],), dtype=A.dtype)
+    amg_core.extract_subblocks(A.indptr, A.indices, A.data, subblock,
+                               subblock_ptr, subdomain, subdomain_ptr,
+                               int(nsdomains), A.shape[0])
+    pivots = np.zeros(subdomain.shape, dtype=A.indices.dtype)
+    nsingular = amg_core.schwarz_factor(subblock, subblock_ptr, subdomain_ptr,
+                                        pivots, int(nsdomains),
+                                        subblock_cond(A.dtype))
+
+    if nsingular > 0:
+        # Extract the singular blocks again, and invert them
+        nonempty = np.flatnonzero(blocksize > 0)
+        singular = nonempty[pivots[subdomain_ptr[nonempty]] == -1]
+        for i in singular:
+            j0, j1 = subblock_ptr[i], subblock_ptr[i+1]
+            block = np.zeros((j1 - j0,), dtype=A.dtype)
+            amg_core.extract_subblocks(
+                A.indptr, A.indices, A.data, block,
+                np.array([0, j1 - j0], dtype=A.indices.dtype),
+                subdomain[subdomain_ptr[i]:subdomain_ptr[i+1]],
+                np.array([0, blocksize[i]], dtype=A.indices.dtype),
+                1, A.shape[0])
+            subblock[j0:j1] = block
+        invert_subblocks(subblock, subblock_ptr, blocksize, singular)
+
+    A.schwarz_factors = (subdomain, subdomain_ptr, subblock, subblock_ptr,
+                         pivots)
+    return A.schwarz_factors
+
+
+def schwarz_colors(A, subdomain, subdomain_ptr, method='MIS'):
+    """Set the coloring of the subdomains for multicolor Schwarz relaxation.
+
+    Two subdomains have different colors if one overlaps the other or
+    couples to it in A, i.e., if one writes x where the other reads it.
+    The subdomains of one color are then independent, and are relaxed
+    simultaneously.  The result is cached on A.
+
+    Parameters
+    ----------
+    A : csr_matrix
+        Sparse NxN matrix
+    subdomain, subdomain_ptr : int array
+        Subdomains, see schwarz
+    method : {'MIS', 'JP', 'LDF'}
+        Vertex coloring algorithm, see pyamg.graph.vertex_coloring
+
+    Returns
+    -------
+    color_ptr, color_domains : int array
+        The subdomains of color c are
+        color_domains[color_ptr[c]:color_ptr[c+1]]
+
+    """
+    # Check if A has a pre-existing coloring of the same subdomains
+    if hasattr(A, 'schwarz_colors'):
+        if np.array(A.schwarz_colors[0] == subdomain).all() and \
+           np.array(A.schwarz_colors[1] == subdomain_ptr).all():
+            return A.schwarz_colors[2:]
+
+    from pyamg.graph import vertex_coloring
+
+    n = A.shape[0]
+    nsdomains = subdomain_ptr.shape[0] - 1
+    # E has a row for each subdomain, with the indices it writes, and
+    # E (G + I) the indices it reads
+    E = sparse.csr_matrix((np.ones(subdomain.shape[0]), subdomain,
+                           subdomain_ptr), shape=(nsdomains, n))
+    G = sparse.csr_matrix((np.ones(A.indices.shape[0]), A.indices, A.indptr),
+                          shape=(n, n)) + sparse.eye(n, format='csr')
+    C = E * (E * G).T
+    C = (C + C.T).tocsr()
+
+    colors = vertex_coloring(C, method=method)
+    num_colors = colors.max() + 1 if nsdomains > 0 else 0
+
+    color_ptr = np.zeros((num_colors+1,), dtype=A.indices.dtype)
+    color_ptr[1:] = np.cumsum(np.bincount(colors, minlength=num_colors))
+    color_domains = np.argsort(colors, kind='mergesort').astype(
+        A.indices.dtype)
+
+    A.schwarz_colors = (subdomain, subdomain_ptr, color_ptr, color_domains)
+    return color_ptr, color_domains
+
+
+def scratch_space(workspace, name, shape, dtype):
+    """Return scratch space for a relaxation method.
+
+    Parameters
+    ----------
+    workspace : multilevel_solver.workspace, None
+        Workspace of the level being relaxed, or None
+    name : string
+        Name of the scratch array
+    shape : tuple
+        Shape of the scratch array
+    dtype : dtype
+        Data type of the scratch array
+
+    Returns
+    -------
+    Uninitialized array of the given shape and dtype.  The array is taken
+    from workspace, so that it is only allocated once, unless workspace is
+    None.
+
+    Notes
+    -----
+    The smoothers of a multilevel_solver pass the workspace of their level.
+    The workspace is kept with the level, not with A, so that hierarchies
+    that share an operator, e.g. hierarchies built from the same A in
+    different threads, do not share scratch space.  Within a workspace the
+    arrays are kept per thread.
+
+    """
+    if workspace is not None:
+        return workspace.get(name, shape, dtype)
+    return np.empty(shape, dtype=dtype)
+
+
+def multicolor_parameters(A, method='MIS'):
+    """Set multicolor Gauss-Seidel parameters.
+
+    Helper function for setting up multicolor Gauss-Seidel relaxation.  The
+    (block) rows of A are colored such that no two rows of the same color are
+    coupled in A, and then grouped by color.  The result is cached on A, so
+    that the coloring is computed only once per level, instead of every cycle.
+
+    Parameters
+    ----------
+    A : csr_matrix, bsr_matrix, delta_csr_matrix
+        Sparse NxN matrix
+    method : {'MIS', 'JP', 'LDF'}
+        Vertex coloring algorithm, see pyamg.graph.vertex_coloring
+
+    Returns
+    -------
+    A.multicolor_parameters[0] is color_ptr
+    A.multicolor_parameters[1] is color_rows
+
+    The (block) rows of color c are
+    color_rows[color_ptr[c]:color_ptr[c+1]]
+
+    Examples
+    --------
+    >>> from pyamg.gallery import poisson
+    >>> from pyamg.relaxation.relaxation import multicolor_parameters
+    >>> A = poisson((4,), format='csr')
+    >>> color_ptr, color_rows = multicolor_parameters(A)
+    >>> print color_ptr
+    [0 2 4]
+    >>> print color_rows
+    [0 2 1 3]
+
+    """
+    # Check if A has a pre-existing coloring
+    if hasattr(A, 'multicolor_parameters'):
+        return A.multicolor_parameters
+
+    from pyamg.graph import vertex_coloring
+
+    # Color the (block) graph of A + A^T, so that rows of the same color
+    # are independent regardless of the symmetry of A
+    n = A.indptr.shape[0] - 1
+    indices = A.tocsr().indices if isinstance(A, delta_csr_matrix) else\
+        A.indices
+    G = sparse.csr_matrix((np.ones(indices.shape[0]), indices, A.indptr),
+                          shape=(n, n))
+    G = (G + G.T).tocsr()
+
+    colors = vertex_coloring(G, method=method)
+    num_colors = colors.max() + 1 if colors.size > 0 else 0
+
+    color_ptr = np.zeros((num_colors+1,), dtype=A.indptr.dtype)
+    color_ptr[1:] = np.cumsum(np.bincount(colors, minlength=num_colors))
+    color_rows = np.argsort(colors, kind='mergesort').astype(A.indptr.dtype)
+
+    A.multicolor_parameters = (color_ptr, color_rows)
+    return A.multicolor_parameters
+
 # from pyamg.utils import dispatcher
 # dispatch = dispatcher( dict([ (fn,eval(fn)) for fn in __all__ ]) )
@@ -7,7 +7,9 @@ from . import relaxation
 from .chebyshev import chebyshev_polynomial_coefficients
 from pyamg.util.utils import scale_rows, get_block_diag, get_diagonal
 from pyamg.util.linalg import approximate_spectral_radius
+from pyamg.util.compressed import delta_csr_matrix
 from pyamg.krylov import gmres, cgne, cgnr, cg
+from pyamg.util.profile import null_profile
 
 __all__ = ['change_smoothers']
 
@@ -133,6 +135,7 @@ def change_smoothers(ml, presmoother, postsmoother):
 
     """
     ml.symmetric_smoothing = True
+    ml.smoother_args = (presmoother, postsmoother)  # for ml.update
 
     # interpret arguments into list
     if isinstance(presmoother, str) or isinstance(presmoother, tuple) or\
@@ -155,6 +158,8 @@ def change_smoothers(ml, presmoother, postsmoother):
     kwargs2 = {}
     min_len = min(len(presmoother), len(postsmoother), len(ml.levels[:-1]))
     same = (len(presmoother) == len(postsmoother))
+    profile = getattr(ml, 'profile', None) or null_profile
+    profile.start()
     for i in range(0, min_len):
         # unpack presmoother[i]
         fn1, kwargs1 = unpack_arg(presmoother[i])
@@ -173,6 +178,7 @@ def change_smoothers(ml, presmoother, postsmoother):
         except NameError:
             raise NameError("invalid postsmoother method: ", fn2)
         ml.levels[i].postsmoother = setup_postsmoother(ml.levels[i], **kwargs2)
+        profile.lap('setup', i, 'smoother')
 
         # Check if symmetric smoothing scheme
         try:
@@ -217,6 +223,7 @@ def change_smoothers(ml, presmoother, postsmoother):
                 raise NameError("invalid postsmoother method: ", fn2)
             ml.levels[i].postsmoother =\
                 setup_postsmoother(ml.levels[i], **kwargs2)
+            profile.lap('setup', i, 'smoother')
 
             # Check if symmetric smoothing scheme
             try:
@@ -261,6 +268,7 @@ def change_smoothers(ml, presmoother, postsmoother):
             # Set up postsmoother
             ml.levels[i].postsmoother =\
                 setup_postsmoother(ml.levels[i], **kwargs2)
+            profile.lap('setup', i, 'smoother')
 
             # Check if symmetric smoothing scheme
             try:
@@ -296,6 +304,7 @@ def change_smoothers(ml, presmoother, postsmoother):
     for i in range(mid_len, len(ml.levels[:-1])):
         ml.levels[i].presmoother = setup_presmoother(ml.levels[i], **kwargs1)
         ml.levels[i].postsmoother = setup_postsmoother(ml.levels[i], **kwargs2)
+        profile.lap('setup', i, 'smoother')
 
 
 def rho_D_inv_A(A):
@@ -303,7 +312,7 @@ def rho_D_inv_A(A):
 
     Parameters
     ----------
-    A : sparse-matrix
+    A : sparse-matrix, delta_csr_matrix
 
     Returns
     -------
@@ -321,8 +330,9 @@ def rho_D_inv_A(A):
 
     """
     if not hasattr(A, 'rho_D_inv'):
-        D_inv = get_diagonal(A, inv=True)
-        D_inv_A = scale_rows(A, D_inv, copy=True)
+        M = A.tocsr() if isinstance(A, delta_csr_matrix) else A
+        D_inv = get_diagonal(M, inv=True)
+        D_inv_A = scale_rows(M, D_inv, copy=True)
         A.rho_D_inv = approximate_spectral_radius(D_inv_A)
 
     return A.rho_D_inv
@@ -435,7 +445,16 @@ def matrix_asformat(lvl, name, format, blocksize=None):
 
     Returns
     -------
-    Function pointer for the appropriate relaxation method for level=lvl
+    Function pointer for the appropriate relaxation method for level=lvl.
+    If the function accepts N x k arrays x and b, to relax k right-hand
+    sides at once, it has the attribute multiple_rhs = True.  Otherwise,
+    multilevel_solver relaxes the columns one at a time.  If the method
+    is also implemented by amg_core.multigrid_cycle, the function has the
+    attribute native = (method, iterations, parameter), e.g.,
+    ('gauss_seidel', 1, 'symmetric') or ('jacobi', 1, omega), so that
+    multilevel_solver may cycle on the level without returning to Python.
+    If the function accepts the keyword zero_guess, to skip the product
+    A*x when x is zero on entry, it has the attribute zero_guess = True.
 
     Examples
     --------
@@ -445,17 +464,29 @@ def matrix_asformat(lvl, name, format, blocksize=None):
 
 
 def setup_gauss_seidel(lvl, iterations=DEFAULT_NITER, sweep=DEFAULT_SWEEP):
+    if sweep == 'multicolor' and (sparse.isspmatrix(lvl.A) or
+                                  isinstance(lvl.A, delta_csr_matrix)):
+        # color the level once, the coloring is cached on lvl.A
+        relaxation.multicolor_parameters(lvl.A)
+
     def smoother(A, x, b):
         relaxation.gauss_seidel(A, x, b, iterations=iterations, sweep=sweep)
+    smoother.multiple_rhs = True
+    if sweep in ['forward', 'backward', 'symmetric']:
+        smoother.native = ('gauss_seidel', iterations, sweep)
     return smoother
 
 
 def setup_jacobi(lvl, iterations=DEFAULT_NITER, omega=1.0, withrho=True):
     if withrho:
         omega = omega/rho_D_inv_A(lvl.A)
+    workspace = getattr(lvl, 'workspace', None)
 
     def smoother(A, x, b):
-        relaxation.jacobi(A, x, b, iterations=iterations, omega=omega)
+        relaxation.jacobi(A, x, b, iterations=iterations, omega=omega,
+                          workspace=workspace)
+    smoother.multiple_rhs = True
+    smoother.native = ('jacobi', iterations, omega)
     return smoother
 
 
@@ -465,16 +496,24 @@ def setup_schwarz(lvl, iterations=DEFAULT_NITER, subdomain=None,
 
     matrix_asformat(lvl, 'A', 'csr')
     lvl.Acsr.sort_indices()
-    subdomain, subdomain_ptr, inv_subblock, inv_subblock_ptr = \
-        relaxation.schwarz_parameters(lvl.Acsr, subdomain, subdomain_ptr,
-                                      inv_subblock, inv_subblock_ptr)
+    if inv_subblock is None:
+        subdomain, subdomain_ptr = \
+            relaxation.schwarz_factors(lvl.Acsr, subdomain, subdomain_ptr)[:2]
+    else:
+        subdomain, subdomain_ptr, inv_subblock, inv_subblock_ptr = \
+            relaxation.schwarz_parameters(lvl.Acsr, subdomain, subdomain_ptr,
+                                          inv_subblock, inv_subblock_ptr)
+    if sweep == 'multicolor':
+        relaxation.schwarz_colors(lvl.Acsr, subdomain, subdomain_ptr)
+    workspace = getattr(lvl, 'workspace', None)
 
     def smoother(A, x, b):
         relaxation.schwarz(lvl.Acsr, x, b, iterations=iterations,
                            subdomain=subdomain,
                            subdomain_ptr=subdomain_ptr,
                            inv_subblock=inv_subblock,
-                           inv_subblock_ptr=inv_subblock_ptr, sweep=sweep)
+                           inv_subblock_ptr=inv_subblock_ptr, sweep=sweep,
+                           workspace=workspace)
     return smoother
 
 
@@ -495,11 +534,24 @@ def setup_strength_based_schwarz(lvl, iterations=DEFAULT_NITER,
                          subdomain_ptr=subdomain_ptr, sweep=sweep)
 
 
+def _block_matrix(lvl, blocksize):
+    """Return lvl.A for the block smoothers.
+
+    A delta_csr_matrix has no block kernels, so it is converted to BSR once
+    here, rather than by make_system on each call.  The copy is kept by the
+    smoother only.
+    """
+    if isinstance(lvl.A, delta_csr_matrix):
+        return lvl.A.tocsr().tobsr(blocksize=(blocksize, blocksize))
+    return lvl.A
+
+
 def setup_block_jacobi(lvl, iterations=DEFAULT_NITER, omega=1.0, Dinv=None,
                        blocksize=None, withrho=True):
     # Determine Blocksize
     if blocksize is None and Dinv is None:
-        if sparse.isspmatrix_csr(lvl.A):
+        if sparse.isspmatrix_csr(lvl.A) or\
+                isinstance(lvl.A, delta_csr_matrix):
             blocksize = 1
         elif sparse.isspmatrix_bsr(lvl.A):
             blocksize = lvl.A.blocksize[0]
@@ -512,15 +564,19 @@ def setup_block_jacobi(lvl, iterations=DEFAULT_NITER, omega=1.0, Dinv=None,
                             withrho=withrho)
     else:
         # Use Block Jacobi
+        Ablock = _block_matrix(lvl, blocksize)
         if Dinv is None:
-            Dinv = get_block_diag(lvl.A, blocksize=blocksize, inv_flag=True)
+            Dinv = get_block_diag(Ablock, blocksize=blocksize, inv_flag=True)
         if withrho:
-            omega = omega/rho_block_D_inv_A(lvl.A, Dinv)
+            omega = omega/rho_block_D_inv_A(Ablock, Dinv)
+        workspace = getattr(lvl, 'workspace', None)
 
         def smoother(A, x, b):
+            if isinstance(A, delta_csr_matrix):
+                A = Ablock
             relaxation.block_jacobi(A, x, b, iterations=iterations,
                                     omega=omega, Dinv=Dinv,
-                                    blocksize=blocksize)
+                                    blocksize=blocksize, workspace=workspace)
         return smoother
 
 
@@ -529,7 +585,8 @@ def setup_block_gauss_seidel(lvl, iterations=DEFAULT_NITER,
                              Dinv=None, blocksize=None):
     # Determine Blocksize
     if blocksize is None and Dinv is None:
-        if sparse.isspmatrix_csr(lvl.A):
+        if sparse.isspmatrix_csr(lvl.A) or\
+                isinstance(lvl.A, delta_csr_matrix):
             blocksize = 1
         elif sparse.isspmatrix_bsr(lvl.A):
             blocksize = lvl.A.blocksize[0]
@@ -541,10 +598,13 @@ def setup_block_gauss_seidel(lvl, iterations=DEFAULT_NITER,
         return setup_gauss_seidel(lvl, iterations=iterations, sweep=sweep)
     else:
         # Use Block GS
+        Ablock = _block_matrix(lvl, blocksize)
         if Dinv is None:
-            Dinv = get_block_diag(lvl.A, blocksize=blocksize, inv_flag=True)
+            Dinv = get_block_diag(Ablock, blocksize=blocksize, inv_flag=True)
 
         def smoother(A, x, b):
+            if isinstance(A, delta_csr_matrix):
+                A = Ablock
             relaxation.block_gauss_seidel(A, x, b, iterations=iterations,
                                           Dinv=Dinv, blocksize=blocksize,
                                           sweep=sweep)
@@ -554,17 +614,22 @@ def setup_block_gauss_seidel(lvl, iterations=DEFAULT_NITER,
 
 def setup_richardson(lvl, iterations=DEFAULT_NITER, omega=1.0):
     omega = omega/approximate_spectral_radius(lvl.A)
+    workspace = getattr(lvl, 'workspace', None)
 
-    def smoother(A, x, b):
+    def smoother(A, x, b, zero_guess=False):
         relaxation.polynomial(A, x, b, coefficients=[omega],
-                              iterations=iterations)
+                              iterations=iterations, workspace=workspace,
+                              zero_guess=zero_guess)
+    smoother.zero_guess = True
     return smoother
 
 
 def setup_sor(lvl, omega=0.5, iterations=DEFAULT_NITER, sweep=DEFAULT_SWEEP):
+    workspace = getattr(lvl, 'workspace', None)
+
     def smoother(A, x, b):
         relaxation.sor(A, x, b, omega=omega, iterations=iterations,
-                       sweep=sweep)
+                       sweep=sweep, workspace=workspace)
     return smoother
 
 
@@ -575,10 +640,13 @@ def setup_chebyshev(lvl, lower_bound=1.0/30.0, upper_bound=1.1, degree=3,
     b = rho * upper_bound
     # drop the constant coefficient
     coefficients = -chebyshev_polynomial_coefficients(a, b, degree)[:-1]
+    workspace = getattr(lvl, 'workspace', None)
 
-    def smoother(A, x, b):
+    def smoother(A, x, b, zero_guess=False):
         relaxation.polynomial(A, x, b, coefficients=coefficients,
-                              iterations=iterations)
+                              iterations=iterations, workspace=workspace,
+                              zero_guess=zero_guess)
+    smoother.zero_guess = True
     return smoother
 
 
@@ -675,4 +743,5 @@ def setup_cgnr(lvl, tol=1e-12, maxiter=1, M=None, callback=None,
 def setup_None(lvl):
     def smoother(A, x, b):
         pass
+    smoother.native = ('none', 0, None)
     return smoother
@@ -2,15 +2,18 @@ import numpy as np
 import scipy
 from scipy.sparse import spdiags, csr_matrix, bsr_matrix, eye
 from scipy.linalg import solve
+from scipy.sparse.linalg import aslinearoperator
 
 from pyamg.gallery import poisson, sprand, elasticity
 from pyamg.relaxation.relaxation import gauss_seidel, jacobi,\
     block_jacobi, block_gauss_seidel, jacobi_ne, schwarz, sor,\
     gauss_seidel_indexed, polynomial, gauss_seidel_ne,\
-    gauss_seidel_nr
+    gauss_seidel_nr, multicolor_parameters, schwarz_parameters,\
+    schwarz_factors, schwarz_colors
 from pyamg.util.utils import get_block_diag
+from pyamg import amg_core
 
-from numpy.testing import TestCase, assert_almost_equal
+from numpy.testing import TestCase, assert_almost_equal, assert_equal
 
 # Ignore efficiency warnings
 import warnings
@@ -31,6 +34,7 @@ class TestCommonRelaxation(TestCase):
     def setUp(self):
         self.cases = []
         self.cases.append((gauss_seidel, (), {}))
+        self.cases.append((gauss_seidel, (), {'sweep': 'multicolor'}))
         self.cases.append((jacobi, (), {}))
         self.cases.append((block_jacobi, (), {}))
         self.cases.append((block_gauss_seidel, (), {}))
@@ -134,15 +138,55 @@ class TestRelaxation(TestCase):
         polynomial(A, x, b, [-0.14285714, 1., -2.])
         assert_almost_equal(x, x0 - 0.14285714 * A * A * r + A * r - 2 * r)
 
-        # polynomial() optimizes for the case x=0
+        # polynomial() optimizes for the case x=0, stated by zero_guess
         x = 0 * x0
-        polynomial(A, x, b, [-1.0/3.0])
+        polynomial(A, x, b, [-1.0/3.0], zero_guess=True)
         assert_almost_equal(x, 1.0/3.0*b)
 
         x = 0*x0
-        polynomial(A, x, b, [-0.14285714, 1., -2.])
+        polynomial(A, x, b, [-0.14285714, 1., -2.], zero_guess=True)
         assert_almost_equal(x, 0.14285714*A*A*b + A*b - 2*b)
 
+    def test_polynomial_native(self):
+        # CSR and BSR matrices are smoothed by amg_core, compare to the
+        # products of A as a LinearOperator
+        np.random.seed(1381271372)
+        A = elasticity.linear_elasticity((5, 5), format='bsr')[0]
+        cases = [A, A.tocsr(), poisson((10, 10), format='csr'),
+                 (1.0 + 0.5j) * A]
+        for A in cases:
+            b = np.random.rand(A.shape[0]).astype(A.dtype)
+            guess = np.random.rand(A.shape[0]).astype(A.dtype)
+            for coefficients in [[0.3], [0.2, -0.5], [-0.1, 0.4, 0.2, 1.1]]:
+                for x0 in [guess, 0 * guess]:
+                    x = x0.copy()
+                    polynomial(A, x, b, coefficients, iterations=2)
+                    xr = x0.copy()
+                    polynomial(aslinearoperator(A), xr, b, coefficients,
+                               iterations=2)
+                    assert_almost_equal(x, xr)
+                    if not x0.any():
+                        x = x0.copy()
+                        polynomial(A, x, b, coefficients, iterations=2,
+                                   zero_guess=True)
+                        assert_almost_equal(x, xr)
+
+        # single precision, as in a hierarchy with cycle_dtype, is smoothed
+        # by amg_core with the coefficients cast to its dtype
+        from pyamg.util.profile import Profile
+        A = poisson((10, 10), format='csr')
+        for dtype in [np.float32, np.complex64]:
+            A32 = A.astype(dtype)
+            b = np.random.rand(A.shape[0]).astype(dtype)
+            x = np.zeros_like(b)
+            xr = np.zeros_like(b)
+            profile = Profile(trace_memory=False)
+            with profile.timing_kernels():
+                polynomial(A32, x, b, [-0.1, 0.4, 0.2])
+            assert_equal(profile.kernels['polynomial'][0], 1)
+            polynomial(aslinearoperator(A32), xr, b, [-0.1, 0.4, 0.2])
+            assert_almost_equal(x, xr, decimal=5)
+
     def test_jacobi(self):
         N = 1
         A = spdiags([2*np.ones(N), -np.ones(N), -np.ones(N)], [0, -1, 1], N, N,
@@ -194,6 +238,63 @@ class TestRelaxation(TestCase):
         assert_almost_equal(x,
                             2.0/3.0*x_copy + 1.0/3.0*np.array([5.5, 11.0, 15.5]))
 
+    def test_jacobi_threads(self):
+        from concurrent.futures import ThreadPoolExecutor
+
+        # threaded kernels give the same result for any number of threads
+        assert(amg_core.set_num_threads(0) >= 1)
+        num_threads = amg_core.set_num_threads(0)
+
+        A = elasticity.linear_elasticity((10, 10))[0]
+        Acsr = A.tocsr()
+        Dinv = get_block_diag(A, blocksize=2, inv_flag=True)
+        b = np.sin(np.arange(A.shape[0], dtype=float))
+
+        results = []
+        for n in [1, 4]:
+            threads = amg_core.set_num_threads(n)
+            # the setting is process wide, it applies in other threads
+            with ThreadPoolExecutor(max_workers=1) as pool:
+                assert_equal(pool.submit(amg_core.set_num_threads, 0).result(),
+                             threads)
+            x1 = np.zeros(A.shape[0])
+            x2 = np.zeros(A.shape[0])
+            x3 = np.zeros(A.shape[0])
+            jacobi(Acsr, x1, b, iterations=3, omega=0.5)
+            jacobi(A, x2, b, iterations=3, omega=0.5)
+            block_jacobi(A, x3, b, Dinv=Dinv, blocksize=2, iterations=3,
+                         omega=0.5)
+            results.append((x1, x2, x3))
+        amg_core.set_num_threads(num_threads)
+
+        for x, y in zip(results[0], results[1]):
+            assert_almost_equal(x, y)
+
+    def test_multiple_rhs(self):
+        # relaxing a block of right-hand sides is the same as relaxing
+        # each of them separately
+        np.random.seed(3181)
+        A = elasticity.linear_elasticity((6, 6))[0]
+        cases = [A.tocsr(), A, poisson((10, 10), format='csr')]
+
+        for A in cases:
+            for dtype in [np.float64, np.complex128]:
+                A = A.astype(dtype)
+                X0 = np.random.rand(A.shape[0], 3).astype(dtype)
+                B = np.random.rand(A.shape[0], 3).astype(dtype)
+                methods = [(gauss_seidel, {'sweep': 'forward'}),
+                           (gauss_seidel, {'sweep': 'backward'}),
+                           (gauss_seidel, {'sweep': 'symmetric'}),
+                           (gauss_seidel, {'sweep': 'multicolor'}),
+                           (jacobi, {'omega': 0.5})]
+                for method, kwargs in methods:
+                    X = X0.copy()
+                    method(A, X, B, iterations=2, **kwargs)
+                    for j in range(B.shape[1]):
+                        x = X0[:, j].copy()
+                        method(A, x, B[:, j].copy(), iterations=2, **kwargs)
+                        assert_almost_equal(X[:, j], x)
+
     def test_jacobi_bsr(self):
         cases = []
         # JBS: remove some N
@@ -247,6 +348,53 @@ class TestRelaxation(TestCase):
                     gauss_seidel(B, x_bsr, b, sweep=sweep)
                     assert_almost_equal(x_bsr, x_csr)
 
+    def test_gauss_seidel_multicolor(self):
+        cases = []
+        cases.append(poisson((10,), format='csr'))
+        cases.append(poisson((7, 7), format='csr'))
+        cases.append(elasticity.linear_elasticity((5, 5))[0].tocsr())
+        C = sprand(20, 20, 0.3) + eye(20, 20)
+        cases.append((C*C.H).tocsr())
+        C = sprand(20, 20, 0.2) + 2.0*eye(20, 20)
+        cases.append(C.tocsr())
+
+        for A in cases:
+            # no two rows of the same color are coupled
+            color_ptr, color_rows = multicolor_parameters(A)
+            colors = np.empty(A.shape[0], dtype=int)
+            for c in range(color_ptr.shape[0]-1):
+                colors[color_rows[color_ptr[c]:color_ptr[c+1]]] = c
+            Acoo = A.tocoo()
+            mask = Acoo.row != Acoo.col
+            assert((colors[Acoo.row[mask]] != colors[Acoo.col[mask]]).all())
+
+            # multicolor GS is GS in the order of the colors
+            x = np.arange(A.shape[0]).astype(np.float64)
+            b = np.sin(x)
+            x_indexed = x.copy()
+            gauss_seidel(A, x, b, iterations=2, sweep='multicolor')
+            gauss_seidel_indexed(A, x_indexed, b, color_rows, iterations=2)
+            assert_almost_equal(x, x_indexed)
+
+            # the coloring is cached on A
+            assert(multicolor_parameters(A) is A.multicolor_parameters)
+
+            # BSR variant relaxes pointwise within each block
+            if A.shape[0] % 2 == 0:
+                B = A.tobsr(blocksize=(2, 2))
+                color_ptr, color_rows = multicolor_parameters(B)
+                order = np.ravel(np.vstack((2*color_rows, 2*color_rows+1)).T)
+                x_bsr = np.arange(B.shape[0]).astype(np.float64)
+                x_indexed = x_bsr.copy()
+                gauss_seidel(B, x_bsr, b, sweep='multicolor')
+                gauss_seidel_indexed(A, x_indexed, b, order)
+                assert_almost_equal(x_bsr, x_indexed)
+
+        # a matrix without rows has no colors
+        color_ptr, color_rows = multicolor_parameters(csr_matrix((0, 0)))
+        assert_equal(color_ptr, [0])
+        assert_equal(color_rows.shape, (0,))
+
     def test_gauss_seidel_gold(self):
         np.random.seed(0)
 
@@ -705,6 +853,10 @@ class TestRelaxation(TestCase):
         temp = np.random.rand(4, 4)
         cases.append(csr_matrix(temp.T.dot(temp)))
 
+        # singular blocks, which are pseudo-inverted
+        temp = np.random.rand(2, 4)
+        cases.append(csr_matrix(temp.T.dot(temp)))
+
         # reference implementation
         def gold(A, x, b, iterations, sweep='forward'):
             A = csr_matrix(A)
@@ -760,6 +912,47 @@ class TestRelaxation(TestCase):
             assert_almost_equal(x, gold(A, x_copy, b, iterations=1,
                                         sweep='symmetric'))
 
+    def test_schwarz_multicolor(self):
+        np.random.seed(1771228934)
+
+        A = poisson((8, 8), format='csr')
+        A.data[0] = 10.0
+        A.data[1] = -0.5
+        A.data[3] = -0.5
+        b = np.random.rand(A.shape[0])
+        x0 = np.random.rand(A.shape[0])
+
+        # the explicit inverses give the same result as the LU factors
+        x = x0.copy()
+        schwarz(A, x, b, iterations=2, sweep='symmetric')
+        subdomain, subdomain_ptr, inv_subblock, inv_subblock_ptr = \
+            schwarz_parameters(A)
+        xinv = x0.copy()
+        schwarz(A, xinv, b, iterations=2, subdomain=subdomain,
+                subdomain_ptr=subdomain_ptr, inv_subblock=inv_subblock,
+                inv_subblock_ptr=inv_subblock_ptr, sweep='symmetric')
+        assert_almost_equal(xinv, x)
+
+        # multicolor Schwarz is multiplicative Schwarz with the subdomains
+        # in the order of their colors
+        for subdomain, subdomain_ptr in [(None, None),
+                                         (np.arange(64), np.arange(0, 65, 8))]:
+            x = x0.copy()
+            schwarz(A, x, b, iterations=1, subdomain=subdomain,
+                    subdomain_ptr=subdomain_ptr, sweep='multicolor')
+            subdomain, subdomain_ptr = \
+                schwarz_factors(A, subdomain, subdomain_ptr)[:2]
+            color_ptr, color_domains = schwarz_colors(A, subdomain,
+                                                      subdomain_ptr)
+            assert(color_ptr.shape[0] > 2)
+
+            xr = x0.copy()
+            for i in color_domains:
+                si = subdomain[subdomain_ptr[i]:subdomain_ptr[i+1]]
+                Ai = A[si, :][:, si].toarray()
+                xr[si] += solve(Ai, b[si] - A[si, :] * xr)
+            assert_almost_equal(x, xr)
+
 
 # Test complex arithmetic
 class TestComplexRelaxation(TestCase):
@@ -1702,6 +1895,57 @@ class TestBlockRelaxation(TestCase):
             assert_almost_equal(x, gold(A, x_copy, b, blocksize, 'symmetric'),
                                 decimal=4)
 
+    def test_compiled_blocksizes(self):
+        # the blocksizes that the kernels are compiled for, see
+        # instantiate.yml, relax as the generic kernels
+        np.random.seed(1848215641)
+
+        def kernels(A, b, Dinv, temp, start, stop, step):
+            Ap, Aj, Ax = A.indptr, A.indices, np.ravel(A.data)
+            D = A.blocksize[0]
+            omega = np.array([0.7])
+            color_ptr, color_rows = multicolor_parameters(A)
+            colors = color_ptr.shape[0] - 1
+            color_sweep = (0, colors, 1) if step > 0 else (colors - 1, -1, -1)
+            coefficients = np.array([0.1, -0.4, 0.2], dtype=A.dtype)
+            return [('bsr_gauss_seidel', (Ap, Aj, Ax),
+                     (b, start, stop, step, D)),
+                    ('bsr_gauss_seidel_multicolor', (Ap, Aj, Ax),
+                     (b, color_ptr, color_rows) + color_sweep + (D,)),
+                    ('bsr_jacobi', (Ap, Aj, Ax),
+                     (b, temp, start, stop, step, D, omega)),
+                    ('block_jacobi', (Ap, Aj, Ax),
+                     (b, Dinv, temp, start, stop, step, omega, D)),
+                    ('block_gauss_seidel', (Ap, Aj, Ax),
+                     (b, Dinv, start, stop, step, D)),
+                    ('bsr_polynomial', (Ap, Aj, Ax),
+                     (b, np.empty(3 * b.size, dtype=b.dtype), coefficients,
+                      step < 0, D))]
+
+        for D in [2, 3, 4, 6]:
+            for dtype in [np.float64, np.complex128]:
+                C = sprand(8*D, 8*D, 0.3) + eye(8*D, 8*D)
+                A = (C*C.H).tobsr(blocksize=(D, D)).astype(dtype)
+                if dtype == np.complex128:
+                    A = A + 1.0j*A
+                A.sort_indices()
+                n = A.shape[0] // D
+                Dinv = np.ravel(get_block_diag(A, blocksize=D, inv_flag=True))
+                b = np.random.rand(A.shape[0]).astype(dtype)
+                x0 = np.random.rand(A.shape[0]).astype(dtype)
+                temp = np.empty_like(x0)
+
+                for start, stop, step in [(0, n, 1), (n - 1, -1, -1)]:
+                    for name, matrix, args in kernels(A, b, Dinv, temp,
+                                                      start, stop, step):
+                        x = x0.copy()
+                        getattr(amg_core, name)(*(matrix + (x,) + args))
+                        x_generic = x0.copy()
+                        getattr(amg_core, name + '_generic')(
+                            *(matrix + (x_generic,) + args))
+                        assert(np.abs(x - x0).max() > 0)
+                        assert_almost_equal(x, x_generic)
+
 # class TestDispatch(TestCase):
 #     def test_string(self):
 #         from pyamg.relaxation import dispatch
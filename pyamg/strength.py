@@ -667,17 +667,15 @@ def evolution_strength_of_connection(A, B=None, epsilon=4.0, k=2,
             Atilde = Atilde * Atilde
 
         # Call incomplete mat-mat mult
-        AtildeCSC = Atilde.tocsc()
-        AtildeCSC.sort_indices()
         mask.sort_indices()
         Atilde.sort_indices()
-        amg_core.incomplete_mat_mult_csr(Atilde.indptr, Atilde.indices,
-                                         Atilde.data, AtildeCSC.indptr,
-                                         AtildeCSC.indices, AtildeCSC.data,
-                                         mask.indptr, mask.indices, mask.data,
-                                         dimen)
+        amg_core.masked_mat_mult_csr(Atilde.indptr, Atilde.indices,
+                                     Atilde.data, Atilde.indptr,
+                                     Atilde.indices, Atilde.data,
+                                     mask.indptr, mask.indices, mask.data,
+                                     dimen, dimen, 0)
 
-        del AtildeCSC, Atilde
+        del Atilde
         Atilde = mask
         Atilde.eliminate_zeros()
         Atilde.sort_indices()
@@ -774,6 +772,15 @@ def evolution_strength_of_connection(A, B=None, epsilon=4.0, k=2,
         _array_precision = {'f': 0, 'd': 1, 'g': 2, 'F': 0, 'D': 1, 'G': 2}
         tol = {0: feps * 1e3, 1: eps * 1e6, 2: geps * 1e6}[_array_precision[t]]
 
+        # Scratch space for the local minimization problems, one slice for
+        # each thread
+        max_length = np.max(np.diff(Atilde.indptr))
+        num_threads = amg_core.set_num_threads(0)
+        workspace = np.empty((num_threads * (2 * max_length * (NullDim + 1) +
+                                             3 * (NullDim + 1)**2 +
+                                             2 * (NullDim + 1)),),
+                             dtype=Atilde.dtype)
+
         # Use constrained min problem to define strength
         amg_core.evolution_strength_helper(Atilde.data,
                                            Atilde.indptr,
@@ -782,7 +789,8 @@ def evolution_strength_of_connection(A, B=None, epsilon=4.0, k=2,
                                            np.ravel(Bmat),
                                            np.ravel((D_A * B.conj()).T),
                                            np.ravel(BDB),
-                                           BDBCols, NullDim, tol)
+                                           BDBCols, NullDim, tol,
+                                           workspace)
 
         Atilde.eliminate_zeros()
 
@@ -95,6 +95,33 @@ class TestGraph(TestCase):
                 c = vertex_coloring(G, method=method)
                 assert_is_vertex_coloring(G, c)
 
+    def test_thread_count(self):
+        # the parallel methods give the same result for any number of threads
+        from pyamg.graph import asgraph
+        num_threads = amg_core.set_num_threads(0)
+        try:
+            for G in self.cases:
+                G = asgraph(G)
+                N = G.shape[0]
+                y = np.random.rand(N)
+                results = []
+                for threads in [1, 4]:
+                    amg_core.set_num_threads(threads)
+                    mis = -np.ones(N, dtype='intc')
+                    amg_core.maximal_independent_set_parallel(
+                        N, G.indptr, G.indices, -1, 1, 0, mis, y, -1)
+                    misk = np.empty(N, dtype='intc')
+                    amg_core.maximal_independent_set_k_parallel(
+                        N, G.indptr, G.indices, 2, misk, y, -1)
+                    coloring = np.empty(N, dtype='intc')
+                    amg_core.vertex_coloring_jones_plassmann(
+                        N, G.indptr, G.indices, coloring, y.copy())
+                    results.append((mis, misk, coloring))
+                for a, b in zip(results[0], results[1]):
+                    assert_equal(a, b)
+        finally:
+            amg_core.set_num_threads(num_threads)
+
     def test_bellman_ford(self):
         """Test pile of cases against reference implementation."""
 
@@ -116,6 +143,33 @@ class TestGraph(TestCase):
                 assert_equal(D_result, D_expected)
                 assert_equal(S_result, S_expected)
 
+    def test_bellman_ford_frontier(self):
+        from pyamg.graph import asgraph
+        np.random.seed(1518834332)
+        num_threads = amg_core.set_num_threads(0)
+        try:
+            for G in self.cases:
+                G = asgraph(G)
+                G.data = np.random.rand(G.nnz)
+                N = G.shape[0]
+
+                seeds = np.random.permutation(N)[:max(1, int(N/10))]
+                D_expected, S_expected = bellman_ford(G, seeds)
+
+                for threads in [1, 4]:
+                    amg_core.set_num_threads(threads)
+                    D_result = np.full(N, np.inf, dtype=G.dtype)
+                    D_result[seeds] = 0
+                    S_result = np.full(N, -1, dtype='intc')
+                    S_result[seeds] = seeds
+                    amg_core.bellman_ford_frontier(N, G.indptr, G.indices,
+                                                   G.data, D_result, S_result)
+
+                    assert_equal(D_result, D_expected)
+                    assert_equal(S_result, S_expected)
+        finally:
+            amg_core.set_num_threads(num_threads)
+
     def test_bellman_ford_reference(self):
         Edges = np.array([[1, 4],
                           [3, 1],
@@ -279,6 +333,33 @@ def test_breadth_first_search():
     assert_equal(BFS(G, 3)[1], [-1, -1, -1, 0])
 
 
+def test_reverse_cuthill_mckee():
+    from pyamg.graph import reverse_cuthill_mckee
+
+    def bandwidth(G):
+        G = G.tocoo()
+        return np.abs(G.row - G.col).max()
+
+    # a path, searched from an end, and an isolated vertex
+    G = sparse.csr_matrix([[0, 0, 1, 0],
+                           [0, 0, 0, 0],
+                           [1, 0, 0, 1],
+                           [0, 0, 1, 0]])
+    assert_equal(reverse_cuthill_mckee(G), [3, 2, 0, 1])
+
+    np.random.seed(1407221631)
+    A = poisson((20, 20), format='csr')
+    for dtype in [np.intc, np.int64]:
+        p = np.random.permutation(A.shape[0])
+        B = A[p, :][:, p].tocsr()
+        B.indptr = B.indptr.astype(dtype)
+        B.indices = B.indices.astype(dtype)
+        order = reverse_cuthill_mckee(B)
+        assert_equal(np.sort(order), np.arange(A.shape[0]))
+        assert(bandwidth(B[order, :][:, order]) <= 20)
+        assert(bandwidth(B) > 20)
+
+
 def test_connected_components():
 
     cases = []
@@ -97,6 +97,675 @@ class TestMultilevel(TestCase):
             # print residuals
             assert_almost_equal(np.linalg.norm(b - A*x), residuals[-1])
 
+    def test_residual_restrict(self):
+        from pyamg import smoothed_aggregation_solver, ruge_stuben_solver
+        from pyamg.gallery import linear_elasticity
+        np.random.seed(2171)
+
+        cases = []
+        A = poisson((20, 20), format='csr')
+        cases.append((A, smoothed_aggregation_solver(A, max_coarse=10)))
+        cases.append((A, ruge_stuben_solver(A, max_coarse=10)))
+        A, B = linear_elasticity((10, 10))
+        cases.append((A, smoothed_aggregation_solver(A, B=B, max_coarse=10)))
+        A = poisson((20, 20), format='csr')
+        A = A + 1e-2j*A
+        cases.append((A, smoothed_aggregation_solver(A, max_coarse=10)))
+
+        for A, ml in cases:
+            b = np.random.rand(A.shape[0]).astype(A.dtype)
+            x_fused = ml.solve(b, maxiter=3, tol=1e-12)
+            for level in ml.levels[:-1]:
+                # the fused residual and restriction is used on all levels
+                assert(level.RT is not None)
+                level.RT = None
+            x = ml.solve(b, maxiter=3, tol=1e-12)
+            assert_almost_equal(x_fused, x)
+
+    def test_workspace(self):
+        from concurrent.futures import ThreadPoolExecutor
+        from pyamg import smoothed_aggregation_solver
+        np.random.seed(1764)
+
+        A = poisson((20, 20), format='csr')
+        b = np.random.rand(A.shape[0])
+        np.random.seed(2181693367)
+        ml = smoothed_aggregation_solver(A, max_coarse=10,
+                                         presmoother='schwarz',
+                                         postsmoother='jacobi')
+        x = ml.solve(b, maxiter=3, tol=1e-12, cycle='W')
+        arrays = [dict(level.workspace.arrays) for level in ml.levels]
+        assert('schwarz' in arrays[0] and 'jacobi' in arrays[0])
+
+        # repeated solves reuse the workspace and are unchanged by it
+        x2 = ml.solve(b, maxiter=3, tol=1e-12, cycle='W')
+        assert_equal(x, x2)
+        for level, before in zip(ml.levels, arrays):
+            assert(not hasattr(level.A, 'workspace'))
+            assert_equal(sorted(before.keys()),
+                         sorted(level.workspace.arrays.keys()))
+            for name in before:
+                assert(level.workspace.arrays[name] is before[name])
+
+        # a second hierarchy on the same A has its own workspace
+        np.random.seed(2181693367)
+        ml2 = smoothed_aggregation_solver(A, max_coarse=10,
+                                          presmoother='schwarz',
+                                          postsmoother='jacobi')
+        x2 = ml2.solve(b, maxiter=3, tol=1e-12, cycle='W')
+        assert_equal(x, x2)
+        for level, level2 in zip(ml.levels, ml2.levels):
+            for name in level2.workspace.arrays:
+                assert(level2.workspace.arrays[name] is not
+                       level.workspace.arrays.get(name))
+
+        # each thread solves with its own temporaries of the same workspace
+        B = np.random.rand(A.shape[0], 8)
+
+        def solve(j):
+            x = [ml.solve(B[:, j], maxiter=3, tol=1e-12, cycle=cycle)
+                 for cycle in ['V', 'W']]
+            return x, [dict(level.workspace.arrays) for level in ml.levels]
+
+        # with the Python cycle and with the native cycle
+        for max_nnz in [0, multilevel_solver.native_cycle_max_nnz]:
+            ml.native_cycle_max_nnz = max_nnz
+            serial = [solve(j)[0] for j in range(B.shape[1])]
+            with ThreadPoolExecutor(max_workers=4) as pool:
+                results = list(pool.map(solve, range(B.shape[1])))
+            assert_equal([r[0] for r in results], serial)
+            for lvl, before in enumerate(arrays):
+                for name in before:
+                    assert(ml.levels[lvl].workspace.arrays[name] is
+                           before[name])
+                    for r in results:
+                        assert(r[1][lvl].get(name) is not before[name])
+
+        # without a workspace, the relaxation methods allocate scratch space
+        from pyamg.relaxation.relaxation import jacobi, schwarz
+        x2 = np.zeros_like(b)
+        jacobi(A, x2, b, iterations=2, omega=0.5)
+        x3 = np.zeros_like(b)
+        jacobi(A, x3, b, iterations=2, omega=0.5,
+               workspace=ml.levels[0].workspace)
+        assert_equal(x2, x3)
+        schwarz(A, x2, b)
+        schwarz(A, x3, b, workspace=ml.levels[0].workspace)
+        assert_equal(x2, x3)
+
+    def test_multiple_rhs(self):
+        from pyamg import smoothed_aggregation_solver, ruge_stuben_solver
+        np.random.seed(2091)
+
+        A = poisson((20, 20), format='csr')
+        B = np.random.rand(A.shape[0], 4)
+        cases = []
+        cases.append(smoothed_aggregation_solver(A, max_coarse=10))
+        cases.append(ruge_stuben_solver(A, max_coarse=10,
+                                        presmoother='jacobi',
+                                        postsmoother='jacobi',
+                                        coarse_solver='splu'))
+        cases.append(smoothed_aggregation_solver(A, max_coarse=10,
+                                                 presmoother='schwarz',
+                                                 postsmoother='schwarz'))
+
+        # the block of right-hand sides gives the same iterates as
+        # solving each of them separately
+        for ml in cases:
+            for cycle in ['V', 'W', 'F']:
+                residuals = []
+                X = ml.solve(B, maxiter=4, tol=1e-14, cycle=cycle,
+                             residuals=residuals)
+                assert_equal(X.shape, B.shape)
+                assert_equal(len(residuals), 5)
+                for j in range(B.shape[1]):
+                    res = []
+                    x = ml.solve(B[:, j], maxiter=4, tol=1e-14, cycle=cycle,
+                                 residuals=res)
+                    assert_almost_equal(X[:, j], x)
+                    assert_almost_equal([r[j] for r in residuals], res)
+
+            X0 = np.random.rand(*B.shape)
+            X = ml.solve(B, x0=X0, maxiter=2, tol=1e-14)
+            for j in range(B.shape[1]):
+                x = ml.solve(B[:, j], x0=X0[:, j], maxiter=2, tol=1e-14)
+                assert_almost_equal(X[:, j], x)
+
+            # accelerated solves and AMLI cycles go one column at a time
+            residuals = []
+            X = ml.solve(B, tol=1e-8, accel='cg', residuals=residuals)
+            assert_equal(len(residuals), B.shape[1])
+            for j in range(B.shape[1]):
+                x = ml.solve(B[:, j], tol=1e-8, accel='cg')
+                assert_almost_equal(X[:, j], x)
+
+            M = ml.aspreconditioner()
+            assert_almost_equal(M.matmat(B),
+                                np.column_stack([M*B[:, j]
+                                                 for j in range(4)]))
+
+    def test_mixed_precision(self):
+        from pyamg import smoothed_aggregation_solver, ruge_stuben_solver
+        np.random.seed(1612)
+
+        A = poisson((30, 30), format='csr')
+        b = np.random.rand(A.shape[0])
+        cases = []
+        cases.append(smoothed_aggregation_solver(A, max_coarse=10,
+                                                 cycle_dtype=np.float32))
+        cases.append(ruge_stuben_solver(A, max_coarse=10,
+                                        cycle_dtype=np.float32))
+
+        for ml in cases:
+            assert_equal(ml.outer_A.dtype, np.float64)
+            assert_equal((ml.outer_A - A).nnz, 0)
+            for level in ml.levels:
+                assert_equal(level.A.dtype, np.float32)
+            for level in ml.levels[:-1]:
+                assert_equal(level.P.dtype, np.float32)
+                assert_equal(level.R.dtype, np.float32)
+
+            # the solution is accurate beyond single precision
+            for accel in [None, 'cg']:
+                residuals = []
+                x = ml.solve(b, tol=1e-10, maxiter=100, accel=accel,
+                             residuals=residuals)
+                assert_equal(x.dtype, np.float64)
+                assert(np.linalg.norm(b - A * x) < 1e-9 * np.linalg.norm(b))
+
+            M = ml.aspreconditioner()
+            assert_equal(M.dtype, np.float64)
+            assert_equal((M * b).dtype, np.float64)
+
+        # no conversion if cycle_dtype matches A
+        ml = smoothed_aggregation_solver(A, max_coarse=10,
+                                         cycle_dtype=np.float64)
+        assert(ml.outer_A is None)
+        assert_equal(ml.levels[0].A.dtype, np.float64)
+
+    def test_profile(self):
+        from pyamg import smoothed_aggregation_solver, ruge_stuben_solver
+        from pyamg import amg_core
+        np.random.seed(1613)
+
+        A = poisson((30, 30), format='csr')
+        b = np.random.rand(A.shape[0])
+        kernels = dict((name, getattr(amg_core, name))
+                       for name in dir(amg_core))
+        cases = []
+        cases.append((smoothed_aggregation_solver(A, max_coarse=10,
+                                                  profile=True),
+                      ['strength', 'aggregate', 'tentative', 'smooth', 'RAP',
+                       'smoother']))
+        cases.append((ruge_stuben_solver(A, max_coarse=10, profile=True),
+                      ['strength', 'splitting', 'interpolation', 'RAP',
+                       'smoother']))
+
+        for ml, phases in cases:
+            nlevels = len(ml.levels)
+            assert(nlevels > 2)
+            for lvl in range(nlevels - 1):
+                for phase in phases:
+                    calls, seconds, nbytes = ml.profile.setup[(lvl, phase)]
+                    assert_equal(calls, 1)
+                    assert(seconds >= 0.0)
+            assert(len(ml.profile.kernels) > 0)
+
+            residuals = []
+            ml.solve(b, tol=1e-8, maxiter=20, residuals=residuals)
+            cycles = len(residuals) - 1
+            for lvl in range(nlevels - 1):
+                for component in ['presmooth', 'restrict', 'prolongate',
+                                  'postsmooth']:
+                    assert_equal(ml.profile.solve[(lvl, component)][0],
+                                 cycles)
+            assert_equal(ml.profile.solve[(nlevels - 1, 'coarse_solve')][0],
+                         cycles)
+
+            summary = ml.profile_summary()
+            assert('Setup' in summary and 'Solve' in summary)
+
+        # the amg_core kernels are timed in place, not replaced
+        for name in dir(amg_core):
+            assert(getattr(amg_core, name) is kernels[name])
+
+        # only the calls of the profiling thread are timed, and nested
+        # profiles only see their own calls
+        from concurrent.futures import ThreadPoolExecutor
+        from pyamg.relaxation.relaxation import jacobi
+        from pyamg.util.profile import Profile
+        outer = Profile(trace_memory=False)
+        inner = Profile(trace_memory=False)
+        x = np.zeros_like(b)
+        with outer.timing_kernels():
+            with ThreadPoolExecutor(max_workers=1) as pool:
+                pool.submit(jacobi, A, x.copy(), b).result()
+            assert('jacobi' not in outer.kernels)
+            jacobi(A, x, b)
+            with inner.timing_kernels():
+                jacobi(A, x, b, iterations=1)
+                jacobi(A, x, b, iterations=2)
+            jacobi(A, x, b)
+        assert_equal(outer.kernels['jacobi'][0], 2)
+        assert_equal(inner.kernels['jacobi'][0], 3)
+        jacobi(A, x, b)
+        assert_equal(outer.kernels['jacobi'][0], 2)
+
+        # no profile by default
+        ml = smoothed_aggregation_solver(A, max_coarse=10)
+        assert(ml.profile is None)
+        ml.solve(b, maxiter=2)
+        assert(isinstance(ml.profile_summary(), str))
+
+    def test_update(self):
+        from pyamg import smoothed_aggregation_solver, ruge_stuben_solver
+        from pyamg import rootnode_solver
+        from pyamg.gallery import linear_elasticity
+
+        A = poisson((30, 30), format='csr')
+        np.random.seed(1579203478)
+        b = np.random.rand(A.shape[0])
+        # D A D has the same symmetric strength of connection, and so the
+        # same aggregates, as A
+        d = 1.0 + np.random.rand(A.shape[0])
+        rows = np.repeat(np.arange(A.shape[0]), np.diff(A.indptr))
+        A2 = A.copy()
+        A2.data = d[rows] * A.data * d[A.indices]
+
+        cases = []
+        cases.append((smoothed_aggregation_solver, A, A2,
+                      {'max_coarse': 10}))
+        cases.append((smoothed_aggregation_solver, A, A2,
+                      {'max_coarse': 10, 'keep': True,
+                       'presmoother': 'schwarz', 'postsmoother': 'schwarz'}))
+        cases.append((smoothed_aggregation_solver, A, A2,
+                      {'max_coarse': 10, 'smooth': 'energy'}))
+        cases.append((smoothed_aggregation_solver, A, A2,
+                      {'max_coarse': 10, 'coarse_solver': 'splu',
+                       'cycle_dtype': np.float32}))
+        # the classical strength of connection is invariant to scaling
+        cases.append((ruge_stuben_solver, A, 2.5 * A, {'max_coarse': 10}))
+
+        E, B = linear_elasticity((10, 10), format='bsr')
+        E2 = E.copy()
+        E2.data *= 3.0
+        cases.append((smoothed_aggregation_solver, E, E2,
+                      {'B': B, 'max_coarse': 10}))
+
+        for method, A1, A2, kwargs in cases:
+            np.random.seed(2181693367)
+            ml = method(A1, **kwargs)
+            x1 = ml.solve(b[:A1.shape[0]], tol=1e-8, maxiter=100)
+
+            np.random.seed(2181693367)
+            ml.update(A2)
+            np.random.seed(2181693367)
+            exact = method(A2, **kwargs)
+
+            assert_equal(len(ml.levels), len(exact.levels))
+            for level, exact_level in zip(ml.levels, exact.levels):
+                assert_equal(level.A.dtype, exact_level.A.dtype)
+                assert_almost_equal(level.A.toarray(),
+                                    exact_level.A.toarray(), decimal=5)
+                assert(not hasattr(level.A, 'workspace'))
+
+            residuals = []
+            x2 = ml.solve(b[:A1.shape[0]], tol=1e-8, maxiter=100,
+                          residuals=residuals)
+            assert(np.linalg.norm(b[:A2.shape[0]] - A2 * x2) <
+                   1e-7 * np.linalg.norm(b[:A2.shape[0]]))
+            assert(np.linalg.norm(x1 - x2) > 1e-3 * np.linalg.norm(x1))
+
+        # the patterns of the prolongators and coarse operators are reused,
+        # and the candidates are improved from those of the setup, so that
+        # an update for the same A is the setup
+        for method in [smoothed_aggregation_solver, ruge_stuben_solver]:
+            np.random.seed(2181693367)
+            ml = method(A, max_coarse=10)
+            levels = ml.levels
+            np.random.seed(2181693367)
+            ml.update(A)
+            for level, old_level in zip(ml.levels[1:], levels[1:]):
+                assert(level.A.indices is old_level.A.indices)
+                assert_equal(level.A.data, old_level.A.data)
+            if method is smoothed_aggregation_solver:
+                for level, old_level in zip(ml.levels, levels):
+                    assert_equal(level.B, old_level.B)
+                for level, old_level in zip(ml.levels[:-1], levels[:-1]):
+                    assert(level.P.indices is old_level.P.indices)
+
+        # the patterns of the setup are kept for reordered and compressed
+        # hierarchies, whose levels are permuted and in other formats
+        max_nnz = multilevel_solver.native_cycle_max_nnz
+        multilevel_solver.native_cycle_max_nnz = 0
+        try:
+            for method, Anew in [(smoothed_aggregation_solver, A2),
+                                 (ruge_stuben_solver, 2.5 * A)]:
+                np.random.seed(2181693367)
+                ml = method(A, max_coarse=10, reorder='rcm', compress=True)
+                patterns = ml.patterns
+                assert_equal(len(patterns), len(ml.levels))
+                np.random.seed(2181693367)
+                ml.update(Anew)
+                for pattern, old_pattern in zip(ml.patterns[1:],
+                                                patterns[1:]):
+                    assert(pattern.A.indices is old_pattern.A.indices)
+                if method is smoothed_aggregation_solver:
+                    for pattern, old_pattern in zip(ml.patterns[:-1],
+                                                    patterns[:-1]):
+                        assert(pattern.P.indices is old_pattern.P.indices)
+
+                np.random.seed(2181693367)
+                exact = method(Anew, max_coarse=10)
+                for level, exact_level in zip(ml.patterns, exact.levels):
+                    assert_equal(level.A.indices, exact_level.A.indices)
+                x = ml.solve(b, tol=1e-8, maxiter=100)
+                assert(np.linalg.norm(b - Anew * x) <
+                       1e-7 * np.linalg.norm(b))
+        finally:
+            multilevel_solver.native_cycle_max_nnz = max_nnz
+
+        # the data that setup and the smoothers cache on A is recomputed
+        # when the values of A are changed in place
+        for smoother in ['jacobi', 'schwarz']:
+            Ain = A.copy()
+            np.random.seed(2181693367)
+            ml = smoothed_aggregation_solver(Ain, max_coarse=10,
+                                             presmoother=smoother,
+                                             postsmoother=smoother)
+            ml.solve(b, tol=1e-8, maxiter=100)
+            Ain.data *= 2
+            np.random.seed(2181693367)
+            ml.update(Ain)
+            np.random.seed(2181693367)
+            exact = smoothed_aggregation_solver(2 * A, max_coarse=10,
+                                                presmoother=smoother,
+                                                postsmoother=smoother)
+            for level, exact_level in zip(ml.levels, exact.levels):
+                assert_almost_equal(level.A.toarray(),
+                                    exact_level.A.toarray())
+            residuals, exact_residuals = [], []
+            ml.solve(b, tol=1e-8, maxiter=100, residuals=residuals)
+            exact.solve(b, tol=1e-8, maxiter=100, residuals=exact_residuals)
+            assert_almost_equal(np.array(residuals) / residuals[0],
+                                np.array(exact_residuals) / residuals[0],
+                                decimal=5)
+
+        # the sparsity pattern must not change
+        ml = smoothed_aggregation_solver(A, max_coarse=10)
+        Ashift = A + sparse.eye(A.shape[0], k=2, format='csr')
+        for Abad in [A.tobsr(blocksize=(1, 1)), Ashift,
+                     poisson((20, 20), format='csr')]:
+            self.assertRaises(ValueError, ml.update, Abad)
+
+        # not available for hierarchies that do not set an updater
+        ml = rootnode_solver(A, max_coarse=10)
+        self.assertRaises(ValueError, ml.update, A2)
+
+    def test_native_cycle(self):
+        from pyamg import smoothed_aggregation_solver, ruge_stuben_solver
+        from pyamg.gallery import linear_elasticity
+
+        A = poisson((30, 30), format='csr')
+        E, B = linear_elasticity((10, 10), format='bsr')
+        np.random.seed(1393848193)
+
+        cases = []
+        cases.append((smoothed_aggregation_solver, A, {}))
+        cases.append((smoothed_aggregation_solver, A,
+                      {'presmoother': ('jacobi', {'iterations': 2}),
+                       'postsmoother': ('jacobi', {'iterations': 2}),
+                       'coarse_solver': 'lu'}))
+        cases.append((smoothed_aggregation_solver, A,
+                      {'presmoother': ('gauss_seidel', {'sweep': 'forward'}),
+                       'postsmoother': ('gauss_seidel',
+                                        {'sweep': 'backward'}),
+                       'cycle_dtype': np.float32}))
+        cases.append((ruge_stuben_solver, A, {'postsmoother': None}))
+        cases.append((smoothed_aggregation_solver, E, {'B': B}))
+        cases.append((smoothed_aggregation_solver, E,
+                      {'B': B, 'presmoother': 'jacobi',
+                       'postsmoother': 'jacobi'}))
+
+        for method, A, kwargs in cases:
+            ml = method(A, max_coarse=10, **kwargs)
+            native = ml._multilevel_solver__native_hierarchy()
+            assert_equal(native['start'], 0)
+
+            b = np.random.rand(A.shape[0])
+            x0 = np.random.rand(A.shape[0])
+            for cycle in ['V', 'W', 'F']:
+                x = ml.solve(b, x0=x0, tol=1e-12, maxiter=5, cycle=cycle)
+                ml.native_cycle_max_nnz = 0
+                exact = ml.solve(b, x0=x0, tol=1e-12, maxiter=5, cycle=cycle)
+                del ml.native_cycle_max_nnz
+                rtol = 1e-4 if ml.outer_A is not None else 1e-10
+                assert(np.linalg.norm(x - exact) <
+                       rtol * np.linalg.norm(exact))
+
+        # only the coarsest levels within native_cycle_max_nnz are native
+        ml = smoothed_aggregation_solver(A, max_coarse=10)
+        ml.native_cycle_max_nnz = ml.levels[1].A.nnz
+        native = ml._multilevel_solver__native_hierarchy()
+        assert(native['start'] > 1)
+
+        # other smoothers and coarse solvers are cycled in Python
+        for kwargs in [{'presmoother': 'sor'},
+                       {'postsmoother': ('gauss_seidel',
+                                         {'sweep': 'multicolor'})},
+                       {'coarse_solver': 'splu'}]:
+            ml = smoothed_aggregation_solver(A, max_coarse=10, **kwargs)
+            assert(ml._multilevel_solver__native_hierarchy() is None)
+            b = np.random.rand(A.shape[0])
+            residuals = []
+            ml.solve(b, tol=1e-8, residuals=residuals)
+            assert(residuals[-1] < 1e-8 * residuals[0])
+
+    def test_reorder(self):
+        from pyamg import smoothed_aggregation_solver, ruge_stuben_solver
+        from pyamg.gallery import linear_elasticity
+
+        np.random.seed(2834521991)
+        A = poisson((20, 20), format='csr')
+        p = np.random.permutation(A.shape[0])
+        A = A[p, :][:, p].tocsr()
+        E, B = linear_elasticity((8, 8), format='bsr')
+        jacobi = {'presmoother': 'jacobi', 'postsmoother': 'jacobi',
+                  'max_coarse': 10}
+
+        cases = []
+        cases.append((smoothed_aggregation_solver, A, {}, 'rcm'))
+        cases.append((smoothed_aggregation_solver, A, {}, 'aggregate'))
+        cases.append((smoothed_aggregation_solver, E, {'B': B}, 'rcm'))
+        cases.append((smoothed_aggregation_solver, E, {'B': B}, 'aggregate'))
+        cases.append((smoothed_aggregation_solver, A,
+                      {'cycle_dtype': np.float32}, 'rcm'))
+        cases.append((ruge_stuben_solver, A, {}, 'rcm'))
+
+        for method, A, kwargs, reorder in cases:
+            kwargs.update(jacobi)
+            ml = method(A, **kwargs)
+            mlr = method(A, reorder=reorder, **kwargs)
+
+            # each level is a permutation of the level of the setup
+            for level, levelr, q in zip(ml.levels, mlr.levels, mlr.orders):
+                Aq = level.A.tocsr()[q, :][:, q]
+                assert_equal(abs(levelr.A.tocsr() - Aq).max(), 0)
+                assert_equal(levelr.A.format, level.A.format)
+
+            # jacobi smoothing is independent of the ordering, so that the
+            # solutions agree in the ordering of A
+            rtol = 1e-4 if 'cycle_dtype' in kwargs else 1e-10
+            for solve in [lambda ml, b: ml.solve(b, tol=1e-8, maxiter=5),
+                          lambda ml, b: ml.aspreconditioner() * b]:
+                b = np.random.rand(A.shape[0])
+                x = solve(ml, b)
+                xr = solve(mlr, b)
+                assert(np.linalg.norm(xr - x) < rtol * np.linalg.norm(x))
+
+            # update takes A in its original ordering
+            A2 = A.copy()
+            A2.data *= 2.0
+            ml.update(A2)
+            mlr.update(A2)
+            b = np.random.rand(A.shape[0])
+            x = ml.solve(b, tol=1e-8, maxiter=5)
+            xr = mlr.solve(b, tol=1e-8, maxiter=5)
+            assert(np.linalg.norm(xr - x) < rtol * np.linalg.norm(x))
+
+        # the aggregates are contiguous and in the order of the coarse level
+        ml = smoothed_aggregation_solver(A, max_coarse=10, reorder='aggregate')
+        for lvl, level in enumerate(ml.levels[:-1]):
+            fine, coarse = ml.orders[lvl], ml.orders[lvl + 1]
+            AggOp = level.AggOp.tocsr()[fine, :][:, coarse].tocoo()
+            assert(np.all(np.diff(AggOp.col[np.argsort(AggOp.row)]) >= 0))
+
+        # Ruge-Stuben has no aggregates
+        self.assertRaises(ValueError, ruge_stuben_solver, A,
+                          reorder='aggregate')
+
+    def test_compress(self):
+        from pyamg import smoothed_aggregation_solver
+        from pyamg.util.compressed import delta_csr_matrix, aggregate_matrix
+
+        np.random.seed(1270219654)
+        A = poisson((30, 30), format='csr')
+        # a nonsymmetric A, for which R != P^H
+        rows = np.repeat(np.arange(A.shape[0]), np.diff(A.indptr))
+        Ans = A.copy()
+        Ans.data[A.indices < rows] *= 0.8
+        cases = []
+        cases.append((A, {'presmoother': 'jacobi', 'postsmoother': 'jacobi'},
+                      'cg'))
+        cases.append((A, {'presmoother': ('gauss_seidel',
+                                          {'sweep': 'symmetric'}),
+                          'postsmoother': ('gauss_seidel',
+                                           {'sweep': 'symmetric'})}, 'cg'))
+        cases.append((A, {'smooth': None}, 'cg'))
+        cases.append((Ans, {'symmetry': 'nonsymmetric'}, 'gmres'))
+
+        # compress the levels that the native cycle would take
+        max_nnz = multilevel_solver.native_cycle_max_nnz
+        multilevel_solver.native_cycle_max_nnz = 0
+        try:
+            for A, kwargs, accel in cases:
+                np.random.seed(2181693367)
+                ml = smoothed_aggregation_solver(A, max_coarse=10, **kwargs)
+                np.random.seed(2181693367)
+                mlc = smoothed_aggregation_solver(A, max_coarse=10,
+                                                  compress=True, **kwargs)
+                assert(len(mlc.levels) > 2)
+                for lvl, level in enumerate(mlc.levels[:-1]):
+                    if lvl > 0:
+                        assert(isinstance(level.A, delta_csr_matrix))
+                    if 'symmetry' in kwargs:
+                        # P is only compressed if R = P^H
+                        assert(not isinstance(level.P, (aggregate_matrix,
+                                                        delta_csr_matrix)))
+                    elif kwargs.get('smooth', 'jacobi') is None:
+                        assert(isinstance(level.P, aggregate_matrix))
+                    else:
+                        assert(isinstance(level.P, delta_csr_matrix))
+                assert(sparse.isspmatrix_csr(mlc.levels[-1].A))
+                assert_almost_equal(mlc.operator_complexity(),
+                                    ml.operator_complexity())
+
+                b = np.random.rand(A.shape[0])
+                x = ml.solve(b, tol=1e-8, maxiter=5)
+                xc = mlc.solve(b, tol=1e-8, maxiter=5)
+                assert(np.linalg.norm(xc - x) < 1e-10 * np.linalg.norm(x))
+                x = ml.solve(b, tol=1e-8, accel=accel)
+                xc = mlc.solve(b, tol=1e-8, accel=accel)
+                assert(np.linalg.norm(xc - x) < 1e-8 * np.linalg.norm(x))
+        finally:
+            multilevel_solver.native_cycle_max_nnz = max_nnz
+
+    def test_save_load(self):
+        import os
+        import shutil
+        import tempfile
+        from pyamg import smoothed_aggregation_solver, ruge_stuben_solver
+
+        np.random.seed(1518295264)
+        A = poisson((20, 20), format='csr')
+        b = np.random.rand(A.shape[0])
+        schwarz = ('schwarz', {'sweep': 'multicolor'})
+        multicolor = ('gauss_seidel', {'sweep': 'multicolor'})
+        chebyshev = ('chebyshev', {'degree': 2})
+
+        cases = []
+        cases.append((smoothed_aggregation_solver, {}, None))
+        cases.append((smoothed_aggregation_solver,
+                      {'presmoother': schwarz, 'postsmoother': schwarz,
+                       'coarse_solver': 'lu'}, 'schwarz_factors'))
+        cases.append((smoothed_aggregation_solver,
+                      {'presmoother': multicolor, 'postsmoother': multicolor,
+                       'reorder': 'rcm', 'cycle_dtype': np.float32},
+                      'multicolor_parameters'))
+        cases.append((smoothed_aggregation_solver,
+                      {'presmoother': 'jacobi', 'postsmoother': 'jacobi',
+                       'compress': True}, 'rho_D_inv'))
+        cases.append((ruge_stuben_solver,
+                      {'presmoother': chebyshev, 'postsmoother': chebyshev,
+                       'coarse_solver': 'splu'}, 'rho'))
+
+        # compress the levels that the native cycle would take
+        max_nnz = multilevel_solver.native_cycle_max_nnz
+        multilevel_solver.native_cycle_max_nnz = 0
+        directory = tempfile.mkdtemp()
+        try:
+            path = os.path.join(directory, 'hierarchy.bin')
+            for method, kwargs, cached in cases:
+                ml = method(A, max_coarse=10, **kwargs)
+                x = ml.solve(b, tol=1e-8, maxiter=5)
+                ml.save(path)
+
+                for mmap in [True, False]:
+                    ml2 = multilevel_solver.load(path, mmap=mmap)
+                    assert_equal(len(ml2.levels), len(ml.levels))
+                    for level, level2 in zip(ml.levels, ml2.levels):
+                        assert_equal(type(level2.A), type(level.A))
+                        assert_equal(level2.A.shape, level.A.shape)
+                        # a compressed R is loaded as the adjoint of P
+                        if getattr(getattr(level, 'R', None), 'adjoint_of',
+                                   None) is level.P:
+                            assert(level2.R.adjoint_of is level2.P)
+                    A2 = ml2.levels[0].A
+                    assert_equal(isinstance(A2.data.base, np.memmap), mmap)
+                    if cached is not None:
+                        # the smoothers are set up from the saved data
+                        assert(hasattr(A2, cached))
+
+                    x2 = ml2.solve(b, tol=1e-8, maxiter=5)
+                    assert_almost_equal(x2, x)
+                    del ml2, A2
+        finally:
+            multilevel_solver.native_cycle_max_nnz = max_nnz
+            shutil.rmtree(directory)
+
+    def test_concurrent_solves(self):
+        from concurrent.futures import ThreadPoolExecutor
+        from pyamg import smoothed_aggregation_solver, ruge_stuben_solver
+
+        # amg_core releases the GIL, solves on one hierarchy run in threads
+        A = poisson((40, 40), format='csr')
+        np.random.seed(2138695391)
+        B = np.random.rand(A.shape[0], 8)
+        cases = []
+        np.random.seed(2181693367)
+        cases.append(smoothed_aggregation_solver(A, max_coarse=10))
+        np.random.seed(2181693367)
+        cases.append(ruge_stuben_solver(A, max_coarse=10))
+
+        for ml in cases:
+            def solve(j):
+                return ml.solve(B[:, j], tol=1e-10, maxiter=10)
+
+            serial = [solve(j) for j in range(B.shape[1])]
+            with ThreadPoolExecutor(max_workers=4) as pool:
+                results = list(pool.map(solve, 2 * list(range(B.shape[1]))))
+            assert_equal(results, 2 * serial)
+
     def test_cycle_complexity(self):
         # four levels
         levels = []
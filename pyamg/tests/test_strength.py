@@ -7,7 +7,9 @@ from pyamg.gallery import poisson, linear_elasticity, load_example,\
 from pyamg.strength import classical_strength_of_connection,\
     symmetric_strength_of_connection, evolution_strength_of_connection,\
     distance_strength_of_connection
-from pyamg.amg_core import incomplete_mat_mult_csr
+from pyamg.amg_core import incomplete_mat_mult_csr, masked_mat_mult_csr,\
+    masked_mat_mult_symbolic, masked_mat_mult_pattern,\
+    masked_mat_mult_numeric_csr
 from pyamg.util.linalg import approximate_spectral_radius
 from pyamg.util.utils import scale_rows
 
@@ -66,6 +68,51 @@ class TestStrengthOfConnection(TestCase):
                 assert_equal(result.nnz, expected.nnz)
                 assert_array_almost_equal(result.toarray(), expected.toarray())
 
+    def test_strength_of_connection_threads(self):
+        # the row-parallel kernels give the same S for any number of threads
+        from pyamg import amg_core
+        num_threads = amg_core.set_num_threads(0)
+        try:
+            for A in self.cases:
+                results = []
+                for threads in [1, 4]:
+                    amg_core.set_num_threads(threads)
+                    results.append([classical_soc(A, 0.25),
+                                    classical_soc(A, 0.25, norm='min'),
+                                    symmetric_soc(A, 0.1)])
+                for S1, S2 in zip(results[0], results[1]):
+                    assert_array_equal(S1.indptr, S2.indptr)
+                    assert_array_equal(S1.indices, S2.indices)
+                    assert_array_equal(S1.data, S2.data)
+        finally:
+            amg_core.set_num_threads(num_threads)
+
+    def test_evolution_strength_of_connection_threads(self):
+        # the rows of the evolution measure are split over the threads, and
+        # give the same S for any number of threads
+        from pyamg import amg_core
+        num_threads = amg_core.set_num_threads(0)
+        cases = []
+        A, B = linear_elasticity((8, 8), format='bsr')
+        cases.append((A, B))
+        A = poisson((12, 12), format='csr')
+        B = np.vstack((np.ones(A.shape[0]), np.arange(A.shape[0]))).T
+        cases.append((A, B))
+        try:
+            for A, B in cases:
+                results = []
+                for threads in [1, 4]:
+                    amg_core.set_num_threads(threads)
+                    np.random.seed(1793)
+                    results.append(evolution_soc(A, B, epsilon=4.0, k=2,
+                                                 proj_type='D_A'))
+                S1, S2 = results
+                assert_array_equal(S1.indptr, S2.indptr)
+                assert_array_equal(S1.indices, S2.indices)
+                assert_array_equal(S1.data, S2.data)
+        finally:
+            amg_core.set_num_threads(num_threads)
+
     def test_distance_strength_of_connection(self):
         data = load_example('airfoil')
         cases = []
@@ -227,6 +274,74 @@ class TestStrengthOfConnection(TestCase):
             assert_array_equal(exact.indptr, result.indptr)
             assert_array_equal(exact.indices, result.indices)
 
+    def test_masked_mat_mult_csr(self):
+        # We test that (A*B).multiply(mask) = masked_mat_mult_csr(A,B,mask),
+        # and that the symbolic and numeric phases give the same result
+        np.random.seed(2001)
+        cases = []
+        for m, k, n in [(1, 1, 1), (5, 7, 3), (40, 30, 50), (200, 200, 200)]:
+            A = sparse.random(m, k, density=0.2, format='csr')
+            B = sparse.random(k, n, density=0.2, format='csr')
+            mask = sparse.random(m, n, density=0.3, format='csr')
+            cases.append((A, B, mask))
+            cases.append((A + 1.0j*A, B - 2.0j*B, mask))
+        A = poisson((10, 10), format='csr')
+        cases.append((A, A, A))
+        cases.append((A, A, A*A))
+
+        for A, B, mask in cases:
+            A.sort_indices()
+            mask = mask.astype(np.result_type(A.dtype, B.dtype))
+            mask.data[:] = 1.0
+            B = B.astype(mask.dtype)
+            A = A.astype(mask.dtype)
+            exact = (A*B).multiply(mask).toarray()
+
+            result = mask.copy()
+            masked_mat_mult_csr(A.indptr, A.indices, A.data, B.indptr,
+                                B.indices, B.data, result.indptr,
+                                result.indices, result.data,
+                                A.shape[0], B.shape[1], 0)
+            assert_array_almost_equal(result.toarray(), exact)
+
+            # force the hash accumulator, which accumulates in the same
+            # order as the dense one
+            result1 = mask.copy()
+            masked_mat_mult_csr(A.indptr, A.indices, A.data, B.indptr,
+                                B.indices, B.data, result1.indptr,
+                                result1.indices, result1.data,
+                                A.shape[0], B.shape[1], 1)
+            assert_equal(result1.data, result.data)
+
+            # compare to the dot-product version
+            BCSC = B.tocsc()
+            BCSC.sort_indices()
+            result2 = mask.copy()
+            result2.sort_indices()
+            if A.shape[0] == B.shape[1]:
+                incomplete_mat_mult_csr(A.indptr, A.indices, A.data,
+                                        BCSC.indptr, BCSC.indices, BCSC.data,
+                                        result2.indptr, result2.indices,
+                                        result2.data, A.shape[0])
+                assert_array_almost_equal(result2.toarray(), exact)
+
+            # reuse the symbolic phase
+            Hp = np.zeros(A.nnz + 1, dtype=np.intc)
+            masked_mat_mult_symbolic(A.indptr, A.indices, B.indptr, B.indices,
+                                     mask.indptr, mask.indices, Hp,
+                                     A.shape[0], B.shape[1])
+            Hb = np.zeros(Hp[-1], dtype=np.intc)
+            Hs = np.zeros(Hp[-1], dtype=np.intc)
+            masked_mat_mult_pattern(A.indptr, A.indices, B.indptr, B.indices,
+                                    mask.indptr, mask.indices, Hp, Hb, Hs,
+                                    A.shape[0], B.shape[1])
+            result3 = mask.copy()
+            for scale in [1.0, 2.0]:
+                masked_mat_mult_numeric_csr(A.indptr, scale*A.data, B.data,
+                                            Hp, Hb, Hs, result3.indptr,
+                                            result3.data, A.shape[0])
+                assert_array_equal(result3.data, scale*result.data)
+
     def test_evolution_strength_of_connection(self):
         # Params:  A, B, epsilon=4.0, k=2, proj_type="l2"
         cases = []
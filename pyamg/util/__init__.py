@@ -3,7 +3,10 @@ from __future__ import absolute_import
 
 from .info import __doc__
 
+from .arrayfile import *
+from .compressed import *
 from .linalg import *
+from .profile import *
 from .utils import *
 
 __all__ = [s for s in dir() if not s.startswith('_')]
@@ -0,0 +1,146 @@
+"""Aligned binary file of named arrays, for memory mapping."""
+from __future__ import absolute_import
+
+import json
+import struct
+
+import numpy as np
+
+__all__ = ['save_arrays', 'load_arrays']
+
+# file signature, followed by the length of the header as a little endian
+# uint64, the header in JSON, and the arrays
+MAGIC = b'PYAMGARR'
+VERSION = 1
+
+# alignment of each array in the file, in bytes, a multiple of the cache
+# line and of the size of any dtype
+ALIGNMENT = 64
+
+
+def _aligned(offset):
+    return -(-offset // ALIGNMENT) * ALIGNMENT
+
+
+def save_arrays(path, arrays, header=None):
+    """Write named arrays to a binary file, each aligned to 64 bytes.
+
+    Parameters
+    ----------
+    path : string
+        Name of the file, which is overwritten
+    arrays : dict
+        Arrays keyed by name.  The dtypes must be numeric or boolean.
+    header : dict
+        Additional data stored with the arrays, it must be serializable as
+        JSON
+
+    Returns
+    -------
+    Nothing, the file is written.
+
+    Notes
+    -----
+    The file holds the signature b'PYAMGARR', the length of the header as a
+    little endian uint64, the header as JSON, and then the raw data of each
+    array in C order, starting at an offset that is a multiple of 64 bytes.
+    The header records the dtype, shape, and offset of each array, so that
+    load_arrays can return views of a memory map of the file.
+
+    Examples
+    --------
+    >>> import numpy as np
+    >>> import tempfile, os
+    >>> from pyamg.util.arrayfile import save_arrays, load_arrays
+    >>> path = os.path.join(tempfile.mkdtemp(), 'arrays.bin')
+    >>> save_arrays(path, {'x': np.arange(4.0)}, header={'n': 4})
+    >>> header, arrays = load_arrays(path)
+    >>> header['n'], arrays['x']
+    (4, array([0., 1., 2., 3.]))
+
+    """
+    arrays = dict((name, np.ascontiguousarray(a))
+                  for name, a in arrays.items())
+    for name, a in arrays.items():
+        if a.dtype.kind not in 'biufc':
+            raise TypeError('array %s has unsupported dtype %s'
+                            % (name, a.dtype))
+
+    # the offsets depend on the length of the header, which depends on the
+    # offsets, so the arrays are placed relative to the end of the header
+    # and the header is padded to a multiple of ALIGNMENT
+    layout = {}
+    offset = 0
+    for name in sorted(arrays):
+        a = arrays[name]
+        layout[name] = {'dtype': a.dtype.str, 'shape': list(a.shape),
+                        'offset': offset}
+        offset = _aligned(offset + a.nbytes)
+
+    contents = {'version': VERSION, 'arrays': layout,
+                'header': header if header is not None else {}}
+    text = json.dumps(contents, sort_keys=True).encode('utf-8')
+    start = _aligned(len(MAGIC) + 8 + len(text))
+    text += b' ' * (start - len(MAGIC) - 8 - len(text))
+
+    with open(path, 'wb') as f:
+        f.write(MAGIC)
+        f.write(struct.pack('<Q', len(text)))
+        f.write(text)
+        for name in sorted(arrays):
+            a = arrays[name]
+            f.seek(start + layout[name]['offset'])
+            a.tofile(f)
+        f.truncate(start + offset)
+
+
+def load_arrays(path, mmap=True):
+    """Read the named arrays of a file written by save_arrays.
+
+    Parameters
+    ----------
+    path : string
+        Name of the file
+    mmap : bool
+        If True, the arrays are views of a copy-on-write memory map of the
+        file, so that no data is read until it is used, and the pages are
+        shared by all processes that map the file.  Otherwise the file is
+        read into memory once.
+
+    Returns
+    -------
+    header : dict
+        The header passed to save_arrays
+    arrays : dict
+        Arrays keyed by name
+
+    Notes
+    -----
+    With mmap=True, writes to the arrays change only the memory of the
+    calling process, not the file.
+
+    """
+    with open(path, 'rb') as f:
+        magic = f.read(len(MAGIC))
+        if magic != MAGIC:
+            raise ValueError('%s is not a file written by save_arrays'
+                             % path)
+        length, = struct.unpack('<Q', f.read(8))
+        contents = json.loads(f.read(length).decode('utf-8'))
+    if contents['version'] > VERSION:
+        raise ValueError('%s has an unsupported version (%d)'
+                         % (path, contents['version']))
+    start = len(MAGIC) + 8 + length
+
+    if mmap:
+        data = np.memmap(path, dtype=np.uint8, mode='c')
+    else:
+        data = np.fromfile(path, dtype=np.uint8)
+
+    arrays = {}
+    for name, entry in contents['arrays'].items():
+        dtype = np.dtype(str(entry['dtype']))
+        shape = tuple(entry['shape'])
+        arrays[str(name)] = np.ndarray(shape, dtype=dtype, buffer=data,
+                                       offset=start + entry['offset'])
+    return contents['header'], arrays
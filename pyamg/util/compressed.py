@@ -0,0 +1,270 @@
+"""Compressed storage of the operators of a multigrid hierarchy."""
+from __future__ import absolute_import
+
+import numpy as np
+from scipy import sparse
+from scipy.sparse.linalg import LinearOperator
+
+from pyamg import amg_core
+
+__all__ = ['delta_csr_matrix', 'aggregate_matrix']
+
+# largest offset between adjacent columns of a row of a delta_csr_matrix
+MAX_DELTA = np.iinfo(np.uint16).max
+
+
+class delta_csr_matrix(LinearOperator):
+    """CSR matrix with 16-bit delta encoded column indices.
+
+    Each row stores the column of its first entry in base, and the offset
+    of each column from the previous one in the row in offsets, as uint16.
+    This replaces the 4 (int32) or 8 (int64) bytes of each column index by
+    2 bytes.  The products with A and A^H, and Gauss-Seidel and Jacobi
+    relaxation, decode the columns on the fly, see csr_delta_matvec in
+    amg_core.
+
+    Parameters
+    ----------
+    A : csr_matrix, tuple
+        Matrix to compress, or the tuple (indptr, base, offsets, data) of an
+        encoded matrix, e.g., as stored by multilevel_solver.save
+    shape : tuple
+        Shape of the matrix, only used with the tuple of arrays
+
+    Attributes
+    ----------
+    indptr : array
+        CSR row pointer
+    base : array
+        Column of the first entry of each row, or 0 for an empty row
+    offsets : array
+        Offset of each column from the previous one in its row, 0 for the
+        first entry of each row
+    data : array
+        CSR data array
+    nnz : int
+        Number of stored values
+    nbytes : int
+        Size of indptr, base, offsets, and data
+
+    Raises
+    ------
+    ValueError
+        If two adjacent columns of a row of A are more than 65535 apart
+
+    Notes
+    -----
+    Only the products with vectors are provided, tocsr returns the matrix
+    in CSR format for other operations.
+
+    Examples
+    --------
+    >>> from pyamg.gallery import poisson
+    >>> from pyamg.util.compressed import delta_csr_matrix
+    >>> import numpy as np
+    >>> A = poisson((10, 10), format='csr')
+    >>> C = delta_csr_matrix(A)
+    >>> x = np.arange(100.0)
+    >>> np.allclose(C * x, A * x)
+    True
+    >>> C.offsets.dtype
+    dtype('uint16')
+
+    """
+
+    format = 'dcsr'
+
+    def __init__(self, A, shape=None):
+        """Encode the columns of A."""
+        if isinstance(A, tuple):
+            self.indptr, self.base, self.offsets, self.data = A
+            super(delta_csr_matrix, self).__init__(self.data.dtype, shape)
+            self.nnz = self.data.size
+            return
+
+        if not sparse.isspmatrix_csr(A):
+            A = sparse.csr_matrix(A)
+        if not A.has_sorted_indices:
+            A = A.sorted_indices()
+        super(delta_csr_matrix, self).__init__(A.dtype, A.shape)
+
+        starts = A.indptr[:-1][np.diff(A.indptr) > 0]
+        offsets = np.zeros(A.indices.shape, dtype=A.indices.dtype)
+        offsets[1:] = np.diff(A.indices)
+        offsets[starts] = 0
+        if offsets.size and offsets.max() > MAX_DELTA:
+            raise ValueError('the columns of a row of A are more than %d '
+                             'apart' % MAX_DELTA)
+
+        self.indptr = A.indptr
+        self.base = np.zeros(A.shape[0], dtype=A.indices.dtype)
+        self.base[np.diff(A.indptr) > 0] = A.indices[starts]
+        self.offsets = offsets.astype(np.uint16)
+        self.data = A.data
+        self.nnz = A.nnz
+
+    @property
+    def nbytes(self):
+        return self.indptr.nbytes + self.base.nbytes +\
+            self.offsets.nbytes + self.data.nbytes
+
+    def _values(self, x):
+        # x and the data of A in their common dtype, for amg_core
+        dtype = np.result_type(self.dtype, x.dtype)
+        data = self.data if dtype == self.dtype else self.data.astype(dtype)
+        return np.asarray(np.ravel(x), dtype=dtype), data
+
+    def _matvec(self, x):
+        x, data = self._values(x)
+        y = np.empty(self.shape[0], dtype=x.dtype)
+        amg_core.csr_delta_matvec(self.indptr, self.base, self.offsets,
+                                  data, x, y)
+        return y
+
+    def _rmatvec(self, x):
+        x, data = self._values(x)
+        y = np.empty(self.shape[1], dtype=x.dtype)
+        amg_core.csr_delta_rmatvec(self.indptr, self.base, self.offsets,
+                                   data, x, y)
+        return y
+
+    def tocsr(self):
+        """Return the matrix in CSR format, sharing indptr and data."""
+        lengths = np.diff(self.indptr)
+        rows = lengths > 0
+        # column jj of row i is base[i] + sums[jj] - sums[indptr[i]]
+        sums = np.cumsum(self.offsets, dtype=np.int64)
+        indices = np.repeat(self.base[rows] - sums[self.indptr[:-1][rows]],
+                            lengths[rows]) + sums
+        return sparse.csr_matrix((self.data,
+                                  indices.astype(self.indptr.dtype),
+                                  self.indptr), shape=self.shape)
+
+    def diagonal(self):
+        """Return the main diagonal."""
+        return self.tocsr().diagonal()
+
+
+class aggregate_matrix(LinearOperator):
+    """Prolongator stored by its aggregate map.
+
+    A prolongator with at most one block in each block row, e.g., a
+    tentative prolongator, is stored by the block column, i.e., the
+    aggregate, of each block row, and the block itself.  This drops the
+    row pointer, and one block column index is stored per block row.  The
+    products with P and P^H are computed by aggregate_prolongate_add and
+    aggregate_restrict of amg_core.
+
+    Parameters
+    ----------
+    P : csr_matrix, bsr_matrix, tuple
+        Prolongator with at most one (block) entry in each (block) row, or
+        the tuple (aggregates, data) of a stored prolongator
+    shape : tuple
+        Shape of the prolongator, only used with the tuple of arrays
+
+    Attributes
+    ----------
+    aggregates : array
+        Block column of each block row, or -1 for a zero block row
+    data : array
+        Block of each block row, of shape (n_brow, R, C) for blocksize
+        (R, C), zero for a zero block row
+    blocksize : tuple
+        (R, C), (1, 1) for a CSR matrix
+    nnz : int
+        Number of values in the nonzero block rows, i.e., without the zero
+        blocks stored for the zero block rows
+    nbytes : int
+        Size of aggregates and data
+
+    Raises
+    ------
+    ValueError
+        If a (block) row of P has more than one (block) entry
+
+    Examples
+    --------
+    >>> from pyamg.util.compressed import aggregate_matrix
+    >>> from scipy.sparse import csr_matrix
+    >>> import numpy as np
+    >>> T = csr_matrix(np.array([[1.0, 0], [1.0, 0], [0, 2.0]]))
+    >>> P = aggregate_matrix(T)
+    >>> P.aggregates
+    array([0, 0, 1], dtype=int32)
+    >>> P.H * np.ones(3)
+    array([2., 2.])
+
+    """
+
+    format = 'agg'
+
+    def __init__(self, P, shape=None):
+        """Store the aggregate map of P."""
+        if isinstance(P, tuple):
+            self.aggregates, self.data = P
+            super(aggregate_matrix, self).__init__(self.data.dtype, shape)
+            self.blocksize = self.data.shape[1:]
+            self.nnz = self._count_nnz()
+            return
+
+        if sparse.isspmatrix_bsr(P):
+            blocksize = P.blocksize
+        else:
+            P = sparse.csr_matrix(P)
+            blocksize = (1, 1)
+        super(aggregate_matrix, self).__init__(P.dtype, P.shape)
+
+        lengths = np.diff(P.indptr)
+        if lengths.size and lengths.max() > 1:
+            raise ValueError('a block row of P has more than one block')
+        rows = lengths > 0
+        starts = P.indptr[:-1][rows]
+
+        self.blocksize = blocksize
+        self.aggregates = np.full(lengths.size, -1, dtype=P.indices.dtype)
+        self.aggregates[rows] = P.indices[starts]
+        self.data = np.zeros((lengths.size,) + blocksize, dtype=P.dtype)
+        self.data[rows] = P.data.reshape((-1,) + blocksize)[starts]
+        self.nnz = self._count_nnz()
+
+    def _count_nnz(self):
+        R, C = self.blocksize
+        return int(np.count_nonzero(self.aggregates >= 0)) * R * C
+
+    @property
+    def nbytes(self):
+        return self.aggregates.nbytes + self.data.nbytes
+
+    def _values(self, x):
+        # x and the data of P in their common dtype, for amg_core
+        dtype = np.result_type(self.dtype, x.dtype)
+        data = self.data if dtype == self.dtype else self.data.astype(dtype)
+        return np.asarray(np.ravel(x), dtype=dtype), np.ravel(data)
+
+    def _matvec(self, x):
+        x, data = self._values(x)
+        y = np.zeros(self.shape[0], dtype=x.dtype)
+        amg_core.aggregate_prolongate_add(self.aggregates, data, x, y,
+                                          self.blocksize[0],
+                                          self.blocksize[1])
+        return y
+
+    def _rmatvec(self, x):
+        x, data = self._values(x)
+        y = np.empty(self.shape[1], dtype=x.dtype)
+        amg_core.aggregate_restrict(self.aggregates, data, x, y,
+                                    self.blocksize[0], self.blocksize[1])
+        return y
+
+    def tobsr(self):
+        """Return the prolongator in BSR format."""
+        rows = self.aggregates >= 0
+        indptr = np.zeros(rows.size + 1, dtype=self.aggregates.dtype)
+        np.cumsum(rows, out=indptr[1:])
+        return sparse.bsr_matrix((self.data[rows], self.aggregates[rows],
+                                  indptr), shape=self.shape)
+
+    def tocsr(self):
+        """Return the prolongator in CSR format."""
+        return self.tobsr().tocsr()
@@ -0,0 +1,222 @@
+"""Timing and memory profile of the setup and solve phases."""
+from __future__ import print_function
+
+import threading
+import types
+from collections import OrderedDict
+from contextlib import contextmanager
+from timeit import default_timer
+
+try:
+    import tracemalloc
+except ImportError:  # Python 2
+    tracemalloc = None
+
+__all__ = ['Profile', 'null_profile']
+
+
+class Profile(object):
+    """Wall time and memory allocated by each phase of a multilevel_solver.
+
+    Parameters
+    ----------
+    trace_memory : bool
+        If True, the memory allocated by each phase is traced with
+        tracemalloc, which slows down the Python parts of the phases.
+
+    Attributes
+    ----------
+    setup : OrderedDict
+        setup[(level, phase)] = [calls, seconds, bytes] for the setup phases
+        on each level, e.g., 'strength', 'aggregate', 'tentative', 'smooth',
+        'RAP', and 'smoother'
+    solve : OrderedDict
+        solve[(level, component)] = [calls, seconds, bytes] for the
+        components of the cycle on each level, i.e., 'presmooth',
+        'restrict', 'coarse_solve', 'prolongate', and 'postsmooth'
+    kernels : OrderedDict
+        kernels[name] = [calls, seconds] for the amg_core kernels called
+        during the setup and the solve
+
+    Notes
+    -----
+    The phases are timed with lap, which records the time since the last
+    call to start or lap, so that the consecutive phases of a routine are
+    timed without nesting.  The bytes are the net memory allocated by
+    Python and numpy during a phase, as traced by tracemalloc, and are not
+    recorded with Python 2 or if trace_memory is False.
+
+    The time spent in amg_core is measured in timing_kernels by timers in
+    the bindings of amg_core, around the call of each kernel, which
+    separates the C++ time from the Python overhead of a phase and of the
+    bindings.  The timers are per thread, so only the kernels called by
+    the thread that records the profile are timed.
+
+    Examples
+    --------
+    >>> from pyamg.gallery import poisson
+    >>> from pyamg import smoothed_aggregation_solver
+    >>> A = poisson((100, 100), format='csr')
+    >>> ml = smoothed_aggregation_solver(A, profile=True)
+    >>> x = ml.solve(A * ml.levels[0].B[:, 0], tol=1e-8)
+    >>> print(ml.profile_summary())                     # doctest: +SKIP
+
+    """
+
+    def __init__(self, trace_memory=True):
+        """Initialize an empty profile."""
+        self.trace_memory = trace_memory and tracemalloc is not None
+        self.setup = OrderedDict()
+        self.solve = OrderedDict()
+        self.kernels = OrderedDict()
+        self._tic = default_timer()
+        self._mem = 0
+        self._timing_depth = 0
+
+    @property
+    def timing(self):
+        """Whether timing_kernels is active."""
+        return self._timing_depth > 0
+
+    def _memory(self):
+        if not self.trace_memory or not tracemalloc.is_tracing():
+            return 0
+        return tracemalloc.get_traced_memory()[0]
+
+    def start(self):
+        """Start timing the next phase."""
+        self._mem = self._memory()
+        self._tic = default_timer()
+
+    def lap(self, table, level, phase):
+        """Record the phase since the last start or lap in the given table.
+
+        Parameters
+        ----------
+        table : {'setup', 'solve'}
+            Table of the profile to record the phase in
+        level : int
+            Level of the hierarchy
+        phase : string
+            Name of the phase
+
+        """
+        toc = default_timer()
+        mem = self._memory()
+        entry = getattr(self, table).setdefault((level, phase), [0, 0.0, 0])
+        entry[0] += 1
+        entry[1] += toc - self._tic
+        entry[2] += mem - self._mem
+        self._mem = mem
+        self._tic = default_timer()
+
+    @contextmanager
+    def timing_kernels(self):
+        """Time the calls to amg_core, and trace memory, within the context."""
+        self._timing_depth += 1
+        if self._timing_depth > 1:
+            try:
+                yield
+            finally:
+                self._timing_depth -= 1
+            return
+
+        # the calls so far belong to the profile that is already timing
+        # in this thread, if any
+        stack = _timing_profiles()
+        if stack:
+            stack[-1]._collect_kernels(True)
+        else:
+            self._collect_kernels(True, discard=True)
+        stack.append(self)
+
+        tracing = self.trace_memory and not tracemalloc.is_tracing()
+        if tracing:
+            tracemalloc.start()
+        self.start()
+
+        try:
+            yield
+        finally:
+            if tracing:
+                tracemalloc.stop()
+            stack.pop()
+            self._collect_kernels(len(stack) > 0)
+            self._timing_depth -= 1
+
+    def _collect_kernels(self, enable, discard=False):
+        # add the kernel timers of this thread to the profile, and enable
+        # or disable them for the subsequent calls
+        for module in _kernel_modules():
+            timers = module._kernel_timers(enable)
+            if discard:
+                continue
+            for name, (calls, seconds) in timers.items():
+                entry = self.kernels.setdefault(name, [0, 0.0])
+                entry[0] += calls
+                entry[1] += seconds
+
+    def __repr__(self):
+        """Print the setup, solve, and kernel tables."""
+        output = ''
+        for title, table in [('Setup', self.setup), ('Solve', self.solve)]:
+            if not table:
+                continue
+            total = sum(entry[1] for entry in table.values())
+            output += '%s: %.4f s\n' % (title, total)
+            output += '  level  phase            calls    seconds'\
+                '       bytes\n'
+            for (level, phase), entry in sorted(table.items(),
+                                                key=_level_order):
+                output += '   %2s    %-14s %7d %10.4f %11d\n' %\
+                    (level, phase, entry[0], entry[1], entry[2])
+
+        if self.kernels:
+            total = sum(entry[1] for entry in self.kernels.values())
+            output += 'amg_core: %.4f s\n' % total
+            output += '  kernel                            calls    seconds\n'
+            for name, entry in sorted(self.kernels.items(),
+                                      key=lambda item: -item[1][1]):
+                output += '  %-32s %6d %10.4f\n' % (name, entry[0], entry[1])
+
+        return output
+
+
+_timing = threading.local()
+
+
+def _timing_profiles():
+    # the profiles timing kernels in this thread, innermost last
+    if not hasattr(_timing, 'profiles'):
+        _timing.profiles = []
+    return _timing.profiles
+
+
+def _kernel_modules():
+    # the modules of amg_core, each with the timers of its kernels
+    from pyamg import amg_core
+    return [module for module in vars(amg_core).values()
+            if isinstance(module, types.ModuleType) and
+            hasattr(module, '_kernel_timers')]
+
+
+def _level_order(item):
+    # sort by level, keeping the insertion order of the phases in a level
+    return item[0][0]
+
+
+class NullProfile(Profile):
+    """Profile that records nothing, used when profiling is disabled."""
+
+    def start(self):
+        pass
+
+    def lap(self, table, level, phase):
+        pass
+
+    @contextmanager
+    def timing_kernels(self):
+        yield
+
+
+null_profile = NullProfile()
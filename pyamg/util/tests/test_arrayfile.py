@@ -0,0 +1,53 @@
+import os
+import shutil
+import tempfile
+
+import numpy as np
+
+from pyamg.util.arrayfile import save_arrays, load_arrays, ALIGNMENT
+
+from numpy.testing import TestCase, assert_equal, assert_raises
+
+
+class TestArrayFile(TestCase):
+    def setUp(self):
+        self.directory = tempfile.mkdtemp()
+        self.path = os.path.join(self.directory, 'arrays.bin')
+
+    def tearDown(self):
+        shutil.rmtree(self.directory)
+
+    def test_save_load(self):
+        np.random.seed(1406938514)
+        arrays = {'float': np.random.rand(7),
+                  'complex': np.random.rand(3, 5) + 1.0j,
+                  'int': np.arange(11, dtype=np.intc),
+                  'int64': np.arange(3, dtype=np.int64)[::-1],
+                  'uint16': np.array([1, 2, 65535], dtype=np.uint16),
+                  'bool': np.array([True, False]),
+                  'empty': np.zeros((0, 2, 2), dtype=np.float32)}
+        header = {'name': 'test', 'levels': [1, 2.5, None]}
+        save_arrays(self.path, arrays, header)
+
+        for mmap in [True, False]:
+            header2, arrays2 = load_arrays(self.path, mmap=mmap)
+            assert_equal(header2, header)
+            assert_equal(sorted(arrays2), sorted(arrays))
+            for name, a in arrays.items():
+                assert_equal(arrays2[name].dtype, a.dtype)
+                assert_equal(arrays2[name], a)
+                # each array is aligned in the file, and so in the map
+                if mmap:
+                    assert_equal(arrays2[name].ctypes.data % ALIGNMENT, 0)
+                assert_equal(isinstance(arrays2[name].base, np.memmap), mmap)
+
+            # the memory map is copy-on-write
+            arrays2['float'][:] = 0
+            del arrays2
+            assert_equal(load_arrays(self.path)[1]['float'], arrays['float'])
+
+        assert_raises(TypeError, save_arrays, self.path,
+                      {'object': np.array([None])})
+        with open(self.path, 'wb') as f:
+            f.write(b'not an array file')
+        assert_raises(ValueError, load_arrays, self.path)
@@ -0,0 +1,141 @@
+import numpy as np
+from scipy import sparse
+
+from pyamg.gallery import poisson, linear_elasticity
+from pyamg.util.compressed import delta_csr_matrix, aggregate_matrix
+from pyamg.relaxation.relaxation import gauss_seidel, jacobi
+from pyamg.relaxation.smoothing import setup_block_jacobi,\
+    setup_block_gauss_seidel
+from pyamg.multilevel import multilevel_solver
+
+from numpy.testing import TestCase, assert_equal, assert_array_almost_equal,\
+    assert_raises
+
+
+class TestCompressed(TestCase):
+    def setUp(self):
+        np.random.seed(1768212781)
+
+        self.cases = []
+        self.cases.append(poisson((10, 10), format='csr'))
+        A = sparse.random(50, 70, density=0.1, format='csr')
+        A = A + 1.0j * A
+        self.cases.append(A.tocsr())
+        # empty rows, and rows with a single entry
+        A = sparse.random(40, 40, density=0.05, format='lil')
+        A[3, :] = 0
+        A[7, 39] = 2.0
+        self.cases.append(A.tocsr())
+        A = poisson((12, 12), format='csr')
+        A.indptr = A.indptr.astype(np.int64)
+        A.indices = A.indices.astype(np.int64)
+        self.cases.append(A)
+
+    def test_delta_csr_matrix(self):
+        for A in self.cases:
+            C = delta_csr_matrix(A)
+            assert_equal(C.offsets.dtype, np.uint16)
+            assert_equal(C.nnz, A.nnz)
+
+            B = C.tocsr()
+            assert_equal(B.indices.dtype, A.indices.dtype)
+            assert_equal(abs(B - A).nnz, 0)
+
+            x = np.random.rand(A.shape[1])
+            assert_array_almost_equal(C * x, A * x)
+            y = np.random.rand(A.shape[0])
+            assert_array_almost_equal(C.H * y, A.H * y)
+            X = np.random.rand(A.shape[1], 3)
+            assert_array_almost_equal(C * X, A * X)
+
+        A = self.cases[0]
+        C = delta_csr_matrix(A)
+        assert(C.nbytes < A.data.nbytes + A.indices.nbytes + A.indptr.nbytes)
+
+        # unsorted columns are sorted
+        A = sparse.csr_matrix((np.array([1.0, 2.0, 3.0]), np.array([2, 0, 1]),
+                               np.array([0, 3])), shape=(1, 3))
+        assert_equal(delta_csr_matrix(A).tocsr().toarray(), [[2, 3, 1]])
+
+        # columns more than 2**16 - 1 apart
+        A = sparse.csr_matrix((np.ones(2), np.array([0, 2**16]),
+                               np.array([0, 2])), shape=(1, 2**16 + 1))
+        assert_raises(ValueError, delta_csr_matrix, A)
+
+    def test_aggregate_matrix(self):
+        aggregates = np.array([0, 0, 1, 1, 1, 2, 2, 0, 2])
+        rows = np.arange(10)
+        AggOp = sparse.csr_matrix((np.ones(9), aggregates, rows),
+                                  shape=(9, 3))
+        cases = []
+        cases.append(sparse.csr_matrix((np.random.rand(9), aggregates, rows),
+                                       shape=(9, 3)))
+        cases.append(sparse.csr_matrix((1.0j * np.random.rand(9), aggregates,
+                                        rows), shape=(9, 3)))
+        # a zero row
+        T = AggOp.tolil()
+        T[4, :] = 0
+        cases.append(T.tocsr())
+        # blocks, as the tentative prolongator of a system
+        cases.append(sparse.bsr_matrix((np.random.rand(9, 2, 3), aggregates,
+                                        rows), shape=(18, 9)))
+
+        for T in cases:
+            P = aggregate_matrix(T)
+            assert_equal(abs(P.tocsr() - T).nnz, 0)
+            assert_equal(abs(P.tobsr().tocsr() - T).nnz, 0)
+            assert_equal(P.nnz, T.nnz)
+            Q = aggregate_matrix((P.aggregates, P.data), P.shape)
+            assert_equal(Q.nnz, T.nnz)
+
+            xc = np.random.rand(T.shape[1])
+            assert_array_almost_equal(P * xc, T * xc)
+            x = np.random.rand(T.shape[0])
+            assert_array_almost_equal(P.H * x, T.H * x)
+
+        T = AggOp.tolil()
+        T[4, 0] = 1.0
+        assert_raises(ValueError, aggregate_matrix, T.tocsr())
+
+    def test_relaxation(self):
+        for A in [poisson((10, 10), format='csr'),
+                  linear_elasticity((5, 5), format='bsr')[0].tocsr()]:
+            C = delta_csr_matrix(A)
+            b = np.random.rand(A.shape[0])
+            x0 = np.random.rand(A.shape[0])
+
+            for sweep in ['forward', 'backward', 'symmetric', 'multicolor']:
+                x = x0.copy()
+                xc = x0.copy()
+                gauss_seidel(A, x, b, iterations=2, sweep=sweep)
+                gauss_seidel(C, xc, b, iterations=2, sweep=sweep)
+                assert_array_almost_equal(xc, x)
+            # the coloring is cached on the compressed matrix
+            assert_equal(C.multicolor_parameters, A.multicolor_parameters)
+
+            x = x0.copy()
+            xc = x0.copy()
+            jacobi(A, x, b, iterations=2, omega=0.6)
+            jacobi(C, xc, b, iterations=2, omega=0.6)
+            assert_array_almost_equal(xc, x)
+
+    def test_block_smoothers(self):
+        # the block smoothers of a compressed level relax a BSR copy of it,
+        # converted once at setup
+        A = linear_elasticity((5, 5), format='bsr')[0].tocsr()
+        b = np.random.rand(A.shape[0])
+        x0 = np.random.rand(A.shape[0])
+        for setup, kwargs in [(setup_block_jacobi, {'withrho': False}),
+                              (setup_block_gauss_seidel, {})]:
+            level = multilevel_solver.level()
+            level.A = A
+            compressed = multilevel_solver.level()
+            compressed.A = delta_csr_matrix(A)
+            smoother = setup(level, blocksize=2, **kwargs)
+            smoother_compressed = setup(compressed, blocksize=2, **kwargs)
+
+            x = x0.copy()
+            xc = x0.copy()
+            smoother(level.A, x, b)
+            smoother_compressed(compressed.A, xc, b)
+            assert_array_almost_equal(xc, x)
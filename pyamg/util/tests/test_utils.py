@@ -12,7 +12,7 @@ from pyamg.util.utils import diag_sparse, profile_solver, to_type,\
     compute_BtBinv, eliminate_diag_dom_nodes
 
 from numpy.testing import TestCase, assert_equal, assert_almost_equal,\
-    assert_array_almost_equal, assert_array_equal
+    assert_array_almost_equal, assert_array_equal, assert_raises
 
 
 class TestUtils(TestCase):
@@ -1070,6 +1070,123 @@ class TestUtils(TestCase):
                           [0., 0., 0., 0.]])
         assert_array_almost_equal(Acopy.toarray(), exact)
 
+    def test_galerkin_product(self):
+        from pyamg.util.utils import galerkin_product
+        from pyamg.gallery import poisson, linear_elasticity, sprand
+        from pyamg.aggregation.aggregate import standard_aggregation
+        from pyamg.aggregation.tentative import fit_candidates
+        from pyamg.aggregation.smooth import jacobi_prolongation_smoother
+        from pyamg.strength import symmetric_strength_of_connection
+        np.random.seed(3479852017)
+
+        cases = []
+        # random rectangular CSR
+        A = sprand(40, 40, 0.1, format='csr')
+        P = sprand(40, 12, 0.2, format='csr')
+        R = sprand(12, 40, 0.2, format='csr')
+        cases.append((R, A, P))
+        cases.append((P.T, A, P))        # R in CSC
+        cases.append((R, A.astype(complex) * 1j, P))
+
+        # entries that cancel to exactly zero, for a graph Laplacian
+        L = poisson((6,), format='csr')
+        L.data[[0, -1]] = 1.0
+        one = csr_matrix(np.ones((6, 1)))
+        cases.append((one.T, L, one))
+        agg = np.kron(np.eye(3), np.ones((2, 1)))
+        cases.append((csr_matrix(agg.T), L, csr_matrix(agg + 0.5)))
+        cases.append((one.T.tobsr(blocksize=(1, 2)),
+                      L.tobsr(blocksize=(2, 2)), one.tobsr(blocksize=(2, 1))))
+
+        # tentative and smoothed SA prolongators, CSR and BSR
+        for A, B in [(poisson((12, 12), format='csr'), np.ones((144, 1))),
+                     linear_elasticity((6, 6), format='bsr')]:
+            C = symmetric_strength_of_connection(A)
+            AggOp = standard_aggregation(C)[0]
+            T = fit_candidates(AggOp, B)[0]
+            P = jacobi_prolongation_smoother(A, T, C, B)
+            cases.append((T.T, A, T))
+            cases.append((P.T, A, P))
+            cases.append((P.H, A.tocsr(), P.tocsr()))
+
+        for R, A, P in cases:
+            exact = (R * A * P).toarray()
+            RAP = galerkin_product(R, A, P)
+            assert_equal(RAP.shape, exact.shape)
+            if isspmatrix_bsr(A) or isspmatrix_bsr(P):
+                assert isspmatrix_bsr(RAP)
+            else:
+                assert RAP.format == 'csr'
+            assert_array_almost_equal(RAP.toarray(), exact)
+
+            # no explicit zeros, as in the scipy product
+            scipy_RAP = (R * A * P).tocsr()
+            scipy_RAP.eliminate_zeros()
+            if isspmatrix_bsr(RAP):
+                scipy_RAP = scipy_RAP.tobsr(blocksize=RAP.blocksize)
+            assert_equal(RAP.nnz, scipy_RAP.nnz)
+
+            # sorted indices without duplicates
+            indices = RAP.indices.copy()
+            RAP.has_sorted_indices = False
+            RAP.sort_indices()
+            assert_equal(RAP.indices, indices)
+
+            if RAP.nnz == 0:
+                continue
+
+            # in the pattern of a previous product, the values are those of
+            # the product, and the index arrays are shared
+            R2, A2 = 2.0 * R, 4.0 * A
+            RAP2 = galerkin_product(R2, A2, P)
+            result = galerkin_product(R2, A2, P, pattern=RAP)
+            assert result.indices is RAP.indices
+            assert_equal(result.toarray(), RAP2.toarray())
+
+            # a larger pattern drops the zeros, and a smaller one is not
+            # used
+            larger = csr_matrix(np.ones(RAP.shape))
+            smaller = RAP.copy()
+            smaller.data[0] = 0.0
+            smaller.eliminate_zeros()
+            if isspmatrix_bsr(RAP):
+                larger = larger.tobsr(blocksize=RAP.blocksize)
+            for pattern in [larger, smaller]:
+                nnz = pattern.nnz
+                result = galerkin_product(R2, A2, P, pattern=pattern)
+                assert_equal(result.nnz, RAP2.nnz)
+                assert_equal(result.toarray(), RAP2.toarray())
+                assert_equal(pattern.nnz, nnz)
+
+        # the result does not depend on the number of threads
+        R, A, P = cases[-2]
+        saved = pyamg.amg_core.set_num_threads(0)
+        try:
+            pyamg.amg_core.set_num_threads(1)
+            RAP1 = galerkin_product(R, A, P)
+            pyamg.amg_core.set_num_threads(4)
+            RAP4 = galerkin_product(R, A, P)
+        finally:
+            pyamg.amg_core.set_num_threads(saved)
+        assert_equal(RAP1.indices, RAP4.indices)
+        assert_equal(RAP1.data, RAP4.data)
+
+        # int64 indices are passed to amg_core as they are
+        R, A, P = cases[0]
+        for M in [R, A, P]:
+            M.indptr = M.indptr.astype(np.int64)
+            M.indices = M.indices.astype(np.int64)
+        RAP = galerkin_product(R, A, P)
+        assert_equal(RAP.indptr.dtype, np.int64)
+        assert_equal(RAP.indices.dtype, np.int64)
+        assert_array_almost_equal(RAP.toarray(), (R * A * P).toarray())
+
+        # an output must be a C-contiguous array of the index dtype
+        Cp = np.empty(2 * (R.shape[0] + 1), dtype=np.int64)[::2]
+        assert_raises(TypeError, pyamg.amg_core.galerkin_product_symbolic,
+                      R.indptr, R.indices, A.indptr, A.indices,
+                      P.indptr, P.indices, Cp, R.shape[0], P.shape[1])
+
 
 class TestComplexUtils(TestCase):
     def test_diag_sparse(self):
@@ -20,7 +20,7 @@ __all__ = ['blocksize', 'diag_sparse', 'profile_solver', 'to_type',
            'get_Cpt_params', 'compute_BtBinv', 'eliminate_diag_dom_nodes',
            'levelize_strength_or_aggregation',
            'levelize_smooth_or_improve_candidates', 'filter_matrix_columns',
-           'filter_matrix_rows', 'truncate_rows']
+           'filter_matrix_rows', 'truncate_rows', 'galerkin_product']
 
 try:
     from scipy.sparse._sparsetools import csr_scale_rows, bsr_scale_rows
@@ -2192,6 +2192,186 @@ def truncate_rows(A, nz_per_row):
     return A
 
 
+def galerkin_product(R, A, P, pattern=None):
+    """Compute the coarse grid operator R*A*P without forming A*P.
+
+    Parameters
+    ----------
+    R : sparse matrix
+        Restriction operator, e.g. P.H
+    A : csr_matrix, bsr_matrix
+        Fine grid operator
+    P : sparse matrix
+        Prolongation operator
+    pattern : csr_matrix, bsr_matrix
+        Optional previous product, e.g. the coarse operator of the same
+        level of a hierarchy for values of A with the same sparsity, whose
+        sparsity pattern is tried for RAP before it is computed
+
+    Returns
+    -------
+    RAP : csr_matrix, bsr_matrix
+        R*A*P with sorted indices and without explicit zeros.  RAP is a
+        bsr_matrix if A or P is a bsr_matrix, and a csr_matrix otherwise.
+
+    Notes
+    -----
+    The rows of RAP are computed in parallel by amg_core, each from the
+    rows of A and P that it depends on, so that the peak memory of the
+    product is RAP itself, instead of the intermediate A*P (or R*A) of
+    the scipy product.  If A or P is a bsr_matrix, the blocks of R, A,
+    and P are multiplied as dense blocks, with R in blocks of
+    P.blocksize[1] x A.blocksize[0] unless R is a bsr_matrix with
+    compatible blocks.
+
+    Entries (or blocks) that cancel to exactly zero are dropped, as in the
+    scipy product, so that they do not count towards the complexity of the
+    hierarchy or as connections in the strength of connection of the next
+    level.
+
+    If pattern is given, with the format, shape and blocksize of RAP, the
+    values of RAP are first computed in the pattern by
+    amg_core.galerkin_product_values_csr (or _bsr), which skips the
+    symbolic phase and the sort of the columns of each row.  RAP then
+    shares the index arrays of pattern, unless it has entries that are
+    zero.  If a product of R, A, and P falls outside of the pattern, RAP
+    is computed as without pattern, so the result is the same either way.
+
+    See Also
+    --------
+    amg_core.galerkin_product_csr, amg_core.galerkin_product_bsr
+
+    Examples
+    --------
+    >>> from pyamg.gallery import poisson
+    >>> from pyamg.util.utils import galerkin_product
+    >>> from scipy.sparse import csr_matrix
+    >>> import numpy as np
+    >>> A = poisson((4,), format='csr')
+    >>> P = csr_matrix(np.kron(np.eye(2), np.ones((2, 1))))
+    >>> galerkin_product(P.T, A, P).toarray()
+    array([[ 2., -1.],
+           [-1.,  2.]])
+
+    """
+    if R.shape[1] != A.shape[0] or A.shape[1] != P.shape[0]:
+        raise ValueError('incompatible dimensions')
+
+    dtype = upcast(R.dtype, A.dtype, P.dtype)
+    shape = (R.shape[0], P.shape[1])
+
+    if not (isspmatrix_bsr(A) or isspmatrix_bsr(P)):
+        R = R.tocsr().astype(dtype, copy=False)
+        A = A.tocsr().astype(dtype, copy=False)
+        P = P.tocsr().astype(dtype, copy=False)
+        index_type = np.result_type(R.indices, A.indices, P.indices)
+
+        RAP = None
+        if isspmatrix_csr(pattern) and pattern.shape == shape and \
+                pattern.indices.dtype == index_type:
+            Cx = np.empty(pattern.nnz, dtype=dtype)
+            misses = pyamg.amg_core.galerkin_product_values_csr(
+                R.indptr, R.indices, R.data, A.indptr, A.indices, A.data,
+                P.indptr, P.indices, P.data, pattern.indptr, pattern.indices,
+                Cx, shape[0], shape[1])
+            if misses == 0:
+                RAP = _in_pattern(csr_matrix, Cx, pattern, Cx != 0)
+
+        if RAP is None:
+            Cp = np.empty(shape[0] + 1, dtype=index_type)
+            pyamg.amg_core.galerkin_product_symbolic(R.indptr, R.indices,
+                                                     A.indptr, A.indices,
+                                                     P.indptr, P.indices,
+                                                     Cp, shape[0], shape[1])
+            Cj = np.empty(Cp[-1], dtype=index_type)
+            Cx = np.empty(Cp[-1], dtype=dtype)
+            pyamg.amg_core.galerkin_product_csr(R.indptr, R.indices, R.data,
+                                                A.indptr, A.indices, A.data,
+                                                P.indptr, P.indices, P.data,
+                                                Cp, Cj, Cx, shape[0],
+                                                shape[1])
+            RAP = csr_matrix((Cx, Cj, Cp), shape=shape)
+            RAP.has_sorted_indices = True
+            RAP.eliminate_zeros()
+    else:
+        A_brow, A_bcol = A.blocksize if isspmatrix_bsr(A) else (1, 1)
+        if isspmatrix_bsr(P) and P.blocksize[0] == A_bcol:
+            P_bcol = P.blocksize[1]
+        else:
+            P_bcol = 1
+        if isspmatrix_bsr(R) and R.blocksize[1] == A_brow:
+            R_brow = R.blocksize[0]
+        else:
+            R_brow = P_bcol
+
+        R = R.tobsr(blocksize=(R_brow, A_brow)).astype(dtype, copy=False)
+        A = A.tobsr(blocksize=(A_brow, A_bcol)).astype(dtype, copy=False)
+        P = P.tobsr(blocksize=(A_bcol, P_bcol)).astype(dtype, copy=False)
+
+        n_brow = int(shape[0] / R_brow)
+        n_bcol = int(shape[1] / P_bcol)
+        index_type = np.result_type(R.indices, A.indices, P.indices)
+
+        RAP = None
+        if isspmatrix_bsr(pattern) and pattern.shape == shape and \
+                pattern.blocksize == (R_brow, P_bcol) and \
+                pattern.indices.dtype == index_type:
+            Cx = np.empty(pattern.nnz, dtype=dtype)
+            misses = pyamg.amg_core.galerkin_product_values_bsr(
+                R.indptr, R.indices, np.ravel(R.data),
+                A.indptr, A.indices, np.ravel(A.data),
+                P.indptr, P.indices, np.ravel(P.data),
+                pattern.indptr, pattern.indices, Cx, n_brow, n_bcol,
+                R_brow, A_brow, A_bcol, P_bcol)
+            if misses == 0:
+                Cx = Cx.reshape(-1, R_brow, P_bcol)
+                RAP = _in_pattern(bsr_matrix, Cx, pattern,
+                                  Cx.any(axis=(1, 2)))
+
+        if RAP is None:
+            Cp = np.empty(n_brow + 1, dtype=index_type)
+            pyamg.amg_core.galerkin_product_symbolic(R.indptr, R.indices,
+                                                     A.indptr, A.indices,
+                                                     P.indptr, P.indices,
+                                                     Cp, n_brow, n_bcol)
+            Cj = np.empty(Cp[-1], dtype=index_type)
+            Cx = np.empty(Cp[-1] * R_brow * P_bcol, dtype=dtype)
+            pyamg.amg_core.galerkin_product_bsr(R.indptr, R.indices,
+                                                np.ravel(R.data),
+                                                A.indptr, A.indices,
+                                                np.ravel(A.data),
+                                                P.indptr, P.indices,
+                                                np.ravel(P.data),
+                                                Cp, Cj, Cx, n_brow, n_bcol,
+                                                R_brow, A_brow, A_bcol,
+                                                P_bcol)
+            RAP = bsr_matrix((Cx.reshape(-1, R_brow, P_bcol), Cj, Cp),
+                             shape=shape)
+            RAP.has_sorted_indices = True
+            RAP.eliminate_zeros()
+
+    return RAP
+
+
+def _in_pattern(matrix, data, pattern, nonzero):
+    """Build a sparse matrix with the values data in the pattern of pattern.
+
+    The matrix shares the index arrays of pattern if every entry (or
+    block) is nonzero, as marked by nonzero.  Otherwise the zeros are
+    dropped from a copy of the pattern, so that pattern is unchanged.
+    """
+    if nonzero.all():
+        M = matrix((data, pattern.indices, pattern.indptr),
+                   shape=pattern.shape)
+    else:
+        nnz = np.concatenate(([0], np.cumsum(nonzero)))
+        indptr = nnz[pattern.indptr].astype(pattern.indptr.dtype)
+        M = matrix((data[nonzero], pattern.indices[nonzero], indptr),
+                   shape=pattern.shape)
+    M.has_sorted_indices = pattern.has_sorted_indices
+    return M
+
+
 # from functools import partial, update_wrapper
 # def dispatcher(name_to_handle):
 #    def dispatcher(arg):
@@ -166,6 +166,41 @@ def cpp_flag(compiler):
                            'is needed!')
 
 
+def openmp_flag(compiler):
+    """Return the OpenMP compiler flag, or None if OpenMP is not supported.
+
+    A small OpenMP program is compiled and linked, so that a compiler that
+    accepts the flag but lacks the runtime (e.g. Apple clang) is rejected.
+    Set PYAMG_NO_OPENMP to build without OpenMP.
+    """
+    import tempfile
+    import shutil
+    if os.environ.get('PYAMG_NO_OPENMP'):
+        return None
+    if compiler.compiler_type == 'msvc':
+        flag = '/openmp'
+    else:
+        flag = '-fopenmp'
+    tmpdir = tempfile.mkdtemp()
+    try:
+        fname = os.path.join(tmpdir, 'test_openmp.cpp')
+        with open(fname, 'w') as f:
+            f.write('#include <omp.h>\n'
+                    'int main (int argc, char **argv) '
+                    '{ return omp_get_max_threads() < 1; }')
+        objects = compiler.compile([fname], output_dir=tmpdir,
+                                   extra_postargs=[flag])
+        compiler.link_executable(objects,
+                                 os.path.join(tmpdir, 'test_openmp'),
+                                 extra_postargs=[flag])
+    except (setuptools.distutils.errors.CompileError,
+            setuptools.distutils.errors.LinkError):
+        return None
+    finally:
+        shutil.rmtree(tmpdir)
+    return flag
+
+
 class BuildExt(build_ext):
     """A custom build extension for adding compiler-specific options."""
     c_opts = {
@@ -194,6 +229,18 @@ class BuildExt(build_ext):
             if has_flag(self.compiler, '-fvisibility=hidden'):
                 c_opts.append('-fvisibility=hidden')
 
+        # enable the threaded amg_core kernels
+        omp = openmp_flag(self.compiler)
+        if omp is not None:
+            c_opts.append(omp)
+            if ct == 'unix':
+                l_opts.append(omp)
+        elif ct == 'msvc':
+            # the omp pragmas are ignored, without a warning for each
+            c_opts.append('/wd4068')
+        elif has_flag(self.compiler, '-Wno-unknown-pragmas'):
+            c_opts.append('-Wno-unknown-pragmas')
+
         for ext in self.extensions:
             ext.extra_compile_args = c_opts
             ext.extra_link_args = l_opts
@@ -264,9 +311,11 @@ amg_core_headers = ['evolution_strength.h',
                     'graph.h',
                     'krylov.h',
                     'linalg.h',
+                    'parallel.h',
                     'relaxation.h',
                     'ruge_stuben.h',
-                    'smoothed_aggregation.h']
+                    'smoothed_aggregation.h',
+                    'sparse.h']
 amg_core_headers = [f.replace('.h', '') for f in amg_core_headers]
 
 ext_modules = [Extension('pyamg.amg_core.%s' % f,
@@ -280,6 +329,12 @@ ext_modules += [Extension('pyamg.amg_core.tests.bind_examples',
                           include_dirs=[get_pybind_include(), get_pybind_include(user=True)],
                           language='c++')]
 
+ext_modules += [Extension('pyamg.amg_core.tests.linalg_examples',
+                          sources=['pyamg/amg_core/tests/linalg_examples_bind.cpp'],
+                          include_dirs=[get_pybind_include(), get_pybind_include(user=True),
+                                        'pyamg/amg_core'],
+                          language='c++')]
+
 setup(
     name='pyamg',
     version=fullversion,